@@ -13,6 +13,7 @@
 #include <string.h>
 #include <lwm2mcore/lwm2mcore.h>
 #include <lwm2mcore/security.h>
+#include <lwm2mcore/heap.h>
 #include "liblwm2m.h"
 #include "clientConfig.h"
 
@@ -475,7 +476,8 @@ static int ConfigurationHandler
                             if (!securityConfigPtr)
                             {
                                 securityConfigPtr = (clientSecurityConfig_t*)
-                                                    lwm2m_malloc(sizeof(clientSecurityConfig_t));
+                                            lwm2mcore_MallocTag(sizeof(clientSecurityConfig_t),
+                                                                LWM2MCORE_HEAP_TAG_PLATFORM);
                                 memset(securityConfigPtr, 0, sizeof(clientSecurityConfig_t));
                                 securityConfigPtr->isBootstrapServer = true;
                                 AddSecurity(&ClientConfig, securityConfigPtr);
@@ -516,7 +518,8 @@ static int ConfigurationHandler
                             if (!securityConfigPtr)
                             {
                                 securityConfigPtr = (clientSecurityConfig_t*)
-                                                     lwm2m_malloc(sizeof(clientSecurityConfig_t));
+                                            lwm2mcore_MallocTag(sizeof(clientSecurityConfig_t),
+                                                                LWM2MCORE_HEAP_TAG_PLATFORM);
                                 memset(securityConfigPtr, 0, sizeof(clientSecurityConfig_t));
                                 securityConfigPtr->isBootstrapServer = false;
                                 securityConfigPtr->serverId = serverId;
@@ -952,13 +955,13 @@ int clientConfigWriteOneLine
     char* bufferPtr = NULL;
     int bsize = MAX_FILE_SIZE;
 
-    bufferPtr = lwm2m_malloc(bsize);
+    bufferPtr = lwm2mcore_MallocTag(bsize, LWM2MCORE_HEAP_TAG_PLATFORM);
     assert(bufferPtr);
     memset(bufferPtr, 0, bsize);
 
     if ((bsize = ReadFileToBuffer(bufferPtr)) < 0)
     {
-        free(bufferPtr);
+        lwm2m_free(bufferPtr);
         return bsize;
     }
 
@@ -975,7 +978,7 @@ int clientConfigWriteOneLine
         clientConfigRead(&configPtr);
     }
 
-    free(bufferPtr);
+    lwm2m_free(bufferPtr);
     return bsize;
 }
 
@@ -1017,4 +1020,7 @@ void ClientConfigFree
         securityPtr = security2Ptr;
     }
     ClientConfig.securityPtr = NULL;
+
+    // The decoded credentials refer to the freed configuration
+    ClearCredentialCache();
 }
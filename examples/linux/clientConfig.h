@@ -248,5 +248,16 @@ void ClientConfigFree
 (
     void
 );
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Wipe the credentials decoded from the client configuration (see security.c)
+ */
+//--------------------------------------------------------------------------------------------------
+void ClearCredentialCache
+(
+    void
+);
+
 #endif /* _CLIENTCONFIG_H_ */
 
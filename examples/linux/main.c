@@ -18,6 +18,9 @@
 #include <lwm2mcore/lwm2mcore.h>
 #include <lwm2mcore/device.h>
 #include <lwm2mcore/udp.h>
+#include <lwm2mcore/statistics.h>
+#include <lwm2mcore/heap.h>
+#include <lwm2mcore/trace.h>
 #include "dtls_debug.h"
 #include "dtlsConnection.h"
 
@@ -30,6 +33,8 @@
 #include <errno.h>
 #include <signal.h>
 #include "clientConfig.h"
+#include "memPool.h"
+#include "paramStore.h"
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -38,6 +43,34 @@
 //--------------------------------------------------------------------------------------------------
 #define MAX_PACKET_SIZE 1024
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Period of the CoAP metrics event, in seconds
+ */
+//--------------------------------------------------------------------------------------------------
+#define COAP_METRICS_PERIOD 300
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of records of the trace ring buffer
+ */
+//--------------------------------------------------------------------------------------------------
+#define TRACE_RECORD_NB 4096
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of bytes captured per packet in the trace
+ */
+//--------------------------------------------------------------------------------------------------
+#define TRACE_CAPTURE_LEN 256
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Trace file written by the trace command, to be decoded by the lwm2mtrace tool
+ */
+//--------------------------------------------------------------------------------------------------
+#define TRACE_FILE "lwm2mcore.trace"
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Socket configuration set in udp.c
@@ -80,6 +113,20 @@ static char Endpoint[LWM2MCORE_ENDPOINT_LEN] = {0};
 //--------------------------------------------------------------------------------------------------
 static log_t LogLevel = DTLS_LOG_INFO;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size classes serving the small allocations of LwM2MCore and Wakaama (URIs, CoAP options,
+ * observation and transaction structures)
+ */
+//--------------------------------------------------------------------------------------------------
+static const MemPoolConfig_t SizeClasses[] =
+{
+    {32, 256},
+    {64, 256},
+    {128, 128},
+    {256, 64}
+};
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Client configuration
@@ -97,6 +144,7 @@ typedef enum
     START_CNX,          ///< Start a connection
     STOP_CNX,           ///< Stop a connection
     UPDATE_REQUEST,     ///< Send a registration update
+    TRACE_DUMP,         ///< Write the trace records in a file
     QUIT,               ///< Quit
     MAX_CMD             ///< Internal usage
 }
@@ -116,6 +164,93 @@ typedef struct
 }
 CommandDesc_t;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function to print the CoAP metrics of the servers
+ */
+//--------------------------------------------------------------------------------------------------
+static void PrintCoapMetrics
+(
+    uint16_t serverNb       ///< [IN] Number of servers with metrics
+)
+{
+    lwm2mcore_CoapMetrics_t metrics;
+    uint16_t i;
+
+    for (i = 0; i < serverNb; i++)
+    {
+        if (LWM2MCORE_ERR_COMPLETED_OK != lwm2mcore_GetCoapMetrics(i, &metrics))
+        {
+            break;
+        }
+
+        printf("Server %u: CON %u, retransmissions %u, timeouts %u, duplicates %u, "\
+               "SRTT %u us, RTTVAR %u us, max RTT %u us\n",
+               metrics.securityInstId, metrics.conSentNb, metrics.retransmissionNb,
+               metrics.timeoutNb, metrics.duplicateNb, metrics.srttUs, metrics.rttVarUs,
+               metrics.rtt.maxUs);
+        printf("Server %u: sent %llu bytes / %u DTLS records, received %llu bytes / "\
+               "%u DTLS records, %u handshakes\n",
+               metrics.securityInstId, (unsigned long long)metrics.bytesSent,
+               metrics.dtlsRecordSentNb, (unsigned long long)metrics.bytesReceived,
+               metrics.dtlsRecordReceivedNb, metrics.handshake.count);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function to print the heap statistics of the subsystems
+ */
+//--------------------------------------------------------------------------------------------------
+static void PrintHeapStats
+(
+    void
+)
+{
+    static const char* tagNames[LWM2MCORE_HEAP_TAG_MAX] =
+    {
+        "Wakaama", "Object manager", "Session manager", "Package downloader", "DTLS", "Platform"
+    };
+    lwm2mcore_HeapStats_t stats;
+    int tag;
+
+    for (tag = 0; tag < LWM2MCORE_HEAP_TAG_MAX; tag++)
+    {
+        if (LWM2MCORE_ERR_COMPLETED_OK != lwm2mcore_GetHeapStats(tag, &stats))
+        {
+            // Heap accounting not enabled
+            return;
+        }
+
+        printf("Heap %s: %llu bytes in %u blocks, peak %llu bytes, %u allocations, "\
+               "%u releases, %u failures\n",
+               tagNames[tag], (unsigned long long)stats.currentBytes, stats.currentNb,
+               (unsigned long long)stats.peakBytes, stats.allocNb, stats.freeNb, stats.failureNb);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function to print the statistics of the size classes
+ */
+//--------------------------------------------------------------------------------------------------
+static void PrintSizeClassStats
+(
+    void
+)
+{
+    MemPoolStats_t stats;
+    size_t i;
+
+    for (i = 0; MemPoolGetSizeClassStats(i, &stats); i++)
+    {
+        printf("Size class %zu bytes: %u/%u blocks used, peak %u, %u allocations, "\
+               "%u exhausted\n",
+               stats.blockSize, stats.usedNb, stats.blockNb, stats.peakUsedNb, stats.allocNb,
+               stats.exhaustedNb);
+    }
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Handler for LWM2MCore events
@@ -219,6 +354,12 @@ static int StatusHandler
                 }
                 break;
 
+        case LWM2MCORE_EVENT_COAP_METRICS:
+                PrintCoapMetrics(eventStatus.u.coapMetrics.serverNb);
+                PrintHeapStats();
+                PrintSizeClassStats();
+                break;
+
         default:
             printf("Unknown event %d\n", eventStatus.event);
             break;
@@ -270,11 +411,63 @@ CommandDesc_t Commands[] =
     {"start",   "Launch a connection to the server",    START_CNX,      NULL},
     {"stop",    "Stop a connection to the server",      STOP_CNX,       NULL},
     {"update",  "Trigger a registration update",        UPDATE_REQUEST, NULL},
+    {"trace",   "Write the trace in " TRACE_FILE,       TRACE_DUMP,     NULL},
     {"quit",    "Quit the client gracefully.",          QUIT,           NULL},
     {"^C",      "Quit the client abruptly.",            MAX_CMD,        NULL},
     {NULL,      NULL,                                   MAX_CMD,        NULL}
 };
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function to write the trace records in a file
+ */
+//--------------------------------------------------------------------------------------------------
+static void WriteTraceFile
+(
+    const char* fileNamePtr     ///< [IN] Trace file
+)
+{
+    lwm2mcore_TraceFileHeader_t header;
+    lwm2mcore_TraceRecord_t* recordsPtr;
+    uint32_t seq = 0;
+    FILE* filePtr;
+
+    recordsPtr = (lwm2mcore_TraceRecord_t*)malloc(TRACE_RECORD_NB
+                                                  * sizeof(lwm2mcore_TraceRecord_t));
+    if (NULL == recordsPtr)
+    {
+        printf("Unable to allocate the trace records\n");
+        return;
+    }
+
+    memset(&header, 0, sizeof(header));
+    header.magic = LWM2MCORE_TRACE_FILE_MAGIC;
+    header.version = LWM2MCORE_TRACE_FILE_VERSION;
+    header.recordSize = sizeof(lwm2mcore_TraceRecord_t);
+    header.recordNb = lwm2mcore_TraceGetRecords(&seq, recordsPtr, TRACE_RECORD_NB, &header.lostNb);
+
+    filePtr = fopen(fileNamePtr, "wb");
+    if (   (NULL == filePtr)
+        || (1 != fwrite(&header, sizeof(header), 1, filePtr))
+        || (header.recordNb != fwrite(recordsPtr,
+                                      sizeof(lwm2mcore_TraceRecord_t),
+                                      header.recordNb,
+                                      filePtr)))
+    {
+        printf("Unable to write %s\n", fileNamePtr);
+    }
+    else
+    {
+        printf("%u trace records written in %s\n", header.recordNb, fileNamePtr);
+    }
+
+    if (NULL != filePtr)
+    {
+        fclose(filePtr);
+    }
+    free(recordsPtr);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Function to find a command
@@ -374,6 +567,8 @@ static void TreatCmd
             ContextPtr = lwm2mcore_Init(StatusHandler);
             if (NULL != ContextPtr)
             {
+                lwm2mcore_SetCoapMetricsPeriod(COAP_METRICS_PERIOD);
+
                 // Register to the LWM2M agent
                 size_t len = LWM2MCORE_ENDPOINT_LEN;
                 if (LWM2MCORE_ERR_COMPLETED_OK == lwm2mcore_GetDeviceImei(Endpoint, &len))
@@ -411,6 +606,10 @@ static void TreatCmd
             lwm2mcore_Update(ContextPtr);
         break;
 
+        case TRACE_DUMP:
+            WriteTraceFile(TRACE_FILE);
+        break;
+
         case QUIT:
             if (NULL != ContextPtr)
             {
@@ -521,10 +720,22 @@ int main
     // Set DTLS log level
     dtls_set_log_level(LogLevel);
 
+    // Serve the small allocations from the size classes, before the configuration is allocated
+    if (!MemPoolSetSizeClasses(SizeClasses, sizeof(SizeClasses) / sizeof(SizeClasses[0])))
+    {
+        printf("Unable to create the size classes\n");
+    }
+
     // Get the client configuration from clientConfig.txt file
     memset(&ClientConfiguration, 0, sizeof(ClientConfiguration));
     clientConfigRead(&ClientConfiguration);
 
+    // Enable the binary trace of the exchanges with the servers
+    if (!lwm2mcore_TraceEnable(TRACE_RECORD_NB, TRACE_CAPTURE_LEN))
+    {
+        printf("Unable to enable the trace\n");
+    }
+
     // Install signal handler to catch CTRL+C to gracefully shutdown
     signal(SIGINT, Interrupt);
 
@@ -553,6 +764,14 @@ int main
                 printf("Error in select(): %d %s\n", errno, strerror(errno));
             }
         }
+        else if (0 == result)
+        {
+            // Nothing to do: remove the obsolete records of the parameter store
+            if (ParamStoreIsCompactionNeeded())
+            {
+                ParamStoreCompact();
+            }
+        }
         else if (result > 0)
         {
             int numBytes;
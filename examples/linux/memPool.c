@@ -0,0 +1,512 @@
+/**
+ * @file memPool.c
+ *
+ * Fixed-size block pools of the Linux client, see memPool.h
+ *
+ * The free blocks of a pool form a list of block indexes: the index of the next free block is
+ * stored in the first bytes of a free block. The list head is a 64-bit word holding the index of
+ * the first free block and a generation counter incremented by each update, so that a head
+ * compare-and-swap fails if the list was modified in between, even if the same block is back at
+ * the head (ABA problem).
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include "memPool.h"
+
+//--------------------------------------------------------------------------------------------------
+// Symbol and Enum definitions
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Block index marking the end of the free list
+ */
+//--------------------------------------------------------------------------------------------------
+#define NO_BLOCK                    UINT32_MAX
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Build a free list head from a generation and a block index
+ */
+//--------------------------------------------------------------------------------------------------
+#define HEAD(generation, index)     (((uint64_t)(generation) << 32) | (uint32_t)(index))
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Block index of a free list head
+ */
+//--------------------------------------------------------------------------------------------------
+#define HEAD_INDEX(head)            ((uint32_t)(head))
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Generation of a free list head
+ */
+//--------------------------------------------------------------------------------------------------
+#define HEAD_GENERATION(head)       ((uint32_t)((head) >> 32))
+
+//--------------------------------------------------------------------------------------------------
+// Data structures
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool
+ */
+//--------------------------------------------------------------------------------------------------
+struct MemPool
+{
+    uint8_t* arenaPtr;          ///< Blocks
+    size_t   blockSize;         ///< Block size, multiple of MEM_POOL_ALIGNMENT
+    uint32_t blockNb;           ///< Number of blocks
+    uint64_t head;              ///< Free list head: generation and index of the first free block
+    uint32_t allocNb;           ///< Number of allocations
+    uint32_t releaseNb;         ///< Number of releases
+    uint32_t peakUsedNb;        ///< Peak of the number of allocated blocks
+    uint32_t exhaustedNb;       ///< Number of allocations failed because all blocks were used
+};
+
+//--------------------------------------------------------------------------------------------------
+// Static variables
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pools of the size classes, sorted by block size
+ */
+//--------------------------------------------------------------------------------------------------
+static MemPoolRef_t SizeClasses[MEM_POOL_SIZE_CLASS_MAX_NB];
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of size classes
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t SizeClassNb;
+
+//--------------------------------------------------------------------------------------------------
+// Static functions
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the address of the link to the next free block, stored in a free block
+ *
+ * @return
+ *      - Link address
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t* GetNextPtr
+(
+    MemPoolRef_t poolRef,       ///< [IN] Pool reference
+    uint32_t     index          ///< [IN] Block index
+)
+{
+    return (uint32_t*)(void*)(poolRef->arenaPtr + ((size_t)index * poolRef->blockSize));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of allocated blocks of a pool
+ *
+ * @return
+ *      - Number of allocated blocks
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t GetUsedNb
+(
+    MemPoolRef_t poolRef        ///< [IN] Pool reference
+)
+{
+    uint32_t releaseNb = __atomic_load_n(&poolRef->releaseNb, __ATOMIC_ACQUIRE);
+
+    return __atomic_load_n(&poolRef->allocNb, __ATOMIC_ACQUIRE) - releaseNb;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compare two size class configurations by block size, for qsort
+ */
+//--------------------------------------------------------------------------------------------------
+static int CompareConfigs
+(
+    const void* aPtr,           ///< [IN] First configuration
+    const void* bPtr            ///< [IN] Second configuration
+)
+{
+    size_t a = ((const MemPoolConfig_t*)aPtr)->blockSize;
+    size_t b = ((const MemPoolConfig_t*)bPtr)->blockSize;
+
+    return (a > b) - (a < b);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public functions
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a pool
+ *
+ * @return
+ *      - Pool reference
+ *      - NULL if the configuration is invalid or in case of allocation failure
+ */
+//--------------------------------------------------------------------------------------------------
+MemPoolRef_t MemPoolCreate
+(
+    size_t   blockSize,         ///< [IN] Block size
+    uint32_t blockNb            ///< [IN] Number of blocks
+)
+{
+    MemPoolRef_t poolRef;
+    uint32_t i;
+
+    if ((0 == blockNb) || (NO_BLOCK == blockNb) || (0 == blockSize)
+     || ((SIZE_MAX / blockNb) <= (blockSize + MEM_POOL_ALIGNMENT)))
+    {
+        return NULL;
+    }
+
+    poolRef = (MemPoolRef_t)malloc(sizeof(struct MemPool));
+    if (!poolRef)
+    {
+        return NULL;
+    }
+    memset(poolRef, 0, sizeof(struct MemPool));
+
+    poolRef->blockSize = (blockSize + MEM_POOL_ALIGNMENT - 1) & ~((size_t)MEM_POOL_ALIGNMENT - 1);
+    poolRef->blockNb = blockNb;
+    if (0 != posix_memalign((void**)&poolRef->arenaPtr,
+                            MEM_POOL_ALIGNMENT,
+                            poolRef->blockSize * blockNb))
+    {
+        free(poolRef);
+        return NULL;
+    }
+
+    for (i = 0; i < blockNb; i++)
+    {
+        *GetNextPtr(poolRef, i) = ((i + 1) < blockNb) ? (i + 1) : NO_BLOCK;
+    }
+    poolRef->head = HEAD(0, 0);
+
+    return poolRef;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete a pool
+ *
+ * @return
+ *      - true if the pool is deleted
+ *      - false if some blocks are still allocated
+ */
+//--------------------------------------------------------------------------------------------------
+bool MemPoolDelete
+(
+    MemPoolRef_t poolRef        ///< [IN] Pool reference
+)
+{
+    if (!poolRef)
+    {
+        return true;
+    }
+
+    if (0 != GetUsedNb(poolRef))
+    {
+        return false;
+    }
+
+    free(poolRef->arenaPtr);
+    free(poolRef);
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Allocate a block. This function can be called by any thread.
+ *
+ * @return
+ *      - Block address
+ *      - NULL if all the blocks are allocated
+ */
+//--------------------------------------------------------------------------------------------------
+void* MemPoolAlloc
+(
+    MemPoolRef_t poolRef        ///< [IN] Pool reference
+)
+{
+    uint64_t head = __atomic_load_n(&poolRef->head, __ATOMIC_ACQUIRE);
+    uint32_t usedNb;
+    uint32_t peakUsedNb;
+    uint32_t index;
+
+    do
+    {
+        uint32_t next;
+
+        index = HEAD_INDEX(head);
+        if (NO_BLOCK == index)
+        {
+            __atomic_fetch_add(&poolRef->exhaustedNb, 1, __ATOMIC_RELAXED);
+            return NULL;
+        }
+
+        // The block may be allocated by another thread meanwhile: the link is then discarded
+        // as the head generation changed
+        next = __atomic_load_n(GetNextPtr(poolRef, index), __ATOMIC_RELAXED);
+        if (__atomic_compare_exchange_n(&poolRef->head,
+                                        &head,
+                                        HEAD(HEAD_GENERATION(head) + 1, next),
+                                        true,
+                                        __ATOMIC_ACQUIRE,
+                                        __ATOMIC_ACQUIRE))
+        {
+            break;
+        }
+    }
+    while (1);
+
+    // A release done meanwhile may not be visible yet: the peak is then slightly overestimated
+    usedNb = __atomic_add_fetch(&poolRef->allocNb, 1, __ATOMIC_RELAXED)
+             - __atomic_load_n(&poolRef->releaseNb, __ATOMIC_RELAXED);
+    peakUsedNb = __atomic_load_n(&poolRef->peakUsedNb, __ATOMIC_RELAXED);
+    while ((peakUsedNb < usedNb)
+        && (!__atomic_compare_exchange_n(&poolRef->peakUsedNb, &peakUsedNb, usedNb, true,
+                                         __ATOMIC_RELAXED, __ATOMIC_RELAXED)))
+    {
+        ;
+    }
+
+    return GetNextPtr(poolRef, index);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if an address is a block of a pool
+ *
+ * @return
+ *      - true if the address belongs to the pool arena
+ *      - false otherwise
+ */
+//--------------------------------------------------------------------------------------------------
+bool MemPoolContains
+(
+    MemPoolRef_t poolRef,       ///< [IN] Pool reference
+    const void*  ptr            ///< [IN] Address
+)
+{
+    uintptr_t address = (uintptr_t)ptr;
+    uintptr_t arena = (uintptr_t)poolRef->arenaPtr;
+
+    return (address >= arena) && ((address - arena) < (poolRef->blockSize * poolRef->blockNb));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Release a block allocated by MemPoolAlloc(). This function can be called by any thread.
+ */
+//--------------------------------------------------------------------------------------------------
+void MemPoolRelease
+(
+    MemPoolRef_t poolRef,       ///< [IN] Pool reference
+    void*        ptr            ///< [IN] Block address
+)
+{
+    uint32_t index = (uint32_t)(((uintptr_t)ptr - (uintptr_t)poolRef->arenaPtr)
+                                / poolRef->blockSize);
+    uint64_t head = __atomic_load_n(&poolRef->head, __ATOMIC_RELAXED);
+
+    do
+    {
+        __atomic_store_n(GetNextPtr(poolRef, index), HEAD_INDEX(head), __ATOMIC_RELAXED);
+    }
+    while (!__atomic_compare_exchange_n(&poolRef->head,
+                                        &head,
+                                        HEAD(HEAD_GENERATION(head) + 1, index),
+                                        true,
+                                        __ATOMIC_RELEASE,
+                                        __ATOMIC_RELAXED));
+
+    __atomic_fetch_add(&poolRef->releaseNb, 1, __ATOMIC_RELEASE);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the statistics of a pool
+ */
+//--------------------------------------------------------------------------------------------------
+void MemPoolGetStats
+(
+    MemPoolRef_t    poolRef,    ///< [IN] Pool reference
+    MemPoolStats_t* statsPtr    ///< [OUT] Statistics
+)
+{
+    statsPtr->blockSize = poolRef->blockSize;
+    statsPtr->blockNb = poolRef->blockNb;
+    statsPtr->usedNb = GetUsedNb(poolRef);
+    statsPtr->peakUsedNb = __atomic_load_n(&poolRef->peakUsedNb, __ATOMIC_RELAXED);
+    statsPtr->allocNb = __atomic_load_n(&poolRef->allocNb, __ATOMIC_RELAXED);
+    statsPtr->exhaustedNb = __atomic_load_n(&poolRef->exhaustedNb, __ATOMIC_RELAXED);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create the pools of the size classes used by lwm2m_malloc().
+ *
+ * This function has to be called when no other thread can allocate memory, typically before the
+ * LwM2MCore initialization. The size classes can't be changed while some of their blocks are
+ * allocated.
+ *
+ * @return
+ *      - true if the size classes are created
+ *      - false if the configuration is invalid, if the current size classes are in use or in case
+ *        of allocation failure
+ */
+//--------------------------------------------------------------------------------------------------
+bool MemPoolSetSizeClasses
+(
+    const MemPoolConfig_t* configPtr,   ///< [IN] Size class configurations, NULL to delete the
+                                        ///<      size classes
+    size_t                 configNb     ///< [IN] Number of size classes
+)
+{
+    MemPoolConfig_t configs[MEM_POOL_SIZE_CLASS_MAX_NB];
+    MemPoolRef_t pools[MEM_POOL_SIZE_CLASS_MAX_NB];
+    size_t i;
+
+    if ((MEM_POOL_SIZE_CLASS_MAX_NB < configNb) || ((!configPtr) && (configNb)))
+    {
+        return false;
+    }
+
+    for (i = 0; i < SizeClassNb; i++)
+    {
+        if (0 != GetUsedNb(SizeClasses[i]))
+        {
+            return false;
+        }
+    }
+
+    if (configNb)
+    {
+        memcpy(configs, configPtr, configNb * sizeof(MemPoolConfig_t));
+        qsort(configs, configNb, sizeof(MemPoolConfig_t), CompareConfigs);
+    }
+
+    for (i = 0; i < configNb; i++)
+    {
+        pools[i] = MemPoolCreate(configs[i].blockSize, configs[i].blockNb);
+        if (!pools[i])
+        {
+            while (i)
+            {
+                MemPoolDelete(pools[--i]);
+            }
+            return false;
+        }
+    }
+
+    for (i = 0; i < SizeClassNb; i++)
+    {
+        MemPoolDelete(SizeClasses[i]);
+    }
+
+    if (configNb)
+    {
+        memcpy(SizeClasses, pools, configNb * sizeof(MemPoolRef_t));
+    }
+    SizeClassNb = configNb;
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Allocate a block from the smallest size class large enough with a free block
+ *
+ * @return
+ *      - Block address
+ *      - NULL if the size is larger than all the size classes or if they are exhausted
+ */
+//--------------------------------------------------------------------------------------------------
+void* MemPoolSizeClassAlloc
+(
+    size_t size                 ///< [IN] Requested size
+)
+{
+    size_t i;
+
+    for (i = 0; i < SizeClassNb; i++)
+    {
+        if (SizeClasses[i]->blockSize >= size)
+        {
+            void* blockPtr = MemPoolAlloc(SizeClasses[i]);
+
+            if (blockPtr)
+            {
+                return blockPtr;
+            }
+        }
+    }
+
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Release a block to its size class
+ *
+ * @return
+ *      - true if the block is released
+ *      - false if the address is not a block of a size class
+ */
+//--------------------------------------------------------------------------------------------------
+bool MemPoolSizeClassRelease
+(
+    void* ptr                   ///< [IN] Block address
+)
+{
+    size_t i;
+
+    for (i = 0; i < SizeClassNb; i++)
+    {
+        if (MemPoolContains(SizeClasses[i], ptr))
+        {
+            MemPoolRelease(SizeClasses[i], ptr);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the statistics of a size class
+ *
+ * @return
+ *      - true on success
+ *      - false if the index is out of range
+ */
+//--------------------------------------------------------------------------------------------------
+bool MemPoolGetSizeClassStats
+(
+    size_t          index,      ///< [IN] Size class index, from the smallest block size
+    MemPoolStats_t* statsPtr    ///< [OUT] Statistics
+)
+{
+    if ((index >= SizeClassNb) || (!statsPtr))
+    {
+        return false;
+    }
+
+    MemPoolGetStats(SizeClasses[index], statsPtr);
+    return true;
+}
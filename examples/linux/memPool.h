@@ -0,0 +1,218 @@
+/**
+ * @file memPool.h
+ *
+ * Fixed-size block pools of the Linux client.
+ *
+ * A pool is a single arena allocated at its creation and split in blocks of the same size: the
+ * allocation and the release of a block only pop and push an index on a lock-free list, and the
+ * arena never fragments the heap.
+ *
+ * The size classes are a set of pools to which lwm2m_malloc() routes the small allocations: an
+ * allocation is served by the smallest class large enough with a free block, or by the heap if all
+ * these classes are exhausted. lwm2m_free() releases a block to its pool based on its address.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#ifndef _MEMPOOL_H_
+#define _MEMPOOL_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of size classes
+ */
+//--------------------------------------------------------------------------------------------------
+#define MEM_POOL_SIZE_CLASS_MAX_NB      8
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Alignment of the blocks
+ */
+//--------------------------------------------------------------------------------------------------
+#define MEM_POOL_ALIGNMENT              16
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reference to a pool
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct MemPool* MemPoolRef_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Configuration of a pool
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    size_t   blockSize;         ///< Block size, rounded up to MEM_POOL_ALIGNMENT
+    uint32_t blockNb;           ///< Number of blocks
+}
+MemPoolConfig_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool statistics
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    size_t   blockSize;         ///< Block size
+    uint32_t blockNb;           ///< Number of blocks
+    uint32_t usedNb;            ///< Number of allocated blocks
+    uint32_t peakUsedNb;        ///< Peak of usedNb
+    uint32_t allocNb;           ///< Number of allocations
+    uint32_t exhaustedNb;       ///< Number of allocations failed because all blocks were used
+}
+MemPoolStats_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a pool
+ *
+ * @return
+ *      - Pool reference
+ *      - NULL if the configuration is invalid or in case of allocation failure
+ */
+//--------------------------------------------------------------------------------------------------
+MemPoolRef_t MemPoolCreate
+(
+    size_t   blockSize,         ///< [IN] Block size
+    uint32_t blockNb            ///< [IN] Number of blocks
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete a pool
+ *
+ * @return
+ *      - true if the pool is deleted
+ *      - false if some blocks are still allocated
+ */
+//--------------------------------------------------------------------------------------------------
+bool MemPoolDelete
+(
+    MemPoolRef_t poolRef        ///< [IN] Pool reference
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Allocate a block. This function can be called by any thread.
+ *
+ * @return
+ *      - Block address
+ *      - NULL if all the blocks are allocated
+ */
+//--------------------------------------------------------------------------------------------------
+void* MemPoolAlloc
+(
+    MemPoolRef_t poolRef        ///< [IN] Pool reference
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if an address is a block of a pool
+ *
+ * @return
+ *      - true if the address belongs to the pool arena
+ *      - false otherwise
+ */
+//--------------------------------------------------------------------------------------------------
+bool MemPoolContains
+(
+    MemPoolRef_t poolRef,       ///< [IN] Pool reference
+    const void*  ptr            ///< [IN] Address
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Release a block allocated by MemPoolAlloc(). This function can be called by any thread.
+ */
+//--------------------------------------------------------------------------------------------------
+void MemPoolRelease
+(
+    MemPoolRef_t poolRef,       ///< [IN] Pool reference
+    void*        ptr            ///< [IN] Block address
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the statistics of a pool
+ */
+//--------------------------------------------------------------------------------------------------
+void MemPoolGetStats
+(
+    MemPoolRef_t    poolRef,    ///< [IN] Pool reference
+    MemPoolStats_t* statsPtr    ///< [OUT] Statistics
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create the pools of the size classes used by lwm2m_malloc().
+ *
+ * This function has to be called when no other thread can allocate memory, typically before the
+ * LwM2MCore initialization. The size classes can't be changed while some of their blocks are
+ * allocated.
+ *
+ * @return
+ *      - true if the size classes are created
+ *      - false if the configuration is invalid, if the current size classes are in use or in case
+ *        of allocation failure
+ */
+//--------------------------------------------------------------------------------------------------
+bool MemPoolSetSizeClasses
+(
+    const MemPoolConfig_t* configPtr,   ///< [IN] Size class configurations, NULL to delete the
+                                        ///<      size classes
+    size_t                 configNb     ///< [IN] Number of size classes
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Allocate a block from the smallest size class large enough with a free block
+ *
+ * @return
+ *      - Block address
+ *      - NULL if the size is larger than all the size classes or if they are exhausted
+ */
+//--------------------------------------------------------------------------------------------------
+void* MemPoolSizeClassAlloc
+(
+    size_t size                 ///< [IN] Requested size
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Release a block to its size class
+ *
+ * @return
+ *      - true if the block is released
+ *      - false if the address is not a block of a size class
+ */
+//--------------------------------------------------------------------------------------------------
+bool MemPoolSizeClassRelease
+(
+    void* ptr                   ///< [IN] Block address
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the statistics of a size class
+ *
+ * @return
+ *      - true on success
+ *      - false if the index is out of range
+ */
+//--------------------------------------------------------------------------------------------------
+bool MemPoolGetSizeClassStats
+(
+    size_t          index,      ///< [IN] Size class index, from the smallest block size
+    MemPoolStats_t* statsPtr    ///< [OUT] Statistics
+);
+
+#endif /* _MEMPOOL_H_ */
@@ -0,0 +1,730 @@
+/**
+ * @file packageStorage.c
+ *
+ * Storage backend of the downloaded packages for the Linux client, see packageStorage.h
+ *
+ * The length of data committed at each checkpoint is saved in a checkpoint file next to the
+ * package file. As the package downloader workspace is saved before the data are stored, the
+ * workspace is always ahead of the committed data: the package downloader downloads again the
+ * data stored after the last checkpoint when the download is resumed with the committed length
+ * as update offset. A checkpoint file lost or truncated by a power failure only leads to a
+ * download restarting from the beginning of the binary data.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+// fallocate, mremap and O_DIRECT are Linux extensions
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "packageStorage.h"
+
+//--------------------------------------------------------------------------------------------------
+// Static functions
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Round a length up to the direct I/O alignment
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t AlignUp
+(
+    uint64_t len        ///< [IN] Length
+)
+{
+    return (len + PKG_STORAGE_ALIGN_LEN - 1) & ~((uint64_t)PKG_STORAGE_ALIGN_LEN - 1);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Round a length down to the direct I/O alignment
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t AlignDown
+(
+    uint64_t len        ///< [IN] Length
+)
+{
+    return len & ~((uint64_t)PKG_STORAGE_ALIGN_LEN - 1);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Allocate the package file blocks up to the given size. The file size is set with ftruncate if
+ * the file system doesn't support fallocate.
+ *
+ * @return
+ *  - DWL_OK    The file is allocated
+ *  - DWL_FAULT The file can't be allocated
+ */
+//--------------------------------------------------------------------------------------------------
+static lwm2mcore_DwlResult_t AllocateFile
+(
+    PackageStorage_t* storagePtr,   ///< [IN] Package storage context
+    uint64_t          size          ///< [IN] New file size
+)
+{
+    size = AlignUp(size);
+    if (size <= storagePtr->fileSize)
+    {
+        return DWL_OK;
+    }
+
+    if (0 != fallocate(storagePtr->fd, 0, 0, (off_t)size))
+    {
+        if ((EOPNOTSUPP != errno) || (0 != ftruncate(storagePtr->fd, (off_t)size)))
+        {
+            printf("%s Failed to allocate %llu bytes for %s: %s\n",
+                   __func__, (unsigned long long)size, storagePtr->path, strerror(errno));
+            return DWL_FAULT;
+        }
+    }
+
+    if (storagePtr->mapPtr)
+    {
+        void* mapPtr = mremap(storagePtr->mapPtr,
+                              (size_t)storagePtr->fileSize,
+                              (size_t)size,
+                              MREMAP_MAYMOVE);
+        if (MAP_FAILED == mapPtr)
+        {
+            printf("%s Failed to remap %s: %s\n", __func__, storagePtr->path, strerror(errno));
+            return DWL_FAULT;
+        }
+        storagePtr->mapPtr = (uint8_t*)mapPtr;
+    }
+
+    storagePtr->fileSize = size;
+    return DWL_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Grow the package file when the stored data exceed the allocated size, e.g. for a decompressed
+ * binary larger than the package
+ *
+ * @return
+ *  - DWL_OK    The file is large enough
+ *  - DWL_FAULT The file can't be allocated
+ */
+//--------------------------------------------------------------------------------------------------
+static lwm2mcore_DwlResult_t GrowFile
+(
+    PackageStorage_t* storagePtr,   ///< [IN] Package storage context
+    uint64_t          size          ///< [IN] Required file size
+)
+{
+    if (size <= storagePtr->fileSize)
+    {
+        return DWL_OK;
+    }
+
+    // Grow by half of the current size at least, to limit the number of allocations
+    if (size < (storagePtr->fileSize + (storagePtr->fileSize / 2)))
+    {
+        size = storagePtr->fileSize + (storagePtr->fileSize / 2);
+    }
+
+    return AllocateFile(storagePtr, size);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a buffer to the package file at the given offset
+ *
+ * @return
+ *  - DWL_OK    The buffer is written
+ *  - DWL_FAULT The buffer can't be written
+ */
+//--------------------------------------------------------------------------------------------------
+static lwm2mcore_DwlResult_t WriteAt
+(
+    PackageStorage_t* storagePtr,   ///< [IN] Package storage context
+    const uint8_t*    bufPtr,       ///< [IN] Buffer to write
+    size_t            len,          ///< [IN] Buffer length
+    uint64_t          offset        ///< [IN] File offset
+)
+{
+    while (len)
+    {
+        ssize_t writtenLen = pwrite(storagePtr->fd, bufPtr, len, (off_t)offset);
+        if (0 > writtenLen)
+        {
+            if (EINTR == errno)
+            {
+                continue;
+            }
+            printf("%s Failed to write %s: %s\n", __func__, storagePtr->path, strerror(errno));
+            return DWL_FAULT;
+        }
+        bufPtr += writtenLen;
+        len -= (size_t)writtenLen;
+        offset += (uint64_t)writtenLen;
+    }
+
+    return DWL_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write the content of the write buffer to the package file.
+ *
+ * In direct mode, only the complete aligned blocks are written, unless the whole buffer is
+ * requested: the last block is then padded.
+ *
+ * @return
+ *  - DWL_OK    The buffer is written
+ *  - DWL_FAULT The buffer can't be written
+ */
+//--------------------------------------------------------------------------------------------------
+static lwm2mcore_DwlResult_t FlushBuffer
+(
+    PackageStorage_t* storagePtr,   ///< [IN] Package storage context
+    bool              isAll         ///< [IN] Write the whole buffer
+)
+{
+    size_t dataLen = storagePtr->bufferLen;
+    size_t writeLen = dataLen;
+
+    if (PKG_STORAGE_MODE_DIRECT == storagePtr->mode)
+    {
+        if (isAll)
+        {
+            writeLen = (size_t)AlignUp(dataLen);
+            memset(storagePtr->bufferPtr + dataLen, 0, writeLen - dataLen);
+        }
+        else
+        {
+            writeLen = (size_t)AlignDown(dataLen);
+            dataLen = writeLen;
+        }
+    }
+
+    if (!writeLen)
+    {
+        return DWL_OK;
+    }
+
+    if (   (DWL_OK != GrowFile(storagePtr, storagePtr->writtenLen + writeLen))
+        || (DWL_OK != WriteAt(storagePtr, storagePtr->bufferPtr, writeLen, storagePtr->writtenLen))
+       )
+    {
+        return DWL_FAULT;
+    }
+
+    storagePtr->writtenLen += dataLen;
+    storagePtr->bufferLen -= dataLen;
+    if (storagePtr->bufferLen)
+    {
+        memmove(storagePtr->bufferPtr, storagePtr->bufferPtr + dataLen, storagePtr->bufferLen);
+    }
+
+    return DWL_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the committed length saved in the checkpoint file
+ *
+ * @return
+ *  - Committed length, 0 if there is no valid checkpoint file
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t ReadCheckpointFile
+(
+    PackageStorage_t* storagePtr    ///< [IN] Package storage context
+)
+{
+    uint64_t committedLen = 0;
+    int fd = open(storagePtr->checkpointPath, O_RDONLY);
+
+    if (0 > fd)
+    {
+        return 0;
+    }
+
+    if (sizeof(committedLen) != read(fd, &committedLen, sizeof(committedLen)))
+    {
+        committedLen = 0;
+    }
+    close(fd);
+
+    return committedLen;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Save the committed length in the checkpoint file
+ *
+ * @return
+ *  - DWL_OK    The checkpoint file is written
+ *  - DWL_FAULT The checkpoint file can't be written
+ */
+//--------------------------------------------------------------------------------------------------
+static lwm2mcore_DwlResult_t WriteCheckpointFile
+(
+    PackageStorage_t* storagePtr    ///< [IN] Package storage context
+)
+{
+    lwm2mcore_DwlResult_t result = DWL_OK;
+    int fd = open(storagePtr->checkpointPath, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+
+    if (0 > fd)
+    {
+        printf("%s Failed to open %s: %s\n", __func__, storagePtr->checkpointPath, strerror(errno));
+        return DWL_FAULT;
+    }
+
+    if (   (sizeof(storagePtr->checkpointLen) != write(fd,
+                                                       &storagePtr->checkpointLen,
+                                                       sizeof(storagePtr->checkpointLen)))
+        || (0 != fdatasync(fd))
+       )
+    {
+        printf("%s Failed to write %s\n", __func__, storagePtr->checkpointPath);
+        result = DWL_FAULT;
+    }
+    close(fd);
+
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Load the committed data of the last incomplete aligned block in the write buffer, so that the
+ * following writes stay aligned
+ *
+ * @return
+ *  - DWL_OK    The block is loaded
+ *  - DWL_FAULT The block can't be read
+ */
+//--------------------------------------------------------------------------------------------------
+static lwm2mcore_DwlResult_t LoadLastBlock
+(
+    PackageStorage_t* storagePtr    ///< [IN] Package storage context
+)
+{
+    uint64_t blockOffset = AlignDown(storagePtr->checkpointLen);
+    size_t blockLen = (size_t)(storagePtr->checkpointLen - blockOffset);
+    ssize_t readLen;
+
+    if (!blockLen)
+    {
+        return DWL_OK;
+    }
+
+    do
+    {
+        readLen = pread(storagePtr->fd,
+                        storagePtr->bufferPtr,
+                        PKG_STORAGE_ALIGN_LEN,
+                        (off_t)blockOffset);
+    }
+    while ((0 > readLen) && (EINTR == errno));
+
+    if ((0 > readLen) || ((size_t)readLen < blockLen))
+    {
+        printf("%s Failed to read %s\n", __func__, storagePtr->path);
+        return DWL_FAULT;
+    }
+
+    storagePtr->writtenLen = blockOffset;
+    storagePtr->bufferLen = blockLen;
+    return DWL_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Release the resources of the package storage
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReleaseStorage
+(
+    PackageStorage_t* storagePtr    ///< [IN] Package storage context
+)
+{
+    if (storagePtr->mapPtr)
+    {
+        munmap(storagePtr->mapPtr, (size_t)storagePtr->fileSize);
+        storagePtr->mapPtr = NULL;
+    }
+    free(storagePtr->bufferPtr);
+    storagePtr->bufferPtr = NULL;
+    if (0 <= storagePtr->fd)
+    {
+        close(storagePtr->fd);
+        storagePtr->fd = -1;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public functions
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Open the package file.
+ *
+ * The file is preallocated to the expected size. When the download is resumed, the existing file
+ * is opened and the stored data are truncated to the last checkpoint: the update offset of the
+ * package downloader should then be set to the value returned by
+ * PackageStorageGetCommittedLen().
+ *
+ * @return
+ *  - DWL_OK    The file is opened
+ *  - DWL_FAULT The file can't be opened or allocated
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_DwlResult_t PackageStorageOpen
+(
+    PackageStorage_t*    storagePtr,    ///< [OUT] Package storage context
+    const char*          pathPtr,       ///< [IN] Package file path
+    uint64_t             expectedSize,  ///< [IN] Expected size of the stored data, used to
+                                        ///<      preallocate the file (e.g. the package size)
+    PackageStorageMode_t mode,          ///< [IN] Write mode
+    bool                 isResume       ///< [IN] Resume a previous download
+)
+{
+    int flags = O_RDWR | O_CREAT;
+    struct stat fileStat;
+
+    if ((!storagePtr) || (!pathPtr) || (PKG_STORAGE_PATH_MAX_LEN <= strlen(pathPtr)))
+    {
+        return DWL_FAULT;
+    }
+
+    memset(storagePtr, 0, sizeof(PackageStorage_t));
+    storagePtr->fd = -1;
+    storagePtr->mode = mode;
+    storagePtr->checkpointInterval = PKG_STORAGE_CHECKPOINT_LEN;
+    snprintf(storagePtr->path, sizeof(storagePtr->path), "%s", pathPtr);
+    snprintf(storagePtr->checkpointPath, sizeof(storagePtr->checkpointPath), "%s.ckpt", pathPtr);
+
+    if (!isResume)
+    {
+        flags |= O_TRUNC;
+        unlink(storagePtr->checkpointPath);
+    }
+
+    if (PKG_STORAGE_MODE_DIRECT == mode)
+    {
+        storagePtr->fd = open(pathPtr, flags | O_DIRECT, 0600);
+        if ((0 > storagePtr->fd) && (EINVAL == errno))
+        {
+            printf("%s Direct I/O not supported for %s, using buffered writes\n",
+                   __func__, pathPtr);
+            storagePtr->mode = PKG_STORAGE_MODE_BUFFERED;
+        }
+    }
+    if (0 > storagePtr->fd)
+    {
+        storagePtr->fd = open(pathPtr, flags, 0600);
+    }
+    if ((0 > storagePtr->fd) || (0 != fstat(storagePtr->fd, &fileStat)))
+    {
+        printf("%s Failed to open %s: %s\n", __func__, pathPtr, strerror(errno));
+        ReleaseStorage(storagePtr);
+        return DWL_FAULT;
+    }
+    storagePtr->fileSize = (uint64_t)fileStat.st_size;
+
+    if (isResume)
+    {
+        storagePtr->checkpointLen = ReadCheckpointFile(storagePtr);
+        if (storagePtr->checkpointLen > storagePtr->fileSize)
+        {
+            printf("%s Incoherent checkpoint for %s, restarting\n", __func__, pathPtr);
+            storagePtr->checkpointLen = 0;
+        }
+        storagePtr->storedLen = storagePtr->checkpointLen;
+        storagePtr->writtenLen = storagePtr->checkpointLen;
+    }
+
+    if (DWL_OK != AllocateFile(storagePtr, expectedSize))
+    {
+        ReleaseStorage(storagePtr);
+        return DWL_FAULT;
+    }
+
+    if (PKG_STORAGE_MODE_MMAP == storagePtr->mode)
+    {
+        // The mapping needs a non-empty file
+        if (   (DWL_OK != AllocateFile(storagePtr, PKG_STORAGE_BUFFER_LEN))
+            || (MAP_FAILED == (storagePtr->mapPtr = mmap(NULL,
+                                                         (size_t)storagePtr->fileSize,
+                                                         PROT_READ | PROT_WRITE,
+                                                         MAP_SHARED,
+                                                         storagePtr->fd,
+                                                         0)))
+           )
+        {
+            printf("%s Failed to map %s: %s\n", __func__, pathPtr, strerror(errno));
+            storagePtr->mapPtr = NULL;
+            ReleaseStorage(storagePtr);
+            return DWL_FAULT;
+        }
+        return DWL_OK;
+    }
+
+    if (   (0 != posix_memalign((void**)&storagePtr->bufferPtr,
+                                PKG_STORAGE_ALIGN_LEN,
+                                PKG_STORAGE_BUFFER_LEN))
+        || (DWL_OK != LoadLastBlock(storagePtr))
+       )
+    {
+        printf("%s Failed to prepare the write buffer for %s\n", __func__, pathPtr);
+        ReleaseStorage(storagePtr);
+        return DWL_FAULT;
+    }
+
+    return DWL_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Store data in the package file.
+ *
+ * A checkpoint is automatically done once the checkpoint interval of data is stored.
+ *
+ * @return
+ *  - DWL_OK    The data are stored
+ *  - DWL_FAULT The data can't be stored
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_DwlResult_t PackageStorageWrite
+(
+    PackageStorage_t* storagePtr,   ///< [IN] Package storage context
+    const uint8_t*    bufPtr,       ///< [IN] Data to store
+    size_t            len           ///< [IN] Data length
+)
+{
+    if ((!storagePtr) || (0 > storagePtr->fd) || ((!bufPtr) && (len)))
+    {
+        return DWL_FAULT;
+    }
+
+    if (storagePtr->mapPtr)
+    {
+        if (DWL_OK != GrowFile(storagePtr, storagePtr->storedLen + len))
+        {
+            return DWL_FAULT;
+        }
+        memcpy(storagePtr->mapPtr + storagePtr->storedLen, bufPtr, len);
+        storagePtr->storedLen += len;
+        storagePtr->writtenLen = storagePtr->storedLen;
+    }
+    else
+    {
+        storagePtr->storedLen += len;
+        while (len)
+        {
+            size_t copyLen = PKG_STORAGE_BUFFER_LEN - storagePtr->bufferLen;
+
+            if (copyLen > len)
+            {
+                copyLen = len;
+            }
+            memcpy(storagePtr->bufferPtr + storagePtr->bufferLen, bufPtr, copyLen);
+            storagePtr->bufferLen += copyLen;
+            bufPtr += copyLen;
+            len -= copyLen;
+
+            // Full buffer: write it as a single aligned block
+            if (   (PKG_STORAGE_BUFFER_LEN == storagePtr->bufferLen)
+                && (DWL_OK != FlushBuffer(storagePtr, false))
+               )
+            {
+                return DWL_FAULT;
+            }
+        }
+    }
+
+    if ((storagePtr->storedLen - storagePtr->checkpointLen) >= storagePtr->checkpointInterval)
+    {
+        return PackageStorageCheckpoint(storagePtr);
+    }
+
+    return DWL_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Store data in the package file: storeRange callback of the package downloader, the context
+ * pointer of the package downloader being the package storage context.
+ *
+ * @return
+ *  - DWL_OK    The data are stored
+ *  - DWL_FAULT The data can't be stored
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_DwlResult_t PackageStorageStoreRange
+(
+    uint8_t* bufPtr,        ///< [IN] Buffer of data to store
+    size_t bufSize,         ///< [IN] Size of buffer to store
+    void* ctxPtr            ///< [IN] Package storage context
+)
+{
+    return PackageStorageWrite((PackageStorage_t*)ctxPtr, bufPtr, bufSize);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Commit the stored data to the file: the data are written and synchronized, and the committed
+ * length is saved in the checkpoint file.
+ *
+ * @note In direct mode, the last incomplete aligned block stays in the write buffer and is only
+ * committed by the next checkpoints or by PackageStorageClose().
+ *
+ * @return
+ *  - DWL_OK    The checkpoint is done
+ *  - DWL_FAULT The checkpoint failed
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_DwlResult_t PackageStorageCheckpoint
+(
+    PackageStorage_t* storagePtr    ///< [IN] Package storage context
+)
+{
+    if ((!storagePtr) || (0 > storagePtr->fd))
+    {
+        return DWL_FAULT;
+    }
+
+    if (storagePtr->mapPtr)
+    {
+        // msync needs a page-aligned address
+        uint64_t syncOffset = AlignDown(storagePtr->checkpointLen);
+
+        if (   (storagePtr->writtenLen > syncOffset)
+            && (0 != msync(storagePtr->mapPtr + syncOffset,
+                           (size_t)(storagePtr->writtenLen - syncOffset),
+                           MS_SYNC))
+           )
+        {
+            printf("%s Failed to synchronize %s: %s\n",
+                   __func__, storagePtr->path, strerror(errno));
+            return DWL_FAULT;
+        }
+    }
+    else
+    {
+        if (DWL_OK != FlushBuffer(storagePtr, false))
+        {
+            return DWL_FAULT;
+        }
+        if (0 != fdatasync(storagePtr->fd))
+        {
+            printf("%s Failed to synchronize %s: %s\n",
+                   __func__, storagePtr->path, strerror(errno));
+            return DWL_FAULT;
+        }
+    }
+
+    if (storagePtr->writtenLen == storagePtr->checkpointLen)
+    {
+        return DWL_OK;
+    }
+    storagePtr->checkpointLen = storagePtr->writtenLen;
+
+    return WriteCheckpointFile(storagePtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the length of data committed at the last checkpoint
+ *
+ * @return
+ *  - Committed data length
+ */
+//--------------------------------------------------------------------------------------------------
+uint64_t PackageStorageGetCommittedLen
+(
+    const PackageStorage_t* storagePtr  ///< [IN] Package storage context
+)
+{
+    if (!storagePtr)
+    {
+        return 0;
+    }
+
+    return storagePtr->checkpointLen;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Close the package file.
+ *
+ * When the download is complete, all the stored data are committed, the file is truncated to the
+ * stored length and the checkpoint file is deleted. Otherwise (e.g. suspended download), a
+ * checkpoint is done and the download can be resumed from it.
+ *
+ * @return
+ *  - DWL_OK    The file is closed
+ *  - DWL_FAULT The stored data can't be committed
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_DwlResult_t PackageStorageClose
+(
+    PackageStorage_t* storagePtr,   ///< [IN] Package storage context
+    bool              isComplete    ///< [IN] All the package data are stored
+)
+{
+    lwm2mcore_DwlResult_t result = DWL_OK;
+
+    if ((!storagePtr) || (0 > storagePtr->fd))
+    {
+        return DWL_FAULT;
+    }
+
+    if (!isComplete)
+    {
+        result = PackageStorageCheckpoint(storagePtr);
+        ReleaseStorage(storagePtr);
+        return result;
+    }
+
+    if (storagePtr->mapPtr)
+    {
+        if (0 != msync(storagePtr->mapPtr, (size_t)storagePtr->storedLen, MS_SYNC))
+        {
+            result = DWL_FAULT;
+        }
+        munmap(storagePtr->mapPtr, (size_t)storagePtr->fileSize);
+        storagePtr->mapPtr = NULL;
+    }
+    else if (DWL_OK != FlushBuffer(storagePtr, true))
+    {
+        result = DWL_FAULT;
+    }
+
+    // Remove the preallocated blocks and the padding after the stored data
+    if (   (DWL_OK == result)
+        && (   (0 != ftruncate(storagePtr->fd, (off_t)storagePtr->storedLen))
+            || (0 != fsync(storagePtr->fd))
+           )
+       )
+    {
+        printf("%s Failed to commit %s: %s\n", __func__, storagePtr->path, strerror(errno));
+        result = DWL_FAULT;
+    }
+
+    if (DWL_OK == result)
+    {
+        storagePtr->checkpointLen = storagePtr->storedLen;
+        unlink(storagePtr->checkpointPath);
+    }
+
+    ReleaseStorage(storagePtr);
+    return result;
+}
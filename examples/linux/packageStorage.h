@@ -0,0 +1,199 @@
+/**
+ * @file packageStorage.h
+ *
+ * Storage backend of the downloaded packages for the Linux client.
+ *
+ * The binary data given to the storeRange callback of the package downloader are written to a
+ * file preallocated from the package size. Small data chunks are coalesced into large aligned
+ * writes, and the file is only synchronized at checkpoint boundaries: the length of data
+ * committed to the file at the last checkpoint is the update offset to give to the package
+ * downloader when the download is resumed.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#ifndef _PACKAGESTORAGE_H_
+#define _PACKAGESTORAGE_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <packageDownloader/lwm2mcorePackageDownloader.h>
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximal length of the package file path
+ */
+//--------------------------------------------------------------------------------------------------
+#define PKG_STORAGE_PATH_MAX_LEN        256
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Length of the write buffer coalescing the stored data chunks. It is a multiple of
+ * PKG_STORAGE_ALIGN_LEN.
+ */
+//--------------------------------------------------------------------------------------------------
+#define PKG_STORAGE_BUFFER_LEN          (1024 * 1024)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Alignment of the file offsets, lengths and buffer addresses of the direct I/O writes
+ */
+//--------------------------------------------------------------------------------------------------
+#define PKG_STORAGE_ALIGN_LEN           4096
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Default length of stored data between two checkpoints
+ */
+//--------------------------------------------------------------------------------------------------
+#define PKG_STORAGE_CHECKPOINT_LEN      (4 * 1024 * 1024)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Package file write modes
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    PKG_STORAGE_MODE_BUFFERED,      ///< Coalesced writes through the page cache
+    PKG_STORAGE_MODE_DIRECT,        ///< Coalesced aligned writes bypassing the page cache
+                                    ///< (O_DIRECT), buffered mode if not supported by the file
+                                    ///< system
+    PKG_STORAGE_MODE_MMAP           ///< Copy into a shared memory mapping of the file
+}
+PackageStorageMode_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Package storage context
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char                 path[PKG_STORAGE_PATH_MAX_LEN];        ///< Package file path
+    char                 checkpointPath[PKG_STORAGE_PATH_MAX_LEN + 8]; ///< Checkpoint file path
+    PackageStorageMode_t mode;              ///< Write mode
+    int                  fd;                ///< Package file descriptor
+    uint64_t             fileSize;          ///< Allocated file size
+    uint64_t             storedLen;         ///< Length of data given to the storage
+    uint64_t             writtenLen;        ///< Length of data written to the file
+    uint64_t             checkpointLen;     ///< Length of data committed at the last checkpoint
+    uint64_t             checkpointInterval;///< Length of stored data between two checkpoints
+    uint8_t*             bufferPtr;         ///< Aligned write buffer (buffered and direct modes)
+    size_t               bufferLen;         ///< Length of data in the write buffer
+    uint8_t*             mapPtr;            ///< File mapping (mmap mode)
+}
+PackageStorage_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Open the package file.
+ *
+ * The file is preallocated to the expected size. When the download is resumed, the existing file
+ * is opened and the stored data are truncated to the last checkpoint: the update offset of the
+ * package downloader should then be set to the value returned by
+ * PackageStorageGetCommittedLen().
+ *
+ * @return
+ *  - DWL_OK    The file is opened
+ *  - DWL_FAULT The file can't be opened or allocated
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_DwlResult_t PackageStorageOpen
+(
+    PackageStorage_t*    storagePtr,    ///< [OUT] Package storage context
+    const char*          pathPtr,       ///< [IN] Package file path
+    uint64_t             expectedSize,  ///< [IN] Expected size of the stored data, used to
+                                        ///<      preallocate the file (e.g. the package size)
+    PackageStorageMode_t mode,          ///< [IN] Write mode
+    bool                 isResume       ///< [IN] Resume a previous download
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Store data in the package file.
+ *
+ * A checkpoint is automatically done once the checkpoint interval of data is stored.
+ *
+ * @return
+ *  - DWL_OK    The data are stored
+ *  - DWL_FAULT The data can't be stored
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_DwlResult_t PackageStorageWrite
+(
+    PackageStorage_t* storagePtr,   ///< [IN] Package storage context
+    const uint8_t*    bufPtr,       ///< [IN] Data to store
+    size_t            len           ///< [IN] Data length
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Store data in the package file: storeRange callback of the package downloader, the context
+ * pointer of the package downloader being the package storage context.
+ *
+ * @return
+ *  - DWL_OK    The data are stored
+ *  - DWL_FAULT The data can't be stored
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_DwlResult_t PackageStorageStoreRange
+(
+    uint8_t* bufPtr,        ///< [IN] Buffer of data to store
+    size_t bufSize,         ///< [IN] Size of buffer to store
+    void* ctxPtr            ///< [IN] Package storage context
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Commit the stored data to the file: the data are written and synchronized, and the committed
+ * length is saved in the checkpoint file.
+ *
+ * @note In direct mode, the last incomplete aligned block stays in the write buffer and is only
+ * committed by the next checkpoints or by PackageStorageClose().
+ *
+ * @return
+ *  - DWL_OK    The checkpoint is done
+ *  - DWL_FAULT The checkpoint failed
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_DwlResult_t PackageStorageCheckpoint
+(
+    PackageStorage_t* storagePtr    ///< [IN] Package storage context
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the length of data committed at the last checkpoint
+ *
+ * @return
+ *  - Committed data length
+ */
+//--------------------------------------------------------------------------------------------------
+uint64_t PackageStorageGetCommittedLen
+(
+    const PackageStorage_t* storagePtr  ///< [IN] Package storage context
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Close the package file.
+ *
+ * When the download is complete, all the stored data are committed, the file is truncated to the
+ * stored length and the checkpoint file is deleted. Otherwise (e.g. suspended download), a
+ * checkpoint is done and the download can be resumed from it.
+ *
+ * @return
+ *  - DWL_OK    The file is closed
+ *  - DWL_FAULT The stored data can't be committed
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_DwlResult_t PackageStorageClose
+(
+    PackageStorage_t* storagePtr,   ///< [IN] Package storage context
+    bool              isComplete    ///< [IN] All the package data are stored
+);
+
+#endif /* _PACKAGESTORAGE_H_ */
@@ -1,22 +1,48 @@
 /**
  * @file paramStorage.c
  *
- * Porting layer for parameter storage in platform memory
+ * Porting layer for parameter storage in platform memory, see paramStore.h
+ *
+ * The store file starts with a header (magic and version) followed by the records:
+ *
+ *  | CRC (4) | magic (2) | type (1) | parameter Id (1) | value length (4) | value |
+ *
+ * The CRC32 covers the record from the magic to the end of the value. A record is written with a
+ * single pwrite at the end of the file followed by fdatasync(), and the in-memory index is only
+ * updated once the record is synchronized. When the file is loaded, the records are replayed up to
+ * the first invalid one (truncated record, bad magic or CRC) and the file is truncated there.
+ *
+ * The compaction writes the store header and the live records in a temporary file, synchronizes
+ * it and renames it to the store file: the store file is always either the old or the new one.
  *
  * Copyright (C) Sierra Wireless Inc.
  *
  */
 
+#include <errno.h>
+#include <fcntl.h>
+#include <libgen.h>
 #include <stdio.h>
 #include <stdint.h>
 #include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <zlib.h>
 #include <platform/types.h>
 #include <lwm2mcore/lwm2mcore.h>
 #include <lwm2mcore/paramStorage.h>
+#include "paramStore.h"
+
+//--------------------------------------------------------------------------------------------------
+// Symbol and Enum definitions
+//--------------------------------------------------------------------------------------------------
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Configuration filename
+ * Legacy configuration filename prefix (one configN.txt and configN.bak file pair per parameter),
+ * imported when the store file is created
  */
 //--------------------------------------------------------------------------------------------------
 #define CONFIG_FILENAME             "config"
@@ -30,65 +56,800 @@
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Configuration file maximum length
+ * Store file magic
  */
 //--------------------------------------------------------------------------------------------------
-#define CONFIG_FILE_MAX_LENGTH      200
+#define STORE_MAGIC                 "LWPS"
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Write parameter in platform memory
+ * Store file format version
+ */
+//--------------------------------------------------------------------------------------------------
+#define STORE_VERSION               1
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Store file header length: magic and version
+ */
+//--------------------------------------------------------------------------------------------------
+#define STORE_HEADER_LEN            8
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Record magic
+ */
+//--------------------------------------------------------------------------------------------------
+#define RECORD_MAGIC                0x5052
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Record header length: CRC, magic, type, parameter Id and value length
+ */
+//--------------------------------------------------------------------------------------------------
+#define RECORD_HEADER_LEN           12
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Record types
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    RECORD_TYPE_SET    = 1,         ///< Parameter value
+    RECORD_TYPE_DELETE = 2          ///< Parameter deletion
+}
+RecordType_t;
+
+//--------------------------------------------------------------------------------------------------
+// Data structures
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Index entry of a parameter
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    bool     isSet;                 ///< Parameter is stored
+    uint64_t valueOffset;           ///< File offset of the last value
+    uint32_t len;                   ///< Length of the last value
+}
+ParamEntry_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parameter store context
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char              path[PARAM_STORE_PATH_MAX_LEN];       ///< Store file path
+    char              tmpPath[PARAM_STORE_PATH_MAX_LEN + 4];///< Compaction file path
+    int               fd;                                   ///< Store file descriptor
+    uint64_t          endOffset;                            ///< End of the last valid record
+    ParamEntry_t      entries[LWM2MCORE_MAX_PARAM];         ///< Index of the parameters
+    ParamStoreStats_t stats;                                ///< Statistics
+}
+Store_t;
+
+//--------------------------------------------------------------------------------------------------
+// Static variables
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parameter store
+ */
+//--------------------------------------------------------------------------------------------------
+static Store_t Store = { .fd = -1 };
+
+//--------------------------------------------------------------------------------------------------
+// Static functions
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fill a record header and compute its CRC
+ */
+//--------------------------------------------------------------------------------------------------
+static void BuildRecordHeader
+(
+    uint8_t*          headerPtr,    ///< [OUT] Record header (RECORD_HEADER_LEN bytes)
+    RecordType_t      type,         ///< [IN] Record type
+    lwm2mcore_Param_t paramId,      ///< [IN] Parameter Id
+    const uint8_t*    valuePtr,     ///< [IN] Value
+    uint32_t          len           ///< [IN] Value length
+)
+{
+    uint16_t magic = RECORD_MAGIC;
+    uint32_t crc;
+
+    memcpy(headerPtr + 4, &magic, sizeof(magic));
+    headerPtr[6] = (uint8_t)type;
+    headerPtr[7] = (uint8_t)paramId;
+    memcpy(headerPtr + 8, &len, sizeof(len));
+
+    crc = crc32(0L, headerPtr + 4, RECORD_HEADER_LEN - 4);
+    if (len)
+    {
+        crc = crc32(crc, valuePtr, len);
+    }
+    memcpy(headerPtr, &crc, sizeof(crc));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a buffer at the given offset of a file
  *
  * @return
- *      - LWM2MCORE_ERR_COMPLETED_OK if the treatment succeeds
- *      - LWM2MCORE_ERR_GENERAL_ERROR if the treatment fails
- *      - LWM2MCORE_ERR_INVALID_ARG if a parameter is invalid in resource handler
+ *      - true if the buffer is written
+ *      - false otherwise
  */
 //--------------------------------------------------------------------------------------------------
-lwm2mcore_Sid_t lwm2mcore_SetParam
+static bool WriteAt
 (
+    int            fd,          ///< [IN] File descriptor
+    const uint8_t* bufPtr,      ///< [IN] Buffer to write
+    size_t         len,         ///< [IN] Buffer length
+    uint64_t       offset       ///< [IN] File offset
+)
+{
+    while (len)
+    {
+        ssize_t writtenLen = pwrite(fd, bufPtr, len, (off_t)offset);
+        if (0 > writtenLen)
+        {
+            if (EINTR == errno)
+            {
+                continue;
+            }
+            return false;
+        }
+        bufPtr += writtenLen;
+        len -= (size_t)writtenLen;
+        offset += (uint64_t)writtenLen;
+    }
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read a buffer at the given offset of a file
+ *
+ * @return
+ *      - true if the whole buffer is read
+ *      - false otherwise
+ */
+//--------------------------------------------------------------------------------------------------
+static bool ReadAt
+(
+    int      fd,                ///< [IN] File descriptor
+    uint8_t* bufPtr,            ///< [OUT] Buffer
+    size_t   len,               ///< [IN] Length to read
+    uint64_t offset             ///< [IN] File offset
+)
+{
+    while (len)
+    {
+        ssize_t readLen = pread(fd, bufPtr, len, (off_t)offset);
+        if (0 >= readLen)
+        {
+            if ((0 > readLen) && (EINTR == errno))
+            {
+                continue;
+            }
+            return false;
+        }
+        bufPtr += readLen;
+        len -= (size_t)readLen;
+        offset += (uint64_t)readLen;
+    }
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Synchronize the directory of the store file, so that a created or renamed store file survives a
+ * power loss
+ */
+//--------------------------------------------------------------------------------------------------
+static void SyncDirectory
+(
+    void
+)
+{
+    char path[PARAM_STORE_PATH_MAX_LEN];
+    int fd;
+
+    memcpy(path, Store.path, sizeof(path));
+    fd = open(dirname(path), O_RDONLY | O_DIRECTORY);
+    if (0 <= fd)
+    {
+        fsync(fd);
+        close(fd);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append a record to the store file and update the index once the record is committed
+ *
+ * @return
+ *      - LWM2MCORE_ERR_COMPLETED_OK if the record is committed
+ *      - LWM2MCORE_ERR_GENERAL_ERROR otherwise, the store being unchanged
+ */
+//--------------------------------------------------------------------------------------------------
+static lwm2mcore_Sid_t AppendRecord
+(
+    RecordType_t      type,         ///< [IN] Record type
     lwm2mcore_Param_t paramId,      ///< [IN] Parameter Id
-    uint8_t* bufferPtr,             ///< [IN] Data buffer
-    size_t len                      ///< [IN] Length of input buffer
+    const uint8_t*    valuePtr,     ///< [IN] Value
+    uint32_t          len           ///< [IN] Value length
 )
 {
-    FILE* fPtr = NULL;
-    char fname0[CONFIG_FILENAME_MAX_LENGTH];
-    char fname1[CONFIG_FILENAME_MAX_LENGTH];
+    ParamEntry_t* entryPtr = &Store.entries[paramId];
+    uint8_t* recordPtr = (uint8_t*)malloc(RECORD_HEADER_LEN + len);
 
-    if ((LWM2MCORE_MAX_PARAM <= paramId) || (NULL == bufferPtr))
+    if (!recordPtr)
     {
-        return LWM2MCORE_ERR_INVALID_ARG;
+        return LWM2MCORE_ERR_GENERAL_ERROR;
     }
 
-    sprintf(fname0, "%s%d.txt", CONFIG_FILENAME, paramId);
-    sprintf(fname1, "%s%d.bak", CONFIG_FILENAME, paramId);
+    BuildRecordHeader(recordPtr, type, paramId, valuePtr, len);
+    if (len)
+    {
+        memcpy(recordPtr + RECORD_HEADER_LEN, valuePtr, len);
+    }
 
-    if (NULL != (fPtr = fopen(fname0, "w")))
+    // Single write of the whole record, then commit
+    if (   (!WriteAt(Store.fd, recordPtr, RECORD_HEADER_LEN + len, Store.endOffset))
+        || (0 != fdatasync(Store.fd))
+       )
     {
-        if (fwrite(bufferPtr, 1, len, fPtr) != len)
+        printf("%s Failed to write %s: %s\n", __func__, Store.path, strerror(errno));
+        free(recordPtr);
+
+        // Remove the partial record, it would be discarded by the next load anyway
+        if (0 != ftruncate(Store.fd, (off_t)Store.endOffset))
         {
-            fclose(fPtr);
-            printf("%s Failed to write file: %s\n", __func__, fname0);
-            return LWM2MCORE_ERR_GENERAL_ERROR;
+            printf("%s Failed to truncate %s\n", __func__, Store.path);
+        }
+        return LWM2MCORE_ERR_GENERAL_ERROR;
+    }
+    free(recordPtr);
+
+    // The previous record of the parameter and the deletion records are obsolete
+    if (entryPtr->isSet)
+    {
+        Store.stats.liveLen -= RECORD_HEADER_LEN + entryPtr->len;
+        Store.stats.deadLen += RECORD_HEADER_LEN + entryPtr->len;
+    }
+    if (RECORD_TYPE_SET == type)
+    {
+        entryPtr->isSet = true;
+        entryPtr->valueOffset = Store.endOffset + RECORD_HEADER_LEN;
+        entryPtr->len = len;
+        Store.stats.liveLen += RECORD_HEADER_LEN + len;
+    }
+    else
+    {
+        entryPtr->isSet = false;
+        Store.stats.deadLen += RECORD_HEADER_LEN;
+    }
+    Store.endOffset += RECORD_HEADER_LEN + len;
+    Store.stats.fileLen = Store.endOffset;
+    Store.stats.recordNb++;
+
+    return LWM2MCORE_ERR_COMPLETED_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Replay the records of the store file in the index. The file is truncated after the last valid
+ * record.
+ *
+ * @return
+ *      - true if the store file is loaded
+ *      - false if the store file is not a valid store file
+ */
+//--------------------------------------------------------------------------------------------------
+static bool LoadStore
+(
+    void
+)
+{
+    struct stat st;
+    uint8_t* filePtr;
+    uint64_t offset = STORE_HEADER_LEN;
+    uint32_t version = STORE_VERSION;
+
+    if ((0 != fstat(Store.fd, &st)) || (STORE_HEADER_LEN > st.st_size))
+    {
+        return false;
+    }
+
+    filePtr = (uint8_t*)malloc((size_t)st.st_size);
+    if (!filePtr)
+    {
+        return false;
+    }
+
+    if (   (!ReadAt(Store.fd, filePtr, (size_t)st.st_size, 0))
+        || (0 != memcmp(filePtr, STORE_MAGIC, 4))
+        || (0 != memcmp(filePtr + 4, &version, sizeof(version)))
+       )
+    {
+        free(filePtr);
+        return false;
+    }
+
+    while (RECORD_HEADER_LEN <= ((uint64_t)st.st_size - offset))
+    {
+        uint8_t* recordPtr = filePtr + offset;
+        uint8_t header[RECORD_HEADER_LEN];
+        ParamEntry_t* entryPtr;
+        uint32_t len;
+
+        memcpy(&len, recordPtr + 8, sizeof(len));
+        if (   (PARAM_STORE_VALUE_MAX_LEN < len)
+            || ((RECORD_HEADER_LEN + len) > ((uint64_t)st.st_size - offset))
+            || (LWM2MCORE_MAX_PARAM <= recordPtr[7])
+            || ((RECORD_TYPE_SET != recordPtr[6]) && (RECORD_TYPE_DELETE != recordPtr[6]))
+           )
+        {
+            break;
+        }
+
+        BuildRecordHeader(header,
+                          (RecordType_t)recordPtr[6],
+                          (lwm2mcore_Param_t)recordPtr[7],
+                          recordPtr + RECORD_HEADER_LEN,
+                          len);
+        if (0 != memcmp(header, recordPtr, RECORD_HEADER_LEN))
+        {
+            break;
+        }
+
+        entryPtr = &Store.entries[recordPtr[7]];
+        if (entryPtr->isSet)
+        {
+            Store.stats.liveLen -= RECORD_HEADER_LEN + entryPtr->len;
+            Store.stats.deadLen += RECORD_HEADER_LEN + entryPtr->len;
+        }
+        if (RECORD_TYPE_SET == recordPtr[6])
+        {
+            entryPtr->isSet = true;
+            entryPtr->valueOffset = offset + RECORD_HEADER_LEN;
+            entryPtr->len = len;
+            Store.stats.liveLen += RECORD_HEADER_LEN + len;
+        }
+        else
+        {
+            entryPtr->isSet = false;
+            Store.stats.deadLen += RECORD_HEADER_LEN;
+        }
+        Store.stats.recordNb++;
+        offset += RECORD_HEADER_LEN + len;
+    }
+    free(filePtr);
+
+    if (offset < (uint64_t)st.st_size)
+    {
+        // Record interrupted by a crash or corrupted
+        Store.stats.discardedLen = (uint32_t)((uint64_t)st.st_size - offset);
+        printf("%s Discard %u invalid bytes at offset %llu of %s\n", __func__,
+               Store.stats.discardedLen, (unsigned long long)offset, Store.path);
+        if ((0 != ftruncate(Store.fd, (off_t)offset)) || (0 != fdatasync(Store.fd)))
+        {
+            printf("%s Failed to truncate %s\n", __func__, Store.path);
+        }
+    }
+    Store.endOffset = offset;
+    Store.stats.fileLen = offset;
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a store file containing the store header and the live records of the current store
+ *
+ * @return
+ *      - File descriptor of the synchronized file
+ *      - -1 if the file can't be written
+ */
+//--------------------------------------------------------------------------------------------------
+static int WriteStoreFile
+(
+    const char*   pathPtr,                          ///< [IN] File path
+    ParamEntry_t  entries[LWM2MCORE_MAX_PARAM]      ///< [OUT] Index of the new file
+)
+{
+    uint8_t storeHeader[STORE_HEADER_LEN];
+    uint32_t version = STORE_VERSION;
+    uint64_t offset = STORE_HEADER_LEN;
+    int paramId;
+    int fd = open(pathPtr, O_RDWR | O_CREAT | O_TRUNC, 0600);
+
+    if (0 > fd)
+    {
+        printf("%s Failed to open %s: %s\n", __func__, pathPtr, strerror(errno));
+        return -1;
+    }
+
+    memcpy(storeHeader, STORE_MAGIC, 4);
+    memcpy(storeHeader + 4, &version, sizeof(version));
+    if (!WriteAt(fd, storeHeader, sizeof(storeHeader), 0))
+    {
+        close(fd);
+        return -1;
+    }
+
+    memset(entries, 0, sizeof(ParamEntry_t) * LWM2MCORE_MAX_PARAM);
+    for (paramId = 0; paramId < LWM2MCORE_MAX_PARAM; paramId++)
+    {
+        ParamEntry_t* entryPtr = &Store.entries[paramId];
+        uint8_t* recordPtr;
+        bool isWritten;
+
+        if (!entryPtr->isSet)
+        {
+            continue;
+        }
+
+        recordPtr = (uint8_t*)malloc(RECORD_HEADER_LEN + entryPtr->len);
+        if (!recordPtr)
+        {
+            close(fd);
+            return -1;
+        }
+
+        isWritten = ReadAt(Store.fd,
+                           recordPtr + RECORD_HEADER_LEN,
+                           entryPtr->len,
+                           entryPtr->valueOffset);
+        if (isWritten)
+        {
+            BuildRecordHeader(recordPtr,
+                              RECORD_TYPE_SET,
+                              (lwm2mcore_Param_t)paramId,
+                              recordPtr + RECORD_HEADER_LEN,
+                              entryPtr->len);
+            isWritten = WriteAt(fd, recordPtr, RECORD_HEADER_LEN + entryPtr->len, offset);
+        }
+        free(recordPtr);
+
+        if (!isWritten)
+        {
+            printf("%s Failed to copy parameter %d to %s\n", __func__, paramId, pathPtr);
+            close(fd);
+            return -1;
         }
-        fclose(fPtr);
+
+        entries[paramId].isSet = true;
+        entries[paramId].valueOffset = offset + RECORD_HEADER_LEN;
+        entries[paramId].len = entryPtr->len;
+        offset += RECORD_HEADER_LEN + entryPtr->len;
+    }
+
+    if (0 != fsync(fd))
+    {
+        printf("%s Failed to synchronize %s: %s\n", __func__, pathPtr, strerror(errno));
+        close(fd);
+        return -1;
     }
 
-    if (NULL != (fPtr = fopen(fname1, "w")))
+    return fd;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Import the parameters of the legacy configN.txt and configN.bak files in the store, and delete
+ * the legacy files once imported
+ */
+//--------------------------------------------------------------------------------------------------
+static void ImportLegacyFiles
+(
+    void
+)
+{
+    int paramId;
+
+    for (paramId = 0; paramId < LWM2MCORE_MAX_PARAM; paramId++)
     {
-        if (fwrite(bufferPtr, 1, len, fPtr) != len)
+        char fname0[CONFIG_FILENAME_MAX_LENGTH];
+        char fname1[CONFIG_FILENAME_MAX_LENGTH];
+        const char* fnames[2] = { fname0, fname1 };
+        int i;
+
+        snprintf(fname0, sizeof(fname0), "%s%d.txt", CONFIG_FILENAME, paramId);
+        snprintf(fname1, sizeof(fname1), "%s%d.bak", CONFIG_FILENAME, paramId);
+
+        for (i = 0; i < 2; i++)
         {
+            FILE* fPtr = fopen(fnames[i], "r");
+            uint8_t* bufferPtr;
+            long len;
+            bool isImported = false;
+
+            if (NULL == fPtr)
+            {
+                continue;
+            }
+
+            fseek(fPtr, 0, SEEK_END);
+            len = ftell(fPtr);
+            rewind(fPtr);
+
+            if ((0 < len) && (PARAM_STORE_VALUE_MAX_LEN >= len))
+            {
+                bufferPtr = (uint8_t*)malloc((size_t)len);
+                if (   (bufferPtr)
+                    && ((size_t)len == fread(bufferPtr, 1, (size_t)len, fPtr))
+                   )
+                {
+                    isImported = (LWM2MCORE_ERR_COMPLETED_OK == AppendRecord(RECORD_TYPE_SET,
+                                                                   (lwm2mcore_Param_t)paramId,
+                                                                   bufferPtr,
+                                                                   (uint32_t)len));
+                }
+                free(bufferPtr);
+            }
             fclose(fPtr);
-            printf("%s Failed to write file: %s\n", __func__, fname1);
+
+            if (isImported)
+            {
+                printf("%s Parameter %d imported from %s\n", __func__, paramId, fnames[i]);
+                remove(fname0);
+                remove(fname1);
+                break;
+            }
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Open the parameter store with the default file if it is not opened
+ *
+ * @return
+ *      - true if the store is opened
+ *      - false otherwise
+ */
+//--------------------------------------------------------------------------------------------------
+static bool CheckStore
+(
+    void
+)
+{
+    if (0 <= Store.fd)
+    {
+        return true;
+    }
+
+    return (LWM2MCORE_ERR_COMPLETED_OK == ParamStoreOpen(PARAM_STORE_FILENAME));
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public functions
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Open the parameter store and load its index.
+ *
+ * @return
+ *      - LWM2MCORE_ERR_COMPLETED_OK if the store is opened
+ *      - LWM2MCORE_ERR_INVALID_ARG if the path is invalid
+ *      - LWM2MCORE_ERR_GENERAL_ERROR if the store file can't be opened or created
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_Sid_t ParamStoreOpen
+(
+    const char* pathPtr         ///< [IN] Store file path
+)
+{
+    ParamEntry_t entries[LWM2MCORE_MAX_PARAM];
+    bool isCreated = false;
+
+    if ((NULL == pathPtr) || (PARAM_STORE_PATH_MAX_LEN <= strlen(pathPtr)))
+    {
+        return LWM2MCORE_ERR_INVALID_ARG;
+    }
+
+    ParamStoreClose();
+    strcpy(Store.path, pathPtr);
+    snprintf(Store.tmpPath, sizeof(Store.tmpPath), "%s.tmp", pathPtr);
+
+    // Compaction interrupted before the rename: the store file is still valid
+    remove(Store.tmpPath);
+
+    Store.fd = open(Store.path, O_RDWR);
+    if ((0 <= Store.fd) && (!LoadStore()))
+    {
+        printf("%s Invalid store file %s, recreate it\n", __func__, Store.path);
+        close(Store.fd);
+        Store.fd = -1;
+        memset(Store.entries, 0, sizeof(Store.entries));
+        memset(&Store.stats, 0, sizeof(Store.stats));
+    }
+
+    if (0 > Store.fd)
+    {
+        // Create an empty store file atomically
+        Store.fd = WriteStoreFile(Store.tmpPath, entries);
+        if ((0 > Store.fd) || (0 != rename(Store.tmpPath, Store.path)))
+        {
+            printf("%s Failed to create %s\n", __func__, Store.path);
+            ParamStoreClose();
             return LWM2MCORE_ERR_GENERAL_ERROR;
         }
-        fclose(fPtr);
+        SyncDirectory();
+        Store.endOffset = STORE_HEADER_LEN;
+        Store.stats.fileLen = STORE_HEADER_LEN;
+        isCreated = true;
+    }
+
+    if (isCreated)
+    {
+        ImportLegacyFiles();
     }
 
     return LWM2MCORE_ERR_COMPLETED_OK;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Close the parameter store
+ */
+//--------------------------------------------------------------------------------------------------
+void ParamStoreClose
+(
+    void
+)
+{
+    if (0 <= Store.fd)
+    {
+        close(Store.fd);
+    }
+    memset(&Store, 0, sizeof(Store));
+    Store.fd = -1;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if a compaction of the parameter store is requested
+ *
+ * @return
+ *      - true if obsolete records should be removed by ParamStoreCompact()
+ *      - false otherwise
+ */
+//--------------------------------------------------------------------------------------------------
+bool ParamStoreIsCompactionNeeded
+(
+    void
+)
+{
+    return (   (0 <= Store.fd)
+            && (PARAM_STORE_COMPACT_MIN_DEAD_LEN <= Store.stats.deadLen)
+            && (Store.stats.liveLen <= Store.stats.deadLen));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compact the parameter store
+ *
+ * @return
+ *      - LWM2MCORE_ERR_COMPLETED_OK if the store is compacted
+ *      - LWM2MCORE_ERR_INVALID_STATE if the store is not opened
+ *      - LWM2MCORE_ERR_GENERAL_ERROR if the compaction failed, the store being unchanged
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_Sid_t ParamStoreCompact
+(
+    void
+)
+{
+    ParamEntry_t entries[LWM2MCORE_MAX_PARAM];
+    int fd;
+
+    if (0 > Store.fd)
+    {
+        return LWM2MCORE_ERR_INVALID_STATE;
+    }
+
+    fd = WriteStoreFile(Store.tmpPath, entries);
+    if (0 > fd)
+    {
+        remove(Store.tmpPath);
+        return LWM2MCORE_ERR_GENERAL_ERROR;
+    }
+
+    if (0 != rename(Store.tmpPath, Store.path))
+    {
+        printf("%s Failed to rename %s: %s\n", __func__, Store.tmpPath, strerror(errno));
+        close(fd);
+        remove(Store.tmpPath);
+        return LWM2MCORE_ERR_GENERAL_ERROR;
+    }
+    SyncDirectory();
+
+    close(Store.fd);
+    Store.fd = fd;
+    memcpy(Store.entries, entries, sizeof(entries));
+    Store.endOffset = STORE_HEADER_LEN + Store.stats.liveLen;
+    Store.stats.fileLen = Store.endOffset;
+    Store.stats.deadLen = 0;
+    Store.stats.compactionNb++;
+
+    return LWM2MCORE_ERR_COMPLETED_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the parameter store statistics
+ */
+//--------------------------------------------------------------------------------------------------
+void ParamStoreGetStats
+(
+    ParamStoreStats_t* statsPtr     ///< [OUT] Statistics
+)
+{
+    if (statsPtr)
+    {
+        memcpy(statsPtr, &Store.stats, sizeof(ParamStoreStats_t));
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write parameter in platform memory
+ *
+ * @return
+ *      - LWM2MCORE_ERR_COMPLETED_OK if the treatment succeeds
+ *      - LWM2MCORE_ERR_GENERAL_ERROR if the treatment fails
+ *      - LWM2MCORE_ERR_INVALID_ARG if a parameter is invalid in resource handler
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_Sid_t lwm2mcore_SetParam
+(
+    lwm2mcore_Param_t paramId,      ///< [IN] Parameter Id
+    uint8_t* bufferPtr,             ///< [IN] Data buffer
+    size_t len                      ///< [IN] Length of input buffer
+)
+{
+    lwm2mcore_Sid_t sid;
+
+    if (   (LWM2MCORE_MAX_PARAM <= paramId)
+        || (NULL == bufferPtr)
+        || (PARAM_STORE_VALUE_MAX_LEN < len)
+       )
+    {
+        return LWM2MCORE_ERR_INVALID_ARG;
+    }
+
+    if (!CheckStore())
+    {
+        return LWM2MCORE_ERR_GENERAL_ERROR;
+    }
+
+    sid = AppendRecord(RECORD_TYPE_SET, paramId, bufferPtr, (uint32_t)len);
+
+    // Bound the store file size if the client is never idle
+    if (   (LWM2MCORE_ERR_COMPLETED_OK == sid)
+        && (PARAM_STORE_COMPACT_MAX_DEAD_LEN <= Store.stats.deadLen)
+       )
+    {
+        ParamStoreCompact();
+    }
+
+    return sid;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Read parameter from platform memory
@@ -106,51 +867,36 @@ lwm2mcore_Sid_t lwm2mcore_GetParam
     size_t* lenPtr                  ///< [INOUT] Length of input buffer
 )
 {
-    FILE* fPtr = NULL;
-    int bsize = *lenPtr;
-    int rsize = 0;
-    char fname0[CONFIG_FILENAME_MAX_LENGTH];
-    char fname1[CONFIG_FILENAME_MAX_LENGTH];
+    ParamEntry_t* entryPtr;
+    size_t len;
 
     if ((LWM2MCORE_MAX_PARAM <= paramId) || (NULL == bufferPtr) || (NULL == lenPtr))
     {
         return LWM2MCORE_ERR_INVALID_ARG;
     }
 
-    sprintf(fname0, "%s%d.txt", CONFIG_FILENAME, paramId);
-    sprintf(fname1, "%s%d.bak", CONFIG_FILENAME, paramId);
-
-    if (NULL != (fPtr = fopen(fname0, "r")))
+    if (!CheckStore())
     {
-        if ((rsize = fread(bufferPtr, 1, bsize, fPtr)) == 0)
-        {
-            printf("Failed to read file %s\n", fname0);
-            fclose(fPtr);
-            return LWM2MCORE_ERR_GENERAL_ERROR;
-        }
-        fclose(fPtr);
+        *lenPtr = 0;
+        return LWM2MCORE_ERR_GENERAL_ERROR;
     }
 
-    if (rsize == 0)
+    entryPtr = &Store.entries[paramId];
+    len = entryPtr->len;
+    if (len > *lenPtr)
     {
-        if (NULL != (fPtr = fopen(fname1, "r")))
-        {
-            if (0 == (rsize = fread(bufferPtr, 1, bsize, fPtr)))
-            {
-                printf("Failed to read file %s\n", fname1);
-                bsize = -1; /*Incidate reading error*/
-                fclose(fPtr);
-                return LWM2MCORE_ERR_GENERAL_ERROR;
-            }
-            fclose(fPtr);
-        }
+        len = *lenPtr;
     }
-    *lenPtr = (size_t)rsize;
 
-    if(!rsize)
+    if (   (!entryPtr->isSet)
+        || (!len)
+        || (!ReadAt(Store.fd, bufferPtr, len, entryPtr->valueOffset))
+       )
     {
+        *lenPtr = 0;
         return LWM2MCORE_ERR_GENERAL_ERROR;
     }
+    *lenPtr = len;
 
     return LWM2MCORE_ERR_COMPLETED_OK;
 }
@@ -170,23 +916,15 @@ lwm2mcore_Sid_t lwm2mcore_DeleteParam
     lwm2mcore_Param_t paramId       ///< [IN] Parameter Id
 )
 {
-    char fname0[CONFIG_FILENAME_MAX_LENGTH];
-    char fname1[CONFIG_FILENAME_MAX_LENGTH];
-
     if (LWM2MCORE_MAX_PARAM <= paramId)
     {
         return LWM2MCORE_ERR_INVALID_ARG;
     }
 
-    sprintf(fname0, "%s%d.txt", CONFIG_FILENAME, paramId);
-    sprintf(fname1, "%s%d.bak", CONFIG_FILENAME, paramId);
-
-    if ( (remove(fname0) != 0)
-      || (remove(fname1) != 0) )
+    if ((!CheckStore()) || (!Store.entries[paramId].isSet))
     {
         return LWM2MCORE_ERR_GENERAL_ERROR;
     }
 
-    return LWM2MCORE_ERR_COMPLETED_OK;
+    return AppendRecord(RECORD_TYPE_DELETE, paramId, NULL, 0);
 }
-
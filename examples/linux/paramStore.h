@@ -0,0 +1,151 @@
+/**
+ * @file paramStore.h
+ *
+ * Log-structured parameter store of the Linux client.
+ *
+ * All the parameters handled by lwm2mcore_SetParam(), lwm2mcore_GetParam() and
+ * lwm2mcore_DeleteParam() are stored in a single append-only file. Each update or deletion is
+ * appended as a record protected by a CRC, and is committed by a single write followed by a data
+ * synchronization: a record interrupted by a crash or a power loss is detected and discarded when
+ * the file is loaded, the previous value of the parameter being kept.
+ *
+ * The file is loaded once in an in-memory index giving the location of the last value of each
+ * parameter. The obsolete records are removed by a compaction, which rewrites the live records in
+ * a temporary file atomically renamed to the store file. The compaction is not done on the write
+ * path but deferred to an idle point of the client (see ParamStoreCompact()), unless the obsolete
+ * records exceed PARAM_STORE_COMPACT_MAX_DEAD_LEN.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#ifndef _PARAMSTORE_H_
+#define _PARAMSTORE_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <lwm2mcore/lwm2mcore.h>
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Default parameter store file
+ */
+//--------------------------------------------------------------------------------------------------
+#define PARAM_STORE_FILENAME                "config.db"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximal length of the parameter store file path
+ */
+//--------------------------------------------------------------------------------------------------
+#define PARAM_STORE_PATH_MAX_LEN            256
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximal length of a parameter value
+ */
+//--------------------------------------------------------------------------------------------------
+#define PARAM_STORE_VALUE_MAX_LEN           (1024 * 1024)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Minimal length of obsolete records before a compaction is requested. A compaction is also only
+ * requested when the obsolete records are larger than the live ones.
+ */
+//--------------------------------------------------------------------------------------------------
+#define PARAM_STORE_COMPACT_MIN_DEAD_LEN    (64 * 1024)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Length of obsolete records above which the compaction is done on the write path
+ */
+//--------------------------------------------------------------------------------------------------
+#define PARAM_STORE_COMPACT_MAX_DEAD_LEN    (1024 * 1024)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parameter store statistics
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint64_t fileLen;           ///< Store file length
+    uint64_t liveLen;           ///< Length of the live records
+    uint64_t deadLen;           ///< Length of the obsolete records
+    uint32_t recordNb;          ///< Number of records loaded or appended since the store opening
+    uint32_t discardedLen;      ///< Length of the invalid data discarded at the store opening
+    uint32_t compactionNb;      ///< Number of compactions since the store opening
+}
+ParamStoreStats_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Open the parameter store and load its index.
+ *
+ * The store file is created if it doesn't exist. An interrupted record at the end of the file is
+ * discarded and the file is truncated to the last valid record. This function is automatically
+ * called with PARAM_STORE_FILENAME by the first parameter access if the store is not opened.
+ *
+ * @return
+ *      - LWM2MCORE_ERR_COMPLETED_OK if the store is opened
+ *      - LWM2MCORE_ERR_INVALID_ARG if the path is invalid
+ *      - LWM2MCORE_ERR_GENERAL_ERROR if the store file can't be opened or created
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_Sid_t ParamStoreOpen
+(
+    const char* pathPtr         ///< [IN] Store file path
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Close the parameter store
+ */
+//--------------------------------------------------------------------------------------------------
+void ParamStoreClose
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if a compaction of the parameter store is requested
+ *
+ * @return
+ *      - true if obsolete records should be removed by ParamStoreCompact()
+ *      - false otherwise
+ */
+//--------------------------------------------------------------------------------------------------
+bool ParamStoreIsCompactionNeeded
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compact the parameter store: the live records are rewritten in a new file which atomically
+ * replaces the store file. This function should be called when the client is idle.
+ *
+ * @return
+ *      - LWM2MCORE_ERR_COMPLETED_OK if the store is compacted
+ *      - LWM2MCORE_ERR_INVALID_STATE if the store is not opened
+ *      - LWM2MCORE_ERR_GENERAL_ERROR if the compaction failed, the store being unchanged
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_Sid_t ParamStoreCompact
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the parameter store statistics
+ */
+//--------------------------------------------------------------------------------------------------
+void ParamStoreGetStats
+(
+    ParamStoreStats_t* statsPtr     ///< [OUT] Statistics
+);
+
+#endif /* _PARAMSTORE_H_ */
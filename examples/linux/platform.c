@@ -11,6 +11,265 @@
 #include <string.h>
 #include <errno.h>
 #include <liblwm2m.h>
+#include <lwm2mcore/heap.h>
+#include "memPool.h"
+
+#if defined(LWM2MCORE_HEAP_ACCOUNTING) && !defined(LWM2M_MEMORY_TRACE)
+//--------------------------------------------------------------------------------------------------
+/**
+ * Header stored before each allocated block, keeping the block aligned for any type
+ */
+//--------------------------------------------------------------------------------------------------
+typedef union
+{
+    struct
+    {
+        size_t              size;   ///< Size requested by the caller
+        lwm2mcore_HeapTag_t tag;    ///< Subsystem owning the block
+    }
+    info;                           ///< Block information
+    long double             ld;     ///< Alignment
+    uint64_t                u64;    ///< Alignment
+    void*                   ptr;    ///< Alignment
+}
+HeapHeader_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Heap counters of a subsystem, updated with atomic operations as the allocations can be done by
+ * several threads. The counters are never reset: the values at the last reset are subtracted when
+ * the statistics are read, so that an allocation or a release only costs two atomic operations.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint64_t currentBytes;          ///< Number of bytes currently allocated
+    uint64_t peakBytes;             ///< Peak of currentBytes since the last reset
+    uint32_t allocNb;               ///< Number of allocations
+    uint32_t freeNb;                ///< Number of releases
+    uint32_t failureNb;             ///< Number of allocation failures
+    uint32_t resetAllocNb;          ///< Number of allocations at the last reset
+    uint32_t resetFreeNb;           ///< Number of releases at the last reset
+    uint32_t resetFailureNb;        ///< Number of allocation failures at the last reset
+}
+__attribute__((aligned(64))) HeapCounters_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Heap counters per subsystem, on separate cache lines
+ */
+//--------------------------------------------------------------------------------------------------
+static HeapCounters_t HeapCounters[LWM2MCORE_HEAP_TAG_MAX];
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Update the peak of a subsystem
+ */
+//--------------------------------------------------------------------------------------------------
+static void UpdateHeapPeak
+(
+    HeapCounters_t* countersPtr,    ///< [IN] Heap counters
+    uint64_t currentBytes           ///< [IN] Number of bytes currently allocated
+)
+{
+    uint64_t peakBytes = __atomic_load_n(&countersPtr->peakBytes, __ATOMIC_RELAXED);
+
+    while ((peakBytes < currentBytes)
+        && (!__atomic_compare_exchange_n(&countersPtr->peakBytes, &peakBytes, currentBytes, true,
+                                         __ATOMIC_RELAXED, __ATOMIC_RELAXED)))
+    {
+        ;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Memory allocation owned by a subsystem
+ *
+ * @return
+ *  - memory address
+ *  - NULL in case of allocation failure
+ */
+//--------------------------------------------------------------------------------------------------
+void* lwm2mcore_MallocTag
+(
+    size_t size,                    ///< [IN] Memory size to be allocated
+    lwm2mcore_HeapTag_t tag         ///< [IN] Subsystem owning the allocation
+)
+{
+    HeapCounters_t* countersPtr;
+    HeapHeader_t* headerPtr = NULL;
+
+    if (LWM2MCORE_HEAP_TAG_MAX <= (unsigned int)tag)
+    {
+        tag = LWM2MCORE_HEAP_TAG_WAKAAMA;
+    }
+    countersPtr = &HeapCounters[tag];
+
+    if ((SIZE_MAX - sizeof(HeapHeader_t)) >= size)
+    {
+        headerPtr = (HeapHeader_t*)MemPoolSizeClassAlloc(sizeof(HeapHeader_t) + size);
+        if (!headerPtr)
+        {
+            headerPtr = (HeapHeader_t*)malloc(sizeof(HeapHeader_t) + size);
+        }
+    }
+
+    if (!headerPtr)
+    {
+        __atomic_fetch_add(&countersPtr->failureNb, 1, __ATOMIC_RELAXED);
+#ifdef LWM2M_WITH_LOGS
+        lwm2m_printf("out of memory\n");
+#endif
+        return NULL;
+    }
+
+    headerPtr->info.size = size;
+    headerPtr->info.tag = tag;
+
+    __atomic_fetch_add(&countersPtr->allocNb, 1, __ATOMIC_RELAXED);
+    UpdateHeapPeak(countersPtr,
+                   __atomic_add_fetch(&countersPtr->currentBytes, size, __ATOMIC_RELAXED));
+
+    return headerPtr + 1;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Memory allocation with trace
+ *
+ * @return
+ *  - memory address
+ */
+//--------------------------------------------------------------------------------------------------
+void* lwm2m_malloc
+(
+    size_t size     ///< [IN] Memory size to be allocated
+)
+{
+    return lwm2mcore_MallocTag(size, LWM2MCORE_HEAP_TAG_WAKAAMA);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Memory free
+ */
+//--------------------------------------------------------------------------------------------------
+void lwm2m_free
+(
+    void* ptr   ///< [IN] Memory address to release
+)
+{
+    HeapHeader_t* headerPtr;
+    HeapCounters_t* countersPtr;
+
+    if (!ptr)
+    {
+        return;
+    }
+
+    headerPtr = (HeapHeader_t*)ptr - 1;
+    countersPtr = &HeapCounters[headerPtr->info.tag];
+
+    __atomic_fetch_add(&countersPtr->freeNb, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_sub(&countersPtr->currentBytes, headerPtr->info.size, __ATOMIC_RELAXED);
+
+    if (!MemPoolSizeClassRelease(headerPtr))
+    {
+        free(headerPtr);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Duplicate a string
+ *
+ * @return
+ *  - Duplicated string address
+ */
+//--------------------------------------------------------------------------------------------------
+char* lwm2m_strdup
+(
+    const char* strPtr  ///< [IN] String to be duplicated
+)
+{
+    size_t len = strlen(strPtr) + 1;
+    char* dstrPtr;
+
+    dstrPtr = (char*)lwm2m_malloc(len);
+    if (!dstrPtr)
+    {
+        return NULL;
+    }
+    memcpy(dstrPtr, strPtr, len);
+    return dstrPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the heap statistics of a subsystem
+ *
+ * @return
+ *  - LWM2MCORE_ERR_COMPLETED_OK on success
+ *  - LWM2MCORE_ERR_INVALID_ARG if the tag or the pointer is invalid
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_Sid_t lwm2mcore_GetHeapStats
+(
+    lwm2mcore_HeapTag_t tag,        ///< [IN] Subsystem
+    lwm2mcore_HeapStats_t* statsPtr ///< [OUT] Heap statistics
+)
+{
+    HeapCounters_t* countersPtr;
+    uint32_t allocNb;
+    uint32_t freeNb;
+
+    if ((LWM2MCORE_HEAP_TAG_MAX <= (unsigned int)tag) || (!statsPtr))
+    {
+        return LWM2MCORE_ERR_INVALID_ARG;
+    }
+
+    countersPtr = &HeapCounters[tag];
+    freeNb = __atomic_load_n(&countersPtr->freeNb, __ATOMIC_RELAXED);
+    allocNb = __atomic_load_n(&countersPtr->allocNb, __ATOMIC_RELAXED);
+
+    statsPtr->currentBytes = __atomic_load_n(&countersPtr->currentBytes, __ATOMIC_RELAXED);
+    statsPtr->peakBytes = __atomic_load_n(&countersPtr->peakBytes, __ATOMIC_RELAXED);
+    statsPtr->currentNb = allocNb - freeNb;
+    statsPtr->allocNb = allocNb - countersPtr->resetAllocNb;
+    statsPtr->freeNb = freeNb - countersPtr->resetFreeNb;
+    statsPtr->failureNb = __atomic_load_n(&countersPtr->failureNb, __ATOMIC_RELAXED)
+                          - countersPtr->resetFailureNb;
+
+    return LWM2MCORE_ERR_COMPLETED_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reset the peaks and the counters of the heap statistics
+ */
+//--------------------------------------------------------------------------------------------------
+void lwm2mcore_ResetHeapStats
+(
+    void
+)
+{
+    int i;
+
+    for (i = 0; i < LWM2MCORE_HEAP_TAG_MAX; i++)
+    {
+        HeapCounters_t* countersPtr = &HeapCounters[i];
+
+        __atomic_store_n(&countersPtr->peakBytes,
+                         __atomic_load_n(&countersPtr->currentBytes, __ATOMIC_RELAXED),
+                         __ATOMIC_RELAXED);
+        countersPtr->resetAllocNb = __atomic_load_n(&countersPtr->allocNb, __ATOMIC_RELAXED);
+        countersPtr->resetFreeNb = __atomic_load_n(&countersPtr->freeNb, __ATOMIC_RELAXED);
+        countersPtr->resetFailureNb = __atomic_load_n(&countersPtr->failureNb, __ATOMIC_RELAXED);
+    }
+}
+
+#else /* LWM2MCORE_HEAP_ACCOUNTING */
 
 #ifndef LWM2M_MEMORY_TRACE
 //--------------------------------------------------------------------------------------------------
@@ -28,7 +287,11 @@ void* lwm2m_malloc
 {
     void *mem;
 
-    mem = malloc(size);
+    mem = MemPoolSizeClassAlloc(size);
+    if (!mem)
+    {
+        mem = malloc(size);
+    }
     if (!mem)
     {
 #ifdef LWM2M_WITH_LOGS
@@ -49,7 +312,10 @@ void lwm2m_free
     void* ptr   ///< [IN] Memory address to release
 )
 {
-    free(ptr);
+    if ((ptr) && (!MemPoolSizeClassRelease(ptr)))
+    {
+        free(ptr);
+    }
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -80,6 +346,57 @@ char* lwm2m_strdup
 
 #endif
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Memory allocation owned by a subsystem: the allocations are not accounted
+ *
+ * @return
+ *  - memory address
+ */
+//--------------------------------------------------------------------------------------------------
+void* lwm2mcore_MallocTag
+(
+    size_t size,                    ///< [IN] Memory size to be allocated
+    lwm2mcore_HeapTag_t tag         ///< [IN] Subsystem owning the allocation
+)
+{
+    (void)tag;
+    return lwm2m_malloc(size);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the heap statistics of a subsystem: the allocations are not accounted
+ *
+ * @return
+ *  - LWM2MCORE_ERR_NOT_YET_IMPLEMENTED
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_Sid_t lwm2mcore_GetHeapStats
+(
+    lwm2mcore_HeapTag_t tag,        ///< [IN] Subsystem
+    lwm2mcore_HeapStats_t* statsPtr ///< [OUT] Heap statistics
+)
+{
+    (void)tag;
+    (void)statsPtr;
+    return LWM2MCORE_ERR_NOT_YET_IMPLEMENTED;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reset the peaks and the counters of the heap statistics: the allocations are not accounted
+ */
+//--------------------------------------------------------------------------------------------------
+void lwm2mcore_ResetHeapStats
+(
+    void
+)
+{
+}
+
+#endif /* LWM2MCORE_HEAP_ACCOUNTING */
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Compare strings
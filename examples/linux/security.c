@@ -4,27 +4,37 @@
  * Porting layer for credential management and package security (CRC, signature)
  *
  * @note The CRC is computed using the crc32 function from zlib.
- * @note The signature verification uses the OpenSSL library.
+ * @note The signature verification uses the OpenSSL library. The signature scheme of a package is
+ * given by the type of its public key:
+ *  - RSA key: RSA-PSS signature of the SHA-1 digest of the package
+ *  - EC P-256 key: ECDSA signature of the SHA-256 digest, DER encoded or raw (r|s, 64 bytes)
+ *  - Ed25519 key: Ed25519 signature of the SHA-256 digest
  *
  * Copyright (C) Sierra Wireless Inc.
  *
  */
 
 #include <stdint.h>
+#include <stdio.h>
 #include <stddef.h>
+#include <stdlib.h>
 #include <string.h>
 #include <platform/types.h>
 #include <ctype.h>
+#include <errno.h>
 #include <zlib.h>
 #include <openssl/sha.h>
 #include <openssl/bio.h>
 #include <openssl/pem.h>
 #include <openssl/err.h>
 #include <openssl/evp.h>
+#include <openssl/rsa.h>
+#include <openssl/ec.h>
 #include <openssl/x509.h>
 #include <lwm2mcore/lwm2mcore.h>
 #include <lwm2mcore/security.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
 #include "clientConfig.h"
 #include "handlers.h"
 #include "crypto.h"
@@ -50,6 +60,20 @@
 //--------------------------------------------------------------------------------------------------
 #define SERVER_ADDRESS_FILE         "server_address"
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Define for the saved SSL certificate
+ */
+//--------------------------------------------------------------------------------------------------
+#define SSL_CERTIFICATE_FILE        "ssl_certificate"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Define for the SSL certificate being written in parts, until the last part is written
+ */
+//--------------------------------------------------------------------------------------------------
+#define SSL_CERTIFICATE_PART_FILE   "ssl_certificate.part"
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Define for credential name in client configuration file
@@ -64,6 +88,128 @@
 //--------------------------------------------------------------------------------------------------
 #define SERVER_ID_LENGTH            6
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Length of a raw ECDSA P-256 signature (r and s) and maximal length of its DER encoding
+ */
+//--------------------------------------------------------------------------------------------------
+#define ECDSA_P256_RAW_SIGNATURE_LEN        64
+#define ECDSA_P256_DER_SIGNATURE_MAX_LEN    72
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Serialized package digest state (see lwm2mcore_CopySha1), big-endian:
+ * - digest algorithm (1 byte, see PackageDigest_t)
+ * - hashed length in bytes (8 bytes)
+ * - intermediate hash value (5 words for SHA-1, 8 words for SHA-256)
+ * - data of the last incomplete block, not yet hashed (hashed length modulo the block length)
+ *
+ * The serialized state is at most 104 bytes long, within LWM2MCORE_HASH_STATE_MAX_LEN.
+ */
+//--------------------------------------------------------------------------------------------------
+#define HASH_STATE_HEADER_LEN       9
+#define HASH_STATE_SHA1_WORDS       5
+#define HASH_STATE_SHA256_WORDS     8
+#define HASH_BLOCK_LEN              64
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Package digest algorithms
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    PACKAGE_DIGEST_NONE     = 0,    ///< Unsupported public key
+    PACKAGE_DIGEST_SHA1     = 1,    ///< SHA-1, RSA-PSS signature
+    PACKAGE_DIGEST_SHA256   = 2     ///< SHA-256, ECDSA P-256 or Ed25519 signature
+}
+PackageDigest_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Package digest context, allocated by lwm2mcore_StartSha1 or lwm2mcore_RestoreSha1
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    PackageDigest_t digest;         ///< Digest algorithm
+    union
+    {
+        SHA_CTX     sha1;           ///< SHA-1 context
+        SHA256_CTX  sha256;         ///< SHA-256 context
+    }
+    ctx;                            ///< Digest context of the algorithm
+}
+PackageHashCtx_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Package public key structure
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint8_t   key[LWM2MCORE_PUBLICKEY_LEN]; ///< Public key, DER format
+    size_t    len;                          ///< Public key length, 0 if not set
+    EVP_PKEY* evpKeyPtr;                    ///< Parsed public key (set or default one), NULL until
+                                            ///< the first verification
+}
+PackageKey_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Public keys set by lwm2mcore_SetCredential for firmware and software packages.
+ * When set, they are used instead of the default keys. These keys are not persistent.
+ */
+//--------------------------------------------------------------------------------------------------
+static PackageKey_t FwPackageKey;
+static PackageKey_t SwPackageKey;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of server slots of the credential cache for each credential. The slot of a credential is
+ * given by its server Id: two servers sharing a slot evict each other.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CREDENTIAL_CACHE_SLOT_NB    4
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximal length of a cached credential (the server address being the longest one)
+ */
+//--------------------------------------------------------------------------------------------------
+#define CREDENTIAL_CACHE_DATA_LEN   LWM2MCORE_SERVERADDR_LEN
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Credential cache entry
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    bool     isValid;                           ///< The entry contains the decoded credential
+    uint16_t serverId;                          ///< Server Id of the credential
+    size_t   len;                               ///< Credential length
+    uint8_t  data[CREDENTIAL_CACHE_DATA_LEN];   ///< Credential, PSK secret decoded in binary
+}
+CredentialCacheEntry_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Cache of the server credentials read in the client configuration, indexed by credential Id and
+ * server slot. A credential is decoded once on its first read and is invalidated when it is set or
+ * deleted. The cache is locked in RAM and wiped when invalidated, as it contains the PSK secrets.
+ */
+//--------------------------------------------------------------------------------------------------
+static CredentialCacheEntry_t CredentialCache[LWM2MCORE_CREDENTIAL_MAX][CREDENTIAL_CACHE_SLOT_NB];
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Credential cache locked in RAM
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsCredentialCacheLocked;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Convert a numeric value into a uppercase character representing the hexidecimal value of the
@@ -180,6 +326,254 @@ static int32_t StringToBinary
     return stringSize / 2;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if a credential is read in the client configuration and kept in the credential cache
+ *
+ * @return
+ *  - true if the credential is cached
+ *  - false else
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsCachedCredential
+(
+    lwm2mcore_Credentials_t credId      ///< [IN] Credential identifier
+)
+{
+    switch (credId)
+    {
+        case LWM2MCORE_CREDENTIAL_BS_PUBLIC_KEY:
+        case LWM2MCORE_CREDENTIAL_BS_SECRET_KEY:
+        case LWM2MCORE_CREDENTIAL_BS_ADDRESS:
+        case LWM2MCORE_CREDENTIAL_DM_PUBLIC_KEY:
+        case LWM2MCORE_CREDENTIAL_DM_SECRET_KEY:
+        case LWM2MCORE_CREDENTIAL_DM_ADDRESS:
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the credential cache entry of a credential
+ *
+ * @return
+ *  - Cache entry, which may contain the credential of another server
+ */
+//--------------------------------------------------------------------------------------------------
+static CredentialCacheEntry_t* GetCredentialCacheEntry
+(
+    lwm2mcore_Credentials_t credId,     ///< [IN] Credential identifier
+    uint16_t*               serverIdPtr ///< [INOUT] Server Id, normalized for the bootstrap server
+)
+{
+    if (credId <= LWM2MCORE_CREDENTIAL_BS_ADDRESS)
+    {
+        // Only one bootstrap server
+        *serverIdPtr = LWM2MCORE_BS_SERVER_ID;
+    }
+
+    return &CredentialCache[credId][*serverIdPtr % CREDENTIAL_CACHE_SLOT_NB];
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Wipe a credential cache entry
+ */
+//--------------------------------------------------------------------------------------------------
+static void WipeCredentialCacheEntry
+(
+    CredentialCacheEntry_t* entryPtr    ///< [IN] Cache entry
+)
+{
+    // Volatile access: the wipe of the secret can't be optimized out
+    volatile uint8_t* bytePtr = (volatile uint8_t*)entryPtr;
+    size_t i;
+
+    for (i = 0; i < sizeof(CredentialCacheEntry_t); i++)
+    {
+        bytePtr[i] = 0;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Invalidate a credential in the credential cache
+ */
+//--------------------------------------------------------------------------------------------------
+static void InvalidateCredential
+(
+    lwm2mcore_Credentials_t credId,     ///< [IN] Credential identifier
+    uint16_t                serverId    ///< [IN] Server Id
+)
+{
+    CredentialCacheEntry_t* entryPtr;
+
+    if (!IsCachedCredential(credId))
+    {
+        return;
+    }
+
+    entryPtr = GetCredentialCacheEntry(credId, &serverId);
+    if ((entryPtr->isValid) && (entryPtr->serverId == serverId))
+    {
+        WipeCredentialCacheEntry(entryPtr);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Release the parsed public key of a package type, the key being parsed again by the next
+ * signature verification
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReleasePackageVerifyKey
+(
+    PackageKey_t* packageKeyPtr     ///< [IN] Package public key
+)
+{
+    if (packageKeyPtr->evpKeyPtr)
+    {
+        EVP_PKEY_free(packageKeyPtr->evpKeyPtr);
+        packageKeyPtr->evpKeyPtr = NULL;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read a credential in the client configuration and decode it in a credential cache entry
+ *
+ * @return
+ *      - LWM2MCORE_ERR_COMPLETED_OK if the treatment succeeds
+ *      - LWM2MCORE_ERR_GENERAL_ERROR if the credential is not present
+ *      - LWM2MCORE_ERR_INVALID_ARG if the credential can't be decoded
+ */
+//--------------------------------------------------------------------------------------------------
+static lwm2mcore_Sid_t LoadCredential
+(
+    lwm2mcore_Credentials_t credId,     ///< [IN] Credential identifier
+    uint16_t                serverId,   ///< [IN] Server Id
+    CredentialCacheEntry_t* entryPtr    ///< [OUT] Cache entry
+)
+{
+    clientSecurityConfig_t* securityObjPtr;
+    const char* valuePtr = NULL;
+    size_t len;
+
+    if (!IsCredentialCacheLocked)
+    {
+        // Keep the secrets out of the swap, if allowed: retried at the next load on failure
+        if (0 == mlock(CredentialCache, sizeof(CredentialCache)))
+        {
+            IsCredentialCacheLocked = true;
+        }
+        else
+        {
+            printf("Failed to lock the credential cache in RAM: %s\n", strerror(errno));
+        }
+    }
+
+    WipeCredentialCacheEntry(entryPtr);
+
+    if (credId <= LWM2MCORE_CREDENTIAL_BS_ADDRESS)
+    {
+        securityObjPtr = GetBootstrapInformation();
+    }
+    else
+    {
+        securityObjPtr = GetDmServerConfigById(serverId);
+    }
+
+    if (!securityObjPtr)
+    {
+        return LWM2MCORE_ERR_GENERAL_ERROR;
+    }
+
+    switch (credId)
+    {
+        case LWM2MCORE_CREDENTIAL_BS_PUBLIC_KEY:
+        case LWM2MCORE_CREDENTIAL_DM_PUBLIC_KEY:
+            valuePtr = securityObjPtr->devicePKID;
+            if (!strlen(valuePtr))
+            {
+                return LWM2MCORE_ERR_GENERAL_ERROR;
+            }
+            break;
+
+        case LWM2MCORE_CREDENTIAL_BS_SECRET_KEY:
+        case LWM2MCORE_CREDENTIAL_DM_SECRET_KEY:
+        {
+            size_t hexLen = strlen((char*)securityObjPtr->secretKey);
+            int32_t pskLen;
+
+            if (hexLen % 2)
+            {
+                return LWM2MCORE_ERR_INVALID_ARG;
+            }
+
+            pskLen = StringToBinary((char*)securityObjPtr->secretKey,
+                                    (uint16_t)hexLen,
+                                    (char*)entryPtr->data,
+                                    sizeof(entryPtr->data));
+            if (0 > pskLen)
+            {
+                WipeCredentialCacheEntry(entryPtr);
+                return LWM2MCORE_ERR_INVALID_ARG;
+            }
+            entryPtr->len = (size_t)pskLen;
+        }
+        break;
+
+        case LWM2MCORE_CREDENTIAL_BS_ADDRESS:
+        case LWM2MCORE_CREDENTIAL_DM_ADDRESS:
+            valuePtr = securityObjPtr->serverURI;
+            break;
+
+        default:
+            return LWM2MCORE_ERR_INVALID_ARG;
+    }
+
+    if (valuePtr)
+    {
+        len = strnlen(valuePtr, sizeof(entryPtr->data));
+        memcpy(entryPtr->data, valuePtr, len);
+        entryPtr->len = len;
+    }
+
+    entryPtr->serverId = serverId;
+    entryPtr->isValid = true;
+
+    return LWM2MCORE_ERR_COMPLETED_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Wipe the credential cache and release the parsed package public keys. This function is called
+ * when the client configuration is freed.
+ */
+//--------------------------------------------------------------------------------------------------
+void ClearCredentialCache
+(
+    void
+)
+{
+    int credId;
+    int slot;
+
+    for (credId = 0; credId < LWM2MCORE_CREDENTIAL_MAX; credId++)
+    {
+        for (slot = 0; slot < CREDENTIAL_CACHE_SLOT_NB; slot++)
+        {
+            WipeCredentialCacheEntry(&CredentialCache[credId][slot]);
+        }
+    }
+
+    ReleasePackageVerifyKey(&FwPackageKey);
+    ReleasePackageVerifyKey(&SwPackageKey);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  *                  OBJECT 0: SECURITY
@@ -208,7 +602,6 @@ lwm2mcore_Sid_t lwm2mcore_GetCredential
 )
 {
     lwm2mcore_Sid_t result = LWM2MCORE_ERR_GENERAL_ERROR;
-    clientSecurityConfig_t* securityObjPtr;
     clientConfig_t* config = ClientConfigGet();
 
     printf("Get credentials %d, serverId %d\n", credId, serverId);
@@ -223,130 +616,55 @@ lwm2mcore_Sid_t lwm2mcore_GetCredential
         return LWM2MCORE_ERR_GENERAL_ERROR;
     }
 
-    memset(bufferPtr, 0, *lenPtr);
-    switch (credId)
+    if (IsCachedCredential(credId))
     {
-        case LWM2MCORE_CREDENTIAL_BS_PUBLIC_KEY:
-            securityObjPtr = GetBootstrapInformation();
-            if (securityObjPtr)
-            {
-                if (*lenPtr < strlen (securityObjPtr->devicePKID))
-                {
-                    return LWM2MCORE_ERR_OVERFLOW;
-                }
+        CredentialCacheEntry_t* entryPtr = GetCredentialCacheEntry(credId, &serverId);
 
-                if (strlen(securityObjPtr->devicePKID))
-                {
-                    memcpy(bufferPtr,
-                           securityObjPtr->devicePKID,
-                           strlen(securityObjPtr->devicePKID));
-                    *lenPtr = strlen(securityObjPtr->devicePKID);
-                    result = LWM2MCORE_ERR_COMPLETED_OK;
-                }
-                else
-                {
-                    result = LWM2MCORE_ERR_GENERAL_ERROR;
-                }
-            }
-            break;
-
-        case LWM2MCORE_CREDENTIAL_BS_SERVER_PUBLIC_KEY:
-            result = LWM2MCORE_ERR_COMPLETED_OK;
-            break;
-
-        case LWM2MCORE_CREDENTIAL_BS_SECRET_KEY:
-            securityObjPtr = GetBootstrapInformation();
-            if (securityObjPtr)
-            {
-                uint16_t pskLen = strlen((char*)securityObjPtr->secretKey) / 2;
-                if( 0 > StringToBinary((char*)(securityObjPtr->secretKey),
-                                        pskLen,
-                                        bufferPtr,
-                                        *lenPtr))
-                {
-                    return LWM2MCORE_ERR_INVALID_ARG;
-                }
-
-                *lenPtr = pskLen;
-                result = LWM2MCORE_ERR_COMPLETED_OK;
-            }
-            break;
-
-        case LWM2MCORE_CREDENTIAL_BS_ADDRESS:
-            securityObjPtr = GetBootstrapInformation();
-            if (securityObjPtr)
+        if ((!entryPtr->isValid) || (entryPtr->serverId != serverId))
+        {
+            result = LoadCredential(credId, serverId, entryPtr);
+            if (LWM2MCORE_ERR_COMPLETED_OK != result)
             {
-                if (*lenPtr < strlen (securityObjPtr->serverURI))
-                {
-                    return LWM2MCORE_ERR_OVERFLOW;
-                }
-                memcpy(bufferPtr, securityObjPtr->serverURI, strlen(securityObjPtr->serverURI));
-                *lenPtr = strlen(securityObjPtr->serverURI);
-                result = LWM2MCORE_ERR_COMPLETED_OK;
+                return result;
             }
-            break;
+        }
 
-        case LWM2MCORE_CREDENTIAL_DM_PUBLIC_KEY:
-            securityObjPtr = GetDmServerConfigById(serverId);
-            if (securityObjPtr)
-            {
-                if (*lenPtr < strlen (securityObjPtr->devicePKID))
-                {
-                    return LWM2MCORE_ERR_OVERFLOW;
-                }
+        if (*lenPtr < entryPtr->len)
+        {
+            return LWM2MCORE_ERR_OVERFLOW;
+        }
 
-                if (strlen(securityObjPtr->devicePKID))
-                {
-                    memcpy(bufferPtr, securityObjPtr->devicePKID, strlen(securityObjPtr->devicePKID));
-                    *lenPtr = strlen(securityObjPtr->devicePKID);
-                    result = LWM2MCORE_ERR_COMPLETED_OK;
-                }
-                else
-                {
-                    result = LWM2MCORE_ERR_GENERAL_ERROR;
-                }
-            }
-            break;
+        memcpy(bufferPtr, entryPtr->data, entryPtr->len);
+        if (entryPtr->len < *lenPtr)
+        {
+            bufferPtr[entryPtr->len] = '\0';
+        }
+        *lenPtr = entryPtr->len;
+        return LWM2MCORE_ERR_COMPLETED_OK;
+    }
 
+    memset(bufferPtr, 0, *lenPtr);
+    switch (credId)
+    {
+        case LWM2MCORE_CREDENTIAL_BS_SERVER_PUBLIC_KEY:
         case LWM2MCORE_CREDENTIAL_DM_SERVER_PUBLIC_KEY:
             result = LWM2MCORE_ERR_COMPLETED_OK;
             break;
 
-        case LWM2MCORE_CREDENTIAL_DM_SECRET_KEY:
+        case LWM2MCORE_CREDENTIAL_FW_KEY:
         {
-            securityObjPtr = GetDmServerConfigById(serverId);
-            if (securityObjPtr)
+            if (FwPackageKey.len)
             {
-                uint16_t pskLen = strlen((char*)securityObjPtr->secretKey) / 2;
-                if( 0 > StringToBinary((char*)(securityObjPtr->secretKey),
-                                        pskLen,
-                                        bufferPtr,
-                                        *lenPtr))
-                {
-                    return LWM2MCORE_ERR_INVALID_ARG;
-                }
-                *lenPtr = pskLen;
-                result = LWM2MCORE_ERR_COMPLETED_OK;
-            }
-        }
-        break;
-
-        case LWM2MCORE_CREDENTIAL_DM_ADDRESS:
-            securityObjPtr = GetDmServerConfigById(serverId);
-            if (securityObjPtr)
-            {
-                if (*lenPtr < strlen (securityObjPtr->serverURI))
+                if (*lenPtr < FwPackageKey.len)
                 {
                     return LWM2MCORE_ERR_OVERFLOW;
                 }
-                memcpy(bufferPtr, securityObjPtr->serverURI, strlen(securityObjPtr->serverURI));
-                *lenPtr = strlen(securityObjPtr->serverURI);
+                memcpy(bufferPtr, FwPackageKey.key, FwPackageKey.len);
+                *lenPtr = FwPackageKey.len;
                 result = LWM2MCORE_ERR_COMPLETED_OK;
+                break;
             }
-            break;
 
-        case LWM2MCORE_CREDENTIAL_FW_KEY:
-        {
             // Public key for firmware package (X.509 SubjectPublicKeyInfo format)
             uint8_t publicKeyFw[] =
             {
@@ -390,6 +708,18 @@ lwm2mcore_Sid_t lwm2mcore_GetCredential
 
         case LWM2MCORE_CREDENTIAL_SW_KEY:
         {
+            if (SwPackageKey.len)
+            {
+                if (*lenPtr < SwPackageKey.len)
+                {
+                    return LWM2MCORE_ERR_OVERFLOW;
+                }
+                memcpy(bufferPtr, SwPackageKey.key, SwPackageKey.len);
+                *lenPtr = SwPackageKey.len;
+                result = LWM2MCORE_ERR_COMPLETED_OK;
+                break;
+            }
+
             // Public key for software package (PEM DER ASN.1 PKCS#1 RSA Public key format)
             uint8_t publicKeySw[] =
             {
@@ -471,8 +801,29 @@ lwm2mcore_Sid_t lwm2mcore_SetCredential
         return LWM2MCORE_ERR_GENERAL_ERROR;
     }
 
+    // The decoded credential is obsolete
+    InvalidateCredential(credId, serverId);
+
     switch (credId)
     {
+        case LWM2MCORE_CREDENTIAL_FW_KEY:
+        case LWM2MCORE_CREDENTIAL_SW_KEY:
+        {
+            PackageKey_t* packageKeyPtr = (LWM2MCORE_CREDENTIAL_FW_KEY == credId) ?
+                                          &FwPackageKey : &SwPackageKey;
+
+            if (LWM2MCORE_PUBLICKEY_LEN < len)
+            {
+                return LWM2MCORE_ERR_OVERFLOW;
+            }
+
+            memcpy(packageKeyPtr->key, bufferPtr, len);
+            packageKeyPtr->len = len;
+            ReleasePackageVerifyKey(packageKeyPtr);
+            result = LWM2MCORE_ERR_COMPLETED_OK;
+        }
+        break;
+
         case LWM2MCORE_CREDENTIAL_BS_PUBLIC_KEY:
             if (LWM2MCORE_PSKID_LEN < len)
             {
@@ -745,6 +1096,8 @@ bool lwm2mcore_DeleteCredential
         return false;
     }
 
+    InvalidateCredential(credId, serverId);
+
     switch (credId)
     {
         case LWM2MCORE_CREDENTIAL_DM_PUBLIC_KEY:
@@ -804,50 +1157,520 @@ bool lwm2mcore_DeleteCredential
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Compute and update CRC32 with data buffer passed as an argument
+ * Compute and update CRC32 with data buffer passed as an argument
+ *
+ * @return Updated CRC32
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t lwm2mcore_Crc32
+(
+    uint32_t crc,       ///< [IN] Current CRC32 value
+    uint8_t* bufPtr,    ///< [IN] Data buffer to hash
+    size_t   len        ///< [IN] Data buffer length
+)
+{
+    return crc32(crc, bufPtr, len);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Print OpenSSL errors
+ */
+//--------------------------------------------------------------------------------------------------
+static void PrintOpenSSLErrors
+(
+    void
+)
+{
+    char errorString[LWM2MCORE_ERROR_STR_MAX_LEN];
+    unsigned long error;
+
+    // Retrieve the first error and remove it from the queue
+    error = ERR_get_error();
+    while (0 != error)
+    {
+        // Convert the error code to a human-readable string and print it
+        ERR_error_string_n(error, errorString, sizeof(errorString));
+        printf("%s\n", errorString);
+
+        // Retrieve the next error and remove it from the queue
+        error = ERR_get_error();
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the digest algorithm of the packages verified by a public key
+ *
+ * @return
+ *  - Digest algorithm
+ *  - PACKAGE_DIGEST_NONE if the key type is not supported
+ */
+//--------------------------------------------------------------------------------------------------
+static PackageDigest_t GetPackageDigest
+(
+    EVP_PKEY* keyPtr    ///< [IN] Public key
+)
+{
+    switch (EVP_PKEY_base_id(keyPtr))
+    {
+        case EVP_PKEY_RSA:
+            return PACKAGE_DIGEST_SHA1;
+
+        case EVP_PKEY_EC:
+        {
+            // Only the P-256 curve is supported
+            const EC_KEY* ecKeyPtr = EVP_PKEY_get0_EC_KEY(keyPtr);
+
+            if (   (ecKeyPtr)
+                && (NID_X9_62_prime256v1 == EC_GROUP_get_curve_name(EC_KEY_get0_group(ecKeyPtr)))
+               )
+            {
+                return PACKAGE_DIGEST_SHA256;
+            }
+            return PACKAGE_DIGEST_NONE;
+        }
+
+        case EVP_PKEY_ED25519:
+            return PACKAGE_DIGEST_SHA256;
+
+        default:
+            return PACKAGE_DIGEST_NONE;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the public key verifying the packages of a given type. The key is parsed on its first use
+ * and kept until the package key is set again.
+ *
+ * @return
+ *  - Public key
+ *  - NULL if the key can't be retrieved or is not supported
+ */
+//--------------------------------------------------------------------------------------------------
+static EVP_PKEY* GetPackageVerifyKey
+(
+    lwm2mcore_PkgDwlType_t packageType  ///< [IN] Package type (FW or SW)
+)
+{
+    lwm2mcore_Credentials_t credId;
+    PackageKey_t* packageKeyPtr;
+    char publicKey[LWM2MCORE_PUBLICKEY_LEN];
+    size_t publicKeyLen = LWM2MCORE_PUBLICKEY_LEN;
+    const unsigned char* derPtr;
+    EVP_PKEY* keyPtr;
+
+    // The package type indicates the public key to use
+    switch (packageType)
+    {
+        case LWM2MCORE_PKG_FW:
+            credId = LWM2MCORE_CREDENTIAL_FW_KEY;
+            packageKeyPtr = &FwPackageKey;
+            break;
+
+        case LWM2MCORE_PKG_SW:
+            credId = LWM2MCORE_CREDENTIAL_SW_KEY;
+            packageKeyPtr = &SwPackageKey;
+            break;
+
+        default:
+            printf("Unknown or unsupported package type %d\n", packageType);
+            return NULL;
+    }
+
+    if (packageKeyPtr->evpKeyPtr)
+    {
+        return packageKeyPtr->evpKeyPtr;
+    }
+
+    // Retrieve the public key corresponding to the package type
+    if (LWM2MCORE_ERR_COMPLETED_OK != lwm2mcore_GetCredential(credId,
+                                                              LWM2MCORE_BS_SERVER_ID,
+                                                              publicKey,
+                                                              &publicKeyLen))
+    {
+        printf("Error while retrieving credentials %d\n", credId);
+        return NULL;
+    }
+
+    // The public key is stored in DER format, two formats are possible:
+    // - X.509 SubjectPublicKeyInfo: RSA, EC or Ed25519 key, identified by its AlgorithmIdentifier
+    // - PEM DER ASN.1 PKCS#1 RSA Public key: ASN.1 type RSAPublicKey
+    derPtr = (const unsigned char*)publicKey;
+    keyPtr = d2i_PUBKEY(NULL, &derPtr, (long)publicKeyLen);
+    if (!keyPtr)
+    {
+        ERR_clear_error();
+        derPtr = (const unsigned char*)publicKey;
+        keyPtr = d2i_PublicKey(EVP_PKEY_RSA, NULL, &derPtr, (long)publicKeyLen);
+    }
+    if (!keyPtr)
+    {
+        printf("Unable to retrieve public key\n");
+        PrintOpenSSLErrors();
+        return NULL;
+    }
+
+    if (PACKAGE_DIGEST_NONE == GetPackageDigest(keyPtr))
+    {
+        printf("Unsupported public key type %d\n", EVP_PKEY_base_id(keyPtr));
+        EVP_PKEY_free(keyPtr);
+        return NULL;
+    }
+
+    packageKeyPtr->evpKeyPtr = keyPtr;
+    return keyPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Convert a raw ECDSA P-256 signature (r and s, big-endian) to its DER encoding
+ *
+ * @return
+ *  - DER signature length
+ *  - 0 on failure
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t EcdsaRawToDerSignature
+(
+    const uint8_t* rawSignaturePtr,     ///< [IN] Raw signature
+    uint8_t*       derSignaturePtr,     ///< [OUT] DER signature
+    size_t         derSignatureLen      ///< [IN] DER signature buffer length
+)
+{
+    size_t halfLen = ECDSA_P256_RAW_SIGNATURE_LEN / 2;
+    ECDSA_SIG* signaturePtr = ECDSA_SIG_new();
+    BIGNUM* rPtr = BN_bin2bn(rawSignaturePtr, (int)halfLen, NULL);
+    BIGNUM* sPtr = BN_bin2bn(rawSignaturePtr + halfLen, (int)halfLen, NULL);
+    int len = 0;
+
+    // ECDSA_SIG_set0 returns 1 for success and takes the ownership of r and s
+    if ((signaturePtr) && (rPtr) && (sPtr) && (1 == ECDSA_SIG_set0(signaturePtr, rPtr, sPtr)))
+    {
+        rPtr = NULL;
+        sPtr = NULL;
+
+        len = i2d_ECDSA_SIG(signaturePtr, NULL);
+        if ((len > 0) && ((size_t)len <= derSignatureLen))
+        {
+            len = i2d_ECDSA_SIG(signaturePtr, &derSignaturePtr);
+        }
+        else
+        {
+            len = 0;
+        }
+    }
+
+    BN_free(rPtr);
+    BN_free(sPtr);
+    ECDSA_SIG_free(signaturePtr);
+
+    return (len > 0) ? (size_t)len : 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Verify the signature of a package digest
+ *
+ * @return
+ *  - true  The signature is valid
+ *  - false The signature is not valid or can't be verified
+ */
+//--------------------------------------------------------------------------------------------------
+static bool VerifyPackageSignature
+(
+    EVP_PKEY*      keyPtr,          ///< [IN] Public key
+    const uint8_t* digestPtr,       ///< [IN] Package digest
+    size_t         digestLen,       ///< [IN] Package digest length
+    const uint8_t* signaturePtr,    ///< [IN] Package signature
+    size_t         signatureLen     ///< [IN] Package signature length
+)
+{
+    uint8_t derSignature[ECDSA_P256_DER_SIGNATURE_MAX_LEN];
+    EVP_PKEY_CTX* evpPkeyCtxPtr = NULL;
+    EVP_MD_CTX* evpMdCtxPtr = NULL;
+    bool isValid = false;
+
+    switch (EVP_PKEY_base_id(keyPtr))
+    {
+        case EVP_PKEY_ED25519:
+            // Ed25519 signs the digest itself, without any pre-hashing
+            // EVP_DigestVerify returns 1 if the verification was successful
+            evpMdCtxPtr = EVP_MD_CTX_new();
+            isValid = (   (evpMdCtxPtr)
+                       && (1 == EVP_DigestVerifyInit(evpMdCtxPtr, NULL, NULL, NULL, keyPtr))
+                       && (1 == EVP_DigestVerify(evpMdCtxPtr,
+                                                 signaturePtr,
+                                                 signatureLen,
+                                                 digestPtr,
+                                                 digestLen)));
+            break;
+
+        case EVP_PKEY_EC:
+            // A raw signature is DER encoded for OpenSSL
+            if (ECDSA_P256_RAW_SIGNATURE_LEN == signatureLen)
+            {
+                signatureLen = EcdsaRawToDerSignature(signaturePtr,
+                                                      derSignature,
+                                                      sizeof(derSignature));
+                signaturePtr = derSignature;
+            }
+
+            // EVP_PKEY_verify returns 1 if the verification was successful
+            evpPkeyCtxPtr = EVP_PKEY_CTX_new(keyPtr, NULL);
+            isValid = (   (evpPkeyCtxPtr)
+                       && (signatureLen)
+                       && (1 == EVP_PKEY_verify_init(evpPkeyCtxPtr))
+                       && (EVP_PKEY_CTX_set_signature_md(evpPkeyCtxPtr, EVP_sha256()) > 0)
+                       && (1 == EVP_PKEY_verify(evpPkeyCtxPtr,
+                                                signaturePtr,
+                                                signatureLen,
+                                                digestPtr,
+                                                digestLen)));
+            break;
+
+        case EVP_PKEY_RSA:
+            // Set the signature verification options:
+            // - RSA padding mode is PSS
+            // - message digest type is SHA1
+            // EVP_PKEY_CTX_ctrl functions return a positive value for success
+            // and 0 or a negative value for failure
+            evpPkeyCtxPtr = EVP_PKEY_CTX_new(keyPtr, NULL);
+            isValid = (   (evpPkeyCtxPtr)
+                       && (1 == EVP_PKEY_verify_init(evpPkeyCtxPtr))
+                       && (EVP_PKEY_CTX_set_rsa_padding(evpPkeyCtxPtr, RSA_PKCS1_PSS_PADDING) > 0)
+                       && (EVP_PKEY_CTX_set_signature_md(evpPkeyCtxPtr, EVP_sha1()) > 0)
+                       && (1 == EVP_PKEY_verify(evpPkeyCtxPtr,
+                                                signaturePtr,
+                                                signatureLen,
+                                                digestPtr,
+                                                digestLen)));
+            break;
+
+        default:
+            break;
+    }
+
+    EVP_PKEY_CTX_free(evpPkeyCtxPtr);
+    EVP_MD_CTX_free(evpMdCtxPtr);
+
+    return isValid;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a value in big-endian order
+ *
+ * @return
+ *  - Buffer position after the value
+ */
+//--------------------------------------------------------------------------------------------------
+static uint8_t* WriteBigEndian
+(
+    uint8_t* bufPtr,    ///< [OUT] Buffer
+    uint64_t value,     ///< [IN] Value
+    size_t   len        ///< [IN] Value length in bytes
+)
+{
+    size_t i;
+
+    for (i = 0; i < len; i++)
+    {
+        bufPtr[i] = (uint8_t)(value >> (8 * (len - 1 - i)));
+    }
+
+    return bufPtr + len;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read a value in big-endian order
+ *
+ * @return
+ *  - Value
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t ReadBigEndian
+(
+    const uint8_t* bufPtr,  ///< [IN] Buffer
+    size_t         len      ///< [IN] Value length in bytes
+)
+{
+    uint64_t value = 0;
+    size_t i;
+
+    for (i = 0; i < len; i++)
+    {
+        value = (value << 8) | bufPtr[i];
+    }
+
+    return value;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Serialize a package digest state
  *
- * @return Updated CRC32
+ * @return
+ *  - Serialized state length
+ *  - 0 if the digest context is not valid
  */
 //--------------------------------------------------------------------------------------------------
-uint32_t lwm2mcore_Crc32
+static size_t SerializeHashState
 (
-    uint32_t crc,       ///< [IN] Current CRC32 value
-    uint8_t* bufPtr,    ///< [IN] Data buffer to hash
-    size_t   len        ///< [IN] Data buffer length
+    const PackageHashCtx_t* hashCtxPtr, ///< [IN] Digest context
+    uint8_t*                bufPtr      ///< [OUT] Buffer of LWM2MCORE_HASH_STATE_MAX_LEN bytes
 )
 {
-    return crc32(crc, bufPtr, len);
+    SHA_LONG state[HASH_STATE_SHA256_WORDS];
+    const uint8_t* pendingPtr;
+    unsigned int pendingNum;
+    size_t pendingLen;
+    size_t wordNb;
+    uint64_t bitLen;
+    uint8_t* dataPtr;
+    size_t i;
+
+    switch (hashCtxPtr->digest)
+    {
+        case PACKAGE_DIGEST_SHA1:
+            state[0] = hashCtxPtr->ctx.sha1.h0;
+            state[1] = hashCtxPtr->ctx.sha1.h1;
+            state[2] = hashCtxPtr->ctx.sha1.h2;
+            state[3] = hashCtxPtr->ctx.sha1.h3;
+            state[4] = hashCtxPtr->ctx.sha1.h4;
+            wordNb = HASH_STATE_SHA1_WORDS;
+            bitLen = ((uint64_t)hashCtxPtr->ctx.sha1.Nh << 32) | hashCtxPtr->ctx.sha1.Nl;
+            pendingPtr = (const uint8_t*)hashCtxPtr->ctx.sha1.data;
+            pendingNum = hashCtxPtr->ctx.sha1.num;
+            break;
+
+        case PACKAGE_DIGEST_SHA256:
+            memcpy(state, hashCtxPtr->ctx.sha256.h, sizeof(state));
+            wordNb = HASH_STATE_SHA256_WORDS;
+            bitLen = ((uint64_t)hashCtxPtr->ctx.sha256.Nh << 32) | hashCtxPtr->ctx.sha256.Nl;
+            pendingPtr = (const uint8_t*)hashCtxPtr->ctx.sha256.data;
+            pendingNum = hashCtxPtr->ctx.sha256.num;
+            break;
+
+        default:
+            return 0;
+    }
+
+    // The data not yet hashed is given by the hashed length
+    pendingLen = (size_t)((bitLen >> 3) % HASH_BLOCK_LEN);
+    if (pendingNum != pendingLen)
+    {
+        return 0;
+    }
+
+    bufPtr[0] = (uint8_t)hashCtxPtr->digest;
+    dataPtr = WriteBigEndian(bufPtr + 1, bitLen >> 3, sizeof(uint64_t));
+    for (i = 0; i < wordNb; i++)
+    {
+        dataPtr = WriteBigEndian(dataPtr, state[i], sizeof(uint32_t));
+    }
+    memcpy(dataPtr, pendingPtr, pendingLen);
+
+    return (size_t)(dataPtr - bufPtr) + pendingLen;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Print OpenSSL errors
+ * Deserialize a package digest state
+ *
+ * @return
+ *  - true  The digest context is restored
+ *  - false The serialized state is not valid
  */
 //--------------------------------------------------------------------------------------------------
-static void PrintOpenSSLErrors
+static bool DeserializeHashState
 (
-    void
+    const uint8_t*    bufPtr,       ///< [IN] Serialized state
+    size_t            bufSize,      ///< [IN] Buffer length
+    PackageHashCtx_t* hashCtxPtr    ///< [OUT] Digest context
 )
 {
-    char errorString[LWM2MCORE_ERROR_STR_MAX_LEN];
-    unsigned long error;
+    SHA_LONG state[HASH_STATE_SHA256_WORDS];
+    const uint8_t* dataPtr;
+    size_t pendingLen;
+    size_t wordNb;
+    uint64_t len;
+    size_t i;
+
+    if (bufSize < HASH_STATE_HEADER_LEN)
+    {
+        return false;
+    }
 
-    // Retrieve the first error and remove it from the queue
-    error = ERR_get_error();
-    while (0 != error)
+    switch (bufPtr[0])
     {
-        // Convert the error code to a human-readable string and print it
-        ERR_error_string_n(error, errorString, sizeof(errorString));
-        printf("%s\n", errorString);
+        case PACKAGE_DIGEST_SHA1:
+            wordNb = HASH_STATE_SHA1_WORDS;
+            break;
 
-        // Retrieve the next error and remove it from the queue
-        error = ERR_get_error();
+        case PACKAGE_DIGEST_SHA256:
+            wordNb = HASH_STATE_SHA256_WORDS;
+            break;
+
+        default:
+            return false;
+    }
+
+    len = ReadBigEndian(bufPtr + 1, sizeof(uint64_t));
+    pendingLen = (size_t)(len % HASH_BLOCK_LEN);
+    if (bufSize < (HASH_STATE_HEADER_LEN + (wordNb * sizeof(uint32_t)) + pendingLen))
+    {
+        return false;
+    }
+
+    dataPtr = bufPtr + HASH_STATE_HEADER_LEN;
+    for (i = 0; i < wordNb; i++)
+    {
+        state[i] = (SHA_LONG)ReadBigEndian(dataPtr, sizeof(uint32_t));
+        dataPtr += sizeof(uint32_t);
+    }
+
+    // SHA1_Init and SHA256_Init functions return 1 for success, 0 otherwise
+    memset(hashCtxPtr, 0, sizeof(PackageHashCtx_t));
+    hashCtxPtr->digest = (PackageDigest_t)bufPtr[0];
+    if (PACKAGE_DIGEST_SHA1 == hashCtxPtr->digest)
+    {
+        if (1 != SHA1_Init(&hashCtxPtr->ctx.sha1))
+        {
+            return false;
+        }
+        hashCtxPtr->ctx.sha1.h0 = state[0];
+        hashCtxPtr->ctx.sha1.h1 = state[1];
+        hashCtxPtr->ctx.sha1.h2 = state[2];
+        hashCtxPtr->ctx.sha1.h3 = state[3];
+        hashCtxPtr->ctx.sha1.h4 = state[4];
+        hashCtxPtr->ctx.sha1.Nl = (SHA_LONG)(len << 3);
+        hashCtxPtr->ctx.sha1.Nh = (SHA_LONG)(len >> 29);
+        memcpy(hashCtxPtr->ctx.sha1.data, dataPtr, pendingLen);
+        hashCtxPtr->ctx.sha1.num = (unsigned int)pendingLen;
+    }
+    else
+    {
+        if (1 != SHA256_Init(&hashCtxPtr->ctx.sha256))
+        {
+            return false;
+        }
+        memcpy(hashCtxPtr->ctx.sha256.h, state, sizeof(state));
+        hashCtxPtr->ctx.sha256.Nl = (SHA_LONG)(len << 3);
+        hashCtxPtr->ctx.sha256.Nh = (SHA_LONG)(len >> 29);
+        memcpy(hashCtxPtr->ctx.sha256.data, dataPtr, pendingLen);
+        hashCtxPtr->ctx.sha256.num = (unsigned int)pendingLen;
     }
+
+    return true;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Initialize the SHA1 computation
+ * Initialize the package digest computation. The digest algorithm is given by the public key of
+ * the package type: SHA-1 for a RSA key, SHA-256 for an EC P-256 or an Ed25519 key.
  *
  * @return
  *      - LWM2MCORE_ERR_COMPLETED_OK if the treatment succeeds
@@ -857,10 +1680,13 @@ static void PrintOpenSSLErrors
 //--------------------------------------------------------------------------------------------------
 lwm2mcore_Sid_t lwm2mcore_StartSha1
 (
-    void** sha1CtxPtr   ///< [INOUT] SHA1 context pointer
+    lwm2mcore_PkgDwlType_t packageType, ///< [IN] Package type (FW or SW)
+    void** sha1CtxPtr                   ///< [INOUT] SHA1 context pointer
 )
 {
-    static SHA_CTX shaCtx;
+    PackageHashCtx_t* hashCtxPtr;
+    EVP_PKEY* keyPtr;
+    int result;
 
     // Check if SHA1 context pointer is set
     if (!sha1CtxPtr)
@@ -872,24 +1698,51 @@ lwm2mcore_Sid_t lwm2mcore_StartSha1
     // Load the error strings
     ERR_load_crypto_strings();
 
-    // Initialize the SHA1 context
-    // SHA1_Init function returns 1 for success, 0 otherwise
-    if (1 != SHA1_Init(&shaCtx))
+    // The public key is parsed once, the next verifications use the parsed key
+    keyPtr = GetPackageVerifyKey(packageType);
+    if (!keyPtr)
     {
-        printf("SHA1_Init failed\n");
-        PrintOpenSSLErrors();
         return LWM2MCORE_ERR_GENERAL_ERROR;
     }
+
+    // Allocate the digest context, unless an existing context is reused
+    if (!*sha1CtxPtr)
+    {
+        *sha1CtxPtr = malloc(sizeof(PackageHashCtx_t));
+        if (!*sha1CtxPtr)
+        {
+            printf("Unable to allocate the digest context\n");
+            return LWM2MCORE_ERR_GENERAL_ERROR;
+        }
+    }
+    hashCtxPtr = (PackageHashCtx_t*)*sha1CtxPtr;
+
+    // Initialize the digest context
+    // SHA1_Init and SHA256_Init functions return 1 for success, 0 otherwise
+    memset(hashCtxPtr, 0, sizeof(PackageHashCtx_t));
+    hashCtxPtr->digest = GetPackageDigest(keyPtr);
+    if (PACKAGE_DIGEST_SHA256 == hashCtxPtr->digest)
+    {
+        result = SHA256_Init(&hashCtxPtr->ctx.sha256);
+    }
     else
     {
-        *sha1CtxPtr = (void*)&shaCtx;
-        return LWM2MCORE_ERR_COMPLETED_OK;
+        result = SHA1_Init(&hashCtxPtr->ctx.sha1);
+    }
+
+    if (1 != result)
+    {
+        printf("Digest initialization failed\n");
+        PrintOpenSSLErrors();
+        return LWM2MCORE_ERR_GENERAL_ERROR;
     }
+
+    return LWM2MCORE_ERR_COMPLETED_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Compute and update SHA1 digest with the data buffer passed as an argument
+ * Compute and update the package digest with the data buffer passed as an argument
  *
  * @return
  *      - LWM2MCORE_ERR_COMPLETED_OK if the treatment succeeds
@@ -904,6 +1757,9 @@ lwm2mcore_Sid_t lwm2mcore_ProcessSha1
     size_t   len            ///< [IN] Data buffer length
 )
 {
+    PackageHashCtx_t* hashCtxPtr = (PackageHashCtx_t*)sha1CtxPtr;
+    int result;
+
     // Check if pointers are set
     if ((!sha1CtxPtr) || (!bufPtr))
     {
@@ -911,11 +1767,20 @@ lwm2mcore_Sid_t lwm2mcore_ProcessSha1
         return LWM2MCORE_ERR_INVALID_ARG;
     }
 
-    // Update SHA1 digest
-    // SHA1_Update function returns 1 for success, 0 otherwise
-    if (1 != SHA1_Update((SHA_CTX*)sha1CtxPtr, bufPtr, len))
+    // Update the digest
+    // SHA1_Update and SHA256_Update functions return 1 for success, 0 otherwise
+    if (PACKAGE_DIGEST_SHA256 == hashCtxPtr->digest)
+    {
+        result = SHA256_Update(&hashCtxPtr->ctx.sha256, bufPtr, len);
+    }
+    else
+    {
+        result = SHA1_Update(&hashCtxPtr->ctx.sha1, bufPtr, len);
+    }
+
+    if (1 != result)
     {
-        printf("SHA1_Update failed\n");
+        printf("Digest update failed\n");
         PrintOpenSSLErrors();
         return LWM2MCORE_ERR_GENERAL_ERROR;
     }
@@ -925,7 +1790,7 @@ lwm2mcore_Sid_t lwm2mcore_ProcessSha1
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Finalize SHA1 digest and verify the package signature
+ * Finalize the package digest and verify the package signature
  *
  * @return
  *      - LWM2MCORE_ERR_COMPLETED_OK if the treatment succeeds
@@ -941,14 +1806,11 @@ lwm2mcore_Sid_t lwm2mcore_EndSha1
     size_t signatureLen                 ///< [IN] Package signature length
 )
 {
-    unsigned char sha1Digest[SHA_DIGEST_LENGTH];
-    lwm2mcore_Credentials_t credId;
-    char publicKey[LWM2MCORE_PUBLICKEY_LEN];
-    size_t publicKeyLen = LWM2MCORE_PUBLICKEY_LEN;
-    BIO* bufioPtr = NULL;
-    RSA* rsaKeyPtr = NULL;
-    EVP_PKEY* evpPkeyPtr = NULL;
-    EVP_PKEY_CTX* evpPkeyCtxPtr = NULL;
+    PackageHashCtx_t* hashCtxPtr = (PackageHashCtx_t*)sha1CtxPtr;
+    unsigned char digest[SHA256_DIGEST_LENGTH];
+    size_t digestLen;
+    EVP_PKEY* keyPtr;
+    int result;
 
     // Check if pointers are set
     if ((!sha1CtxPtr) || (!signaturePtr))
@@ -957,126 +1819,41 @@ lwm2mcore_Sid_t lwm2mcore_EndSha1
         return LWM2MCORE_ERR_INVALID_ARG;
     }
 
-    // Finalize SHA1 digest
-    // SHA1_Final function returns 1 for success, 0 otherwise
-    if (1 != SHA1_Final(sha1Digest, (SHA_CTX*)sha1CtxPtr))
-    {
-        printf("SHA1_Final failed\n");
-        PrintOpenSSLErrors();
-        return LWM2MCORE_ERR_GENERAL_ERROR;
-    }
-
-    // The package type indicates the public key to use
-    switch (packageType)
-    {
-        case LWM2MCORE_PKG_FW:
-            credId = LWM2MCORE_CREDENTIAL_FW_KEY;
-            break;
-
-        case LWM2MCORE_PKG_SW:
-            credId = LWM2MCORE_CREDENTIAL_SW_KEY;
-            break;
-
-        default:
-            printf("Unknown or unsupported package type %d\n", packageType);
-            return LWM2MCORE_ERR_GENERAL_ERROR;
-            break;
-    }
-
-    // Retrieve the public key corresponding to the package type
-    if (LWM2MCORE_ERR_COMPLETED_OK != lwm2mcore_GetCredential(credId,
-                                                              LWM2MCORE_BS_SERVER_ID,
-                                                              publicKey,
-                                                              &publicKeyLen))
+    // Finalize the digest
+    // SHA1_Final and SHA256_Final functions return 1 for success, 0 otherwise
+    if (PACKAGE_DIGEST_SHA256 == hashCtxPtr->digest)
     {
-        printf("Error while retrieving credentials %d\n", credId);
-        return LWM2MCORE_ERR_GENERAL_ERROR;
+        result = SHA256_Final(digest, &hashCtxPtr->ctx.sha256);
+        digestLen = SHA256_DIGEST_LENGTH;
     }
-
-    // The public key is stored in PKCS #1 DER format, convert it to a RSA key.
-    // Note that two formats are possible, try both of them if necessary:
-    // - PEM DER ASN.1 PKCS#1 RSA Public key: ASN.1 type RSAPublicKey
-    // - X.509 SubjectPublicKeyInfo: Object Identifier rsaEncryption added for AlgorithmIdentifier
-
-    // First create the memory BIO containing the DER key
-    bufioPtr = BIO_new_mem_buf((void*)publicKey, publicKeyLen);
-    if (!bufioPtr)
+    else
     {
-        printf("Unable to create a memory BIO\n");
-        PrintOpenSSLErrors();
-        return LWM2MCORE_ERR_GENERAL_ERROR;
+        result = SHA1_Final(digest, &hashCtxPtr->ctx.sha1);
+        digestLen = SHA_DIGEST_LENGTH;
     }
-    // Then convert it to a RSA key using PEM DER ASN.1 PKCS#1 RSA Public key format
-    rsaKeyPtr = d2i_RSAPublicKey_bio(bufioPtr, NULL);
-    if (!rsaKeyPtr)
-    {
-        // Memory BIO is modified by last function call, retrieve the DER key again
-        BIO_free(bufioPtr);
-        bufioPtr = BIO_new_mem_buf((void*)publicKey, publicKeyLen);
-        if (!bufioPtr)
-        {
-            printf("Unable to create a memory BIO\n");
-            PrintOpenSSLErrors();
-            return LWM2MCORE_ERR_GENERAL_ERROR;
-        }
 
-        // Then convert it to a RSA key using X.509 SubjectPublicKeyInfo format
-        rsaKeyPtr = d2i_RSA_PUBKEY_bio(bufioPtr, NULL);
-    }
-    BIO_free(bufioPtr);
-    if (!rsaKeyPtr)
-    {
-        printf("Unable to retrieve public key\n");
-        PrintOpenSSLErrors();
-        return LWM2MCORE_ERR_GENERAL_ERROR;
-    }
-    evpPkeyPtr = EVP_PKEY_new();
-    if (!evpPkeyPtr)
+    if (1 != result)
     {
-        printf("Unable to create EVP_PKEY structure\n");
-        PrintOpenSSLErrors();
-        return LWM2MCORE_ERR_GENERAL_ERROR;
-    }
-    // EVP_PKEY_assign_RSA returns 1 for success and 0 for failure
-    if (1 != EVP_PKEY_assign_RSA(evpPkeyPtr, rsaKeyPtr))
-    {
-        printf("Unable to assign public key\n");
+        printf("Digest finalization failed\n");
         PrintOpenSSLErrors();
         return LWM2MCORE_ERR_GENERAL_ERROR;
     }
 
-    // Create EVP public key context, necessary to verify the signature
-    evpPkeyCtxPtr = EVP_PKEY_CTX_new(evpPkeyPtr, NULL);
-    if (   (!evpPkeyCtxPtr)
-        || (1 != EVP_PKEY_verify_init(evpPkeyCtxPtr))
-       )
+    keyPtr = GetPackageVerifyKey(packageType);
+    if (!keyPtr)
     {
-        printf("Unable to create and initialize EVP PKEY context\n");
-        PrintOpenSSLErrors();
         return LWM2MCORE_ERR_GENERAL_ERROR;
     }
 
-    // Set the signature verification options:
-    // - RSA padding mode is PSS
-    // - message digest type is SHA1
-    // EVP_PKEY_CTX_ctrl functions return a positive value for success
-    // and 0 or a negative value for failure
-    if (   (EVP_PKEY_CTX_set_rsa_padding(evpPkeyCtxPtr, RSA_PKCS1_PSS_PADDING) <= 0)
-        || (EVP_PKEY_CTX_set_signature_md(evpPkeyCtxPtr, EVP_sha1()) <= 0)
-       )
+    // The package was hashed for another public key, e.g. the key was set during the download
+    if (GetPackageDigest(keyPtr) != hashCtxPtr->digest)
     {
-        printf("Error during EVP PKEY context initialization\n");
-        PrintOpenSSLErrors();
+        printf("Package digest algorithm does not match the public key\n");
         return LWM2MCORE_ERR_GENERAL_ERROR;
     }
 
     // Verify signature
-    // VP_PKEY_verify returns 1 if the verification was successful and 0 if it failed
-    if (1 != EVP_PKEY_verify(evpPkeyCtxPtr,
-                             signaturePtr,
-                             signatureLen,
-                             sha1Digest,
-                             sizeof(sha1Digest)))
+    if (!VerifyPackageSignature(keyPtr, digest, digestLen, signaturePtr, signatureLen))
     {
         printf("Signature verification failed\n");
         PrintOpenSSLErrors();
@@ -1088,7 +1865,7 @@ lwm2mcore_Sid_t lwm2mcore_EndSha1
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Copy the SHA1 context in a buffer
+ * Copy the SHA1 context in a buffer: the digest state is serialized, see HASH_STATE_HEADER_LEN
  *
  * @return
  *      - LWM2MCORE_ERR_COMPLETED_OK if the treatment succeeds
@@ -1111,21 +1888,25 @@ lwm2mcore_Sid_t lwm2mcore_CopySha1
     }
 
     // Check buffer length
-    if (bufSize < sizeof(SHA_CTX))
+    if (bufSize < LWM2MCORE_HASH_STATE_MAX_LEN)
     {
-        printf("Buffer is too short (%zu < %zu)\n", bufSize, sizeof(SHA_CTX));
+        printf("Buffer is too short (%zu < %d)\n", bufSize, LWM2MCORE_HASH_STATE_MAX_LEN);
         return LWM2MCORE_ERR_INVALID_ARG;
     }
 
-    // Copy the SHA1 context
+    // Serialize the digest state
     memset(bufPtr, 0, bufSize);
-    memcpy(bufPtr, sha1CtxPtr, sizeof(SHA_CTX));
+    if (!SerializeHashState((PackageHashCtx_t*)sha1CtxPtr, (uint8_t*)bufPtr))
+    {
+        printf("Invalid digest context\n");
+        return LWM2MCORE_ERR_GENERAL_ERROR;
+    }
     return LWM2MCORE_ERR_COMPLETED_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Restore the SHA1 context from a buffer
+ * Restore the SHA1 context from a buffer, allocating the context if necessary
  *
  * @return
  *      - LWM2MCORE_ERR_COMPLETED_OK if the treatment succeeds
@@ -1140,6 +1921,8 @@ lwm2mcore_Sid_t lwm2mcore_RestoreSha1
     void** sha1CtxPtr   ///< [INOUT] SHA1 context pointer
 )
 {
+    PackageHashCtx_t hashCtx;
+
     // Check if pointers are set
     if ((!sha1CtxPtr) || (!bufPtr))
     {
@@ -1147,28 +1930,30 @@ lwm2mcore_Sid_t lwm2mcore_RestoreSha1
         return LWM2MCORE_ERR_INVALID_ARG;
     }
 
-    // Check buffer length
-    if (bufSize < sizeof(SHA_CTX))
+    // Deserialize the digest state, e.g. an unknown digest algorithm is rejected
+    if (!DeserializeHashState((const uint8_t*)bufPtr, bufSize, &hashCtx))
     {
-        printf("Buffer is too short (%zu < %zu)\n", bufSize, sizeof(SHA_CTX));
-        return LWM2MCORE_ERR_INVALID_ARG;
+        printf("Invalid digest state\n");
+        return LWM2MCORE_ERR_GENERAL_ERROR;
     }
 
-    // Initialize SHA1 context
-    if (LWM2MCORE_ERR_COMPLETED_OK != lwm2mcore_StartSha1(sha1CtxPtr))
+    // Allocate the digest context, unless an existing context is reused
+    if (!*sha1CtxPtr)
     {
-        printf("Unable to initialize SHA1 context\n");
-        return LWM2MCORE_ERR_GENERAL_ERROR;
+        *sha1CtxPtr = malloc(sizeof(PackageHashCtx_t));
+        if (!*sha1CtxPtr)
+        {
+            printf("Unable to allocate the digest context\n");
+            return LWM2MCORE_ERR_GENERAL_ERROR;
+        }
     }
-
-    // Restore the SHA1 context
-    memcpy(*sha1CtxPtr, bufPtr, sizeof(SHA_CTX));
+    memcpy(*sha1CtxPtr, &hashCtx, sizeof(PackageHashCtx_t));
     return LWM2MCORE_ERR_COMPLETED_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Cancel and reset the SHA1 computation
+ * Cancel the SHA1 computation and release the context
  *
  * @return
  *      - LWM2MCORE_ERR_COMPLETED_OK if the treatment succeeds
@@ -1188,7 +1973,8 @@ lwm2mcore_Sid_t lwm2mcore_CancelSha1
         return LWM2MCORE_ERR_INVALID_ARG;
     }
 
-    // Reset SHA1 context
+    // Release SHA1 context
+    free(*sha1CtxPtr);
     *sha1CtxPtr = NULL;
 
     return LWM2MCORE_ERR_COMPLETED_OK;
@@ -1209,12 +1995,173 @@ lwm2mcore_Sid_t lwm2mcore_UpdateSslCertificate
     int    len         ///< [IN] Certificate len
 )
 {
-    (void)(len);
-    if (!certPtr)
+    FILE* filePtr;
+    size_t writtenLen;
+
+    if ((!certPtr) || (0 > len))
     {
         printf("NULL certificate\n");
         return LWM2MCORE_ERR_INVALID_ARG;
     }
 
+    if (0 == len)
+    {
+        remove(SSL_CERTIFICATE_FILE);
+        return LWM2MCORE_ERR_COMPLETED_OK;
+    }
+
+    filePtr = fopen(SSL_CERTIFICATE_FILE, "wb");
+    if (!filePtr)
+    {
+        return LWM2MCORE_ERR_GENERAL_ERROR;
+    }
+
+    writtenLen = fwrite(certPtr, 1, (size_t)len, filePtr);
+    if ((0 != fclose(filePtr)) || ((size_t)len != writtenLen))
+    {
+        remove(SSL_CERTIFICATE_FILE);
+        return LWM2MCORE_ERR_GENERAL_ERROR;
+    }
+
+    return LWM2MCORE_ERR_COMPLETED_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read a part of the saved SSL certificate
+ *
+ * @return
+ *      - LWM2MCORE_ERR_COMPLETED_OK if the read succeeds
+ *      - LWM2MCORE_ERR_GENERAL_ERROR if the read fails
+ *      - LWM2MCORE_ERR_INVALID_ARG if a parameter is invalid
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_Sid_t lwm2mcore_GetSslCertificate
+(
+    size_t offset,          ///< [IN] Offset of the part in the certificate
+    char* bufferPtr,        ///< [OUT] Part of the certificate
+    size_t* lenPtr,         ///< [INOUT] Buffer length and length of the part
+    size_t* totalLenPtr     ///< [OUT] Certificate length
+)
+{
+    FILE* filePtr;
+    long fileLen;
+
+    if ((!bufferPtr) || (!lenPtr) || (!totalLenPtr))
+    {
+        return LWM2MCORE_ERR_INVALID_ARG;
+    }
+
+    filePtr = fopen(SSL_CERTIFICATE_FILE, "rb");
+    if (!filePtr)
+    {
+        // No saved certificate
+        *lenPtr = 0;
+        *totalLenPtr = 0;
+        return LWM2MCORE_ERR_COMPLETED_OK;
+    }
+
+    if ((0 != fseek(filePtr, 0, SEEK_END)) || (0 > (fileLen = ftell(filePtr))))
+    {
+        fclose(filePtr);
+        return LWM2MCORE_ERR_GENERAL_ERROR;
+    }
+    *totalLenPtr = (size_t)fileLen;
+
+    if (offset >= (size_t)fileLen)
+    {
+        *lenPtr = 0;
+    }
+    else
+    {
+        if (*lenPtr > ((size_t)fileLen - offset))
+        {
+            *lenPtr = (size_t)fileLen - offset;
+        }
+
+        if (   (0 != fseek(filePtr, (long)offset, SEEK_SET))
+            || (*lenPtr != fread(bufferPtr, 1, *lenPtr, filePtr)))
+        {
+            fclose(filePtr);
+            return LWM2MCORE_ERR_GENERAL_ERROR;
+        }
+    }
+
+    fclose(filePtr);
+    return LWM2MCORE_ERR_COMPLETED_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a part of the SSL certificate
+ *
+ * The parts are appended to a temporary file, which replaces the saved certificate once the last
+ * part is written.
+ *
+ * @return
+ *      - LWM2MCORE_ERR_COMPLETED_OK if the write succeeds
+ *      - LWM2MCORE_ERR_GENERAL_ERROR if the write fails
+ *      - LWM2MCORE_ERR_INVALID_ARG if a parameter is invalid
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_Sid_t lwm2mcore_UpdateSslCertificatePart
+(
+    size_t offset,          ///< [IN] Offset of the part in the certificate
+    char* bufferPtr,        ///< [IN] Part of the certificate
+    size_t len,             ///< [IN] Length of the part
+    bool isLast             ///< [IN] The part is the last one of the certificate
+)
+{
+    FILE* filePtr;
+    long fileLen;
+    size_t writtenLen;
+
+    if ((!bufferPtr) && (len))
+    {
+        return LWM2MCORE_ERR_INVALID_ARG;
+    }
+
+    // The first part starts a new certificate, the next ones are appended
+    filePtr = fopen(SSL_CERTIFICATE_PART_FILE, (0 == offset) ? "wb" : "r+b");
+    if (!filePtr)
+    {
+        return LWM2MCORE_ERR_GENERAL_ERROR;
+    }
+
+    if (   (0 != fseek(filePtr, 0, SEEK_END))
+        || (0 > (fileLen = ftell(filePtr)))
+        || (offset != (size_t)fileLen))
+    {
+        printf("SSL certificate part at offset %zu not following the written parts\n", offset);
+        fclose(filePtr);
+        return LWM2MCORE_ERR_GENERAL_ERROR;
+    }
+
+    writtenLen = len ? fwrite(bufferPtr, 1, len, filePtr) : 0;
+    if ((0 != fclose(filePtr)) || (len != writtenLen))
+    {
+        remove(SSL_CERTIFICATE_PART_FILE);
+        return LWM2MCORE_ERR_GENERAL_ERROR;
+    }
+
+    if (!isLast)
+    {
+        return LWM2MCORE_ERR_COMPLETED_OK;
+    }
+
+    // The complete certificate replaces the saved one
+    if (0 == (offset + len))
+    {
+        remove(SSL_CERTIFICATE_PART_FILE);
+        remove(SSL_CERTIFICATE_FILE);
+        return LWM2MCORE_ERR_COMPLETED_OK;
+    }
+
+    if (0 != rename(SSL_CERTIFICATE_PART_FILE, SSL_CERTIFICATE_FILE))
+    {
+        remove(SSL_CERTIFICATE_PART_FILE);
+        return LWM2MCORE_ERR_GENERAL_ERROR;
+    }
+
     return LWM2MCORE_ERR_COMPLETED_OK;
 }
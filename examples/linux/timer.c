@@ -189,3 +189,22 @@ bool lwm2mcore_TimerIsRunning
     }
     return true;
 }
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Adaptation function to get a monotonic time, used to measure durations
+ *
+ * @return
+ *      - monotonic time in microseconds
+ */
+//--------------------------------------------------------------------------------------------------
+uint64_t lwm2mcore_GetTimeUs
+(
+    void
+)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000) + ((uint64_t)ts.tv_nsec / 1000);
+}
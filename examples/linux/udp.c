@@ -18,6 +18,7 @@
 #include <sys/socket.h>
 #include <unistd.h>
 #include <errno.h>
+#include <pthread.h>
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -33,6 +34,36 @@ const char* localPortPtr = "56830";
 //--------------------------------------------------------------------------------------------------
 lwm2mcore_SocketConfig_t LinuxSocketConfig;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum length of the port string of a server address, including the null-terminator
+ */
+//--------------------------------------------------------------------------------------------------
+#define PORT_MAX_LEN        8
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Server address resolution started by lwm2mcore_UdpResolve
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    bool                isStarted;                                  ///< Thread started
+    pthread_t           thread;                                     ///< Resolution thread
+    char                host[LWM2MCORE_SERVER_URI_MAX_LEN + 1];     ///< Resolved host
+    char                port[PORT_MAX_LEN];                         ///< Resolved port
+    int                 result;                                     ///< getaddrinfo result
+    struct addrinfo*    addrListPtr;                                ///< Resolved addresses
+}
+AddressResolution_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Server address resolution
+ */
+//--------------------------------------------------------------------------------------------------
+static AddressResolution_t Resolution;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Create a socket
@@ -86,6 +117,122 @@ static int CreateSocket
     return s;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Resolution thread: resolve the server address for any address family, the address family of the
+ * socket being only known by lwm2mcore_UdpConnect
+ */
+//--------------------------------------------------------------------------------------------------
+static void* ResolveAddress
+(
+    void* contextPtr        ///< [IN] Server address resolution
+)
+{
+    AddressResolution_t* resolutionPtr = (AddressResolution_t*)contextPtr;
+    struct addrinfo hints;
+
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_DGRAM;
+
+    resolutionPtr->result = getaddrinfo(resolutionPtr->host,
+                                        resolutionPtr->port,
+                                        &hints,
+                                        &resolutionPtr->addrListPtr);
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Wait for the end of the started resolution and take its result
+ *
+ * @return
+ *      - resolved addresses if the resolution concerns the host and port and succeeded, to be
+ *        released by freeaddrinfo
+ *      - NULL otherwise
+ */
+//--------------------------------------------------------------------------------------------------
+static struct addrinfo* TakeResolvedAddress
+(
+    const char* hostPtr,        ///< [IN] Host, NULL to discard the resolution
+    const char* portPtr         ///< [IN] Port, NULL to discard the resolution
+)
+{
+    struct addrinfo* addrListPtr = NULL;
+
+    if (!Resolution.isStarted)
+    {
+        return NULL;
+    }
+
+    pthread_join(Resolution.thread, NULL);
+    Resolution.isStarted = false;
+
+    if ((0 == Resolution.result) && (NULL != Resolution.addrListPtr))
+    {
+        if (   (NULL != hostPtr)
+            && (NULL != portPtr)
+            && (0 == strcmp(hostPtr, Resolution.host))
+            && (0 == strcmp(portPtr, Resolution.port))
+           )
+        {
+            addrListPtr = Resolution.addrListPtr;
+        }
+        else
+        {
+            freeaddrinfo(Resolution.addrListPtr);
+        }
+    }
+    Resolution.addrListPtr = NULL;
+
+    return addrListPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start the resolution of the server address
+ * This function is called by the LwM2MCore and must be adapted to the platform
+ * The aim of this function is to resolve the server address in a thread, the result being used by
+ * the next lwm2mcore_UdpConnect call for the same host and port
+ *
+ * @return
+ *      - true if the resolution is started
+ *      - false on error
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+bool lwm2mcore_UdpResolve
+(
+    const char* hostPtr,                ///< [IN] Host
+    const char* portPtr                 ///< [IN] Port
+)
+{
+    if (   (NULL == hostPtr)
+        || (NULL == portPtr)
+        || (sizeof(Resolution.host) <= strlen(hostPtr))
+        || (sizeof(Resolution.port) <= strlen(portPtr))
+       )
+    {
+        return false;
+    }
+
+    // Only one resolution at a time: discard the previous one
+    TakeResolvedAddress(NULL, NULL);
+
+    memset(&Resolution, 0, sizeof(Resolution));
+    strcpy(Resolution.host, hostPtr);
+    strcpy(Resolution.port, portPtr);
+
+    if (0 != pthread_create(&Resolution.thread, NULL, ResolveAddress, &Resolution))
+    {
+        printf("Failed to start the address resolution: %s\n", strerror(errno));
+        return false;
+    }
+    Resolution.isStarted = true;
+
+    return true;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Open a socket to the server
@@ -234,19 +381,29 @@ bool lwm2mcore_UdpConnect
     int sockfd;
     (void)serverAddressPtr;
 
-    // Connect
-    memset(&hints, 0, sizeof(hints));
-    hints.ai_family = addressFamily;
-    hints.ai_socktype = SOCK_DGRAM;
-
-    if ((0 != getaddrinfo(hostPtr, portPtr, &hints, &servinfoPtr)) || (servinfoPtr == NULL))
+    // Use the address resolved by lwm2mcore_UdpResolve if any
+    servinfoPtr = TakeResolvedAddress(hostPtr, portPtr);
+    if (NULL == servinfoPtr)
     {
-        return false;
+        memset(&hints, 0, sizeof(hints));
+        hints.ai_family = addressFamily;
+        hints.ai_socktype = SOCK_DGRAM;
+
+        if ((0 != getaddrinfo(hostPtr, portPtr, &hints, &servinfoPtr)) || (servinfoPtr == NULL))
+        {
+            return false;
+        }
     }
 
+    // Connect
     sockfd = -1;
     for (p = servinfoPtr; (p != NULL) && (sockfd == -1); p = p->ai_next)
     {
+        if ((AF_UNSPEC != addressFamily) && (p->ai_family != addressFamily))
+        {
+            continue;
+        }
+
         sockfd = socket(p->ai_family, p->ai_socktype, p->ai_protocol);
 
         if (sockfd >= 0)
@@ -3,6 +3,9 @@
  *
  * Porting layer for Firmware Over The Air update
  *
+ * @note The package decompression uses the inflate functions from zlib. Zstandard frames are
+ * supported if the client is built with LWM2MCORE_WITH_ZSTD.
+ *
  * Copyright (C) Sierra Wireless Inc.
  *
  */
@@ -10,16 +13,227 @@
 #include <stdint.h>
 #include <stddef.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zlib.h>
+#ifdef LWM2MCORE_WITH_ZSTD
+#include <zstd.h>
+#endif
 #include <platform/types.h>
 #include <lwm2mcore/lwm2mcore.h>
 #include <lwm2mcore/update.h>
+#include "packageStorage.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Decompression context
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    lwm2mcore_CompressionType_t type;       ///< Compression algorithm
+    union
+    {
+        z_stream        zlib;               ///< zlib inflate stream
+#ifdef LWM2MCORE_WITH_ZSTD
+        ZSTD_DStream*   zstdPtr;            ///< Zstandard decompression stream
+#endif
+    } u;
+}
+DecompressionCtx_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Define for the file storing the binary of a package pushed by the server
+ */
+//--------------------------------------------------------------------------------------------------
+#define PUSH_PACKAGE_FILE       "package_push"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Package downloader of the package pushed by the server
+ */
+//--------------------------------------------------------------------------------------------------
+static lwm2mcore_PackageDownloader_t PushDownloader;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Storage of the package pushed by the server
+ */
+//--------------------------------------------------------------------------------------------------
+static PackageStorage_t PushStorage;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Firmware update state of the package pushed by the server
+ */
+//--------------------------------------------------------------------------------------------------
+static lwm2mcore_FwUpdateState_t PushFwUpdateState = LWM2MCORE_FW_UPDATE_STATE_IDLE;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the download of a pushed package: nothing to connect to
+ *
+ * @return
+ *  - DWL_OK    The function succeeded
+ */
+//--------------------------------------------------------------------------------------------------
+static lwm2mcore_DwlResult_t PushInitDownload
+(
+    char* uriPtr,   ///< URI to use for the download
+    void* ctxPtr    ///< Context pointer
+)
+{
+    (void)uriPtr;
+    (void)ctxPtr;
+    return DWL_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the information of a pushed package: the package size is not known in advance
+ *
+ * @return
+ *  - DWL_OK    The function succeeded
+ */
+//--------------------------------------------------------------------------------------------------
+static lwm2mcore_DwlResult_t PushGetPackageInfo
+(
+    lwm2mcore_PackageDownloaderData_t* dataPtr, ///< Information about the package
+    void* ctxPtr                                ///< Context pointer
+)
+{
+    (void)ctxPtr;
+    dataPtr->packageSize = 0;
+    return DWL_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the firmware update state of a pushed package
+ *
+ * @return
+ *  - DWL_OK    The function succeeded
+ */
+//--------------------------------------------------------------------------------------------------
+static lwm2mcore_DwlResult_t PushSetFwUpdateState
+(
+    lwm2mcore_FwUpdateState_t updateState       ///< New update state
+)
+{
+    printf("Pushed package: firmware update state %d\n", updateState);
+    PushFwUpdateState = updateState;
+    return DWL_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the firmware update result of a pushed package
+ *
+ * @return
+ *  - DWL_OK    The function succeeded
+ */
+//--------------------------------------------------------------------------------------------------
+static lwm2mcore_DwlResult_t PushSetFwUpdateResult
+(
+    lwm2mcore_FwUpdateResult_t updateResult     ///< New update result
+)
+{
+    printf("Pushed package: firmware update result %d\n", updateResult);
+    return DWL_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the software update state of a pushed package: only firmware packages are pushed
+ *
+ * @return
+ *  - DWL_FAULT The function failed
+ */
+//--------------------------------------------------------------------------------------------------
+static lwm2mcore_DwlResult_t PushSetSwUpdateState
+(
+    lwm2mcore_SwUpdateState_t updateState       ///< New update state
+)
+{
+    (void)updateState;
+    return DWL_FAULT;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the software update result of a pushed package: only firmware packages are pushed
+ *
+ * @return
+ *  - DWL_FAULT The function failed
+ */
+//--------------------------------------------------------------------------------------------------
+static lwm2mcore_DwlResult_t PushSetSwUpdateResult
+(
+    lwm2mcore_SwUpdateResult_t updateResult     ///< New update result
+)
+{
+    (void)updateResult;
+    return DWL_FAULT;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start the download of a pushed package: the data are pushed by the server, as an asynchronous
+ * transfer
+ *
+ * @return
+ *  - DWL_BUSY  The asynchronous transfer is started
+ */
+//--------------------------------------------------------------------------------------------------
+static lwm2mcore_DwlResult_t PushDownload
+(
+    uint64_t startOffset,       ///< Offset indicating where to start the download
+    void* ctxPtr                ///< Context pointer
+)
+{
+    (void)startOffset;
+    (void)ctxPtr;
+    return DWL_BUSY;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * End the download of a pushed package: the package file is kept only if it is complete
+ *
+ * @return
+ *  - DWL_OK    The function succeeded
+ *  - DWL_FAULT The function failed
+ */
+//--------------------------------------------------------------------------------------------------
+static lwm2mcore_DwlResult_t PushEndDownload
+(
+    void* ctxPtr            ///< Context pointer
+)
+{
+    bool isComplete = (LWM2MCORE_FW_UPDATE_STATE_DOWNLOADED == PushFwUpdateState);
+    lwm2mcore_DwlResult_t result;
+
+    result = PackageStorageClose((PackageStorage_t*)ctxPtr, isComplete);
+    if (!isComplete)
+    {
+        remove(PUSH_PACKAGE_FILE);
+        remove(PUSH_PACKAGE_FILE ".ckpt");
+    }
+
+    return result;
+}
 
 //--------------------------------------------------------------------------------------------------
 /**
  * The server pushes a package to the LWM2M client
  *
+ * A firmware package is stored in a file by the package downloader, as the blocks are received.
+ *
  * @return
- *      - LWM2MCORE_ERR_NOT_YET_IMPLEMENTED if the resource is not yet implemented
+ *      - LWM2MCORE_ERR_COMPLETED_OK if the push transfer is started
+ *      - LWM2MCORE_ERR_GENERAL_ERROR if the package downloader can't be started
+ *      - LWM2MCORE_ERR_NOT_YET_IMPLEMENTED if the update type is not yet implemented
  *      - LWM2MCORE_ERR_INVALID_ARG if a parameter is invalid in resource handler
  */
 //--------------------------------------------------------------------------------------------------
@@ -31,20 +245,68 @@ lwm2mcore_Sid_t lwm2mcore_PushUpdatePackage
     size_t len                      ///< [IN] length of input buffer
 )
 {
-    if ((NULL == bufferPtr) || (LWM2MCORE_MAX_UPDATE_TYPE <= type))
+    if (((NULL == bufferPtr) && (0 != len)) || (LWM2MCORE_MAX_UPDATE_TYPE <= type))
     {
         return LWM2MCORE_ERR_INVALID_ARG;
     }
 
-    (void)type;
     (void)instanceId;
-    (void)bufferPtr;
-    (void)len;
 
-    printf("update.c to be implemented\n");
-    return LWM2MCORE_ERR_NOT_YET_IMPLEMENTED;
-}
+    if (LWM2MCORE_FW_UPDATE_TYPE != type)
+    {
+        printf("update.c to be implemented\n");
+        return LWM2MCORE_ERR_NOT_YET_IMPLEMENTED;
+    }
+
+    // A push transfer in progress is aborted
+    if (DWL_OK == lwm2mcore_PackageDownloaderEndTransfer(DWL_ABORTED))
+    {
+        printf("Pushed package transfer aborted\n");
+    }
+
+    // An empty package cancels the update
+    if (0 == len)
+    {
+        PushFwUpdateState = LWM2MCORE_FW_UPDATE_STATE_IDLE;
+        return LWM2MCORE_ERR_COMPLETED_OK;
+    }
+
+    if (DWL_OK != PackageStorageOpen(&PushStorage,
+                                     PUSH_PACKAGE_FILE,
+                                     0,
+                                     PKG_STORAGE_MODE_BUFFERED,
+                                     false))
+    {
+        return LWM2MCORE_ERR_GENERAL_ERROR;
+    }
 
+    memset(&PushDownloader, 0, sizeof(PushDownloader));
+    PushDownloader.data.updateType = LWM2MCORE_FW_UPDATE_TYPE;
+    PushDownloader.initDownload = PushInitDownload;
+    PushDownloader.getInfo = PushGetPackageInfo;
+    PushDownloader.setFwUpdateState = PushSetFwUpdateState;
+    PushDownloader.setFwUpdateResult = PushSetFwUpdateResult;
+    PushDownloader.setSwUpdateState = PushSetSwUpdateState;
+    PushDownloader.setSwUpdateResult = PushSetSwUpdateResult;
+    PushDownloader.download = PushDownload;
+    PushDownloader.storeRange = PackageStorageStoreRange;
+    PushDownloader.endDownload = PushEndDownload;
+    PushDownloader.ctxPtr = &PushStorage;
+
+    PushFwUpdateState = LWM2MCORE_FW_UPDATE_STATE_IDLE;
+    lwm2mcore_PackageDownloaderInit();
+
+    // The package downloader waits for the pushed data
+    if (DWL_BUSY != lwm2mcore_PackageDownloaderRun(&PushDownloader))
+    {
+        PackageStorageClose(&PushStorage, false);
+        remove(PUSH_PACKAGE_FILE);
+        remove(PUSH_PACKAGE_FILE ".ckpt");
+        return LWM2MCORE_ERR_GENERAL_ERROR;
+    }
+
+    return LWM2MCORE_ERR_COMPLETED_OK;
+}
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -450,3 +712,232 @@ lwm2mcore_Sid_t lwm2mcore_SuspendPackageDownload
     printf("update.c to be implemented\n");
     return LWM2MCORE_ERR_NOT_YET_IMPLEMENTED;
 }
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize a streaming decompression
+ *
+ * @return
+ *      - LWM2MCORE_ERR_COMPLETED_OK if the treatment succeeds
+ *      - LWM2MCORE_ERR_GENERAL_ERROR if the treatment fails
+ *      - LWM2MCORE_ERR_OP_NOT_SUPPORTED if the compression type is not supported
+ *      - LWM2MCORE_ERR_INVALID_ARG if a parameter is invalid
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_Sid_t lwm2mcore_StartDecompression
+(
+    lwm2mcore_CompressionType_t type,   ///< [IN] Compression algorithm
+    void** decompCtxPtr                 ///< [INOUT] Decompression context pointer
+)
+{
+    DecompressionCtx_t* ctxPtr;
+
+    if (!decompCtxPtr)
+    {
+        printf("No decompression context pointer\n");
+        return LWM2MCORE_ERR_INVALID_ARG;
+    }
+
+    ctxPtr = (DecompressionCtx_t*)malloc(sizeof(DecompressionCtx_t));
+    if (!ctxPtr)
+    {
+        printf("Unable to allocate the decompression context\n");
+        return LWM2MCORE_ERR_GENERAL_ERROR;
+    }
+    memset(ctxPtr, 0, sizeof(DecompressionCtx_t));
+    ctxPtr->type = type;
+
+    switch (type)
+    {
+        case LWM2MCORE_COMP_TYPE_ZLIB:
+            if (Z_OK != inflateInit(&ctxPtr->u.zlib))
+            {
+                printf("inflateInit failed: %s\n", ctxPtr->u.zlib.msg ? ctxPtr->u.zlib.msg : "");
+                free(ctxPtr);
+                return LWM2MCORE_ERR_GENERAL_ERROR;
+            }
+            break;
+
+#ifdef LWM2MCORE_WITH_ZSTD
+        case LWM2MCORE_COMP_TYPE_ZSTD:
+            ctxPtr->u.zstdPtr = ZSTD_createDStream();
+            if (   (!ctxPtr->u.zstdPtr)
+                || (ZSTD_isError(ZSTD_initDStream(ctxPtr->u.zstdPtr)))
+               )
+            {
+                printf("Unable to initialize the Zstandard stream\n");
+                ZSTD_freeDStream(ctxPtr->u.zstdPtr);
+                free(ctxPtr);
+                return LWM2MCORE_ERR_GENERAL_ERROR;
+            }
+            break;
+#endif
+
+        default:
+            printf("Unsupported compression type %d\n", type);
+            free(ctxPtr);
+            return LWM2MCORE_ERR_OP_NOT_SUPPORTED;
+    }
+
+    *decompCtxPtr = (void*)ctxPtr;
+    return LWM2MCORE_ERR_COMPLETED_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Decompress a part of a compressed stream
+ *
+ * The function consumes at most *inLenPtr bytes from inBufPtr and produces at most *outLenPtr
+ * bytes in outBufPtr. On return, *inLenPtr and *outLenPtr are respectively set to the number of
+ * consumed and produced bytes. If the output buffer is full, the function should be called again
+ * in order to flush the pending decompressed data.
+ *
+ * @return
+ *      - LWM2MCORE_ERR_COMPLETED_OK if the treatment succeeds
+ *      - LWM2MCORE_ERR_GENERAL_ERROR if the compressed stream is corrupted
+ *      - LWM2MCORE_ERR_INVALID_ARG if a parameter is invalid
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_Sid_t lwm2mcore_ProcessDecompression
+(
+    void*    decompCtxPtr,  ///< [IN] Decompression context pointer
+    uint8_t* inBufPtr,      ///< [IN] Compressed data
+    size_t*  inLenPtr,      ///< [INOUT] Compressed data length / consumed length
+    uint8_t* outBufPtr,     ///< [INOUT] Decompressed data buffer
+    size_t*  outLenPtr,     ///< [INOUT] Decompressed buffer length / produced length
+    bool*    isEndPtr       ///< [OUT] true if the end of the compressed stream is reached
+)
+{
+    DecompressionCtx_t* ctxPtr = (DecompressionCtx_t*)decompCtxPtr;
+
+    if ((!ctxPtr) || (!inLenPtr) || (!outBufPtr) || (!outLenPtr) || (!isEndPtr))
+    {
+        printf("NULL pointer provided\n");
+        return LWM2MCORE_ERR_INVALID_ARG;
+    }
+    if ((!inBufPtr) && (*inLenPtr))
+    {
+        printf("NULL input buffer provided\n");
+        return LWM2MCORE_ERR_INVALID_ARG;
+    }
+
+    *isEndPtr = false;
+
+    switch (ctxPtr->type)
+    {
+        case LWM2MCORE_COMP_TYPE_ZLIB:
+        {
+            int rc;
+            z_stream* streamPtr = &ctxPtr->u.zlib;
+
+            streamPtr->next_in = inBufPtr;
+            streamPtr->avail_in = (uInt)*inLenPtr;
+            streamPtr->next_out = outBufPtr;
+            streamPtr->avail_out = (uInt)*outLenPtr;
+
+            rc = inflate(streamPtr, Z_NO_FLUSH);
+            switch (rc)
+            {
+                case Z_STREAM_END:
+                    *isEndPtr = true;
+                    break;
+
+                case Z_OK:
+                case Z_BUF_ERROR:
+                    // Z_BUF_ERROR only means that no progress was possible with the given buffers
+                    break;
+
+                default:
+                    printf("inflate failed: %d %s\n", rc, streamPtr->msg ? streamPtr->msg : "");
+                    return LWM2MCORE_ERR_GENERAL_ERROR;
+            }
+
+            *inLenPtr -= streamPtr->avail_in;
+            *outLenPtr -= streamPtr->avail_out;
+        }
+        break;
+
+#ifdef LWM2MCORE_WITH_ZSTD
+        case LWM2MCORE_COMP_TYPE_ZSTD:
+        {
+            size_t rc;
+            ZSTD_inBuffer input = { inBufPtr, *inLenPtr, 0 };
+            ZSTD_outBuffer output = { outBufPtr, *outLenPtr, 0 };
+
+            rc = ZSTD_decompressStream(ctxPtr->u.zstdPtr, &output, &input);
+            if (ZSTD_isError(rc))
+            {
+                printf("ZSTD_decompressStream failed: %s\n", ZSTD_getErrorName(rc));
+                return LWM2MCORE_ERR_GENERAL_ERROR;
+            }
+
+            // A null return value indicates that a frame is completely decoded and flushed
+            if (0 == rc)
+            {
+                *isEndPtr = true;
+            }
+
+            *inLenPtr = input.pos;
+            *outLenPtr = output.pos;
+        }
+        break;
+#endif
+
+        default:
+            printf("Unsupported compression type %d\n", ctxPtr->type);
+            return LWM2MCORE_ERR_INVALID_ARG;
+    }
+
+    return LWM2MCORE_ERR_COMPLETED_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * End the streaming decompression and release the decompression context
+ *
+ * @return
+ *      - LWM2MCORE_ERR_COMPLETED_OK if the treatment succeeds
+ *      - LWM2MCORE_ERR_GENERAL_ERROR if the treatment fails
+ *      - LWM2MCORE_ERR_INVALID_ARG if a parameter is invalid
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_Sid_t lwm2mcore_EndDecompression
+(
+    void** decompCtxPtr     ///< [INOUT] Decompression context pointer
+)
+{
+    DecompressionCtx_t* ctxPtr;
+
+    if (!decompCtxPtr)
+    {
+        printf("No decompression context pointer\n");
+        return LWM2MCORE_ERR_INVALID_ARG;
+    }
+
+    ctxPtr = (DecompressionCtx_t*)*decompCtxPtr;
+    if (!ctxPtr)
+    {
+        return LWM2MCORE_ERR_COMPLETED_OK;
+    }
+
+    switch (ctxPtr->type)
+    {
+        case LWM2MCORE_COMP_TYPE_ZLIB:
+            inflateEnd(&ctxPtr->u.zlib);
+            break;
+
+#ifdef LWM2MCORE_WITH_ZSTD
+        case LWM2MCORE_COMP_TYPE_ZSTD:
+            ZSTD_freeDStream(ctxPtr->u.zstdPtr);
+            break;
+#endif
+
+        default:
+            break;
+    }
+
+    free(ctxPtr);
+    *decompCtxPtr = NULL;
+
+    return LWM2MCORE_ERR_COMPLETED_OK;
+}
@@ -0,0 +1,106 @@
+/**
+ * @file connStats.h
+ *
+ * Background sampling of the connectivity statistics: the counters of the Connectivity Statistics
+ * object (7) and the radio values of the Extended Connectivity Statistics object (10242) are read
+ * from the platform at a configured interval, and the last samples are kept in a ring.
+ *
+ * While the sampling is enabled, the reads of these resources are served from the last sample
+ * instead of the platform: a server read does not wait for the modem. The minimum, maximum and
+ * average values over the samples of the ring can be retrieved by the application.
+ *
+ * The samples are taken in the callback of the LWM2MCORE_TIMER_CONN_STATS timer, independently of
+ * the LwM2M session. The first sample is taken one second after the configuration: the resources
+ * are read from the platform until then. The timer callback can interrupt a read of the samples:
+ * a read never returns a partially written sample.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#ifndef __LWM2MCORE_CONNSTATS_H__
+#define __LWM2MCORE_CONNSTATS_H__
+
+#include <lwm2mcore/lwm2mcore.h>
+
+/**
+  * @addtogroup lwm2mcore_connstats_IFS
+  * @{
+  */
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Number of samples kept in the ring: the oldest sample is replaced by a new one
+ */
+//--------------------------------------------------------------------------------------------------
+#define LWM2MCORE_CONN_STATS_SAMPLE_MAX_NB      16
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Configuration of the connectivity statistics sampling
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t interval;          ///< Sampling interval in seconds
+}lwm2mcore_ConnStatsConfig_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Aggregation of the samples of a resource
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    int64_t min;                ///< Minimum value
+    int64_t max;                ///< Maximum value
+    int64_t avg;                ///< Average value, rounded toward zero
+    int64_t last;               ///< Value of the last sample
+    uint16_t sampleNb;          ///< Number of samples in which the value was read
+    uint32_t duration;          ///< Time in seconds between the first and the last of these
+                                ///< samples
+}lwm2mcore_ConnStatsAggregate_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Function to configure the connectivity statistics sampling.
+ *
+ * The samples of a previous configuration are discarded.
+ *
+ * @return
+ *      - @ref LWM2MCORE_ERR_COMPLETED_OK if the configuration is applied
+ *      - @ref LWM2MCORE_ERR_INVALID_ARG if the interval is 0
+ *      - @ref LWM2MCORE_ERR_GENERAL_ERROR if the sampling timer cannot be launched
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_Sid_t lwm2mcore_ConnStatsConfigure
+(
+    const lwm2mcore_ConnStatsConfig_t* configPtr    ///< [IN] Configuration, NULL to disable the
+                                                    ///<      sampling
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Function to aggregate the samples of a resource of the objects 7 or 10242
+ *
+ * @return
+ *      - @ref LWM2MCORE_ERR_COMPLETED_OK if the aggregation is retrieved
+ *      - @ref LWM2MCORE_ERR_INVALID_ARG if a parameter is invalid or if the resource is not sampled
+ *      - @ref LWM2MCORE_ERR_INVALID_STATE if the sampling is disabled or if no sample contains a
+ *             value of the resource
+ *      - @ref LWM2MCORE_ERR_GENERAL_ERROR if the samples keep being modified during the
+ *             aggregation
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_Sid_t lwm2mcore_GetConnStatsAggregate
+(
+    uint16_t oid,                                   ///< [IN] Object Id
+    uint16_t rid,                                   ///< [IN] Resource Id
+    lwm2mcore_ConnStatsAggregate_t* aggregatePtr    ///< [OUT] Aggregation of the samples
+);
+
+/**
+  * @}
+  */
+
+#endif /* __LWM2MCORE_CONNSTATS_H__ */
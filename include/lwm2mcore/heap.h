@@ -0,0 +1,103 @@
+/**
+ * @file heap.h
+ *
+ * LwM2MCore heap accounting: allocations tagged by subsystem
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#ifndef __LWM2MCORE_HEAP_H__
+#define __LWM2MCORE_HEAP_H__
+
+#include <lwm2mcore/lwm2mcore.h>
+
+/**
+  * @addtogroup lwm2mcore_heap_IFS
+  * @{
+  */
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Enum for the subsystems owning heap allocations
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    LWM2MCORE_HEAP_TAG_WAKAAMA = 0,         ///< Wakaama, and any allocation without tag done with
+                                            ///< lwm2m_malloc
+    LWM2MCORE_HEAP_TAG_OBJECT_MANAGER,      ///< Object manager: objects, resources, bootstrap
+                                            ///< information
+    LWM2MCORE_HEAP_TAG_SESSION_MANAGER,     ///< Session manager: client context, traces
+    LWM2MCORE_HEAP_TAG_PACKAGE_DOWNLOADER,  ///< Package downloader
+    LWM2MCORE_HEAP_TAG_TINYDTLS,            ///< DTLS connections and sessions
+    LWM2MCORE_HEAP_TAG_PLATFORM,            ///< Platform adaptation layer
+    LWM2MCORE_HEAP_TAG_MAX                  ///< Internal usage
+}lwm2mcore_HeapTag_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Heap statistics of a subsystem
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint64_t currentBytes;      ///< Number of bytes currently allocated
+    uint64_t peakBytes;         ///< Peak of currentBytes
+    uint32_t currentNb;         ///< Number of allocated blocks
+    uint32_t allocNb;           ///< Number of allocations
+    uint32_t freeNb;            ///< Number of releases
+    uint32_t failureNb;         ///< Number of allocation failures
+}lwm2mcore_HeapStats_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Adaptation function for a memory allocation owned by a subsystem.
+ *
+ * The memory is released by lwm2m_free. A platform which does not account the allocations can
+ * simply call lwm2m_malloc.
+ *
+ * @return
+ *      - memory address
+ *      - @c NULL in case of allocation failure
+ */
+//--------------------------------------------------------------------------------------------------
+void* lwm2mcore_MallocTag
+(
+    size_t size,                    ///< [IN] Memory size to be allocated
+    lwm2mcore_HeapTag_t tag         ///< [IN] Subsystem owning the allocation
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Adaptation function to get the heap statistics of a subsystem
+ *
+ * @return
+ *      - @ref LWM2MCORE_ERR_COMPLETED_OK on success
+ *      - @ref LWM2MCORE_ERR_INVALID_ARG if the tag or the pointer is invalid
+ *      - @ref LWM2MCORE_ERR_NOT_YET_IMPLEMENTED if the platform does not account the allocations
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_Sid_t lwm2mcore_GetHeapStats
+(
+    lwm2mcore_HeapTag_t tag,        ///< [IN] Subsystem
+    lwm2mcore_HeapStats_t* statsPtr ///< [OUT] Heap statistics
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Adaptation function to reset the peaks and the counters of the heap statistics.
+ *
+ * The current number of bytes and blocks are kept.
+ */
+//--------------------------------------------------------------------------------------------------
+void lwm2mcore_ResetHeapStats
+(
+    void
+);
+
+/**
+  * @}
+  */
+
+#endif /* __LWM2MCORE_HEAP_H__ */
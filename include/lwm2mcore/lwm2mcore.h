@@ -143,8 +143,9 @@ typedef enum
     LWM2MCORE_EVENT_FALLBACK_STARTED               = 17,    ///< A fallback mechanism was started.
     LWM2MCORE_EVENT_DOWNLOAD_PROGRESS              = 18,    ///< Indicate the download %
     LWM2MCORE_EVENT_LWM2M_SESSION_TYPE_START       = 23,    ///< LWM2M Event to know if the session is a Bootstrap or a Device Management one
+    LWM2MCORE_EVENT_COAP_METRICS                   = 24,    ///< Periodic event to retrieve the CoAP metrics of the servers (see lwm2mcore_SetCoapMetricsPeriod)
     /* NEW EVENT TO BE ADDED BEFORE THIS COMMENT */
-    LWM2MCORE_EVENT_LAST                           = 24     ///< Internal usage
+    LWM2MCORE_EVENT_LAST                           = 25     ///< Internal usage
 }lwm2mcore_StatusType_t;
 
 //--------------------------------------------------------------------------------------------------
@@ -238,6 +239,25 @@ typedef enum
     LWM2MCORE_PKG_SW      ///< Package for software
 }lwm2mcore_PkgDwlType_t;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Enum for the startup phases, from lwm2mcore_Init to the registration to the server
+ *
+ * @note When a bootstrap is needed, the server connection and authentication phases concern the
+ * bootstrap server.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    LWM2MCORE_STARTUP_INIT = 0,             ///< lwm2mcore_Init is called
+    LWM2MCORE_STARTUP_OBJECTS_REGISTERED,   ///< lwm2mcore_ObjectRegister is done
+    LWM2MCORE_STARTUP_SOCKET_OPENED,        ///< The socket is opened by lwm2mcore_Connect
+    LWM2MCORE_STARTUP_SERVER_CONNECTED,     ///< The server address is resolved and connected
+    LWM2MCORE_STARTUP_AUTHENTICATED,        ///< The DTLS handshake with the server is done
+    LWM2MCORE_STARTUP_REGISTERED,           ///< The registration to the server is done
+    LWM2MCORE_STARTUP_PHASE_MAX             ///< Internal usage
+}lwm2mcore_StartupPhase_t;
+
 /**
   * @addtogroup lwm2mcore_init_IFS
   * @{
@@ -250,6 +270,19 @@ typedef enum
 //--------------------------------------------------------------------------------------------------
 typedef struct ClientData_s* lwm2mcore_Ref_t;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Startup profile: time of each startup phase since the lwm2mcore_Init call
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t phaseMask;                                 ///< Reached phases: bit n is set if the
+                                                        ///< phase n was reached
+    uint64_t elapsedUs[LWM2MCORE_STARTUP_PHASE_MAX];    ///< Time of the first occurrence of each
+                                                        ///< phase, in microseconds
+}lwm2mcore_StartupProfile_t;
+
 /**
   * @}
   */
@@ -363,6 +396,17 @@ typedef struct
                                             ///< @ref LWM2MCORE_EVENT_LWM2M_SESSION_TYPE_START event
 }lwm2mcore_SessionStatus_t;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Structure for CoAP metrics event
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint16_t serverNb;                      ///< Number of servers with CoAP metrics for
+                                            ///< @ref LWM2MCORE_EVENT_COAP_METRICS event
+}lwm2mcore_CoapMetricsStatus_t;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * @brief Structure for events (session and package download)
@@ -375,6 +419,7 @@ typedef struct
     {
         lwm2mcore_SessionStatus_t   session;    ///< Session information
         lwm2mcore_PkgDwlStatus_t    pkgStatus;  ///< Package download status
+        lwm2mcore_CoapMetricsStatus_t coapMetrics;  ///< CoAP metrics status
     }u;                                         ///< Union
 }lwm2mcore_Status_t;
 
@@ -418,6 +463,52 @@ typedef int (*lwm2mcore_ReadCallback_t)
     valueChangedCallback_t changedCb    ///< [IN] not used for READ operation
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Function pointer of resource streamed READ function.
+ *
+ * The value is read in parts, for example one part per CoAP Block2 block, so that a large value
+ * is never held in memory at once.
+ *
+ * @return
+ *      - 0 on success
+ *      - negative value on failure
+ */
+//--------------------------------------------------------------------------------------------------
+typedef int (*lwm2mcore_StreamReadCallback_t)
+(
+    lwm2mcore_Uri_t* uriPtr,            ///< [IN] uri represents the requested operation and
+                                        ///< object/resource.
+    size_t offset,                      ///< [IN] offset of the part in the value
+    char* bufferPtr,                    ///< [OUT] part of the value
+    size_t* lenPtr,                     ///< [INOUT] length of input buffer and length of the
+                                        ///< returned part
+    size_t* totalLenPtr                 ///< [OUT] total length of the value
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Function pointer of resource streamed WRITE function.
+ *
+ * The value is written in parts, for example one part per CoAP Block1 block as the blocks are
+ * received, so that a large value can be written to its storage without being held in memory at
+ * once. The parts are given in order, starting at offset 0.
+ *
+ * @return
+ *      - 0 on success
+ *      - negative value on failure
+ */
+//--------------------------------------------------------------------------------------------------
+typedef int (*lwm2mcore_StreamWriteCallback_t)
+(
+    lwm2mcore_Uri_t* uriPtr,            ///< [IN] uri represents the requested operation and
+                                        ///< object/resource.
+    size_t offset,                      ///< [IN] offset of the part in the value
+    char* bufferPtr,                    ///< [IN] part of the value
+    size_t len,                         ///< [IN] length of the part
+    bool isLast                         ///< [IN] the part is the last one of the value
+);
+
 //--------------------------------------------------------------------------------------------------
 /**
  * @brief Function pointer of resource WRITE/OBSERVE function.
@@ -467,6 +558,10 @@ typedef struct
     lwm2mcore_ReadCallback_t read;      ///< operation handler: READ handler
     lwm2mcore_WriteCallback_t write;    ///< operation handler: WRITE handler
     lwm2mcore_ExecuteCallback_t exec;   ///< operation handler: EXECUTE handler
+    lwm2mcore_StreamReadCallback_t streamRead;      ///< operation handler: streamed READ handler,
+                                                    ///< for the values read in blocks
+    lwm2mcore_StreamWriteCallback_t streamWrite;    ///< operation handler: streamed WRITE handler,
+                                                    ///< for the values written in blocks
 }lwm2mcore_Resource_t;
 
 //--------------------------------------------------------------------------------------------------
@@ -604,6 +699,9 @@ uint16_t lwm2mcore_ObjectRegister
 /**
  * @brief LwM2M client entry point to initiate a connection
  *
+ * The first LwM2M client step, which starts the connection to the server, is run before the
+ * function returns.
+ *
  * @return
  *      - @c true if the treatment is launched
  *      - else @c false
@@ -661,6 +759,24 @@ bool lwm2mcore_ConnectionGetType
                                     ///< true: device management)
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Function to retrieve the startup profile, i.e. the time of the startup phases reached
+ * since the last lwm2mcore_Init call.
+ *
+ * The profile is complete when the @ref LWM2MCORE_EVENT_LWM2M_SESSION_TYPE_START event is received
+ * for a device management session.
+ *
+ * @return
+ *      - @c true if the profile is retrieved
+ *      - else @c false
+ */
+//--------------------------------------------------------------------------------------------------
+bool lwm2mcore_GetStartupProfile
+(
+    lwm2mcore_StartupProfile_t* profilePtr  ///< [OUT] Startup profile
+);
+
 /**
   * @}
   */
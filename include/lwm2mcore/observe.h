@@ -0,0 +1,89 @@
+/**
+ * @file observe.h
+ *
+ * Observation of single-instance resources: the notification attributes (pmin, pmax, gt, lt, st)
+ * are evaluated by LwM2MCore.
+ *
+ * The application signals the changes of the resource values. A changed value is read once through
+ * the resource handler and compared with the last notified value: the server is notified if the
+ * change crosses the gt or lt thresholds or reaches the st step, or on any change if none of them
+ * is set. A notification is delayed until the minimum period (pmin) since the previous one is
+ * elapsed, and sent without change when the maximum period (pmax) is elapsed.
+ *
+ * The values are not read between the changes and the deadlines: when no value changes and no
+ * period is elapsed, the observations cost nothing.
+ *
+ * In queue mode, the notifications are held while the device sleeps and sent after its next
+ * wake-up (see queueMode.h).
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#ifndef __LWM2MCORE_OBSERVE_H__
+#define __LWM2MCORE_OBSERVE_H__
+
+#include <lwm2mcore/lwm2mcore.h>
+
+/**
+  * @addtogroup lwm2mcore_observe_IFS
+  * @{
+  */
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Statistics of the resource observations
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t changedNb;         ///< Number of changes signaled on observed resources
+    uint32_t filteredNb;        ///< Number of changes not notified: same value, or gt, lt and st
+                                ///< attributes not reached
+    uint32_t deferredNb;        ///< Number of notifications delayed by the minimum period
+    uint32_t notifiedNb;        ///< Number of notifications sent
+    uint32_t maxPeriodNb;       ///< Number of notifications sent without change, at the maximum
+                                ///< period
+    uint16_t observationNb;     ///< Number of observed resources
+}lwm2mcore_ObserveStats_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Function to signal that the value of a single-instance resource changed.
+ *
+ * If the resource is observed, its value is read through its read handler and the server is
+ * notified according to the notification attributes.
+ *
+ * @return
+ *      - @ref LWM2MCORE_ERR_COMPLETED_OK if the change is evaluated, or if the resource is not
+ *             observed
+ *      - @ref LWM2MCORE_ERR_INVALID_ARG if the instance reference is NULL
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_Sid_t lwm2mcore_ResourceChanged
+(
+    lwm2mcore_Ref_t instanceRef,    ///< [IN] instance reference
+    uint16_t oid,                   ///< [IN] Object Id
+    uint16_t oiid,                  ///< [IN] Object instance Id
+    uint16_t rid                    ///< [IN] Resource Id
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Function to retrieve the statistics of the resource observations
+ *
+ * @return
+ *      - @ref LWM2MCORE_ERR_COMPLETED_OK if the statistics are retrieved
+ *      - @ref LWM2MCORE_ERR_INVALID_ARG if a parameter is invalid
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_Sid_t lwm2mcore_GetObserveStats
+(
+    lwm2mcore_ObserveStats_t* statsPtr  ///< [OUT] Observation statistics
+);
+
+/**
+  * @}
+  */
+
+#endif /* __LWM2MCORE_OBSERVE_H__ */
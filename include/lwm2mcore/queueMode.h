@@ -0,0 +1,122 @@
+/**
+ * @file queueMode.h
+ *
+ * LwM2M queue mode: when the binding of the Device Management server is UDP with queue mode
+ * ("UQ"), the device sleeps between its exchanges with the server and the data which LwM2MCore
+ * sends on its own initiative are held until the next wake-up.
+ *
+ * The device is awake after the registration. It goes to sleep when no message has been exchanged
+ * with the server during the awake time and no transaction is on-going. While it sleeps:
+ * - the LwM2M engine is not stepped,
+ * - the composite observations are not checked,
+ * - the Send records are buffered, even if a send threshold is reached.
+ *
+ * The device wakes up for the next deadline of the LwM2M engine (Registration Update, observation
+ * maximum period), the age threshold of the Send records buffered before it went to sleep, or the
+ * maximum sleep time: the data produced while the device sleeps wait for the next wake-up, and the
+ * maximum sleep time bounds their latency. On wake-up, the device sends a Registration Update,
+ * which tells the server that the device is reachable: once the update is acknowledged, the
+ * changed values of the composite observations and the buffered Send records are sent in one
+ * burst, and the server can send its queued requests during the awake time.
+ *
+ * The messages sent by the application while the device sleeps (data push, asynchronous response)
+ * do not wake it up.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#ifndef __LWM2MCORE_QUEUEMODE_H__
+#define __LWM2MCORE_QUEUEMODE_H__
+
+#include <lwm2mcore/lwm2mcore.h>
+
+/**
+  * @addtogroup lwm2mcore_queuemode_IFS
+  * @{
+  */
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Default awake time in seconds: CoAP MAX_TRANSMIT_WAIT with the default transmission
+ * parameters of RFC 7252, as recommended by the LwM2M specification
+ */
+//--------------------------------------------------------------------------------------------------
+#define LWM2MCORE_QUEUE_MODE_AWAKE_TIME     93
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Configuration of the queue mode
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t awakeTime;         ///< Time in seconds the device stays awake after the last message
+                                ///< exchanged with the server
+    uint32_t maxSleepTime;      ///< Maximum sleep time in seconds, 0 for no limit other than the
+                                ///< deadlines of the LwM2M engine and of the Send records
+}lwm2mcore_QueueModeConfig_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Statistics of the queue mode
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t wakeUpNb;          ///< Number of wake-ups with a Registration Update
+    uint32_t burstNb;           ///< Number of bursts of held data sent after a wake-up
+    uint32_t heldNb;            ///< Number of Send messages held while the device was sleeping
+                                ///< or waking up
+    uint32_t awakeTime;         ///< Time in seconds spent awake in queue mode
+    uint32_t sleepTime;         ///< Time in seconds spent sleeping
+    bool isSleeping;            ///< The device is currently sleeping
+}lwm2mcore_QueueModeStats_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Function to configure the queue mode.
+ *
+ * The queue mode is applied at the next registration or Registration Update, if the binding of the
+ * server is "UQ". Disabling the queue mode wakes the device up at its next wake-up time.
+ *
+ * @return
+ *      - @ref LWM2MCORE_ERR_COMPLETED_OK if the configuration is applied
+ *      - @ref LWM2MCORE_ERR_INVALID_ARG if the configuration is invalid
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_Sid_t lwm2mcore_QueueModeConfigure
+(
+    const lwm2mcore_QueueModeConfig_t* configPtr    ///< [IN] Configuration, NULL to disable the
+                                                    ///<      queue mode
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Function to retrieve the statistics of the queue mode
+ *
+ * @return
+ *      - @ref LWM2MCORE_ERR_COMPLETED_OK if the statistics are retrieved
+ *      - @ref LWM2MCORE_ERR_INVALID_ARG if a parameter is invalid
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_Sid_t lwm2mcore_GetQueueModeStats
+(
+    lwm2mcore_QueueModeStats_t* statsPtr    ///< [OUT] Queue mode statistics
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Function to reset the statistics of the queue mode
+ */
+//--------------------------------------------------------------------------------------------------
+void lwm2mcore_ResetQueueModeStats
+(
+    void
+);
+
+/**
+  * @}
+  */
+
+#endif /* __LWM2MCORE_QUEUEMODE_H__ */
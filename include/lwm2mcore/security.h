@@ -47,6 +47,13 @@
 //--------------------------------------------------------------------------------------------------
 #define LWM2MCORE_ERROR_STR_MAX_LEN         128
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximal length of a digest state serialized by lwm2mcore_CopySha1
+ */
+//--------------------------------------------------------------------------------------------------
+#define LWM2MCORE_HASH_STATE_MAX_LEN        128
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This define value is used in lwm2mcore_GetCredential, lwm2mcore_SetCredential,
@@ -187,6 +194,12 @@ uint32_t lwm2mcore_Crc32
 /**
  * Initialize the SHA1 computation
  *
+ * A new context is allocated if the context pointer is NULL; it is released by
+ * lwm2mcore_CancelSha1. Several contexts can be used at the same time.
+ *
+ * @note The package type gives the public key verifying the package signature, the platform may
+ * therefore use another digest algorithm than SHA1 depending on the signature scheme of the key.
+ *
  * @return
  *      - LWM2MCORE_ERR_COMPLETED_OK if the treatment succeeds
  *      - LWM2MCORE_ERR_GENERAL_ERROR if the treatment fails
@@ -194,7 +207,8 @@ uint32_t lwm2mcore_Crc32
 //--------------------------------------------------------------------------------------------------
 lwm2mcore_Sid_t lwm2mcore_StartSha1
 (
-    void** sha1CtxPtr   ///< [INOUT] SHA1 context pointer
+    lwm2mcore_PkgDwlType_t packageType, ///< [IN] Package type (FW or SW)
+    void** sha1CtxPtr                   ///< [INOUT] SHA1 context pointer
 );
 
 //--------------------------------------------------------------------------------------------------
@@ -234,6 +248,9 @@ lwm2mcore_Sid_t lwm2mcore_EndSha1
 /**
  * Copy the SHA1 context in a buffer
  *
+ * The digest state is serialized in a portable format of at most LWM2MCORE_HASH_STATE_MAX_LEN
+ * bytes, to be saved in platform memory and restored by lwm2mcore_RestoreSha1.
+ *
  * @return
  *      - LWM2MCORE_ERR_COMPLETED_OK if the treatment succeeds
  *      - LWM2MCORE_ERR_GENERAL_ERROR if the treatment fails
@@ -251,6 +268,8 @@ lwm2mcore_Sid_t lwm2mcore_CopySha1
 /**
  * Restore the SHA1 context from a buffer
  *
+ * A new context is allocated if the context pointer is NULL.
+ *
  * @return
  *      - LWM2MCORE_ERR_COMPLETED_OK if the treatment succeeds
  *      - LWM2MCORE_ERR_GENERAL_ERROR if the treatment fails
@@ -266,7 +285,7 @@ lwm2mcore_Sid_t lwm2mcore_RestoreSha1
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Cancel and reset the SHA1 computation
+ * Cancel and reset the SHA1 computation. The context is released and its pointer is reset.
  *
  * @return
  *      - LWM2MCORE_ERR_COMPLETED_OK if the treatment succeeds
@@ -296,4 +315,47 @@ lwm2mcore_Sid_t lwm2mcore_UpdateSslCertificate
     char*  certPtr,    ///< [IN] Certificate
     int    len         ///< [IN] Certificate len
 );
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read a part of the saved SSL certificate
+ *
+ * The certificate is read in parts, so that it is never held in memory at once. The returned part
+ * is shorter than the buffer at the end of the certificate. A missing certificate is empty.
+ *
+ * @return
+ *      - LWM2MCORE_ERR_COMPLETED_OK if the read succeeds
+ *      - LWM2MCORE_ERR_GENERAL_ERROR if the read fails
+ *      - LWM2MCORE_ERR_INVALID_ARG if a parameter is invalid
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_Sid_t lwm2mcore_GetSslCertificate
+(
+    size_t offset,          ///< [IN] Offset of the part in the certificate
+    char* bufferPtr,        ///< [OUT] Part of the certificate
+    size_t* lenPtr,         ///< [INOUT] Buffer length and length of the part
+    size_t* totalLenPtr     ///< [OUT] Certificate length
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a part of the SSL certificate
+ *
+ * The certificate is written in parts, in order and starting at offset 0, so that it is never held
+ * in memory at once. The part at offset 0 starts a new certificate. The saved certificate is only
+ * replaced once the last part is written: an empty certificate deletes it.
+ *
+ * @return
+ *      - LWM2MCORE_ERR_COMPLETED_OK if the write succeeds
+ *      - LWM2MCORE_ERR_GENERAL_ERROR if the write fails
+ *      - LWM2MCORE_ERR_INVALID_ARG if a parameter is invalid
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_Sid_t lwm2mcore_UpdateSslCertificatePart
+(
+    size_t offset,          ///< [IN] Offset of the part in the certificate
+    char* bufferPtr,        ///< [IN] Part of the certificate
+    size_t len,             ///< [IN] Length of the part
+    bool isLast             ///< [IN] The part is the last one of the certificate
+);
 #endif /* __LWM2MCORE_SECURITY_H__ */
@@ -0,0 +1,164 @@
+/**
+ * @file send.h
+ *
+ * LwM2M 1.1 Send operation: the application records timestamped resource values, which are
+ * buffered by LwM2MCore and sent to the server in a single SenML-CBOR message, a confirmable POST
+ * request on /dp
+ *
+ * The values are read through the resource handlers when they are recorded. The buffered records
+ * are sent when:
+ * - their payload reaches the configured length,
+ * - the oldest record reaches the configured age,
+ * - another message is sent to the server, if configured: the radio is then already on,
+ * - the application requests it.
+ *
+ * In queue mode, the records are held while the device sleeps and sent after its next wake-up (see
+ * queueMode.h).
+ *
+ * Only one Send message is in flight at a time: it is retransmitted as any confirmable CoAP
+ * message, and the records are kept in the buffer until the server acknowledges the message. They
+ * are sent again in the next message if it is not acknowledged.
+ * When the buffer is full, the oldest record is dropped.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#ifndef __LWM2MCORE_SEND_H__
+#define __LWM2MCORE_SEND_H__
+
+#include <lwm2mcore/lwm2mcore.h>
+
+/**
+  * @addtogroup lwm2mcore_send_IFS
+  * @{
+  */
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Minimum payload length of a Send message
+ */
+//--------------------------------------------------------------------------------------------------
+#define LWM2MCORE_SEND_PAYLOAD_MIN_LEN  64
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Maximum payload length of a Send message: the message is not sent in blocks
+ */
+//--------------------------------------------------------------------------------------------------
+#define LWM2MCORE_SEND_PAYLOAD_MAX_LEN  1024
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Configuration of the Send operation
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint16_t recordMaxNb;       ///< Maximum number of buffered records
+    uint16_t payloadMaxLen;     ///< Maximum payload length of a Send message: the records are sent
+                                ///< when their payload reaches this length
+    uint32_t maxAge;            ///< Maximum age of a buffered record in seconds before the records
+                                ///< are sent, 0 to disable the age threshold
+    bool flushOnUplink;         ///< Send the records when another message is sent to the server
+}lwm2mcore_SendConfig_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Statistics of the Send operation
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t recordedNb;        ///< Number of recorded values
+    uint32_t droppedNb;         ///< Number of records dropped from the full buffer before being
+                                ///< acknowledged
+    uint32_t sendNb;            ///< Number of Send messages initiated
+    uint32_t ackNb;             ///< Number of Send messages acknowledged
+    uint32_t sentRecordNb;      ///< Number of records acknowledged
+    uint32_t failedNb;          ///< Number of Send messages which could not be initiated or were
+                                ///< not acknowledged
+    uint16_t bufferedNb;        ///< Number of records currently buffered
+}lwm2mcore_SendStats_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Function to configure the Send operation. The buffered records are dropped.
+ *
+ * @return
+ *      - @ref LWM2MCORE_ERR_COMPLETED_OK if the configuration is applied
+ *      - @ref LWM2MCORE_ERR_INVALID_ARG if the configuration is invalid
+ *      - @ref LWM2MCORE_ERR_INVALID_STATE if a Send message is in flight
+ *      - @ref LWM2MCORE_ERR_GENERAL_ERROR on memory allocation failure
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_Sid_t lwm2mcore_SendConfigure
+(
+    const lwm2mcore_SendConfig_t* configPtr     ///< [IN] Configuration, NULL to disable the Send
+                                                ///<      operation
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Function to record the current value of a single-instance resource, read through its
+ * read handler, with a timestamp
+ *
+ * The records are sent if the payload length threshold is reached.
+ *
+ * @return
+ *      - @ref LWM2MCORE_ERR_COMPLETED_OK if the value is recorded
+ *      - @ref LWM2MCORE_ERR_INVALID_ARG if the resource is not registered or has multiple
+ *             instances
+ *      - @ref LWM2MCORE_ERR_INVALID_STATE if the Send operation is not configured
+ *      - @ref LWM2MCORE_ERR_OP_NOT_SUPPORTED if the resource cannot be read
+ *      - @ref LWM2MCORE_ERR_OVERFLOW if the record is larger than the maximum payload length
+ *      - @ref LWM2MCORE_ERR_GENERAL_ERROR if the read handler fails
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_Sid_t lwm2mcore_SendRecord
+(
+    lwm2mcore_Ref_t instanceRef,    ///< [IN] instance reference
+    uint16_t oid,                   ///< [IN] Object Id
+    uint16_t oiid,                  ///< [IN] Object instance Id
+    uint16_t rid,                   ///< [IN] Resource Id
+    int64_t time                    ///< [IN] Time of the value (UNIX time in seconds)
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Function to send the buffered records, for example when the application knows that the
+ * radio is on
+ *
+ * @return
+ *      - @ref LWM2MCORE_ERR_COMPLETED_OK if a Send message is initiated or if no record is
+ *             buffered
+ *      - @ref LWM2MCORE_ERR_INVALID_STATE if the Send operation is not configured, if a Send
+ *             message is in flight, or if the device sleeps in queue mode (see queueMode.h): the
+ *             records are sent later
+ *      - @ref LWM2MCORE_ERR_GENERAL_ERROR if the message cannot be initiated
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_Sid_t lwm2mcore_SendFlush
+(
+    lwm2mcore_Ref_t instanceRef     ///< [IN] instance reference
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Function to retrieve the statistics of the Send operation
+ *
+ * @return
+ *      - @ref LWM2MCORE_ERR_COMPLETED_OK if the statistics are retrieved
+ *      - @ref LWM2MCORE_ERR_INVALID_ARG if a parameter is invalid
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_Sid_t lwm2mcore_GetSendStats
+(
+    lwm2mcore_SendStats_t* statsPtr     ///< [OUT] Send statistics
+);
+
+/**
+  * @}
+  */
+
+#endif /* __LWM2MCORE_SEND_H__ */
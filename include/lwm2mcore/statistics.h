@@ -0,0 +1,197 @@
+/**
+ * @file statistics.h
+ *
+ * LwM2MCore statistics: latency histograms of the LwM2M operations handled by the objects and
+ * CoAP transaction metrics of the servers
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#ifndef __LWM2MCORE_STATISTICS_H__
+#define __LWM2MCORE_STATISTICS_H__
+
+#include <lwm2mcore/lwm2mcore.h>
+
+/**
+  * @addtogroup lwm2mcore_stats_IFS
+  * @{
+  */
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Number of buckets of a latency histogram.
+ *
+ * The bucket n counts the latencies from 2^n to 2^(n+1) - 1 microseconds. The first bucket also
+ * counts the null latencies and the last bucket counts all the latencies from 2^n microseconds
+ * (about 8 seconds).
+ */
+//--------------------------------------------------------------------------------------------------
+#define LWM2MCORE_STATS_BUCKET_NB       24
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Maximum number of objects with statistics
+ */
+//--------------------------------------------------------------------------------------------------
+#define LWM2MCORE_STATS_OBJECT_MAX_NB   32
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Maximum number of servers with CoAP metrics
+ */
+//--------------------------------------------------------------------------------------------------
+#define LWM2MCORE_COAP_METRICS_SERVER_MAX_NB    4
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Enum for the LwM2M operations with statistics
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    LWM2MCORE_STATS_OP_READ = 0,        ///< Read
+    LWM2MCORE_STATS_OP_WRITE,           ///< Write
+    LWM2MCORE_STATS_OP_EXECUTE,         ///< Execute
+    LWM2MCORE_STATS_OP_DISCOVER,        ///< Discover
+    LWM2MCORE_STATS_OP_CREATE,          ///< Create
+    LWM2MCORE_STATS_OP_DELETE,          ///< Delete
+    LWM2MCORE_STATS_OP_MAX              ///< Internal usage
+}lwm2mcore_StatsOp_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Latency histogram
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t count;                                 ///< Number of latencies
+    uint32_t maxUs;                                 ///< Maximum latency in microseconds
+    uint64_t totalUs;                               ///< Sum of the latencies in microseconds
+    uint32_t buckets[LWM2MCORE_STATS_BUCKET_NB];    ///< Number of latencies per bucket
+}lwm2mcore_Histogram_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Statistics of an object
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint16_t oid;                                           ///< Object Id
+    lwm2mcore_Histogram_t request[LWM2MCORE_STATS_OP_MAX];  ///< Time to handle the requests
+    lwm2mcore_Histogram_t callback[LWM2MCORE_STATS_OP_MAX]; ///< Time spent in the resource
+                                                            ///< read, write and execute handlers
+}lwm2mcore_ObjectStats_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief CoAP transaction metrics of a server
+ *
+ * The round-trip times are measured from the first transmission of a confirmable message to its
+ * acknowledgement or reset, and are only sampled for the messages which were not retransmitted.
+ * A confirmable message is counted as a timeout when it is not acknowledged within the CoAP
+ * MAX_TRANSMIT_WAIT time (93 seconds with the default transmission parameters).
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint16_t securityInstId;            ///< Security object instance Id of the server
+    uint32_t conSentNb;                 ///< Number of confirmable messages sent, excluding the
+                                        ///< retransmissions
+    uint32_t retransmissionNb;          ///< Number of retransmissions of confirmable messages
+    uint32_t timeoutNb;                 ///< Number of confirmable messages never acknowledged
+    uint32_t duplicateNb;               ///< Number of duplicate requests received
+    uint32_t dtlsRecordSentNb;          ///< Number of DTLS records sent
+    uint32_t dtlsRecordReceivedNb;      ///< Number of DTLS records received
+    uint64_t bytesSent;                 ///< Number of bytes sent in UDP datagrams
+    uint64_t bytesReceived;             ///< Number of bytes received in UDP datagrams
+    uint32_t srttUs;                    ///< Smoothed round-trip time in microseconds (RFC 6298),
+                                        ///< 0 if no round-trip time was sampled
+    uint32_t rttVarUs;                  ///< Round-trip time variation in microseconds (RFC 6298)
+    lwm2mcore_Histogram_t rtt;          ///< Round-trip times
+    lwm2mcore_Histogram_t handshake;    ///< DTLS handshake durations
+}lwm2mcore_CoapMetrics_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Function to retrieve the statistics of an object.
+ *
+ * The statistics are recorded without lock by the LwM2MCore thread: they can be read by another
+ * thread, each counter being consistent.
+ *
+ * @return
+ *      - @ref LWM2MCORE_ERR_COMPLETED_OK if the statistics are retrieved
+ *      - @ref LWM2MCORE_ERR_INCORRECT_RANGE if no object has this index: the index of the objects
+ *             with statistics goes from 0 to the number of objects minus 1
+ *      - @ref LWM2MCORE_ERR_INVALID_ARG if a parameter is invalid
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_Sid_t lwm2mcore_GetStatistics
+(
+    uint16_t index,                     ///< [IN] Index of the object
+    lwm2mcore_ObjectStats_t* statsPtr   ///< [OUT] Object statistics
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Function to reset the statistics of all the objects
+ */
+//--------------------------------------------------------------------------------------------------
+void lwm2mcore_ResetStatistics
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Function to retrieve the CoAP metrics of a server.
+ *
+ * This function has to be called from the LwM2MCore thread, for example on the
+ * @ref LWM2MCORE_EVENT_COAP_METRICS event.
+ *
+ * @return
+ *      - @ref LWM2MCORE_ERR_COMPLETED_OK if the metrics are retrieved
+ *      - @ref LWM2MCORE_ERR_INCORRECT_RANGE if no server has this index: the index of the servers
+ *             with metrics goes from 0 to the number of servers minus 1
+ *      - @ref LWM2MCORE_ERR_INVALID_ARG if a parameter is invalid
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_Sid_t lwm2mcore_GetCoapMetrics
+(
+    uint16_t index,                     ///< [IN] Index of the server
+    lwm2mcore_CoapMetrics_t* metricsPtr ///< [OUT] Server metrics
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Function to reset the CoAP metrics of all the servers.
+ *
+ * This function has to be called from the LwM2MCore thread.
+ */
+//--------------------------------------------------------------------------------------------------
+void lwm2mcore_ResetCoapMetrics
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Function to set the period of the @ref LWM2MCORE_EVENT_COAP_METRICS event.
+ *
+ * The period is checked on each LwM2MCore step, which runs at least every 60 seconds during a
+ * session, or at each wake-up in queue mode: the event can therefore be delayed up to the next
+ * step.
+ */
+//--------------------------------------------------------------------------------------------------
+void lwm2mcore_SetCoapMetricsPeriod
+(
+    uint32_t periodSec                  ///< [IN] Event period in seconds, 0 to disable the event
+);
+
+/**
+  * @}
+  */
+
+#endif /* __LWM2MCORE_STATISTICS_H__ */
@@ -31,8 +31,9 @@
 //--------------------------------------------------------------------------------------------------
 typedef enum
 {
-    LWM2MCORE_TIMER_STEP,      ///< Timer step
-    LWM2MCORE_TIMER_MAX        ///< Maximum timer value (internal use)
+    LWM2MCORE_TIMER_STEP,       ///< Timer step
+    LWM2MCORE_TIMER_CONN_STATS, ///< Timer of the connectivity statistics sampling
+    LWM2MCORE_TIMER_MAX         ///< Maximum timer value (internal use)
 }lwm2mcore_TimerType_t;
 
 //--------------------------------------------------------------------------------------------------
@@ -89,6 +90,19 @@ bool lwm2mcore_TimerIsRunning
     lwm2mcore_TimerType_t timer    ///< [IN] Timer Id
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Adaptation function to get a monotonic time, used to measure durations
+ *
+ * @return
+ *      - monotonic time in microseconds
+ */
+//--------------------------------------------------------------------------------------------------
+uint64_t lwm2mcore_GetTimeUs
+(
+    void
+);
+
 /**
   * @}
   */
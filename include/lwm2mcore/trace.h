@@ -0,0 +1,191 @@
+/**
+ * @file trace.h
+ *
+ * LwM2MCore binary trace: fixed-size records stored in a ring buffer, to be decoded offline
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#ifndef __LWM2MCORE_TRACE_H__
+#define __LWM2MCORE_TRACE_H__
+
+#include <lwm2mcore/lwm2mcore.h>
+
+/**
+  * @addtogroup lwm2mcore_trace_IFS
+  * @{
+  */
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Magic number of a trace file ("LWTR")
+ */
+//--------------------------------------------------------------------------------------------------
+#define LWM2MCORE_TRACE_FILE_MAGIC      0x5254574C
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Version of the trace file format
+ */
+//--------------------------------------------------------------------------------------------------
+#define LWM2MCORE_TRACE_FILE_VERSION    1
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Number of argument words of a trace record
+ */
+//--------------------------------------------------------------------------------------------------
+#define LWM2MCORE_TRACE_ARG_NB          4
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief First event Id available for the platform traces
+ */
+//--------------------------------------------------------------------------------------------------
+#define LWM2MCORE_TRACE_PLATFORM_BASE   0x8000
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Trace flag of a packet: the packet contains DTLS records
+ */
+//--------------------------------------------------------------------------------------------------
+#define LWM2MCORE_TRACE_FLAG_DTLS       0x01
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Trace event Ids
+ *
+ * The arguments of each event are listed in the order of the record arguments.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    LWM2MCORE_TRACE_PAYLOAD = 0,        ///< Captured bytes of the previous packet event, stored in
+                                        ///< the arguments (len bytes)
+    LWM2MCORE_TRACE_DATAGRAM_SENT,      ///< UDP datagram sent: security instance Id, length,
+                                        ///< flags, captured length
+    LWM2MCORE_TRACE_DATAGRAM_RECEIVED,  ///< UDP datagram received: security instance Id, length,
+                                        ///< flags, captured length
+    LWM2MCORE_TRACE_COAP_SENT,          ///< Plain text CoAP message sent: security instance Id,
+                                        ///< length, flags, captured length
+    LWM2MCORE_TRACE_COAP_RECEIVED,      ///< Plain text CoAP message received: security instance
+                                        ///< Id, length, flags, captured length
+    LWM2MCORE_TRACE_READ,               ///< Resource read: object Id, object instance Id,
+                                        ///< resource Id (resource instance Id in the upper 16
+                                        ///< bits), lwm2mcore_Sid_t
+    LWM2MCORE_TRACE_WRITE,              ///< Resource write: object Id, object instance Id,
+                                        ///< resource Id, lwm2mcore_Sid_t
+    LWM2MCORE_TRACE_EXECUTE,            ///< Resource execute: object Id, object instance Id,
+                                        ///< resource Id, lwm2mcore_Sid_t
+    LWM2MCORE_TRACE_SESSION_EVENT,      ///< Session event: event type, event status
+    LWM2MCORE_TRACE_DTLS_EVENT,         ///< DTLS event or alert: code, level
+    LWM2MCORE_TRACE_STATUS_EVENT,       ///< Status event sent to the application: event
+    LWM2MCORE_TRACE_EVENT_MAX           ///< Internal usage
+}lwm2mcore_TraceEvent_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Trace record (32 bytes)
+ *
+ * A packet event is followed by LWM2MCORE_TRACE_PAYLOAD records with the captured bytes of the
+ * packet, with consecutive sequence numbers.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint64_t timeUs;                            ///< Time in microseconds (lwm2mcore_GetTimeUs)
+    uint32_t seq;                               ///< Sequence number
+    uint16_t event;                             ///< Event Id (lwm2mcore_TraceEvent_t or platform
+                                                ///< event from LWM2MCORE_TRACE_PLATFORM_BASE)
+    uint16_t len;                               ///< Number of payload bytes in the arguments, for
+                                                ///< the LWM2MCORE_TRACE_PAYLOAD event
+    uint32_t args[LWM2MCORE_TRACE_ARG_NB];      ///< Arguments or payload bytes
+}lwm2mcore_TraceRecord_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Header of a trace file, followed by the trace records in the host byte order
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t magic;                 ///< LWM2MCORE_TRACE_FILE_MAGIC
+    uint16_t version;               ///< LWM2MCORE_TRACE_FILE_VERSION
+    uint16_t recordSize;            ///< Size of a record: sizeof(lwm2mcore_TraceRecord_t)
+    uint32_t recordNb;              ///< Number of records
+    uint32_t lostNb;                ///< Number of records overwritten before being read
+}lwm2mcore_TraceFileHeader_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Function to enable the trace.
+ *
+ * The trace records are stored in a ring buffer: when it is full, the oldest records are
+ * overwritten. The records can be added by any thread without lock.
+ *
+ * @return
+ *      - @c true if the trace is enabled
+ *      - @c false if the trace is already enabled, if the record number is not a power of two or
+ *        in case of allocation failure
+ */
+//--------------------------------------------------------------------------------------------------
+bool lwm2mcore_TraceEnable
+(
+    uint32_t recordNb,              ///< [IN] Number of records of the ring buffer (power of two)
+    uint16_t captureLen             ///< [IN] Maximum number of bytes captured per packet,
+                                    ///<      0 to trace the packet lengths only
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Function to disable the trace and release the ring buffer.
+ *
+ * This function has to be called when no other thread can add a record.
+ */
+//--------------------------------------------------------------------------------------------------
+void lwm2mcore_TraceDisable
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Function to add a platform trace record
+ */
+//--------------------------------------------------------------------------------------------------
+void lwm2mcore_Trace
+(
+    uint16_t event,                 ///< [IN] Event Id, from LWM2MCORE_TRACE_PLATFORM_BASE
+    uint32_t arg0,                  ///< [IN] First argument
+    uint32_t arg1,                  ///< [IN] Second argument
+    uint32_t arg2,                  ///< [IN] Third argument
+    uint32_t arg3                   ///< [IN] Fourth argument
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Function to retrieve the trace records, in the order of their sequence numbers.
+ *
+ * The retrieval starts from the sequence number *seqPtr, or from the oldest record in the ring
+ * buffer if this record was overwritten. *seqPtr is updated with the sequence number following
+ * the last retrieved record, to be used for the next call. The records overwritten during the
+ * retrieval are skipped.
+ *
+ * @return
+ *      - Number of retrieved records
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t lwm2mcore_TraceGetRecords
+(
+    uint32_t* seqPtr,                   ///< [INOUT] Sequence number of the first record
+    lwm2mcore_TraceRecord_t* recordsPtr,///< [OUT] Records
+    uint32_t recordNb,                  ///< [IN] Maximum number of records
+    uint32_t* lostNbPtr                 ///< [OUT] Number of records lost since *seqPtr (optional)
+);
+
+/**
+  * @}
+  */
+
+#endif /* __LWM2MCORE_TRACE_H__ */
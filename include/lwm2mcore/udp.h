@@ -131,6 +131,27 @@ bool lwm2mcore_UdpConnect
     int* sockPtr                        ///< [IN] Socket file descriptor
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start the resolution of the server address
+ * This function is called by the LwM2MCore and must be adapted to the platform
+ * The aim of this function is to resolve the server address while the LwM2MCore objects are
+ * registered: the resolved address is used by the next lwm2mcore_UdpConnect call for the same
+ * host and port. The function must not wait for the resolution; a platform without asynchronous
+ * resolution can return false, the address being then resolved by lwm2mcore_UdpConnect.
+ *
+ * @return
+ *      - true if the resolution is started
+ *      - false on error
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+bool lwm2mcore_UdpResolve
+(
+    const char* hostPtr,                ///< [IN] Host
+    const char* portPtr                 ///< [IN] Port
+);
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Send data on a socket
@@ -149,10 +149,30 @@ typedef enum
     LWM2MCORE_SW_UPDATE_RESULT_UNINSTALL_FAILURE= 59    ///< Uninstallation Failure
 }lwm2mcore_SwUpdateResult_t;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Enumeration for the compression algorithm used in a compressed binary (DWL COMP section)
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    LWM2MCORE_COMP_TYPE_ZLIB     = 1,   ///< zlib (RFC 1950) stream
+    LWM2MCORE_COMP_TYPE_ZSTD     = 2,   ///< Zstandard (RFC 8478) frame
+    LWM2MCORE_COMP_TYPE_MAX             ///< Internal usage
+}lwm2mcore_CompressionType_t;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * The server pushes a package to the LWM2M client
  *
+ * This function is called with the first block of the package written by the server in the
+ * Package resource. The platform starts the package downloader for an asynchronous transfer:
+ * lwm2mcore_PackageDownloaderRun() is called with a download callback returning DWL_BUSY. The
+ * blocks, including this first one, are then given by LwM2MCore to the package downloader as they
+ * are received, and the transfer end is notified with lwm2mcore_PackageDownloaderEndTransfer().
+ *
+ * An empty package (null length) cancels the update: a push transfer in progress is aborted.
+ *
  * @return
  *      - LWM2MCORE_ERR_COMPLETED_OK if the treatment succeeds
  *      - LWM2MCORE_ERR_GENERAL_ERROR if the treatment fails
@@ -481,5 +501,68 @@ lwm2mcore_Sid_t lwm2mcore_SuspendPackageDownload
     void
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Package decompression
+ */
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize a streaming decompression
+ *
+ * @return
+ *      - LWM2MCORE_ERR_COMPLETED_OK if the treatment succeeds
+ *      - LWM2MCORE_ERR_GENERAL_ERROR if the treatment fails
+ *      - LWM2MCORE_ERR_OP_NOT_SUPPORTED if the compression type is not supported
+ *      - LWM2MCORE_ERR_INVALID_ARG if a parameter is invalid
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_Sid_t lwm2mcore_StartDecompression
+(
+    lwm2mcore_CompressionType_t type,   ///< [IN] Compression algorithm
+    void** decompCtxPtr                 ///< [INOUT] Decompression context pointer
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Decompress a part of a compressed stream
+ *
+ * The function consumes at most *inLenPtr bytes from inBufPtr and produces at most *outLenPtr
+ * bytes in outBufPtr. On return, *inLenPtr and *outLenPtr are respectively set to the number of
+ * consumed and produced bytes. If the output buffer is full, the function should be called again
+ * in order to flush the pending decompressed data.
+ *
+ * @return
+ *      - LWM2MCORE_ERR_COMPLETED_OK if the treatment succeeds
+ *      - LWM2MCORE_ERR_GENERAL_ERROR if the compressed stream is corrupted
+ *      - LWM2MCORE_ERR_INVALID_ARG if a parameter is invalid
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_Sid_t lwm2mcore_ProcessDecompression
+(
+    void*    decompCtxPtr,  ///< [IN] Decompression context pointer
+    uint8_t* inBufPtr,      ///< [IN] Compressed data
+    size_t*  inLenPtr,      ///< [INOUT] Compressed data length / consumed length
+    uint8_t* outBufPtr,     ///< [INOUT] Decompressed data buffer
+    size_t*  outLenPtr,     ///< [INOUT] Decompressed buffer length / produced length
+    bool*    isEndPtr       ///< [OUT] true if the end of the compressed stream is reached
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * End the streaming decompression and release the decompression context
+ *
+ * @return
+ *      - LWM2MCORE_ERR_COMPLETED_OK if the treatment succeeds
+ *      - LWM2MCORE_ERR_GENERAL_ERROR if the treatment fails
+ *      - LWM2MCORE_ERR_INVALID_ARG if a parameter is invalid
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_Sid_t lwm2mcore_EndDecompression
+(
+    void** decompCtxPtr     ///< [INOUT] Decompression context pointer
+);
+
 #endif /* __LWM2MCORE_UPDATE_H__ */
 
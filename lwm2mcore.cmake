@@ -35,15 +35,26 @@ include_directories(${LWM2MCORE_SOURCES_DIR}/examples/linux/
                     ${LWM2MCORE_SOURCES_DIR}/wakaama/core/er-coap-13/)
 
 set(LWM2MCORE_SOURCES
+    ${LWM2MCORE_SOURCES_DIR}/objectManager/coapRequests.c
+    ${LWM2MCORE_SOURCES_DIR}/objectManager/composite.c
+    ${LWM2MCORE_SOURCES_DIR}/objectManager/connStats.c
     ${LWM2MCORE_SOURCES_DIR}/objectManager/handlers.c
     ${LWM2MCORE_SOURCES_DIR}/objectManager/lwm2mcoreCoapHandlers.c
     ${LWM2MCORE_SOURCES_DIR}/objectManager/objects.c
     ${LWM2MCORE_SOURCES_DIR}/objectManager/objectsTable.c
+    ${LWM2MCORE_SOURCES_DIR}/objectManager/observe.c
+    ${LWM2MCORE_SOURCES_DIR}/objectManager/operationStats.c
+    ${LWM2MCORE_SOURCES_DIR}/objectManager/paramCache.c
+    ${LWM2MCORE_SOURCES_DIR}/objectManager/sendBuffer.c
+    ${LWM2MCORE_SOURCES_DIR}/objectManager/senml.c
     ${LWM2MCORE_SOURCES_DIR}/objectManager/utils.c
     ${LWM2MCORE_SOURCES_DIR}/packageDownloader/lwm2mcorePackageDownloader.c
     ${LWM2MCORE_SOURCES_DIR}/packageDownloader/workspace.c
+    ${LWM2MCORE_SOURCES_DIR}/sessionManager/coapMetrics.c
     ${LWM2MCORE_SOURCES_DIR}/sessionManager/dtlsConnection.c
-    ${LWM2MCORE_SOURCES_DIR}/sessionManager/lwm2mcoreSession.c)
+    ${LWM2MCORE_SOURCES_DIR}/sessionManager/lwm2mcoreSession.c
+    ${LWM2MCORE_SOURCES_DIR}/sessionManager/queueMode.c
+    ${LWM2MCORE_SOURCES_DIR}/sessionManager/traceBuffer.c)
 
 add_definitions(-g
                 -Wall
@@ -0,0 +1,2089 @@
+/**
+ * @file coapRequests.c
+ *
+ * LwM2M requests handled by LwM2MCore before Wakaama, see coapRequests.h
+ *
+ * Only the CoAP header, the token and the options used by these requests are parsed (RFC 7252
+ * section 3): Uri-Path, Uri-Query, Content-Format, Accept, Observe (RFC 7641), Block1 and Block2
+ * (RFC 7959). A message with another critical option is left to Wakaama.
+ *
+ * A response is piggybacked in the acknowledgement of a confirmable request, and sent in a new
+ * non-confirmable message otherwise. The message Ids of the last notifications are kept with their
+ * token: a reset of one of these notifications cancels its observation.
+ *
+ * The Send requests of the LwM2M 1.1 Send operation (a confirmable POST on /dp) are written here
+ * too: the request in flight is kept to be retransmitted, and its acknowledgement is matched by
+ * message Id and token.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <lwm2mcore/lwm2mcore.h>
+#include <lwm2mcore/timer.h>
+#include "liblwm2m.h"
+#include "internals.h"
+#include "objects.h"
+#include "observe.h"
+#include "composite.h"
+#include "senml.h"
+#include "coapRequests.h"
+#include "sendBuffer.h"
+#include "sessionManager.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * CoAP fixed header length and version
+ */
+//--------------------------------------------------------------------------------------------------
+#define HEADER_LEN                  4
+#define COAP_VERSION                1
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * CoAP message types
+ */
+//--------------------------------------------------------------------------------------------------
+#define MESSAGE_TYPE_CON            0
+#define MESSAGE_TYPE_NON            1
+#define MESSAGE_TYPE_ACK            2
+#define MESSAGE_TYPE_RST            3
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * CoAP request codes
+ */
+//--------------------------------------------------------------------------------------------------
+#define METHOD_GET                  0x01
+#define METHOD_POST                 0x02
+#define METHOD_PUT                  0x03
+#define METHOD_FETCH                0x05
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * CoAP option numbers
+ */
+//--------------------------------------------------------------------------------------------------
+#define OPTION_OBSERVE              6
+#define OPTION_URI_PATH             11
+#define OPTION_CONTENT_FORMAT       12
+#define OPTION_URI_QUERY            15
+#define OPTION_ACCEPT               17
+#define OPTION_BLOCK2               23
+#define OPTION_BLOCK1               27
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Options present in a message
+ */
+//--------------------------------------------------------------------------------------------------
+#define OPTION_FLAG_OBSERVE         0x01
+#define OPTION_FLAG_CONTENT_FORMAT  0x02
+#define OPTION_FLAG_ACCEPT          0x04
+#define OPTION_FLAG_BLOCK2          0x08
+#define OPTION_FLAG_BLOCK1          0x10
+#define OPTION_FLAG_URI_PATH        0x20
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Marker between the options and the payload
+ */
+//--------------------------------------------------------------------------------------------------
+#define PAYLOAD_MARKER              0xFF
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of Uri-Query options of a request, and maximum length of each of them
+ */
+//--------------------------------------------------------------------------------------------------
+#define QUERY_MAX_NB                8
+#define QUERY_MAX_LEN               32
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum length of the options of a response: Observe, Content-Format, Block2 and Block1, or of a
+ * Send request: Uri-Path and Content-Format
+ */
+//--------------------------------------------------------------------------------------------------
+#define OPTIONS_MAX_LEN             20
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Uri-Path of the Send requests
+ */
+//--------------------------------------------------------------------------------------------------
+#define SEND_URI_PATH               "dp"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Token length of the Send requests
+ */
+//--------------------------------------------------------------------------------------------------
+#define SEND_TOKEN_LEN              4
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum length of a response or a notification
+ */
+//--------------------------------------------------------------------------------------------------
+#define MESSAGE_MAX_LEN             (HEADER_LEN + COAP_REQUEST_TOKEN_MAX_LEN + OPTIONS_MAX_LEN \
+                                     + 1 + COAP_REQUEST_BLOCK_MAX_LEN)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum value of the Observe option: 24 bits
+ */
+//--------------------------------------------------------------------------------------------------
+#define OBSERVE_SEQ_MASK            0xFFFFFF
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of notifications kept to handle their reset
+ */
+//--------------------------------------------------------------------------------------------------
+#define NOTIFICATION_MAX_NB         8
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of responses kept to answer the retransmissions of confirmable requests, and time during
+ * which a message Id can be retransmitted (EXCHANGE_LIFETIME of RFC 7252) in seconds
+ */
+//--------------------------------------------------------------------------------------------------
+#define EXCHANGE_MAX_NB             8
+#define EXCHANGE_LIFETIME           247
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * URI flags of a resource path
+ */
+//--------------------------------------------------------------------------------------------------
+#define URI_FLAG_RESOURCE           (LWM2M_URI_FLAG_OBJECT_ID | LWM2M_URI_FLAG_INSTANCE_ID \
+                                     | LWM2M_URI_FLAG_RESOURCE_ID)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parsed CoAP message. The Uri-Query options and the payload point to the received buffer.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint8_t         type;                               ///< Message type
+    uint8_t         code;                               ///< Request or response code
+    uint16_t        mid;                                ///< Message Id
+    uint8_t         token[COAP_REQUEST_TOKEN_MAX_LEN];  ///< Token
+    uint8_t         tokenLen;                           ///< Token length
+    uint8_t         optionMask;                         ///< Options present: OPTION_FLAG_xxx
+    bool            isLwm2mUri;                         ///< The Uri-Path options are a LwM2M
+                                                        ///< path, or the root path
+    uint8_t         segmentNb;                          ///< Number of Uri-Path options
+    lwm2m_uri_t     uri;                                ///< LwM2M path
+    uint32_t        observe;                            ///< Observe option
+    uint16_t        format;                             ///< Content-Format option
+    uint16_t        accept;                             ///< Accept option
+    uint32_t        block2;                             ///< Block2 option
+    uint32_t        block1;                             ///< Block1 option
+    uint8_t         queryNb;                            ///< Number of Uri-Query options
+    const uint8_t*  queryPtr[QUERY_MAX_NB];             ///< Uri-Query options
+    size_t          queryLen[QUERY_MAX_NB];             ///< Uri-Query option lengths
+    const uint8_t*  payloadPtr;                         ///< Payload
+    size_t          payloadLen;                         ///< Payload length
+}Message_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Response or notification to send
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint8_t         code;                               ///< Response code
+    uint8_t         optionMask;                         ///< Options to send: OPTION_FLAG_xxx
+    uint32_t        observe;                            ///< Observe option
+    uint16_t        format;                             ///< Content-Format option
+    uint32_t        block2;                             ///< Block2 option
+    uint32_t        block1;                             ///< Block1 option
+    const char*     uriPathPtr;                         ///< Uri-Path option of a request
+    const uint8_t*  payloadPtr;                         ///< Payload
+    size_t          payloadLen;                         ///< Payload length
+}Response_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Message being written
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint8_t*        bufferPtr;                          ///< Message buffer, of MESSAGE_MAX_LEN
+    size_t          len;                                ///< Written length
+    uint16_t        lastOption;                         ///< Number of the last written option
+}Writer_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Notification sent to a server
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    void*           sessionPtr;                         ///< Session of the server
+    uint16_t        mid;                                ///< Message Id
+    uint8_t         token[COAP_REQUEST_TOKEN_MAX_LEN];  ///< Token of the observation
+    uint8_t         tokenLen;                           ///< Token length, 0 if the entry is not
+                                                        ///< used
+}Notification_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Response to a confirmable request, sent again if the request is retransmitted
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    void*           sessionPtr;                         ///< Session of the server, NULL if the
+                                                        ///< entry is not used
+    uint16_t        mid;                                ///< Message Id of the request and of the
+                                                        ///< acknowledgement
+    uint32_t        time;                               ///< Time of the request in seconds
+    uint8_t         buffer[MESSAGE_MAX_LEN];            ///< Acknowledgement
+    size_t          len;                                ///< Acknowledgement length
+}Exchange_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Block written by a Block1 request
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    void*           sessionPtr;                         ///< Session of the server, NULL if no
+                                                        ///< block is written
+    lwm2m_uri_t     uri;                                ///< Written resource
+    uint32_t        blockNum;                           ///< Block number
+    bool            isMore;                             ///< More flag of the block
+}StreamBlock_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send request in flight, kept to be retransmitted until it is acknowledged
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint16_t        mid;                                ///< Message Id
+    uint8_t         token[SEND_TOKEN_LEN];              ///< Token
+    uint8_t         buffer[MESSAGE_MAX_LEN];            ///< Request
+    size_t          len;                                ///< Request length, 0 if no request is
+                                                        ///< in flight
+}SendRequest_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Last responses to confirmable requests
+ */
+//--------------------------------------------------------------------------------------------------
+static Exchange_t ExchangeList[EXCHANGE_MAX_NB];
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Last block written by a Block1 request
+ */
+//--------------------------------------------------------------------------------------------------
+static StreamBlock_t LastStreamBlock;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send request in flight
+ */
+//--------------------------------------------------------------------------------------------------
+static SendRequest_t SendRequest;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Last notifications sent, to handle their reset
+ */
+//--------------------------------------------------------------------------------------------------
+static Notification_t NotificationList[NOTIFICATION_MAX_NB];
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Index of the next entry of NotificationList
+ */
+//--------------------------------------------------------------------------------------------------
+static uint8_t NotificationNext = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Last value of the Observe option
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t ObserveSeq = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *                      PRIVATE FUNCTIONS
+ */
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the value of an unsigned integer option
+ *
+ * @return
+ *      - Value
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t ParseUint
+(
+    const uint8_t* valuePtr,            ///< [IN] Option value
+    size_t len                          ///< [IN] Option length: 0 to 4 bytes
+)
+{
+    uint32_t value = 0;
+
+    while (len--)
+    {
+        value = (value << 8) | *valuePtr++;
+    }
+
+    return value;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the extended option delta or length which follows the first byte of an option
+ *
+ * @return
+ *      - true on success
+ *      - false if the field is truncated or reserved
+ */
+//--------------------------------------------------------------------------------------------------
+static bool ParseOptionField
+(
+    const uint8_t* bufferPtr,           ///< [IN] Message
+    size_t len,                         ///< [IN] Message length
+    size_t* posPtr,                     ///< [INOUT] Position in the message
+    uint32_t* valuePtr                  ///< [INOUT] Delta or length of the first byte, then
+                                        ///<         value of the field
+)
+{
+    switch (*valuePtr)
+    {
+        case 13:
+            if ((*posPtr + 1) > len)
+            {
+                return false;
+            }
+            *valuePtr = 13 + (uint32_t)bufferPtr[*posPtr];
+            *posPtr += 1;
+            break;
+
+        case 14:
+            if ((*posPtr + 2) > len)
+            {
+                return false;
+            }
+            *valuePtr = 269 + ParseUint(bufferPtr + *posPtr, 2);
+            *posPtr += 2;
+            break;
+
+        case 15:
+            return false;
+
+        default:
+            break;
+    }
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add an Uri-Path option to the LwM2M path of a message: a path of more than three segments or
+ * with a segment which is not an Id is not a LwM2M path
+ */
+//--------------------------------------------------------------------------------------------------
+static void AddUriSegment
+(
+    Message_t* messagePtr,              ///< [INOUT] Message
+    const uint8_t* valuePtr,            ///< [IN] Option value
+    size_t len                          ///< [IN] Option length
+)
+{
+    uint32_t id = 0;
+    size_t i;
+
+    if ((3 <= messagePtr->segmentNb) || (0 == len) || (5 < len))
+    {
+        messagePtr->isLwm2mUri = false;
+        return;
+    }
+
+    for (i = 0; i < len; i++)
+    {
+        if ((valuePtr[i] < '0') || (valuePtr[i] > '9'))
+        {
+            messagePtr->isLwm2mUri = false;
+            return;
+        }
+        id = (id * 10) + (uint32_t)(valuePtr[i] - '0');
+    }
+
+    if (LWM2M_MAX_ID <= id)
+    {
+        messagePtr->isLwm2mUri = false;
+        return;
+    }
+
+    switch (messagePtr->segmentNb)
+    {
+        case 0:
+            messagePtr->uri.objectId = (uint16_t)id;
+            messagePtr->uri.flag |= LWM2M_URI_FLAG_OBJECT_ID;
+            break;
+
+        case 1:
+            messagePtr->uri.instanceId = (uint16_t)id;
+            messagePtr->uri.flag |= LWM2M_URI_FLAG_INSTANCE_ID;
+            break;
+
+        default:
+            messagePtr->uri.resourceId = (uint16_t)id;
+            messagePtr->uri.flag |= LWM2M_URI_FLAG_RESOURCE_ID;
+            break;
+    }
+    messagePtr->segmentNb++;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parse an option of a message
+ *
+ * @return
+ *      - true on success
+ *      - false if the option is invalid or if it is an unknown critical option
+ */
+//--------------------------------------------------------------------------------------------------
+static bool ParseOption
+(
+    Message_t* messagePtr,              ///< [INOUT] Message
+    uint32_t number,                    ///< [IN] Option number
+    const uint8_t* valuePtr,            ///< [IN] Option value
+    size_t len                          ///< [IN] Option length
+)
+{
+    switch (number)
+    {
+        case OPTION_OBSERVE:
+            if (3 < len)
+            {
+                return false;
+            }
+            messagePtr->optionMask |= OPTION_FLAG_OBSERVE;
+            messagePtr->observe = ParseUint(valuePtr, len);
+            break;
+
+        case OPTION_URI_PATH:
+            AddUriSegment(messagePtr, valuePtr, len);
+            break;
+
+        case OPTION_CONTENT_FORMAT:
+        case OPTION_ACCEPT:
+            if (2 < len)
+            {
+                return false;
+            }
+            if (OPTION_ACCEPT == number)
+            {
+                messagePtr->optionMask |= OPTION_FLAG_ACCEPT;
+                messagePtr->accept = (uint16_t)ParseUint(valuePtr, len);
+            }
+            else
+            {
+                messagePtr->optionMask |= OPTION_FLAG_CONTENT_FORMAT;
+                messagePtr->format = (uint16_t)ParseUint(valuePtr, len);
+            }
+            break;
+
+        case OPTION_URI_QUERY:
+            if (QUERY_MAX_NB <= messagePtr->queryNb)
+            {
+                return false;
+            }
+            messagePtr->queryPtr[messagePtr->queryNb] = valuePtr;
+            messagePtr->queryLen[messagePtr->queryNb] = len;
+            messagePtr->queryNb++;
+            break;
+
+        case OPTION_BLOCK2:
+        case OPTION_BLOCK1:
+            if (3 < len)
+            {
+                return false;
+            }
+            if (OPTION_BLOCK2 == number)
+            {
+                messagePtr->optionMask |= OPTION_FLAG_BLOCK2;
+                messagePtr->block2 = ParseUint(valuePtr, len);
+            }
+            else
+            {
+                messagePtr->optionMask |= OPTION_FLAG_BLOCK1;
+                messagePtr->block1 = ParseUint(valuePtr, len);
+            }
+            break;
+
+        default:
+            /* The odd option numbers are critical */
+            if (number & 0x01)
+            {
+                return false;
+            }
+            break;
+    }
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parse a CoAP message
+ *
+ * @return
+ *      - true on success
+ *      - false if the message is invalid or carries an unknown critical option
+ */
+//--------------------------------------------------------------------------------------------------
+static bool ParseMessage
+(
+    const uint8_t* bufferPtr,           ///< [IN] Message
+    size_t len,                         ///< [IN] Message length
+    Message_t* messagePtr               ///< [OUT] Parsed message
+)
+{
+    uint32_t number = 0;
+    size_t pos = HEADER_LEN;
+
+    memset(messagePtr, 0, sizeof(Message_t));
+
+    if ((HEADER_LEN > len) || (COAP_VERSION != (bufferPtr[0] >> 6)))
+    {
+        return false;
+    }
+
+    messagePtr->type = (bufferPtr[0] >> 4) & 0x03;
+    messagePtr->tokenLen = bufferPtr[0] & 0x0F;
+    messagePtr->code = bufferPtr[1];
+    messagePtr->mid = (uint16_t)ParseUint(bufferPtr + 2, 2);
+    messagePtr->isLwm2mUri = true;
+
+    if (   (COAP_REQUEST_TOKEN_MAX_LEN < messagePtr->tokenLen)
+        || ((pos + messagePtr->tokenLen) > len))
+    {
+        return false;
+    }
+    memcpy(messagePtr->token, bufferPtr + pos, messagePtr->tokenLen);
+    pos += messagePtr->tokenLen;
+
+    while ((pos < len) && (PAYLOAD_MARKER != bufferPtr[pos]))
+    {
+        uint32_t delta = bufferPtr[pos] >> 4;
+        uint32_t optionLen = bufferPtr[pos] & 0x0F;
+
+        pos++;
+        if (   (!ParseOptionField(bufferPtr, len, &pos, &delta))
+            || (!ParseOptionField(bufferPtr, len, &pos, &optionLen))
+            || (optionLen > (len - pos)))
+        {
+            return false;
+        }
+
+        number += delta;
+        if (!ParseOption(messagePtr, number, bufferPtr + pos, optionLen))
+        {
+            return false;
+        }
+        pos += optionLen;
+    }
+
+    /* A payload marker is followed by a non-empty payload */
+    if (pos < len)
+    {
+        pos++;
+        if (pos == len)
+        {
+            return false;
+        }
+        messagePtr->payloadPtr = bufferPtr + pos;
+        messagePtr->payloadLen = len - pos;
+    }
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the next value of the Observe option
+ *
+ * @return
+ *      - Observe option
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t NextObserveSeq
+(
+    void
+)
+{
+    ObserveSeq = (ObserveSeq + 1) & OBSERVE_SEQ_MASK;
+    return ObserveSeq;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Decode a Block1 or Block2 option
+ *
+ * @return
+ *      - true on success
+ *      - false if the block size is reserved
+ */
+//--------------------------------------------------------------------------------------------------
+static bool DecodeBlock
+(
+    uint32_t value,                     ///< [IN] Option value
+    uint32_t* numPtr,                   ///< [OUT] Block number
+    bool* isMorePtr,                    ///< [OUT] More flag
+    uint16_t* sizePtr                   ///< [OUT] Block size
+)
+{
+    if (7 == (value & 0x07))
+    {
+        return false;
+    }
+
+    *numPtr = value >> 4;
+    *isMorePtr = (0 != (value & 0x08));
+    *sizePtr = (uint16_t)(16 << (value & 0x07));
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Encode a Block1 or Block2 option
+ *
+ * @return
+ *      - Option value
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t EncodeBlock
+(
+    uint32_t num,                       ///< [IN] Block number
+    bool isMore,                        ///< [IN] More flag
+    uint16_t size                       ///< [IN] Block size: 16 to 1024 bytes
+)
+{
+    uint32_t szx = 0;
+
+    while ((16u << szx) < size)
+    {
+        szx++;
+    }
+
+    return (num << 4) | (isMore ? 0x08 : 0) | szx;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the payload of a response. A payload longer than the requested block size, or than
+ * COAP_REQUEST_BLOCK_MAX_LEN without Block2 option in the request, is sent in blocks: the block
+ * requested by the Block2 option, the first block otherwise.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SetPayload
+(
+    Response_t* responsePtr,            ///< [INOUT] Response
+    const Message_t* requestPtr,        ///< [IN] Request, NULL for a notification
+    const uint8_t* payloadPtr,          ///< [IN] Payload
+    size_t len                          ///< [IN] Payload length
+)
+{
+    uint32_t blockNum = 0;
+    uint16_t blockSize = COAP_REQUEST_BLOCK_MAX_LEN;
+    bool isMore;
+    size_t offset;
+
+    if ((NULL != requestPtr) && (requestPtr->optionMask & OPTION_FLAG_BLOCK2))
+    {
+        if (!DecodeBlock(requestPtr->block2, &blockNum, &isMore, &blockSize))
+        {
+            responsePtr->code = COAP_400_BAD_REQUEST;
+            return;
+        }
+    }
+    else if (COAP_REQUEST_BLOCK_MAX_LEN >= len)
+    {
+        responsePtr->payloadPtr = payloadPtr;
+        responsePtr->payloadLen = len;
+        return;
+    }
+
+    offset = (size_t)blockNum * blockSize;
+    if ((0 != blockNum) && (offset >= len))
+    {
+        responsePtr->code = COAP_402_BAD_OPTION;
+        return;
+    }
+
+    isMore = ((len - offset) > blockSize);
+    responsePtr->optionMask |= OPTION_FLAG_BLOCK2;
+    responsePtr->block2 = EncodeBlock(blockNum, isMore, blockSize);
+    responsePtr->payloadPtr = payloadPtr + offset;
+    responsePtr->payloadLen = isMore ? blockSize : (len - offset);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write the header of an option of a message: its delta and its length, shorter than 13 bytes.
+ * The options are written by increasing number.
+ */
+//--------------------------------------------------------------------------------------------------
+static void WriteOptionHeader
+(
+    Writer_t* writerPtr,                ///< [INOUT] Message being written
+    uint16_t number,                    ///< [IN] Option number
+    uint8_t len                         ///< [IN] Option length
+)
+{
+    uint16_t delta = (uint16_t)(number - writerPtr->lastOption);
+    uint8_t* headerPtr = writerPtr->bufferPtr + writerPtr->len;
+
+    writerPtr->len++;
+    if (13 > delta)
+    {
+        *headerPtr = (uint8_t)(delta << 4);
+    }
+    else
+    {
+        *headerPtr = (uint8_t)(13 << 4);
+        writerPtr->bufferPtr[writerPtr->len++] = (uint8_t)(delta - 13);
+    }
+    *headerPtr |= len;
+    writerPtr->lastOption = number;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write an unsigned integer option of a message
+ */
+//--------------------------------------------------------------------------------------------------
+static void WriteOption
+(
+    Writer_t* writerPtr,                ///< [INOUT] Message being written
+    uint16_t number,                    ///< [IN] Option number
+    uint32_t value                      ///< [IN] Unsigned integer value
+)
+{
+    uint8_t len = 0;
+    int i;
+
+    /* Minimal length of the value: 0 is encoded as an empty value */
+    while ((4 > len) && (value >> (8 * len)))
+    {
+        len++;
+    }
+
+    WriteOptionHeader(writerPtr, number, len);
+    for (i = len - 1; i >= 0; i--)
+    {
+        writerPtr->bufferPtr[writerPtr->len++] = (uint8_t)(value >> (8 * i));
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a string option of a message, shorter than 13 bytes
+ */
+//--------------------------------------------------------------------------------------------------
+static void WriteStringOption
+(
+    Writer_t* writerPtr,                ///< [INOUT] Message being written
+    uint16_t number,                    ///< [IN] Option number
+    const char* valuePtr                ///< [IN] String value
+)
+{
+    uint8_t len = (uint8_t)strlen(valuePtr);
+
+    WriteOptionHeader(writerPtr, number, len);
+    memcpy(writerPtr->bufferPtr + writerPtr->len, valuePtr, len);
+    writerPtr->len += len;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send a response, a notification or a Send request to a server
+ *
+ * @return
+ *      - true if the message is sent
+ *      - false otherwise
+ */
+//--------------------------------------------------------------------------------------------------
+static bool SendMessage
+(
+    lwm2m_context_t* contextPtr,        ///< [IN] Wakaama context
+    void* sessionPtr,                   ///< [IN] Session of the server
+    uint8_t type,                       ///< [IN] Message type
+    uint16_t mid,                       ///< [IN] Message Id
+    const uint8_t* tokenPtr,            ///< [IN] Token
+    uint8_t tokenLen,                   ///< [IN] Token length
+    const Response_t* responsePtr,      ///< [IN] Response, or request
+    uint8_t* keptPtr,                   ///< [OUT] Buffer keeping the message, of MESSAGE_MAX_LEN,
+                                        ///<       NULL if the message is not kept
+    size_t* keptLenPtr                  ///< [OUT] Length of the kept message
+)
+{
+    uint8_t localBuffer[MESSAGE_MAX_LEN];
+    uint8_t* buffer = keptPtr ? keptPtr : localBuffer;
+    Writer_t writer;
+
+    writer.bufferPtr = buffer;
+    writer.lastOption = 0;
+    buffer[0] = (uint8_t)((COAP_VERSION << 6) | (type << 4) | tokenLen);
+    buffer[1] = responsePtr->code;
+    buffer[2] = (uint8_t)(mid >> 8);
+    buffer[3] = (uint8_t)mid;
+    memcpy(buffer + HEADER_LEN, tokenPtr, tokenLen);
+    writer.len = HEADER_LEN + tokenLen;
+
+    if (responsePtr->optionMask & OPTION_FLAG_OBSERVE)
+    {
+        WriteOption(&writer, OPTION_OBSERVE, responsePtr->observe);
+    }
+    if (responsePtr->optionMask & OPTION_FLAG_URI_PATH)
+    {
+        WriteStringOption(&writer, OPTION_URI_PATH, responsePtr->uriPathPtr);
+    }
+    if (responsePtr->optionMask & OPTION_FLAG_CONTENT_FORMAT)
+    {
+        WriteOption(&writer, OPTION_CONTENT_FORMAT, responsePtr->format);
+    }
+    if (responsePtr->optionMask & OPTION_FLAG_BLOCK2)
+    {
+        WriteOption(&writer, OPTION_BLOCK2, responsePtr->block2);
+    }
+    if (responsePtr->optionMask & OPTION_FLAG_BLOCK1)
+    {
+        WriteOption(&writer, OPTION_BLOCK1, responsePtr->block1);
+    }
+
+    if (responsePtr->payloadLen)
+    {
+        buffer[writer.len++] = PAYLOAD_MARKER;
+        memcpy(buffer + writer.len, responsePtr->payloadPtr, responsePtr->payloadLen);
+        writer.len += responsePtr->payloadLen;
+    }
+
+    if (keptLenPtr)
+    {
+        *keptLenPtr = writer.len;
+    }
+
+    return (COAP_NO_ERROR == lwm2m_buffer_send(sessionPtr,
+                                               buffer,
+                                               writer.len,
+                                               contextPtr->userData));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the current time
+ *
+ * @return
+ *      - Time in seconds
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t GetTime
+(
+    void
+)
+{
+    return (uint32_t)(lwm2mcore_GetTimeUs() / 1000000);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the exchange of a confirmable request received within EXCHANGE_LIFETIME
+ *
+ * @return
+ *      - Exchange
+ *      - NULL if the request is not a retransmission
+ */
+//--------------------------------------------------------------------------------------------------
+static Exchange_t* FindExchange
+(
+    void* sessionPtr,                   ///< [IN] Session of the server
+    uint16_t mid                        ///< [IN] Message Id of the request
+)
+{
+    uint32_t now = GetTime();
+    int i;
+
+    for (i = 0; i < EXCHANGE_MAX_NB; i++)
+    {
+        Exchange_t* exchangePtr = &ExchangeList[i];
+
+        if (   (NULL != exchangePtr->sessionPtr)
+            && (sessionPtr == exchangePtr->sessionPtr) && (mid == exchangePtr->mid)
+            && ((now - exchangePtr->time) < EXCHANGE_LIFETIME))
+        {
+            return exchangePtr;
+        }
+    }
+
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get an exchange to keep the acknowledgement of a confirmable request: an unused or expired
+ * entry, the oldest one otherwise
+ *
+ * @return
+ *      - Exchange
+ */
+//--------------------------------------------------------------------------------------------------
+static Exchange_t* NewExchange
+(
+    void* sessionPtr,                   ///< [IN] Session of the server
+    uint16_t mid                        ///< [IN] Message Id of the request
+)
+{
+    uint32_t now = GetTime();
+    Exchange_t* exchangePtr = &ExchangeList[0];
+    int i;
+
+    for (i = 0; i < EXCHANGE_MAX_NB; i++)
+    {
+        if (   (NULL == ExchangeList[i].sessionPtr)
+            || ((now - ExchangeList[i].time) >= EXCHANGE_LIFETIME))
+        {
+            exchangePtr = &ExchangeList[i];
+            break;
+        }
+        if ((now - ExchangeList[i].time) > (now - exchangePtr->time))
+        {
+            exchangePtr = &ExchangeList[i];
+        }
+    }
+
+    exchangePtr->sessionPtr = sessionPtr;
+    exchangePtr->mid = mid;
+    exchangePtr->time = now;
+    exchangePtr->len = 0;
+    return exchangePtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Find the device management server of a session
+ *
+ * @return
+ *      - Server
+ *      - NULL if the session is not the one of a device management server of the client
+ */
+//--------------------------------------------------------------------------------------------------
+static lwm2m_server_t* FindServer
+(
+    lwm2m_context_t* contextPtr,        ///< [IN] Wakaama context
+    void* sessionPtr                    ///< [IN] Session of the server
+)
+{
+    lwm2m_server_t* serverPtr;
+
+    for (serverPtr = contextPtr->serverList; NULL != serverPtr; serverPtr = serverPtr->next)
+    {
+        if (sessionPtr == serverPtr->sessionH)
+        {
+            return serverPtr;
+        }
+    }
+
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check that a session is the one of a device management server of the client, as Wakaama does
+ * before handling a request, and that the client has not deregistered from this server
+ *
+ * @return
+ *      - true if the server is registered
+ *      - false otherwise
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsRegisteredServer
+(
+    lwm2m_context_t* contextPtr,        ///< [IN] Wakaama context
+    void* sessionPtr                    ///< [IN] Session of the server
+)
+{
+    lwm2m_server_t* serverPtr = FindServer(contextPtr, sessionPtr);
+
+    return ((NULL != serverPtr) && (STATE_DEREGISTERED != serverPtr->status));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the short server Id of the device management server of a session: the observations and the
+ * notification attributes of a server are kept under this Id
+ *
+ * @return
+ *      - Short server Id
+ *      - 0 if the session is not the one of a device management server of the client
+ */
+//--------------------------------------------------------------------------------------------------
+static uint16_t GetShortServerId
+(
+    lwm2m_context_t* contextPtr,        ///< [IN] Wakaama context
+    void* sessionPtr                    ///< [IN] Session of the server
+)
+{
+    lwm2m_server_t* serverPtr = FindServer(contextPtr, sessionPtr);
+
+    return (NULL != serverPtr) ? serverPtr->shortID : 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send the response of a request: piggybacked in the acknowledgement of a confirmable request, in
+ * a new message otherwise. The acknowledgement is kept to answer a retransmission of the request.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Reply
+(
+    lwm2m_context_t* contextPtr,        ///< [IN] Wakaama context
+    void* sessionPtr,                   ///< [IN] Session of the server
+    const Message_t* requestPtr,        ///< [IN] Request
+    const Response_t* responsePtr       ///< [IN] Response
+)
+{
+    bool isSent;
+
+    /* The payload is not sent with an error code */
+    if (COAP_400_BAD_REQUEST <= responsePtr->code)
+    {
+        Response_t response;
+
+        memset(&response, 0, sizeof(response));
+        response.code = responsePtr->code;
+        responsePtr = &response;
+    }
+
+    if (MESSAGE_TYPE_CON == requestPtr->type)
+    {
+        Exchange_t* exchangePtr = NewExchange(sessionPtr, requestPtr->mid);
+
+        isSent = SendMessage(contextPtr, sessionPtr, MESSAGE_TYPE_ACK, requestPtr->mid,
+                             requestPtr->token, requestPtr->tokenLen, responsePtr,
+                             exchangePtr->buffer, &exchangePtr->len);
+    }
+    else
+    {
+        isSent = SendMessage(contextPtr, sessionPtr, MESSAGE_TYPE_NON, contextPtr->nextMID++,
+                             requestPtr->token, requestPtr->tokenLen, responsePtr, NULL, NULL);
+    }
+
+    if (!isSent)
+    {
+        LOG_ARG("Failed to send the response %d.%02d", responsePtr->code >> 5,
+                responsePtr->code & 0x1F);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send a response without payload
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReplyCode
+(
+    lwm2m_context_t* contextPtr,        ///< [IN] Wakaama context
+    void* sessionPtr,                   ///< [IN] Session of the server
+    const Message_t* requestPtr,        ///< [IN] Request
+    uint8_t code                        ///< [IN] Response code
+)
+{
+    Response_t response;
+
+    memset(&response, 0, sizeof(response));
+    response.code = code;
+    Reply(contextPtr, sessionPtr, requestPtr, &response);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read a path and serialize its value, see omanager_CoapSerialize
+ *
+ * @return
+ *      - COAP_205_CONTENT if the path is read: the buffer is released by the caller with
+ *        lwm2m_free
+ *      - COAP_406_NOT_ACCEPTABLE if the value can't be serialized in the content format
+ *      - other CoAP error codes if the path can't be read, see omanager_ReadUri
+ */
+//--------------------------------------------------------------------------------------------------
+static uint8_t ReadPayload
+(
+    const lwm2m_uri_t* uriPtr,          ///< [IN] Path
+    lwm2m_media_type_t* formatPtr,      ///< [INOUT] Requested content format, then content format
+                                        ///<         of the payload
+    uint8_t** bufferPtr,                ///< [OUT] Payload
+    size_t* lenPtr                      ///< [OUT] Payload length
+)
+{
+    lwm2m_uri_t uri = *uriPtr;
+    lwm2m_data_t* dataPtr = NULL;
+    lwm2m_data_t* listPtr;
+    int dataNb = 0;
+    int listNb;
+    int length;
+    uint8_t result;
+
+    *bufferPtr = NULL;
+    *lenPtr = 0;
+
+    result = omanager_ReadUri(uriPtr, &dataNb, &dataPtr);
+    if (COAP_205_CONTENT != result)
+    {
+        return result;
+    }
+
+    /* The data of an object instance or of a resource are the children of the instance */
+    listNb = dataNb;
+    listPtr = dataPtr;
+    if ((uri.flag & LWM2M_URI_FLAG_INSTANCE_ID) && (1 == dataNb))
+    {
+        listNb = (int)dataPtr->value.asChildren.count;
+        listPtr = dataPtr->value.asChildren.array;
+    }
+
+    length = omanager_CoapSerialize(&uri, listNb, listPtr, formatPtr, bufferPtr);
+    lwm2m_data_free(dataNb, dataPtr);
+    if (0 > length)
+    {
+        *bufferPtr = NULL;
+        return COAP_406_NOT_ACCEPTABLE;
+    }
+
+    *lenPtr = (size_t)length;
+    return COAP_205_CONTENT;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handle a GET request on a resource with a streamed read handler: the requested block, the first
+ * one without Block2 option, is read in the buffer of the response, see lwm2mcore_StreamRead
+ *
+ * @return
+ *      - true if the request is handled
+ *      - false if the resource is read through the object read callback
+ */
+//--------------------------------------------------------------------------------------------------
+static bool HandleStreamRead
+(
+    lwm2m_context_t* contextPtr,        ///< [IN] Wakaama context
+    void* sessionPtr,                   ///< [IN] Session of the server
+    const Message_t* requestPtr         ///< [IN] Request
+)
+{
+    uint8_t block[COAP_REQUEST_BLOCK_MAX_LEN];
+    uint16_t format = LWM2M_CONTENT_OPAQUE;
+    uint16_t blockSize = COAP_REQUEST_BLOCK_MAX_LEN;
+    uint32_t blockNum = 0;
+    Response_t response;
+    size_t len = 0;
+    bool isLast = true;
+    bool isMore;
+
+    if (URI_FLAG_RESOURCE != requestPtr->uri.flag)
+    {
+        return false;
+    }
+
+    /* The value is streamed as opaque or plain text data */
+    if (requestPtr->optionMask & OPTION_FLAG_ACCEPT)
+    {
+        if (   (LWM2M_CONTENT_OPAQUE != requestPtr->accept)
+            && (LWM2M_CONTENT_TEXT != requestPtr->accept))
+        {
+            return false;
+        }
+        format = requestPtr->accept;
+    }
+
+    memset(&response, 0, sizeof(response));
+    if (   (requestPtr->optionMask & OPTION_FLAG_BLOCK2)
+        && (!DecodeBlock(requestPtr->block2, &blockNum, &isMore, &blockSize)))
+    {
+        response.code = COAP_400_BAD_REQUEST;
+    }
+    else
+    {
+        response.code = lwm2mcore_StreamRead(&requestPtr->uri, blockNum, blockSize, block, &len,
+                                             &isLast);
+        if (COAP_501_NOT_IMPLEMENTED == response.code)
+        {
+            return false;
+        }
+    }
+
+    if (COAP_205_CONTENT == response.code)
+    {
+        response.optionMask |= OPTION_FLAG_CONTENT_FORMAT;
+        response.format = format;
+        if ((requestPtr->optionMask & OPTION_FLAG_BLOCK2) || (!isLast))
+        {
+            response.optionMask |= OPTION_FLAG_BLOCK2;
+            response.block2 = EncodeBlock(blockNum, !isLast, blockSize);
+        }
+        response.payloadPtr = block;
+        response.payloadLen = len;
+    }
+
+    Reply(contextPtr, sessionPtr, requestPtr, &response);
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handle a write request on a resource with a streamed write handler: each block, the whole value
+ * without Block1 option, is given to the handler from the buffer of the request, see
+ * lwm2mcore_StreamWrite. The last written block, sent again in a new request, is acknowledged
+ * again without being given to the handler.
+ *
+ * @return
+ *      - true if the request is handled
+ *      - false if the blocks are reassembled by Wakaama and written through the object write
+ *        callback
+ */
+//--------------------------------------------------------------------------------------------------
+static bool HandleStreamWrite
+(
+    lwm2m_context_t* contextPtr,        ///< [IN] Wakaama context
+    void* sessionPtr,                   ///< [IN] Session of the server
+    const Message_t* requestPtr         ///< [IN] Request
+)
+{
+    uint16_t blockSize = COAP_REQUEST_BLOCK_MAX_LEN;
+    uint32_t blockNum = 0;
+    Response_t response;
+    bool isMore = false;
+
+    if (URI_FLAG_RESOURCE != requestPtr->uri.flag)
+    {
+        return false;
+    }
+
+    /* The value is streamed as opaque or plain text data */
+    if (   (requestPtr->optionMask & OPTION_FLAG_CONTENT_FORMAT)
+        && (LWM2M_CONTENT_OPAQUE != requestPtr->format)
+        && (LWM2M_CONTENT_TEXT != requestPtr->format))
+    {
+        return false;
+    }
+
+    memset(&response, 0, sizeof(response));
+    if (   (requestPtr->optionMask & OPTION_FLAG_BLOCK1)
+        && (!DecodeBlock(requestPtr->block1, &blockNum, &isMore, &blockSize)))
+    {
+        response.code = COAP_400_BAD_REQUEST;
+    }
+    else if (   (requestPtr->optionMask & OPTION_FLAG_BLOCK1)
+             && (sessionPtr == LastStreamBlock.sessionPtr)
+             && (requestPtr->uri.objectId == LastStreamBlock.uri.objectId)
+             && (requestPtr->uri.instanceId == LastStreamBlock.uri.instanceId)
+             && (requestPtr->uri.resourceId == LastStreamBlock.uri.resourceId)
+             && (blockNum == LastStreamBlock.blockNum)
+             && ((0 != blockNum) || (LastStreamBlock.isMore)))
+    {
+        /* Block already written, received again in a new request: acknowledged again, except the
+         * first block of a new transfer
+         */
+        LOG_ARG("Block %d already written", blockNum);
+        response.code = LastStreamBlock.isMore ? COAP_231_CONTINUE : COAP_204_CHANGED;
+    }
+    else
+    {
+        response.code = lwm2mcore_StreamWrite(&requestPtr->uri, blockNum, blockSize, !isMore,
+                                              (uint8_t*)requestPtr->payloadPtr,
+                                              requestPtr->payloadLen);
+        if (COAP_501_NOT_IMPLEMENTED == response.code)
+        {
+            return false;
+        }
+
+        memset(&LastStreamBlock, 0, sizeof(LastStreamBlock));
+        if (   (requestPtr->optionMask & OPTION_FLAG_BLOCK1)
+            && ((COAP_231_CONTINUE == response.code) || (COAP_204_CHANGED == response.code)))
+        {
+            LastStreamBlock.sessionPtr = sessionPtr;
+            LastStreamBlock.uri = requestPtr->uri;
+            LastStreamBlock.blockNum = blockNum;
+            LastStreamBlock.isMore = isMore;
+        }
+    }
+
+    /* The written block is acknowledged by the Block1 option of the request */
+    if (   (requestPtr->optionMask & OPTION_FLAG_BLOCK1)
+        && ((COAP_231_CONTINUE == response.code) || (COAP_204_CHANGED == response.code)))
+    {
+        response.optionMask |= OPTION_FLAG_BLOCK1;
+        response.block1 = requestPtr->block1;
+    }
+
+    Reply(contextPtr, sessionPtr, requestPtr, &response);
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handle a GET request accepting a SenML content format, which Wakaama does not encode
+ *
+ * @return
+ *      - true if the request is handled
+ *      - false if the request is handled by Wakaama
+ */
+//--------------------------------------------------------------------------------------------------
+static bool HandleRead
+(
+    lwm2m_context_t* contextPtr,        ///< [IN] Wakaama context
+    void* sessionPtr,                   ///< [IN] Session of the server
+    const Message_t* requestPtr         ///< [IN] Request
+)
+{
+    lwm2m_media_type_t format = (lwm2m_media_type_t)requestPtr->accept;
+    Response_t response;
+    uint8_t* payloadPtr = NULL;
+    size_t payloadLen = 0;
+
+    if (   (!(requestPtr->optionMask & OPTION_FLAG_ACCEPT))
+        || (!(requestPtr->uri.flag & LWM2M_URI_FLAG_OBJECT_ID))
+        || (   (LWM2MCORE_CONTENT_SENML_JSON != requestPtr->accept)
+            && (LWM2MCORE_CONTENT_SENML_CBOR != requestPtr->accept)))
+    {
+        return false;
+    }
+
+    memset(&response, 0, sizeof(response));
+    response.code = ReadPayload(&requestPtr->uri, &format, &payloadPtr, &payloadLen);
+    if (COAP_205_CONTENT == response.code)
+    {
+        response.optionMask |= OPTION_FLAG_CONTENT_FORMAT;
+        response.format = (uint16_t)format;
+        SetPayload(&response, requestPtr, payloadPtr, payloadLen);
+    }
+
+    Reply(contextPtr, sessionPtr, requestPtr, &response);
+    lwm2m_free(payloadPtr);
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handle a GET request with the Observe option on a resource: the observation is registered, or
+ * cancelled, by the observation engine of LwM2MCore
+ *
+ * @return
+ *      - true if the request is handled
+ *      - false if the observation is handled by Wakaama
+ */
+//--------------------------------------------------------------------------------------------------
+static bool HandleObserve
+(
+    lwm2m_context_t* contextPtr,        ///< [IN] Wakaama context
+    void* sessionPtr,                   ///< [IN] Session of the server
+    const Message_t* requestPtr         ///< [IN] Request
+)
+{
+    lwm2m_media_type_t format = LWM2M_CONTENT_TEXT;
+    Response_t response;
+    uint8_t* payloadPtr = NULL;
+    size_t payloadLen = 0;
+
+    if (   (URI_FLAG_RESOURCE != requestPtr->uri.flag)
+        || ((0 != requestPtr->observe) && (1 != requestPtr->observe)))
+    {
+        return false;
+    }
+
+    /* A deregistration is answered as a read */
+    if (   (1 == requestPtr->observe)
+        && (!lwm2mcore_ObserveCancel(GetShortServerId(contextPtr, sessionPtr),
+                                     requestPtr->token,
+                                     requestPtr->tokenLen)))
+    {
+        return false;
+    }
+
+    if (requestPtr->optionMask & OPTION_FLAG_ACCEPT)
+    {
+        format = (lwm2m_media_type_t)requestPtr->accept;
+    }
+
+    memset(&response, 0, sizeof(response));
+    response.code = ReadPayload(&requestPtr->uri, &format, &payloadPtr, &payloadLen);
+
+    if ((COAP_205_CONTENT == response.code) && (0 == requestPtr->observe))
+    {
+        if (!lwm2mcore_ObserveResource(GetShortServerId(contextPtr, sessionPtr),
+                                       requestPtr->token,
+                                       requestPtr->tokenLen,
+                                       &requestPtr->uri,
+                                       (uint16_t)format))
+        {
+            lwm2m_free(payloadPtr);
+            return false;
+        }
+        response.optionMask |= OPTION_FLAG_OBSERVE;
+        response.observe = NextObserveSeq();
+    }
+
+    if (COAP_205_CONTENT == response.code)
+    {
+        response.optionMask |= OPTION_FLAG_CONTENT_FORMAT;
+        response.format = (uint16_t)format;
+        SetPayload(&response, requestPtr, payloadPtr, payloadLen);
+    }
+
+    Reply(contextPtr, sessionPtr, requestPtr, &response);
+    lwm2m_free(payloadPtr);
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handle a FETCH request on the root path: Read-Composite, or Observe-Composite with the Observe
+ * option. The response is encoded in the format of the Accept option, in the format of the request
+ * by default.
+ */
+//--------------------------------------------------------------------------------------------------
+static void HandleFetch
+(
+    lwm2m_context_t* contextPtr,        ///< [IN] Wakaama context
+    void* sessionPtr,                   ///< [IN] Session of the server
+    const Message_t* requestPtr         ///< [IN] Request
+)
+{
+    uint16_t format = requestPtr->format;
+    bool isObserve = false;
+    Response_t response;
+    uint8_t* payloadPtr = NULL;
+    size_t payloadLen = 0;
+
+    if (requestPtr->optionMask & OPTION_FLAG_ACCEPT)
+    {
+        format = requestPtr->accept;
+    }
+
+    /* The next blocks of a notification are requested without registering the observation */
+    if (   (requestPtr->optionMask & OPTION_FLAG_OBSERVE)
+        && (!((requestPtr->optionMask & OPTION_FLAG_BLOCK2) && (requestPtr->block2 >> 4))))
+    {
+        if (0 == requestPtr->observe)
+        {
+            isObserve = true;
+        }
+        else if (1 == requestPtr->observe)
+        {
+            lwm2mcore_CompositeCancel(GetShortServerId(contextPtr, sessionPtr),
+                                      requestPtr->token,
+                                      requestPtr->tokenLen);
+        }
+    }
+
+    memset(&response, 0, sizeof(response));
+    if (isObserve)
+    {
+        response.code = lwm2mcore_CompositeObserve(GetShortServerId(contextPtr, sessionPtr),
+                                                   requestPtr->token,
+                                                   requestPtr->tokenLen,
+                                                   requestPtr->format,
+                                                   requestPtr->payloadPtr,
+                                                   requestPtr->payloadLen,
+                                                   format,
+                                                   &payloadPtr,
+                                                   &payloadLen);
+    }
+    else
+    {
+        response.code = lwm2mcore_CompositeRead(requestPtr->format,
+                                                requestPtr->payloadPtr,
+                                                requestPtr->payloadLen,
+                                                format,
+                                                &payloadPtr,
+                                                &payloadLen);
+    }
+
+    if (COAP_205_CONTENT == response.code)
+    {
+        if (isObserve)
+        {
+            response.optionMask |= OPTION_FLAG_OBSERVE;
+            response.observe = NextObserveSeq();
+        }
+        response.optionMask |= OPTION_FLAG_CONTENT_FORMAT;
+        response.format = format;
+        SetPayload(&response, requestPtr, payloadPtr, payloadLen);
+    }
+
+    Reply(contextPtr, sessionPtr, requestPtr, &response);
+    lwm2m_free(payloadPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parse the notification attributes of the Uri-Query options of a Write-Attributes request. An
+ * attribute without value is cleared.
+ *
+ * @return
+ *      - COAP_NO_ERROR on success
+ *      - COAP_400_BAD_REQUEST if an attribute is unknown, repeated or has an invalid value
+ */
+//--------------------------------------------------------------------------------------------------
+static uint8_t ParseAttributes
+(
+    const Message_t* messagePtr,        ///< [IN] Request
+    lwm2m_attributes_t* attrPtr         ///< [OUT] Attributes to set and to clear
+)
+{
+    static const struct
+    {
+        const char* namePtr;
+        uint8_t flag;
+    }
+    attributeList[] =
+    {
+        { "pmin",   LWM2M_ATTR_FLAG_MIN_PERIOD },
+        { "pmax",   LWM2M_ATTR_FLAG_MAX_PERIOD },
+        { "gt",     LWM2M_ATTR_FLAG_GREATER_THAN },
+        { "lt",     LWM2M_ATTR_FLAG_LESS_THAN },
+        { "st",     LWM2M_ATTR_FLAG_STEP }
+    };
+    char query[QUERY_MAX_LEN + 1];
+    uint8_t i;
+
+    memset(attrPtr, 0, sizeof(lwm2m_attributes_t));
+
+    for (i = 0; i < messagePtr->queryNb; i++)
+    {
+        char* valuePtr;
+        char* endPtr = NULL;
+        uint8_t flag = 0;
+        size_t j;
+
+        if (QUERY_MAX_LEN < messagePtr->queryLen[i])
+        {
+            return COAP_400_BAD_REQUEST;
+        }
+        memcpy(query, messagePtr->queryPtr[i], messagePtr->queryLen[i]);
+        query[messagePtr->queryLen[i]] = '\0';
+
+        valuePtr = strchr(query, '=');
+        if (NULL != valuePtr)
+        {
+            *valuePtr++ = '\0';
+        }
+
+        for (j = 0; j < (sizeof(attributeList) / sizeof(attributeList[0])); j++)
+        {
+            if (0 == strcmp(query, attributeList[j].namePtr))
+            {
+                flag = attributeList[j].flag;
+            }
+        }
+
+        if ((0 == flag) || ((attrPtr->toSet | attrPtr->toClear) & flag))
+        {
+            return COAP_400_BAD_REQUEST;
+        }
+
+        if (NULL == valuePtr)
+        {
+            attrPtr->toClear |= flag;
+            continue;
+        }
+
+        switch (flag)
+        {
+            case LWM2M_ATTR_FLAG_MIN_PERIOD:
+            case LWM2M_ATTR_FLAG_MAX_PERIOD:
+            {
+                unsigned long period;
+
+                if ((valuePtr[0] < '0') || (valuePtr[0] > '9'))
+                {
+                    return COAP_400_BAD_REQUEST;
+                }
+                period = strtoul(valuePtr, &endPtr, 10);
+                if (LWM2M_ATTR_FLAG_MIN_PERIOD == flag)
+                {
+                    attrPtr->minPeriod = (uint32_t)period;
+                }
+                else
+                {
+                    attrPtr->maxPeriod = (uint32_t)period;
+                }
+            }
+            break;
+
+            case LWM2M_ATTR_FLAG_GREATER_THAN:
+                attrPtr->greaterThan = strtod(valuePtr, &endPtr);
+                break;
+
+            case LWM2M_ATTR_FLAG_LESS_THAN:
+                attrPtr->lessThan = strtod(valuePtr, &endPtr);
+                break;
+
+            default:
+                attrPtr->step = strtod(valuePtr, &endPtr);
+                if (0 > attrPtr->step)
+                {
+                    return COAP_400_BAD_REQUEST;
+                }
+                break;
+        }
+
+        if ((endPtr == valuePtr) || ('\0' != *endPtr))
+        {
+            return COAP_400_BAD_REQUEST;
+        }
+        attrPtr->toSet |= flag;
+    }
+
+    return COAP_NO_ERROR;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handle a Write-Attributes request: the attributes are written in the observation engine of
+ * LwM2MCore, then given to Wakaama for its own observations
+ *
+ * @return
+ *      - true if the request is rejected
+ *      - false if the attributes are written: Wakaama applies them and sends the response
+ */
+//--------------------------------------------------------------------------------------------------
+static bool HandleWriteAttributes
+(
+    lwm2m_context_t* contextPtr,        ///< [IN] Wakaama context
+    void* sessionPtr,                   ///< [IN] Session of the server
+    const Message_t* requestPtr         ///< [IN] Request
+)
+{
+    lwm2m_attributes_t attr;
+    uint8_t result;
+
+    result = ParseAttributes(requestPtr, &attr);
+    if (COAP_NO_ERROR == result)
+    {
+        result = lwm2mcore_WriteAttributes(GetShortServerId(contextPtr, sessionPtr),
+                                           &requestPtr->uri,
+                                           &attr);
+        if (COAP_204_CHANGED == result)
+        {
+            return false;
+        }
+    }
+
+    LOG_ARG("Write-Attributes rejected: %d.%02d", result >> 5, result & 0x1F);
+    ReplyCode(contextPtr, sessionPtr, requestPtr, result);
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handle the acknowledgement or the reset of the Send request in flight, matched by message Id and,
+ * for an acknowledgement, by token. An empty acknowledgement or a 2.xx response acknowledges the
+ * Send request, see omanager_SendAck.
+ *
+ * @return
+ *      - true if the message concerns the Send request in flight
+ *      - false otherwise
+ */
+//--------------------------------------------------------------------------------------------------
+static bool HandleSendAck
+(
+    const Message_t* messagePtr         ///< [IN] Acknowledgement or reset message
+)
+{
+    bool isAcknowledged = false;
+
+    if ((0 == SendRequest.len) || (messagePtr->mid != SendRequest.mid))
+    {
+        return false;
+    }
+
+    if (MESSAGE_TYPE_ACK == messagePtr->type)
+    {
+        if (   (0 != messagePtr->code)
+            && (   (SEND_TOKEN_LEN != messagePtr->tokenLen)
+                || (0 != memcmp(messagePtr->token, SendRequest.token, SEND_TOKEN_LEN))))
+        {
+            return false;
+        }
+        isAcknowledged = ((0 == messagePtr->code) || (2 == (messagePtr->code >> 5)));
+    }
+
+    LOG_ARG("Send request %d: %s %d.%02d", messagePtr->mid,
+            (MESSAGE_TYPE_ACK == messagePtr->type) ? "acknowledgement" : "reset",
+            messagePtr->code >> 5, messagePtr->code & 0x1F);
+    SendRequest.len = 0;
+    omanager_SendAck(messagePtr->mid, isAcknowledged);
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handle a reset message: the reset of a notification sent by this module cancels its observation.
+ * The message Ids are only unique per session: the reset must come from the session of the
+ * notification.
+ *
+ * @return
+ *      - true if the reset concerns a notification of this module
+ *      - false otherwise
+ */
+//--------------------------------------------------------------------------------------------------
+static bool HandleReset
+(
+    lwm2m_context_t* contextPtr,        ///< [IN] Wakaama context
+    void* sessionPtr,                   ///< [IN] Session of the server
+    const Message_t* messagePtr         ///< [IN] Reset message
+)
+{
+    uint16_t shortServerId;
+    int i;
+
+    for (i = 0; i < NOTIFICATION_MAX_NB; i++)
+    {
+        Notification_t* notificationPtr = &NotificationList[i];
+
+        if (   (0 != notificationPtr->tokenLen) && (sessionPtr == notificationPtr->sessionPtr)
+            && (messagePtr->mid == notificationPtr->mid))
+        {
+            LOG_ARG("Notification %d reset", messagePtr->mid);
+            shortServerId = GetShortServerId(contextPtr, sessionPtr);
+            if (!lwm2mcore_ObserveCancel(shortServerId,
+                                         notificationPtr->token,
+                                         notificationPtr->tokenLen))
+            {
+                lwm2mcore_CompositeCancel(shortServerId,
+                                          notificationPtr->token,
+                                          notificationPtr->tokenLen);
+            }
+            notificationPtr->tokenLen = 0;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *                      PUBLIC FUNCTIONS
+ */
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handle a CoAP message received from a server.
+ *
+ * This function is called by the session manager for each received CoAP message, before giving it
+ * to Wakaama. The following messages are handled by LwM2MCore:
+ *  - Read request on a resource with a streamed read handler, see lwm2mcore_StreamRead
+ *  - Write request on a resource with a streamed write handler, see lwm2mcore_StreamWrite
+ *  - Read request accepting a SenML content format, see lwm2mcore_SenmlSerialize
+ *  - Observe request on a single-instance resource, see lwm2mcore_ObserveResource
+ *  - Observe request with the Observe option set to 1 on an observation of LwM2MCore, see
+ *    lwm2mcore_ObserveCancel
+ *  - Write-Attributes request with invalid attributes, see lwm2mcore_WriteAttributes: the valid
+ *    attributes are also given to Wakaama, for its own observations
+ *  - FETCH request on the root path, see lwm2mcore_CompositeRead, lwm2mcore_CompositeObserve and
+ *    lwm2mcore_CompositeCancel
+ *  - Reset of a notification sent by this module
+ *  - Acknowledgement or reset of the Send request in flight, see omanager_CoapSend
+ *
+ * @return
+ *      - true if the message is handled by LwM2MCore
+ *      - false if the message is to be handled by Wakaama
+ */
+//--------------------------------------------------------------------------------------------------
+bool omanager_CoapHandleMessage
+(
+    lwm2m_context_t* contextPtr,        ///< [IN] Wakaama context
+    void* sessionPtr,                   ///< [IN] Session of the server
+    uint8_t* bufferPtr,                 ///< [IN] Received message
+    size_t len                          ///< [IN] Message length
+)
+{
+    Message_t message;
+    Exchange_t* exchangePtr;
+
+    if (   (NULL == contextPtr) || (NULL == bufferPtr) || (smanager_IsBootstrapConnection())
+        || (!IsRegisteredServer(contextPtr, sessionPtr))
+        || (!ParseMessage(bufferPtr, len, &message)))
+    {
+        return false;
+    }
+
+    if (   ((MESSAGE_TYPE_ACK == message.type) || (MESSAGE_TYPE_RST == message.type))
+        && (HandleSendAck(&message)))
+    {
+        return true;
+    }
+
+    if (MESSAGE_TYPE_RST == message.type)
+    {
+        return HandleReset(contextPtr, sessionPtr, &message);
+    }
+
+    /* The responses, the empty messages and the requests on other paths are left to Wakaama */
+    if (   (MESSAGE_TYPE_ACK == message.type) || (0 == message.code) || (0 != (message.code >> 5))
+        || (!message.isLwm2mUri))
+    {
+        return false;
+    }
+
+    /* Retransmission of a confirmable request answered by LwM2MCore: the acknowledgement is sent
+     * again, the request is not handled twice
+     */
+    if (MESSAGE_TYPE_CON == message.type)
+    {
+        exchangePtr = FindExchange(sessionPtr, message.mid);
+        if (exchangePtr)
+        {
+            LOG_ARG("Retransmission of request %d", message.mid);
+            if (COAP_NO_ERROR != lwm2m_buffer_send(sessionPtr,
+                                                   exchangePtr->buffer,
+                                                   exchangePtr->len,
+                                                   contextPtr->userData))
+            {
+                LOG("Failed to send the acknowledgement again");
+            }
+            return true;
+        }
+    }
+
+    switch (message.code)
+    {
+        case METHOD_GET:
+            if (message.optionMask & OPTION_FLAG_OBSERVE)
+            {
+                return HandleObserve(contextPtr, sessionPtr, &message);
+            }
+            return (   HandleStreamRead(contextPtr, sessionPtr, &message)
+                    || HandleRead(contextPtr, sessionPtr, &message));
+
+        case METHOD_FETCH:
+            /* Read-Composite and Observe-Composite */
+            if (0 == message.segmentNb)
+            {
+                HandleFetch(contextPtr, sessionPtr, &message);
+                return true;
+            }
+            break;
+
+        case METHOD_PUT:
+            /* Write-Attributes: no payload, the attributes are in the query */
+            if ((0 != message.uri.flag) && (0 == message.payloadLen) && (0 != message.queryNb))
+            {
+                return HandleWriteAttributes(contextPtr, sessionPtr, &message);
+            }
+            return HandleStreamWrite(contextPtr, sessionPtr, &message);
+
+        case METHOD_POST:
+            return HandleStreamWrite(contextPtr, sessionPtr, &message);
+
+        default:
+            break;
+    }
+
+    return false;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send a notification of an observation handled by LwM2MCore.
+ *
+ * The notification is a non-confirmable 2.05 Content response carrying the token of the
+ * observation and the next value of the Observe option.
+ *
+ * @return
+ *      - true if the notification is sent
+ *      - false otherwise
+ */
+//--------------------------------------------------------------------------------------------------
+bool omanager_CoapNotify
+(
+    lwm2m_context_t* contextPtr,        ///< [IN] Wakaama context
+    void* sessionPtr,                   ///< [IN] Session of the server
+    const uint8_t* tokenPtr,            ///< [IN] Token of the observation
+    uint8_t tokenLen,                   ///< [IN] Token length
+    uint16_t format,                    ///< [IN] Content format of the payload
+    const uint8_t* payloadPtr,          ///< [IN] Payload
+    size_t payloadLen                   ///< [IN] Payload length
+)
+{
+    Notification_t* notificationPtr;
+    Response_t response;
+    uint16_t mid;
+
+    if (   (NULL == contextPtr) || (NULL == sessionPtr) || (NULL == tokenPtr) || (0 == tokenLen)
+        || (COAP_REQUEST_TOKEN_MAX_LEN < tokenLen))
+    {
+        return false;
+    }
+
+    memset(&response, 0, sizeof(response));
+    response.code = COAP_205_CONTENT;
+    response.optionMask = OPTION_FLAG_OBSERVE | OPTION_FLAG_CONTENT_FORMAT;
+    response.observe = NextObserveSeq();
+    response.format = format;
+
+    /* A long payload is notified with its first block: the server requests the next ones */
+    SetPayload(&response, NULL, payloadPtr, payloadLen);
+
+    mid = contextPtr->nextMID++;
+    if (!SendMessage(contextPtr, sessionPtr, MESSAGE_TYPE_NON, mid, tokenPtr, tokenLen, &response,
+                     NULL, NULL))
+    {
+        return false;
+    }
+
+    /* Kept to cancel the observation if the server resets the notification */
+    notificationPtr = &NotificationList[NotificationNext];
+    NotificationNext = (uint8_t)((NotificationNext + 1) % NOTIFICATION_MAX_NB);
+    notificationPtr->sessionPtr = sessionPtr;
+    notificationPtr->mid = mid;
+    memcpy(notificationPtr->token, tokenPtr, tokenLen);
+    notificationPtr->tokenLen = tokenLen;
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send a request of the LwM2M 1.1 Send operation.
+ *
+ * The request is a confirmable POST on /dp with a new message Id and a new token. It is kept until
+ * its acknowledgement, matched by omanager_CoapHandleMessage and reported to omanager_SendAck, to
+ * be retransmitted by omanager_CoapSendAgain. A previous request in flight is dropped.
+ *
+ * @return
+ *      - true if the request is sent
+ *      - false otherwise
+ */
+//--------------------------------------------------------------------------------------------------
+bool omanager_CoapSend
+(
+    lwm2m_context_t* contextPtr,        ///< [IN] Wakaama context
+    void* sessionPtr,                   ///< [IN] Session of the server
+    uint16_t format,                    ///< [IN] Content format of the payload
+    const uint8_t* payloadPtr,          ///< [IN] Payload
+    size_t payloadLen,                  ///< [IN] Payload length
+    uint16_t* midPtr                    ///< [OUT] Message Id of the request
+)
+{
+    Response_t request;
+    uint32_t token;
+
+    SendRequest.len = 0;
+
+    if (   (NULL == contextPtr) || (NULL == sessionPtr) || (NULL == payloadPtr)
+        || (0 == payloadLen) || (COAP_REQUEST_BLOCK_MAX_LEN < payloadLen) || (NULL == midPtr))
+    {
+        return false;
+    }
+
+    memset(&request, 0, sizeof(request));
+    request.code = METHOD_POST;
+    request.optionMask = OPTION_FLAG_URI_PATH | OPTION_FLAG_CONTENT_FORMAT;
+    request.uriPathPtr = SEND_URI_PATH;
+    request.format = format;
+    request.payloadPtr = payloadPtr;
+    request.payloadLen = payloadLen;
+
+    /* The token only has to differ from the tokens of the other requests in flight */
+    SendRequest.mid = contextPtr->nextMID++;
+    token = (uint32_t)lwm2mcore_GetTimeUs() ^ ((uint32_t)SendRequest.mid << 16);
+    SendRequest.token[0] = (uint8_t)(token >> 24);
+    SendRequest.token[1] = (uint8_t)(token >> 16);
+    SendRequest.token[2] = (uint8_t)(token >> 8);
+    SendRequest.token[3] = (uint8_t)token;
+
+    if (!SendMessage(contextPtr, sessionPtr, MESSAGE_TYPE_CON, SendRequest.mid, SendRequest.token,
+                     SEND_TOKEN_LEN, &request, SendRequest.buffer, &SendRequest.len))
+    {
+        SendRequest.len = 0;
+        return false;
+    }
+
+    *midPtr = SendRequest.mid;
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Retransmit the Send request in flight, with the same message Id and token.
+ *
+ * @return
+ *      - true if the request is sent again
+ *      - false if no request is in flight or if it cannot be sent
+ */
+//--------------------------------------------------------------------------------------------------
+bool omanager_CoapSendAgain
+(
+    lwm2m_context_t* contextPtr,        ///< [IN] Wakaama context
+    void* sessionPtr                    ///< [IN] Session of the server
+)
+{
+    if ((NULL == contextPtr) || (NULL == sessionPtr) || (0 == SendRequest.len))
+    {
+        return false;
+    }
+
+    LOG_ARG("Retransmission of Send request %d", SendRequest.mid);
+    return (COAP_NO_ERROR == lwm2m_buffer_send(sessionPtr,
+                                               SendRequest.buffer,
+                                               SendRequest.len,
+                                               contextPtr->userData));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Serialize the data of a response or of a notification in the requested content format.
+ *
+ * The SenML content formats are encoded by lwm2mcore_SenmlSerialize, the other formats by Wakaama
+ * which may choose another format. The buffer is released by the caller with lwm2m_free.
+ *
+ * @return
+ *      - Length of the serialized data
+ *      - -1 on failure
+ */
+//--------------------------------------------------------------------------------------------------
+int omanager_CoapSerialize
+(
+    lwm2m_uri_t* uriPtr,                ///< [IN] Requested URI
+    int dataNb,                         ///< [IN] Number of data
+    lwm2m_data_t* dataPtr,              ///< [IN] Data read on the URI
+    lwm2m_media_type_t* formatPtr,      ///< [INOUT] Requested content format, then content format
+                                        ///<         of the serialized data
+    uint8_t** bufferPtr                 ///< [OUT] Serialized data
+)
+{
+    if (   (LWM2MCORE_CONTENT_SENML_JSON == *formatPtr)
+        || (LWM2MCORE_CONTENT_SENML_CBOR == *formatPtr))
+    {
+        return lwm2mcore_SenmlSerialize(uriPtr, dataNb, dataPtr, (uint16_t)*formatPtr, bufferPtr);
+    }
+
+    return lwm2m_data_serialize(uriPtr, dataNb, dataPtr, formatPtr, bufferPtr);
+}
@@ -0,0 +1,160 @@
+/**
+ * @file coapRequests.h
+ *
+ * LwM2M requests handled by LwM2MCore before Wakaama
+ *
+ * The CoAP messages received from a server are first given to this module: the requests served by
+ * the LwM2MCore engines are answered here, the other messages are handled by Wakaama. The
+ * notifications of these engines are sent by this module too, with the Observe option, and the
+ * requests of the LwM2M 1.1 Send operation.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#ifndef __COAPREQUESTS_H__
+#define __COAPREQUESTS_H__
+
+#include <lwm2mcore/lwm2mcore.h>
+#include "liblwm2m.h"
+
+/**
+  * @addtogroup lwm2mcore_coaprequests_int
+  * @{
+  */
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Maximum length of a CoAP token
+ */
+//--------------------------------------------------------------------------------------------------
+#define COAP_REQUEST_TOKEN_MAX_LEN      8
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Maximum payload length of a response or a notification: a longer payload is sent in
+ * blocks (RFC 7959)
+ */
+//--------------------------------------------------------------------------------------------------
+#define COAP_REQUEST_BLOCK_MAX_LEN      1024
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Handle a CoAP message received from a server.
+ *
+ * This function is called by the session manager for each received CoAP message, before giving it
+ * to Wakaama. The following messages are handled by LwM2MCore:
+ *  - Read request on a resource with a streamed read handler, see lwm2mcore_StreamRead
+ *  - Write request on a resource with a streamed write handler, see lwm2mcore_StreamWrite
+ *  - Read request accepting a SenML content format, see lwm2mcore_SenmlSerialize
+ *  - Observe request on a single-instance resource, see lwm2mcore_ObserveResource
+ *  - Observe request with the Observe option set to 1 on an observation of LwM2MCore, see
+ *    lwm2mcore_ObserveCancel
+ *  - Write-Attributes request with invalid attributes, see lwm2mcore_WriteAttributes: the valid
+ *    attributes are also given to Wakaama, for its own observations
+ *  - FETCH request on the root path, see lwm2mcore_CompositeRead, lwm2mcore_CompositeObserve and
+ *    lwm2mcore_CompositeCancel
+ *  - Reset of a notification sent by this module
+ *  - Acknowledgement or reset of the Send request in flight, see omanager_CoapSend
+ *
+ * @return
+ *      - true if the message is handled by LwM2MCore
+ *      - false if the message is to be handled by Wakaama
+ */
+//--------------------------------------------------------------------------------------------------
+bool omanager_CoapHandleMessage
+(
+    lwm2m_context_t* contextPtr,        ///< [IN] Wakaama context
+    void* sessionPtr,                   ///< [IN] Session of the server
+    uint8_t* bufferPtr,                 ///< [IN] Received message
+    size_t len                          ///< [IN] Message length
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Send a notification of an observation handled by LwM2MCore.
+ *
+ * The notification is a non-confirmable 2.05 Content response carrying the token of the
+ * observation and the next value of the Observe option.
+ *
+ * @return
+ *      - true if the notification is sent
+ *      - false otherwise
+ */
+//--------------------------------------------------------------------------------------------------
+bool omanager_CoapNotify
+(
+    lwm2m_context_t* contextPtr,        ///< [IN] Wakaama context
+    void* sessionPtr,                   ///< [IN] Session of the server
+    const uint8_t* tokenPtr,            ///< [IN] Token of the observation
+    uint8_t tokenLen,                   ///< [IN] Token length
+    uint16_t format,                    ///< [IN] Content format of the payload
+    const uint8_t* payloadPtr,          ///< [IN] Payload
+    size_t payloadLen                   ///< [IN] Payload length
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Send a request of the LwM2M 1.1 Send operation.
+ *
+ * The request is a confirmable POST on /dp with a new message Id and a new token. It is kept until
+ * its acknowledgement, matched by omanager_CoapHandleMessage and reported to omanager_SendAck, to
+ * be retransmitted by omanager_CoapSendAgain. A previous request in flight is dropped.
+ *
+ * @return
+ *      - true if the request is sent
+ *      - false otherwise
+ */
+//--------------------------------------------------------------------------------------------------
+bool omanager_CoapSend
+(
+    lwm2m_context_t* contextPtr,        ///< [IN] Wakaama context
+    void* sessionPtr,                   ///< [IN] Session of the server
+    uint16_t format,                    ///< [IN] Content format of the payload
+    const uint8_t* payloadPtr,          ///< [IN] Payload
+    size_t payloadLen,                  ///< [IN] Payload length, up to COAP_REQUEST_BLOCK_MAX_LEN
+    uint16_t* midPtr                    ///< [OUT] Message Id of the request
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Retransmit the Send request in flight, with the same message Id and token.
+ *
+ * @return
+ *      - true if the request is sent again
+ *      - false if no request is in flight or if it cannot be sent
+ */
+//--------------------------------------------------------------------------------------------------
+bool omanager_CoapSendAgain
+(
+    lwm2m_context_t* contextPtr,        ///< [IN] Wakaama context
+    void* sessionPtr                    ///< [IN] Session of the server
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Serialize the data of a response or of a notification in the requested content format.
+ *
+ * The SenML content formats are encoded by lwm2mcore_SenmlSerialize, the other formats by Wakaama
+ * which may choose another format. The buffer is released by the caller with lwm2m_free.
+ *
+ * @return
+ *      - Length of the serialized data
+ *      - -1 on failure
+ */
+//--------------------------------------------------------------------------------------------------
+int omanager_CoapSerialize
+(
+    lwm2m_uri_t* uriPtr,                ///< [IN] Requested URI
+    int dataNb,                         ///< [IN] Number of data
+    lwm2m_data_t* dataPtr,              ///< [IN] Data read on the URI
+    lwm2m_media_type_t* formatPtr,      ///< [INOUT] Requested content format, then content format
+                                        ///<         of the serialized data
+    uint8_t** bufferPtr                 ///< [OUT] Serialized data
+);
+
+/**
+  * @}
+  */
+
+#endif /* __COAPREQUESTS_H__ */
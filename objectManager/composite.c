@@ -0,0 +1,591 @@
+/**
+ * @file composite.c
+ *
+ * LwM2M 1.1 Read-Composite and Observe-Composite operations, see composite.h
+ *
+ * The paths are read through omanager_ReadUri, which returns the values of each path as an array
+ * of object instances: the records of all the paths are then written in a single pack with the
+ * object path as prefix, without base name.
+ *
+ * An observation keeps the parsed paths and a hash of the last payload sent to the server: the
+ * server is notified when the hash of the payload read again differs. An observation belongs to
+ * the server which sent the request, identified by its short server Id.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <lwm2mcore/lwm2mcore.h>
+#include "liblwm2m.h"
+#include "internals.h"
+#include "objects.h"
+#include "senml.h"
+#include "composite.h"
+#include "sessionManager.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * FNV-1a hash parameters
+ */
+//--------------------------------------------------------------------------------------------------
+#define FNV_OFFSET_BASIS        2166136261u
+#define FNV_PRIME               16777619u
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Composite observation
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    bool        isUsed;                             ///< The observation is registered
+    uint16_t    shortServerId;                      ///< Short server Id of the observing server
+    uint8_t     token[COMPOSITE_TOKEN_MAX_LEN];     ///< Token of the Observe-Composite request
+    uint8_t     tokenLen;                           ///< Token length
+    uint16_t    format;                             ///< Content format of the notifications
+    int         uriNb;                              ///< Number of observed paths
+    lwm2m_uri_t uriList[COMPOSITE_URI_MAX_NB];      ///< Observed paths
+    uint32_t    hash;                               ///< Hash of the last notified payload
+}Observation_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Composite observations
+ */
+//--------------------------------------------------------------------------------------------------
+static Observation_t ObservationList[COMPOSITE_OBSERVE_MAX_NB];
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *                      PRIVATE FUNCTIONS
+ */
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parse a path: /oid, /oid/oiid or /oid/oiid/rid
+ *
+ * @return
+ *      - true on success
+ *      - false if the path is not a valid object, object instance or resource path
+ */
+//--------------------------------------------------------------------------------------------------
+static bool ParsePath
+(
+    const char* pathPtr,                ///< [IN] Path
+    lwm2m_uri_t* uriPtr                 ///< [OUT] URI
+)
+{
+    static const uint8_t flags[] =
+    {
+        LWM2M_URI_FLAG_OBJECT_ID,
+        LWM2M_URI_FLAG_INSTANCE_ID,
+        LWM2M_URI_FLAG_RESOURCE_ID
+    };
+    uint16_t* idPtrs[3];
+    int segmentNb = 0;
+
+    memset(uriPtr, 0, sizeof(lwm2m_uri_t));
+    idPtrs[0] = &uriPtr->objectId;
+    idPtrs[1] = &uriPtr->instanceId;
+    idPtrs[2] = &uriPtr->resourceId;
+
+    while ('\0' != *pathPtr)
+    {
+        uint32_t id = 0;
+        int digitNb = 0;
+
+        if (('/' != *pathPtr) || (3 == segmentNb))
+        {
+            return false;
+        }
+        pathPtr++;
+
+        while (('0' <= *pathPtr) && ('9' >= *pathPtr))
+        {
+            id = (id * 10) + (uint32_t)(*pathPtr - '0');
+            digitNb++;
+            pathPtr++;
+            // The Id 65535 is reserved
+            if ((5 < digitNb) || (LWM2M_MAX_ID <= id))
+            {
+                return false;
+            }
+        }
+
+        if (0 == digitNb)
+        {
+            return false;
+        }
+
+        *idPtrs[segmentNb] = (uint16_t)id;
+        uriPtr->flag |= flags[segmentNb];
+        segmentNb++;
+    }
+
+    return (0 != segmentNb);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parse the SenML pack of the paths of a composite request
+ *
+ * @return
+ *      - COAP_NO_ERROR on success
+ *      - COAP_400_BAD_REQUEST if the pack or a path is invalid
+ *      - COAP_415_UNSUPPORTED_CONTENT_FORMAT if the content format is not a SenML format
+ */
+//--------------------------------------------------------------------------------------------------
+static uint8_t ParseRequest
+(
+    uint16_t format,                    ///< [IN] Content format of the request payload
+    const uint8_t* requestPtr,          ///< [IN] Request payload
+    size_t requestLen,                  ///< [IN] Request payload length
+    lwm2m_uri_t* uriListPtr,            ///< [OUT] Paths, of COMPOSITE_URI_MAX_NB elements
+    int* uriNbPtr                       ///< [OUT] Number of paths
+)
+{
+    char names[COMPOSITE_URI_MAX_NB][SENML_NAME_MAX_LEN];
+    int nameNb;
+    int i;
+
+    if ((LWM2MCORE_CONTENT_SENML_JSON != format) && (LWM2MCORE_CONTENT_SENML_CBOR != format))
+    {
+        return COAP_415_UNSUPPORTED_CONTENT_FORMAT;
+    }
+
+    nameNb = omanager_SenmlDecodeNames(format, requestPtr, requestLen, names,
+                                       COMPOSITE_URI_MAX_NB);
+    if (0 >= nameNb)
+    {
+        LOG_ARG("Invalid composite request, %d paths", nameNb);
+        return COAP_400_BAD_REQUEST;
+    }
+
+    for (i = 0; i < nameNb; i++)
+    {
+        if (!ParsePath(names[i], &uriListPtr[i]))
+        {
+            LOG_ARG("Invalid composite path %s", names[i]);
+            return COAP_400_BAD_REQUEST;
+        }
+    }
+
+    *uriNbPtr = nameNb;
+    return COAP_NO_ERROR;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the paths of a composite request and encode their values in a SenML pack
+ *
+ * @return
+ *      - COAP_205_CONTENT on success
+ *      - COAP_404_NOT_FOUND if none of the paths is found
+ *      - COAP_415_UNSUPPORTED_CONTENT_FORMAT if the content format is not a SenML format
+ *      - COAP_500_INTERNAL_SERVER_ERROR if the values cannot be encoded
+ *      - other CoAP error codes if a read handler fails
+ */
+//--------------------------------------------------------------------------------------------------
+static uint8_t ReadPaths
+(
+    uint16_t format,                    ///< [IN] Content format of the response
+    const lwm2m_uri_t* uriListPtr,      ///< [IN] Paths
+    int uriNb,                          ///< [IN] Number of paths
+    uint8_t** bufferPtr,                ///< [OUT] Response payload
+    size_t* lenPtr                      ///< [OUT] Response payload length
+)
+{
+    lwm2m_data_t* dataList[COMPOSITE_URI_MAX_NB];
+    int dataNbList[COMPOSITE_URI_MAX_NB];
+    char prefix[SENML_NAME_MAX_LEN];
+    omanager_SenmlWriter_t writer;
+    uint8_t result = COAP_404_NOT_FOUND;
+    uint32_t recordNb = 0;
+    size_t length = 0;
+    int pass;
+    int i;
+
+    *bufferPtr = NULL;
+    *lenPtr = 0;
+
+    if ((LWM2MCORE_CONTENT_SENML_JSON != format) && (LWM2MCORE_CONTENT_SENML_CBOR != format))
+    {
+        return COAP_415_UNSUPPORTED_CONTENT_FORMAT;
+    }
+
+    memset(dataList, 0, sizeof(dataList));
+    memset(dataNbList, 0, sizeof(dataNbList));
+
+    for (i = 0; i < uriNb; i++)
+    {
+        uint8_t readResult = omanager_ReadUri(&uriListPtr[i], &dataNbList[i], &dataList[i]);
+
+        if (COAP_205_CONTENT == readResult)
+        {
+            recordNb += omanager_SenmlCountRecords(dataNbList[i], dataList[i]);
+            result = COAP_205_CONTENT;
+        }
+        else if (COAP_404_NOT_FOUND != readResult)
+        {
+            result = readResult;
+            break;
+        }
+    }
+
+    /* First pass: payload length, second pass: payload */
+    for (pass = 0; (pass < 2) && (COAP_205_CONTENT == result); pass++)
+    {
+        if (1 == pass)
+        {
+            *bufferPtr = (uint8_t*)OMANAGER_MALLOC(length);
+            if (NULL == *bufferPtr)
+            {
+                result = COAP_500_INTERNAL_SERVER_ERROR;
+                break;
+            }
+        }
+
+        if (!omanager_SenmlBegin(&writer, format, *bufferPtr, length, recordNb, NULL, 0))
+        {
+            result = COAP_500_INTERNAL_SERVER_ERROR;
+            break;
+        }
+
+        for (i = 0; (i < uriNb) && (COAP_205_CONTENT == result); i++)
+        {
+            snprintf(prefix, sizeof(prefix), "/%u/", uriListPtr[i].objectId);
+            if ((dataList[i])
+             && (!omanager_SenmlAddData(&writer, prefix, dataNbList[i], dataList[i])))
+            {
+                result = COAP_500_INTERNAL_SERVER_ERROR;
+            }
+        }
+
+        if (COAP_205_CONTENT == result)
+        {
+            size_t packLen = omanager_SenmlEnd(&writer);
+
+            if ((0 == packLen) || ((1 == pass) && (length != packLen)))
+            {
+                result = COAP_500_INTERNAL_SERVER_ERROR;
+            }
+            length = packLen;
+        }
+    }
+
+    for (i = 0; i < uriNb; i++)
+    {
+        if (dataList[i])
+        {
+            lwm2m_data_free(dataNbList[i], dataList[i]);
+        }
+    }
+
+    if (COAP_205_CONTENT != result)
+    {
+        lwm2m_free(*bufferPtr);
+        *bufferPtr = NULL;
+        return result;
+    }
+
+    *lenPtr = length;
+    return COAP_205_CONTENT;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compute the FNV-1a hash of a payload
+ *
+ * @return
+ *      - Hash
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t HashPayload
+(
+    const uint8_t* payloadPtr,          ///< [IN] Payload
+    size_t length                       ///< [IN] Payload length
+)
+{
+    uint32_t hash = FNV_OFFSET_BASIS;
+
+    while (length--)
+    {
+        hash ^= *payloadPtr++;
+        hash *= FNV_PRIME;
+    }
+
+    return hash;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Find the observation of a token, registered by a server
+ *
+ * @return
+ *      - Observation
+ *      - NULL if the token is not observed by this server
+ */
+//--------------------------------------------------------------------------------------------------
+static Observation_t* FindObservation
+(
+    uint16_t shortServerId,             ///< [IN] Short server Id
+    const uint8_t* tokenPtr,            ///< [IN] Token
+    uint8_t tokenLen                    ///< [IN] Token length
+)
+{
+    int i;
+
+    for (i = 0; i < COMPOSITE_OBSERVE_MAX_NB; i++)
+    {
+        if (   (ObservationList[i].isUsed)
+            && (shortServerId == ObservationList[i].shortServerId)
+            && (tokenLen == ObservationList[i].tokenLen)
+            && (0 == memcmp(tokenPtr, ObservationList[i].token, tokenLen)))
+        {
+            return &ObservationList[i];
+        }
+    }
+
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *                      PUBLIC FUNCTIONS
+ */
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read-Composite request.
+ *
+ * This function is called by omanager_CoapHandleMessage for a FETCH request on the root path. The
+ * buffer is allocated by this function and released by the caller with lwm2m_free. The paths which
+ * are not found are not part of the response.
+ *
+ * @return
+ *      - COAP_205_CONTENT if the paths are read
+ *      - COAP_400_BAD_REQUEST if the request payload is invalid
+ *      - COAP_404_NOT_FOUND if none of the paths is found
+ *      - COAP_415_UNSUPPORTED_CONTENT_FORMAT if a content format is not a SenML format
+ *      - other CoAP error codes if a read handler fails
+ */
+//--------------------------------------------------------------------------------------------------
+uint8_t lwm2mcore_CompositeRead
+(
+    uint16_t requestFormat,             ///< [IN] Content format of the request payload
+    const uint8_t* requestPtr,          ///< [IN] Request payload: SenML pack of the paths
+    size_t requestLen,                  ///< [IN] Request payload length
+    uint16_t responseFormat,            ///< [IN] Requested content format of the response
+    uint8_t** bufferPtr,                ///< [OUT] Response payload
+    size_t* lenPtr                      ///< [OUT] Response payload length
+)
+{
+    lwm2m_uri_t uriList[COMPOSITE_URI_MAX_NB];
+    int uriNb;
+    uint8_t result;
+
+    if ((NULL == requestPtr) || (NULL == bufferPtr) || (NULL == lenPtr))
+    {
+        return COAP_400_BAD_REQUEST;
+    }
+    *bufferPtr = NULL;
+    *lenPtr = 0;
+
+    result = ParseRequest(requestFormat, requestPtr, requestLen, uriList, &uriNb);
+    if (COAP_NO_ERROR != result)
+    {
+        return result;
+    }
+
+    result = ReadPaths(responseFormat, uriList, uriNb, bufferPtr, lenPtr);
+    LOG_ARG("Read-Composite of %d paths: result %d, length %d", uriNb, result, (int)*lenPtr);
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Observe-Composite request.
+ *
+ * This function is called by omanager_CoapHandleMessage for a FETCH request on the root path with
+ * the Observe option set to 0. The paths are read as for a Read-Composite request, and the
+ * observation is registered with the request token, replacing a previous observation of the server
+ * with the same token.
+ *
+ * @return
+ *      - see lwm2mcore_CompositeRead
+ *      - COAP_503_SERVICE_UNAVAILABLE if the maximum number of observations is reached
+ */
+//--------------------------------------------------------------------------------------------------
+uint8_t lwm2mcore_CompositeObserve
+(
+    uint16_t shortServerId,             ///< [IN] Short server Id of the requesting server
+    const uint8_t* tokenPtr,            ///< [IN] Request token
+    uint8_t tokenLen,                   ///< [IN] Request token length
+    uint16_t requestFormat,             ///< [IN] Content format of the request payload
+    const uint8_t* requestPtr,          ///< [IN] Request payload: SenML pack of the paths
+    size_t requestLen,                  ///< [IN] Request payload length
+    uint16_t responseFormat,            ///< [IN] Requested content format of the response
+    uint8_t** bufferPtr,                ///< [OUT] Response payload
+    size_t* lenPtr                      ///< [OUT] Response payload length
+)
+{
+    Observation_t* observationPtr;
+    lwm2m_uri_t uriList[COMPOSITE_URI_MAX_NB];
+    int uriNb;
+    uint8_t result;
+    int i;
+
+    if (   (NULL == tokenPtr) || (0 == tokenLen) || (COMPOSITE_TOKEN_MAX_LEN < tokenLen)
+        || (NULL == requestPtr) || (NULL == bufferPtr) || (NULL == lenPtr))
+    {
+        return COAP_400_BAD_REQUEST;
+    }
+    *bufferPtr = NULL;
+    *lenPtr = 0;
+
+    observationPtr = FindObservation(shortServerId, tokenPtr, tokenLen);
+    for (i = 0; (NULL == observationPtr) && (i < COMPOSITE_OBSERVE_MAX_NB); i++)
+    {
+        if (!ObservationList[i].isUsed)
+        {
+            observationPtr = &ObservationList[i];
+        }
+    }
+
+    if (NULL == observationPtr)
+    {
+        LOG("Too many composite observations");
+        return COAP_503_SERVICE_UNAVAILABLE;
+    }
+
+    result = ParseRequest(requestFormat, requestPtr, requestLen, uriList, &uriNb);
+    if (COAP_NO_ERROR != result)
+    {
+        return result;
+    }
+
+    result = ReadPaths(responseFormat, uriList, uriNb, bufferPtr, lenPtr);
+    if (COAP_205_CONTENT != result)
+    {
+        return result;
+    }
+
+    memset(observationPtr, 0, sizeof(Observation_t));
+    observationPtr->isUsed = true;
+    observationPtr->shortServerId = shortServerId;
+    memcpy(observationPtr->token, tokenPtr, tokenLen);
+    observationPtr->tokenLen = tokenLen;
+    observationPtr->format = responseFormat;
+    observationPtr->uriNb = uriNb;
+    memcpy(observationPtr->uriList, uriList, uriNb * sizeof(lwm2m_uri_t));
+    observationPtr->hash = HashPayload(*bufferPtr, *lenPtr);
+
+    LOG_ARG("Observe-Composite of %d paths", uriNb);
+    return COAP_205_CONTENT;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Cancel a composite observation.
+ *
+ * This function is called by omanager_CoapHandleMessage for a FETCH request on the root path with
+ * the Observe option set to 1, or when the server resets a notification.
+ *
+ * @return
+ *      - true if the observation is cancelled
+ *      - false if the token is not observed by the server
+ */
+//--------------------------------------------------------------------------------------------------
+bool lwm2mcore_CompositeCancel
+(
+    uint16_t shortServerId,             ///< [IN] Short server Id of the requesting server
+    const uint8_t* tokenPtr,            ///< [IN] Request token
+    uint8_t tokenLen                    ///< [IN] Request token length
+)
+{
+    Observation_t* observationPtr;
+
+    if (NULL == tokenPtr)
+    {
+        return false;
+    }
+
+    observationPtr = FindObservation(shortServerId, tokenPtr, tokenLen);
+    if (NULL == observationPtr)
+    {
+        return false;
+    }
+
+    observationPtr->isUsed = false;
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the composite observations and notify the server of the changed values
+ */
+//--------------------------------------------------------------------------------------------------
+void omanager_CompositeCheck
+(
+    lwm2mcore_Ref_t instanceRef         ///< [IN] instance reference
+)
+{
+    int i;
+
+    for (i = 0; i < COMPOSITE_OBSERVE_MAX_NB; i++)
+    {
+        Observation_t* observationPtr = &ObservationList[i];
+        uint8_t* bufferPtr;
+        size_t length;
+        uint32_t hash;
+
+        if (!observationPtr->isUsed)
+        {
+            continue;
+        }
+
+        if (COAP_205_CONTENT != ReadPaths(observationPtr->format,
+                                          observationPtr->uriList,
+                                          observationPtr->uriNb,
+                                          &bufferPtr,
+                                          &length))
+        {
+            continue;
+        }
+
+        /* The hash is only updated once the server is notified: a failed notification is sent
+         * again at the next check */
+        hash = HashPayload(bufferPtr, length);
+        if ((hash != observationPtr->hash)
+         && (smanager_Notify(instanceRef,
+                             observationPtr->shortServerId,
+                             observationPtr->token,
+                             observationPtr->tokenLen,
+                             observationPtr->format,
+                             bufferPtr,
+                             length)))
+        {
+            observationPtr->hash = hash;
+        }
+
+        lwm2m_free(bufferPtr);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Cancel all the composite observations, when the session is closed
+ */
+//--------------------------------------------------------------------------------------------------
+void omanager_CompositeReset
+(
+    void
+)
+{
+    memset(ObservationList, 0, sizeof(ObservationList));
+}
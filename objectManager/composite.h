@@ -0,0 +1,145 @@
+/**
+ * @file composite.h
+ *
+ * LwM2M 1.1 Read-Composite and Observe-Composite operations
+ *
+ * The request payload is a SenML pack listing the paths to read: objects, object instances or
+ * resources, of any object. Each path is read through the read handlers of its object and all the
+ * values are encoded in a single SenML pack, each record carrying its absolute path.
+ *
+ * A composite observation is re-read after each step of the session and the server is notified
+ * when the encoded values change.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#ifndef __COMPOSITE_H__
+#define __COMPOSITE_H__
+
+#include <lwm2mcore/lwm2mcore.h>
+#include "liblwm2m.h"
+
+/**
+  * @addtogroup lwm2mcore_composite_int
+  * @{
+  */
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Maximum number of paths of a composite request
+ */
+//--------------------------------------------------------------------------------------------------
+#define COMPOSITE_URI_MAX_NB            16
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Maximum number of composite observations
+ */
+//--------------------------------------------------------------------------------------------------
+#define COMPOSITE_OBSERVE_MAX_NB        4
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Maximum length of a CoAP token
+ */
+//--------------------------------------------------------------------------------------------------
+#define COMPOSITE_TOKEN_MAX_LEN         8
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Read-Composite request.
+ *
+ * This function is called by omanager_CoapHandleMessage for a FETCH request on the root path. The
+ * buffer is allocated by this function and released by the caller with lwm2m_free. The paths which
+ * are not found are not part of the response.
+ *
+ * @return
+ *      - COAP_205_CONTENT if the paths are read
+ *      - COAP_400_BAD_REQUEST if the request payload is invalid
+ *      - COAP_404_NOT_FOUND if none of the paths is found
+ *      - COAP_415_UNSUPPORTED_CONTENT_FORMAT if a content format is not a SenML format
+ *      - other CoAP error codes if a read handler fails
+ */
+//--------------------------------------------------------------------------------------------------
+uint8_t lwm2mcore_CompositeRead
+(
+    uint16_t requestFormat,             ///< [IN] Content format of the request payload
+    const uint8_t* requestPtr,          ///< [IN] Request payload: SenML pack of the paths
+    size_t requestLen,                  ///< [IN] Request payload length
+    uint16_t responseFormat,            ///< [IN] Requested content format of the response
+    uint8_t** bufferPtr,                ///< [OUT] Response payload
+    size_t* lenPtr                      ///< [OUT] Response payload length
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Observe-Composite request.
+ *
+ * This function is called by omanager_CoapHandleMessage for a FETCH request on the root path with
+ * the Observe option set to 0. The paths are read as for a Read-Composite request, and the
+ * observation is registered with the request token, replacing a previous observation of the server
+ * with the same token.
+ *
+ * @return
+ *      - see lwm2mcore_CompositeRead
+ *      - COAP_503_SERVICE_UNAVAILABLE if the maximum number of observations is reached
+ */
+//--------------------------------------------------------------------------------------------------
+uint8_t lwm2mcore_CompositeObserve
+(
+    uint16_t shortServerId,             ///< [IN] Short server Id of the requesting server
+    const uint8_t* tokenPtr,            ///< [IN] Request token
+    uint8_t tokenLen,                   ///< [IN] Request token length
+    uint16_t requestFormat,             ///< [IN] Content format of the request payload
+    const uint8_t* requestPtr,          ///< [IN] Request payload: SenML pack of the paths
+    size_t requestLen,                  ///< [IN] Request payload length
+    uint16_t responseFormat,            ///< [IN] Requested content format of the response
+    uint8_t** bufferPtr,                ///< [OUT] Response payload
+    size_t* lenPtr                      ///< [OUT] Response payload length
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Cancel a composite observation.
+ *
+ * This function is called by omanager_CoapHandleMessage for a FETCH request on the root path with
+ * the Observe option set to 1, or when the server resets a notification.
+ *
+ * @return
+ *      - true if the observation is cancelled
+ *      - false if the token is not observed by the server
+ */
+//--------------------------------------------------------------------------------------------------
+bool lwm2mcore_CompositeCancel
+(
+    uint16_t shortServerId,             ///< [IN] Short server Id of the requesting server
+    const uint8_t* tokenPtr,            ///< [IN] Request token
+    uint8_t tokenLen                    ///< [IN] Request token length
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Read the composite observations and notify the server of the changed values
+ */
+//--------------------------------------------------------------------------------------------------
+void omanager_CompositeCheck
+(
+    lwm2mcore_Ref_t instanceRef         ///< [IN] instance reference
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Cancel all the composite observations, when the session is closed
+ */
+//--------------------------------------------------------------------------------------------------
+void omanager_CompositeReset
+(
+    void
+);
+
+/**
+  * @}
+  */
+
+#endif /* __COMPOSITE_H__ */
@@ -0,0 +1,780 @@
+/**
+ * @file connStats.c
+ *
+ * Connectivity statistics sampler, see connStats.h
+ *
+ * A sample holds the values of all the sampled resources read at the same time, and a mask of the
+ * values which were read successfully: a radio value can be unavailable with the current cellular
+ * technology. The samples are stored in a ring of fixed size, from the oldest to the newest.
+ *
+ * The result of the last platform read of each resource is kept, so that a read served from the
+ * samples returns the same error as the platform when the value is unavailable.
+ *
+ * The sampling timer can interrupt a read of the ring, for example when the timer callbacks run in
+ * a signal handler. The values of a sample are read from the platform first, then the sample is
+ * added to the ring with the ring sequence number odd. A reader checks that the sequence number is
+ * even and did not change while it read the ring, and reads again otherwise: a read never returns a
+ * partially written sample.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#include <string.h>
+#include <lwm2mcore/lwm2mcore.h>
+#include <lwm2mcore/timer.h>
+#include <lwm2mcore/connectivity.h>
+#include <lwm2mcore/device.h>
+#include "liblwm2m.h"
+#include "internals.h"
+#include "objects.h"
+#include "utils.h"
+#include "connStats.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delay of the first sample after the configuration, in seconds
+ */
+//--------------------------------------------------------------------------------------------------
+#define FIRST_SAMPLE_DELAY      1
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of attempts to read the ring while it is modified
+ */
+//--------------------------------------------------------------------------------------------------
+#define READ_ATTEMPT_MAX_NB     8
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Type of a sampled value, as returned by the platform
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    VALUE_TYPE_UINT8 = 0,               ///< uint8_t
+    VALUE_TYPE_UINT16,                  ///< uint16_t
+    VALUE_TYPE_UINT32,                  ///< uint32_t
+    VALUE_TYPE_INT32,                   ///< int32_t
+    VALUE_TYPE_UINT64                   ///< uint64_t
+}ValueType_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sampled values
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    VALUE_SMS_TX_COUNT = 0,             ///< /7/0/0: SMS Tx counter
+    VALUE_SMS_RX_COUNT,                 ///< /7/0/1: SMS Rx counter
+    VALUE_TX_DATA,                      ///< /7/0/2: Tx data
+    VALUE_RX_DATA,                      ///< /7/0/3: Rx data
+    VALUE_SIGNAL_BARS,                  ///< /10242/0/0: Signal bars
+    VALUE_ROAMING,                      ///< /10242/0/2: Roaming indicator
+    VALUE_ECIO,                         ///< /10242/0/3: Ec/Io
+    VALUE_RSRP,                         ///< /10242/0/4: RSRP
+    VALUE_RSRQ,                         ///< /10242/0/5: RSRQ
+    VALUE_RSCP,                         ///< /10242/0/6: RSCP
+    VALUE_TEMPERATURE,                  ///< /10242/0/7: Device temperature
+    VALUE_UNEXPECTED_RESETS,            ///< /10242/0/8: Unexpected reset counter
+    VALUE_TOTAL_RESETS,                 ///< /10242/0/9: Total reset counter
+    VALUE_LAC,                          ///< /10242/0/10: Location Area Code
+    VALUE_TAC,                          ///< /10242/0/11: Tracking Area Code
+    VALUE_NB                            ///< Number of sampled values
+}ValueId_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Description of a sampled value
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint16_t    oid;                    ///< Object Id
+    uint16_t    rid;                    ///< Resource Id
+    ValueType_t type;                   ///< Type of the value returned by the platform
+}ValueDesc_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sample of the connectivity statistics
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t    time;                   ///< Time of the sample in seconds
+    uint16_t    validMask;              ///< Values read successfully: bit n for the ValueId_t n
+    int64_t     values[VALUE_NB];       ///< Values
+}Sample_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sampled values, in the ValueId_t order
+ */
+//--------------------------------------------------------------------------------------------------
+static const ValueDesc_t ValueDescList[VALUE_NB] =
+{
+    { LWM2MCORE_CONN_STATS_OID, LWM2MCORE_CONN_STATS_TX_SMS_COUNT_RID, VALUE_TYPE_UINT64 },
+    { LWM2MCORE_CONN_STATS_OID, LWM2MCORE_CONN_STATS_RX_SMS_COUNT_RID, VALUE_TYPE_UINT64 },
+    { LWM2MCORE_CONN_STATS_OID, LWM2MCORE_CONN_STATS_TX_DATA_COUNT_RID, VALUE_TYPE_UINT64 },
+    { LWM2MCORE_CONN_STATS_OID, LWM2MCORE_CONN_STATS_RX_DATA_COUNT_RID, VALUE_TYPE_UINT64 },
+    { LWM2MCORE_EXT_CONN_STATS_OID, LWM2MCORE_EXT_CONN_STATS_SIGNAL_BARS_RID, VALUE_TYPE_UINT8 },
+    { LWM2MCORE_EXT_CONN_STATS_OID, LWM2MCORE_EXT_CONN_STATS_ROAMING_RID, VALUE_TYPE_UINT8 },
+    { LWM2MCORE_EXT_CONN_STATS_OID, LWM2MCORE_EXT_CONN_STATS_ECIO_RID, VALUE_TYPE_INT32 },
+    { LWM2MCORE_EXT_CONN_STATS_OID, LWM2MCORE_EXT_CONN_STATS_RSRP_RID, VALUE_TYPE_INT32 },
+    { LWM2MCORE_EXT_CONN_STATS_OID, LWM2MCORE_EXT_CONN_STATS_RSRQ_RID, VALUE_TYPE_INT32 },
+    { LWM2MCORE_EXT_CONN_STATS_OID, LWM2MCORE_EXT_CONN_STATS_RSCP_RID, VALUE_TYPE_INT32 },
+    { LWM2MCORE_EXT_CONN_STATS_OID, LWM2MCORE_EXT_CONN_STATS_TEMPERATURE_RID, VALUE_TYPE_INT32 },
+    { LWM2MCORE_EXT_CONN_STATS_OID, LWM2MCORE_EXT_CONN_STATS_UNEXPECTED_RESETS_RID,
+      VALUE_TYPE_UINT32 },
+    { LWM2MCORE_EXT_CONN_STATS_OID, LWM2MCORE_EXT_CONN_STATS_TOTAL_RESETS_RID, VALUE_TYPE_UINT32 },
+    { LWM2MCORE_EXT_CONN_STATS_OID, LWM2MCORE_EXT_CONN_STATS_LAC_RID, VALUE_TYPE_UINT32 },
+    { LWM2MCORE_EXT_CONN_STATS_OID, LWM2MCORE_EXT_CONN_STATS_TAC_RID, VALUE_TYPE_UINT16 }
+};
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sampling interval in seconds, 0 if the sampling is disabled
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t Interval = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Ring of samples
+ */
+//--------------------------------------------------------------------------------------------------
+static Sample_t SampleList[LWM2MCORE_CONN_STATS_SAMPLE_MAX_NB];
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Position of the oldest sample in the ring
+ */
+//--------------------------------------------------------------------------------------------------
+static uint16_t SampleFirst = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of samples in the ring
+ */
+//--------------------------------------------------------------------------------------------------
+static uint16_t SampleNb = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Result of the last platform read of each value
+ */
+//--------------------------------------------------------------------------------------------------
+static lwm2mcore_Sid_t LastSidList[VALUE_NB];
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sequence number of the ring, odd while the ring is modified
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t RingSeq = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *                      PRIVATE FUNCTIONS
+ */
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the current time in seconds
+ *
+ * @return
+ *      - Time in seconds
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t GetTime
+(
+    void
+)
+{
+    return (uint32_t)(lwm2mcore_GetTimeUs() / 1000000);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Find a sampled value
+ *
+ * @return
+ *      - Value Id
+ *      - VALUE_NB if the resource is not sampled
+ */
+//--------------------------------------------------------------------------------------------------
+static ValueId_t FindValue
+(
+    uint16_t oid,                       ///< [IN] Object Id
+    uint16_t rid                        ///< [IN] Resource Id
+)
+{
+    int i;
+
+    for (i = 0; i < VALUE_NB; i++)
+    {
+        if ((oid == ValueDescList[i].oid) && (rid == ValueDescList[i].rid))
+        {
+            return (ValueId_t)i;
+        }
+    }
+
+    return VALUE_NB;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read a value from the platform
+ *
+ * @return
+ *      - Result of the platform function
+ */
+//--------------------------------------------------------------------------------------------------
+static lwm2mcore_Sid_t ReadValue
+(
+    ValueId_t valueId,                  ///< [IN] Value Id
+    int64_t* valuePtr                   ///< [OUT] Value
+)
+{
+    lwm2mcore_Sid_t sID;
+    uint64_t u64Value = 0;
+    uint32_t u32Value = 0;
+    uint16_t u16Value = 0;
+    uint8_t u8Value = 0;
+    int32_t i32Value = 0;
+
+    switch (valueId)
+    {
+        case VALUE_SMS_TX_COUNT:
+            sID = lwm2mcore_GetSmsTxCount(&u64Value);
+            break;
+
+        case VALUE_SMS_RX_COUNT:
+            sID = lwm2mcore_GetSmsRxCount(&u64Value);
+            break;
+
+        case VALUE_TX_DATA:
+            sID = lwm2mcore_GetTxData(&u64Value);
+            break;
+
+        case VALUE_RX_DATA:
+            sID = lwm2mcore_GetRxData(&u64Value);
+            break;
+
+        case VALUE_SIGNAL_BARS:
+            sID = lwm2mcore_GetSignalBars(&u8Value);
+            break;
+
+        case VALUE_ROAMING:
+            sID = lwm2mcore_GetRoamingIndicator(&u8Value);
+            break;
+
+        case VALUE_ECIO:
+            sID = lwm2mcore_GetEcIo(&i32Value);
+            break;
+
+        case VALUE_RSRP:
+            sID = lwm2mcore_GetRsrp(&i32Value);
+            break;
+
+        case VALUE_RSRQ:
+            sID = lwm2mcore_GetRsrq(&i32Value);
+            break;
+
+        case VALUE_RSCP:
+            sID = lwm2mcore_GetRscp(&i32Value);
+            break;
+
+        case VALUE_TEMPERATURE:
+            sID = lwm2mcore_GetDeviceTemperature(&i32Value);
+            break;
+
+        case VALUE_UNEXPECTED_RESETS:
+            sID = lwm2mcore_GetDeviceUnexpectedResets(&u32Value);
+            break;
+
+        case VALUE_TOTAL_RESETS:
+            sID = lwm2mcore_GetDeviceTotalResets(&u32Value);
+            break;
+
+        case VALUE_LAC:
+            sID = lwm2mcore_GetLac(&u32Value);
+            break;
+
+        case VALUE_TAC:
+            sID = lwm2mcore_GetServingCellLteTracAreaCode(&u16Value);
+            break;
+
+        default:
+            return LWM2MCORE_ERR_INCORRECT_RANGE;
+    }
+
+    switch (ValueDescList[valueId].type)
+    {
+        case VALUE_TYPE_UINT8:
+            *valuePtr = (int64_t)u8Value;
+            break;
+
+        case VALUE_TYPE_UINT16:
+            *valuePtr = (int64_t)u16Value;
+            break;
+
+        case VALUE_TYPE_UINT32:
+            *valuePtr = (int64_t)u32Value;
+            break;
+
+        case VALUE_TYPE_INT32:
+            *valuePtr = (int64_t)i32Value;
+            break;
+
+        default:
+            *valuePtr = (int64_t)u64Value;
+            break;
+    }
+
+    return sID;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Format a sampled value with the type returned by the platform
+ *
+ * @return
+ *      - Length of the formatted value
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t FormatValue
+(
+    ValueId_t valueId,                  ///< [IN] Value Id
+    int64_t value,                      ///< [IN] Value
+    char* bufferPtr                     ///< [OUT] Formatted value
+)
+{
+    uint64_t u64Value = (uint64_t)value;
+    uint32_t u32Value = (uint32_t)value;
+    uint16_t u16Value = (uint16_t)value;
+    uint8_t u8Value = (uint8_t)value;
+    int32_t i32Value = (int32_t)value;
+
+    switch (ValueDescList[valueId].type)
+    {
+        case VALUE_TYPE_UINT8:
+            return omanager_FormatValueToBytes((uint8_t*)bufferPtr,
+                                               &u8Value,
+                                               sizeof(u8Value),
+                                               false);
+
+        case VALUE_TYPE_UINT16:
+            return omanager_FormatValueToBytes((uint8_t*)bufferPtr,
+                                               &u16Value,
+                                               sizeof(u16Value),
+                                               false);
+
+        case VALUE_TYPE_UINT32:
+            return omanager_FormatValueToBytes((uint8_t*)bufferPtr,
+                                               &u32Value,
+                                               sizeof(u32Value),
+                                               false);
+
+        case VALUE_TYPE_INT32:
+            return omanager_FormatValueToBytes((uint8_t*)bufferPtr,
+                                               &i32Value,
+                                               sizeof(i32Value),
+                                               true);
+
+        default:
+            return omanager_FormatValueToBytes((uint8_t*)bufferPtr,
+                                               &u64Value,
+                                               sizeof(u64Value),
+                                               false);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start a modification of the ring
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartRingWrite
+(
+    void
+)
+{
+    __atomic_store_n(&RingSeq, RingSeq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * End a modification of the ring
+ */
+//--------------------------------------------------------------------------------------------------
+static void EndRingWrite
+(
+    void
+)
+{
+    __atomic_store_n(&RingSeq, RingSeq + 1, __ATOMIC_RELEASE);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start a read of the ring
+ *
+ * @return
+ *      - Sequence number of the ring, to be checked at the end of the read
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t StartRingRead
+(
+    void
+)
+{
+    return __atomic_load_n(&RingSeq, __ATOMIC_ACQUIRE);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * End a read of the ring
+ *
+ * @return
+ *      - true if the ring was not modified during the read
+ *      - false if the read has to be done again
+ */
+//--------------------------------------------------------------------------------------------------
+static bool EndRingRead
+(
+    uint32_t seq                        ///< [IN] Sequence number at the start of the read
+)
+{
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return (0 == (seq & 1)) && (seq == __atomic_load_n(&RingSeq, __ATOMIC_RELAXED));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Aggregate the samples of a value. The ring is not protected against a modification.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AggregateValue
+(
+    ValueId_t valueId,                              ///< [IN] Value Id
+    lwm2mcore_ConnStatsAggregate_t* aggregatePtr    ///< [OUT] Aggregation of the samples
+)
+{
+    uint32_t firstTime = 0;
+    int64_t deltaSum = 0;
+    int i;
+
+    memset(aggregatePtr, 0, sizeof(lwm2mcore_ConnStatsAggregate_t));
+
+    /* The values are summed as differences with the first one, to keep the sum small */
+    for (i = 0; i < SampleNb; i++)
+    {
+        const Sample_t* samplePtr =
+                        &SampleList[(SampleFirst + i) % LWM2MCORE_CONN_STATS_SAMPLE_MAX_NB];
+        int64_t value = samplePtr->values[valueId];
+
+        if (!(samplePtr->validMask & (1 << valueId)))
+        {
+            continue;
+        }
+
+        if (0 == aggregatePtr->sampleNb)
+        {
+            firstTime = samplePtr->time;
+            aggregatePtr->min = value;
+            aggregatePtr->max = value;
+            aggregatePtr->avg = value;
+        }
+        else if (value < aggregatePtr->min)
+        {
+            aggregatePtr->min = value;
+        }
+        else if (value > aggregatePtr->max)
+        {
+            aggregatePtr->max = value;
+        }
+
+        deltaSum += value - aggregatePtr->avg;
+        aggregatePtr->last = value;
+        aggregatePtr->duration = samplePtr->time - firstTime;
+        aggregatePtr->sampleNb++;
+    }
+
+    if (0 != aggregatePtr->sampleNb)
+    {
+        aggregatePtr->avg += deltaSum / aggregatePtr->sampleNb;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Callback of the sampling timer: take a sample and launch the timer for the next one
+ */
+//--------------------------------------------------------------------------------------------------
+static void SampleTimerCb
+(
+    void
+)
+{
+    omanager_ConnStatsSample();
+
+    if (   (0 != Interval)
+        && (false == lwm2mcore_TimerSet(LWM2MCORE_TIMER_CONN_STATS, Interval, SampleTimerCb)))
+    {
+        LOG("ERROR to launch the connectivity statistics timer");
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *                      PUBLIC FUNCTIONS
+ */
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the sampled resources from the platform and add a sample to the ring
+ */
+//--------------------------------------------------------------------------------------------------
+void omanager_ConnStatsSample
+(
+    void
+)
+{
+    lwm2mcore_Sid_t sidList[VALUE_NB];
+    Sample_t sample;
+    int i;
+
+    if (0 == Interval)
+    {
+        return;
+    }
+
+    /* The platform is read before the ring is modified */
+    memset(&sample, 0, sizeof(sample));
+    sample.time = GetTime();
+    for (i = 0; i < VALUE_NB; i++)
+    {
+        sidList[i] = ReadValue((ValueId_t)i, &sample.values[i]);
+        if (LWM2MCORE_ERR_COMPLETED_OK == sidList[i])
+        {
+            sample.validMask |= (uint16_t)(1 << i);
+        }
+    }
+
+    StartRingWrite();
+
+    /* The oldest sample is replaced when the ring is full */
+    memcpy(&SampleList[(SampleFirst + SampleNb) % LWM2MCORE_CONN_STATS_SAMPLE_MAX_NB],
+           &sample,
+           sizeof(sample));
+    if (LWM2MCORE_CONN_STATS_SAMPLE_MAX_NB == SampleNb)
+    {
+        SampleFirst = (SampleFirst + 1) % LWM2MCORE_CONN_STATS_SAMPLE_MAX_NB;
+    }
+    else
+    {
+        SampleNb++;
+    }
+    memcpy(LastSidList, sidList, sizeof(LastSidList));
+
+    EndRingWrite();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read a resource of the objects 7 or 10242 from the last sample.
+ *
+ * The value is formatted as the read handler of the resource formats the value returned by the
+ * platform.
+ *
+ * @return
+ *      - true if the resource is read from the last sample: sIdPtr is the result of the platform
+ *        read when the sample was taken
+ *      - false if the sampling is disabled, if no sample is taken yet or if the resource is not
+ *        sampled: the resource is read from the platform
+ */
+//--------------------------------------------------------------------------------------------------
+bool omanager_ConnStatsRead
+(
+    uint16_t oid,                       ///< [IN] Object Id
+    uint16_t rid,                       ///< [IN] Resource Id
+    char* bufferPtr,                    ///< [INOUT] data buffer for information
+    size_t* lenPtr,                     ///< [INOUT] length of input buffer and length of the
+                                        ///< returned data
+    int* sIdPtr                         ///< [OUT] Result of the read
+)
+{
+    ValueId_t valueId;
+    int attemptNb;
+
+    if ((0 == Interval) || (NULL == sIdPtr))
+    {
+        return false;
+    }
+
+    valueId = FindValue(oid, rid);
+    if (VALUE_NB == valueId)
+    {
+        return false;
+    }
+
+    for (attemptNb = 0; attemptNb < READ_ATTEMPT_MAX_NB; attemptNb++)
+    {
+        uint32_t seq = StartRingRead();
+        uint16_t sampleNb = SampleNb;
+        const Sample_t* samplePtr = &SampleList[(SampleFirst + sampleNb
+                                                 + LWM2MCORE_CONN_STATS_SAMPLE_MAX_NB - 1)
+                                                % LWM2MCORE_CONN_STATS_SAMPLE_MAX_NB];
+        bool isValid = (0 != (samplePtr->validMask & (1 << valueId)));
+        int64_t value = samplePtr->values[valueId];
+        lwm2mcore_Sid_t sID = LastSidList[valueId];
+
+        if (EndRingRead(seq))
+        {
+            if (0 == sampleNb)
+            {
+                return false;
+            }
+
+            *sIdPtr = sID;
+            if (isValid)
+            {
+                *lenPtr = FormatValue(valueId, value, bufferPtr);
+            }
+            return true;
+        }
+    }
+
+    /* The ring is being modified: the resource is read from the platform */
+    return false;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Discard the samples, when the connectivity counters are reset
+ */
+//--------------------------------------------------------------------------------------------------
+void omanager_ConnStatsReset
+(
+    void
+)
+{
+    StartRingWrite();
+    SampleFirst = 0;
+    SampleNb = 0;
+    EndRingWrite();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function to configure the connectivity statistics sampling.
+ *
+ * The samples of a previous configuration are discarded.
+ *
+ * @return
+ *      - LWM2MCORE_ERR_COMPLETED_OK if the configuration is applied
+ *      - LWM2MCORE_ERR_INVALID_ARG if the interval is 0
+ *      - LWM2MCORE_ERR_GENERAL_ERROR if the sampling timer cannot be launched
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_Sid_t lwm2mcore_ConnStatsConfigure
+(
+    const lwm2mcore_ConnStatsConfig_t* configPtr    ///< [IN] Configuration, NULL to disable the
+                                                    ///<      sampling
+)
+{
+    if ((NULL != configPtr) && (0 == configPtr->interval))
+    {
+        return LWM2MCORE_ERR_INVALID_ARG;
+    }
+
+    if (   (0 != Interval)
+        && (false == lwm2mcore_TimerStop(LWM2MCORE_TIMER_CONN_STATS)))
+    {
+        LOG("Error to stop the connectivity statistics timer");
+    }
+    Interval = 0;
+    omanager_ConnStatsReset();
+
+    if (NULL == configPtr)
+    {
+        return LWM2MCORE_ERR_COMPLETED_OK;
+    }
+
+    if (false == lwm2mcore_TimerSet(LWM2MCORE_TIMER_CONN_STATS,
+                                    FIRST_SAMPLE_DELAY,
+                                    SampleTimerCb))
+    {
+        LOG("ERROR to launch the connectivity statistics timer");
+        return LWM2MCORE_ERR_GENERAL_ERROR;
+    }
+
+    Interval = configPtr->interval;
+    LOG_ARG("Connectivity statistics sampled every %d seconds", Interval);
+    return LWM2MCORE_ERR_COMPLETED_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function to aggregate the samples of a resource of the objects 7 or 10242
+ *
+ * @return
+ *      - LWM2MCORE_ERR_COMPLETED_OK if the aggregation is retrieved
+ *      - LWM2MCORE_ERR_INVALID_ARG if a parameter is invalid or if the resource is not sampled
+ *      - LWM2MCORE_ERR_INVALID_STATE if the sampling is disabled or if no sample contains a value
+ *        of the resource
+ *      - LWM2MCORE_ERR_GENERAL_ERROR if the samples are modified during each aggregation attempt
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_Sid_t lwm2mcore_GetConnStatsAggregate
+(
+    uint16_t oid,                                   ///< [IN] Object Id
+    uint16_t rid,                                   ///< [IN] Resource Id
+    lwm2mcore_ConnStatsAggregate_t* aggregatePtr    ///< [OUT] Aggregation of the samples
+)
+{
+    lwm2mcore_ConnStatsAggregate_t aggregate;
+    ValueId_t valueId;
+    int attemptNb;
+
+    if (NULL == aggregatePtr)
+    {
+        return LWM2MCORE_ERR_INVALID_ARG;
+    }
+
+    valueId = FindValue(oid, rid);
+    if (VALUE_NB == valueId)
+    {
+        return LWM2MCORE_ERR_INVALID_ARG;
+    }
+
+    if (0 == Interval)
+    {
+        return LWM2MCORE_ERR_INVALID_STATE;
+    }
+
+    for (attemptNb = 0; attemptNb < READ_ATTEMPT_MAX_NB; attemptNb++)
+    {
+        uint32_t seq = StartRingRead();
+
+        AggregateValue(valueId, &aggregate);
+        if (EndRingRead(seq))
+        {
+            if (0 == aggregate.sampleNb)
+            {
+                return LWM2MCORE_ERR_INVALID_STATE;
+            }
+
+            memcpy(aggregatePtr, &aggregate, sizeof(lwm2mcore_ConnStatsAggregate_t));
+            return LWM2MCORE_ERR_COMPLETED_OK;
+        }
+    }
+
+    return LWM2MCORE_ERR_GENERAL_ERROR;
+}
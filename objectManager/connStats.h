@@ -0,0 +1,68 @@
+/**
+ * @file connStats.h
+ *
+ * Connectivity statistics sampler, see lwm2mcore/connStats.h
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#ifndef __CONNSTATS_H__
+#define __CONNSTATS_H__
+
+#include <lwm2mcore/connStats.h>
+
+/**
+  * @addtogroup lwm2mcore_connstats_int
+  * @{
+  */
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Read the sampled resources from the platform and add a sample to the ring
+ */
+//--------------------------------------------------------------------------------------------------
+void omanager_ConnStatsSample
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Read a resource of the objects 7 or 10242 from the last sample.
+ *
+ * The value is formatted as the read handler of the resource formats the value returned by the
+ * platform.
+ *
+ * @return
+ *      - true if the resource is read from the last sample: sIdPtr is the result of the platform
+ *        read when the sample was taken
+ *      - false if the sampling is disabled, if no sample is taken yet or if the resource is not
+ *        sampled: the resource is read from the platform
+ */
+//--------------------------------------------------------------------------------------------------
+bool omanager_ConnStatsRead
+(
+    uint16_t oid,                       ///< [IN] Object Id
+    uint16_t rid,                       ///< [IN] Resource Id
+    char* bufferPtr,                    ///< [INOUT] data buffer for information
+    size_t* lenPtr,                     ///< [INOUT] length of input buffer and length of the
+                                        ///< returned data
+    int* sIdPtr                         ///< [OUT] Result of the read
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Discard the samples, when the connectivity counters are reset
+ */
+//--------------------------------------------------------------------------------------------------
+void omanager_ConnStatsReset
+(
+    void
+);
+
+/**
+  * @}
+  */
+
+#endif /* __CONNSTATS_H__ */
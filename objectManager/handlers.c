@@ -18,11 +18,14 @@
 #include <lwm2mcore/paramStorage.h>
 #include <lwm2mcore/update.h>
 #include <lwm2mcore/location.h>
+#include <packageDownloader/lwm2mcorePackageDownloader.h>
 #include "handlers.h"
 #include "sessionManager.h"
 #include "objects.h"
 #include "internals.h"
 #include "utils.h"
+#include "paramCache.h"
+#include "connStats.h"
 #include "liblwm2m.h"
 
 //--------------------------------------------------------------------------------------------------
@@ -82,12 +85,70 @@
 //--------------------------------------------------------------------------------------------------
 #define BS_CONFIG_VERSION_2         2
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Bootstrap file version 3
+ *
+ * The configuration is stored in a single parameter with an explicit layout, all the integers
+ * being in network byte order:
+ *  - header: version (4 bytes), security objects number (2 bytes), server objects number (2 bytes)
+ *  - security object records, BS_CONFIG_SECURITY_RECORD_LEN bytes each
+ *  - server object records, BS_CONFIG_SERVER_RECORD_LEN bytes each
+ *  - CRC32 of all the previous bytes (4 bytes)
+ *
+ * The records having a fixed length, the configuration is decoded in place from a single read.
+ */
+//--------------------------------------------------------------------------------------------------
+#define BS_CONFIG_VERSION_3         3
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Supported version for bootstrap file
  */
 //--------------------------------------------------------------------------------------------------
-#define BS_CONFIG_VERSION           BS_CONFIG_VERSION_2
+#define BS_CONFIG_VERSION           BS_CONFIG_VERSION_3
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Bootstrap file version 3: header length
+ */
+//--------------------------------------------------------------------------------------------------
+#define BS_CONFIG_HEADER_LEN            8
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Bootstrap file version 3: security object record length
+ *
+ * Object instance Id (2 bytes), is bootstrap server (1 byte), security mode (1 byte), short server
+ * Id (2 bytes), client hold off time (2 bytes), bootstrap server account timeout (4 bytes)
+ */
+//--------------------------------------------------------------------------------------------------
+#define BS_CONFIG_SECURITY_RECORD_LEN   12
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Bootstrap file version 3: server object record length
+ *
+ * Object instance Id (2 bytes), short server Id (2 bytes), lifetime (4 bytes), default minimum
+ * period (4 bytes), default maximum period (4 bytes), disable timeout (4 bytes), is disabled
+ * (1 byte), notification storing (1 byte), binding mode (LWM2MCORE_BINDING_STR_MAX_LEN bytes)
+ */
+//--------------------------------------------------------------------------------------------------
+#define BS_CONFIG_SERVER_RECORD_LEN     (22 + LWM2MCORE_BINDING_STR_MAX_LEN)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Bootstrap file version 3: CRC length
+ */
+//--------------------------------------------------------------------------------------------------
+#define BS_CONFIG_CRC_LEN               4
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Length of the buffer used to read the bootstrap file: a larger file needs a second read
+ */
+//--------------------------------------------------------------------------------------------------
+#define BS_CONFIG_READ_LEN              512
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -161,10 +222,86 @@ ConfigBootstrapFileV01_t;
 //--------------------------------------------------------------------------------------------------
 static ConfigBootstrapFile_t BsConfigList;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function to get an object instance slot of object 0 (security)
+ *
+ * @return
+ *  - pointer on the slot
+ */
+//--------------------------------------------------------------------------------------------------
+static ConfigSecurityObject_t* GetSecuritySlot
+(
+    ConfigBootstrapFile_t*  bsConfigListPtr,            ///< [IN] Bootstrap information list
+    uint16_t                slot                        ///< [IN] Slot index, lower than
+                                                        ///<      SecuritySlotNb()
+)
+{
+    if (LWM2MCORE_BS_INSTANCE_MAX_NB > slot)
+    {
+        return &bsConfigListPtr->security[slot];
+    }
+    return &bsConfigListPtr->securityExtraPtr[slot - LWM2MCORE_BS_INSTANCE_MAX_NB];
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function to get the number of object instance slots of object 0 (security)
+ *
+ * @return
+ *  - number of slots
+ */
+//--------------------------------------------------------------------------------------------------
+static uint16_t SecuritySlotNb
+(
+    const ConfigBootstrapFile_t*  bsConfigListPtr       ///< [IN] Bootstrap information list
+)
+{
+    return (uint16_t)(LWM2MCORE_BS_INSTANCE_MAX_NB + bsConfigListPtr->securityExtraNb);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function to get an object instance slot of object 1 (server)
+ *
+ * @return
+ *  - pointer on the slot
+ */
+//--------------------------------------------------------------------------------------------------
+static ConfigServerObject_t* GetServerSlot
+(
+    ConfigBootstrapFile_t*  bsConfigListPtr,            ///< [IN] Bootstrap information list
+    uint16_t                slot                        ///< [IN] Slot index, lower than
+                                                        ///<      ServerSlotNb()
+)
+{
+    if (LWM2MCORE_BS_INSTANCE_MAX_NB > slot)
+    {
+        return &bsConfigListPtr->server[slot];
+    }
+    return &bsConfigListPtr->serverExtraPtr[slot - LWM2MCORE_BS_INSTANCE_MAX_NB];
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function to get the number of object instance slots of object 1 (server)
+ *
+ * @return
+ *  - number of slots
+ */
+//--------------------------------------------------------------------------------------------------
+static uint16_t ServerSlotNb
+(
+    const ConfigBootstrapFile_t*  bsConfigListPtr       ///< [IN] Bootstrap information list
+)
+{
+    return (uint16_t)(LWM2MCORE_BS_INSTANCE_MAX_NB + bsConfigListPtr->serverExtraNb);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Function to get the bootstrap information for a specific object instance Id of object 0
- * (security)
+ * (security). The slot of the same index is checked first, then all the slots.
  *
  * @return
  *  - pointer on object instance structure on success
@@ -173,23 +310,41 @@ static ConfigBootstrapFile_t BsConfigList;
 //--------------------------------------------------------------------------------------------------
 static ConfigSecurityObject_t* FindSecurityInstance
 (
-    ConfigBootstrapFile_t   bsConfigList,               ///< [IN] Bootstrap information list
+    ConfigBootstrapFile_t*  bsConfigListPtr,            ///< [IN] Bootstrap information list
     uint16_t                securityObjectInstanceId    ///< [IN] Security object instance Id
 )
 {
-    ConfigSecurityObject_t* bsInfoPtr = bsConfigList.securityPtr;
+    ConfigSecurityObject_t* securityPtr;
+    uint16_t slot;
 
-    while ((bsInfoPtr) && ((bsInfoPtr->data.securityObjectInstanceId) != securityObjectInstanceId))
+    if (LWM2MCORE_BS_INSTANCE_MAX_NB > securityObjectInstanceId)
     {
-        bsInfoPtr = bsInfoPtr->nextPtr;
+        securityPtr = &bsConfigListPtr->security[securityObjectInstanceId];
+        if (   (securityPtr->isUsed)
+            && (securityObjectInstanceId == securityPtr->data.securityObjectInstanceId)
+           )
+        {
+            return securityPtr;
+        }
     }
-    return bsInfoPtr;
+
+    for (slot = 0; slot < SecuritySlotNb(bsConfigListPtr); slot++)
+    {
+        securityPtr = GetSecuritySlot(bsConfigListPtr, slot);
+        if (   (securityPtr->isUsed)
+            && (securityObjectInstanceId == securityPtr->data.securityObjectInstanceId)
+           )
+        {
+            return securityPtr;
+        }
+    }
+    return NULL;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
  * Function to get the bootstrap information for a specific object instance Id of object 1
- * (server)
+ * (server). The slot of the same index is checked first, then all the slots.
  *
  * @return
  *  - pointer on ConfigServerObject_t
@@ -198,25 +353,69 @@ static ConfigSecurityObject_t* FindSecurityInstance
 //--------------------------------------------------------------------------------------------------
 static ConfigServerObject_t* FindServerInstance
 (
-    ConfigBootstrapFile_t   bsConfigList,               ///< [IN] Bootstrap information list
+    ConfigBootstrapFile_t*  bsConfigListPtr,            ///< [IN] Bootstrap information list
     uint16_t                serverObjectInstanceId      ///< [IN] Server object instance Id
 )
 {
-    ConfigServerObject_t* bsInfoPtr = bsConfigList.serverPtr;
+    ConfigServerObject_t* serverPtr;
+    uint16_t slot;
 
-    while (bsInfoPtr)
+    if (LWM2MCORE_BS_INSTANCE_MAX_NB > serverObjectInstanceId)
     {
-        bsInfoPtr = bsInfoPtr->nextPtr;
+        serverPtr = &bsConfigListPtr->server[serverObjectInstanceId];
+        if (   (serverPtr->isUsed)
+            && (serverObjectInstanceId == serverPtr->data.serverObjectInstanceId)
+           )
+        {
+            return serverPtr;
+        }
     }
 
-    bsInfoPtr = bsConfigList.serverPtr;
+    for (slot = 0; slot < ServerSlotNb(bsConfigListPtr); slot++)
+    {
+        serverPtr = GetServerSlot(bsConfigListPtr, slot);
+        if (   (serverPtr->isUsed)
+            && (serverObjectInstanceId == serverPtr->data.serverObjectInstanceId)
+           )
+        {
+            return serverPtr;
+        }
+    }
+    return NULL;
+}
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function to get the first object instance of object 1 (server), i.e. the one with the lowest
+ * instance Id
+ *
+ * @return
+ *  - pointer on ConfigServerObject_t
+ *  - NULL if no device management server is configured
+ */
+//--------------------------------------------------------------------------------------------------
+static ConfigServerObject_t* GetFirstServerInstance
+(
+    ConfigBootstrapFile_t*  bsConfigListPtr             ///< [IN] Bootstrap information list
+)
+{
+    ConfigServerObject_t* firstPtr = NULL;
+    uint16_t slot;
 
-    while ((bsInfoPtr) && ((bsInfoPtr->data.serverObjectInstanceId) != serverObjectInstanceId))
+    for (slot = 0; slot < ServerSlotNb(bsConfigListPtr); slot++)
     {
-        bsInfoPtr = bsInfoPtr->nextPtr;
+        ConfigServerObject_t* serverPtr = GetServerSlot(bsConfigListPtr, slot);
+
+        if (   (serverPtr->isUsed)
+            && (   (NULL == firstPtr)
+                || (serverPtr->data.serverObjectInstanceId < firstPtr->data.serverObjectInstanceId)
+               )
+           )
+        {
+            firstPtr = serverPtr;
+        }
     }
-    return bsInfoPtr;
+    return firstPtr;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -339,65 +538,202 @@ static lwm2mcore_Sid_t BuildVelocity
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Function to add an object instance of object 0 (security) in bootstrap information list
+ * Function to get a free object instance slot of object 0 (security): the slot of the same index
+ * as the instance Id if it is free, the first free slot otherwise. When all the slots are used,
+ * LWM2MCORE_BS_INSTANCE_MAX_NB additional slots are allocated.
+ *
+ * @return
+ *  - pointer on the free slot on success
+ *  - NULL if the maximum number of slots is reached
  */
 //--------------------------------------------------------------------------------------------------
-static void AddBootstrapInformationSecurity
+static ConfigSecurityObject_t* GetFreeSecuritySlot
 (
-    ConfigBootstrapFile_t* bsConfigListPtr,         ///< [IN] Bootstrap information list
-    ConfigSecurityObject_t* securityInformationPtr  ///< [IN] Security object
+    ConfigBootstrapFile_t*  bsConfigListPtr,            ///< [INOUT] Bootstrap information list
+    uint16_t                securityObjectInstanceId    ///< [IN] Security object instance Id
 )
 {
-    if (!bsConfigListPtr->securityPtr)
+    ConfigSecurityObject_t* extraPtr;
+    uint16_t slotNb = SecuritySlotNb(bsConfigListPtr);
+    uint16_t slot;
+
+    if (   (LWM2MCORE_BS_INSTANCE_MAX_NB > securityObjectInstanceId)
+        && (!bsConfigListPtr->security[securityObjectInstanceId].isUsed)
+       )
     {
-        bsConfigListPtr->securityPtr = securityInformationPtr;
-        bsConfigListPtr->securityPtr->nextPtr = NULL;
+        return &bsConfigListPtr->security[securityObjectInstanceId];
     }
-    else
-    {
-        ConfigSecurityObject_t* tempPtr = bsConfigListPtr->securityPtr;
 
-        while (tempPtr->nextPtr)
+    for (slot = 0; slot < slotNb; slot++)
+    {
+        if (!GetSecuritySlot(bsConfigListPtr, slot)->isUsed)
         {
-            tempPtr = tempPtr->nextPtr;
+            return GetSecuritySlot(bsConfigListPtr, slot);
         }
-        tempPtr->nextPtr = securityInformationPtr;
-        securityInformationPtr->nextPtr = NULL;
     }
+
+    if ((UINT16_MAX - LWM2MCORE_BS_INSTANCE_MAX_NB) < slotNb)
+    {
+        return NULL;
+    }
+
+    extraPtr = (ConfigSecurityObject_t*)OMANAGER_MALLOC(sizeof(ConfigSecurityObject_t) *
+                           (bsConfigListPtr->securityExtraNb + LWM2MCORE_BS_INSTANCE_MAX_NB));
+    LWM2MCORE_ASSERT(extraPtr);
+    memset(extraPtr,
+           0,
+           sizeof(ConfigSecurityObject_t) *
+           (bsConfigListPtr->securityExtraNb + LWM2MCORE_BS_INSTANCE_MAX_NB));
+    if (bsConfigListPtr->securityExtraPtr)
+    {
+        memcpy(extraPtr,
+               bsConfigListPtr->securityExtraPtr,
+               sizeof(ConfigSecurityObject_t) * bsConfigListPtr->securityExtraNb);
+        lwm2m_free(bsConfigListPtr->securityExtraPtr);
+    }
+    bsConfigListPtr->securityExtraPtr = extraPtr;
+    bsConfigListPtr->securityExtraNb += LWM2MCORE_BS_INSTANCE_MAX_NB;
+
+    return GetSecuritySlot(bsConfigListPtr, slotNb);
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Function to add an object instance of object 1 (server) in bootstrap information list
+ * Function to get a free object instance slot of object 1 (server): the slot of the same index as
+ * the instance Id if it is free, the first free slot otherwise. When all the slots are used,
+ * LWM2MCORE_BS_INSTANCE_MAX_NB additional slots are allocated.
+ *
+ * @return
+ *  - pointer on the free slot on success
+ *  - NULL if the maximum number of slots is reached
  */
 //--------------------------------------------------------------------------------------------------
-static void AddBootstrapInformationServer
+static ConfigServerObject_t* GetFreeServerSlot
 (
-    ConfigBootstrapFile_t*  bsConfigListPtr,          ///< [IN] Bootstrap information list
-    ConfigServerObject_t*   serverInformationPtr      ///< [IN] Server object
+    ConfigBootstrapFile_t*  bsConfigListPtr,            ///< [INOUT] Bootstrap information list
+    uint16_t                serverObjectInstanceId      ///< [IN] Server object instance Id
 )
 {
-    if (!bsConfigListPtr->serverPtr)
+    ConfigServerObject_t* extraPtr;
+    uint16_t slotNb = ServerSlotNb(bsConfigListPtr);
+    uint16_t slot;
+
+    if (   (LWM2MCORE_BS_INSTANCE_MAX_NB > serverObjectInstanceId)
+        && (!bsConfigListPtr->server[serverObjectInstanceId].isUsed)
+       )
     {
-        bsConfigListPtr->serverPtr = serverInformationPtr;
-        bsConfigListPtr->serverPtr->nextPtr = NULL;
+        return &bsConfigListPtr->server[serverObjectInstanceId];
     }
-    else
+
+    for (slot = 0; slot < slotNb; slot++)
+    {
+        if (!GetServerSlot(bsConfigListPtr, slot)->isUsed)
+        {
+            return GetServerSlot(bsConfigListPtr, slot);
+        }
+    }
+
+    if ((UINT16_MAX - LWM2MCORE_BS_INSTANCE_MAX_NB) < slotNb)
+    {
+        return NULL;
+    }
+
+    extraPtr = (ConfigServerObject_t*)OMANAGER_MALLOC(sizeof(ConfigServerObject_t) *
+                           (bsConfigListPtr->serverExtraNb + LWM2MCORE_BS_INSTANCE_MAX_NB));
+    LWM2MCORE_ASSERT(extraPtr);
+    memset(extraPtr,
+           0,
+           sizeof(ConfigServerObject_t) *
+           (bsConfigListPtr->serverExtraNb + LWM2MCORE_BS_INSTANCE_MAX_NB));
+    if (bsConfigListPtr->serverExtraPtr)
+    {
+        memcpy(extraPtr,
+               bsConfigListPtr->serverExtraPtr,
+               sizeof(ConfigServerObject_t) * bsConfigListPtr->serverExtraNb);
+        lwm2m_free(bsConfigListPtr->serverExtraPtr);
+    }
+    bsConfigListPtr->serverExtraPtr = extraPtr;
+    bsConfigListPtr->serverExtraNb += LWM2MCORE_BS_INSTANCE_MAX_NB;
+
+    return GetServerSlot(bsConfigListPtr, slotNb);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function to add an object instance of object 0 (security) in bootstrap information list. An
+ * existing object instance with the same Id is cleared.
+ *
+ * @return
+ *  - pointer on the cleared object instance structure on success
+ *  - NULL if the maximum number of slots is reached
+ */
+//--------------------------------------------------------------------------------------------------
+static ConfigSecurityObject_t* AddBootstrapInformationSecurity
+(
+    ConfigBootstrapFile_t*  bsConfigListPtr,            ///< [INOUT] Bootstrap information list
+    uint16_t                securityObjectInstanceId    ///< [IN] Security object instance Id
+)
+{
+    ConfigSecurityObject_t* securityInformationPtr;
+
+    securityInformationPtr = FindSecurityInstance(bsConfigListPtr, securityObjectInstanceId);
+    if (!securityInformationPtr)
     {
-        ConfigServerObject_t* tempPtr = bsConfigListPtr->serverPtr;
+        securityInformationPtr = GetFreeSecuritySlot(bsConfigListPtr, securityObjectInstanceId);
+        if (!securityInformationPtr)
+        {
+            LOG_ARG("No slot for security object instance Id %d", securityObjectInstanceId);
+            return NULL;
+        }
+        bsConfigListPtr->securityObjectNumber++;
+    }
 
-        while (tempPtr->nextPtr)
+    memset(securityInformationPtr, 0, sizeof(ConfigSecurityObject_t));
+    securityInformationPtr->data.securityObjectInstanceId = securityObjectInstanceId;
+    securityInformationPtr->isUsed = true;
+    return securityInformationPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function to add an object instance of object 1 (server) in bootstrap information list. An
+ * existing object instance with the same Id is cleared.
+ *
+ * @return
+ *  - pointer on the cleared object instance structure on success
+ *  - NULL if the maximum number of slots is reached
+ */
+//--------------------------------------------------------------------------------------------------
+static ConfigServerObject_t* AddBootstrapInformationServer
+(
+    ConfigBootstrapFile_t*  bsConfigListPtr,            ///< [INOUT] Bootstrap information list
+    uint16_t                serverObjectInstanceId      ///< [IN] Server object instance Id
+)
+{
+    ConfigServerObject_t* serverInformationPtr;
+
+    serverInformationPtr = FindServerInstance(bsConfigListPtr, serverObjectInstanceId);
+    if (!serverInformationPtr)
+    {
+        serverInformationPtr = GetFreeServerSlot(bsConfigListPtr, serverObjectInstanceId);
+        if (!serverInformationPtr)
         {
-            tempPtr = tempPtr->nextPtr;
+            LOG_ARG("No slot for server object instance Id %d", serverObjectInstanceId);
+            return NULL;
         }
-        tempPtr->nextPtr = serverInformationPtr;
-        serverInformationPtr->nextPtr = NULL;
+        bsConfigListPtr->serverObjectNumber++;
     }
+
+    memset(serverInformationPtr, 0, sizeof(ConfigServerObject_t));
+    serverInformationPtr->data.serverObjectInstanceId = serverObjectInstanceId;
+    serverInformationPtr->isUsed = true;
+    return serverInformationPtr;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Function to save the bootstrap configuration in platform memory
+ * Function to save the bootstrap configuration in platform memory, in the version 3 format. The
+ * configuration is cached and only written by the next omanager_FlushParams() call.
  *
  * @return
  *      - true in case of success
@@ -406,76 +742,90 @@ static void AddBootstrapInformationServer
 //--------------------------------------------------------------------------------------------------
 static bool StoreBootstrapConfiguration
 (
-    ConfigBootstrapFile_t BsConfig              ///< [IN] Bootstrap configuration to store
+    ConfigBootstrapFile_t* bsConfigPtr          ///< [IN] Bootstrap configuration to store
 )
 {
     bool result = false;
     uint32_t lenToStore;
-    uint32_t lenWritten = 0;
-    uint32_t len = sizeof(lenToStore);
-    uint16_t loop = 0;
+    uint32_t lenWritten = BS_CONFIG_HEADER_LEN;
+    uint32_t crc;
+    uint16_t securityObjectNumber = 0;
+    uint16_t serverObjectNumber = 0;
+    uint16_t slot;
     uint8_t* dataPtr;
-    uint8_t* dataLenPtr;
 
-    ConfigSecurityObject_t* securityPtr = BsConfig.securityPtr;
-    ConfigServerObject_t* serverPtr = BsConfig.serverPtr;
+    lenToStore = BS_CONFIG_HEADER_LEN +
+                 BS_CONFIG_SECURITY_RECORD_LEN * bsConfigPtr->securityObjectNumber +
+                 BS_CONFIG_SERVER_RECORD_LEN * bsConfigPtr->serverObjectNumber +
+                 BS_CONFIG_CRC_LEN;
 
-    lenToStore = sizeof(BsConfig.version) +
-                 sizeof(BsConfig.securityObjectNumber) +
-                 sizeof(BsConfig.serverObjectNumber) +
-                 sizeof(ConfigSecurityToStore_t) * BsConfig.securityObjectNumber +
-                 sizeof(ConfigServerToStore_t) * BsConfig.serverObjectNumber;
-
-    dataPtr = (uint8_t*)lwm2m_malloc(lenToStore);
+    dataPtr = (uint8_t*)OMANAGER_MALLOC(lenToStore);
     if (!dataPtr)
     {
         return false;
     }
     memset(dataPtr, 0, lenToStore);
 
-    /* Copy the version */
-    memcpy(dataPtr + lenWritten, &(BsConfig.version), sizeof(BsConfig.version));
-    lenWritten += sizeof(BsConfig.version);
-
-    /* Copy the number of security objects and server objects */
-    memcpy(dataPtr + lenWritten,
-           &(BsConfig.securityObjectNumber),
-           sizeof(BsConfig.securityObjectNumber));
-    lenWritten += sizeof(BsConfig.securityObjectNumber);
+    /* Security object records */
+    for (slot = 0; slot < SecuritySlotNb(bsConfigPtr); slot++)
+    {
+        const ConfigSecurityObject_t* securityPtr = GetSecuritySlot(bsConfigPtr, slot);
+        uint8_t* recordPtr = dataPtr + lenWritten;
 
-    memcpy(dataPtr + lenWritten,
-           &(BsConfig.serverObjectNumber),
-           sizeof(BsConfig.serverObjectNumber));
-    lenWritten += sizeof(BsConfig.serverObjectNumber);
+        if (!securityPtr->isUsed)
+        {
+            continue;
+        }
 
-    /* Copy security objects data */
-    loop = BsConfig.securityObjectNumber;
-    while (loop && securityPtr)
-    {
-        memcpy(dataPtr + lenWritten, &(securityPtr->data), sizeof(ConfigSecurityToStore_t));
-        lenWritten += sizeof(ConfigSecurityToStore_t);
-        securityPtr = securityPtr->nextPtr;
-        loop--;
+        omanager_FormatUint16ToBytes(recordPtr, securityPtr->data.securityObjectInstanceId);
+        recordPtr[2] = securityPtr->data.isBootstrapServer ? 1 : 0;
+        recordPtr[3] = (uint8_t)securityPtr->data.securityMode;
+        omanager_FormatUint16ToBytes(recordPtr + 4, securityPtr->data.serverId);
+        omanager_FormatUint16ToBytes(recordPtr + 6, securityPtr->data.clientHoldOffTime);
+        omanager_FormatUint32ToBytes(recordPtr + 8, securityPtr->data.bootstrapAccountTimeout);
+        lenWritten += BS_CONFIG_SECURITY_RECORD_LEN;
+        securityObjectNumber++;
     }
 
-    /* Copy server objects data */
-    loop = BsConfig.serverObjectNumber;
-    while (loop && serverPtr)
+    /* Server object records */
+    for (slot = 0; slot < ServerSlotNb(bsConfigPtr); slot++)
     {
-        memcpy(dataPtr + lenWritten, &(serverPtr->data), sizeof(ConfigServerToStore_t));
-        lenWritten += sizeof(ConfigServerToStore_t);
-        serverPtr = serverPtr->nextPtr;
-        loop--;
+        const ConfigServerObject_t* serverPtr = GetServerSlot(bsConfigPtr, slot);
+        uint8_t* recordPtr = dataPtr + lenWritten;
+
+        if (!serverPtr->isUsed)
+        {
+            continue;
+        }
+
+        omanager_FormatUint16ToBytes(recordPtr, serverPtr->data.serverObjectInstanceId);
+        omanager_FormatUint16ToBytes(recordPtr + 2, serverPtr->data.serverId);
+        omanager_FormatUint32ToBytes(recordPtr + 4, serverPtr->data.lifetime);
+        omanager_FormatUint32ToBytes(recordPtr + 8, serverPtr->data.defaultPmin);
+        omanager_FormatUint32ToBytes(recordPtr + 12, serverPtr->data.defaultPmax);
+        omanager_FormatUint32ToBytes(recordPtr + 16, serverPtr->data.disableTimeout);
+        recordPtr[20] = serverPtr->data.isDisable ? 1 : 0;
+        recordPtr[21] = serverPtr->data.isNotifStored ? 1 : 0;
+        memcpy(recordPtr + 22, serverPtr->data.bindingMode, LWM2MCORE_BINDING_STR_MAX_LEN);
+        lenWritten += BS_CONFIG_SERVER_RECORD_LEN;
+        serverObjectNumber++;
     }
-    lwm2mcore_DataDump("BS config data", dataPtr, lenToStore);
-    dataLenPtr = (uint8_t*)&lenToStore;
 
-    if ( (LWM2MCORE_ERR_COMPLETED_OK == lwm2mcore_SetParam(LWM2MCORE_BOOTSTRAP_INFO_SIZE_PARAM,
-                                                           dataLenPtr,
-                                                           len))
-      && (LWM2MCORE_ERR_COMPLETED_OK == lwm2mcore_SetParam(LWM2MCORE_BOOTSTRAP_PARAM,
-                                                           dataPtr,
-                                                           lenToStore)))
+    /* Header with the number of written records, then CRC */
+    omanager_FormatUint32ToBytes(dataPtr, BS_CONFIG_VERSION_3);
+    omanager_FormatUint16ToBytes(dataPtr + 4, securityObjectNumber);
+    omanager_FormatUint16ToBytes(dataPtr + 6, serverObjectNumber);
+    crc = lwm2mcore_Crc32(0L, dataPtr, lenWritten);
+    omanager_FormatUint32ToBytes(dataPtr + lenWritten, crc);
+    lenWritten += BS_CONFIG_CRC_LEN;
+
+    lwm2mcore_DataDump("BS config data", dataPtr, lenWritten);
+
+    /* The configuration is written in platform memory by the next parameter flush */
+    if (LWM2MCORE_ERR_COMPLETED_OK == omanager_SetParam(LWM2MCORE_BOOTSTRAP_PARAM,
+                                                        dataPtr,
+                                                        lenWritten,
+                                                        true))
     {
         result = true;
     }
@@ -487,7 +837,8 @@ static bool StoreBootstrapConfiguration
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Function to free the bootstrap information list
+ * Function to free the bootstrap information list: the object instances and their credentials are
+ * cleared
  */
 //--------------------------------------------------------------------------------------------------
 static void FreeBootstrapInformation
@@ -495,28 +846,14 @@ static void FreeBootstrapInformation
     ConfigBootstrapFile_t* configPtr        ///< [INOUT] Configuration to free
 )
 {
-    ConfigSecurityObject_t* securityInformationPtr;
-    ConfigServerObject_t* serverInformationPtr;
-
-    /* Free bootstrap information list */
-    securityInformationPtr = configPtr->securityPtr;
-    while (NULL != securityInformationPtr)
+    if (configPtr->securityExtraPtr)
     {
-        ConfigSecurityObject_t* nextPtr = securityInformationPtr->nextPtr;
-        lwm2m_free(securityInformationPtr);
-        securityInformationPtr = nextPtr;
+        lwm2m_free(configPtr->securityExtraPtr);
     }
-    configPtr->securityPtr = NULL;
-
-    serverInformationPtr = configPtr->serverPtr;
-    while (NULL != serverInformationPtr)
+    if (configPtr->serverExtraPtr)
     {
-        ConfigServerObject_t* nextPtr = serverInformationPtr->nextPtr;
-        lwm2m_free(serverInformationPtr);
-        serverInformationPtr = nextPtr;
+        lwm2m_free(configPtr->serverExtraPtr);
     }
-    configPtr->serverPtr = NULL;
-
     memset(configPtr, 0, sizeof(ConfigBootstrapFile_t));
 }
 
@@ -535,34 +872,236 @@ static void SetDefaultBootstrapConfiguration
     LOG("Set default BS configuration");
 
     FreeBootstrapInformation(configPtr);
-    memset(configPtr, 0, sizeof(ConfigSecurityObject_t));
     configPtr->version = BS_CONFIG_VERSION;
 
-    /* Allocation security object for bootstrap server */
-    securityInformationPtr = (ConfigSecurityObject_t*)lwm2m_malloc(sizeof(ConfigSecurityObject_t));
-    LWM2MCORE_ASSERT(securityInformationPtr);
-    memset(securityInformationPtr, 0, sizeof(ConfigSecurityObject_t));
-    configPtr->securityObjectNumber = 1;
-    configPtr->serverObjectNumber = 0;
+    /* Object instance of object 0 for bootstrap is 0 */
+    securityInformationPtr = AddBootstrapInformationSecurity(configPtr, 0);
+    LWM2MCORE_ASSERT(securityInformationPtr);
+    securityInformationPtr->data.isBootstrapServer = true;
+    /* PSK support only */
+    securityInformationPtr->data.securityMode = SEC_PSK;
+
+    /* Default values */
+    securityInformationPtr->data.serverId = 1;
+    securityInformationPtr->data.clientHoldOffTime = 5;
+    securityInformationPtr->data.bootstrapAccountTimeout = 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function to get the version and the expected length of a stored bootstrap configuration from
+ * its first bytes
+ *
+ * @return
+ *      - expected length of the configuration
+ *      - 0 if the version is not supported or if the header is truncated
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t GetBootstrapConfigurationLen
+(
+    const uint8_t*  rawDataPtr,     ///< [IN] Stored configuration
+    size_t          len,            ///< [IN] Read length
+    uint32_t*       versionPtr      ///< [OUT] Configuration version
+)
+{
+    uint32_t hostVersion;
+    uint16_t securityObjectNumber;
+    uint16_t serverObjectNumber;
+
+    *versionPtr = 0;
+    if (len < BS_CONFIG_HEADER_LEN)
+    {
+        return 0;
+    }
+
+    if (BS_CONFIG_VERSION_3 == omanager_BytesToUint32(rawDataPtr))
+    {
+        *versionPtr = BS_CONFIG_VERSION_3;
+        return BS_CONFIG_HEADER_LEN +
+               BS_CONFIG_SECURITY_RECORD_LEN * omanager_BytesToUint16(rawDataPtr + 4) +
+               BS_CONFIG_SERVER_RECORD_LEN * omanager_BytesToUint16(rawDataPtr + 6) +
+               BS_CONFIG_CRC_LEN;
+    }
+
+    /* Previous versions: raw structures in host byte order */
+    memcpy(&hostVersion, rawDataPtr, sizeof(hostVersion));
+    switch (hostVersion)
+    {
+        case BS_CONFIG_VERSION_2:
+            *versionPtr = BS_CONFIG_VERSION_2;
+            memcpy(&securityObjectNumber, rawDataPtr + 4, sizeof(securityObjectNumber));
+            memcpy(&serverObjectNumber, rawDataPtr + 6, sizeof(serverObjectNumber));
+            return sizeof(hostVersion) +
+                   sizeof(securityObjectNumber) +
+                   sizeof(serverObjectNumber) +
+                   sizeof(ConfigSecurityToStore_t) * securityObjectNumber +
+                   sizeof(ConfigServerToStore_t) * serverObjectNumber;
+
+        case BS_CONFIG_VERSION_1:
+            *versionPtr = BS_CONFIG_VERSION_1;
+            return sizeof(ConfigBootstrapFileV01_t);
+
+        default:
+            return 0;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function to decode a bootstrap configuration stored in the version 3 format
+ *
+ * @return
+ *      - true in case of success
+ *      - false if the configuration is corrupted
+ */
+//--------------------------------------------------------------------------------------------------
+static bool DecodeBootstrapConfiguration
+(
+    ConfigBootstrapFile_t*  configPtr,      ///< [OUT] Bootstrap configuration
+    uint8_t*                rawDataPtr,     ///< [IN] Stored configuration
+    size_t                  len             ///< [IN] Stored configuration length
+)
+{
+    uint16_t securityObjectNumber = omanager_BytesToUint16(rawDataPtr + 4);
+    uint16_t serverObjectNumber = omanager_BytesToUint16(rawDataPtr + 6);
+    uint32_t lenRead = BS_CONFIG_HEADER_LEN;
+    uint32_t crc;
+    uint16_t loop;
+
+    crc = lwm2mcore_Crc32(0L, rawDataPtr, len - BS_CONFIG_CRC_LEN);
+    if (crc != omanager_BytesToUint32(rawDataPtr + len - BS_CONFIG_CRC_LEN))
+    {
+        LOG("Bad BS configuration CRC");
+        return false;
+    }
+
+    configPtr->version = BS_CONFIG_VERSION_3;
+
+    /* Security object records */
+    for (loop = 0; loop < securityObjectNumber; loop++)
+    {
+        const uint8_t* recordPtr = rawDataPtr + lenRead;
+        ConfigSecurityObject_t* securityPtr;
+
+        lenRead += BS_CONFIG_SECURITY_RECORD_LEN;
+        if (FindSecurityInstance(configPtr, omanager_BytesToUint16(recordPtr)))
+        {
+            continue;
+        }
+
+        securityPtr = AddBootstrapInformationSecurity(configPtr, omanager_BytesToUint16(recordPtr));
+        if (!securityPtr)
+        {
+            continue;
+        }
+        securityPtr->data.isBootstrapServer = (0 != recordPtr[2]);
+        securityPtr->data.securityMode = (SecurityMode_t)recordPtr[3];
+        securityPtr->data.serverId = omanager_BytesToUint16(recordPtr + 4);
+        securityPtr->data.clientHoldOffTime = omanager_BytesToUint16(recordPtr + 6);
+        securityPtr->data.bootstrapAccountTimeout = omanager_BytesToUint32(recordPtr + 8);
+    }
+
+    /* Server object records */
+    for (loop = 0; loop < serverObjectNumber; loop++)
+    {
+        const uint8_t* recordPtr = rawDataPtr + lenRead;
+        ConfigServerObject_t* serverPtr;
+
+        lenRead += BS_CONFIG_SERVER_RECORD_LEN;
+        if (FindServerInstance(configPtr, omanager_BytesToUint16(recordPtr)))
+        {
+            continue;
+        }
+
+        serverPtr = AddBootstrapInformationServer(configPtr, omanager_BytesToUint16(recordPtr));
+        if (!serverPtr)
+        {
+            continue;
+        }
+        serverPtr->data.serverId = omanager_BytesToUint16(recordPtr + 2);
+        serverPtr->data.lifetime = omanager_BytesToUint32(recordPtr + 4);
+        serverPtr->data.defaultPmin = omanager_BytesToUint32(recordPtr + 8);
+        serverPtr->data.defaultPmax = omanager_BytesToUint32(recordPtr + 12);
+        serverPtr->data.disableTimeout = omanager_BytesToUint32(recordPtr + 16);
+        serverPtr->data.isDisable = (0 != recordPtr[20]);
+        serverPtr->data.isNotifStored = (0 != recordPtr[21]);
+        memcpy(serverPtr->data.bindingMode, recordPtr + 22, LWM2MCORE_BINDING_STR_MAX_LEN);
+    }
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function to decode a bootstrap configuration stored in the version 2 format (raw structures)
+ */
+//--------------------------------------------------------------------------------------------------
+static void DecodeBootstrapConfigurationV02
+(
+    ConfigBootstrapFile_t*  configPtr,      ///< [OUT] Bootstrap configuration
+    const uint8_t*          rawDataPtr      ///< [IN] Stored configuration
+)
+{
+    uint32_t lenRead = 0;
+    uint16_t securityObjectNumber;
+    uint16_t serverObjectNumber;
+    uint16_t loop;
+
+    /* Skip the version, get the number of security objects and server objects */
+    lenRead += sizeof(configPtr->version);
+    memcpy(&securityObjectNumber, rawDataPtr + lenRead, sizeof(securityObjectNumber));
+    lenRead += sizeof(securityObjectNumber);
+    memcpy(&serverObjectNumber, rawDataPtr + lenRead, sizeof(serverObjectNumber));
+    lenRead += sizeof(serverObjectNumber);
+
+    configPtr->version = BS_CONFIG_VERSION;
+
+    /* Copy the security objects data */
+    for (loop = 0; loop < securityObjectNumber; loop++)
+    {
+        ConfigSecurityToStore_t security;
+        ConfigSecurityObject_t* securityPtr;
+
+        memcpy(&security, rawDataPtr + lenRead, sizeof(ConfigSecurityToStore_t));
+        lenRead += sizeof(ConfigSecurityToStore_t);
+
+        /* Check if the security object instance Id is already stored */
+        if (FindSecurityInstance(configPtr, security.securityObjectInstanceId))
+        {
+            continue;
+        }
+        securityPtr = AddBootstrapInformationSecurity(configPtr, security.securityObjectInstanceId);
+        if (securityPtr)
+        {
+            securityPtr->data = security;
+        }
+    }
 
-    /* Object instance of object 0 for bootstrap is 0 */
-    securityInformationPtr->data.securityObjectInstanceId = 0;
-    securityInformationPtr->data.isBootstrapServer = true;
-    /* PSK support only */
-    securityInformationPtr->data.securityMode = SEC_PSK;
+    /* Copy the server objects data */
+    for (loop = 0; loop < serverObjectNumber; loop++)
+    {
+        ConfigServerToStore_t server;
+        ConfigServerObject_t* serverPtr;
 
-    /* Default values */
-    securityInformationPtr->data.serverId = 1;
-    securityInformationPtr->data.clientHoldOffTime = 5;
-    securityInformationPtr->data.bootstrapAccountTimeout = 0;
+        memcpy(&server, rawDataPtr + lenRead, sizeof(ConfigServerToStore_t));
+        lenRead += sizeof(ConfigServerToStore_t);
 
-    /* Add the security object on the bootstrap configuration list */
-    AddBootstrapInformationSecurity(configPtr, securityInformationPtr);
+        /* Check if the server object instance Id is already stored */
+        if (FindServerInstance(configPtr, server.serverObjectInstanceId))
+        {
+            continue;
+        }
+        serverPtr = AddBootstrapInformationServer(configPtr, server.serverObjectInstanceId);
+        if (serverPtr)
+        {
+            serverPtr->data = server;
+        }
+    }
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Function to adapt bootstrap configuration file from previous version (v1) to current one (v2)
+ * Function to adapt bootstrap configuration file from version 1 to current one
  *
  * @return
  *      - true in case of success
@@ -571,22 +1110,21 @@ static void SetDefaultBootstrapConfiguration
 //--------------------------------------------------------------------------------------------------
 static bool BootstrapConfigurationAdaptation
 (
-    void
+    ConfigBootstrapFile_t*  configPtr,      ///< [OUT] Bootstrap configuration
+    const uint8_t*          rawDataPtr,     ///< [IN] Stored configuration
+    size_t                  len             ///< [IN] Stored configuration length
 )
 {
-    lwm2mcore_Sid_t sid;
     ConfigBootstrapFileV01_t bsConfig;
-    size_t len = sizeof(ConfigBootstrapFileV01_t);
 
     LOG("Adapt bootstrap configuration");
 
-    /* Check if the LwM2MCore configuration file is stored */
-    sid = lwm2mcore_GetParam(LWM2MCORE_BOOTSTRAP_PARAM, (uint8_t*)&bsConfig, &len);
-    if (LWM2MCORE_ERR_COMPLETED_OK != sid)
+    if (sizeof(ConfigBootstrapFileV01_t) > len)
     {
         LOG("No bootstrap configuration");
         return false;
     }
+    memcpy(&bsConfig, rawDataPtr, sizeof(ConfigBootstrapFileV01_t));
 
     if (BS_CONFIG_VERSION_1 == bsConfig.version)
     {
@@ -596,54 +1134,34 @@ static bool BootstrapConfigurationAdaptation
          */
         if (lwm2mcore_CheckCredential(LWM2MCORE_CREDENTIAL_DM_ADDRESS, LWM2MCORE_NO_SERVER_ID))
         {
-            /* Adapt BS configuration file v1 to v2 */
+            /* Adapt BS configuration file v1 to current version */
             ConfigSecurityObject_t* securityInformationPtr;
             ConfigServerObject_t* serverInformationPtr;
             LOG("DM credentials are present");
 
-            BsConfigList.version = BS_CONFIG_VERSION;
-            BsConfigList.securityObjectNumber = 2;
-            BsConfigList.serverObjectNumber = 1;
+            configPtr->version = BS_CONFIG_VERSION;
 
-            /* Allocation security object for bootstrap server */
-            securityInformationPtr = (ConfigSecurityObject_t*)
-                                     lwm2m_malloc(sizeof(ConfigSecurityObject_t));
+            /* Security object for bootstrap server */
+            securityInformationPtr = AddBootstrapInformationSecurity(configPtr, 0);
             LWM2MCORE_ASSERT(securityInformationPtr);
-            memset(securityInformationPtr, 0, sizeof(ConfigSecurityObject_t));
-
-            securityInformationPtr->data.securityObjectInstanceId = 0;
             securityInformationPtr->data.bootstrapAccountTimeout = bsConfig.security[0].bootstrapAccountTimeout;
             securityInformationPtr->data.clientHoldOffTime = bsConfig.security[0].clientHoldOffTime;
             securityInformationPtr->data.isBootstrapServer = bsConfig.security[0].isBootstrapServer;
             securityInformationPtr->data.securityMode = bsConfig.security[0].securityMode;
             securityInformationPtr->data.serverId = bsConfig.security[0].serverId;
 
-            /* Add the security object on the bootstrap configuration list */
-            AddBootstrapInformationSecurity(&BsConfigList, securityInformationPtr);
-
-            /* Allocation security object for DM server */
-            securityInformationPtr = (ConfigSecurityObject_t*)
-                                     lwm2m_malloc(sizeof(ConfigSecurityObject_t));
+            /* Security object for DM server */
+            securityInformationPtr = AddBootstrapInformationSecurity(configPtr, 1);
             LWM2MCORE_ASSERT(securityInformationPtr);
-            memset(securityInformationPtr, 0, sizeof(ConfigSecurityObject_t));
-
-            securityInformationPtr->data.securityObjectInstanceId = 1;
             securityInformationPtr->data.bootstrapAccountTimeout = bsConfig.security[1].bootstrapAccountTimeout;
             securityInformationPtr->data.clientHoldOffTime = bsConfig.security[1].clientHoldOffTime;
             securityInformationPtr->data.isBootstrapServer = bsConfig.security[1].isBootstrapServer;
             securityInformationPtr->data.securityMode = bsConfig.security[1].securityMode;
             securityInformationPtr->data.serverId = bsConfig.security[1].serverId;
 
-            /* Add the security object on the bootstrap configuration list */
-            AddBootstrapInformationSecurity(&BsConfigList, securityInformationPtr);
-
-            /* Allocation server object for DM server */
-            serverInformationPtr = (ConfigServerObject_t*)
-                                   lwm2m_malloc(sizeof(ConfigServerObject_t));
+            /* Server object for DM server */
+            serverInformationPtr = AddBootstrapInformationServer(configPtr, 0);
             LWM2MCORE_ASSERT(serverInformationPtr);
-            memset(serverInformationPtr, 0, sizeof(ConfigServerObject_t));
-
-            serverInformationPtr->data.serverObjectInstanceId = 0;
             serverInformationPtr->data.serverId = bsConfig.server.serverId;
             serverInformationPtr->data.lifetime = bsConfig.server.lifetime;
             serverInformationPtr->data.defaultPmin = bsConfig.server.defaultPmin;
@@ -655,9 +1173,6 @@ static bool BootstrapConfigurationAdaptation
                    bsConfig.server.bindingMode,
                    LWM2MCORE_BINDING_STR_MAX_LEN);
 
-            /* Add the security object on the bootstrap configuration list */
-            AddBootstrapInformationServer(&BsConfigList, serverInformationPtr);
-
             return true;
         }
         /* Else consider that no connection was made to bootstrap */
@@ -671,6 +1186,10 @@ static bool BootstrapConfigurationAdaptation
 /**
  * Function to read the bootstrap configuration from platform memory
  *
+ * The configuration is read with a single parameter read in a stack buffer, a second read being
+ * only needed if the configuration is longer than BS_CONFIG_READ_LEN. A configuration stored in the
+ * version 2 format is converted in the current format.
+ *
  * @return
  *      - true in case of success
  *      - false in case of failure
@@ -684,142 +1203,74 @@ static bool GetBootstrapConfiguration
 )
 {
     lwm2mcore_Sid_t sid;
-    uint32_t lenWritten = 0;
-    uint32_t loop;
-    uint32_t fileSize = 0;
-    uint32_t fileReadSize = 0;
-    size_t len = sizeof(fileSize);
-    uint8_t* dataPtr = (uint8_t*)configPtr;
-    ConfigSecurityObject_t*     securityPtr;
-    ConfigServerObject_t*       serverPtr;
-    uint8_t* rawData;
+    uint8_t buffer[BS_CONFIG_READ_LEN];
+    uint8_t* rawDataPtr = buffer;
+    size_t len = sizeof(buffer);
+    size_t expectedLen = 0;
+    uint32_t version = 0;
+    bool isDecoded = false;
 
     /* Free the configuration */
     FreeBootstrapInformation(configPtr);
 
-    /* Get the bootstrap information file size */
-    sid = lwm2mcore_GetParam(LWM2MCORE_BOOTSTRAP_INFO_SIZE_PARAM, (uint8_t*)&fileSize, &len);
-    LOG_ARG("Get BS configuration size: %d result %d, len %d", fileSize, sid, len);
-    if (LWM2MCORE_ERR_COMPLETED_OK != sid)
+    /* Get the bootstrap information file */
+    sid = omanager_GetParam(LWM2MCORE_BOOTSTRAP_PARAM, buffer, &len);
+    if (LWM2MCORE_ERR_COMPLETED_OK == sid)
     {
-        if (false == BootstrapConfigurationAdaptation())
-        {
-            /* Set a default configuration */
-            SetDefaultBootstrapConfiguration(configPtr);
-        }
-
-        /* Store the configuration */
-        if (storage)
+        expectedLen = GetBootstrapConfigurationLen(buffer, len, &version);
+        if ((expectedLen > len) && (sizeof(buffer) == len))
         {
-            StoreBootstrapConfiguration(*configPtr);
+            /* Configuration longer than the read buffer: read it again */
+            rawDataPtr = (uint8_t*)OMANAGER_MALLOC(expectedLen);
+            LWM2MCORE_ASSERT(rawDataPtr);
+            len = expectedLen;
+            sid = omanager_GetParam(LWM2MCORE_BOOTSTRAP_PARAM, rawDataPtr, &len);
         }
-        return false;
     }
-
-    rawData = (uint8_t*)lwm2m_malloc(fileSize);
-    LWM2MCORE_ASSERT(rawData);
-    fileReadSize = fileSize;
-    /* Get the bootstrap information file */
-    sid = lwm2mcore_GetParam(LWM2MCORE_BOOTSTRAP_PARAM, rawData, (size_t*)((void*)&fileReadSize));
-    LOG_ARG("Read BS configuration: fileReadSize %d result %d", fileReadSize, sid);
+    LOG_ARG("Read BS configuration: version %d len %d result %d", version, len, sid);
 
     if (LWM2MCORE_ERR_COMPLETED_OK != sid)
     {
-        if (false == BootstrapConfigurationAdaptation())
-        {
-            /* Set a default configuration */
-            SetDefaultBootstrapConfiguration(configPtr);
-        }
-        /* Store the configuration */
-        if (storage)
-        {
-            StoreBootstrapConfiguration(*configPtr);
-        }
-        return false;
+        len = 0;
     }
-
-    if (fileReadSize != fileSize)
+    else if ((BS_CONFIG_VERSION_3 == version) && (expectedLen == len))
     {
-        LOG("Not same BS configuration file size");
-        lwm2m_free(rawData);
-        lwm2mcore_DeleteParam(LWM2MCORE_BOOTSTRAP_PARAM);
-        lwm2mcore_DeleteParam(LWM2MCORE_BOOTSTRAP_INFO_SIZE_PARAM);
-
-        /* Set a default configuration */
-        SetDefaultBootstrapConfiguration(configPtr);
+        isDecoded = DecodeBootstrapConfiguration(configPtr, rawDataPtr, len);
+    }
+    else if ((BS_CONFIG_VERSION_2 == version) && (expectedLen == len))
+    {
+        DecodeBootstrapConfigurationV02(configPtr, rawDataPtr);
+        isDecoded = true;
 
-        /* Store the configuration */
+        /* Convert the configuration in the current format */
+        omanager_DeleteParam(LWM2MCORE_BOOTSTRAP_INFO_SIZE_PARAM);
         if (storage)
         {
-            StoreBootstrapConfiguration(*configPtr);
+            StoreBootstrapConfiguration(configPtr);
         }
-        return false;
     }
-
-    if (LWM2MCORE_ERR_COMPLETED_OK != sid)
+    else if ((BS_CONFIG_VERSION_1 == version)
+          && (BootstrapConfigurationAdaptation(configPtr, rawDataPtr, len)))
     {
-        lwm2m_free(rawData);
-        /* Set a default configuration */
-        SetDefaultBootstrapConfiguration(configPtr);
+        if (rawDataPtr != buffer)
+        {
+            lwm2m_free(rawDataPtr);
+        }
 
         /* Store the configuration */
         if (storage)
         {
-            StoreBootstrapConfiguration(*configPtr);
+            StoreBootstrapConfiguration(configPtr);
         }
-
         return false;
     }
 
-    /* Copy the version */
-    memcpy(dataPtr + lenWritten, rawData + lenWritten, sizeof(configPtr->version));
-    lenWritten += sizeof(configPtr->version);
-
-    /* Copy the number of security objects and server objects */
-    memcpy(dataPtr + lenWritten, rawData + lenWritten, sizeof(configPtr->securityObjectNumber));
-    lenWritten += sizeof(configPtr->securityObjectNumber);
-    memcpy(dataPtr + lenWritten, rawData + lenWritten, sizeof(configPtr->serverObjectNumber));
-    lenWritten += sizeof(configPtr->serverObjectNumber);
-
-    /* Allocate security objects and copy related data */
-    for (loop = 0; loop < configPtr->securityObjectNumber; loop++)
-    {
-        securityPtr = (ConfigSecurityObject_t*)lwm2m_malloc(sizeof(ConfigSecurityObject_t));
-        if (securityPtr)
-        {
-            memset(securityPtr, 0, sizeof(ConfigSecurityObject_t));
-            memcpy(securityPtr, rawData + lenWritten, sizeof(ConfigSecurityToStore_t));
-            lenWritten += sizeof(ConfigSecurityToStore_t);
-
-            /* Check if the security object instance Id is already stored */
-            if (NULL == FindSecurityInstance(*configPtr, securityPtr->data.securityObjectInstanceId))
-            {
-                AddBootstrapInformationSecurity(configPtr, securityPtr);
-            }
-        }
-    }
-
-    /* Allocate server objects and copy related data */
-    for (loop = 0; loop < configPtr->serverObjectNumber; loop++)
+    if (rawDataPtr != buffer)
     {
-        serverPtr = (ConfigServerObject_t*)lwm2m_malloc(sizeof(ConfigServerObject_t));
-        if (serverPtr)
-        {
-            memset(serverPtr, 0, sizeof(ConfigServerObject_t));
-            memcpy(serverPtr, rawData + lenWritten, sizeof(ConfigServerToStore_t));
-            lenWritten += sizeof(ConfigServerToStore_t);
-
-            /* Check if the server object instance Id is already stored */
-            if (NULL == FindServerInstance(*configPtr, serverPtr->data.serverObjectInstanceId))
-            {
-                AddBootstrapInformationServer(configPtr, serverPtr);
-            }
-        }
+        lwm2m_free(rawDataPtr);
     }
 
-    lwm2m_free(rawData);
-
-    if (BS_CONFIG_VERSION == configPtr->version)
+    if (isDecoded)
     {
         return true;
     }
@@ -832,13 +1283,13 @@ static bool GetBootstrapConfiguration
          * Delete it
          */
         LOG("Delete bootstrap configuration");
-        sid = lwm2mcore_DeleteParam(LWM2MCORE_BOOTSTRAP_PARAM);
+        sid = omanager_DeleteParam(LWM2MCORE_BOOTSTRAP_PARAM);
         if (LWM2MCORE_ERR_COMPLETED_OK != sid)
         {
             LOG("Error to delete BS configuration parameter");
         }
 
-        sid = lwm2mcore_DeleteParam(LWM2MCORE_BOOTSTRAP_INFO_SIZE_PARAM);
+        sid = omanager_DeleteParam(LWM2MCORE_BOOTSTRAP_INFO_SIZE_PARAM);
         if (LWM2MCORE_ERR_COMPLETED_OK != sid)
         {
             LOG("Error to delete BS configuration size parameter");
@@ -851,7 +1302,7 @@ static bool GetBootstrapConfiguration
     /* Store the configuration */
     if (storage)
     {
-        StoreBootstrapConfiguration(*configPtr);
+        StoreBootstrapConfiguration(configPtr);
     }
 
     return false;
@@ -890,7 +1341,7 @@ lwm2mcore_Sid_t omanager_SetLifetime
     bool        storage     ///< [IN] Indicates if the configuration needs to be stored
 )
 {
-    ConfigServerObject_t* serverInformationPtr = BsConfigList.serverPtr;
+    uint16_t slot;
     LOG_ARG("omanager_SetLifetime %d sec", lifetime);
 
     if (lwm2mcore_CheckLifetimeLimit(lifetime) != true)
@@ -906,8 +1357,7 @@ lwm2mcore_Sid_t omanager_SetLifetime
         /* Load configuration */
         GetBootstrapConfiguration(&BsConfigList, false);
 
-        serverInformationPtr = BsConfigList.serverPtr;
-        if (!serverInformationPtr)
+        if (!BsConfigList.serverObjectNumber)
         {
             /* No DM server configuration */
             LOG("No DM server configuration");
@@ -915,10 +1365,12 @@ lwm2mcore_Sid_t omanager_SetLifetime
         }
 
         /* Set lifetime for all servers */
-        while (serverInformationPtr)
+        for (slot = 0; slot < ServerSlotNb(&BsConfigList); slot++)
         {
-            serverInformationPtr->data.lifetime = lifetime;
-            serverInformationPtr = serverInformationPtr->nextPtr;
+            if (GetServerSlot(&BsConfigList, slot)->isUsed)
+            {
+                GetServerSlot(&BsConfigList, slot)->data.lifetime = lifetime;
+            }
         }
 
         if (false == storage)
@@ -927,14 +1379,16 @@ lwm2mcore_Sid_t omanager_SetLifetime
         }
 
         /* Save bootstrap configuration */
-        if (StoreBootstrapConfiguration(BsConfigList))
+        if (   (StoreBootstrapConfiguration(&BsConfigList))
+            && (LWM2MCORE_ERR_COMPLETED_OK == omanager_FlushParams())
+           )
         {
             return LWM2MCORE_ERR_COMPLETED_OK;
         }
     }
     else
     {
-        if (!serverInformationPtr)
+        if (!BsConfigList.serverObjectNumber)
         {
             /* No DM server configuration */
             LOG("No DM server configuration");
@@ -942,10 +1396,12 @@ lwm2mcore_Sid_t omanager_SetLifetime
         }
 
         /* Set lifetime for all servers */
-        while (serverInformationPtr)
+        for (slot = 0; slot < ServerSlotNb(&BsConfigList); slot++)
         {
-            serverInformationPtr->data.lifetime = lifetime;
-            serverInformationPtr = serverInformationPtr->nextPtr;
+            if (GetServerSlot(&BsConfigList, slot)->isUsed)
+            {
+                GetServerSlot(&BsConfigList, slot)->data.lifetime = lifetime;
+            }
         }
 
         if (false == storage)
@@ -953,7 +1409,9 @@ lwm2mcore_Sid_t omanager_SetLifetime
             return LWM2MCORE_ERR_COMPLETED_OK;
         }
         /* Save bootstrap configuration */
-        if (StoreBootstrapConfiguration(BsConfigList))
+        if (   (StoreBootstrapConfiguration(&BsConfigList))
+            && (LWM2MCORE_ERR_COMPLETED_OK == omanager_FlushParams())
+           )
         {
             return LWM2MCORE_ERR_COMPLETED_OK;
         }
@@ -978,21 +1436,24 @@ lwm2mcore_Sid_t omanager_GetLifetime
     uint32_t* lifetimePtr                 ///< [OUT] lifetime in seconds
 )
 {
+    ConfigServerObject_t* serverInformationPtr;
+
     if (!(BsConfigList.version) || (BS_CONFIG_VERSION != (BsConfigList.version)))
     {
         memset(&BsConfigList, 0, sizeof(BsConfigList));
         GetBootstrapConfiguration(&BsConfigList, true);
-        if (!BsConfigList.serverPtr)
+        serverInformationPtr = GetFirstServerInstance(&BsConfigList);
+        if (!serverInformationPtr)
         {
             /* No DM server configuration */
             LOG("No DM server configuration");
             return LWM2MCORE_ERR_INVALID_STATE;
         }
-        *lifetimePtr = BsConfigList.serverPtr->data.lifetime;
+        *lifetimePtr = serverInformationPtr->data.lifetime;
     }
     else
     {
-        ConfigServerObject_t* serverInformationPtr = BsConfigList.serverPtr;
+        serverInformationPtr = GetFirstServerInstance(&BsConfigList);
         if (!serverInformationPtr)
         {
             /* No DM server configuration */
@@ -1009,6 +1470,60 @@ lwm2mcore_Sid_t omanager_GetLifetime
     return LWM2MCORE_ERR_COMPLETED_OK;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if the binding of the Device Management server is UDP with queue mode
+ *
+ * @return
+ *      - true if the binding is LWM2MCORE_BINDING_UDP_QUEUE
+ *      - false otherwise, or if no device management server is configured
+ */
+//--------------------------------------------------------------------------------------------------
+bool omanager_IsQueueModeBinding
+(
+    void
+)
+{
+    ConfigServerObject_t* serverInformationPtr = GetFirstServerInstance(&BsConfigList);
+
+    if (!serverInformationPtr)
+    {
+        return false;
+    }
+
+    return (0 == strncmp((const char*)serverInformationPtr->data.bindingMode,
+                         LWM2MCORE_BINDING_UDP_QUEUE,
+                         LWM2MCORE_BINDING_STR_MAX_LEN));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Retrieve the default minimum and maximum periods of the observations from the server
+ * configuration
+ *
+ * @return
+ *      - true if the periods are retrieved
+ *      - false if no device management server is configured
+ */
+//--------------------------------------------------------------------------------------------------
+bool omanager_GetDefaultPeriods
+(
+    uint32_t* pminPtr,                  ///< [OUT] Default minimum period in seconds
+    uint32_t* pmaxPtr                   ///< [OUT] Default maximum period in seconds, 0 if not set
+)
+{
+    ConfigServerObject_t* serverInformationPtr = GetFirstServerInstance(&BsConfigList);
+
+    if (!serverInformationPtr)
+    {
+        return false;
+    }
+
+    *pminPtr = serverInformationPtr->data.defaultPmin;
+    *pmaxPtr = serverInformationPtr->data.defaultPmax;
+    return true;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  *                                  OBJECT 0: SECURITY
@@ -1053,19 +1568,15 @@ int omanager_WriteSecurityObj
         return LWM2MCORE_ERR_OP_NOT_SUPPORTED;
     }
 
-    securityInformationPtr = FindSecurityInstance(BsConfigList, uriPtr->oiid);
+    securityInformationPtr = FindSecurityInstance(&BsConfigList, uriPtr->oiid);
     if (!securityInformationPtr)
     {
-        /* Create new securityInformationPtr */
-        securityInformationPtr =
-                            (ConfigSecurityObject_t*)lwm2m_malloc(sizeof(ConfigSecurityObject_t));
-        LWM2MCORE_ASSERT(securityInformationPtr);
-        memset(securityInformationPtr, 0, sizeof(ConfigSecurityObject_t));
-        BsConfigList.securityObjectNumber++;
-
-        /* Set the security object instance Id */
-        securityInformationPtr->data.securityObjectInstanceId = uriPtr->oiid;
-        AddBootstrapInformationSecurity(&BsConfigList, securityInformationPtr);
+        /* Create a new object instance */
+        securityInformationPtr = AddBootstrapInformationSecurity(&BsConfigList, uriPtr->oiid);
+        if (!securityInformationPtr)
+        {
+            return LWM2MCORE_ERR_INCORRECT_RANGE;
+        }
     }
 
     switch (uriPtr->rid)
@@ -1232,7 +1743,7 @@ int omanager_ReadSecurityObj
         return LWM2MCORE_ERR_OP_NOT_SUPPORTED;
     }
 
-    securityInformationPtr = FindSecurityInstance(BsConfigList, uriPtr->oiid);
+    securityInformationPtr = FindSecurityInstance(&BsConfigList, uriPtr->oiid);
     if (!securityInformationPtr)
     {
         return LWM2MCORE_ERR_INCORRECT_RANGE;
@@ -1395,11 +1906,17 @@ bool omanager_StoreCredentials
 {
     bool result = false;
     int storageResult = LWM2MCORE_ERR_COMPLETED_OK;
+    uint16_t slot;
 
-    ConfigSecurityObject_t* securityInformationPtr = BsConfigList.securityPtr;
-
-    while (securityInformationPtr)
+    for (slot = 0; slot < SecuritySlotNb(&BsConfigList); slot++)
     {
+        ConfigSecurityObject_t* securityInformationPtr = GetSecuritySlot(&BsConfigList, slot);
+
+        if (!securityInformationPtr->isUsed)
+        {
+            continue;
+        }
+
         if (securityInformationPtr->data.isBootstrapServer)
         {
             LOG_ARG("Bootstrap: PskIdLen %d PskLen %d Addr len %d",
@@ -1471,8 +1988,6 @@ bool omanager_StoreCredentials
                         securityInformationPtr->data.serverId, storageResult);
             }
         }
-
-        securityInformationPtr = securityInformationPtr->nextPtr;
     }
 
     if (LWM2MCORE_ERR_COMPLETED_OK == storageResult)
@@ -1481,8 +1996,12 @@ bool omanager_StoreCredentials
     }
     LOG_ARG("credentials storage: %d", result);
 
-    /* Set the bootstrap configuration */
-    StoreBootstrapConfiguration(BsConfigList);
+    /* Set the bootstrap configuration: end of bootstrap, write it in platform memory */
+    StoreBootstrapConfiguration(&BsConfigList);
+    if (LWM2MCORE_ERR_COMPLETED_OK != omanager_FlushParams())
+    {
+        result = false;
+    }
     return result;
 }
 
@@ -1573,17 +2092,15 @@ int omanager_WriteServerObj
         return LWM2MCORE_ERR_OP_NOT_SUPPORTED;
     }
 
-    serverInformationPtr = FindServerInstance(BsConfigList, uriPtr->oiid);
+    serverInformationPtr = FindServerInstance(&BsConfigList, uriPtr->oiid);
     if (!serverInformationPtr)
     {
-        /* Create new serverInformationPtr */
-        serverInformationPtr = (ConfigServerObject_t*)lwm2m_malloc(sizeof(ConfigServerObject_t));
-        LWM2MCORE_ASSERT(serverInformationPtr);
-        memset(serverInformationPtr, 0, sizeof(ConfigServerObject_t));
-        BsConfigList.serverObjectNumber++;
-
-        serverInformationPtr->data.serverObjectInstanceId = uriPtr->oiid;
-        AddBootstrapInformationServer(&BsConfigList, serverInformationPtr);
+        /* Create a new object instance */
+        serverInformationPtr = AddBootstrapInformationServer(&BsConfigList, uriPtr->oiid);
+        if (!serverInformationPtr)
+        {
+            return LWM2MCORE_ERR_INCORRECT_RANGE;
+        }
     }
 
     switch (uriPtr->rid)
@@ -1660,7 +2177,7 @@ int omanager_WriteServerObj
      */
     if (false == smanager_IsBootstrapConnection())
     {
-        StoreBootstrapConfiguration(BsConfigList);
+        StoreBootstrapConfiguration(&BsConfigList);
     }
 
     return sID;
@@ -1708,7 +2225,7 @@ int omanager_ReadServerObj
         return LWM2MCORE_ERR_OP_NOT_SUPPORTED;
     }
 
-    serverInformationPtr = FindServerInstance(BsConfigList, uriPtr->oiid);
+    serverInformationPtr = FindServerInstance(&BsConfigList, uriPtr->oiid);
     if (!serverInformationPtr)
     {
         LOG("serverInformationPtr NULL");
@@ -2471,6 +2988,79 @@ int omanager_WriteFwUpdateObj
     return sID;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function to write a part of the package pushed by the server, for a streamed write
+ * Object: 5 - Firmware update
+ * Resource: 0 - Package
+ *
+ * @return
+ *      - LWM2MCORE_ERR_COMPLETED_OK if the part is written
+ *      - LWM2MCORE_ERR_GENERAL_ERROR if the package downloader rejects the part
+ *      - LWM2MCORE_ERR_INCORRECT_RANGE if the resource is not the package
+ *      - LWM2MCORE_ERR_INVALID_ARG if a parameter is invalid
+ *      - LWM2MCORE_ERR_OP_NOT_SUPPORTED if the operation is not supported
+ *      - other error codes of lwm2mcore_PushUpdatePackage
+ */
+//--------------------------------------------------------------------------------------------------
+int omanager_StreamWriteFwUpdatePackage
+(
+    lwm2mcore_Uri_t* uriPtr,            ///< [IN] uri represents the requested operation and
+                                        ///< object/resource
+    size_t offset,                      ///< [IN] offset of the part in the package
+    char* bufferPtr,                    ///< [IN] part of the package
+    size_t len,                         ///< [IN] length of the part
+    bool isLast                         ///< [IN] the part is the last one of the package
+)
+{
+    int sID;
+
+    if ((NULL == uriPtr) || ((NULL == bufferPtr) && (0 != len)))
+    {
+        return LWM2MCORE_ERR_INVALID_ARG;
+    }
+
+    /* Only one object instance */
+    if ((0 < uriPtr->oiid) || (LWM2MCORE_FW_UPDATE_PACKAGE_RID != uriPtr->rid))
+    {
+        return LWM2MCORE_ERR_INCORRECT_RANGE;
+    }
+
+    if (0 == (uriPtr->op & LWM2MCORE_OP_WRITE))
+    {
+        return LWM2MCORE_ERR_OP_NOT_SUPPORTED;
+    }
+
+    if (0 == offset)
+    {
+        /* The platform starts the package downloader, or cancels the update for an empty
+         * package
+         */
+        sID = lwm2mcore_PushUpdatePackage(LWM2MCORE_FW_UPDATE_TYPE, uriPtr->oiid, bufferPtr, len);
+        if ((LWM2MCORE_ERR_COMPLETED_OK != sID) || (0 == len))
+        {
+            return sID;
+        }
+    }
+
+    /* The package data are parsed, checked and stored as they are received */
+    if (   (0 != len)
+        && (DWL_OK != lwm2mcore_PackageDownloaderReceiveData((uint8_t*)bufferPtr, len)))
+    {
+        LOG_ARG("Pushed package rejected at offset %d", (int)offset);
+        lwm2mcore_PackageDownloaderEndTransfer(DWL_FAULT);
+        return LWM2MCORE_ERR_GENERAL_ERROR;
+    }
+
+    if ((isLast) && (DWL_OK != lwm2mcore_PackageDownloaderEndTransfer(DWL_OK)))
+    {
+        LOG("Pushed package transfer end failure");
+        return LWM2MCORE_ERR_GENERAL_ERROR;
+    }
+
+    return LWM2MCORE_ERR_COMPLETED_OK;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Function to read a resource of object 5
@@ -2803,6 +3393,12 @@ int omanager_ReadConnectivityStatisticsObj
         return LWM2MCORE_ERR_OP_NOT_SUPPORTED;
     }
 
+    /* Read from the last sample if the connectivity statistics are sampled */
+    if (omanager_ConnStatsRead(uriPtr->oid, uriPtr->rid, bufferPtr, lenPtr, &sID))
+    {
+        return sID;
+    }
+
     switch (uriPtr->rid)
     {
         /* Resource 0: SMS Tx counter */
@@ -2922,6 +3518,11 @@ int omanager_ExecConnectivityStatistics
         /* Resource 6: Start */
         case LWM2MCORE_CONN_STATS_START_RID:
             sID = lwm2mcore_StartConnectivityCounters();
+            if (LWM2MCORE_ERR_COMPLETED_OK == sID)
+            {
+                /* The samples of the previous counters are discarded */
+                omanager_ConnStatsReset();
+            }
             break;
 
         /* Resource 7: Stop */
@@ -3466,6 +4067,12 @@ int omanager_ReadExtConnectivityStatsObj
         return LWM2MCORE_ERR_OP_NOT_SUPPORTED;
     }
 
+    /* Read from the last sample if the connectivity statistics are sampled */
+    if (omanager_ConnStatsRead(uriPtr->oid, uriPtr->rid, bufferPtr, lenPtr, &sID))
+    {
+        return sID;
+    }
+
     switch (uriPtr->rid)
     {
         /* Resource 0: Signal bars */
@@ -3692,6 +4299,79 @@ int omanager_WriteSslCertif
     return lwm2mcore_UpdateSslCertificate(bufferPtr, len);
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function to read a part of the SSL certificates, for a streamed read
+ * Object: 10243 - SSL certificates
+ * Resource: 0
+ *
+ * @return
+ *      - LWM2MCORE_ERR_COMPLETED_OK if the read succeeds
+ *      - LWM2MCORE_ERR_GENERAL_ERROR if the read fails
+ *      - LWM2MCORE_ERR_INVALID_ARG if a parameter is invalid
+ *      - LWM2MCORE_ERR_OP_NOT_SUPPORTED if the operation is not supported
+ */
+//--------------------------------------------------------------------------------------------------
+int omanager_ReadSslCertif
+(
+    lwm2mcore_Uri_t* uriPtr,            ///< [IN] uri represents the requested operation and
+                                        ///< object/resource
+    size_t offset,                      ///< [IN] offset of the part in the certificates
+    char* bufferPtr,                    ///< [OUT] part of the certificates
+    size_t* lenPtr,                     ///< [INOUT] length of input buffer and length of the
+                                        ///< returned part
+    size_t* totalLenPtr                 ///< [OUT] total length of the certificates
+)
+{
+    if ((!uriPtr) || (!bufferPtr) || (!lenPtr) || (!totalLenPtr))
+    {
+        return LWM2MCORE_ERR_INVALID_ARG;
+    }
+
+    if ( (!(uriPtr->op & LWM2MCORE_OP_READ)) || (uriPtr->oiid) )
+    {
+        return LWM2MCORE_ERR_OP_NOT_SUPPORTED;
+    }
+
+    return lwm2mcore_GetSslCertificate(offset, bufferPtr, lenPtr, totalLenPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function to write a part of the SSL certificates, for a streamed write
+ * Object: 10243 - SSL certificates
+ * Resource: 0
+ *
+ * @return
+ *      - LWM2MCORE_ERR_COMPLETED_OK if the write succeeds
+ *      - LWM2MCORE_ERR_GENERAL_ERROR if the write fails
+ *      - LWM2MCORE_ERR_INVALID_ARG if a parameter is invalid
+ *      - LWM2MCORE_ERR_OP_NOT_SUPPORTED if the operation is not supported
+ */
+//--------------------------------------------------------------------------------------------------
+int omanager_StreamWriteSslCertif
+(
+    lwm2mcore_Uri_t* uriPtr,            ///< [IN] uri represents the requested operation and
+                                        ///< object/resource
+    size_t offset,                      ///< [IN] offset of the part in the certificates
+    char* bufferPtr,                    ///< [IN] part of the certificates
+    size_t len,                         ///< [IN] length of the part
+    bool isLast                         ///< [IN] the part is the last one of the certificates
+)
+{
+    if ((!uriPtr) || ((!bufferPtr) && (len)))
+    {
+        return LWM2MCORE_ERR_INVALID_ARG;
+    }
+
+    if ( (!(uriPtr->op & LWM2MCORE_OP_WRITE)) || (uriPtr->oiid) )
+    {
+        return LWM2MCORE_ERR_OP_NOT_SUPPORTED;
+    }
+
+    return lwm2mcore_UpdateSslCertificatePart(offset, bufferPtr, len, isLast);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Function for not registered objects
@@ -3777,12 +4457,17 @@ void omanager_DeleteDmCredentials
     void
 )
 {
-    ConfigSecurityObject_t* securityInformationPtr = BsConfigList.securityPtr;
-    ConfigSecurityObject_t* newSecurityInformationPtr = NULL;
-    ConfigServerObject_t* serverInformationPtr;
+    uint16_t slot;
 
-    while (securityInformationPtr)
+    for (slot = 0; slot < SecuritySlotNb(&BsConfigList); slot++)
     {
+        ConfigSecurityObject_t* securityInformationPtr = GetSecuritySlot(&BsConfigList, slot);
+
+        if (!securityInformationPtr->isUsed)
+        {
+            continue;
+        }
+
         lwm2mcore_DeleteCredential(LWM2MCORE_CREDENTIAL_DM_PUBLIC_KEY,
                                    securityInformationPtr->data.serverId);
         lwm2mcore_DeleteCredential(LWM2MCORE_CREDENTIAL_DM_SERVER_PUBLIC_KEY,
@@ -3795,37 +4480,26 @@ void omanager_DeleteDmCredentials
         /* Delete bootstrap information related to DM servers */
         if (false == (securityInformationPtr->data.isBootstrapServer))
         {
-            ConfigSecurityObject_t* nextPtr = securityInformationPtr->nextPtr;
             omanager_FreeObjectByInstanceId(LWM2MCORE_SECURITY_OID,
                                             securityInformationPtr->data.securityObjectInstanceId);
-            lwm2m_free(securityInformationPtr);
-            securityInformationPtr = nextPtr;
+            memset(securityInformationPtr, 0, sizeof(ConfigSecurityObject_t));
             BsConfigList.securityObjectNumber--;
         }
-        else
-        {
-            newSecurityInformationPtr = securityInformationPtr;
-            securityInformationPtr = securityInformationPtr->nextPtr;
-            newSecurityInformationPtr->nextPtr = NULL;
-        }
     }
-    BsConfigList.securityPtr = newSecurityInformationPtr;
 
     /* Delete all information about servers */
-    serverInformationPtr = BsConfigList.serverPtr;
-    while (NULL != serverInformationPtr)
+    memset(BsConfigList.server, 0, sizeof(BsConfigList.server));
+    if (BsConfigList.serverExtraPtr)
     {
-        ConfigServerObject_t* nextPtr = serverInformationPtr->nextPtr;
-        lwm2m_free(serverInformationPtr);
-        serverInformationPtr = nextPtr;
-        BsConfigList.serverObjectNumber--;
+        lwm2m_free(BsConfigList.serverExtraPtr);
+        BsConfigList.serverExtraPtr = NULL;
     }
+    BsConfigList.serverExtraNb = 0;
     BsConfigList.serverObjectNumber = 0;
-    BsConfigList.serverPtr = NULL;
 
     /* Unregister all object instances of object 1 in Wakaama */
     omanager_FreeObjectById(LWM2MCORE_SERVER_OID);
 
     /* Store the new configuration */
-    StoreBootstrapConfiguration(BsConfigList);
+    StoreBootstrapConfiguration(&BsConfigList);
 }
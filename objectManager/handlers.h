@@ -47,6 +47,15 @@
 //--------------------------------------------------------------------------------------------------
 #define LWM2MCORE_BINDING_STR_MAX_LEN    3
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Number of object instance slots of the objects 0 (security) and 1 (server) held in the
+ * bootstrap configuration itself. An instance Id lower than this number is stored in the slot of
+ * the same index when it is free. Additional slots are allocated when these ones are used.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LWM2MCORE_BS_INSTANCE_MAX_NB     16
+
 //--------------------------------------------------------------------------------------------------
 /**
  * @brief Binding mode: UDP
@@ -156,7 +165,7 @@ typedef struct _ConfigSecurityObject_t
     uint8_t         secretKey[DTLS_PSK_MAX_KEY_LEN];                ///< PSK secret
     uint16_t        pskLen;                                         ///< PSK secret length
     uint8_t         serverURI[LWM2MCORE_SERVER_URI_MAX_LEN];        ///< Server address
-    struct _ConfigSecurityObject_t* nextPtr;                        ///< Next entry in the list
+    bool            isUsed;                                         ///< Is the instance created?
 }
 ConfigSecurityObject_t;
 
@@ -168,13 +177,17 @@ ConfigSecurityObject_t;
 typedef struct _ConfigServerObject_t
 {
     ConfigServerToStore_t           data;                   ///< Server data
-    struct _ConfigServerObject_t*   nextPtr;                ///< Next entry in the list
+    bool                            isUsed;                 ///< Is the instance created?
 }
 ConfigServerObject_t;
 
 //--------------------------------------------------------------------------------------------------
 /**
  * Structure for bootstrap configuration to be stored in platform storage
+ *
+ * Each object instance slot carries its instance Id. The slot of a small instance Id is usually
+ * the one of the same index, so that the instance is found without any search, and no allocation
+ * is needed to create up to LWM2MCORE_BS_INSTANCE_MAX_NB instances.
  */
 //--------------------------------------------------------------------------------------------------
 typedef struct
@@ -182,8 +195,15 @@ typedef struct
     uint32_t                    version;                    ///< Configuration version
     uint16_t                    securityObjectNumber;       ///< Security objects number
     uint16_t                    serverObjectNumber;         ///< Server objects number
-    ConfigSecurityObject_t*     securityPtr;                ///< DM + BS server: security resources
-    ConfigServerObject_t*       serverPtr;                  ///< DM servers resources
+    ConfigSecurityObject_t      security[LWM2MCORE_BS_INSTANCE_MAX_NB];
+                                                            ///< DM + BS server: security resources
+    ConfigServerObject_t        server[LWM2MCORE_BS_INSTANCE_MAX_NB];
+                                                            ///< DM servers resources
+    ConfigSecurityObject_t*     securityExtraPtr;           ///< Additional security slots
+    uint16_t                    securityExtraNb;            ///< Number of additional security
+                                                            ///< slots
+    ConfigServerObject_t*       serverExtraPtr;             ///< Additional server slots
+    uint16_t                    serverExtraNb;              ///< Number of additional server slots
 }
 ConfigBootstrapFile_t;
 
@@ -486,6 +506,35 @@ int omanager_WriteFwUpdateObj
     size_t len                          ///< [IN] length of input buffer
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Function to write a part of the package pushed by the server, for a streamed write
+ *
+ * Object: 5 - Firmware update
+ * Resource: 0 - Package
+ *
+ * The first part starts the push transfer through lwm2mcore_PushUpdatePackage. The parts are then
+ * given to the package downloader parser as they are received.
+ *
+ * @return
+ *      - @ref LWM2MCORE_ERR_COMPLETED_OK if the part is written
+ *      - @ref LWM2MCORE_ERR_GENERAL_ERROR if the package downloader rejects the part
+ *      - @ref LWM2MCORE_ERR_INCORRECT_RANGE if the resource is not the package
+ *      - @ref LWM2MCORE_ERR_INVALID_ARG if a parameter is invalid
+ *      - @ref LWM2MCORE_ERR_OP_NOT_SUPPORTED if the operation is not supported
+ *      - other error codes of lwm2mcore_PushUpdatePackage
+ */
+//--------------------------------------------------------------------------------------------------
+int omanager_StreamWriteFwUpdatePackage
+(
+    lwm2mcore_Uri_t* uriPtr,            ///< [IN] uri represents the requested operation and
+                                        ///< object/resource
+    size_t offset,                      ///< [IN] offset of the part in the package
+    char* bufferPtr,                    ///< [IN] part of the package
+    size_t len,                         ///< [IN] length of the part
+    bool isLast                         ///< [IN] the part is the last one of the package
+);
+
 //--------------------------------------------------------------------------------------------------
 /**
  * @brief Function to read a resource of object 5
@@ -850,6 +899,55 @@ int omanager_WriteSslCertif
     size_t len                          ///< [IN] length of input buffer
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Function to read a part of the SSL certificates, for a streamed read
+ *
+ * Object: 10243 - SSL certificates
+ * Resource: 0
+ *
+ * @return
+ *      - @ref LWM2MCORE_ERR_COMPLETED_OK if the read succeeds
+ *      - @ref LWM2MCORE_ERR_GENERAL_ERROR if the read fails
+ *      - @ref LWM2MCORE_ERR_INVALID_ARG if a parameter is invalid
+ *      - @ref LWM2MCORE_ERR_OP_NOT_SUPPORTED if the operation is not supported
+ */
+//--------------------------------------------------------------------------------------------------
+int omanager_ReadSslCertif
+(
+    lwm2mcore_Uri_t* uriPtr,            ///< [IN] uri represents the requested operation and
+                                        ///< object/resource
+    size_t offset,                      ///< [IN] offset of the part in the certificates
+    char* bufferPtr,                    ///< [OUT] part of the certificates
+    size_t* lenPtr,                     ///< [INOUT] length of input buffer and length of the
+                                        ///< returned part
+    size_t* totalLenPtr                 ///< [OUT] total length of the certificates
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Function to write a part of the SSL certificates, for a streamed write
+ *
+ * Object: 10243 - SSL certificates
+ * Resource: 0
+ *
+ * @return
+ *      - @ref LWM2MCORE_ERR_COMPLETED_OK if the write succeeds
+ *      - @ref LWM2MCORE_ERR_GENERAL_ERROR if the write fails
+ *      - @ref LWM2MCORE_ERR_INVALID_ARG if a parameter is invalid
+ *      - @ref LWM2MCORE_ERR_OP_NOT_SUPPORTED if the operation is not supported
+ */
+//--------------------------------------------------------------------------------------------------
+int omanager_StreamWriteSslCertif
+(
+    lwm2mcore_Uri_t* uriPtr,            ///< [IN] uri represents the requested operation and
+                                        ///< object/resource
+    size_t offset,                      ///< [IN] offset of the part in the certificates
+    char* bufferPtr,                    ///< [IN] part of the certificates
+    size_t len,                         ///< [IN] length of the part
+    bool isLast                         ///< [IN] the part is the last one of the certificates
+);
+
 //--------------------------------------------------------------------------------------------------
 /**
  * @brief Function for not registered objects
@@ -948,6 +1046,37 @@ lwm2mcore_Sid_t omanager_GetLifetime
     uint32_t* lifetimePtr                           ///< [OUT] lifetime in seconds
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Check if the binding of the Device Management server is UDP with queue mode
+ *
+ * @return
+ *      - @c true if the binding is @ref LWM2MCORE_BINDING_UDP_QUEUE
+ *      - @c false otherwise, or if no device management server is configured
+ */
+//--------------------------------------------------------------------------------------------------
+bool omanager_IsQueueModeBinding
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Retrieve the default minimum and maximum periods of the observations from the server
+ * configuration
+ *
+ * @return
+ *      - @c true if the periods are retrieved
+ *      - @c false if no device management server is configured
+ */
+//--------------------------------------------------------------------------------------------------
+bool omanager_GetDefaultPeriods
+(
+    uint32_t* pminPtr,                              ///< [OUT] Default minimum period in seconds
+    uint32_t* pmaxPtr                               ///< [OUT] Default maximum period in seconds, 0
+                                                    ///<       if not set
+);
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Function to get the number of security and server objects in the bootstrap information
@@ -201,7 +201,7 @@ coap_status_t lwm2mcore_CallCoapEventHandler
     lwm2mcore_Sid_t result = LWM2MCORE_ERR_NOT_YET_IMPLEMENTED;
     lwm2mcore_CoapRequest_t* requestPtr;
 
-    requestPtr = (lwm2mcore_CoapRequest_t*)lwm2m_malloc(sizeof(lwm2mcore_CoapRequest_t));
+    requestPtr = (lwm2mcore_CoapRequest_t*)OMANAGER_MALLOC(sizeof(lwm2mcore_CoapRequest_t));
     if (!requestPtr)
     {
         LOG("requestPtr is NULL");
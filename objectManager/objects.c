@@ -12,6 +12,7 @@
 #include <lwm2mcore/update.h>
 #include <lwm2mcore/security.h>
 #include <lwm2mcore/paramStorage.h>
+#include <lwm2mcore/timer.h>
 #include "liblwm2m.h"
 #include "objects.h"
 #include "sessionManager.h"
@@ -19,6 +20,8 @@
 #include <stdlib.h>
 #include "utils.h"
 #include "handlers.h"
+#include "operationStats.h"
+#include "traceBuffer.h"
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -89,6 +92,30 @@ struct _SwApplicationList_
 //--------------------------------------------------------------------------------------------------
 static SwApplicationList_t* SwApplicationListPtr;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Structure for the ongoing streamed write (Block1 transfer)
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    bool        isActive;       ///< A streamed write is ongoing
+    uint16_t    oid;            ///< Object Id of the written resource
+    uint16_t    oiid;           ///< Object instance Id of the written resource
+    uint16_t    rid;            ///< Resource Id of the written resource
+    size_t      lastOffset;     ///< Offset of the last written block
+    size_t      nextOffset;     ///< Offset of the next block to write
+}
+StreamWrite_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Ongoing streamed write. Wakaama serves one request at a time, so one Block1 transfer is streamed
+ * at a time.
+ */
+//--------------------------------------------------------------------------------------------------
+static StreamWrite_t StreamWrite;
+
 //--------------------------------------------------------------------------------------------------
 /**
  *                      PRIVATE FUNCTIONS
@@ -311,6 +338,7 @@ static uint8_t ReadResourceInstances
     uint8_t result = COAP_404_NOT_FOUND;
     char asyncBuf[LWM2MCORE_BUFFER_MAX_LEN];
     size_t asyncBufLen = LWM2MCORE_BUFFER_MAX_LEN;
+    uint64_t startTimeUs;
     lwm2m_data_t* instancesPtr = lwm2m_data_new(resourcePtr->maxInstCount);
 
     if (!instancesPtr)
@@ -325,8 +353,14 @@ static uint8_t ReadResourceInstances
         uriPtr->riid = i;
 
         /* Read the instance of the resource */
-        LOG_ARG("Instance %d", uriPtr->riid);
+        startTimeUs = lwm2mcore_GetTimeUs();
         sid  = resourcePtr->read(uriPtr, asyncBuf, &asyncBufLen, NULL);
+        omanager_RecordLatency(uriPtr->oid, LWM2MCORE_STATS_OP_READ, true, startTimeUs);
+        smanager_Trace(LWM2MCORE_TRACE_READ,
+                       uriPtr->oid,
+                       uriPtr->oiid,
+                       uriPtr->rid | ((uint32_t)uriPtr->riid << 16),
+                       (uint32_t)sid);
 
         /* Define the CoAP result */
         result = SetCoapError(sid, LWM2MCORE_OP_READ);
@@ -401,6 +435,7 @@ static uint8_t ReadCb
     lwm2mcore_internalResource_t* resourcePtr = NULL;
     char asyncBuf[LWM2MCORE_BUFFER_MAX_LEN];
     size_t asyncBufLen = LWM2MCORE_BUFFER_MAX_LEN;
+    uint64_t startTimeUs;
 
     if ((NULL == objectPtr) || (NULL == dataArrayPtr))
     {
@@ -481,8 +516,6 @@ static uint8_t ReadCb
         {
             if (NULL != resourcePtr->read)
             {
-                LOG_ARG("READ /%d/%d/%d", uri.oid, uri.oiid, uri.rid);
-
                 if (1 < resourcePtr->maxInstCount)
                 {
                     result = ReadResourceInstances(&uri, resourcePtr, (*dataArrayPtr) + i);
@@ -492,7 +525,11 @@ static uint8_t ReadCb
                     asyncBufLen = LWM2MCORE_BUFFER_MAX_LEN;
                     memset(asyncBuf, 0, asyncBufLen);
 
+                    startTimeUs = lwm2mcore_GetTimeUs();
                     sid = resourcePtr->read(&uri, asyncBuf, &asyncBufLen, NULL);
+                    omanager_RecordLatency(uri.oid, LWM2MCORE_STATS_OP_READ, true, startTimeUs);
+                    smanager_Trace(LWM2MCORE_TRACE_READ,
+                                   uri.oid, uri.oiid, uri.rid, (uint32_t)sid);
 
                     /* Define the CoAP result */
                     result = SetCoapError(sid, LWM2MCORE_OP_READ);
@@ -569,6 +606,496 @@ static uint8_t ReadCb
     return result;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read a single-instance resource through its read handler, outside of a server request
+ *
+ * @return
+ *      - COAP_205_CONTENT if the resource is read
+ *      - COAP_404_NOT_FOUND if the object or the resource is not registered, or if the resource
+ *        has multiple instances
+ *      - COAP_501_NOT_IMPLEMENTED if the read handler is not implemented
+ *      - other CoAP error codes if the read handler fails
+ */
+//--------------------------------------------------------------------------------------------------
+uint8_t omanager_ReadResource
+(
+    uint16_t oid,                       ///< [IN] Object Id
+    uint16_t oiid,                      ///< [IN] Object instance Id
+    uint16_t rid,                       ///< [IN] Resource Id
+    lwm2mcore_ResourceType_t* typePtr,  ///< [OUT] Resource type
+    char* bufferPtr,                    ///< [OUT] Resource value, as returned by the read handler
+    size_t* lenPtr                      ///< [INOUT] Buffer size and length of the value
+)
+{
+    int sid;
+    lwm2mcore_Uri_t uri;
+    lwm2mcore_internalObject_t* objPtr;
+    lwm2mcore_internalResource_t* resourcePtr;
+    uint64_t startTimeUs;
+
+    objPtr = FindObject(Lwm2mcoreCtxPtr, oid);
+    if (NULL == objPtr)
+    {
+        return COAP_404_NOT_FOUND;
+    }
+
+    resourcePtr = FindResource(objPtr, rid);
+    if ((NULL == resourcePtr) || (1 < resourcePtr->maxInstCount))
+    {
+        return COAP_404_NOT_FOUND;
+    }
+
+    if (NULL == resourcePtr->read)
+    {
+        return COAP_501_NOT_IMPLEMENTED;
+    }
+
+    memset(&uri, 0, sizeof(uri));
+    uri.op = LWM2MCORE_OP_READ;
+    uri.oid = oid;
+    uri.oiid = oiid;
+    uri.rid = rid;
+
+    /* Keep a null terminator for the float values, converted from text */
+    memset(bufferPtr, 0, *lenPtr);
+    (*lenPtr)--;
+
+    startTimeUs = lwm2mcore_GetTimeUs();
+    sid = resourcePtr->read(&uri, bufferPtr, lenPtr, NULL);
+    omanager_RecordLatency(oid, LWM2MCORE_STATS_OP_READ, true, startTimeUs);
+    smanager_Trace(LWM2MCORE_TRACE_READ, oid, oiid, rid, (uint32_t)sid);
+
+    *typePtr = resourcePtr->type;
+    return SetCoapError(sid, LWM2MCORE_OP_READ);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Find an object registered to Wakaama
+ *
+ * @return
+ *      - Wakaama object
+ *      - NULL if the object is not registered
+ */
+//--------------------------------------------------------------------------------------------------
+static lwm2m_object_t* FindRegisteredObject
+(
+    uint16_t oid                        ///< [IN] Object Id
+)
+{
+    int i;
+
+    for (i = 0; i < RegisteredObjNb; i++)
+    {
+        if ((NULL != ObjectArray[i]) && (oid == ObjectArray[i]->objID))
+        {
+            return ObjectArray[i];
+        }
+    }
+
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read an object, an object instance or a resource through the read handlers, outside of a server
+ * request. The data are returned as an array of object instances, to be released with
+ * lwm2m_data_free.
+ *
+ * @return
+ *      - COAP_205_CONTENT if the URI is read
+ *      - COAP_404_NOT_FOUND if the object, the object instance or the resource is not registered
+ *      - other CoAP error codes if a read handler fails
+ */
+//--------------------------------------------------------------------------------------------------
+uint8_t omanager_ReadUri
+(
+    const lwm2m_uri_t* uriPtr,          ///< [IN] URI to read
+    int* dataNbPtr,                     ///< [OUT] Number of object instances
+    lwm2m_data_t** dataPtr              ///< [OUT] Object instances
+)
+{
+    lwm2m_object_t* objectPtr = FindRegisteredObject(uriPtr->objectId);
+    lwm2m_list_t* instancePtr;
+    lwm2m_data_t* instanceArrayPtr;
+    uint8_t result = COAP_205_CONTENT;
+    int instanceNb = 0;
+    int i;
+
+    *dataNbPtr = 0;
+    *dataPtr = NULL;
+
+    if (NULL == objectPtr)
+    {
+        return COAP_404_NOT_FOUND;
+    }
+
+    /* The instance list is sorted by instance Id */
+    for (instancePtr = objectPtr->instanceList; instancePtr; instancePtr = instancePtr->next)
+    {
+        if (   (instancePtr->next && (instancePtr->next->id == instancePtr->id))
+            || (   (uriPtr->flag & LWM2M_URI_FLAG_INSTANCE_ID)
+                && (uriPtr->instanceId != instancePtr->id)))
+        {
+            continue;
+        }
+        instanceNb++;
+    }
+
+    if (0 == instanceNb)
+    {
+        return (uriPtr->flag & LWM2M_URI_FLAG_INSTANCE_ID) ? COAP_404_NOT_FOUND : COAP_205_CONTENT;
+    }
+
+    instanceArrayPtr = lwm2m_data_new(instanceNb);
+    if (NULL == instanceArrayPtr)
+    {
+        return COAP_500_INTERNAL_SERVER_ERROR;
+    }
+    memset(instanceArrayPtr, 0, instanceNb * sizeof(lwm2m_data_t));
+
+    i = 0;
+    for (instancePtr = objectPtr->instanceList;
+         instancePtr && (COAP_205_CONTENT == result);
+         instancePtr = instancePtr->next)
+    {
+        int numData = 0;
+        lwm2m_data_t* resourceArrayPtr = NULL;
+
+        if (   (instancePtr->next && (instancePtr->next->id == instancePtr->id))
+            || (   (uriPtr->flag & LWM2M_URI_FLAG_INSTANCE_ID)
+                && (uriPtr->instanceId != instancePtr->id)))
+        {
+            continue;
+        }
+
+        if (uriPtr->flag & LWM2M_URI_FLAG_RESOURCE_ID)
+        {
+            resourceArrayPtr = lwm2m_data_new(1);
+            if (NULL == resourceArrayPtr)
+            {
+                result = COAP_500_INTERNAL_SERVER_ERROR;
+                break;
+            }
+            resourceArrayPtr->id = uriPtr->resourceId;
+            numData = 1;
+        }
+
+        result = ReadCb(instancePtr->id, &numData, &resourceArrayPtr, objectPtr);
+
+        instanceArrayPtr[i].type = LWM2M_TYPE_OBJECT_INSTANCE;
+        instanceArrayPtr[i].id = instancePtr->id;
+        instanceArrayPtr[i].value.asChildren.count = (size_t)numData;
+        instanceArrayPtr[i].value.asChildren.array = resourceArrayPtr;
+        i++;
+    }
+
+    if (COAP_205_CONTENT != result)
+    {
+        lwm2m_data_free(instanceNb, instanceArrayPtr);
+        return result;
+    }
+
+    *dataNbPtr = instanceNb;
+    *dataPtr = instanceArrayPtr;
+    return COAP_205_CONTENT;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read a block of a resource through its streamed read handler, for a Block2 transfer.
+ *
+ * This function is called by omanager_CoapHandleMessage, from the receive path of the session
+ * manager, for a GET request on a single resource, before the request is given to Wakaama which
+ * reads the resource through the object read callback. The block is read in the buffer of the
+ * response: the value is never held in memory at once. The response has the opaque or plain text
+ * content format, and the more flag of its Block2 option is set if the block is not the last one.
+ *
+ * @return
+ *      - COAP_205_CONTENT if the block is read
+ *      - COAP_400_BAD_REQUEST if the block size is not a CoAP block size
+ *      - COAP_402_BAD_OPTION if the block is beyond the end of the value
+ *      - COAP_404_NOT_FOUND if the object instance or the resource is not registered
+ *      - COAP_501_NOT_IMPLEMENTED if the resource has no streamed read handler: the resource is
+ *        read through the object read callback
+ *      - other CoAP error codes if the streamed read handler fails
+ */
+//--------------------------------------------------------------------------------------------------
+uint8_t lwm2mcore_StreamRead
+(
+    const lwm2m_uri_t* uriPtr,          ///< [IN] Requested resource
+    uint32_t blockNum,                  ///< [IN] Block number of the Block2 option, 0 without
+                                        ///<      Block2 option
+    uint16_t blockSize,                 ///< [IN] Block size: 16 to 1024 bytes
+    uint8_t* bufferPtr,                 ///< [OUT] Block, of blockSize bytes
+    size_t* lenPtr,                     ///< [OUT] Block length
+    bool* isLastPtr                     ///< [OUT] The block is the last one
+)
+{
+    lwm2mcore_Uri_t uri;
+    lwm2m_object_t* objectPtr;
+    lwm2mcore_internalObject_t* objPtr;
+    lwm2mcore_internalResource_t* resourcePtr;
+    size_t offset;
+    size_t totalLen = 0;
+    size_t blockLen = 0;
+    uint64_t startTimeUs;
+    int sid;
+
+    if ((NULL == uriPtr) || (NULL == bufferPtr) || (NULL == lenPtr) || (NULL == isLastPtr))
+    {
+        return COAP_500_INTERNAL_SERVER_ERROR;
+    }
+
+    /* Only a single resource is streamed */
+    if (   (!(uriPtr->flag & LWM2M_URI_FLAG_INSTANCE_ID))
+        || (!(uriPtr->flag & LWM2M_URI_FLAG_RESOURCE_ID)))
+    {
+        return COAP_501_NOT_IMPLEMENTED;
+    }
+
+    objectPtr = FindRegisteredObject(uriPtr->objectId);
+    objPtr = FindObject(Lwm2mcoreCtxPtr, uriPtr->objectId);
+    if (   (NULL == objectPtr) || (NULL == objPtr)
+        || (!LWM2M_LIST_FIND(objectPtr->instanceList, uriPtr->instanceId)))
+    {
+        return COAP_404_NOT_FOUND;
+    }
+
+    resourcePtr = FindResource(objPtr, uriPtr->resourceId);
+    if (NULL == resourcePtr)
+    {
+        return COAP_404_NOT_FOUND;
+    }
+
+    if (NULL == resourcePtr->streamRead)
+    {
+        return COAP_501_NOT_IMPLEMENTED;
+    }
+
+    /* CoAP block sizes: 2^(SZX + 4) bytes, SZX from 0 to 6 */
+    if ((16 > blockSize) || (1024 < blockSize) || (blockSize & (blockSize - 1)))
+    {
+        return COAP_400_BAD_REQUEST;
+    }
+    offset = (size_t)blockNum * blockSize;
+
+    memset(&uri, 0, sizeof(uri));
+    uri.op = LWM2MCORE_OP_READ;
+    uri.oid = uriPtr->objectId;
+    uri.oiid = uriPtr->instanceId;
+    uri.rid = uriPtr->resourceId;
+    uri.blockNum = blockNum;
+    uri.blockSize = blockSize;
+
+    /* The handler may return a shorter part than requested: read until the block is full */
+    do
+    {
+        size_t partLen = blockSize - blockLen;
+
+        startTimeUs = lwm2mcore_GetTimeUs();
+        sid = resourcePtr->streamRead(&uri,
+                                      offset + blockLen,
+                                      (char*)bufferPtr + blockLen,
+                                      &partLen,
+                                      &totalLen);
+        omanager_RecordLatency(uri.oid, LWM2MCORE_STATS_OP_READ, true, startTimeUs);
+        smanager_Trace(LWM2MCORE_TRACE_READ, uri.oid, uri.oiid, uri.rid, (uint32_t)sid);
+
+        if (LWM2MCORE_ERR_COMPLETED_OK != sid)
+        {
+            return SetCoapError(sid, LWM2MCORE_OP_READ);
+        }
+
+        if ((offset >= totalLen) && (0 != offset))
+        {
+            LOG_ARG("Block %d beyond the value length %d", blockNum, (int)totalLen);
+            return COAP_402_BAD_OPTION;
+        }
+
+        if ((blockSize - blockLen) < partLen)
+        {
+            return COAP_500_INTERNAL_SERVER_ERROR;
+        }
+
+        if ((0 == partLen) && ((offset + blockLen) < totalLen))
+        {
+            LOG("Streamed read handler returned no data");
+            return COAP_500_INTERNAL_SERVER_ERROR;
+        }
+        blockLen += partLen;
+    }
+    while ((blockLen < blockSize) && ((offset + blockLen) < totalLen));
+
+    *lenPtr = blockLen;
+    *isLastPtr = ((offset + blockLen) >= totalLen);
+    return COAP_205_CONTENT;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a part of a resource through its streamed write handler
+ *
+ * @return
+ *      - COAP_204_CHANGED if the part is written
+ *      - other CoAP error codes if the streamed write handler fails
+ */
+//--------------------------------------------------------------------------------------------------
+static uint8_t WriteResourcePart
+(
+    lwm2mcore_internalResource_t* resourcePtr,  ///< [IN] Resource
+    lwm2mcore_Uri_t* uriPtr,                    ///< [IN] Written resource
+    size_t offset,                              ///< [IN] Offset of the part in the value
+    char* bufferPtr,                            ///< [IN] Part of the value
+    size_t len,                                 ///< [IN] Part length
+    bool isLast                                 ///< [IN] The part is the last one
+)
+{
+    uint64_t startTimeUs = lwm2mcore_GetTimeUs();
+    int sid;
+
+    sid = resourcePtr->streamWrite(uriPtr, offset, bufferPtr, len, isLast);
+    omanager_RecordLatency(uriPtr->oid, LWM2MCORE_STATS_OP_WRITE, true, startTimeUs);
+    smanager_Trace(LWM2MCORE_TRACE_WRITE, uriPtr->oid, uriPtr->oiid, uriPtr->rid, (uint32_t)sid);
+
+    return SetCoapError(sid, LWM2MCORE_OP_WRITE);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a block of a resource through its streamed write handler, for a Block1 transfer.
+ *
+ * This function is called by omanager_CoapHandleMessage, from the receive path of the session
+ * manager, for each block of a PUT or POST request on a single resource, as the blocks are
+ * received and before the request is given to Wakaama which reassembles them. The block is given
+ * to the streamed write handler from the buffer of the request: the value is never held in memory
+ * at once.
+ *
+ * The blocks are written in order. A retransmitted block, already written, is acknowledged again
+ * without being written twice. The block 0 starts a new transfer.
+ *
+ * @return
+ *      - COAP_231_CONTINUE if the block is written and is not the last one
+ *      - COAP_204_CHANGED if the last block is written
+ *      - COAP_400_BAD_REQUEST if the block size is not a CoAP block size or the block length is
+ *        invalid
+ *      - COAP_404_NOT_FOUND if the object instance or the resource is not registered
+ *      - COAP_408_REQ_ENTITY_INCOMPLETE if the block is not the next one of the transfer
+ *      - COAP_501_NOT_IMPLEMENTED if the resource has no streamed write handler: the blocks are
+ *        reassembled and the resource is written through the object write callback
+ *      - other CoAP error codes if the streamed write handler fails
+ */
+//--------------------------------------------------------------------------------------------------
+uint8_t lwm2mcore_StreamWrite
+(
+    const lwm2m_uri_t* uriPtr,          ///< [IN] Written resource
+    uint32_t blockNum,                  ///< [IN] Block number of the Block1 option, 0 without
+                                        ///<      Block1 option
+    uint16_t blockSize,                 ///< [IN] Block size: 16 to 1024 bytes
+    bool isLast,                        ///< [IN] The block is the last one: more flag not set, or
+                                        ///<      no Block1 option
+    uint8_t* bufferPtr,                 ///< [IN] Block
+    size_t len                          ///< [IN] Block length
+)
+{
+    lwm2mcore_Uri_t uri;
+    lwm2m_object_t* objectPtr;
+    lwm2mcore_internalObject_t* objPtr;
+    lwm2mcore_internalResource_t* resourcePtr;
+    size_t offset;
+    uint8_t result;
+
+    if ((NULL == uriPtr) || ((NULL == bufferPtr) && (0 != len)))
+    {
+        return COAP_500_INTERNAL_SERVER_ERROR;
+    }
+
+    /* Only a single resource is streamed */
+    if (   (!(uriPtr->flag & LWM2M_URI_FLAG_INSTANCE_ID))
+        || (!(uriPtr->flag & LWM2M_URI_FLAG_RESOURCE_ID)))
+    {
+        return COAP_501_NOT_IMPLEMENTED;
+    }
+
+    objectPtr = FindRegisteredObject(uriPtr->objectId);
+    objPtr = FindObject(Lwm2mcoreCtxPtr, uriPtr->objectId);
+    if (   (NULL == objectPtr) || (NULL == objPtr)
+        || (!LWM2M_LIST_FIND(objectPtr->instanceList, uriPtr->instanceId)))
+    {
+        return COAP_404_NOT_FOUND;
+    }
+
+    resourcePtr = FindResource(objPtr, uriPtr->resourceId);
+    if (NULL == resourcePtr)
+    {
+        return COAP_404_NOT_FOUND;
+    }
+
+    if (NULL == resourcePtr->streamWrite)
+    {
+        return COAP_501_NOT_IMPLEMENTED;
+    }
+
+    /* CoAP block sizes: 2^(SZX + 4) bytes, SZX from 0 to 6. Only the last block is shorter. */
+    if (   (16 > blockSize) || (1024 < blockSize) || (blockSize & (blockSize - 1))
+        || (blockSize < len) || ((!isLast) && (blockSize != len)))
+    {
+        return COAP_400_BAD_REQUEST;
+    }
+    offset = (size_t)blockNum * blockSize;
+
+    if (   (StreamWrite.isActive)
+        && (StreamWrite.oid == uriPtr->objectId)
+        && (StreamWrite.oiid == uriPtr->instanceId)
+        && (StreamWrite.rid == uriPtr->resourceId)
+        && (StreamWrite.lastOffset == offset)
+        && (StreamWrite.nextOffset == (offset + len)))
+    {
+        LOG_ARG("Block %d already written", blockNum);
+        return isLast ? COAP_204_CHANGED : COAP_231_CONTINUE;
+    }
+
+    if (0 == offset)
+    {
+        /* New transfer, an ongoing one is abandoned */
+        StreamWrite.isActive = true;
+        StreamWrite.oid = uriPtr->objectId;
+        StreamWrite.oiid = uriPtr->instanceId;
+        StreamWrite.rid = uriPtr->resourceId;
+        StreamWrite.nextOffset = 0;
+    }
+    else if (   (!StreamWrite.isActive)
+             || (StreamWrite.oid != uriPtr->objectId)
+             || (StreamWrite.oiid != uriPtr->instanceId)
+             || (StreamWrite.rid != uriPtr->resourceId)
+             || (StreamWrite.nextOffset != offset))
+    {
+        LOG_ARG("Unexpected block %d", blockNum);
+        return COAP_408_REQ_ENTITY_INCOMPLETE;
+    }
+
+    memset(&uri, 0, sizeof(uri));
+    uri.op = LWM2MCORE_OP_WRITE;
+    uri.oid = uriPtr->objectId;
+    uri.oiid = uriPtr->instanceId;
+    uri.rid = uriPtr->resourceId;
+    uri.blockNum = blockNum;
+    uri.blockSize = blockSize;
+    uri.lastBlock = isLast;
+
+    result = WriteResourcePart(resourcePtr, &uri, offset, (char*)bufferPtr, len, isLast);
+    if ((COAP_204_CHANGED != result) || (isLast))
+    {
+        StreamWrite.isActive = false;
+        return result;
+    }
+
+    StreamWrite.lastOffset = offset;
+    StreamWrite.nextOffset = offset + len;
+    return COAP_231_CONTINUE;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Generic function when a WRITE/EXECUTE command is treated to format the received data
@@ -775,19 +1302,36 @@ static uint8_t WriteCb
                 resourcePtr = FindResource(objPtr, uri.rid);
                 if (NULL != resourcePtr)
                 {
-                    if (NULL != resourcePtr->write)
+                    if (   (NULL != resourcePtr->streamWrite)
+                        && (   (LWM2M_TYPE_OPAQUE == dataArrayPtr[i].type)
+                            || (LWM2M_TYPE_STRING == dataArrayPtr[i].type)))
+                    {
+                        /* The value is written as a single part, without copy */
+                        result = WriteResourcePart(resourcePtr,
+                                                   &uri,
+                                                   0,
+                                                   (char*)dataArrayPtr[i].value.asBuffer.buffer,
+                                                   dataArrayPtr[i].value.asBuffer.length,
+                                                   true);
+                    }
+                    else if (NULL != resourcePtr->write)
                     {
-                        LOG_ARG("data type %d resourcePtr->ptr %d",
-                                dataArrayPtr[i].type, resourcePtr->type);
-
                        if (FormatDataWriteExecute(resourcePtr->type,
                                                   dataArrayPtr[i],
                                                   asyncBuf,
                                                   &asyncBufLen))
                         {
-                            LOG_ARG("WRITE / %d / %d / %d", uri.oid, uri.oiid, uri.rid);
+                            uint64_t startTimeUs = lwm2mcore_GetTimeUs();
                             sid = resourcePtr->write(&uri, asyncBuf, asyncBufLen);
-                            LOG_ARG("WRITE sID %d", sid);
+                            omanager_RecordLatency(uri.oid,
+                                                   LWM2MCORE_STATS_OP_WRITE,
+                                                   true,
+                                                   startTimeUs);
+                            smanager_Trace(LWM2MCORE_TRACE_WRITE,
+                                           uri.oid,
+                                           uri.oiid,
+                                           uri.rid,
+                                           (uint32_t)sid);
                             /* Define the CoAP result */
                             result = SetCoapError(sid, LWM2MCORE_OP_WRITE);
                         }
@@ -896,7 +1440,7 @@ static uint8_t CreateCb
     if (NULL == objectPtr->instanceList)
     {
         LOG("objectPtr->instanceList == NULL");
-        objectPtr->instanceList = (lwm2m_list_t *)lwm2m_malloc(sizeof(lwm2m_list_t));
+        objectPtr->instanceList = (lwm2m_list_t *)OMANAGER_MALLOC(sizeof(lwm2m_list_t));
         if (NULL != objectPtr->instanceList)
         {
             memset(objectPtr->instanceList, 0, sizeof(lwm2m_list_t));
@@ -907,7 +1451,7 @@ static uint8_t CreateCb
     {
         lwm2m_list_t* instancePtr;
         /* Add the object instance in the Wakaama format */
-        instancePtr = (lwm2m_list_t *)lwm2m_malloc(sizeof(lwm2m_list_t));
+        instancePtr = (lwm2m_list_t *)OMANAGER_MALLOC(sizeof(lwm2m_list_t));
         if (!instancePtr)
         {
            LOG("instancePtr is NULL");
@@ -1119,15 +1663,22 @@ static uint8_t ExecuteCb
                     dataArray.value.asBuffer.buffer = bufferPtr;
                     memset(asyncBuf, 0, asyncBufLen);
 
-                    LOG_ARG("data type %d resourcePtr->type %d", dataArray.type, resourcePtr->type);
                     if (FormatDataWriteExecute(resourcePtr->type,
                                                dataArray,
                                                asyncBuf,
                                                &asyncBufLen))
                     {
-                        LOG_ARG("EXECUTE / %d / %d / %d", uri.oid, uri.oiid, uri.rid);
+                        uint64_t startTimeUs = lwm2mcore_GetTimeUs();
                         sid  = resourcePtr->exec(&uri, asyncBuf, asyncBufLen);
-                        LOG_ARG("EXECUTE sID %d", sid);
+                        omanager_RecordLatency(uri.oid,
+                                               LWM2MCORE_STATS_OP_EXECUTE,
+                                               true,
+                                               startTimeUs);
+                        smanager_Trace(LWM2MCORE_TRACE_EXECUTE,
+                                       uri.oid,
+                                       uri.oiid,
+                                       uri.rid,
+                                       (uint32_t)sid);
                         /* Define the CoAP result */
                         result = SetCoapError(sid, LWM2MCORE_OP_EXECUTE);
                     }
@@ -1158,6 +1709,163 @@ static uint8_t ExecuteCb
     return result;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function called by Wakaama for a READ command, recording the request latency
+ *
+ * @return
+ *      - see ReadCb
+ */
+//--------------------------------------------------------------------------------------------------
+static uint8_t MeasuredReadCb
+(
+    uint16_t instanceId,            ///< [IN] Object ID
+    int* numDataPtr,                ///< [IN] Number of resources to be read
+    lwm2m_data_t** dataArrayPtr,    ///< [IN] Array of requested resources to be read
+    lwm2m_object_t* objectPtr       ///< [IN] Pointer on object
+)
+{
+    uint64_t startTimeUs = lwm2mcore_GetTimeUs();
+    uint8_t result = ReadCb(instanceId, numDataPtr, dataArrayPtr, objectPtr);
+
+    if (NULL != objectPtr)
+    {
+        omanager_RecordLatency(objectPtr->objID, LWM2MCORE_STATS_OP_READ, false, startTimeUs);
+    }
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function called by Wakaama for a WRITE command, recording the request latency
+ *
+ * @return
+ *      - see WriteCb
+ */
+//--------------------------------------------------------------------------------------------------
+static uint8_t MeasuredWriteCb
+(
+    uint16_t instanceId,            ///< [IN] Object ID
+    int numData,                    ///< [IN] Number of resources to be written
+    lwm2m_data_t* dataArrayPtr,     ///< [IN] Array of requested resources to be written
+    lwm2m_object_t* objectPtr       ///< [IN] Pointer on object
+)
+{
+    uint64_t startTimeUs = lwm2mcore_GetTimeUs();
+    uint8_t result = WriteCb(instanceId, numData, dataArrayPtr, objectPtr);
+
+    if (NULL != objectPtr)
+    {
+        omanager_RecordLatency(objectPtr->objID, LWM2MCORE_STATS_OP_WRITE, false, startTimeUs);
+    }
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function called by Wakaama for a CREATE command, recording the request latency
+ *
+ * The write of the created object instance is only recorded as a part of the creation.
+ *
+ * @return
+ *      - see CreateCb
+ */
+//--------------------------------------------------------------------------------------------------
+static uint8_t MeasuredCreateCb
+(
+    uint16_t instanceId,            ///< [IN] Object ID
+    int numData,                    ///< [IN] Number of resources to be written
+    lwm2m_data_t* dataArrayPtr,     ///< [IN] Array of requested resources to be written
+    lwm2m_object_t* objectPtr       ///< [IN] Pointer on object
+)
+{
+    uint64_t startTimeUs = lwm2mcore_GetTimeUs();
+    uint8_t result = CreateCb(instanceId, numData, dataArrayPtr, objectPtr);
+
+    if (NULL != objectPtr)
+    {
+        omanager_RecordLatency(objectPtr->objID, LWM2MCORE_STATS_OP_CREATE, false, startTimeUs);
+    }
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function called by Wakaama for a DELETE command, recording the request latency
+ *
+ * @return
+ *      - see DeleteCb
+ */
+//--------------------------------------------------------------------------------------------------
+static uint8_t MeasuredDeleteCb
+(
+    uint16_t instanceId,            ///< [IN] Object instance ID
+    lwm2m_object_t* objectPtr       ///< [IN] Pointer on object
+)
+{
+    uint64_t startTimeUs = lwm2mcore_GetTimeUs();
+    uint8_t result = DeleteCb(instanceId, objectPtr);
+
+    if (NULL != objectPtr)
+    {
+        omanager_RecordLatency(objectPtr->objID, LWM2MCORE_STATS_OP_DELETE, false, startTimeUs);
+    }
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function called by Wakaama for a DISCOVER command, recording the request latency
+ *
+ * @return
+ *      - see DiscoverCb
+ */
+//--------------------------------------------------------------------------------------------------
+static uint8_t MeasuredDiscoverCb
+(
+    uint16_t instanceId,            ///< [IN] Object ID
+    int* numDataPtr,                ///< [INOUT] Number of resources which were read
+    lwm2m_data_t ** dataArrayPtr,   ///< [IN] Array of requested resources to be discovered
+    lwm2m_object_t* objectPtr       ///< [IN] Pointer on object
+)
+{
+    uint64_t startTimeUs = lwm2mcore_GetTimeUs();
+    uint8_t result = DiscoverCb(instanceId, numDataPtr, dataArrayPtr, objectPtr);
+
+    if (NULL != objectPtr)
+    {
+        omanager_RecordLatency(objectPtr->objID, LWM2MCORE_STATS_OP_DISCOVER, false, startTimeUs);
+    }
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function called by Wakaama for an EXECUTE command, recording the request latency
+ *
+ * @return
+ *      - see ExecuteCb
+ */
+//--------------------------------------------------------------------------------------------------
+static uint8_t MeasuredExecuteCb
+(
+    uint16_t instanceId,            ///< [IN] Object ID
+    uint16_t resourceId,            ///< [IN] Resource ID
+    uint8_t* bufferPtr,             ///< [IN] Data provided in the EXECUTE command
+    int length,                     ///< [IN] Data length
+    lwm2m_object_t* objectPtr       ///< [IN] Pointer on object
+)
+{
+    uint64_t startTimeUs = lwm2mcore_GetTimeUs();
+    uint8_t result = ExecuteCb(instanceId, resourceId, bufferPtr, length, objectPtr);
+
+    if (NULL != objectPtr)
+    {
+        omanager_RecordLatency(objectPtr->objID, LWM2MCORE_STATS_OP_EXECUTE, false, startTimeUs);
+    }
+    return result;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Get the supported object list for LWM2M Core
@@ -1209,7 +1917,7 @@ static lwm2mcore_internalObject_t* InitObject
 
     LOG_ARG("InitObject /%d/%d, multiple %d", client_objPtr->id, iid, multiple);
 
-    objPtr = (lwm2mcore_internalObject_t*)lwm2m_malloc(sizeof (lwm2mcore_internalObject_t));
+    objPtr = (lwm2mcore_internalObject_t*)OMANAGER_MALLOC(sizeof (lwm2mcore_internalObject_t));
 
     LWM2MCORE_ASSERT(objPtr);
 
@@ -1218,7 +1926,6 @@ static lwm2mcore_internalObject_t* InitObject
     objPtr->multiple = multiple;
     objPtr->id = client_objPtr->id;
     objPtr->iid = iid;
-    memset(&(objPtr->attr), 0, sizeof (lwm2m_attribute_t));
 
     /* Object's create and delete handlers should be invoked by the LWM2M client
      * itself. Once the operation is completed, the client shall call avcm_create_lwm2m_object
@@ -1242,7 +1949,7 @@ static lwm2mcore_internalObject_t* InitObject
     for (j = 0; j < client_objPtr->resCnt; j++)
     {
         resourcePtr =
-                (lwm2mcore_internalResource_t*)lwm2m_malloc(sizeof(lwm2mcore_internalResource_t));
+            (lwm2mcore_internalResource_t*)OMANAGER_MALLOC(sizeof(lwm2mcore_internalResource_t));
 
         LWM2MCORE_ASSERT(resourcePtr);
         memset(resourcePtr, 0, sizeof(lwm2mcore_internalResource_t));
@@ -1251,10 +1958,11 @@ static lwm2mcore_internalObject_t* InitObject
         resourcePtr->iid = 0;
         resourcePtr->type = (client_resourcePtr + j)->type;
         resourcePtr->maxInstCount = (client_resourcePtr + j)->maxResInstCnt;
-        memset(&resourcePtr->attr, 0, sizeof(lwm2m_attribute_t));
         resourcePtr->read = (client_resourcePtr + j)->read;
         resourcePtr->write = (client_resourcePtr + j)->write;
         resourcePtr->exec = (client_resourcePtr + j)->exec;
+        resourcePtr->streamRead = (client_resourcePtr + j)->streamRead;
+        resourcePtr->streamWrite = (client_resourcePtr + j)->streamWrite;
         DLIST_INSERT_TAIL(&(objPtr->resource_list), resourcePtr, list);
     }
 
@@ -1489,7 +2197,7 @@ static bool RegisterObjTable
     for (i = 0; i < (handlerPtr->objCnt); i++)
     {
         /* Memory allocation for one object */
-        ObjectArray[ObjNb]  = (lwm2m_object_t *)lwm2m_malloc(sizeof(lwm2m_object_t));
+        ObjectArray[ObjNb]  = (lwm2m_object_t *)OMANAGER_MALLOC(sizeof(lwm2m_object_t));
         if (NULL != ObjectArray[ObjNb])
         {
             memset(ObjectArray[ObjNb], 0, sizeof(lwm2m_object_t));
@@ -1531,12 +2239,12 @@ static bool RegisterObjTable
             {
                 lwm2m_list_t* instancePtr;
                 ObjectArray[ObjNb]->instanceList =
-                        (lwm2m_list_t *)lwm2m_malloc(sizeof(lwm2m_list_t));
+                        (lwm2m_list_t *)OMANAGER_MALLOC(sizeof(lwm2m_list_t));
                 memset(ObjectArray[ObjNb]->instanceList, 0, sizeof(lwm2m_list_t));
                 for (j = 0; j < objInstanceNb; j++)
                 {
                     /* Add the object instance in the Wakaama format */
-                    instancePtr = (lwm2m_list_t *)lwm2m_malloc(sizeof(lwm2m_list_t));
+                    instancePtr = (lwm2m_list_t *)OMANAGER_MALLOC(sizeof(lwm2m_list_t));
                     if (!instancePtr)
                     {
                        LOG("instancePtr is NULL");
@@ -1564,7 +2272,7 @@ static bool RegisterObjTable
             {
                 /* Allocate the unique object instance */
                 ObjectArray[ObjNb]->instanceList =
-                                            (lwm2m_list_t *)lwm2m_malloc(sizeof(lwm2m_list_t));
+                                            (lwm2m_list_t *)OMANAGER_MALLOC(sizeof(lwm2m_list_t));
                 if (ObjectArray[ObjNb]->instanceList != NULL)
                 {
                     memset(ObjectArray[ObjNb]->instanceList, 0, sizeof(lwm2m_list_t));
@@ -1598,12 +2306,12 @@ static bool RegisterObjTable
                  * server. In fact the library doesn't need to know the resources of the object,
                  * only the server does.
                  */
-                ObjectArray[ObjNb]->readFunc     = ReadCb;
-                ObjectArray[ObjNb]->discoverFunc = DiscoverCb;
-                ObjectArray[ObjNb]->writeFunc    = WriteCb;
-                ObjectArray[ObjNb]->executeFunc  = ExecuteCb;
-                ObjectArray[ObjNb]->createFunc   = CreateCb;
-                ObjectArray[ObjNb]->deleteFunc   = DeleteCb;
+                ObjectArray[ObjNb]->readFunc     = MeasuredReadCb;
+                ObjectArray[ObjNb]->discoverFunc = MeasuredDiscoverCb;
+                ObjectArray[ObjNb]->writeFunc    = MeasuredWriteCb;
+                ObjectArray[ObjNb]->executeFunc  = MeasuredExecuteCb;
+                ObjectArray[ObjNb]->createFunc   = MeasuredCreateCb;
+                ObjectArray[ObjNb]->deleteFunc   = MeasuredDeleteCb;
 
                 /* Store the context */
                 ObjectArray[ObjNb]->userData = instanceRef;
@@ -1753,7 +2461,7 @@ static bool UpdateSwListWakaama
                             {
                                 // Object instance is not registered
                                 instancePtr =
-                                    (SwApplicationList_t*)lwm2m_malloc(sizeof(SwApplicationList_t));
+                                  (SwApplicationList_t*)OMANAGER_MALLOC(sizeof(SwApplicationList_t));
                                 LOG("Obj instance is NOT registered");
                                 if (!instancePtr)
                                 {
@@ -1808,7 +2516,7 @@ static bool UpdateSwListWakaama
                 // Only add the object instance in Wakaama if check is true
                 if (instancePtr->check)
                 {
-                    wakaamaInstancePtr = (lwm2m_list_t*)lwm2m_malloc(sizeof(lwm2m_list_t));
+                    wakaamaInstancePtr = (lwm2m_list_t*)OMANAGER_MALLOC(sizeof(lwm2m_list_t));
                     if (!wakaamaInstancePtr)
                     {
                        LOG("instancePtr is NULL");
@@ -1926,6 +2634,9 @@ uint16_t lwm2mcore_ObjectRegister
         omanager_DeleteDmCredentials();
     }
 
+    /* Resolve the server address while the objects are registered */
+    smanager_PrepareConnection();
+
     lwm2mcoreHandlersPtr = omanager_GetHandlers();
 
     /* Register static object tables managed by LwM2MCore */
@@ -1982,6 +2693,11 @@ uint16_t lwm2mcore_ObjectRegister
         UpdateSwListWakaama(instanceRef);
     }
 
+    if (RegisteredObjNb)
+    {
+        smanager_SetStartupPhase(LWM2MCORE_STARTUP_OBJECTS_REGISTERED);
+    }
+
     return RegisteredObjNb;
 }
 
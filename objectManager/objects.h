@@ -12,6 +12,7 @@
 #define __OBJECTS_H__
 
 #include <lwm2mcore/lwm2mcore.h>
+#include <lwm2mcore/heap.h>
 #include "liblwm2m.h"
 
 /**
@@ -58,6 +59,14 @@
 //--------------------------------------------------------------------------------------------------
 #define DLIST_INIT(head) ((head)->p_first = (head)->p_last = NULL)
 
+//--------------------------------------------------------------------------------------------------
+/** Macro to allocate memory owned by the object manager, to be released by lwm2m_free
+ *
+ * @param[in] size memory size to be allocated.
+ */
+//--------------------------------------------------------------------------------------------------
+#define OMANAGER_MALLOC(size) lwm2mcore_MallocTag((size), LWM2MCORE_HEAP_TAG_OBJECT_MANAGER)
+
 //--------------------------------------------------------------------------------------------------
 /** Insert new element into the tail of the list
  *
@@ -415,22 +424,6 @@ typedef enum
     LWM2MCORE_SSL_CERTIFICATE_CERTIF = 0            ///< SSL certificates
 } lwm2mcore_sslCertificateResource_t;
 
-//--------------------------------------------------------------------------------------------------
-/*! \struct lwm2m_attribute_t
- *  \brief data structure represent the attribute.
- */
-//--------------------------------------------------------------------------------------------------
-typedef struct
-{
-    int pmin;       ///< min value
-    int pmax;       ///< max value
-    int gt;         ///< greater than
-    int lt;         ///< less than
-    int st;         ///< step
-    int cancel;     ///< cancel observe
-    int mask;       ///< bitmask indicates what attributes are set
-}lwm2m_attribute_t;
-
 //--------------------------------------------------------------------------------------------------
 /*! \struct lwm2mcore_internalResource_t
  *  \brief data structure represents a LwM2M resource.
@@ -443,10 +436,11 @@ typedef struct _lwm2mcore_internalResource          /// See lwm2mcore_internalRe
     uint16_t iid;                                   ///< resource instance id
     lwm2mcore_ResourceType_t type;                  ///< resource data type
     uint16_t maxInstCount;                          ///< maximal number of instances for this resource
-    lwm2m_attribute_t attr;                         ///< resource attributes
     lwm2mcore_ReadCallback_t read;                  ///< operation handler: read handler
     lwm2mcore_WriteCallback_t write;                ///< operation handler: write handler
     lwm2mcore_ExecuteCallback_t exec;               ///< operation handler: execute handler
+    lwm2mcore_StreamReadCallback_t streamRead;      ///< operation handler: streamed read handler
+    lwm2mcore_StreamWriteCallback_t streamWrite;    ///< operation handler: streamed write handler
     char *cache;                                    ///< cache value for observer (asynchronous notification)
 }lwm2mcore_internalResource_t;
 
@@ -467,7 +461,6 @@ typedef struct _lwm2mcore_internalObject            /// See lwm2mcore_internalOb
     uint16_t id;                                    ///< object id
     uint16_t iid;                                   ///< object instance id
     bool multiple;                                  ///< flag indicate if this is single or multiple instances
-    lwm2m_attribute_t attr;                         ///< object attributes
     struct _lwm2m_resource_list resource_list;      ///< resource linked list
 }lwm2mcore_internalObject_t;
 
@@ -538,6 +531,116 @@ lwm2mcore_Handler_t* omanager_GetHandlers
 (
      void
 );
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Read a single-instance resource through its read handler, outside of a server request
+ *
+ * @return
+ *      - COAP_205_CONTENT if the resource is read
+ *      - COAP_404_NOT_FOUND if the object or the resource is not registered, or if the resource
+ *        has multiple instances
+ *      - COAP_501_NOT_IMPLEMENTED if the read handler is not implemented
+ *      - other CoAP error codes if the read handler fails
+ */
+//--------------------------------------------------------------------------------------------------
+uint8_t omanager_ReadResource
+(
+    uint16_t oid,                       ///< [IN] Object Id
+    uint16_t oiid,                      ///< [IN] Object instance Id
+    uint16_t rid,                       ///< [IN] Resource Id
+    lwm2mcore_ResourceType_t* typePtr,  ///< [OUT] Resource type
+    char* bufferPtr,                    ///< [OUT] Resource value, as returned by the read handler
+    size_t* lenPtr                      ///< [INOUT] Buffer size and length of the value
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Read an object, an object instance or a resource through the read handlers, outside of a
+ *  server request. The data are returned as an array of object instances, to be released with
+ *  lwm2m_data_free.
+ *
+ * @return
+ *      - COAP_205_CONTENT if the URI is read
+ *      - COAP_404_NOT_FOUND if the object, the object instance or the resource is not registered
+ *      - other CoAP error codes if a read handler fails
+ */
+//--------------------------------------------------------------------------------------------------
+uint8_t omanager_ReadUri
+(
+    const lwm2m_uri_t* uriPtr,          ///< [IN] URI to read
+    int* dataNbPtr,                     ///< [OUT] Number of object instances
+    lwm2m_data_t** dataPtr              ///< [OUT] Object instances
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Read a block of a resource through its streamed read handler, for a Block2 transfer.
+ *
+ *  This function is called by omanager_CoapHandleMessage, from the receive path of the session
+ *  manager, for a GET request on a single resource, before the request is given to Wakaama which
+ *  reads the resource through the object read callback. The block is read in the buffer of the
+ *  response: the value is never held in memory at once. The response has the opaque or plain
+ *  text content format, and the more flag of its Block2 option is set if the block is not the last
+ *  one.
+ *
+ * @return
+ *      - COAP_205_CONTENT if the block is read
+ *      - COAP_400_BAD_REQUEST if the block size is not a CoAP block size
+ *      - COAP_402_BAD_OPTION if the block is beyond the end of the value
+ *      - COAP_404_NOT_FOUND if the object instance or the resource is not registered
+ *      - COAP_501_NOT_IMPLEMENTED if the resource has no streamed read handler: the resource is
+ *        read through the object read callback
+ *      - other CoAP error codes if the streamed read handler fails
+ */
+//--------------------------------------------------------------------------------------------------
+uint8_t lwm2mcore_StreamRead
+(
+    const lwm2m_uri_t* uriPtr,          ///< [IN] Requested resource
+    uint32_t blockNum,                  ///< [IN] Block number of the Block2 option, 0 without
+                                        ///<      Block2 option
+    uint16_t blockSize,                 ///< [IN] Block size: 16 to 1024 bytes
+    uint8_t* bufferPtr,                 ///< [OUT] Block, of blockSize bytes
+    size_t* lenPtr,                     ///< [OUT] Block length
+    bool* isLastPtr                     ///< [OUT] The block is the last one
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Write a block of a resource through its streamed write handler, for a Block1 transfer.
+ *
+ *  This function is called by omanager_CoapHandleMessage, from the receive path of the session
+ *  manager, for each block of a PUT or POST request on a single resource, as the blocks are
+ *  received and before the request is given to Wakaama which reassembles them. The block is given
+ *  to the streamed write handler from the buffer of the request: the value is never held in
+ *  memory at once.
+ *
+ *  The blocks are written in order. A retransmitted block, already written, is acknowledged again
+ *  without being written twice. The block 0 starts a new transfer.
+ *
+ * @return
+ *      - COAP_231_CONTINUE if the block is written and is not the last one
+ *      - COAP_204_CHANGED if the last block is written
+ *      - COAP_400_BAD_REQUEST if the block size is not a CoAP block size or the block length is
+ *        invalid
+ *      - COAP_404_NOT_FOUND if the object instance or the resource is not registered
+ *      - COAP_408_REQ_ENTITY_INCOMPLETE if the block is not the next one of the transfer
+ *      - COAP_501_NOT_IMPLEMENTED if the resource has no streamed write handler: the blocks are
+ *        reassembled and the resource is written through the object write callback
+ *      - other CoAP error codes if the streamed write handler fails
+ */
+//--------------------------------------------------------------------------------------------------
+uint8_t lwm2mcore_StreamWrite
+(
+    const lwm2m_uri_t* uriPtr,          ///< [IN] Written resource
+    uint32_t blockNum,                  ///< [IN] Block number of the Block1 option, 0 without
+                                        ///<      Block1 option
+    uint16_t blockSize,                 ///< [IN] Block size: 16 to 1024 bytes
+    bool isLast,                        ///< [IN] The block is the last one: more flag not set, or
+                                        ///<      no Block1 option
+    uint8_t* bufferPtr,                 ///< [IN] Block
+    size_t len                          ///< [IN] Block length
+);
 /**
   * @}
   */
@@ -45,6 +45,8 @@ static lwm2mcore_Resource_t SecurityResources[] =
         omanager_ReadSecurityObj,                   //.read
         omanager_WriteSecurityObj,                  //.write
         NULL,                                       //.exec
+        NULL,                                       //.streamRead
+        NULL,                                       //.streamWrite
     },
     {
         LWM2MCORE_SECURITY_BOOTSTRAP_SERVER_RID,    //.id
@@ -53,6 +55,8 @@ static lwm2mcore_Resource_t SecurityResources[] =
         omanager_ReadSecurityObj,                   //.read
         omanager_WriteSecurityObj,                  //.write
         NULL,                                       //.exec
+        NULL,                                       //.streamRead
+        NULL,                                       //.streamWrite
     },
     {
         LWM2MCORE_SECURITY_MODE_RID,                //.id
@@ -61,6 +65,8 @@ static lwm2mcore_Resource_t SecurityResources[] =
         omanager_ReadSecurityObj,                   //.read
         omanager_WriteSecurityObj,                  //.write
         NULL,                                       //.exec
+        NULL,                                       //.streamRead
+        NULL,                                       //.streamWrite
     },
     {
         LWM2MCORE_SECURITY_PKID_RID,                //.id
@@ -69,6 +75,8 @@ static lwm2mcore_Resource_t SecurityResources[] =
         omanager_ReadSecurityObj,                   //.read
         omanager_WriteSecurityObj,                  //.write
         NULL,                                       //.exec
+        NULL,                                       //.streamRead
+        NULL,                                       //.streamWrite
     },
     {
         LWM2MCORE_SECURITY_SERVER_KEY_RID,          //.id
@@ -77,6 +85,8 @@ static lwm2mcore_Resource_t SecurityResources[] =
         omanager_ReadSecurityObj,                   //.read
         omanager_WriteSecurityObj,                  //.write
         NULL,                                       //.exec
+        NULL,                                       //.streamRead
+        NULL,                                       //.streamWrite
     },
     {
         LWM2MCORE_SECURITY_SECRET_KEY_RID,          //.id
@@ -85,6 +95,8 @@ static lwm2mcore_Resource_t SecurityResources[] =
         omanager_ReadSecurityObj,                   //.read
         omanager_WriteSecurityObj,                  //.write
         NULL,                                       //.exec
+        NULL,                                       //.streamRead
+        NULL,                                       //.streamWrite
     },
     {
         LWM2MCORE_SECURITY_SMS_SECURITY_MODE_RID,   //.id
@@ -93,6 +105,8 @@ static lwm2mcore_Resource_t SecurityResources[] =
         NULL,                                       //.read
         omanager_SmsDummy,                          //.write
         NULL,                                       //.exec
+        NULL,                                       //.streamRead
+        NULL,                                       //.streamWrite
     },
     {
         LWM2MCORE_SECURITY_SMS_BINDING_KEY_PAR_RID, //.id
@@ -101,6 +115,8 @@ static lwm2mcore_Resource_t SecurityResources[] =
         NULL,                                       //.read
         omanager_SmsDummy,                          //.write
         NULL,                                       //.exec
+        NULL,                                       //.streamRead
+        NULL,                                       //.streamWrite
     },
     {
         LWM2MCORE_SECURITY_SMS_BINDING_SEC_KEY_RID, //.id
@@ -109,6 +125,8 @@ static lwm2mcore_Resource_t SecurityResources[] =
         NULL,                                       //.read
         omanager_SmsDummy,                          //.write
         NULL,                                       //.exec
+        NULL,                                       //.streamRead
+        NULL,                                       //.streamWrite
     },
     {
         LWM2MCORE_SECURITY_SERVER_SMS_NUMBER_RID,   //.id
@@ -117,6 +135,8 @@ static lwm2mcore_Resource_t SecurityResources[] =
         NULL,                                       //.read
         omanager_SmsDummy,                          //.write
         NULL,                                       //.exec
+        NULL,                                       //.streamRead
+        NULL,                                       //.streamWrite
     },
     {
         LWM2MCORE_SECURITY_SERVER_ID_RID,           //.id
@@ -125,6 +145,8 @@ static lwm2mcore_Resource_t SecurityResources[] =
         omanager_ReadSecurityObj,                   //.read
         omanager_WriteSecurityObj,                  //.write
         NULL,                                       //.exec
+        NULL,                                       //.streamRead
+        NULL,                                       //.streamWrite
     },
     {
         LWM2MCORE_SECURITY_CLIENT_HOLD_OFF_TIME_RID, //.id
@@ -133,6 +155,8 @@ static lwm2mcore_Resource_t SecurityResources[] =
         omanager_ReadSecurityObj,                    //.read
         omanager_WriteSecurityObj,                   //.write
         NULL,                                        //.exec
+        NULL,                                        //.streamRead
+        NULL,                                        //.streamWrite
     },
     {
         LWM2MCORE_SECURITY_BS_ACCOUNT_TIMEOUT_RID,   //.id
@@ -141,6 +165,8 @@ static lwm2mcore_Resource_t SecurityResources[] =
         omanager_ReadSecurityObj,                    //.read
         omanager_WriteSecurityObj,                   //.write
         NULL,                                        //.exec
+        NULL,                                        //.streamRead
+        NULL,                                        //.streamWrite
     }
 };
 
@@ -160,6 +186,8 @@ static lwm2mcore_Resource_t ServerResources[] =
         omanager_ReadServerObj,                     //.read
         omanager_WriteServerObj,                    //.write
         NULL,                                       //.exec
+        NULL,                                       //.streamRead
+        NULL,                                       //.streamWrite
     },
     {
         LWM2MCORE_SERVER_LIFETIME_RID,              //.id
@@ -168,6 +196,8 @@ static lwm2mcore_Resource_t ServerResources[] =
         omanager_ReadServerObj,                     //.read
         omanager_WriteServerObj,                    //.write
         NULL,                                       //.exec
+        NULL,                                       //.streamRead
+        NULL,                                       //.streamWrite
     },
     {
         LWM2MCORE_SERVER_DEFAULT_MIN_PERIOD_RID,    //.id
@@ -176,6 +206,8 @@ static lwm2mcore_Resource_t ServerResources[] =
         omanager_ReadServerObj,                     //.read
         omanager_WriteServerObj,                    //.write
         NULL,                                       //.exec
+        NULL,                                       //.streamRead
+        NULL,                                       //.streamWrite
     },
     {
         LWM2MCORE_SERVER_DEFAULT_MAX_PERIOD_RID,    //.id
@@ -184,6 +216,8 @@ static lwm2mcore_Resource_t ServerResources[] =
         omanager_ReadServerObj,                     //.read
         omanager_WriteServerObj,                    //.write
         NULL,                                       //.exec
+        NULL,                                       //.streamRead
+        NULL,                                       //.streamWrite
     },
     {
         LWM2MCORE_SERVER_DISABLE_TIMEOUT_RID,       //.id
@@ -192,6 +226,8 @@ static lwm2mcore_Resource_t ServerResources[] =
         omanager_ReadServerObj,                     //.read
         omanager_WriteServerObj,                    //.write
         NULL,                                       //.exec
+        NULL,                                       //.streamRead
+        NULL,                                       //.streamWrite
     },
     {
         LWM2MCORE_SERVER_STORE_NOTIF_WHEN_OFFLINE_RID,  //.id
@@ -200,6 +236,8 @@ static lwm2mcore_Resource_t ServerResources[] =
         omanager_ReadServerObj,                         //.read
         omanager_WriteServerObj,                        //.write
         NULL,                                           //.exec
+        NULL,                                           //.streamRead
+        NULL,                                           //.streamWrite
     },
     {
         LWM2MCORE_SERVER_BINDING_MODE_RID,          //.id
@@ -208,6 +246,8 @@ static lwm2mcore_Resource_t ServerResources[] =
         omanager_ReadServerObj,                     //.read
         omanager_WriteServerObj,                    //.write
         NULL,                                       //.exec
+        NULL,                                       //.streamRead
+        NULL,                                       //.streamWrite
     }
 };
 
@@ -227,6 +267,8 @@ static lwm2mcore_Resource_t DeviceResources[] =
         omanager_ReadDeviceObj,                     //.read
         NULL,                                       //.write
         NULL,                                       //.exec
+        NULL,                                       //.streamRead
+        NULL,                                       //.streamWrite
     },
     {
         LWM2MCORE_DEVICE_MODEL_NUMBER_RID,          //.id
@@ -235,6 +277,8 @@ static lwm2mcore_Resource_t DeviceResources[] =
         omanager_ReadDeviceObj,                     //.read
         NULL,                                       //.write
         NULL,                                       //.exec
+        NULL,                                       //.streamRead
+        NULL,                                       //.streamWrite
     },
     {
         LWM2MCORE_DEVICE_SERIAL_NUMBER_RID,         //.id
@@ -243,6 +287,8 @@ static lwm2mcore_Resource_t DeviceResources[] =
         omanager_ReadDeviceObj,                     //.read
         NULL,                                       //.write
         NULL,                                       //.exec
+        NULL,                                       //.streamRead
+        NULL,                                       //.streamWrite
     },
     {
         LWM2MCORE_DEVICE_FIRMWARE_VERSION_RID,      //.id
@@ -251,6 +297,8 @@ static lwm2mcore_Resource_t DeviceResources[] =
         omanager_ReadDeviceObj,                     //.read
         NULL,                                       //.write
         NULL,                                       //.exec
+        NULL,                                       //.streamRead
+        NULL,                                       //.streamWrite
     },
     {
         LWM2MCORE_DEVICE_REBOOT_RID,                //.id
@@ -259,6 +307,8 @@ static lwm2mcore_Resource_t DeviceResources[] =
         NULL,                                       //.read
         NULL,                                       //.write
         omanager_ExecDeviceObj,                     //.exec
+        NULL,                                       //.streamRead
+        NULL,                                       //.streamWrite
     },
     {
         LWM2MCORE_DEVICE_BATTERY_LEVEL_RID,         //.id
@@ -267,6 +317,8 @@ static lwm2mcore_Resource_t DeviceResources[] =
         omanager_ReadDeviceObj,                     //.read
         NULL,                                       //.write
         NULL,                                       //.exec
+        NULL,                                       //.streamRead
+        NULL,                                       //.streamWrite
     },
     {
         LWM2MCORE_DEVICE_CURRENT_TIME_RID,          //.id
@@ -275,6 +327,8 @@ static lwm2mcore_Resource_t DeviceResources[] =
         omanager_ReadDeviceObj,                     //.read
         omanager_WriteDeviceObj,                    //.write
         NULL,                                       //.exec
+        NULL,                                       //.streamRead
+        NULL,                                       //.streamWrite
     },
     {
         LWM2MCORE_DEVICE_SUPPORTED_BINDING_MODE_RID, //.id
@@ -283,6 +337,8 @@ static lwm2mcore_Resource_t DeviceResources[] =
         omanager_ReadDeviceObj,                     //.read
         omanager_WriteDeviceObj,                    //.write
         NULL,                                       //.exec
+        NULL,                                       //.streamRead
+        NULL,                                       //.streamWrite
     }
 };
 
@@ -302,6 +358,8 @@ static lwm2mcore_Resource_t ConnectivityMonitoringResources[] =
         omanager_ReadConnectivityMonitoringObj,             //.read
         NULL,                                               //.write
         NULL,                                               //.exec
+        NULL,                                               //.streamRead
+        NULL,                                               //.streamWrite
     },
     {
         LWM2MCORE_CONN_MONITOR_AVAIL_NETWORK_BEARER_RID,    //.id
@@ -310,6 +368,8 @@ static lwm2mcore_Resource_t ConnectivityMonitoringResources[] =
         omanager_ReadConnectivityMonitoringObj,                      //.read
         NULL,                                               //.write
         NULL,                                               //.exec
+        NULL,                                               //.streamRead
+        NULL,                                               //.streamWrite
     },
     {
         LWM2MCORE_CONN_MONITOR_RADIO_SIGNAL_STRENGTH_RID,   //.id
@@ -318,6 +378,8 @@ static lwm2mcore_Resource_t ConnectivityMonitoringResources[] =
         omanager_ReadConnectivityMonitoringObj,             //.read
         NULL,                                               //.write
         NULL,                                               //.exec
+        NULL,                                               //.streamRead
+        NULL,                                               //.streamWrite
     },
     {
         LWM2MCORE_CONN_MONITOR_LINK_QUALITY_RID,            //.id
@@ -326,6 +388,8 @@ static lwm2mcore_Resource_t ConnectivityMonitoringResources[] =
         omanager_ReadConnectivityMonitoringObj,             //.read
         NULL,                                               //.write
         NULL,                                               //.exec
+        NULL,                                               //.streamRead
+        NULL,                                               //.streamWrite
     },
     {
         LWM2MCORE_CONN_MONITOR_IP_ADDRESSES_RID,            //.id
@@ -334,6 +398,8 @@ static lwm2mcore_Resource_t ConnectivityMonitoringResources[] =
         omanager_ReadConnectivityMonitoringObj,             //.read
         NULL,                                               //.write
         NULL,                                               //.exec
+        NULL,                                               //.streamRead
+        NULL,                                               //.streamWrite
     },
     {
         LWM2MCORE_CONN_MONITOR_ROUTER_IP_ADDRESSES_RID,     //.id
@@ -342,6 +408,8 @@ static lwm2mcore_Resource_t ConnectivityMonitoringResources[] =
         omanager_ReadConnectivityMonitoringObj,             //.read
         NULL,                                               //.write
         NULL,                                               //.exec
+        NULL,                                               //.streamRead
+        NULL,                                               //.streamWrite
     },
     {
         LWM2MCORE_CONN_MONITOR_LINK_UTILIZATION_RID,        //.id
@@ -350,6 +418,8 @@ static lwm2mcore_Resource_t ConnectivityMonitoringResources[] =
         omanager_ReadConnectivityMonitoringObj,             //.read
         NULL,                                               //.write
         NULL,                                               //.exec
+        NULL,                                               //.streamRead
+        NULL,                                               //.streamWrite
     },
     {
         LWM2MCORE_CONN_MONITOR_APN_RID,                     //.id
@@ -358,6 +428,8 @@ static lwm2mcore_Resource_t ConnectivityMonitoringResources[] =
         omanager_ReadConnectivityMonitoringObj,             //.read
         NULL,                                               //.write
         NULL,                                               //.exec
+        NULL,                                               //.streamRead
+        NULL,                                               //.streamWrite
     },
     {
         LWM2MCORE_CONN_MONITOR_CELL_ID_RID,                 //.id
@@ -366,6 +438,8 @@ static lwm2mcore_Resource_t ConnectivityMonitoringResources[] =
         omanager_ReadConnectivityMonitoringObj,             //.read
         NULL,                                               //.write
         NULL,                                               //.exec
+        NULL,                                               //.streamRead
+        NULL,                                               //.streamWrite
     },
     {
         LWM2MCORE_CONN_MONITOR_SMNC_RID,                    //.id
@@ -374,6 +448,8 @@ static lwm2mcore_Resource_t ConnectivityMonitoringResources[] =
         omanager_ReadConnectivityMonitoringObj,             //.read
         NULL,                                               //.write
         NULL,                                               //.exec
+        NULL,                                               //.streamRead
+        NULL,                                               //.streamWrite
     },
     {
         LWM2MCORE_CONN_MONITOR_SMCC_RID,                    //.id
@@ -382,6 +458,8 @@ static lwm2mcore_Resource_t ConnectivityMonitoringResources[] =
         omanager_ReadConnectivityMonitoringObj,             //.read
         NULL,                                               //.write
         NULL,                                               //.exec
+        NULL,                                               //.streamRead
+        NULL,                                               //.streamWrite
     }
 };
 
@@ -389,7 +467,8 @@ static lwm2mcore_Resource_t ConnectivityMonitoringResources[] =
 /**
  * Firmware update supported resources defined for LWM2M object (5)
  * For each resource, the resource Id, the resource type, the resource instance number,
- * a READ, WRITE, EXEC callback can be defined.
+ * a READ, WRITE, EXEC callback can be defined. A package pushed by the server is written in blocks
+ * through a streamed WRITE callback.
  */
 //--------------------------------------------------------------------------------------------------
 static lwm2mcore_Resource_t FirmwareUpdateResources[] =
@@ -400,7 +479,9 @@ static lwm2mcore_Resource_t FirmwareUpdateResources[] =
         1,                                          //.maxResInstCnt
         NULL,                                       //.read
         omanager_WriteFwUpdateObj,                  //.write
-        NULL                                        //.exec
+        NULL,                                       //.exec
+        NULL,                                       //.streamRead
+        omanager_StreamWriteFwUpdatePackage,        //.streamWrite
     },
     {
         LWM2MCORE_FW_UPDATE_PACKAGE_URI_RID,        //.id
@@ -408,7 +489,9 @@ static lwm2mcore_Resource_t FirmwareUpdateResources[] =
         1,                                          //.maxResInstCnt
         omanager_ReadFwUpdateObj,                   //.read
         omanager_WriteFwUpdateObj,                  //.write
-        NULL                                        //.exec
+        NULL,                                       //.exec
+        NULL,                                       //.streamRead
+        NULL,                                       //.streamWrite
     },
     {
         LWM2MCORE_FW_UPDATE_UPDATE_RID,             //.id
@@ -417,6 +500,8 @@ static lwm2mcore_Resource_t FirmwareUpdateResources[] =
         NULL,                                       //.read
         NULL,                                       //.write
         omanager_ExecFwUpdate,                      //.exec
+        NULL,                                       //.streamRead
+        NULL,                                       //.streamWrite
     },
     {
         LWM2MCORE_FW_UPDATE_UPDATE_STATE_RID,       //.id
@@ -424,7 +509,9 @@ static lwm2mcore_Resource_t FirmwareUpdateResources[] =
         1,                                          //.maxResInstCnt
         omanager_ReadFwUpdateObj,                   //.read
         NULL,                                       //.write
-        NULL                                        //.exec
+        NULL,                                       //.exec
+        NULL,                                       //.streamRead
+        NULL,                                       //.streamWrite
     },
     {
         LWM2MCORE_FW_UPDATE_UPDATE_RESULT_RID,      //.id
@@ -432,7 +519,9 @@ static lwm2mcore_Resource_t FirmwareUpdateResources[] =
         1,                                          //.maxResInstCnt
         omanager_ReadFwUpdateObj,                   //.read
         NULL,                                       //.write
-        NULL                                        //.exec
+        NULL,                                       //.exec
+        NULL,                                       //.streamRead
+        NULL,                                       //.streamWrite
     }
 };
 
@@ -456,6 +545,8 @@ static lwm2mcore_Resource_t LocationResources[] =
         omanager_ReadLocationObj,                   //.read
         NULL,                                       //.write
         NULL,                                       //.exec
+        NULL,                                       //.streamRead
+        NULL,                                       //.streamWrite
     },
     {
         LWM2MCORE_LOCATION_LONGITUDE_RID,           //.id
@@ -468,6 +559,8 @@ static lwm2mcore_Resource_t LocationResources[] =
         omanager_ReadLocationObj,                   //.read
         NULL,                                       //.write
         NULL,                                       //.exec
+        NULL,                                       //.streamRead
+        NULL,                                       //.streamWrite
     },
     {
         LWM2MCORE_LOCATION_ALTITUDE_RID,            //.id
@@ -480,6 +573,8 @@ static lwm2mcore_Resource_t LocationResources[] =
         omanager_ReadLocationObj,                   //.read
         NULL,                                       //.write
         NULL,                                       //.exec
+        NULL,                                       //.streamRead
+        NULL,                                       //.streamWrite
     },
     {
         LWM2MCORE_LOCATION_VELOCITY_RID,            //.id
@@ -488,6 +583,8 @@ static lwm2mcore_Resource_t LocationResources[] =
         omanager_ReadLocationObj,                   //.read
         NULL,                                       //.write
         NULL,                                       //.exec
+        NULL,                                       //.streamRead
+        NULL,                                       //.streamWrite
     },
     {
         LWM2MCORE_LOCATION_TIMESTAMP_RID,           //.id
@@ -496,6 +593,8 @@ static lwm2mcore_Resource_t LocationResources[] =
         omanager_ReadLocationObj,                   //.read
         NULL,                                       //.write
         NULL,                                       //.exec
+        NULL,                                       //.streamRead
+        NULL,                                       //.streamWrite
     }
 };
 
@@ -515,6 +614,8 @@ static lwm2mcore_Resource_t ConnectivityStatisticsResources[] =
         omanager_ReadConnectivityStatisticsObj,     //.read
         NULL,                                       //.write
         NULL,                                       //.exec
+        NULL,                                       //.streamRead
+        NULL,                                       //.streamWrite
     },
     {
         LWM2MCORE_CONN_STATS_RX_SMS_COUNT_RID,      //.id
@@ -523,6 +624,8 @@ static lwm2mcore_Resource_t ConnectivityStatisticsResources[] =
         omanager_ReadConnectivityStatisticsObj,     //.read
         NULL,                                       //.write
         NULL,                                       //.exec
+        NULL,                                       //.streamRead
+        NULL,                                       //.streamWrite
     },
     {
         LWM2MCORE_CONN_STATS_TX_DATA_COUNT_RID,     //.id
@@ -531,6 +634,8 @@ static lwm2mcore_Resource_t ConnectivityStatisticsResources[] =
         omanager_ReadConnectivityStatisticsObj,     //.read
         NULL,                                       //.write
         NULL,                                       //.exec
+        NULL,                                       //.streamRead
+        NULL,                                       //.streamWrite
     },
     {
         LWM2MCORE_CONN_STATS_RX_DATA_COUNT_RID,     //.id
@@ -539,6 +644,8 @@ static lwm2mcore_Resource_t ConnectivityStatisticsResources[] =
         omanager_ReadConnectivityStatisticsObj,     //.read
         NULL,                                       //.write
         NULL,                                       //.exec
+        NULL,                                       //.streamRead
+        NULL,                                       //.streamWrite
     },
     {
         LWM2MCORE_CONN_STATS_START_RID,             //.id
@@ -547,6 +654,8 @@ static lwm2mcore_Resource_t ConnectivityStatisticsResources[] =
         NULL,                                       //.read
         NULL,                                       //.write
         omanager_ExecConnectivityStatistics,        //.exec
+        NULL,                                       //.streamRead
+        NULL,                                       //.streamWrite
     },
     {
         LWM2MCORE_CONN_STATS_STOP_RID,              //.id
@@ -555,6 +664,8 @@ static lwm2mcore_Resource_t ConnectivityStatisticsResources[] =
         NULL,                                       //.read
         NULL,                                       //.write
         omanager_ExecConnectivityStatistics,        //.exec
+        NULL,                                       //.streamRead
+        NULL,                                       //.streamWrite
     }
 };
 
@@ -574,6 +685,8 @@ static lwm2mcore_Resource_t SoftwareUpdateResources[] =
         omanager_ReadSwUpdateObj,                   //.read
         NULL,                                       //.write
         NULL,                                       //.exec
+        NULL,                                       //.streamRead
+        NULL,                                       //.streamWrite
     },
     {
         LWM2MCORE_SW_UPDATE_PACKAGE_VERSION_RID,    //.id
@@ -582,6 +695,8 @@ static lwm2mcore_Resource_t SoftwareUpdateResources[] =
         omanager_ReadSwUpdateObj,                   //.read
         NULL,                                       //.write
         NULL,                                       //.exec
+        NULL,                                       //.streamRead
+        NULL,                                       //.streamWrite
     },
     {
         LWM2MCORE_SW_UPDATE_PACKAGE_URI_RID,        //.id
@@ -590,6 +705,8 @@ static lwm2mcore_Resource_t SoftwareUpdateResources[] =
         NULL,                                       //.read
         omanager_WriteSwUpdateObj,                  //.write
         NULL,                                       //.exec
+        NULL,                                       //.streamRead
+        NULL,                                       //.streamWrite
     },
     {
         LWM2MCORE_SW_UPDATE_INSTALL_RID,            //.id
@@ -598,6 +715,8 @@ static lwm2mcore_Resource_t SoftwareUpdateResources[] =
         NULL,                                       //.read
         NULL,                                       //.write
         omanager_ExecSwUpdate,                      //.exec
+        NULL,                                       //.streamRead
+        NULL,                                       //.streamWrite
     },
     {
         LWM2MCORE_SW_UPDATE_UNINSTALL_RID,          //.id
@@ -606,6 +725,8 @@ static lwm2mcore_Resource_t SoftwareUpdateResources[] =
         NULL,                                       //.read
         NULL,                                       //.write
         omanager_ExecSwUpdate,                      //.exec
+        NULL,                                       //.streamRead
+        NULL,                                       //.streamWrite
     },
     {
         LWM2MCORE_SW_UPDATE_UPDATE_STATE_RID,       //.id
@@ -614,6 +735,8 @@ static lwm2mcore_Resource_t SoftwareUpdateResources[] =
         omanager_ReadSwUpdateObj,                   //.read
         NULL,                                       //.write
         NULL,                                       //.exec
+        NULL,                                       //.streamRead
+        NULL,                                       //.streamWrite
     },
     {
         LWM2MCORE_SW_UPDATE_UPDATE_SUPPORTED_OBJ_RID, //.id
@@ -622,6 +745,8 @@ static lwm2mcore_Resource_t SoftwareUpdateResources[] =
         omanager_ReadSwUpdateObj,                   //.read
         omanager_WriteSwUpdateObj,                  //.write
         NULL,                                       //.exec
+        NULL,                                       //.streamRead
+        NULL,                                       //.streamWrite
     },
     {
         LWM2MCORE_SW_UPDATE_UPDATE_RESULT_RID,      //.id
@@ -630,6 +755,8 @@ static lwm2mcore_Resource_t SoftwareUpdateResources[] =
         omanager_ReadSwUpdateObj,                   //.read
         NULL,                                       //.write
         NULL,                                       //.exec
+        NULL,                                       //.streamRead
+        NULL,                                       //.streamWrite
     },
     {
         LWM2MCORE_SW_UPDATE_ACTIVATE_RID,           //.id
@@ -638,6 +765,8 @@ static lwm2mcore_Resource_t SoftwareUpdateResources[] =
         NULL,                                       //.read
         NULL,                                       //.write
         omanager_ExecSwUpdate,                      //.exec
+        NULL,                                       //.streamRead
+        NULL,                                       //.streamWrite
     },
     {
         LWM2MCORE_SW_UPDATE_DEACTIVATE_RID,         //.id
@@ -646,6 +775,8 @@ static lwm2mcore_Resource_t SoftwareUpdateResources[] =
         NULL,                                       //.read
         NULL,                                       //.write
         omanager_ExecSwUpdate,                      //.exec
+        NULL,                                       //.streamRead
+        NULL,                                       //.streamWrite
     },
     {
         LWM2MCORE_SW_UPDATE_ACTIVATION_STATE_RID,   //.id
@@ -654,6 +785,8 @@ static lwm2mcore_Resource_t SoftwareUpdateResources[] =
         omanager_ReadSwUpdateObj,                   //.read
         NULL,                                       //.write
         NULL,                                       //.exec
+        NULL,                                       //.streamRead
+        NULL,                                       //.streamWrite
     }
 };
 
@@ -673,6 +806,8 @@ static lwm2mcore_Resource_t SubscriptionResources[] =
         omanager_ReadSubscriptionObj,               //.read
         NULL,                                       //.write
         NULL,                                       //.exec
+        NULL,                                       //.streamRead
+        NULL,                                       //.streamWrite
     },
     {
         LWM2MCORE_SUBSCRIPTION_ICCID_RID,           //.id
@@ -681,6 +816,8 @@ static lwm2mcore_Resource_t SubscriptionResources[] =
         omanager_ReadSubscriptionObj,               //.read
         NULL,                                       //.write
         NULL,                                       //.exec
+        NULL,                                       //.streamRead
+        NULL,                                       //.streamWrite
     },
     {
         LWM2MCORE_SUBSCRIPTION_IDENTITY_RID,        //.id
@@ -689,6 +826,8 @@ static lwm2mcore_Resource_t SubscriptionResources[] =
         omanager_ReadSubscriptionObj,               //.read
         NULL,                                       //.write
         NULL,                                       //.exec
+        NULL,                                       //.streamRead
+        NULL,                                       //.streamWrite
     },
     {
         LWM2MCORE_SUBSCRIPTION_MSISDN_RID,          //.id
@@ -697,6 +836,8 @@ static lwm2mcore_Resource_t SubscriptionResources[] =
         omanager_ReadSubscriptionObj,               //.read
         NULL,                                       //.write
         NULL,                                       //.exec
+        NULL,                                       //.streamRead
+        NULL,                                       //.streamWrite
     },
     {
         LWM2MCORE_SUBSCRIPTION_SIM_MODE_RID,        //.id
@@ -705,6 +846,8 @@ static lwm2mcore_Resource_t SubscriptionResources[] =
         NULL,                                       //.read
         NULL,                                       //.write
         omanager_ExecSubscriptionObj,               //.exec
+        NULL,                                       //.streamRead
+        NULL,                                       //.streamWrite
     },
     {
         LWM2MCORE_SUBSCRIPTION_CURRENT_SIM_RID,     //.id
@@ -713,6 +856,8 @@ static lwm2mcore_Resource_t SubscriptionResources[] =
         omanager_ReadSubscriptionObj,               //.read
         NULL,                                       //.write
         NULL,                                       //.exec
+        NULL,                                       //.streamRead
+        NULL,                                       //.streamWrite
     },
     {
         LWM2MCORE_SUBSCRIPTION_SWITCH_SIM_RID,      //.id
@@ -721,6 +866,8 @@ static lwm2mcore_Resource_t SubscriptionResources[] =
         omanager_ReadSubscriptionObj,               //.read
         NULL,                                       //.write
         NULL,                                       //.exec
+        NULL,                                       //.streamRead
+        NULL,                                       //.streamWrite
     }
 };
 
@@ -741,6 +888,8 @@ static lwm2mcore_Resource_t ExtConnectivityStatsResources[] =
         omanager_ReadExtConnectivityStatsObj,           //.read
         NULL,                                           //.write
         NULL,                                           //.exec
+        NULL,                                           //.streamRead
+        NULL,                                           //.streamWrite
     },
     {
         LWM2MCORE_EXT_CONN_STATS_CELLULAR_TECH_RID,     //.id
@@ -749,6 +898,8 @@ static lwm2mcore_Resource_t ExtConnectivityStatsResources[] =
         omanager_ReadExtConnectivityStatsObj,           //.read
         NULL,                                           //.write
         NULL,                                           //.exec
+        NULL,                                           //.streamRead
+        NULL,                                           //.streamWrite
     },
     {
         LWM2MCORE_EXT_CONN_STATS_ROAMING_RID,           //.id
@@ -757,6 +908,8 @@ static lwm2mcore_Resource_t ExtConnectivityStatsResources[] =
         omanager_ReadExtConnectivityStatsObj,           //.read
         NULL,                                           //.write
         NULL,                                           //.exec
+        NULL,                                           //.streamRead
+        NULL,                                           //.streamWrite
     },
     {
         LWM2MCORE_EXT_CONN_STATS_ECIO_RID,              //.id
@@ -765,6 +918,8 @@ static lwm2mcore_Resource_t ExtConnectivityStatsResources[] =
         omanager_ReadExtConnectivityStatsObj,           //.read
         NULL,                                           //.write
         NULL,                                           //.exec
+        NULL,                                           //.streamRead
+        NULL,                                           //.streamWrite
     },
     {
         LWM2MCORE_EXT_CONN_STATS_RSRP_RID,              //.id
@@ -773,6 +928,8 @@ static lwm2mcore_Resource_t ExtConnectivityStatsResources[] =
         omanager_ReadExtConnectivityStatsObj,           //.read
         NULL,                                           //.write
         NULL,                                           //.exec
+        NULL,                                           //.streamRead
+        NULL,                                           //.streamWrite
     },
     {
         LWM2MCORE_EXT_CONN_STATS_RSRQ_RID,              //.id
@@ -781,6 +938,8 @@ static lwm2mcore_Resource_t ExtConnectivityStatsResources[] =
         omanager_ReadExtConnectivityStatsObj,           //.read
         NULL,                                           //.write
         NULL,                                           //.exec
+        NULL,                                           //.streamRead
+        NULL,                                           //.streamWrite
     },
     {
         LWM2MCORE_EXT_CONN_STATS_RSCP_RID,              //.id
@@ -789,6 +948,8 @@ static lwm2mcore_Resource_t ExtConnectivityStatsResources[] =
         omanager_ReadExtConnectivityStatsObj,           //.read
         NULL,                                           //.write
         NULL,                                           //.exec
+        NULL,                                           //.streamRead
+        NULL,                                           //.streamWrite
     },
     {
         LWM2MCORE_EXT_CONN_STATS_TEMPERATURE_RID,       //.id
@@ -797,6 +958,8 @@ static lwm2mcore_Resource_t ExtConnectivityStatsResources[] =
         omanager_ReadExtConnectivityStatsObj,           //.read
         NULL,                                           //.write
         NULL,                                           //.exec
+        NULL,                                           //.streamRead
+        NULL,                                           //.streamWrite
     },
     {
         LWM2MCORE_EXT_CONN_STATS_UNEXPECTED_RESETS_RID, //.id
@@ -805,6 +968,8 @@ static lwm2mcore_Resource_t ExtConnectivityStatsResources[] =
         omanager_ReadExtConnectivityStatsObj,           //.read
         NULL,                                           //.write
         NULL,                                           //.exec
+        NULL,                                           //.streamRead
+        NULL,                                           //.streamWrite
     },
     {
         LWM2MCORE_EXT_CONN_STATS_TOTAL_RESETS_RID,      //.id
@@ -813,6 +978,8 @@ static lwm2mcore_Resource_t ExtConnectivityStatsResources[] =
         omanager_ReadExtConnectivityStatsObj,           //.read
         NULL,                                           //.write
         NULL,                                           //.exec
+        NULL,                                           //.streamRead
+        NULL,                                           //.streamWrite
     },
     {
         LWM2MCORE_EXT_CONN_STATS_LAC_RID,               //.id
@@ -821,6 +988,8 @@ static lwm2mcore_Resource_t ExtConnectivityStatsResources[] =
         omanager_ReadExtConnectivityStatsObj,           //.read
         NULL,                                           //.write
         NULL,                                           //.exec
+        NULL,                                           //.streamRead
+        NULL,                                           //.streamWrite
     },
     {
         LWM2MCORE_EXT_CONN_STATS_TAC_RID,               //.id
@@ -829,6 +998,8 @@ static lwm2mcore_Resource_t ExtConnectivityStatsResources[] =
         omanager_ReadExtConnectivityStatsObj,           //.read
         NULL,                                           //.write
         NULL,                                           //.exec
+        NULL,                                           //.streamRead
+        NULL,                                           //.streamWrite
     }
 };
 
@@ -836,7 +1007,8 @@ static lwm2mcore_Resource_t ExtConnectivityStatsResources[] =
 /**
  * SSL certificate supported resources defined for LWM2M certificate object (10243)
  * For each resource, the resource Id, the resource type, the resource instance number,
- * a READ, WRITE, EXEC callback can be defined.
+ * a READ, WRITE, EXEC callback can be defined. The certificate is read and written in blocks
+ * through streamed READ and WRITE callbacks.
  */
 //--------------------------------------------------------------------------------------------------
 static lwm2mcore_Resource_t SslCertificateResources[] =
@@ -848,6 +1020,8 @@ static lwm2mcore_Resource_t SslCertificateResources[] =
         NULL,                                       //.read
         omanager_WriteSslCertif,                    //.write
         NULL,                                       //.exec
+        omanager_ReadSslCertif,                     //.streamRead
+        omanager_StreamWriteSslCertif,              //.streamWrite
     }
 };
 
@@ -0,0 +1,1192 @@
+/**
+ * @file observe.c
+ *
+ * Observation engine of the single-instance resources, see observe.h
+ *
+ * An observation keeps its resolved attributes and the last notified value: a number for the
+ * integer, time and float resources, a hash of the value for the other ones. A changed value is
+ * compared with the last notified one when the application signals the change.
+ *
+ * The observations and the attributes belong to the server which sent the request, identified by
+ * its short server Id: a server neither sees nor changes the ones of another server.
+ *
+ * The deadline of an observation is the end of its minimum period when a notification is pending,
+ * and the end of its maximum period otherwise. The observations with a deadline are ordered in a
+ * binary min-heap: the next deadline is found in constant time, and an observation is scheduled or
+ * removed in logarithmic time.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <lwm2mcore/lwm2mcore.h>
+#include <lwm2mcore/timer.h>
+#include "liblwm2m.h"
+#include "internals.h"
+#include "objects.h"
+#include "utils.h"
+#include "handlers.h"
+#include "observe.h"
+#include "coapRequests.h"
+#include "queueMode.h"
+#include "sessionManager.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Position of an observation which is not in the heap
+ */
+//--------------------------------------------------------------------------------------------------
+#define HEAP_POS_NONE           0xFF
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delay in seconds before a failed notification is sent again
+ */
+//--------------------------------------------------------------------------------------------------
+#define RETRY_DELAY             5
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * URI flags of a resource path
+ */
+//--------------------------------------------------------------------------------------------------
+#define URI_FLAG_RESOURCE       (LWM2M_URI_FLAG_OBJECT_ID | LWM2M_URI_FLAG_INSTANCE_ID \
+                                 | LWM2M_URI_FLAG_RESOURCE_ID)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * FNV-1a hash parameters
+ */
+//--------------------------------------------------------------------------------------------------
+#define FNV_OFFSET_BASIS        2166136261u
+#define FNV_PRIME               16777619u
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Notification attributes of a path
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint16_t    shortServerId;      ///< Short server Id of the server which set the attributes
+    lwm2m_uri_t uri;                ///< Object, object instance or resource path
+    uint8_t     mask;               ///< Attributes set on the path: LWM2M_ATTR_FLAG_xxx, 0 if the
+                                    ///< entry is not used
+    uint32_t    pmin;               ///< Minimum period in seconds
+    uint32_t    pmax;               ///< Maximum period in seconds
+    double      gt;                 ///< Greater than threshold
+    double      lt;                 ///< Less than threshold
+    double      st;                 ///< Step
+}Attributes_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Resource observation
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    bool        isUsed;                             ///< The observation is registered
+    bool        isNumeric;                          ///< The resource is an integer, time or float
+    bool        isPending;                          ///< A notification waits for the minimum period
+    uint8_t     heapPos;                            ///< Position in the heap, or HEAP_POS_NONE
+    uint8_t     token[OBSERVE_TOKEN_MAX_LEN];       ///< Token of the Observe request
+    uint8_t     tokenLen;                           ///< Token length
+    uint8_t     numericMask;                        ///< gt, lt and st attributes which are set
+    uint16_t    shortServerId;                      ///< Short server Id of the observing server
+    uint16_t    oid;                                ///< Object Id
+    uint16_t    oiid;                               ///< Object instance Id
+    uint16_t    rid;                                ///< Resource Id
+    uint16_t    format;                             ///< Content format of the notifications
+    uint32_t    pmin;                               ///< Minimum period in seconds
+    uint32_t    pmax;                               ///< Maximum period in seconds, 0 if not set
+    uint32_t    lastTime;                           ///< Time of the last notification
+    uint32_t    deadline;                           ///< Time of the next check
+    uint32_t    hash;                               ///< Hash of the last notified value
+    double      value;                              ///< Last notified value, if numeric
+    double      gt;                                 ///< Greater than threshold
+    double      lt;                                 ///< Less than threshold
+    double      st;                                 ///< Step
+}Observation_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Value of a resource, read through its read handler
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    lwm2mcore_ResourceType_t type;                  ///< Resource type
+    char        buffer[LWM2MCORE_BUFFER_MAX_LEN];   ///< Value returned by the read handler
+    size_t      len;                                ///< Value length
+    double      value;                              ///< Value, if numeric
+    uint32_t    hash;                               ///< Hash of the value
+}Value_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Notification attributes of the paths
+ */
+//--------------------------------------------------------------------------------------------------
+static Attributes_t AttributesList[OBSERVE_ATTR_MAX_NB];
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Resource observations
+ */
+//--------------------------------------------------------------------------------------------------
+static Observation_t ObservationList[OBSERVE_MAX_NB];
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Heap of the observations with a deadline: indexes in ObservationList, the first one has the
+ * earliest deadline
+ */
+//--------------------------------------------------------------------------------------------------
+static uint8_t Heap[OBSERVE_MAX_NB];
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of observations in the heap
+ */
+//--------------------------------------------------------------------------------------------------
+static uint8_t HeapNb = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Statistics of the observations
+ */
+//--------------------------------------------------------------------------------------------------
+static lwm2mcore_ObserveStats_t Stats;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *                      PRIVATE FUNCTIONS
+ */
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the current time in seconds
+ *
+ * @return
+ *      - Time in seconds
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t GetTime
+(
+    void
+)
+{
+    return (uint32_t)(lwm2mcore_GetTimeUs() / 1000000);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a period to a time. The sum saturates at UINT32_MAX, as the periods set by the server can be
+ * as large as UINT32_MAX.
+ *
+ * @return
+ *      - Time in seconds
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t AddPeriod
+(
+    uint32_t time,                      ///< [IN] Time in seconds
+    uint32_t period                     ///< [IN] Period in seconds
+)
+{
+    return (period > (UINT32_MAX - time)) ? UINT32_MAX : (time + period);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Swap two observations of the heap
+ */
+//--------------------------------------------------------------------------------------------------
+static void HeapSwap
+(
+    uint8_t pos1,                       ///< [IN] First position
+    uint8_t pos2                        ///< [IN] Second position
+)
+{
+    uint8_t index = Heap[pos1];
+
+    Heap[pos1] = Heap[pos2];
+    Heap[pos2] = index;
+    ObservationList[Heap[pos1]].heapPos = pos1;
+    ObservationList[Heap[pos2]].heapPos = pos2;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the deadline of an observation of the heap
+ *
+ * @return
+ *      - Deadline
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t HeapDeadline
+(
+    uint8_t pos                         ///< [IN] Position
+)
+{
+    return ObservationList[Heap[pos]].deadline;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Move an observation of the heap to its position, after its deadline changed
+ */
+//--------------------------------------------------------------------------------------------------
+static void HeapUpdate
+(
+    uint8_t pos                         ///< [IN] Position
+)
+{
+    /* Move up */
+    while ((0 < pos) && (HeapDeadline(pos) < HeapDeadline((uint8_t)((pos - 1) / 2))))
+    {
+        HeapSwap(pos, (uint8_t)((pos - 1) / 2));
+        pos = (uint8_t)((pos - 1) / 2);
+    }
+
+    /* Move down */
+    for (;;)
+    {
+        uint8_t first = pos;
+        int child = (2 * pos) + 1;
+
+        if ((child < HeapNb) && (HeapDeadline((uint8_t)child) < HeapDeadline(first)))
+        {
+            first = (uint8_t)child;
+        }
+        child++;
+        if ((child < HeapNb) && (HeapDeadline((uint8_t)child) < HeapDeadline(first)))
+        {
+            first = (uint8_t)child;
+        }
+
+        if (first == pos)
+        {
+            break;
+        }
+        HeapSwap(pos, first);
+        pos = first;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the deadline of an observation, and insert it in the heap if needed. The session step is
+ * run earlier if this deadline becomes the first one.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SetDeadline
+(
+    Observation_t* observationPtr,      ///< [IN] Observation
+    uint32_t deadline                   ///< [IN] Deadline
+)
+{
+    uint32_t now;
+
+    observationPtr->deadline = deadline;
+
+    if (HEAP_POS_NONE == observationPtr->heapPos)
+    {
+        observationPtr->heapPos = HeapNb;
+        Heap[HeapNb] = (uint8_t)(observationPtr - ObservationList);
+        HeapNb++;
+    }
+
+    HeapUpdate(observationPtr->heapPos);
+
+    /* The held notifications wait for the wake-up of the device */
+    if ((0 == observationPtr->heapPos) && (!smanager_QueueIsHolding()))
+    {
+        now = GetTime();
+        smanager_ScheduleStep((deadline > now) ? (deadline - now) : 0);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove an observation from the heap
+ */
+//--------------------------------------------------------------------------------------------------
+static void ClearDeadline
+(
+    Observation_t* observationPtr       ///< [IN] Observation
+)
+{
+    uint8_t pos = observationPtr->heapPos;
+
+    if (HEAP_POS_NONE == pos)
+    {
+        return;
+    }
+
+    HeapNb--;
+    if (pos != HeapNb)
+    {
+        HeapSwap(pos, HeapNb);
+        HeapUpdate(pos);
+    }
+    observationPtr->heapPos = HEAP_POS_NONE;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Schedule the next check of an observation: end of the minimum period if a notification is
+ * pending, end of the maximum period otherwise
+ */
+//--------------------------------------------------------------------------------------------------
+static void Schedule
+(
+    Observation_t* observationPtr       ///< [IN] Observation
+)
+{
+    if (observationPtr->isPending)
+    {
+        SetDeadline(observationPtr, AddPeriod(observationPtr->lastTime, observationPtr->pmin));
+    }
+    else if (observationPtr->pmax)
+    {
+        SetDeadline(observationPtr, AddPeriod(observationPtr->lastTime, observationPtr->pmax));
+    }
+    else
+    {
+        ClearDeadline(observationPtr);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compute the FNV-1a hash of a value
+ *
+ * @return
+ *      - Hash
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t HashValue
+(
+    const char* bufferPtr,              ///< [IN] Value
+    size_t len                          ///< [IN] Value length
+)
+{
+    uint32_t hash = FNV_OFFSET_BASIS;
+
+    while (len--)
+    {
+        hash ^= (uint8_t)*bufferPtr++;
+        hash *= FNV_PRIME;
+    }
+
+    return hash;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if a resource type is numeric: the gt, lt and st attributes apply
+ *
+ * @return
+ *      - true if the type is numeric
+ *      - false otherwise
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsNumeric
+(
+    lwm2mcore_ResourceType_t type       ///< [IN] Resource type
+)
+{
+    return (   (LWM2MCORE_RESOURCE_TYPE_INT == type)
+            || (LWM2MCORE_RESOURCE_TYPE_TIME == type)
+            || (LWM2MCORE_RESOURCE_TYPE_FLOAT == type));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the value of an observed resource
+ *
+ * @return
+ *      - true on success
+ *      - false if the resource cannot be read
+ */
+//--------------------------------------------------------------------------------------------------
+static bool ReadValue
+(
+    uint16_t oid,                       ///< [IN] Object Id
+    uint16_t oiid,                      ///< [IN] Object instance Id
+    uint16_t rid,                       ///< [IN] Resource Id
+    Value_t* valuePtr                   ///< [OUT] Value
+)
+{
+    valuePtr->len = sizeof(valuePtr->buffer);
+    if (COAP_205_CONTENT != omanager_ReadResource(oid, oiid, rid, &valuePtr->type,
+                                                  valuePtr->buffer, &valuePtr->len))
+    {
+        return false;
+    }
+
+    switch (valuePtr->type)
+    {
+        case LWM2MCORE_RESOURCE_TYPE_INT:
+        case LWM2MCORE_RESOURCE_TYPE_TIME:
+            valuePtr->value = (double)omanager_BytesToInt(valuePtr->buffer, valuePtr->len);
+            break;
+
+        case LWM2MCORE_RESOURCE_TYPE_FLOAT:
+            valuePtr->value = atof(valuePtr->buffer);
+            break;
+
+        default:
+            valuePtr->value = 0;
+            break;
+    }
+    valuePtr->hash = HashValue(valuePtr->buffer, valuePtr->len);
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if a changed value has to be notified, compared with the last notified value
+ *
+ * @return
+ *      - true if the value has to be notified
+ *      - false otherwise
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsNotifiable
+(
+    const Observation_t* observationPtr,    ///< [IN] Observation
+    const Value_t* valuePtr                 ///< [IN] Changed value
+)
+{
+    double last = observationPtr->value;
+    double value = valuePtr->value;
+    double delta;
+
+    if (!observationPtr->isNumeric)
+    {
+        return (valuePtr->hash != observationPtr->hash);
+    }
+
+    if (0 == observationPtr->numericMask)
+    {
+        return ((value < last) || (value > last));
+    }
+
+    if (   (observationPtr->numericMask & LWM2M_ATTR_FLAG_GREATER_THAN)
+        && (((last <= observationPtr->gt) && (value > observationPtr->gt))
+         || ((last > observationPtr->gt) && (value <= observationPtr->gt))))
+    {
+        return true;
+    }
+
+    if (   (observationPtr->numericMask & LWM2M_ATTR_FLAG_LESS_THAN)
+        && (((last >= observationPtr->lt) && (value < observationPtr->lt))
+         || ((last < observationPtr->lt) && (value >= observationPtr->lt))))
+    {
+        return true;
+    }
+
+    delta = (value > last) ? (value - last) : (last - value);
+    return (   (observationPtr->numericMask & LWM2M_ATTR_FLAG_STEP)
+            && (delta >= observationPtr->st));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send the notification of a value to the server. On failure, the notification is pending and
+ * sent again after a delay.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Notify
+(
+    lwm2mcore_Ref_t instanceRef,        ///< [IN] instance reference
+    Observation_t* observationPtr,      ///< [IN] Observation
+    Value_t* valuePtr                   ///< [IN] Value
+)
+{
+    lwm2m_media_type_t format = (lwm2m_media_type_t)observationPtr->format;
+    lwm2m_data_t data;
+    lwm2m_uri_t uri;
+    uint8_t* payloadPtr = NULL;
+    int length;
+    bool isSent = false;
+
+    memset(&uri, 0, sizeof(uri));
+    uri.flag = URI_FLAG_RESOURCE;
+    uri.objectId = observationPtr->oid;
+    uri.instanceId = observationPtr->oiid;
+    uri.resourceId = observationPtr->rid;
+
+    /* The buffer of a string or opaque value is not copied */
+    memset(&data, 0, sizeof(data));
+    data.id = observationPtr->rid;
+    switch (valuePtr->type)
+    {
+        case LWM2MCORE_RESOURCE_TYPE_INT:
+        case LWM2MCORE_RESOURCE_TYPE_TIME:
+            data.type = LWM2M_TYPE_INTEGER;
+            data.value.asInteger = omanager_BytesToInt(valuePtr->buffer, valuePtr->len);
+            break;
+
+        case LWM2MCORE_RESOURCE_TYPE_FLOAT:
+            data.type = LWM2M_TYPE_FLOAT;
+            data.value.asFloat = valuePtr->value;
+            break;
+
+        case LWM2MCORE_RESOURCE_TYPE_BOOL:
+            data.type = LWM2M_TYPE_BOOLEAN;
+            data.value.asBoolean = (0 != valuePtr->buffer[0]);
+            break;
+
+        case LWM2MCORE_RESOURCE_TYPE_STRING:
+            data.type = LWM2M_TYPE_STRING;
+            data.value.asBuffer.buffer = (uint8_t*)valuePtr->buffer;
+            data.value.asBuffer.length = valuePtr->len;
+            break;
+
+        default:
+            data.type = LWM2M_TYPE_OPAQUE;
+            data.value.asBuffer.buffer = (uint8_t*)valuePtr->buffer;
+            data.value.asBuffer.length = valuePtr->len;
+            break;
+    }
+
+    length = omanager_CoapSerialize(&uri, 1, &data, &format, &payloadPtr);
+    if (0 < length)
+    {
+        isSent = smanager_Notify(instanceRef,
+                                 observationPtr->shortServerId,
+                                 observationPtr->token,
+                                 observationPtr->tokenLen,
+                                 (uint16_t)format,
+                                 payloadPtr,
+                                 (size_t)length);
+    }
+    lwm2m_free(payloadPtr);
+
+    if (!isSent)
+    {
+        LOG_ARG("Notification of /%d/%d/%d failed",
+                observationPtr->oid, observationPtr->oiid, observationPtr->rid);
+        observationPtr->isPending = true;
+        SetDeadline(observationPtr, GetTime() + RETRY_DELAY);
+        return;
+    }
+
+    Stats.notifiedNb++;
+    observationPtr->isPending = false;
+    observationPtr->lastTime = GetTime();
+    observationPtr->value = valuePtr->value;
+    observationPtr->hash = valuePtr->hash;
+    Schedule(observationPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if a path is the same as the path of an attributes entry
+ *
+ * @return
+ *      - true if the paths are the same
+ *      - false otherwise
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsSamePath
+(
+    const lwm2m_uri_t* uriPtr,          ///< [IN] Path
+    const Attributes_t* attributesPtr   ///< [IN] Attributes entry
+)
+{
+    const lwm2m_uri_t* entryUriPtr = &attributesPtr->uri;
+
+    return (   (0 != attributesPtr->mask)
+            && (uriPtr->flag == entryUriPtr->flag)
+            && (uriPtr->objectId == entryUriPtr->objectId)
+            && (   (!(uriPtr->flag & LWM2M_URI_FLAG_INSTANCE_ID))
+                || (uriPtr->instanceId == entryUriPtr->instanceId))
+            && (   (!(uriPtr->flag & LWM2M_URI_FLAG_RESOURCE_ID))
+                || (uriPtr->resourceId == entryUriPtr->resourceId)));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Find the attributes of a path set by a server
+ *
+ * @return
+ *      - Attributes entry
+ *      - NULL if no attribute is set on the path by this server
+ */
+//--------------------------------------------------------------------------------------------------
+static Attributes_t* FindAttributes
+(
+    uint16_t shortServerId,             ///< [IN] Short server Id
+    const lwm2m_uri_t* uriPtr           ///< [IN] Path
+)
+{
+    int i;
+
+    for (i = 0; i < OBSERVE_ATTR_MAX_NB; i++)
+    {
+        if (   (shortServerId == AttributesList[i].shortServerId)
+            && (IsSamePath(uriPtr, &AttributesList[i])))
+        {
+            return &AttributesList[i];
+        }
+    }
+
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Resolve the attributes of an observation: the attributes of the resource override the ones of
+ * the object instance, which override the ones of the object and the default periods of the server
+ */
+//--------------------------------------------------------------------------------------------------
+static void ResolveAttributes
+(
+    Observation_t* observationPtr       ///< [IN] Observation
+)
+{
+    static const uint8_t flags[] =
+    {
+        LWM2M_URI_FLAG_OBJECT_ID,
+        LWM2M_URI_FLAG_OBJECT_ID | LWM2M_URI_FLAG_INSTANCE_ID,
+        URI_FLAG_RESOURCE
+    };
+    uint32_t pmin = 0;
+    uint32_t pmax = 0;
+    lwm2m_uri_t uri;
+    size_t i;
+
+    omanager_GetDefaultPeriods(&pmin, &pmax);
+    observationPtr->pmin = pmin;
+    observationPtr->pmax = pmax;
+    observationPtr->numericMask = 0;
+
+    memset(&uri, 0, sizeof(uri));
+    uri.objectId = observationPtr->oid;
+    uri.instanceId = observationPtr->oiid;
+    uri.resourceId = observationPtr->rid;
+
+    for (i = 0; i < (sizeof(flags) / sizeof(flags[0])); i++)
+    {
+        Attributes_t* attributesPtr;
+
+        uri.flag = flags[i];
+        attributesPtr = FindAttributes(observationPtr->shortServerId, &uri);
+        if (NULL == attributesPtr)
+        {
+            continue;
+        }
+
+        if (attributesPtr->mask & LWM2M_ATTR_FLAG_MIN_PERIOD)
+        {
+            observationPtr->pmin = attributesPtr->pmin;
+        }
+        if (attributesPtr->mask & LWM2M_ATTR_FLAG_MAX_PERIOD)
+        {
+            observationPtr->pmax = attributesPtr->pmax;
+        }
+        if (observationPtr->isNumeric && (attributesPtr->mask & LWM2M_ATTR_FLAG_NUMERIC))
+        {
+            observationPtr->numericMask = attributesPtr->mask & LWM2M_ATTR_FLAG_NUMERIC;
+            observationPtr->gt = attributesPtr->gt;
+            observationPtr->lt = attributesPtr->lt;
+            observationPtr->st = attributesPtr->st;
+        }
+    }
+
+    /* A maximum period lower than the minimum period is ignored */
+    if (observationPtr->pmax < observationPtr->pmin)
+    {
+        observationPtr->pmax = 0;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Find the observation of a token, registered by a server
+ *
+ * @return
+ *      - Observation
+ *      - NULL if the token is not observed by this server
+ */
+//--------------------------------------------------------------------------------------------------
+static Observation_t* FindObservation
+(
+    uint16_t shortServerId,             ///< [IN] Short server Id
+    const uint8_t* tokenPtr,            ///< [IN] Token
+    uint8_t tokenLen                    ///< [IN] Token length
+)
+{
+    int i;
+
+    for (i = 0; i < OBSERVE_MAX_NB; i++)
+    {
+        if (   (ObservationList[i].isUsed)
+            && (shortServerId == ObservationList[i].shortServerId)
+            && (tokenLen == ObservationList[i].tokenLen)
+            && (0 == memcmp(tokenPtr, ObservationList[i].token, tokenLen)))
+        {
+            return &ObservationList[i];
+        }
+    }
+
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *                      PUBLIC FUNCTIONS
+ */
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write-Attributes request.
+ *
+ * This function is called by omanager_CoapHandleMessage for a Write-Attributes request, before
+ * the request is given to Wakaama which applies the attributes to its own observations. The
+ * attributes of the server are set or cleared on the object, object instance or resource path, and
+ * the attributes of the observations of this server below this path are resolved again.
+ *
+ * @return
+ *      - COAP_204_CHANGED if the attributes are written
+ *      - COAP_400_BAD_REQUEST if the attributes are invalid: gt, lt or st on a path other than a
+ *        resource, pmax lower than pmin, lt not lower than gt, or st too large between lt and gt
+ *      - COAP_500_INTERNAL_SERVER_ERROR if the maximum number of paths is reached
+ */
+//--------------------------------------------------------------------------------------------------
+uint8_t lwm2mcore_WriteAttributes
+(
+    uint16_t shortServerId,             ///< [IN] Short server Id of the requesting server
+    const lwm2m_uri_t* uriPtr,          ///< [IN] Object, object instance or resource path
+    const lwm2m_attributes_t* attrPtr   ///< [IN] Attributes to set and to clear
+)
+{
+    Attributes_t* attributesPtr;
+    Attributes_t attributes;
+    int i;
+
+    if (   (NULL == uriPtr) || (NULL == attrPtr)
+        || (!(uriPtr->flag & LWM2M_URI_FLAG_OBJECT_ID))
+        || (attrPtr->toSet & attrPtr->toClear))
+    {
+        return COAP_400_BAD_REQUEST;
+    }
+
+    if (   (attrPtr->toSet & LWM2M_ATTR_FLAG_NUMERIC)
+        && (!(uriPtr->flag & LWM2M_URI_FLAG_RESOURCE_ID)))
+    {
+        return COAP_400_BAD_REQUEST;
+    }
+
+    attributesPtr = FindAttributes(shortServerId, uriPtr);
+    if (NULL != attributesPtr)
+    {
+        memcpy(&attributes, attributesPtr, sizeof(Attributes_t));
+    }
+    else
+    {
+        memset(&attributes, 0, sizeof(Attributes_t));
+        attributes.shortServerId = shortServerId;
+        memcpy(&attributes.uri, uriPtr, sizeof(lwm2m_uri_t));
+    }
+
+    attributes.mask &= (uint8_t)~attrPtr->toClear;
+    attributes.mask |= (uint8_t)attrPtr->toSet;
+    if (attrPtr->toSet & LWM2M_ATTR_FLAG_MIN_PERIOD)
+    {
+        attributes.pmin = attrPtr->minPeriod;
+    }
+    if (attrPtr->toSet & LWM2M_ATTR_FLAG_MAX_PERIOD)
+    {
+        attributes.pmax = attrPtr->maxPeriod;
+    }
+    if (attrPtr->toSet & LWM2M_ATTR_FLAG_GREATER_THAN)
+    {
+        attributes.gt = attrPtr->greaterThan;
+    }
+    if (attrPtr->toSet & LWM2M_ATTR_FLAG_LESS_THAN)
+    {
+        attributes.lt = attrPtr->lessThan;
+    }
+    if (attrPtr->toSet & LWM2M_ATTR_FLAG_STEP)
+    {
+        attributes.st = attrPtr->step;
+    }
+
+    /* Consistency of the attributes of the path */
+    if (   ((LWM2M_ATTR_FLAG_MIN_PERIOD | LWM2M_ATTR_FLAG_MAX_PERIOD)
+            == (attributes.mask & (LWM2M_ATTR_FLAG_MIN_PERIOD | LWM2M_ATTR_FLAG_MAX_PERIOD)))
+        && (attributes.pmax < attributes.pmin))
+    {
+        return COAP_400_BAD_REQUEST;
+    }
+    if ((attributes.mask & LWM2M_ATTR_FLAG_STEP) && (0 > attributes.st))
+    {
+        return COAP_400_BAD_REQUEST;
+    }
+    if ((LWM2M_ATTR_FLAG_GREATER_THAN | LWM2M_ATTR_FLAG_LESS_THAN)
+        == (attributes.mask & (LWM2M_ATTR_FLAG_GREATER_THAN | LWM2M_ATTR_FLAG_LESS_THAN)))
+    {
+        double step = (attributes.mask & LWM2M_ATTR_FLAG_STEP) ? attributes.st : 0;
+
+        if ((attributes.lt + (2 * step)) >= attributes.gt)
+        {
+            return COAP_400_BAD_REQUEST;
+        }
+    }
+
+    for (i = 0; (NULL == attributesPtr) && (i < OBSERVE_ATTR_MAX_NB); i++)
+    {
+        if (0 == AttributesList[i].mask)
+        {
+            attributesPtr = &AttributesList[i];
+        }
+    }
+
+    if (NULL == attributesPtr)
+    {
+        /* Clearing attributes of a path without attributes */
+        if (0 == attributes.mask)
+        {
+            return COAP_204_CHANGED;
+        }
+        LOG("Too many paths with attributes");
+        return COAP_500_INTERNAL_SERVER_ERROR;
+    }
+
+    memcpy(attributesPtr, &attributes, sizeof(Attributes_t));
+
+    /* Resolve again the attributes of the observations below the path */
+    for (i = 0; i < OBSERVE_MAX_NB; i++)
+    {
+        Observation_t* observationPtr = &ObservationList[i];
+
+        if (   (observationPtr->isUsed)
+            && (shortServerId == observationPtr->shortServerId)
+            && (uriPtr->objectId == observationPtr->oid)
+            && (   (!(uriPtr->flag & LWM2M_URI_FLAG_INSTANCE_ID))
+                || (uriPtr->instanceId == observationPtr->oiid))
+            && (   (!(uriPtr->flag & LWM2M_URI_FLAG_RESOURCE_ID))
+                || (uriPtr->resourceId == observationPtr->rid)))
+        {
+            ResolveAttributes(observationPtr);
+            Schedule(observationPtr);
+        }
+    }
+
+    LOG_ARG("Write-Attributes on /%d: mask 0x%x", uriPtr->objectId, attributes.mask);
+    return COAP_204_CHANGED;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Observe request on a resource.
+ *
+ * This function is called by omanager_CoapHandleMessage for an Observe request on a resource,
+ * once the resource is read. If the resource is a single-instance resource, the observation is
+ * handled by LwM2MCore instead of the Wakaama observation list, replacing a previous observation
+ * of the server with the same token.
+ *
+ * @return
+ *      - true if the observation is handled by LwM2MCore
+ *      - false if the path is not a single-instance resource, if the resource cannot be read or
+ *        if the maximum number of observations is reached: the request is given to Wakaama
+ */
+//--------------------------------------------------------------------------------------------------
+bool lwm2mcore_ObserveResource
+(
+    uint16_t shortServerId,             ///< [IN] Short server Id of the requesting server
+    const uint8_t* tokenPtr,            ///< [IN] Request token
+    uint8_t tokenLen,                   ///< [IN] Request token length
+    const lwm2m_uri_t* uriPtr,          ///< [IN] Observed path
+    uint16_t format                     ///< [IN] Content format of the response
+)
+{
+    Observation_t* observationPtr;
+    Value_t value;
+    int i;
+
+    if (   (NULL == tokenPtr) || (0 == tokenLen) || (OBSERVE_TOKEN_MAX_LEN < tokenLen)
+        || (NULL == uriPtr) || (URI_FLAG_RESOURCE != (uriPtr->flag & URI_FLAG_RESOURCE)))
+    {
+        return false;
+    }
+
+    observationPtr = FindObservation(shortServerId, tokenPtr, tokenLen);
+    for (i = 0; (NULL == observationPtr) && (i < OBSERVE_MAX_NB); i++)
+    {
+        if (!ObservationList[i].isUsed)
+        {
+            observationPtr = &ObservationList[i];
+        }
+    }
+
+    if (NULL == observationPtr)
+    {
+        LOG("Too many resource observations");
+        return false;
+    }
+
+    /* The value of the response is the first notified value */
+    if (!ReadValue(uriPtr->objectId, uriPtr->instanceId, uriPtr->resourceId, &value))
+    {
+        return false;
+    }
+
+    if (observationPtr->isUsed)
+    {
+        ClearDeadline(observationPtr);
+        Stats.observationNb--;
+    }
+
+    memset(observationPtr, 0, sizeof(Observation_t));
+    observationPtr->isUsed = true;
+    observationPtr->isNumeric = IsNumeric(value.type);
+    observationPtr->heapPos = HEAP_POS_NONE;
+    observationPtr->shortServerId = shortServerId;
+    memcpy(observationPtr->token, tokenPtr, tokenLen);
+    observationPtr->tokenLen = tokenLen;
+    observationPtr->oid = uriPtr->objectId;
+    observationPtr->oiid = uriPtr->instanceId;
+    observationPtr->rid = uriPtr->resourceId;
+    observationPtr->format = format;
+    observationPtr->lastTime = GetTime();
+    observationPtr->value = value.value;
+    observationPtr->hash = value.hash;
+    ResolveAttributes(observationPtr);
+    Schedule(observationPtr);
+    Stats.observationNb++;
+
+    LOG_ARG("Observe /%d/%d/%d: pmin %d, pmax %d", uriPtr->objectId, uriPtr->instanceId,
+            uriPtr->resourceId, observationPtr->pmin, observationPtr->pmax);
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Cancel a resource observation.
+ *
+ * This function is called by omanager_CoapHandleMessage for an Observe request with the Observe
+ * option set to 1, or when the server resets a notification.
+ *
+ * @return
+ *      - true if the observation is cancelled
+ *      - false if the token is not observed by the server in LwM2MCore
+ */
+//--------------------------------------------------------------------------------------------------
+bool lwm2mcore_ObserveCancel
+(
+    uint16_t shortServerId,             ///< [IN] Short server Id of the requesting server
+    const uint8_t* tokenPtr,            ///< [IN] Request token
+    uint8_t tokenLen                    ///< [IN] Request token length
+)
+{
+    Observation_t* observationPtr;
+
+    if (NULL == tokenPtr)
+    {
+        return false;
+    }
+
+    observationPtr = FindObservation(shortServerId, tokenPtr, tokenLen);
+    if (NULL == observationPtr)
+    {
+        return false;
+    }
+
+    ClearDeadline(observationPtr);
+    observationPtr->isUsed = false;
+    Stats.observationNb--;
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function to signal that the value of a single-instance resource changed.
+ *
+ * If the resource is observed, its value is read through its read handler and the server is
+ * notified according to the notification attributes.
+ *
+ * @return
+ *      - LWM2MCORE_ERR_COMPLETED_OK if the change is evaluated, or if the resource is not observed
+ *      - LWM2MCORE_ERR_INVALID_ARG if the instance reference is NULL
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_Sid_t lwm2mcore_ResourceChanged
+(
+    lwm2mcore_Ref_t instanceRef,    ///< [IN] instance reference
+    uint16_t oid,                   ///< [IN] Object Id
+    uint16_t oiid,                  ///< [IN] Object instance Id
+    uint16_t rid                    ///< [IN] Resource Id
+)
+{
+    Value_t value;
+    bool isRead = false;
+    int i;
+
+    if (NULL == instanceRef)
+    {
+        return LWM2MCORE_ERR_INVALID_ARG;
+    }
+
+    for (i = 0; i < OBSERVE_MAX_NB; i++)
+    {
+        Observation_t* observationPtr = &ObservationList[i];
+        uint32_t now;
+
+        if (   (!observationPtr->isUsed)
+            || (oid != observationPtr->oid)
+            || (oiid != observationPtr->oiid)
+            || (rid != observationPtr->rid))
+        {
+            continue;
+        }
+
+        Stats.changedNb++;
+
+        /* Already waiting for the minimum period: the value is read again at the deadline */
+        if (observationPtr->isPending)
+        {
+            continue;
+        }
+
+        /* The value is read once for all the observations of the resource */
+        if ((!isRead) && (!ReadValue(oid, oiid, rid, &value)))
+        {
+            return LWM2MCORE_ERR_COMPLETED_OK;
+        }
+        isRead = true;
+
+        if (!IsNotifiable(observationPtr, &value))
+        {
+            Stats.filteredNb++;
+            continue;
+        }
+
+        /* The notification is held in queue mode, and sent at the end of the minimum period */
+        now = GetTime();
+        if (   smanager_QueueIsHolding()
+            || ((now - observationPtr->lastTime) < observationPtr->pmin))
+        {
+            Stats.deferredNb++;
+            observationPtr->isPending = true;
+            Schedule(observationPtr);
+            continue;
+        }
+
+        Notify(instanceRef, observationPtr, &value);
+    }
+
+    return LWM2MCORE_ERR_COMPLETED_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function to retrieve the statistics of the resource observations
+ *
+ * @return
+ *      - LWM2MCORE_ERR_COMPLETED_OK if the statistics are retrieved
+ *      - LWM2MCORE_ERR_INVALID_ARG if a parameter is invalid
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_Sid_t lwm2mcore_GetObserveStats
+(
+    lwm2mcore_ObserveStats_t* statsPtr  ///< [OUT] Observation statistics
+)
+{
+    if (NULL == statsPtr)
+    {
+        return LWM2MCORE_ERR_INVALID_ARG;
+    }
+
+    memcpy(statsPtr, &Stats, sizeof(lwm2mcore_ObserveStats_t));
+    return LWM2MCORE_ERR_COMPLETED_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Notify the observations whose minimum period or maximum period is elapsed
+ */
+//--------------------------------------------------------------------------------------------------
+void omanager_ObserveCheck
+(
+    lwm2mcore_Ref_t instanceRef         ///< [IN] instance reference
+)
+{
+    uint32_t now = GetTime();
+
+    while ((0 < HeapNb) && (HeapDeadline(0) <= now))
+    {
+        Observation_t* observationPtr = &ObservationList[Heap[0]];
+        Value_t value;
+
+        if (!ReadValue(observationPtr->oid, observationPtr->oiid, observationPtr->rid, &value))
+        {
+            SetDeadline(observationPtr, now + RETRY_DELAY);
+            continue;
+        }
+
+        if (!observationPtr->isPending)
+        {
+            Stats.maxPeriodNb++;
+        }
+        Notify(instanceRef, observationPtr, &value);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the time until the next deadline of the observations
+ *
+ * @return
+ *      - Time in seconds
+ *      - UINT32_MAX if no observation is waiting for its minimum or maximum period
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t omanager_ObserveGetDelay
+(
+    void
+)
+{
+    uint32_t now;
+
+    if (0 == HeapNb)
+    {
+        return UINT32_MAX;
+    }
+
+    now = GetTime();
+    if (HeapDeadline(0) <= now)
+    {
+        return 0;
+    }
+
+    return HeapDeadline(0) - now;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Cancel all the resource observations and clear the notification attributes, when the session is
+ * closed
+ */
+//--------------------------------------------------------------------------------------------------
+void omanager_ObserveReset
+(
+    void
+)
+{
+    memset(AttributesList, 0, sizeof(AttributesList));
+    memset(ObservationList, 0, sizeof(ObservationList));
+    HeapNb = 0;
+    Stats.observationNb = 0;
+}
@@ -0,0 +1,155 @@
+/**
+ * @file observe.h
+ *
+ * Observation engine of the single-instance resources, see lwm2mcore/observe.h
+ *
+ * The notification attributes written by the server are kept in a table of paths: only the few
+ * paths which carry attributes use memory. The attributes of an observation are resolved from the
+ * resource, object instance and object paths and from the default periods of the server when the
+ * resource is observed or when attributes are written.
+ *
+ * The observations waiting for their minimum or maximum period are ordered in a heap by deadline:
+ * the session step only checks the first deadline.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#ifndef __OBSERVE_H__
+#define __OBSERVE_H__
+
+#include <lwm2mcore/observe.h>
+#include "liblwm2m.h"
+
+/**
+  * @addtogroup lwm2mcore_observe_int
+  * @{
+  */
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Maximum number of observed resources
+ */
+//--------------------------------------------------------------------------------------------------
+#define OBSERVE_MAX_NB                  32
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Maximum number of paths carrying notification attributes
+ */
+//--------------------------------------------------------------------------------------------------
+#define OBSERVE_ATTR_MAX_NB             32
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Maximum length of a CoAP token
+ */
+//--------------------------------------------------------------------------------------------------
+#define OBSERVE_TOKEN_MAX_LEN           8
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Write-Attributes request.
+ *
+ * This function is called by omanager_CoapHandleMessage for a Write-Attributes request, before
+ * the request is given to Wakaama which applies the attributes to its own observations. The
+ * attributes of the server are set or cleared on the object, object instance or resource path, and
+ * the attributes of the observations of this server below this path are resolved again.
+ *
+ * @return
+ *      - COAP_204_CHANGED if the attributes are written
+ *      - COAP_400_BAD_REQUEST if the attributes are invalid: gt, lt or st on a path other than a
+ *        resource, pmax lower than pmin, lt not lower than gt, or st too large between lt and gt
+ *      - COAP_500_INTERNAL_SERVER_ERROR if the maximum number of paths is reached
+ */
+//--------------------------------------------------------------------------------------------------
+uint8_t lwm2mcore_WriteAttributes
+(
+    uint16_t shortServerId,             ///< [IN] Short server Id of the requesting server
+    const lwm2m_uri_t* uriPtr,          ///< [IN] Object, object instance or resource path
+    const lwm2m_attributes_t* attrPtr   ///< [IN] Attributes to set and to clear
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Observe request on a resource.
+ *
+ * This function is called by omanager_CoapHandleMessage for an Observe request on a resource,
+ * once the resource is read. If the resource is a single-instance resource, the observation is
+ * handled by LwM2MCore instead of the Wakaama observation list, replacing a previous observation
+ * of the server with the same token.
+ *
+ * @return
+ *      - true if the observation is handled by LwM2MCore
+ *      - false if the path is not a single-instance resource, if the resource cannot be read or
+ *        if the maximum number of observations is reached: the request is given to Wakaama
+ */
+//--------------------------------------------------------------------------------------------------
+bool lwm2mcore_ObserveResource
+(
+    uint16_t shortServerId,             ///< [IN] Short server Id of the requesting server
+    const uint8_t* tokenPtr,            ///< [IN] Request token
+    uint8_t tokenLen,                   ///< [IN] Request token length
+    const lwm2m_uri_t* uriPtr,          ///< [IN] Observed path
+    uint16_t format                     ///< [IN] Content format of the response
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Cancel a resource observation.
+ *
+ * This function is called by omanager_CoapHandleMessage for an Observe request with the Observe
+ * option set to 1, or when the server resets a notification.
+ *
+ * @return
+ *      - true if the observation is cancelled
+ *      - false if the token is not observed by the server in LwM2MCore
+ */
+//--------------------------------------------------------------------------------------------------
+bool lwm2mcore_ObserveCancel
+(
+    uint16_t shortServerId,             ///< [IN] Short server Id of the requesting server
+    const uint8_t* tokenPtr,            ///< [IN] Request token
+    uint8_t tokenLen                    ///< [IN] Request token length
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Notify the observations whose minimum period or maximum period is elapsed
+ */
+//--------------------------------------------------------------------------------------------------
+void omanager_ObserveCheck
+(
+    lwm2mcore_Ref_t instanceRef         ///< [IN] instance reference
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Get the time until the next deadline of the observations
+ *
+ * @return
+ *      - Time in seconds
+ *      - UINT32_MAX if no observation is waiting for its minimum or maximum period
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t omanager_ObserveGetDelay
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Cancel all the resource observations and clear the notification attributes, when the
+ * session is closed
+ */
+//--------------------------------------------------------------------------------------------------
+void omanager_ObserveReset
+(
+    void
+);
+
+/**
+  * @}
+  */
+
+#endif /* __OBSERVE_H__ */
@@ -0,0 +1,289 @@
+/**
+ * @file operationStats.c
+ *
+ * Latency statistics of the LwM2M operations handled by the objects, see operationStats.h
+ *
+ * The bucket of a latency is the index of its most significant bit, so that recording a latency
+ * only costs a few atomic additions. The counters are read and written with relaxed atomic
+ * operations: a copy of a histogram may mix an operation recorded in parallel in some counters
+ * only, but each counter is consistent.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <platform/types.h>
+#include <lwm2mcore/lwm2mcore.h>
+#include <lwm2mcore/statistics.h>
+#include <lwm2mcore/timer.h>
+#include "operationStats.h"
+#include "objects.h"
+#include "internals.h"
+#include "liblwm2m.h"
+
+//--------------------------------------------------------------------------------------------------
+// Static variables
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Statistics of the objects, in the order of their first recorded operation
+ */
+//--------------------------------------------------------------------------------------------------
+static lwm2mcore_ObjectStats_t* ObjectStatsPtr[LWM2MCORE_STATS_OBJECT_MAX_NB];
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of objects with statistics
+ */
+//--------------------------------------------------------------------------------------------------
+static uint16_t ObjectStatsNb;
+
+//--------------------------------------------------------------------------------------------------
+// Static functions
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the statistics of an object, allocated if the object has no statistics yet
+ *
+ * This function is only called by the LwM2MCore thread: the new statistics are published to the
+ * other threads once initialized.
+ *
+ * @return
+ *      - Statistics of the object
+ *      - NULL if the maximum number of objects is reached or in case of allocation failure
+ */
+//--------------------------------------------------------------------------------------------------
+static lwm2mcore_ObjectStats_t* GetObjectStats
+(
+    uint16_t oid                    ///< [IN] Object Id
+)
+{
+    lwm2mcore_ObjectStats_t* statsPtr;
+    uint16_t i;
+
+    for (i = 0; i < ObjectStatsNb; i++)
+    {
+        if (oid == ObjectStatsPtr[i]->oid)
+        {
+            return ObjectStatsPtr[i];
+        }
+    }
+
+    if (LWM2MCORE_STATS_OBJECT_MAX_NB <= ObjectStatsNb)
+    {
+        return NULL;
+    }
+
+    statsPtr = (lwm2mcore_ObjectStats_t*)OMANAGER_MALLOC(sizeof(lwm2mcore_ObjectStats_t));
+    if (NULL == statsPtr)
+    {
+        LOG("Unable to allocate the object statistics");
+        return NULL;
+    }
+    memset(statsPtr, 0, sizeof(lwm2mcore_ObjectStats_t));
+    statsPtr->oid = oid;
+
+    __atomic_store_n(&ObjectStatsPtr[ObjectStatsNb], statsPtr, __ATOMIC_RELEASE);
+    __atomic_store_n(&ObjectStatsNb, ObjectStatsNb + 1, __ATOMIC_RELEASE);
+
+    return statsPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Internal functions
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a latency to a histogram
+ */
+//--------------------------------------------------------------------------------------------------
+void omanager_AddHistogramSample
+(
+    lwm2mcore_Histogram_t* histogramPtr,    ///< [INOUT] Histogram
+    uint64_t latencyUs                      ///< [IN] Latency in microseconds
+)
+{
+    uint32_t bucket = 0;
+    uint32_t maxUs;
+    uint32_t latency32Us = (UINT32_MAX < latencyUs) ? UINT32_MAX : (uint32_t)latencyUs;
+
+    if (latencyUs)
+    {
+        bucket = 63 - (uint32_t)__builtin_clzll(latencyUs);
+        if (LWM2MCORE_STATS_BUCKET_NB <= bucket)
+        {
+            bucket = LWM2MCORE_STATS_BUCKET_NB - 1;
+        }
+    }
+
+    __atomic_fetch_add(&histogramPtr->buckets[bucket], 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&histogramPtr->totalUs, latencyUs, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&histogramPtr->count, 1, __ATOMIC_RELAXED);
+
+    maxUs = __atomic_load_n(&histogramPtr->maxUs, __ATOMIC_RELAXED);
+    while ((maxUs < latency32Us)
+        && (!__atomic_compare_exchange_n(&histogramPtr->maxUs,
+                                         &maxUs,
+                                         latency32Us,
+                                         false,
+                                         __ATOMIC_RELAXED,
+                                         __ATOMIC_RELAXED)))
+    {
+        /* maxUs is updated with the current value, retry */
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Copy a histogram which may be updated by another thread
+ */
+//--------------------------------------------------------------------------------------------------
+void omanager_CopyHistogram
+(
+    const lwm2mcore_Histogram_t* srcPtr,    ///< [IN] Histogram to copy
+    lwm2mcore_Histogram_t* dstPtr           ///< [OUT] Copy
+)
+{
+    uint32_t i;
+
+    dstPtr->count = __atomic_load_n(&srcPtr->count, __ATOMIC_RELAXED);
+    dstPtr->maxUs = __atomic_load_n(&srcPtr->maxUs, __ATOMIC_RELAXED);
+    dstPtr->totalUs = __atomic_load_n(&srcPtr->totalUs, __ATOMIC_RELAXED);
+    for (i = 0; i < LWM2MCORE_STATS_BUCKET_NB; i++)
+    {
+        dstPtr->buckets[i] = __atomic_load_n(&srcPtr->buckets[i], __ATOMIC_RELAXED);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reset a histogram which may be updated by another thread
+ */
+//--------------------------------------------------------------------------------------------------
+void omanager_ResetHistogram
+(
+    lwm2mcore_Histogram_t* histogramPtr     ///< [INOUT] Histogram
+)
+{
+    uint32_t i;
+
+    __atomic_store_n(&histogramPtr->count, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&histogramPtr->maxUs, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&histogramPtr->totalUs, 0, __ATOMIC_RELAXED);
+    for (i = 0; i < LWM2MCORE_STATS_BUCKET_NB; i++)
+    {
+        __atomic_store_n(&histogramPtr->buckets[i], 0, __ATOMIC_RELAXED);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Record the latency of an operation on an object, from its start time
+ */
+//--------------------------------------------------------------------------------------------------
+void omanager_RecordLatency
+(
+    uint16_t oid,                   ///< [IN] Object Id
+    lwm2mcore_StatsOp_t op,         ///< [IN] Operation
+    bool isCallback,                ///< [IN] The latency is the one of a resource handler
+    uint64_t startTimeUs            ///< [IN] Start time of the operation, in microseconds
+                                    ///<      (see lwm2mcore_GetTimeUs())
+)
+{
+    lwm2mcore_ObjectStats_t* statsPtr;
+    uint64_t nowUs = lwm2mcore_GetTimeUs();
+
+    if (LWM2MCORE_STATS_OP_MAX <= op)
+    {
+        return;
+    }
+
+    statsPtr = GetObjectStats(oid);
+    if (NULL == statsPtr)
+    {
+        return;
+    }
+
+    omanager_AddHistogramSample(isCallback ? &statsPtr->callback[op] : &statsPtr->request[op],
+                                (nowUs > startTimeUs) ? (nowUs - startTimeUs) : 0);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public functions
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function to retrieve the statistics of an object.
+ *
+ * The statistics are recorded without lock by the LwM2MCore thread: they can be read by another
+ * thread, each counter being consistent.
+ *
+ * @return
+ *      - LWM2MCORE_ERR_COMPLETED_OK if the statistics are retrieved
+ *      - LWM2MCORE_ERR_INCORRECT_RANGE if no object has this index: the index of the objects
+ *        with statistics goes from 0 to the number of objects minus 1
+ *      - LWM2MCORE_ERR_INVALID_ARG if a parameter is invalid
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_Sid_t lwm2mcore_GetStatistics
+(
+    uint16_t index,                     ///< [IN] Index of the object
+    lwm2mcore_ObjectStats_t* statsPtr   ///< [OUT] Object statistics
+)
+{
+    lwm2mcore_ObjectStats_t* objectStatsPtr;
+    uint32_t op;
+
+    if (NULL == statsPtr)
+    {
+        return LWM2MCORE_ERR_INVALID_ARG;
+    }
+
+    if (__atomic_load_n(&ObjectStatsNb, __ATOMIC_ACQUIRE) <= index)
+    {
+        return LWM2MCORE_ERR_INCORRECT_RANGE;
+    }
+
+    objectStatsPtr = __atomic_load_n(&ObjectStatsPtr[index], __ATOMIC_ACQUIRE);
+    statsPtr->oid = objectStatsPtr->oid;
+    for (op = 0; op < LWM2MCORE_STATS_OP_MAX; op++)
+    {
+        omanager_CopyHistogram(&objectStatsPtr->request[op], &statsPtr->request[op]);
+        omanager_CopyHistogram(&objectStatsPtr->callback[op], &statsPtr->callback[op]);
+    }
+
+    return LWM2MCORE_ERR_COMPLETED_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function to reset the statistics of all the objects
+ */
+//--------------------------------------------------------------------------------------------------
+void lwm2mcore_ResetStatistics
+(
+    void
+)
+{
+    lwm2mcore_ObjectStats_t* statsPtr;
+    uint16_t objectStatsNb = __atomic_load_n(&ObjectStatsNb, __ATOMIC_ACQUIRE);
+    uint16_t i;
+    uint32_t op;
+
+    for (i = 0; i < objectStatsNb; i++)
+    {
+        statsPtr = __atomic_load_n(&ObjectStatsPtr[i], __ATOMIC_ACQUIRE);
+        for (op = 0; op < LWM2MCORE_STATS_OP_MAX; op++)
+        {
+            omanager_ResetHistogram(&statsPtr->request[op]);
+            omanager_ResetHistogram(&statsPtr->callback[op]);
+        }
+    }
+}
@@ -0,0 +1,79 @@
+/**
+ * @file operationStats.h
+ *
+ * Latency statistics of the LwM2M operations handled by the objects
+ *
+ * The latencies are recorded by the LwM2MCore thread in log-bucketed histograms, without lock: the
+ * counters are updated with atomic operations so that lwm2mcore_GetStatistics() and
+ * lwm2mcore_ResetStatistics() can be called from any thread. The statistics of an object are
+ * allocated on its first recorded operation and are kept until the end of the process, across
+ * the LwM2MCore sessions.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#ifndef __OPERATIONSTATS_H__
+#define __OPERATIONSTATS_H__
+
+#include <lwm2mcore/statistics.h>
+
+/**
+  * @addtogroup lwm2mcore_operationstats_int
+  * @{
+  */
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Add a latency to a histogram
+ */
+//--------------------------------------------------------------------------------------------------
+void omanager_AddHistogramSample
+(
+    lwm2mcore_Histogram_t* histogramPtr,    ///< [INOUT] Histogram
+    uint64_t latencyUs                      ///< [IN] Latency in microseconds
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Copy a histogram which may be updated by another thread
+ */
+//--------------------------------------------------------------------------------------------------
+void omanager_CopyHistogram
+(
+    const lwm2mcore_Histogram_t* srcPtr,    ///< [IN] Histogram to copy
+    lwm2mcore_Histogram_t* dstPtr           ///< [OUT] Copy
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Reset a histogram which may be updated by another thread
+ */
+//--------------------------------------------------------------------------------------------------
+void omanager_ResetHistogram
+(
+    lwm2mcore_Histogram_t* histogramPtr     ///< [INOUT] Histogram
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Record the latency of an operation on an object, from its start time
+ *
+ * The operation is not recorded if the maximum number of objects with statistics is reached or
+ * if the statistics can't be allocated.
+ */
+//--------------------------------------------------------------------------------------------------
+void omanager_RecordLatency
+(
+    uint16_t oid,                   ///< [IN] Object Id
+    lwm2mcore_StatsOp_t op,         ///< [IN] Operation
+    bool isCallback,                ///< [IN] The latency is the one of a resource handler
+    uint64_t startTimeUs            ///< [IN] Start time of the operation, in microseconds
+                                    ///<      (see lwm2mcore_GetTimeUs())
+);
+
+/**
+  * @}
+  */
+
+#endif /* __OPERATIONSTATS_H__ */
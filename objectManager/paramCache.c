@@ -0,0 +1,375 @@
+/**
+ * @file paramCache.c
+ *
+ * Parameter cache of LwM2MCore, see paramCache.h
+ *
+ * A cache entry is only created from a successful read or write of the parameter: a failed read
+ * is not cached, as it can't be distinguished from a temporary failure of the platform memory.
+ * When a read fills the whole buffer of the caller, the stored parameter may be longer than the
+ * cached content: the entry is then partial and only serves the reads of a shorter length.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <platform/types.h>
+#include <lwm2mcore/lwm2mcore.h>
+#include <lwm2mcore/paramStorage.h>
+#include "paramCache.h"
+#include "objects.h"
+#include "internals.h"
+#include "liblwm2m.h"
+
+//--------------------------------------------------------------------------------------------------
+// Data structures
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Cache entry of a parameter
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    bool     isLoaded;          ///< The entry contains the parameter content
+    bool     isPartial;         ///< The stored parameter may be longer than the entry content
+    bool     isDirty;           ///< The entry content is not written in platform memory
+    uint8_t* dataPtr;           ///< Parameter content
+    size_t   len;               ///< Parameter length
+}
+ParamCacheEntry_t;
+
+//--------------------------------------------------------------------------------------------------
+// Static variables
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Cache entries
+ */
+//--------------------------------------------------------------------------------------------------
+static ParamCacheEntry_t ParamCache[LWM2MCORE_MAX_PARAM];
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Cache statistics
+ */
+//--------------------------------------------------------------------------------------------------
+static omanager_ParamCacheStats_t ParamCacheStats;
+
+//--------------------------------------------------------------------------------------------------
+// Static functions
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Release the content of a cache entry
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReleaseEntry
+(
+    ParamCacheEntry_t* entryPtr     ///< [IN] Cache entry
+)
+{
+    if (entryPtr->dataPtr)
+    {
+        lwm2m_free(entryPtr->dataPtr);
+    }
+    memset(entryPtr, 0, sizeof(ParamCacheEntry_t));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the content of a cache entry
+ *
+ * @return
+ *      - true if the content is set
+ *      - false if the content can't be allocated, the entry being released
+ */
+//--------------------------------------------------------------------------------------------------
+static bool SetEntry
+(
+    ParamCacheEntry_t* entryPtr,    ///< [IN] Cache entry
+    const uint8_t*     bufferPtr,   ///< [IN] Parameter content
+    size_t             len,         ///< [IN] Parameter length
+    bool               isPartial    ///< [IN] The content may be truncated
+)
+{
+    if ((!entryPtr->dataPtr) || (entryPtr->len != len))
+    {
+        ReleaseEntry(entryPtr);
+        if (len)
+        {
+            entryPtr->dataPtr = (uint8_t*)OMANAGER_MALLOC(len);
+            if (!entryPtr->dataPtr)
+            {
+                return false;
+            }
+        }
+    }
+
+    if (len)
+    {
+        memcpy(entryPtr->dataPtr, bufferPtr, len);
+    }
+    entryPtr->len = len;
+    entryPtr->isPartial = isPartial;
+    entryPtr->isLoaded = true;
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a cache entry in platform memory
+ *
+ * @return
+ *      - LWM2MCORE_ERR_COMPLETED_OK if the treatment succeeds
+ *      - LWM2MCORE_ERR_GENERAL_ERROR if the treatment fails
+ */
+//--------------------------------------------------------------------------------------------------
+static lwm2mcore_Sid_t WriteEntry
+(
+    lwm2mcore_Param_t paramId       ///< [IN] Parameter Id
+)
+{
+    ParamCacheEntry_t* entryPtr = &ParamCache[paramId];
+    lwm2mcore_Sid_t sid;
+
+    ParamCacheStats.platformWriteNb++;
+    sid = lwm2mcore_SetParam(paramId, entryPtr->dataPtr, entryPtr->len);
+    if (LWM2MCORE_ERR_COMPLETED_OK == sid)
+    {
+        entryPtr->isDirty = false;
+    }
+    else
+    {
+        LOG_ARG("Failed to write parameter %d: %d", paramId, sid);
+    }
+
+    return sid;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Internal functions
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read a parameter, from the cache if it is loaded
+ *
+ * @return
+ *      - LWM2MCORE_ERR_COMPLETED_OK if the treatment succeeds
+ *      - LWM2MCORE_ERR_GENERAL_ERROR if the treatment fails
+ *      - LWM2MCORE_ERR_INVALID_ARG if a parameter is invalid
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_Sid_t omanager_GetParam
+(
+    lwm2mcore_Param_t paramId,      ///< [IN] Parameter Id
+    uint8_t* bufferPtr,             ///< [INOUT] Data buffer
+    size_t* lenPtr                  ///< [INOUT] Length of input buffer
+)
+{
+    ParamCacheEntry_t* entryPtr;
+    lwm2mcore_Sid_t sid;
+    size_t bufferLen;
+
+    if ((LWM2MCORE_MAX_PARAM <= paramId) || (NULL == bufferPtr) || (NULL == lenPtr))
+    {
+        return LWM2MCORE_ERR_INVALID_ARG;
+    }
+
+    entryPtr = &ParamCache[paramId];
+    bufferLen = *lenPtr;
+    ParamCacheStats.readNb++;
+
+    if ((entryPtr->isLoaded) && ((!entryPtr->isPartial) || (bufferLen <= entryPtr->len)))
+    {
+        ParamCacheStats.readHitNb++;
+        if (!entryPtr->len)
+        {
+            *lenPtr = 0;
+            return LWM2MCORE_ERR_GENERAL_ERROR;
+        }
+        if (bufferLen > entryPtr->len)
+        {
+            bufferLen = entryPtr->len;
+        }
+        memcpy(bufferPtr, entryPtr->dataPtr, bufferLen);
+        *lenPtr = bufferLen;
+        return LWM2MCORE_ERR_COMPLETED_OK;
+    }
+
+    // Parameter not cached or partial entry (never dirty): read it in platform memory
+    sid = lwm2mcore_GetParam(paramId, bufferPtr, lenPtr);
+    if ((LWM2MCORE_ERR_COMPLETED_OK == sid) && (*lenPtr) && (*lenPtr <= bufferLen))
+    {
+        SetEntry(entryPtr, bufferPtr, *lenPtr, (*lenPtr == bufferLen));
+    }
+
+    return sid;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a parameter
+ *
+ * @return
+ *      - LWM2MCORE_ERR_COMPLETED_OK if the treatment succeeds
+ *      - LWM2MCORE_ERR_GENERAL_ERROR if the treatment fails
+ *      - LWM2MCORE_ERR_INVALID_ARG if a parameter is invalid
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_Sid_t omanager_SetParam
+(
+    lwm2mcore_Param_t paramId,      ///< [IN] Parameter Id
+    const uint8_t* bufferPtr,       ///< [IN] Data buffer
+    size_t len,                     ///< [IN] Length of input buffer
+    bool isDeferred                 ///< [IN] Defer the write to the next flush
+)
+{
+    ParamCacheEntry_t* entryPtr;
+    lwm2mcore_Sid_t sid;
+
+    if ((LWM2MCORE_MAX_PARAM <= paramId) || (NULL == bufferPtr))
+    {
+        return LWM2MCORE_ERR_INVALID_ARG;
+    }
+
+    entryPtr = &ParamCache[paramId];
+    ParamCacheStats.writeNb++;
+
+    if (   (entryPtr->isLoaded)
+        && (!entryPtr->isPartial)
+        && (len == entryPtr->len)
+        && ((!len) || (0 == memcmp(entryPtr->dataPtr, bufferPtr, len)))
+       )
+    {
+        // Unchanged content: only a pending deferred write may be needed
+        if ((!entryPtr->isDirty) || (isDeferred))
+        {
+            ParamCacheStats.writeSkipNb++;
+            return LWM2MCORE_ERR_COMPLETED_OK;
+        }
+    }
+    else if (!SetEntry(entryPtr, bufferPtr, len, false))
+    {
+        // Not enough memory to cache the parameter: write it directly
+        ParamCacheStats.platformWriteNb++;
+        return lwm2mcore_SetParam(paramId, (uint8_t*)bufferPtr, len);
+    }
+
+    entryPtr->isDirty = true;
+    if (isDeferred)
+    {
+        ParamCacheStats.deferredWriteNb++;
+        return LWM2MCORE_ERR_COMPLETED_OK;
+    }
+
+    sid = WriteEntry(paramId);
+    if (LWM2MCORE_ERR_COMPLETED_OK != sid)
+    {
+        // The content of the platform memory is unknown
+        ReleaseEntry(entryPtr);
+    }
+
+    return sid;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete a parameter
+ *
+ * @return
+ *      - LWM2MCORE_ERR_COMPLETED_OK if the treatment succeeds
+ *      - LWM2MCORE_ERR_GENERAL_ERROR if the treatment fails
+ *      - LWM2MCORE_ERR_INVALID_ARG if a parameter is invalid
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_Sid_t omanager_DeleteParam
+(
+    lwm2mcore_Param_t paramId       ///< [IN] Parameter Id
+)
+{
+    if (LWM2MCORE_MAX_PARAM <= paramId)
+    {
+        return LWM2MCORE_ERR_INVALID_ARG;
+    }
+
+    ReleaseEntry(&ParamCache[paramId]);
+
+    return lwm2mcore_DeleteParam(paramId);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write all the dirty parameters in platform memory
+ *
+ * @return
+ *      - LWM2MCORE_ERR_COMPLETED_OK if all the dirty parameters are written
+ *      - LWM2MCORE_ERR_GENERAL_ERROR if a parameter can't be written, it stays dirty
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_Sid_t omanager_FlushParams
+(
+    void
+)
+{
+    lwm2mcore_Sid_t result = LWM2MCORE_ERR_COMPLETED_OK;
+    int paramId;
+
+    for (paramId = 0; paramId < LWM2MCORE_MAX_PARAM; paramId++)
+    {
+        if (   (ParamCache[paramId].isDirty)
+            && (LWM2MCORE_ERR_COMPLETED_OK != WriteEntry((lwm2mcore_Param_t)paramId))
+           )
+        {
+            result = LWM2MCORE_ERR_GENERAL_ERROR;
+        }
+    }
+
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Flush the dirty parameters and empty the cache
+ */
+//--------------------------------------------------------------------------------------------------
+void omanager_ClearParamCache
+(
+    void
+)
+{
+    int paramId;
+
+    if (LWM2MCORE_ERR_COMPLETED_OK != omanager_FlushParams())
+    {
+        LOG("Dirty parameters lost");
+    }
+
+    for (paramId = 0; paramId < LWM2MCORE_MAX_PARAM; paramId++)
+    {
+        ReleaseEntry(&ParamCache[paramId]);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the parameter cache statistics
+ */
+//--------------------------------------------------------------------------------------------------
+void omanager_GetParamCacheStats
+(
+    omanager_ParamCacheStats_t* statsPtr    ///< [OUT] Statistics
+)
+{
+    if (statsPtr)
+    {
+        memcpy(statsPtr, &ParamCacheStats, sizeof(omanager_ParamCacheStats_t));
+    }
+}
@@ -0,0 +1,135 @@
+/**
+ * @file paramCache.h
+ *
+ * Parameter cache header file
+ *
+ * The parameters stored in platform memory (see paramStorage.h) are kept in RAM once read or
+ * written: the reads are served from the cache, and the writes of an unchanged content are not
+ * done. A parameter written with the deferred flag is only marked as dirty, and all the dirty
+ * parameters are written by omanager_FlushParams() at well-defined points of the LwM2MCore
+ * processing (end of a received request, end of bootstrap, disconnection).
+ *
+ * A given parameter must always be accessed from the same thread; omanager_FlushParams() only
+ * accesses the dirty parameters.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#ifndef __PARAMCACHE_H__
+#define __PARAMCACHE_H__
+
+#include <lwm2mcore/paramStorage.h>
+
+/**
+  * @addtogroup lwm2mcore_paramcache_int
+  * @{
+  */
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Parameter cache statistics
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t readNb;            ///< Number of parameter reads
+    uint32_t readHitNb;         ///< Number of parameter reads served from the cache
+    uint32_t writeNb;           ///< Number of parameter writes
+    uint32_t writeSkipNb;       ///< Number of parameter writes skipped (unchanged content)
+    uint32_t deferredWriteNb;   ///< Number of parameter writes deferred to the next flush
+    uint32_t platformWriteNb;   ///< Number of parameter writes in platform memory
+}
+omanager_ParamCacheStats_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Read a parameter, from the cache if it is loaded
+ *
+ * @return
+ *      - LWM2MCORE_ERR_COMPLETED_OK if the treatment succeeds
+ *      - LWM2MCORE_ERR_GENERAL_ERROR if the treatment fails
+ *      - LWM2MCORE_ERR_INVALID_ARG if a parameter is invalid
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_Sid_t omanager_GetParam
+(
+    lwm2mcore_Param_t paramId,      ///< [IN] Parameter Id
+    uint8_t* bufferPtr,             ///< [INOUT] Data buffer
+    size_t* lenPtr                  ///< [INOUT] Length of input buffer
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Write a parameter. The write is skipped if the content is unchanged, and is only done by
+ * the next omanager_FlushParams() call if it is deferred.
+ *
+ * @return
+ *      - LWM2MCORE_ERR_COMPLETED_OK if the treatment succeeds
+ *      - LWM2MCORE_ERR_GENERAL_ERROR if the treatment fails
+ *      - LWM2MCORE_ERR_INVALID_ARG if a parameter is invalid
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_Sid_t omanager_SetParam
+(
+    lwm2mcore_Param_t paramId,      ///< [IN] Parameter Id
+    const uint8_t* bufferPtr,       ///< [IN] Data buffer
+    size_t len,                     ///< [IN] Length of input buffer
+    bool isDeferred                 ///< [IN] Defer the write to the next flush
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Delete a parameter. The deletion is immediately done in platform memory.
+ *
+ * @return
+ *      - LWM2MCORE_ERR_COMPLETED_OK if the treatment succeeds
+ *      - LWM2MCORE_ERR_GENERAL_ERROR if the treatment fails
+ *      - LWM2MCORE_ERR_INVALID_ARG if a parameter is invalid
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_Sid_t omanager_DeleteParam
+(
+    lwm2mcore_Param_t paramId       ///< [IN] Parameter Id
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Write all the dirty parameters in platform memory
+ *
+ * @return
+ *      - LWM2MCORE_ERR_COMPLETED_OK if all the dirty parameters are written
+ *      - LWM2MCORE_ERR_GENERAL_ERROR if a parameter can't be written, it stays dirty
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_Sid_t omanager_FlushParams
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Flush the dirty parameters and empty the cache: the next reads are done in platform
+ * memory
+ */
+//--------------------------------------------------------------------------------------------------
+void omanager_ClearParamCache
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Get the parameter cache statistics
+ */
+//--------------------------------------------------------------------------------------------------
+void omanager_GetParamCacheStats
+(
+    omanager_ParamCacheStats_t* statsPtr    ///< [OUT] Statistics
+);
+
+/**
+  * @}
+  */
+
+#endif /* __PARAMCACHE_H__ */
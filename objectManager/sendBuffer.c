@@ -0,0 +1,1038 @@
+/**
+ * @file sendBuffer.c
+ *
+ * LwM2M 1.1 Send operation, see send.h and sendBuffer.h
+ *
+ * The records are stored in a ring: the oldest records, at the head of the ring, are the records of
+ * the Send message in flight. A record keeps its value as a LwM2M data, ready to be encoded, and an
+ * upper bound of its encoded length: the records of a message are selected with these bounds
+ * before the exact payload length is computed.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <lwm2mcore/lwm2mcore.h>
+#include <lwm2mcore/send.h>
+#include <lwm2mcore/timer.h>
+#include "liblwm2m.h"
+#include "internals.h"
+#include "objects.h"
+#include "senml.h"
+#include "sendBuffer.h"
+#include "sessionManager.h"
+#include "queueMode.h"
+#include "utils.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Upper bound of the length added to the first record of a pack: array header, base name and base
+ * time
+ */
+//--------------------------------------------------------------------------------------------------
+#define PACK_OVERHEAD_LEN       (3 + (2 + SENML_NAME_MAX_LEN) + 10)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * CoAP transmission parameters of the Send messages (RFC 7252 section 4.8): initial timeout in
+ * seconds, before its random part, and number of retransmissions
+ */
+//--------------------------------------------------------------------------------------------------
+#define ACK_TIMEOUT             2
+#define MAX_RETRANSMIT          4
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Base name of a pack, the longest path shared by all its records
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    BASE_NAME_NONE,             ///< No base name, the records have an absolute path
+    BASE_NAME_OBJECT,           ///< Object path: /oid/
+    BASE_NAME_INSTANCE          ///< Object instance path: /oid/oiid/
+}BaseName_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Buffered record
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint16_t        oid;            ///< Object Id
+    uint16_t        oiid;           ///< Object instance Id
+    uint16_t        rid;            ///< Resource Id
+    uint16_t        encodedLen;     ///< Upper bound of the encoded record length
+    uint32_t        recordTime;     ///< Monotonic time of the record in seconds, for the age
+                                    ///< threshold
+    int64_t         time;           ///< Time of the value (UNIX time in seconds)
+    lwm2m_data_t    data;           ///< Value, the string and opaque values being allocated
+}SendRecord_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Configuration, the Send operation being disabled if the buffer is not allocated
+ */
+//--------------------------------------------------------------------------------------------------
+static lwm2mcore_SendConfig_t Config;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Ring of records, of Config.recordMaxNb records
+ */
+//--------------------------------------------------------------------------------------------------
+static SendRecord_t* RecordsPtr = NULL;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Index of the oldest record
+ */
+//--------------------------------------------------------------------------------------------------
+static uint16_t FirstRecord = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of buffered records
+ */
+//--------------------------------------------------------------------------------------------------
+static uint16_t RecordNb = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of records of the Send message in flight, at the head of the ring
+ */
+//--------------------------------------------------------------------------------------------------
+static uint16_t InFlightNb = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A Send message is in flight
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsInFlight = false;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Message Id of the Send message in flight
+ */
+//--------------------------------------------------------------------------------------------------
+static uint16_t InFlightMid = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of retransmissions of the Send message in flight
+ */
+//--------------------------------------------------------------------------------------------------
+static uint8_t RetransmitNb = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Timeout of the Send message in flight in seconds, doubled at each retransmission
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t AckTimeout = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Monotonic time in seconds of the end of the timeout of the Send message in flight
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t AckTime = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sum of the encoded length bounds of the records not in flight
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t PendingLen = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Monotonic time in seconds of the last Send message which could not be initiated, 0 if none
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t FailureTime = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A message was sent to the server since the last check
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsUplink = false;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A Send message is being initiated: its own transmission is not an uplink opportunity
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsSending = false;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Statistics
+ */
+//--------------------------------------------------------------------------------------------------
+static lwm2mcore_SendStats_t Stats;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *                      PRIVATE FUNCTIONS
+ */
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the monotonic time in seconds
+ *
+ * @return
+ *      - Monotonic time in seconds
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t GetTime
+(
+    void
+)
+{
+    return (uint32_t)(lwm2mcore_GetTimeUs() / 1000000);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get a record of the ring
+ *
+ * @return
+ *      - Record
+ */
+//--------------------------------------------------------------------------------------------------
+static SendRecord_t* GetRecord
+(
+    uint16_t index                  ///< [IN] Index of the record from the oldest one
+)
+{
+    return RecordsPtr + ((FirstRecord + index) % Config.recordMaxNb);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Release the value of a record
+ */
+//--------------------------------------------------------------------------------------------------
+static void FreeValue
+(
+    lwm2m_data_t* dataPtr           ///< [IN] Value
+)
+{
+    if ((LWM2M_TYPE_STRING == dataPtr->type) || (LWM2M_TYPE_OPAQUE == dataPtr->type))
+    {
+        lwm2m_free(dataPtr->value.asBuffer.buffer);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove the oldest record of the ring
+ */
+//--------------------------------------------------------------------------------------------------
+static void RemoveFirstRecord
+(
+    void
+)
+{
+    SendRecord_t* recordPtr = GetRecord(0);
+
+    FreeValue(&recordPtr->data);
+
+    if (InFlightNb)
+    {
+        InFlightNb--;
+    }
+    else
+    {
+        PendingLen -= recordPtr->encodedLen;
+    }
+
+    FirstRecord = (FirstRecord + 1) % Config.recordMaxNb;
+    RecordNb--;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * End the Send message in flight: its remaining records are sent again in the next message
+ */
+//--------------------------------------------------------------------------------------------------
+static void EndInFlight
+(
+    void
+)
+{
+    uint16_t i;
+
+    for (i = 0; i < InFlightNb; i++)
+    {
+        PendingLen += GetRecord(i)->encodedLen;
+    }
+
+    InFlightNb = 0;
+    IsInFlight = false;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Store the value returned by a read handler as a LwM2M data
+ *
+ * @return
+ *      - true on success
+ *      - false if the resource type is not supported or on memory allocation failure
+ */
+//--------------------------------------------------------------------------------------------------
+static bool StoreValue
+(
+    lwm2mcore_ResourceType_t type,  ///< [IN] Resource type
+    const char* bufferPtr,          ///< [IN] Value returned by the read handler
+    size_t len,                     ///< [IN] Value length
+    lwm2m_data_t* dataPtr           ///< [OUT] LwM2M data
+)
+{
+    memset(dataPtr, 0, sizeof(lwm2m_data_t));
+
+    switch (type)
+    {
+        case LWM2MCORE_RESOURCE_TYPE_INT:
+        case LWM2MCORE_RESOURCE_TYPE_TIME:
+            dataPtr->type = LWM2M_TYPE_INTEGER;
+            dataPtr->value.asInteger = omanager_BytesToInt(bufferPtr, len);
+            return true;
+
+        case LWM2MCORE_RESOURCE_TYPE_BOOL:
+            dataPtr->type = LWM2M_TYPE_BOOLEAN;
+            dataPtr->value.asBoolean = (0 != bufferPtr[0]);
+            return true;
+
+        case LWM2MCORE_RESOURCE_TYPE_FLOAT:
+            dataPtr->type = LWM2M_TYPE_FLOAT;
+            dataPtr->value.asFloat = atof(bufferPtr);
+            return true;
+
+        case LWM2MCORE_RESOURCE_TYPE_STRING:
+        case LWM2MCORE_RESOURCE_TYPE_OPAQUE:
+        case LWM2MCORE_RESOURCE_TYPE_UNKNOWN:
+            if (LWM2MCORE_RESOURCE_TYPE_STRING == type)
+            {
+                dataPtr->type = LWM2M_TYPE_STRING;
+            }
+            else
+            {
+                dataPtr->type = LWM2M_TYPE_OPAQUE;
+            }
+
+            if (len)
+            {
+                dataPtr->value.asBuffer.buffer = (uint8_t*)OMANAGER_MALLOC(len);
+                if (NULL == dataPtr->value.asBuffer.buffer)
+                {
+                    return false;
+                }
+                memcpy(dataPtr->value.asBuffer.buffer, bufferPtr, len);
+            }
+            dataPtr->value.asBuffer.length = len;
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write the name of a record, relative to the base name of its pack
+ */
+//--------------------------------------------------------------------------------------------------
+static void GetRecordName
+(
+    const SendRecord_t* recordPtr,  ///< [IN] Record
+    BaseName_t baseName,            ///< [IN] Base name of the pack
+    char* namePtr                   ///< [OUT] Name, of SENML_NAME_MAX_LEN bytes
+)
+{
+    switch (baseName)
+    {
+        case BASE_NAME_INSTANCE:
+            snprintf(namePtr, SENML_NAME_MAX_LEN, "%u", recordPtr->rid);
+            break;
+
+        case BASE_NAME_OBJECT:
+            snprintf(namePtr, SENML_NAME_MAX_LEN, "%u/%u", recordPtr->oiid, recordPtr->rid);
+            break;
+
+        case BASE_NAME_NONE:
+        default:
+            snprintf(namePtr, SENML_NAME_MAX_LEN, "/%u/%u/%u",
+                     recordPtr->oid, recordPtr->oiid, recordPtr->rid);
+            break;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the base name shared by the oldest records
+ *
+ * @return
+ *      - Base name
+ */
+//--------------------------------------------------------------------------------------------------
+static BaseName_t GetBaseName
+(
+    uint16_t recordNb               ///< [IN] Number of records, from the oldest one
+)
+{
+    BaseName_t baseName = BASE_NAME_INSTANCE;
+    const SendRecord_t* firstPtr = GetRecord(0);
+    uint16_t i;
+
+    for (i = 1; (i < recordNb) && (BASE_NAME_NONE != baseName); i++)
+    {
+        const SendRecord_t* recordPtr = GetRecord(i);
+
+        if (recordPtr->oid != firstPtr->oid)
+        {
+            baseName = BASE_NAME_NONE;
+        }
+        else if (recordPtr->oiid != firstPtr->oiid)
+        {
+            baseName = BASE_NAME_OBJECT;
+        }
+    }
+
+    return baseName;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Encode the oldest records in a SenML-CBOR pack
+ *
+ * @return
+ *      - Length of the pack
+ *      - 0 on failure
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t EncodePack
+(
+    uint16_t recordNb,              ///< [IN] Number of records, from the oldest one
+    uint8_t* bufferPtr,             ///< [IN] Output buffer, NULL to compute the length only
+    size_t size                     ///< [IN] Output buffer size
+)
+{
+    omanager_SenmlWriter_t writer;
+    BaseName_t baseName = GetBaseName(recordNb);
+    char name[SENML_NAME_MAX_LEN];
+    char* baseNamePtr = NULL;
+    uint16_t i;
+
+    if (BASE_NAME_NONE != baseName)
+    {
+        const SendRecord_t* firstPtr = GetRecord(0);
+
+        if (BASE_NAME_INSTANCE == baseName)
+        {
+            snprintf(name, sizeof(name), "/%u/%u/", firstPtr->oid, firstPtr->oiid);
+        }
+        else
+        {
+            snprintf(name, sizeof(name), "/%u/", firstPtr->oid);
+        }
+        baseNamePtr = name;
+    }
+
+    if (!omanager_SenmlBegin(&writer, LWM2MCORE_CONTENT_SENML_CBOR, bufferPtr, size, recordNb,
+                             baseNamePtr, GetRecord(0)->time))
+    {
+        return 0;
+    }
+
+    for (i = 0; i < recordNb; i++)
+    {
+        const SendRecord_t* recordPtr = GetRecord(i);
+
+        GetRecordName(recordPtr, baseName, name);
+        if (!omanager_SenmlAddRecord(&writer, name, recordPtr->time, &recordPtr->data))
+        {
+            return 0;
+        }
+    }
+
+    return omanager_SenmlEnd(&writer);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compute an upper bound of the encoded length of a record in a pack, excluding the pack overhead
+ *
+ * @return
+ *      - Encoded length
+ *      - 0 if the record cannot be encoded
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t GetEncodedLength
+(
+    const SendRecord_t* recordPtr   ///< [IN] Record
+)
+{
+    omanager_SenmlWriter_t writer;
+    char name[SENML_NAME_MAX_LEN];
+
+    /* The absolute path and time are never shorter than the relative ones */
+    GetRecordName(recordPtr, BASE_NAME_NONE, name);
+
+    if (   (!omanager_SenmlBegin(&writer, LWM2MCORE_CONTENT_SENML_CBOR, NULL, 0, 1, NULL, 0))
+        || (!omanager_SenmlAddRecord(&writer, name, recordPtr->time, &recordPtr->data)))
+    {
+        return 0;
+    }
+
+    return omanager_SenmlEnd(&writer);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if the payload length threshold is reached: the buffered records do not fit in a single
+ * message. The records are sized exactly only when their length bound exceeds the threshold.
+ *
+ * @return
+ *      - true if the threshold is reached
+ *      - false otherwise
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsPayloadFull
+(
+    void
+)
+{
+    if ((IsInFlight) || ((PendingLen + PACK_OVERHEAD_LEN) <= Config.payloadMaxLen))
+    {
+        return false;
+    }
+
+    return (EncodePack(RecordNb, NULL, 0) > Config.payloadMaxLen);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send the oldest records in a single message, as many as fit in the maximum payload length
+ *
+ * @return
+ *      - LWM2MCORE_ERR_COMPLETED_OK if the message is initiated or if no record is buffered
+ *      - LWM2MCORE_ERR_INVALID_STATE if a Send message is in flight, or if the device sleeps in
+ *        queue mode
+ *      - LWM2MCORE_ERR_GENERAL_ERROR if the message cannot be initiated
+ */
+//--------------------------------------------------------------------------------------------------
+static lwm2mcore_Sid_t Flush
+(
+    lwm2mcore_Ref_t instanceRef     ///< [IN] instance reference
+)
+{
+    bool isSent;
+    uint16_t recordNb = 0;
+    uint32_t length = PACK_OVERHEAD_LEN;
+    size_t payloadLen;
+    uint8_t* payloadPtr;
+    uint16_t mid = 0;
+
+    if (IsInFlight)
+    {
+        return LWM2MCORE_ERR_INVALID_STATE;
+    }
+
+    if (0 == RecordNb)
+    {
+        return LWM2MCORE_ERR_COMPLETED_OK;
+    }
+
+    /* Queue mode: the records are sent after the next wake-up */
+    if (smanager_QueueHoldSend())
+    {
+        return LWM2MCORE_ERR_INVALID_STATE;
+    }
+
+    /* Select the records with their length bounds, at least one record fitting alone */
+    while (   (recordNb < RecordNb)
+           && (   (0 == recordNb)
+               || ((length + GetRecord(recordNb)->encodedLen) <= Config.payloadMaxLen)))
+    {
+        length += GetRecord(recordNb)->encodedLen;
+        recordNb++;
+    }
+
+    /* The relative names and times are shorter: add the records which still fit */
+    payloadLen = EncodePack(recordNb, NULL, 0);
+    while (recordNb < RecordNb)
+    {
+        size_t nextLen = EncodePack(recordNb + 1, NULL, 0);
+
+        if ((0 == nextLen) || (nextLen > Config.payloadMaxLen))
+        {
+            break;
+        }
+        payloadLen = nextLen;
+        recordNb++;
+    }
+
+    while ((payloadLen > Config.payloadMaxLen) && (1 < recordNb))
+    {
+        recordNb--;
+        payloadLen = EncodePack(recordNb, NULL, 0);
+    }
+
+    payloadPtr = (uint8_t*)OMANAGER_MALLOC(payloadLen ? payloadLen : 1);
+    if (   (NULL == payloadPtr)
+        || (0 == payloadLen)
+        || (payloadLen != EncodePack(recordNb, payloadPtr, payloadLen)))
+    {
+        lwm2m_free(payloadPtr);
+        Stats.failedNb++;
+        FailureTime = GetTime();
+        return LWM2MCORE_ERR_GENERAL_ERROR;
+    }
+
+    /* Confirmable POST on /dp, kept by the CoAP layer for its retransmissions */
+    IsSending = true;
+    isSent = smanager_Send(instanceRef, LWM2MCORE_CONTENT_SENML_CBOR, payloadPtr, payloadLen, &mid);
+    IsSending = false;
+    lwm2m_free(payloadPtr);
+
+    if (!isSent)
+    {
+        Stats.failedNb++;
+        FailureTime = GetTime();
+        return LWM2MCORE_ERR_GENERAL_ERROR;
+    }
+
+    LOG_ARG("Send of %u records, %u bytes, mid %u", recordNb, (unsigned int)payloadLen, mid);
+
+    IsInFlight = true;
+    InFlightMid = mid;
+    InFlightNb = recordNb;
+    RetransmitNb = 0;
+    AckTimeout = ACK_TIMEOUT + (uint32_t)(rand() % ACK_TIMEOUT);
+    AckTime = GetTime() + AckTimeout;
+    while (recordNb)
+    {
+        recordNb--;
+        PendingLen -= GetRecord(recordNb)->encodedLen;
+    }
+    FailureTime = 0;
+    Stats.sendNb++;
+
+    return LWM2MCORE_ERR_COMPLETED_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *                      PUBLIC FUNCTIONS
+ */
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function to configure the Send operation. The buffered records are dropped.
+ *
+ * @return
+ *      - LWM2MCORE_ERR_COMPLETED_OK if the configuration is applied
+ *      - LWM2MCORE_ERR_INVALID_ARG if the configuration is invalid
+ *      - LWM2MCORE_ERR_INVALID_STATE if a Send message is in flight
+ *      - LWM2MCORE_ERR_GENERAL_ERROR on memory allocation failure
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_Sid_t lwm2mcore_SendConfigure
+(
+    const lwm2mcore_SendConfig_t* configPtr     ///< [IN] Configuration, NULL to disable the Send
+                                                ///<      operation
+)
+{
+    SendRecord_t* recordsPtr = NULL;
+
+    if (   (NULL != configPtr)
+        && (   (0 == configPtr->recordMaxNb)
+            || (LWM2MCORE_SEND_PAYLOAD_MIN_LEN > configPtr->payloadMaxLen)
+            || (LWM2MCORE_SEND_PAYLOAD_MAX_LEN < configPtr->payloadMaxLen)))
+    {
+        return LWM2MCORE_ERR_INVALID_ARG;
+    }
+
+    if (IsInFlight)
+    {
+        return LWM2MCORE_ERR_INVALID_STATE;
+    }
+
+    if (NULL != configPtr)
+    {
+        recordsPtr = (SendRecord_t*)OMANAGER_MALLOC(configPtr->recordMaxNb * sizeof(SendRecord_t));
+        if (NULL == recordsPtr)
+        {
+            return LWM2MCORE_ERR_GENERAL_ERROR;
+        }
+    }
+
+    omanager_SendFree();
+
+    if (NULL != configPtr)
+    {
+        memcpy(&Config, configPtr, sizeof(Config));
+        RecordsPtr = recordsPtr;
+    }
+
+    return LWM2MCORE_ERR_COMPLETED_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function to record the current value of a single-instance resource, read through its read
+ * handler, with a timestamp
+ *
+ * @return
+ *      - LWM2MCORE_ERR_COMPLETED_OK if the value is recorded
+ *      - LWM2MCORE_ERR_INVALID_ARG if the resource is not registered or has multiple instances
+ *      - LWM2MCORE_ERR_INVALID_STATE if the Send operation is not configured
+ *      - LWM2MCORE_ERR_OP_NOT_SUPPORTED if the resource cannot be read
+ *      - LWM2MCORE_ERR_OVERFLOW if the record is larger than the maximum payload length
+ *      - LWM2MCORE_ERR_GENERAL_ERROR if the read handler fails
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_Sid_t lwm2mcore_SendRecord
+(
+    lwm2mcore_Ref_t instanceRef,    ///< [IN] instance reference
+    uint16_t oid,                   ///< [IN] Object Id
+    uint16_t oiid,                  ///< [IN] Object instance Id
+    uint16_t rid,                   ///< [IN] Resource Id
+    int64_t time                    ///< [IN] Time of the value (UNIX time in seconds)
+)
+{
+    char buffer[LWM2MCORE_BUFFER_MAX_LEN];
+    size_t len = sizeof(buffer);
+    lwm2mcore_ResourceType_t type = LWM2MCORE_RESOURCE_TYPE_UNKNOWN;
+    SendRecord_t record;
+    size_t encodedLen;
+
+    if (NULL == RecordsPtr)
+    {
+        return LWM2MCORE_ERR_INVALID_STATE;
+    }
+
+    switch (omanager_ReadResource(oid, oiid, rid, &type, buffer, &len))
+    {
+        case COAP_205_CONTENT:
+            break;
+
+        case COAP_404_NOT_FOUND:
+            return LWM2MCORE_ERR_INVALID_ARG;
+
+        case COAP_405_METHOD_NOT_ALLOWED:
+        case COAP_501_NOT_IMPLEMENTED:
+            return LWM2MCORE_ERR_OP_NOT_SUPPORTED;
+
+        default:
+            return LWM2MCORE_ERR_GENERAL_ERROR;
+    }
+
+    record.oid = oid;
+    record.oiid = oiid;
+    record.rid = rid;
+    record.time = time;
+    record.recordTime = GetTime();
+    if (!StoreValue(type, buffer, len, &record.data))
+    {
+        return LWM2MCORE_ERR_OP_NOT_SUPPORTED;
+    }
+
+    encodedLen = GetEncodedLength(&record);
+    if ((0 == encodedLen) || ((encodedLen + PACK_OVERHEAD_LEN) > Config.payloadMaxLen))
+    {
+        FreeValue(&record.data);
+        return (encodedLen ? LWM2MCORE_ERR_OVERFLOW : LWM2MCORE_ERR_OP_NOT_SUPPORTED);
+    }
+    record.encodedLen = (uint16_t)encodedLen;
+
+    if (RecordNb == Config.recordMaxNb)
+    {
+        RemoveFirstRecord();
+        Stats.droppedNb++;
+    }
+
+    memcpy(GetRecord(RecordNb), &record, sizeof(record));
+    RecordNb++;
+    PendingLen += record.encodedLen;
+    Stats.recordedNb++;
+
+    if (IsPayloadFull())
+    {
+        Flush(instanceRef);
+    }
+
+    return LWM2MCORE_ERR_COMPLETED_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function to send the buffered records
+ *
+ * @return
+ *      - LWM2MCORE_ERR_COMPLETED_OK if a Send message is initiated or if no record is buffered
+ *      - LWM2MCORE_ERR_INVALID_STATE if the Send operation is not configured, if a Send message is
+ *        in flight, or if the device sleeps in queue mode
+ *      - LWM2MCORE_ERR_GENERAL_ERROR if the message cannot be initiated
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_Sid_t lwm2mcore_SendFlush
+(
+    lwm2mcore_Ref_t instanceRef     ///< [IN] instance reference
+)
+{
+    if (NULL == RecordsPtr)
+    {
+        return LWM2MCORE_ERR_INVALID_STATE;
+    }
+
+    return Flush(instanceRef);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function to retrieve the statistics of the Send operation
+ *
+ * @return
+ *      - LWM2MCORE_ERR_COMPLETED_OK if the statistics are retrieved
+ *      - LWM2MCORE_ERR_INVALID_ARG if a parameter is invalid
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_Sid_t lwm2mcore_GetSendStats
+(
+    lwm2mcore_SendStats_t* statsPtr     ///< [OUT] Send statistics
+)
+{
+    if (NULL == statsPtr)
+    {
+        return LWM2MCORE_ERR_INVALID_ARG;
+    }
+
+    memcpy(statsPtr, &Stats, sizeof(lwm2mcore_SendStats_t));
+    statsPtr->bufferedNb = RecordNb;
+
+    return LWM2MCORE_ERR_COMPLETED_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send the buffered records if a send threshold is reached, and retransmit the Send message in
+ * flight at the end of its timeout
+ */
+//--------------------------------------------------------------------------------------------------
+void omanager_SendCheck
+(
+    lwm2mcore_Ref_t instanceRef     ///< [IN] instance reference
+)
+{
+    bool isUplink = IsUplink;
+
+    IsUplink = false;
+
+    if ((IsInFlight) && (0 == omanager_SendGetDelay()))
+    {
+        if (MAX_RETRANSMIT <= RetransmitNb)
+        {
+            omanager_SendAck(InFlightMid, false);
+            return;
+        }
+
+        IsSending = true;
+        if (!smanager_SendAgain(instanceRef))
+        {
+            LOG_ARG("Failed to retransmit the Send mid %u", InFlightMid);
+        }
+        IsSending = false;
+
+        RetransmitNb++;
+        AckTimeout *= 2;
+        AckTime = GetTime() + AckTimeout;
+        return;
+    }
+
+    if ((NULL == RecordsPtr) || (IsInFlight) || (RecordNb == InFlightNb))
+    {
+        return;
+    }
+
+    if (   (0 == omanager_SendGetDelay())
+        || IsPayloadFull()
+        || (isUplink && Config.flushOnUplink))
+    {
+        Flush(instanceRef);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the time until the timeout of the Send message in flight ends, or until the age threshold of
+ * the buffered records is reached
+ *
+ * @return
+ *      - Time in seconds
+ *      - UINT32_MAX if no message is in flight and no record is waiting for the age threshold
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t omanager_SendGetDelay
+(
+    void
+)
+{
+    uint32_t startTime;
+    uint32_t now;
+
+    if (IsInFlight)
+    {
+        now = GetTime();
+        return (AckTime > now) ? (AckTime - now) : 0;
+    }
+
+    if ((NULL == RecordsPtr) || (RecordNb == InFlightNb) || (0 == Config.maxAge))
+    {
+        return UINT32_MAX;
+    }
+
+    /* A failed message is retried after the same delay */
+    startTime = GetRecord(0)->recordTime;
+    if (FailureTime > startTime)
+    {
+        startTime = FailureTime;
+    }
+
+    now = GetTime();
+    if ((now - startTime) >= Config.maxAge)
+    {
+        return 0;
+    }
+
+    return Config.maxAge - (now - startTime);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if a Send message is in flight
+ *
+ * @return
+ *      - true if a Send message is waiting for its acknowledgement
+ *      - false otherwise
+ */
+//--------------------------------------------------------------------------------------------------
+bool omanager_SendIsInFlight
+(
+    void
+)
+{
+    return IsInFlight;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Signal that a message was sent to the server
+ */
+//--------------------------------------------------------------------------------------------------
+void omanager_SendSignalUplink
+(
+    void
+)
+{
+    if (!IsSending)
+    {
+        IsUplink = true;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handle the end of the transaction of a Send message: its acknowledgement, or its reset, an error
+ * response or the end of its retransmissions
+ *
+ * @return
+ *      - true if the message is the Send message in flight
+ *      - false otherwise
+ */
+//--------------------------------------------------------------------------------------------------
+bool omanager_SendAck
+(
+    uint16_t mid,                   ///< [IN] Message Id
+    bool isAcknowledged             ///< [IN] The server acknowledged the message with a success
+)
+{
+    if ((!IsInFlight) || (mid != InFlightMid))
+    {
+        return false;
+    }
+
+    if (isAcknowledged)
+    {
+        Stats.ackNb++;
+        Stats.sentRecordNb += InFlightNb;
+        while (InFlightNb)
+        {
+            RemoveFirstRecord();
+        }
+    }
+    else
+    {
+        LOG_ARG("Send mid %u not acknowledged", mid);
+        Stats.failedNb++;
+        FailureTime = GetTime();
+    }
+
+    EndInFlight();
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Abort the Send message in flight, when the session is closed
+ */
+//--------------------------------------------------------------------------------------------------
+void omanager_SendAbort
+(
+    void
+)
+{
+    if (IsInFlight)
+    {
+        EndInFlight();
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Drop the buffered records and release the buffer
+ */
+//--------------------------------------------------------------------------------------------------
+void omanager_SendFree
+(
+    void
+)
+{
+    omanager_SendAbort();
+
+    if (NULL != RecordsPtr)
+    {
+        while (RecordNb)
+        {
+            RemoveFirstRecord();
+        }
+        lwm2m_free(RecordsPtr);
+        RecordsPtr = NULL;
+    }
+
+    memset(&Config, 0, sizeof(Config));
+    FirstRecord = 0;
+    PendingLen = 0;
+    FailureTime = 0;
+    IsUplink = false;
+}
@@ -0,0 +1,117 @@
+/**
+ * @file sendBuffer.h
+ *
+ * Buffer of the records of the LwM2M Send operation
+ *
+ * The session manager drives the buffer: it checks the send thresholds and the retransmission of
+ * the Send message in flight after each step and each received packet, and signals the messages
+ * sent to the server. The Send messages are confirmable POST requests on /dp, written by
+ * coapRequests.c which reports their acknowledgement.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#ifndef __SENDBUFFER_H__
+#define __SENDBUFFER_H__
+
+#include <lwm2mcore/lwm2mcore.h>
+#include <lwm2mcore/send.h>
+
+/**
+  * @addtogroup lwm2mcore_send_int
+  * @{
+  */
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Send the buffered records if a send threshold is reached, and retransmit the Send message
+ * in flight at the end of its timeout
+ */
+//--------------------------------------------------------------------------------------------------
+void omanager_SendCheck
+(
+    lwm2mcore_Ref_t instanceRef     ///< [IN] instance reference
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Get the time until the timeout of the Send message in flight ends, or until the age
+ * threshold of the buffered records is reached
+ *
+ * @return
+ *      - Time in seconds
+ *      - UINT32_MAX if no message is in flight and no record is waiting for the age threshold
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t omanager_SendGetDelay
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Check if a Send message is in flight
+ *
+ * @return
+ *      - true if a Send message is waiting for its acknowledgement
+ *      - false otherwise
+ */
+//--------------------------------------------------------------------------------------------------
+bool omanager_SendIsInFlight
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Signal that a message was sent to the server
+ */
+//--------------------------------------------------------------------------------------------------
+void omanager_SendSignalUplink
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Handle the end of the transaction of a Send message: its acknowledgement, or its reset,
+ * an error response or the end of its retransmissions
+ *
+ * @return
+ *      - true if the message is the Send message in flight
+ *      - false otherwise
+ */
+//--------------------------------------------------------------------------------------------------
+bool omanager_SendAck
+(
+    uint16_t mid,                   ///< [IN] Message Id
+    bool isAcknowledged             ///< [IN] The server acknowledged the message with a success
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Abort the Send message in flight, when the session is closed. Its records are sent again
+ * in the next message.
+ */
+//--------------------------------------------------------------------------------------------------
+void omanager_SendAbort
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Drop the buffered records and release the buffer
+ */
+//--------------------------------------------------------------------------------------------------
+void omanager_SendFree
+(
+    void
+);
+
+/**
+  * @}
+  */
+
+#endif /* __SENDBUFFER_H__ */
@@ -0,0 +1,1597 @@
+/**
+ * @file senml.c
+ *
+ * SenML encoding of the LwM2M data, see senml.h
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#include <float.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <platform/types.h>
+#include "objects.h"
+#include "senml.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * CBOR major types
+ */
+//--------------------------------------------------------------------------------------------------
+#define CBOR_UNSIGNED           0
+#define CBOR_NEGATIVE           1
+#define CBOR_BYTES              2
+#define CBOR_TEXT               3
+#define CBOR_ARRAY              4
+#define CBOR_MAP                5
+#define CBOR_TAG                6
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * CBOR simple values and float heads
+ */
+//--------------------------------------------------------------------------------------------------
+#define CBOR_FALSE              0xF4
+#define CBOR_TRUE               0xF5
+#define CBOR_FLOAT32            0xFA
+#define CBOR_FLOAT64            0xFB
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * SenML-CBOR labels (RFC 8428)
+ */
+//--------------------------------------------------------------------------------------------------
+#define SENML_LABEL_BASE_NAME   (-2)
+#define SENML_LABEL_BASE_TIME   (-3)
+#define SENML_LABEL_NAME        0
+#define SENML_LABEL_TIME        6
+#define SENML_LABEL_VALUE       2
+#define SENML_LABEL_STRING      3
+#define SENML_LABEL_BOOLEAN     4
+#define SENML_LABEL_DATA        8
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * LwM2M object link label, in SenML-JSON and SenML-CBOR
+ */
+//--------------------------------------------------------------------------------------------------
+#define SENML_OBJLNK            "vlo"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Length of a temporary buffer for a number in text
+ */
+//--------------------------------------------------------------------------------------------------
+#define NUMBER_MAX_LEN          32
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum nesting depth of the CBOR data items skipped by the reader
+ */
+//--------------------------------------------------------------------------------------------------
+#define CBOR_MAX_DEPTH          8
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * SenML pack reader
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    const uint8_t*  dataPtr;            ///< Encoded pack
+    size_t          length;             ///< Length of the encoded pack
+    size_t          offset;             ///< Offset of the next byte to read
+}
+Reader_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *                      PRIVATE FUNCTIONS
+ */
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write bytes, or only count them if the writer has no buffer
+ */
+//--------------------------------------------------------------------------------------------------
+static void Put
+(
+    omanager_SenmlWriter_t* writerPtr,  ///< [INOUT] Writer
+    const void* dataPtr,                ///< [IN] Bytes
+    size_t len                          ///< [IN] Number of bytes
+)
+{
+    if (writerPtr->bufferPtr)
+    {
+        if ((writerPtr->size - writerPtr->length) < len)
+        {
+            writerPtr->isOverflow = true;
+            return;
+        }
+        memcpy(writerPtr->bufferPtr + writerPtr->length, dataPtr, len);
+    }
+    writerPtr->length += len;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a byte
+ */
+//--------------------------------------------------------------------------------------------------
+static void PutByte
+(
+    omanager_SenmlWriter_t* writerPtr,  ///< [INOUT] Writer
+    uint8_t byte                        ///< [IN] Byte
+)
+{
+    if (writerPtr->bufferPtr)
+    {
+        if (writerPtr->size == writerPtr->length)
+        {
+            writerPtr->isOverflow = true;
+            return;
+        }
+        writerPtr->bufferPtr[writerPtr->length] = byte;
+    }
+    writerPtr->length++;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a string without its null terminator
+ */
+//--------------------------------------------------------------------------------------------------
+static void PutString
+(
+    omanager_SenmlWriter_t* writerPtr,  ///< [INOUT] Writer
+    const char* strPtr                  ///< [IN] String
+)
+{
+    Put(writerPtr, strPtr, strlen(strPtr));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Format an unsigned integer in decimal, with a null terminator
+ *
+ * @return
+ *      - Number of digits
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t FormatUint
+(
+    char* strPtr,                       ///< [OUT] Buffer of at least 21 bytes
+    uint64_t value                      ///< [IN] Integer
+)
+{
+    char digits[20];
+    size_t len = 0;
+    size_t i;
+
+    do
+    {
+        digits[len++] = (char)('0' + (value % 10));
+        value /= 10;
+    }
+    while (value);
+
+    for (i = 0; i < len; i++)
+    {
+        strPtr[i] = digits[len - 1 - i];
+    }
+    strPtr[len] = '\0';
+    return len;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a CBOR data item head, with the shortest encoding of its argument
+ */
+//--------------------------------------------------------------------------------------------------
+static void PutCborHead
+(
+    omanager_SenmlWriter_t* writerPtr,  ///< [INOUT] Writer
+    uint8_t majorType,                  ///< [IN] Major type
+    uint64_t value                      ///< [IN] Argument
+)
+{
+    uint8_t head[9];
+    size_t len;
+    size_t i;
+
+    if (24 > value)
+    {
+        head[0] = (uint8_t)((majorType << 5) | value);
+        len = 1;
+    }
+    else
+    {
+        if (UINT8_MAX >= value)
+        {
+            head[0] = (uint8_t)((majorType << 5) | 24);
+            len = 2;
+        }
+        else if (UINT16_MAX >= value)
+        {
+            head[0] = (uint8_t)((majorType << 5) | 25);
+            len = 3;
+        }
+        else if (UINT32_MAX >= value)
+        {
+            head[0] = (uint8_t)((majorType << 5) | 26);
+            len = 5;
+        }
+        else
+        {
+            head[0] = (uint8_t)((majorType << 5) | 27);
+            len = 9;
+        }
+
+        for (i = len - 1; i > 0; i--)
+        {
+            head[i] = (uint8_t)value;
+            value >>= 8;
+        }
+    }
+
+    Put(writerPtr, head, len);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a CBOR integer
+ */
+//--------------------------------------------------------------------------------------------------
+static void PutCborInt
+(
+    omanager_SenmlWriter_t* writerPtr,  ///< [INOUT] Writer
+    int64_t value                       ///< [IN] Integer
+)
+{
+    if (0 <= value)
+    {
+        PutCborHead(writerPtr, CBOR_UNSIGNED, (uint64_t)value);
+    }
+    else
+    {
+        PutCborHead(writerPtr, CBOR_NEGATIVE, (uint64_t)(-(value + 1)));
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a CBOR text or byte string
+ */
+//--------------------------------------------------------------------------------------------------
+static void PutCborString
+(
+    omanager_SenmlWriter_t* writerPtr,  ///< [INOUT] Writer
+    uint8_t majorType,                  ///< [IN] CBOR_TEXT or CBOR_BYTES
+    const void* dataPtr,                ///< [IN] String
+    size_t len                          ///< [IN] String length
+)
+{
+    PutCborHead(writerPtr, majorType, len);
+    Put(writerPtr, dataPtr, len);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a CBOR float, in single precision if no precision is lost
+ */
+//--------------------------------------------------------------------------------------------------
+static void PutCborFloat
+(
+    omanager_SenmlWriter_t* writerPtr,  ///< [INOUT] Writer
+    double value                        ///< [IN] Float
+)
+{
+    uint8_t item[9];
+    uint64_t bits;
+    size_t len;
+    size_t i;
+
+    if ((value <= FLT_MAX) && (value >= -FLT_MAX) && (!((double)(float)value < value))
+     && (!((double)(float)value > value)))
+    {
+        float single = (float)value;
+        uint32_t singleBits;
+
+        memcpy(&singleBits, &single, sizeof(singleBits));
+        item[0] = CBOR_FLOAT32;
+        bits = singleBits;
+        len = 5;
+    }
+    else
+    {
+        memcpy(&bits, &value, sizeof(bits));
+        item[0] = CBOR_FLOAT64;
+        len = 9;
+    }
+
+    for (i = len - 1; i > 0; i--)
+    {
+        item[i] = (uint8_t)bits;
+        bits >>= 8;
+    }
+
+    Put(writerPtr, item, len);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a JSON string, with its quotes
+ */
+//--------------------------------------------------------------------------------------------------
+static void PutJsonString
+(
+    omanager_SenmlWriter_t* writerPtr,  ///< [INOUT] Writer
+    const char* strPtr,                 ///< [IN] String
+    size_t len                          ///< [IN] String length
+)
+{
+    static const char hex[] = "0123456789abcdef";
+    size_t start = 0;
+    size_t i;
+
+    PutByte(writerPtr, '"');
+    for (i = 0; i < len; i++)
+    {
+        uint8_t c = (uint8_t)strPtr[i];
+
+        if (('"' == c) || ('\\' == c) || (0x20 > c))
+        {
+            Put(writerPtr, strPtr + start, i - start);
+            start = i + 1;
+
+            PutByte(writerPtr, '\\');
+            switch (c)
+            {
+                case '"':
+                case '\\':
+                    PutByte(writerPtr, c);
+                    break;
+
+                case '\n':
+                    PutByte(writerPtr, 'n');
+                    break;
+
+                case '\r':
+                    PutByte(writerPtr, 'r');
+                    break;
+
+                case '\t':
+                    PutByte(writerPtr, 't');
+                    break;
+
+                default:
+                {
+                    char escape[5] = {'u', '0', '0', hex[c >> 4], hex[c & 0x0F]};
+                    Put(writerPtr, escape, sizeof(escape));
+                }
+                break;
+            }
+        }
+    }
+    Put(writerPtr, strPtr + start, len - start);
+    PutByte(writerPtr, '"');
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write opaque data as a JSON string in base64url without padding (RFC 8428)
+ */
+//--------------------------------------------------------------------------------------------------
+static void PutJsonBase64
+(
+    omanager_SenmlWriter_t* writerPtr,  ///< [INOUT] Writer
+    const uint8_t* dataPtr,             ///< [IN] Data
+    size_t len                          ///< [IN] Data length
+)
+{
+    static const char alphabet[] =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+    char quad[4];
+    size_t i;
+
+    PutByte(writerPtr, '"');
+    for (i = 0; (i + 3) <= len; i += 3)
+    {
+        uint32_t bits = ((uint32_t)dataPtr[i] << 16) | ((uint32_t)dataPtr[i + 1] << 8)
+                        | dataPtr[i + 2];
+
+        quad[0] = alphabet[(bits >> 18) & 0x3F];
+        quad[1] = alphabet[(bits >> 12) & 0x3F];
+        quad[2] = alphabet[(bits >> 6) & 0x3F];
+        quad[3] = alphabet[bits & 0x3F];
+        Put(writerPtr, quad, 4);
+    }
+
+    if (i < len)
+    {
+        uint32_t bits = (uint32_t)dataPtr[i] << 16;
+
+        if ((i + 1) < len)
+        {
+            bits |= (uint32_t)dataPtr[i + 1] << 8;
+        }
+        quad[0] = alphabet[(bits >> 18) & 0x3F];
+        quad[1] = alphabet[(bits >> 12) & 0x3F];
+        quad[2] = alphabet[(bits >> 6) & 0x3F];
+        Put(writerPtr, quad, ((i + 1) < len) ? 3 : 2);
+    }
+    PutByte(writerPtr, '"');
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a JSON number from an integer
+ */
+//--------------------------------------------------------------------------------------------------
+static void PutJsonInt
+(
+    omanager_SenmlWriter_t* writerPtr,  ///< [INOUT] Writer
+    int64_t value                       ///< [IN] Integer
+)
+{
+    char number[NUMBER_MAX_LEN];
+    size_t len;
+
+    if (0 > value)
+    {
+        number[0] = '-';
+        len = 1 + FormatUint(number + 1, (uint64_t)(-(value + 1)) + 1);
+    }
+    else
+    {
+        len = FormatUint(number, (uint64_t)value);
+    }
+    Put(writerPtr, number, len);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a JSON number from a float, with the shortest of the 15 and 17 digit representations
+ * which keeps the value
+ *
+ * @return
+ *      - true on success
+ *      - false if the value is not finite
+ */
+//--------------------------------------------------------------------------------------------------
+static bool PutJsonFloat
+(
+    omanager_SenmlWriter_t* writerPtr,  ///< [INOUT] Writer
+    double value                        ///< [IN] Float
+)
+{
+    char number[NUMBER_MAX_LEN];
+    double readValue;
+
+    if (!((value <= DBL_MAX) && (value >= -DBL_MAX)))
+    {
+        return false;
+    }
+
+    snprintf(number, sizeof(number), "%.15g", value);
+    readValue = strtod(number, NULL);
+    if ((readValue < value) || (readValue > value))
+    {
+        snprintf(number, sizeof(number), "%.17g", value);
+    }
+    PutString(writerPtr, number);
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a SenML-JSON record key
+ */
+//--------------------------------------------------------------------------------------------------
+static void PutJsonKey
+(
+    omanager_SenmlWriter_t* writerPtr,  ///< [INOUT] Writer
+    const char* keyPtr,                 ///< [IN] Key, with its quotes and colon
+    bool* isFirstPtr                    ///< [INOUT] First key of the record
+)
+{
+    if (!*isFirstPtr)
+    {
+        PutByte(writerPtr, ',');
+    }
+    *isFirstPtr = false;
+    PutString(writerPtr, keyPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a SenML-JSON record
+ *
+ * @return
+ *      - true on success
+ *      - false if the value can't be encoded
+ */
+//--------------------------------------------------------------------------------------------------
+static bool PutJsonRecord
+(
+    omanager_SenmlWriter_t* writerPtr,  ///< [INOUT] Writer
+    bool isFirstRecord,                 ///< [IN] First record of the pack
+    const char* namePtr,                ///< [IN] Record name
+    int64_t relativeTime,               ///< [IN] Time relative to the base time, 0 if not used
+    const lwm2m_data_t* dataPtr         ///< [IN] Value
+)
+{
+    bool isFirst = true;
+    bool result = true;
+
+    if (!isFirstRecord)
+    {
+        PutByte(writerPtr, ',');
+    }
+    PutByte(writerPtr, '{');
+
+    if (isFirstRecord && ('\0' != writerPtr->baseName[0]))
+    {
+        PutJsonKey(writerPtr, "\"bn\":", &isFirst);
+        PutJsonString(writerPtr, writerPtr->baseName, strlen(writerPtr->baseName));
+    }
+    if (isFirstRecord && (0 != writerPtr->baseTime))
+    {
+        PutJsonKey(writerPtr, "\"bt\":", &isFirst);
+        PutJsonInt(writerPtr, writerPtr->baseTime);
+    }
+    PutJsonKey(writerPtr, "\"n\":", &isFirst);
+    PutJsonString(writerPtr, namePtr, strlen(namePtr));
+    if (0 != relativeTime)
+    {
+        PutJsonKey(writerPtr, "\"t\":", &isFirst);
+        PutJsonInt(writerPtr, relativeTime);
+    }
+
+    switch (dataPtr->type)
+    {
+        case LWM2M_TYPE_INTEGER:
+            PutJsonKey(writerPtr, "\"v\":", &isFirst);
+            PutJsonInt(writerPtr, dataPtr->value.asInteger);
+            break;
+
+        case LWM2M_TYPE_FLOAT:
+            PutJsonKey(writerPtr, "\"v\":", &isFirst);
+            result = PutJsonFloat(writerPtr, dataPtr->value.asFloat);
+            break;
+
+        case LWM2M_TYPE_BOOLEAN:
+            PutJsonKey(writerPtr, "\"vb\":", &isFirst);
+            PutString(writerPtr, dataPtr->value.asBoolean ? "true" : "false");
+            break;
+
+        case LWM2M_TYPE_STRING:
+            PutJsonKey(writerPtr, "\"vs\":", &isFirst);
+            PutJsonString(writerPtr,
+                          (const char*)dataPtr->value.asBuffer.buffer,
+                          dataPtr->value.asBuffer.length);
+            break;
+
+        case LWM2M_TYPE_OPAQUE:
+            PutJsonKey(writerPtr, "\"vd\":", &isFirst);
+            PutJsonBase64(writerPtr,
+                          dataPtr->value.asBuffer.buffer,
+                          dataPtr->value.asBuffer.length);
+            break;
+
+        case LWM2M_TYPE_OBJECT_LINK:
+        {
+            char link[NUMBER_MAX_LEN];
+
+            snprintf(link, sizeof(link), "\"%u:%u\"",
+                     dataPtr->value.asObjLink.objectId,
+                     dataPtr->value.asObjLink.objectInstanceId);
+            PutJsonKey(writerPtr, "\"" SENML_OBJLNK "\":", &isFirst);
+            PutString(writerPtr, link);
+        }
+        break;
+
+        default:
+            result = false;
+            break;
+    }
+
+    PutByte(writerPtr, '}');
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a SenML-CBOR record
+ *
+ * @return
+ *      - true on success
+ *      - false if the value can't be encoded
+ */
+//--------------------------------------------------------------------------------------------------
+static bool PutCborRecord
+(
+    omanager_SenmlWriter_t* writerPtr,  ///< [INOUT] Writer
+    bool isFirstRecord,                 ///< [IN] First record of the pack
+    const char* namePtr,                ///< [IN] Record name
+    int64_t relativeTime,               ///< [IN] Time relative to the base time, 0 if not used
+    const lwm2m_data_t* dataPtr         ///< [IN] Value
+)
+{
+    bool hasBaseName = isFirstRecord && ('\0' != writerPtr->baseName[0]);
+    bool hasBaseTime = isFirstRecord && (0 != writerPtr->baseTime);
+    uint64_t pairNb = 2 + (hasBaseName ? 1 : 0) + (hasBaseTime ? 1 : 0)
+                      + ((0 != relativeTime) ? 1 : 0);
+
+    PutCborHead(writerPtr, CBOR_MAP, pairNb);
+    if (hasBaseName)
+    {
+        PutCborInt(writerPtr, SENML_LABEL_BASE_NAME);
+        PutCborString(writerPtr, CBOR_TEXT, writerPtr->baseName, strlen(writerPtr->baseName));
+    }
+    if (hasBaseTime)
+    {
+        PutCborInt(writerPtr, SENML_LABEL_BASE_TIME);
+        PutCborInt(writerPtr, writerPtr->baseTime);
+    }
+    PutCborInt(writerPtr, SENML_LABEL_NAME);
+    PutCborString(writerPtr, CBOR_TEXT, namePtr, strlen(namePtr));
+    if (0 != relativeTime)
+    {
+        PutCborInt(writerPtr, SENML_LABEL_TIME);
+        PutCborInt(writerPtr, relativeTime);
+    }
+
+    switch (dataPtr->type)
+    {
+        case LWM2M_TYPE_INTEGER:
+            PutCborInt(writerPtr, SENML_LABEL_VALUE);
+            PutCborInt(writerPtr, dataPtr->value.asInteger);
+            break;
+
+        case LWM2M_TYPE_FLOAT:
+            PutCborInt(writerPtr, SENML_LABEL_VALUE);
+            PutCborFloat(writerPtr, dataPtr->value.asFloat);
+            break;
+
+        case LWM2M_TYPE_BOOLEAN:
+            PutCborInt(writerPtr, SENML_LABEL_BOOLEAN);
+            PutByte(writerPtr, dataPtr->value.asBoolean ? CBOR_TRUE : CBOR_FALSE);
+            break;
+
+        case LWM2M_TYPE_STRING:
+            PutCborInt(writerPtr, SENML_LABEL_STRING);
+            PutCborString(writerPtr,
+                          CBOR_TEXT,
+                          dataPtr->value.asBuffer.buffer,
+                          dataPtr->value.asBuffer.length);
+            break;
+
+        case LWM2M_TYPE_OPAQUE:
+            PutCborInt(writerPtr, SENML_LABEL_DATA);
+            PutCborString(writerPtr,
+                          CBOR_BYTES,
+                          dataPtr->value.asBuffer.buffer,
+                          dataPtr->value.asBuffer.length);
+            break;
+
+        case LWM2M_TYPE_OBJECT_LINK:
+        {
+            char link[NUMBER_MAX_LEN];
+            int len;
+
+            len = snprintf(link, sizeof(link), "%u:%u",
+                           dataPtr->value.asObjLink.objectId,
+                           dataPtr->value.asObjLink.objectInstanceId);
+            PutCborString(writerPtr, CBOR_TEXT, SENML_OBJLNK, sizeof(SENML_OBJLNK) - 1);
+            PutCborString(writerPtr, CBOR_TEXT, link, (size_t)len);
+        }
+        break;
+
+        default:
+            return false;
+    }
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Count the records of a data tree
+ *
+ * @return
+ *      - Number of records
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t CountRecords
+(
+    int dataNb,                         ///< [IN] Number of data
+    const lwm2m_data_t* dataPtr         ///< [IN] Data
+)
+{
+    uint32_t recordNb = 0;
+    int i;
+
+    for (i = 0; i < dataNb; i++)
+    {
+        switch (dataPtr[i].type)
+        {
+            case LWM2M_TYPE_OBJECT:
+            case LWM2M_TYPE_OBJECT_INSTANCE:
+            case LWM2M_TYPE_MULTIPLE_RESOURCE:
+                recordNb += CountRecords((int)dataPtr[i].value.asChildren.count,
+                                         dataPtr[i].value.asChildren.array);
+                break;
+
+            case LWM2M_TYPE_UNDEFINED:
+                break;
+
+            default:
+                recordNb++;
+                break;
+        }
+    }
+
+    return recordNb;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write the records of a data tree, named from a path prefix
+ *
+ * @return
+ *      - true on success
+ *      - false on failure
+ */
+//--------------------------------------------------------------------------------------------------
+static bool WriteRecords
+(
+    omanager_SenmlWriter_t* writerPtr,  ///< [INOUT] Writer
+    char* namePtr,                      ///< [INOUT] Name buffer of SENML_NAME_MAX_LEN bytes
+    size_t prefixLen,                   ///< [IN] Length of the path prefix in the name buffer
+    int dataNb,                         ///< [IN] Number of data
+    const lwm2m_data_t* dataPtr         ///< [IN] Data
+)
+{
+    int i;
+
+    for (i = 0; i < dataNb; i++)
+    {
+        size_t len;
+
+        // Room for an identifier of 5 digits, a slash and the null terminator
+        if ((SENML_NAME_MAX_LEN - prefixLen) < 7)
+        {
+            return false;
+        }
+        len = FormatUint(namePtr + prefixLen, dataPtr[i].id);
+
+        switch (dataPtr[i].type)
+        {
+            case LWM2M_TYPE_OBJECT:
+            case LWM2M_TYPE_OBJECT_INSTANCE:
+            case LWM2M_TYPE_MULTIPLE_RESOURCE:
+                namePtr[prefixLen + len] = '/';
+                namePtr[prefixLen + len + 1] = '\0';
+                if (!WriteRecords(writerPtr,
+                                  namePtr,
+                                  prefixLen + len + 1,
+                                  (int)dataPtr[i].value.asChildren.count,
+                                  dataPtr[i].value.asChildren.array))
+                {
+                    return false;
+                }
+                break;
+
+            case LWM2M_TYPE_UNDEFINED:
+                break;
+
+            default:
+                if (!omanager_SenmlAddRecord(writerPtr, namePtr, 0, &dataPtr[i]))
+                {
+                    return false;
+                }
+                break;
+        }
+    }
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Join a base name and a name
+ *
+ * @return
+ *      - true on success
+ *      - false if the full name is too long
+ */
+//--------------------------------------------------------------------------------------------------
+static bool JoinName
+(
+    char* fullNamePtr,                  ///< [OUT] Full name, of SENML_NAME_MAX_LEN bytes
+    const char* baseNamePtr,            ///< [IN] Base name
+    const char* namePtr                 ///< [IN] Name
+)
+{
+    size_t baseNameLen = strlen(baseNamePtr);
+    size_t nameLen = strlen(namePtr);
+
+    if ((baseNameLen + nameLen) >= SENML_NAME_MAX_LEN)
+    {
+        return false;
+    }
+
+    memcpy(fullNamePtr, baseNamePtr, baseNameLen);
+    memcpy(fullNamePtr + baseNameLen, namePtr, nameLen + 1);
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read a CBOR data item head. The indefinite lengths are not supported.
+ *
+ * @return
+ *      - true on success
+ *      - false if the head is truncated or not supported
+ */
+//--------------------------------------------------------------------------------------------------
+static bool GetCborHead
+(
+    Reader_t* readerPtr,                ///< [INOUT] Reader
+    uint8_t* majorTypePtr,              ///< [OUT] Major type
+    uint64_t* valuePtr                  ///< [OUT] Argument
+)
+{
+    uint8_t info;
+    size_t len;
+
+    if (readerPtr->offset >= readerPtr->length)
+    {
+        return false;
+    }
+
+    *majorTypePtr = readerPtr->dataPtr[readerPtr->offset] >> 5;
+    info = readerPtr->dataPtr[readerPtr->offset] & 0x1F;
+    readerPtr->offset++;
+
+    if (24 > info)
+    {
+        *valuePtr = info;
+        return true;
+    }
+
+    if (27 < info)
+    {
+        return false;
+    }
+
+    len = (size_t)1 << (info - 24);
+    if ((readerPtr->length - readerPtr->offset) < len)
+    {
+        return false;
+    }
+
+    *valuePtr = 0;
+    while (len--)
+    {
+        *valuePtr = (*valuePtr << 8) | readerPtr->dataPtr[readerPtr->offset++];
+    }
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Skip a CBOR data item
+ *
+ * @return
+ *      - true on success
+ *      - false if the data item is truncated, not supported or too deeply nested
+ */
+//--------------------------------------------------------------------------------------------------
+static bool SkipCborItem
+(
+    Reader_t* readerPtr,                ///< [INOUT] Reader
+    int depth                           ///< [IN] Nesting depth of the data item
+)
+{
+    uint8_t majorType;
+    uint64_t value;
+    uint64_t i;
+
+    if ((CBOR_MAX_DEPTH < depth) || (!GetCborHead(readerPtr, &majorType, &value)))
+    {
+        return false;
+    }
+
+    switch (majorType)
+    {
+        case CBOR_BYTES:
+        case CBOR_TEXT:
+            if ((readerPtr->length - readerPtr->offset) < value)
+            {
+                return false;
+            }
+            readerPtr->offset += (size_t)value;
+            return true;
+
+        case CBOR_MAP:
+            if ((UINT64_MAX / 2) < value)
+            {
+                return false;
+            }
+            value *= 2;
+            // Fall through
+        case CBOR_ARRAY:
+            for (i = 0; i < value; i++)
+            {
+                if (!SkipCborItem(readerPtr, depth + 1))
+                {
+                    return false;
+                }
+            }
+            return true;
+
+        case CBOR_TAG:
+            return SkipCborItem(readerPtr, depth + 1);
+
+        default:
+            // Integers, simple values and floats: the argument is the whole data item
+            return true;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read a CBOR text string
+ *
+ * @return
+ *      - true on success
+ *      - false if the data item is not a text string or if it is too long
+ */
+//--------------------------------------------------------------------------------------------------
+static bool GetCborText
+(
+    Reader_t* readerPtr,                ///< [INOUT] Reader
+    char* strPtr,                       ///< [OUT] String
+    size_t size                         ///< [IN] String buffer size
+)
+{
+    uint8_t majorType;
+    uint64_t len;
+
+    if (   (!GetCborHead(readerPtr, &majorType, &len))
+        || (CBOR_TEXT != majorType)
+        || (size <= len)
+        || ((readerPtr->length - readerPtr->offset) < len))
+    {
+        return false;
+    }
+
+    memcpy(strPtr, readerPtr->dataPtr + readerPtr->offset, (size_t)len);
+    strPtr[len] = '\0';
+    readerPtr->offset += (size_t)len;
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the names of a SenML-CBOR pack
+ *
+ * @return
+ *      - Number of names
+ *      - -1 if the pack is invalid or if it has too many names
+ */
+//--------------------------------------------------------------------------------------------------
+static int GetCborNames
+(
+    Reader_t* readerPtr,                        ///< [INOUT] Reader
+    char (*namesPtr)[SENML_NAME_MAX_LEN],       ///< [OUT] Names
+    int maxNb                                   ///< [IN] Maximum number of names
+)
+{
+    char baseName[SENML_NAME_MAX_LEN] = "";
+    char name[SENML_NAME_MAX_LEN];
+    uint8_t majorType;
+    uint64_t recordNb;
+    uint64_t pairNb;
+    uint64_t i;
+    uint64_t j;
+
+    if (   (!GetCborHead(readerPtr, &majorType, &recordNb))
+        || (CBOR_ARRAY != majorType)
+        || ((uint64_t)maxNb < recordNb))
+    {
+        return -1;
+    }
+
+    for (i = 0; i < recordNb; i++)
+    {
+        name[0] = '\0';
+
+        if ((!GetCborHead(readerPtr, &majorType, &pairNb)) || (CBOR_MAP != majorType))
+        {
+            return -1;
+        }
+
+        for (j = 0; j < pairNb; j++)
+        {
+            uint64_t label;
+            bool isSkipped = true;
+
+            if (!GetCborHead(readerPtr, &majorType, &label))
+            {
+                return -1;
+            }
+
+            if ((CBOR_NEGATIVE == majorType) && ((-1 - SENML_LABEL_BASE_NAME) == label))
+            {
+                if (!GetCborText(readerPtr, baseName, sizeof(baseName)))
+                {
+                    return -1;
+                }
+                isSkipped = false;
+            }
+            else if ((CBOR_UNSIGNED == majorType) && (SENML_LABEL_NAME == label))
+            {
+                if (!GetCborText(readerPtr, name, sizeof(name)))
+                {
+                    return -1;
+                }
+                isSkipped = false;
+            }
+            else if (CBOR_TEXT == majorType)
+            {
+                // Text label, such as the object link label
+                if ((readerPtr->length - readerPtr->offset) < label)
+                {
+                    return -1;
+                }
+                readerPtr->offset += (size_t)label;
+            }
+
+            if (isSkipped && (!SkipCborItem(readerPtr, 0)))
+            {
+                return -1;
+            }
+        }
+
+        if (!JoinName(namesPtr[i], baseName, name))
+        {
+            return -1;
+        }
+    }
+
+    return (readerPtr->offset == readerPtr->length) ? (int)recordNb : -1;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Skip the JSON white spaces and read a character
+ *
+ * @return
+ *      - Character
+ *      - '\0' at the end of the pack
+ */
+//--------------------------------------------------------------------------------------------------
+static char GetJsonChar
+(
+    Reader_t* readerPtr                 ///< [INOUT] Reader
+)
+{
+    while (readerPtr->offset < readerPtr->length)
+    {
+        char c = (char)readerPtr->dataPtr[readerPtr->offset++];
+
+        if ((' ' != c) && ('\t' != c) && ('\n' != c) && ('\r' != c))
+        {
+            return c;
+        }
+    }
+
+    return '\0';
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read a JSON string, after its opening quote. Only the escaped quote, reverse solidus and solidus
+ * are supported.
+ *
+ * @return
+ *      - true on success
+ *      - false if the string is truncated, not supported or too long
+ */
+//--------------------------------------------------------------------------------------------------
+static bool GetJsonString
+(
+    Reader_t* readerPtr,                ///< [INOUT] Reader
+    char* strPtr,                       ///< [OUT] String, NULL to skip it
+    size_t size                         ///< [IN] String buffer size
+)
+{
+    size_t len = 0;
+
+    while (readerPtr->offset < readerPtr->length)
+    {
+        char c = (char)readerPtr->dataPtr[readerPtr->offset++];
+
+        if ('"' == c)
+        {
+            if (strPtr)
+            {
+                strPtr[len] = '\0';
+            }
+            return true;
+        }
+
+        if ('\\' == c)
+        {
+            if (readerPtr->offset == readerPtr->length)
+            {
+                return false;
+            }
+            c = (char)readerPtr->dataPtr[readerPtr->offset++];
+            if (('"' != c) && ('\\' != c) && ('/' != c))
+            {
+                return false;
+            }
+        }
+
+        if (strPtr)
+        {
+            if ((len + 1) >= size)
+            {
+                return false;
+            }
+            strPtr[len] = c;
+        }
+        len++;
+    }
+
+    return false;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Skip a JSON value: a string, a number, true or false
+ *
+ * @return
+ *      - true on success
+ *      - false if the value is not supported
+ */
+//--------------------------------------------------------------------------------------------------
+static bool SkipJsonValue
+(
+    Reader_t* readerPtr                 ///< [INOUT] Reader
+)
+{
+    char c = GetJsonChar(readerPtr);
+    size_t len = 0;
+
+    if ('"' == c)
+    {
+        return GetJsonString(readerPtr, NULL, 0);
+    }
+
+    if ('\0' == c)
+    {
+        return false;
+    }
+
+    while (   (('-' == c) || ('+' == c) || ('.' == c) || (('0' <= c) && ('9' >= c))
+               || (('a' <= c) && ('z' >= c)) || ('E' == c)))
+    {
+        len++;
+        if (readerPtr->offset == readerPtr->length)
+        {
+            return true;
+        }
+        c = (char)readerPtr->dataPtr[readerPtr->offset++];
+    }
+
+    // Give back the character ending the value
+    readerPtr->offset--;
+    return (0 != len);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the names of a SenML-JSON pack
+ *
+ * @return
+ *      - Number of names
+ *      - -1 if the pack is invalid or if it has too many names
+ */
+//--------------------------------------------------------------------------------------------------
+static int GetJsonNames
+(
+    Reader_t* readerPtr,                        ///< [INOUT] Reader
+    char (*namesPtr)[SENML_NAME_MAX_LEN],       ///< [OUT] Names
+    int maxNb                                   ///< [IN] Maximum number of names
+)
+{
+    char baseName[SENML_NAME_MAX_LEN] = "";
+    char name[SENML_NAME_MAX_LEN];
+    char key[NUMBER_MAX_LEN];
+    int nameNb = 0;
+    char c;
+
+    if ('[' != GetJsonChar(readerPtr))
+    {
+        return -1;
+    }
+
+    c = GetJsonChar(readerPtr);
+    if (']' == c)
+    {
+        return ('\0' == GetJsonChar(readerPtr)) ? 0 : -1;
+    }
+
+    while ('{' == c)
+    {
+        name[0] = '\0';
+
+        c = GetJsonChar(readerPtr);
+        while ('"' == c)
+        {
+            if ((!GetJsonString(readerPtr, key, sizeof(key))) || (':' != GetJsonChar(readerPtr)))
+            {
+                return -1;
+            }
+
+            if ((0 == strcmp(key, "bn")) || (0 == strcmp(key, "n")))
+            {
+                if (   ('"' != GetJsonChar(readerPtr))
+                    || (!GetJsonString(readerPtr,
+                                       ('b' == key[0]) ? baseName : name,
+                                       SENML_NAME_MAX_LEN)))
+                {
+                    return -1;
+                }
+            }
+            else if (!SkipJsonValue(readerPtr))
+            {
+                return -1;
+            }
+
+            c = GetJsonChar(readerPtr);
+            if (',' == c)
+            {
+                c = GetJsonChar(readerPtr);
+            }
+            else if ('}' != c)
+            {
+                return -1;
+            }
+        }
+
+        if (('}' != c) || (nameNb == maxNb) || (!JoinName(namesPtr[nameNb], baseName, name)))
+        {
+            return -1;
+        }
+        nameNb++;
+
+        c = GetJsonChar(readerPtr);
+        if (',' == c)
+        {
+            c = GetJsonChar(readerPtr);
+        }
+        else if (']' == c)
+        {
+            return ('\0' == GetJsonChar(readerPtr)) ? nameNb : -1;
+        }
+        else
+        {
+            return -1;
+        }
+    }
+
+    return -1;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *                      PUBLIC FUNCTIONS
+ */
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start a SenML pack
+ *
+ * The SenML-CBOR pack is a definite-length array: the number of records has to be known.
+ *
+ * @return
+ *      - true on success
+ *      - false if the content format or the base name is not supported
+ */
+//--------------------------------------------------------------------------------------------------
+bool omanager_SenmlBegin
+(
+    omanager_SenmlWriter_t* writerPtr,  ///< [OUT] Writer
+    uint16_t format,                    ///< [IN] LWM2MCORE_CONTENT_SENML_JSON or
+                                        ///<      LWM2MCORE_CONTENT_SENML_CBOR
+    uint8_t* bufferPtr,                 ///< [IN] Output buffer, NULL to compute the length only
+    size_t size,                        ///< [IN] Output buffer size
+    uint32_t recordNb,                  ///< [IN] Number of records of the pack
+    const char* baseNamePtr,            ///< [IN] Base name, NULL if not used
+    int64_t baseTime                    ///< [IN] Base time in seconds, 0 if not used
+)
+{
+    if ((!writerPtr)
+     || ((LWM2MCORE_CONTENT_SENML_JSON != format) && (LWM2MCORE_CONTENT_SENML_CBOR != format))
+     || ((baseNamePtr) && (SENML_NAME_MAX_LEN <= strlen(baseNamePtr))))
+    {
+        return false;
+    }
+
+    memset(writerPtr, 0, sizeof(omanager_SenmlWriter_t));
+    writerPtr->bufferPtr = bufferPtr;
+    writerPtr->size = size;
+    writerPtr->format = format;
+    writerPtr->recordNb = recordNb;
+    writerPtr->baseTime = baseTime;
+    if (baseNamePtr)
+    {
+        strcpy(writerPtr->baseName, baseNamePtr);
+    }
+
+    if (LWM2MCORE_CONTENT_SENML_CBOR == format)
+    {
+        PutCborHead(writerPtr, CBOR_ARRAY, recordNb);
+    }
+    else
+    {
+        PutByte(writerPtr, '[');
+    }
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a record to a SenML pack
+ *
+ * @return
+ *      - true on success
+ *      - false if the data type is not supported, if the record number is exceeded or if the
+ *        buffer is too small
+ */
+//--------------------------------------------------------------------------------------------------
+bool omanager_SenmlAddRecord
+(
+    omanager_SenmlWriter_t* writerPtr,  ///< [INOUT] Writer
+    const char* namePtr,                ///< [IN] Record name, relative to the base name
+    int64_t time,                       ///< [IN] Record time in seconds, 0 for the base time
+    const lwm2m_data_t* dataPtr         ///< [IN] Resource or resource instance value
+)
+{
+    int64_t relativeTime = 0;
+    bool result;
+
+    if ((!namePtr) || (!dataPtr) || (writerPtr->writtenNb >= writerPtr->recordNb))
+    {
+        return false;
+    }
+
+    if (0 != time)
+    {
+        relativeTime = time - writerPtr->baseTime;
+    }
+
+    if (LWM2MCORE_CONTENT_SENML_CBOR == writerPtr->format)
+    {
+        result = PutCborRecord(writerPtr, (0 == writerPtr->writtenNb), namePtr, relativeTime,
+                               dataPtr);
+    }
+    else
+    {
+        result = PutJsonRecord(writerPtr, (0 == writerPtr->writtenNb), namePtr, relativeTime,
+                               dataPtr);
+    }
+
+    writerPtr->writtenNb++;
+    return result && (!writerPtr->isOverflow);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * End a SenML pack
+ *
+ * @return
+ *      - Length of the pack
+ *      - 0 if the pack is incomplete or if the buffer is too small
+ */
+//--------------------------------------------------------------------------------------------------
+size_t omanager_SenmlEnd
+(
+    omanager_SenmlWriter_t* writerPtr   ///< [INOUT] Writer
+)
+{
+    if (LWM2MCORE_CONTENT_SENML_JSON == writerPtr->format)
+    {
+        PutByte(writerPtr, ']');
+    }
+
+    if ((writerPtr->isOverflow) || (writerPtr->writtenNb != writerPtr->recordNb))
+    {
+        return 0;
+    }
+
+    return writerPtr->length;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Serialize the data of a read or notify response in a SenML content format.
+ *
+ * This function is called by omanager_CoapSerialize for the responses and the notifications in
+ * a SenML content format accepted by the server. The buffer is allocated by this function and
+ * released by the caller with lwm2m_free.
+ *
+ * @return
+ *      - Length of the serialized data
+ *      - -1 if the content format is not a SenML format, or on failure
+ */
+//--------------------------------------------------------------------------------------------------
+int lwm2mcore_SenmlSerialize
+(
+    const lwm2m_uri_t* uriPtr,          ///< [IN] Requested URI
+    int dataNb,                         ///< [IN] Number of data
+    const lwm2m_data_t* dataPtr,        ///< [IN] Data read on the URI
+    uint16_t format,                    ///< [IN] Requested content format
+    uint8_t** bufferPtr                 ///< [OUT] Serialized data
+)
+{
+    omanager_SenmlWriter_t writer;
+    char baseName[SENML_NAME_MAX_LEN] = "/";
+    char name[SENML_NAME_MAX_LEN];
+    uint32_t recordNb;
+    size_t length;
+
+    if ((!uriPtr) || (!bufferPtr) || ((0 < dataNb) && (!dataPtr)))
+    {
+        return -1;
+    }
+    *bufferPtr = NULL;
+
+    if (uriPtr->flag & LWM2M_URI_FLAG_OBJECT_ID)
+    {
+        if (uriPtr->flag & LWM2M_URI_FLAG_INSTANCE_ID)
+        {
+            snprintf(baseName, sizeof(baseName), "/%u/%u/",
+                     uriPtr->objectId, uriPtr->instanceId);
+        }
+        else
+        {
+            snprintf(baseName, sizeof(baseName), "/%u/", uriPtr->objectId);
+        }
+    }
+
+    recordNb = CountRecords(dataNb, dataPtr);
+
+    // First pass: payload length
+    name[0] = '\0';
+    if ((!omanager_SenmlBegin(&writer, format, NULL, 0, recordNb, baseName, 0))
+     || (!WriteRecords(&writer, name, 0, dataNb, dataPtr)))
+    {
+        return -1;
+    }
+    length = omanager_SenmlEnd(&writer);
+    if ((0 == length) || (INT32_MAX < length))
+    {
+        return -1;
+    }
+
+    *bufferPtr = (uint8_t*)OMANAGER_MALLOC(length);
+    if (!*bufferPtr)
+    {
+        return -1;
+    }
+
+    // Second pass: payload
+    omanager_SenmlBegin(&writer, format, *bufferPtr, length, recordNb, baseName, 0);
+    if ((!WriteRecords(&writer, name, 0, dataNb, dataPtr))
+     || (length != omanager_SenmlEnd(&writer)))
+    {
+        lwm2m_free(*bufferPtr);
+        *bufferPtr = NULL;
+        return -1;
+    }
+
+    return (int)length;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Count the records of a LwM2M data tree
+ *
+ * @return
+ *      - Number of records
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t omanager_SenmlCountRecords
+(
+    int dataNb,                         ///< [IN] Number of data
+    const lwm2m_data_t* dataPtr         ///< [IN] Data
+)
+{
+    return CountRecords(dataNb, dataPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add the records of a LwM2M data tree to a SenML pack, named from a path prefix
+ *
+ * @return
+ *      - true on success
+ *      - false if a name is too long, or on the same failures as omanager_SenmlAddRecord
+ */
+//--------------------------------------------------------------------------------------------------
+bool omanager_SenmlAddData
+(
+    omanager_SenmlWriter_t* writerPtr,  ///< [INOUT] Writer
+    const char* prefixPtr,              ///< [IN] Path prefix, relative to the base name
+    int dataNb,                         ///< [IN] Number of data
+    const lwm2m_data_t* dataPtr         ///< [IN] Data
+)
+{
+    char name[SENML_NAME_MAX_LEN];
+    size_t prefixLen = strlen(prefixPtr);
+
+    if (SENML_NAME_MAX_LEN <= prefixLen)
+    {
+        return false;
+    }
+    memcpy(name, prefixPtr, prefixLen + 1);
+
+    return WriteRecords(writerPtr, name, prefixLen, dataNb, dataPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Decode the names of a SenML pack, such as the list of paths of a composite request. The base
+ * names are applied and the other fields are ignored.
+ *
+ * @return
+ *      - Number of names
+ *      - -1 if the content format is not supported, if the pack is invalid or if it has too many
+ *        names
+ */
+//--------------------------------------------------------------------------------------------------
+int omanager_SenmlDecodeNames
+(
+    uint16_t format,                            ///< [IN] LWM2MCORE_CONTENT_SENML_JSON or
+                                                ///<      LWM2MCORE_CONTENT_SENML_CBOR
+    const uint8_t* payloadPtr,                  ///< [IN] Encoded pack
+    size_t length,                              ///< [IN] Length of the encoded pack
+    char (*namesPtr)[SENML_NAME_MAX_LEN],       ///< [OUT] Names
+    int maxNb                                   ///< [IN] Maximum number of names
+)
+{
+    Reader_t reader;
+
+    if ((!payloadPtr) || (!namesPtr) || (0 > maxNb))
+    {
+        return -1;
+    }
+
+    reader.dataPtr = payloadPtr;
+    reader.length = length;
+    reader.offset = 0;
+
+    switch (format)
+    {
+        case LWM2MCORE_CONTENT_SENML_CBOR:
+            return GetCborNames(&reader, namesPtr, maxNb);
+
+        case LWM2MCORE_CONTENT_SENML_JSON:
+            return GetJsonNames(&reader, namesPtr, maxNb);
+
+        default:
+            return -1;
+    }
+}
@@ -0,0 +1,204 @@
+/**
+ * @file senml.h
+ *
+ * SenML encoding of the LwM2M data: LwM2M 1.1 SenML-JSON and SenML-CBOR content formats
+ *
+ * The records are written with a base name set in the first record, so that each record only
+ * carries the path of its resource relative to the requested object or object instance. The
+ * timestamped records are written with a base time set in the first record and a time relative to
+ * it, omitted when equal.
+ *
+ * The names of a pack can be decoded, for the requests listing paths in a SenML pack.
+ *
+ * The payload is written in two passes: the first one computes the payload length without writing
+ * it, the second one writes it in a buffer of this length.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#ifndef __SENML_H__
+#define __SENML_H__
+
+#include <lwm2mcore/lwm2mcore.h>
+#include "liblwm2m.h"
+
+/**
+  * @addtogroup lwm2mcore_senml_int
+  * @{
+  */
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief SenML-JSON content format
+ */
+//--------------------------------------------------------------------------------------------------
+#define LWM2MCORE_CONTENT_SENML_JSON    110
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief SenML-CBOR content format
+ */
+//--------------------------------------------------------------------------------------------------
+#define LWM2MCORE_CONTENT_SENML_CBOR    112
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Maximum length of a record name or base name, including the null terminator
+ */
+//--------------------------------------------------------------------------------------------------
+#define SENML_NAME_MAX_LEN              24
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief SenML pack writer
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint8_t*    bufferPtr;                      ///< Output buffer, NULL to compute the length only
+    size_t      size;                           ///< Output buffer size
+    size_t      length;                         ///< Length of the encoded pack
+    uint16_t    format;                         ///< Content format
+    uint32_t    recordNb;                       ///< Number of records of the pack
+    uint32_t    writtenNb;                      ///< Number of written records
+    char        baseName[SENML_NAME_MAX_LEN];   ///< Base name, empty if not used
+    int64_t     baseTime;                       ///< Base time in seconds, 0 if not used
+    bool        isOverflow;                     ///< The buffer is too small
+}
+omanager_SenmlWriter_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Start a SenML pack
+ *
+ * The SenML-CBOR pack is a definite-length array: the number of records has to be known.
+ *
+ * @return
+ *      - true on success
+ *      - false if the content format or the base name is not supported
+ */
+//--------------------------------------------------------------------------------------------------
+bool omanager_SenmlBegin
+(
+    omanager_SenmlWriter_t* writerPtr,  ///< [OUT] Writer
+    uint16_t format,                    ///< [IN] LWM2MCORE_CONTENT_SENML_JSON or
+                                        ///<      LWM2MCORE_CONTENT_SENML_CBOR
+    uint8_t* bufferPtr,                 ///< [IN] Output buffer, NULL to compute the length only
+    size_t size,                        ///< [IN] Output buffer size
+    uint32_t recordNb,                  ///< [IN] Number of records of the pack
+    const char* baseNamePtr,            ///< [IN] Base name, NULL if not used
+    int64_t baseTime                    ///< [IN] Base time in seconds, 0 if not used
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Add a record to a SenML pack
+ *
+ * @return
+ *      - true on success
+ *      - false if the data type is not supported, if the record number is exceeded or if the
+ *        buffer is too small
+ */
+//--------------------------------------------------------------------------------------------------
+bool omanager_SenmlAddRecord
+(
+    omanager_SenmlWriter_t* writerPtr,  ///< [INOUT] Writer
+    const char* namePtr,                ///< [IN] Record name, relative to the base name
+    int64_t time,                       ///< [IN] Record time in seconds, 0 for the base time
+    const lwm2m_data_t* dataPtr         ///< [IN] Resource or resource instance value
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief End a SenML pack
+ *
+ * @return
+ *      - Length of the pack
+ *      - 0 if the pack is incomplete or if the buffer is too small
+ */
+//--------------------------------------------------------------------------------------------------
+size_t omanager_SenmlEnd
+(
+    omanager_SenmlWriter_t* writerPtr   ///< [INOUT] Writer
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Serialize the data of a read or notify response in a SenML content format.
+ *
+ * This function is called by omanager_CoapSerialize for the responses and the notifications in
+ * a SenML content format accepted by the server. The buffer is allocated by this function and
+ * released by the caller with lwm2m_free.
+ *
+ * @return
+ *      - Length of the serialized data
+ *      - -1 if the content format is not a SenML format, or on failure
+ */
+//--------------------------------------------------------------------------------------------------
+int lwm2mcore_SenmlSerialize
+(
+    const lwm2m_uri_t* uriPtr,          ///< [IN] Requested URI
+    int dataNb,                         ///< [IN] Number of data
+    const lwm2m_data_t* dataPtr,        ///< [IN] Data read on the URI
+    uint16_t format,                    ///< [IN] Requested content format
+    uint8_t** bufferPtr                 ///< [OUT] Serialized data
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Count the records of a LwM2M data tree
+ *
+ * @return
+ *      - Number of records
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t omanager_SenmlCountRecords
+(
+    int dataNb,                         ///< [IN] Number of data
+    const lwm2m_data_t* dataPtr         ///< [IN] Data
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Add the records of a LwM2M data tree to a SenML pack, named from a path prefix
+ *
+ * @return
+ *      - true on success
+ *      - false if a name is too long, or on the same failures as omanager_SenmlAddRecord
+ */
+//--------------------------------------------------------------------------------------------------
+bool omanager_SenmlAddData
+(
+    omanager_SenmlWriter_t* writerPtr,  ///< [INOUT] Writer
+    const char* prefixPtr,              ///< [IN] Path prefix, relative to the base name
+    int dataNb,                         ///< [IN] Number of data
+    const lwm2m_data_t* dataPtr         ///< [IN] Data
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Decode the names of a SenML pack, such as the list of paths of a composite request. The
+ * base names are applied and the other fields are ignored.
+ *
+ * @return
+ *      - Number of names
+ *      - -1 if the content format is not supported, if the pack is invalid or if it has too many
+ *        names
+ */
+//--------------------------------------------------------------------------------------------------
+int omanager_SenmlDecodeNames
+(
+    uint16_t format,                            ///< [IN] LWM2MCORE_CONTENT_SENML_JSON or
+                                                ///<      LWM2MCORE_CONTENT_SENML_CBOR
+    const uint8_t* payloadPtr,                  ///< [IN] Encoded pack
+    size_t length,                              ///< [IN] Length of the encoded pack
+    char (*namesPtr)[SENML_NAME_MAX_LEN],       ///< [OUT] Names
+    int maxNb                                   ///< [IN] Maximum number of names
+);
+
+/**
+  * @}
+  */
+
+#endif /* __SENML_H__ */
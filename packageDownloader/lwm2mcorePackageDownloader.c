@@ -7,6 +7,28 @@
  * When the package download starts, downloaded data should be sequentially transmitted to the
  * package downloader using lwm2mcore_PackageDownloaderReceiveData().
  *
+ * @section lwm2mcoreMultiRangeDownload Multi-range download
+ *
+ * If the platform provides a multi-range download callback and the package size is known, the
+ * package is downloaded by ranges, possibly using several concurrent connections. The platform
+ * requests the ranges with lwm2mcore_PackageDownloaderGetNextRange() and transmits the downloaded
+ * data with lwm2mcore_PackageDownloaderReceiveRange(), in any order. Data received before the
+ * preceding data is buffered, so that the DWL parser and the package verification always process
+ * the package sequentially. The ranges are only given if their data fits in the buffering limit
+ * PKG_DWL_REORDER_MAX_LEN.
+ *
+ * @section lwm2mcoreAsyncDownload Asynchronous download
+ *
+ * The download callback can start an asynchronous transfer and return DWL_BUSY instead of blocking
+ * until the end of the transfer. lwm2mcore_PackageDownloaderRun() then returns DWL_BUSY and the
+ * package downloader is a state machine advanced by the application event loop, which can also
+ * run the LwM2M session in the same thread:
+ * - data arrival: the data are given to lwm2mcore_PackageDownloaderProcessData(). If the storage
+ *   is busy, only part of the data is processed and the remaining data should be given again once
+ *   the storage completes some writes;
+ * - transfer end: lwm2mcore_PackageDownloaderEndTransfer() ends or suspends the download with the
+ *   transfer result, as lwm2mcore_PackageDownloaderRun() does when a blocking download returns.
+ *
  * @section lwm2mcoreDwlParser DWL parser
  *
  * A simple DWL package is composed of the following sections:
@@ -24,19 +46,36 @@
  *      - BINA header: general information about the Binary data, e.g. destination baseband
  *      - Binary data: useful binary data for the update
  *      - Padding data
+ * - COMP (Compressed Binary): same structure as the BINA section, the binary data being compressed
+ *      - DWL comments: optional subsection containing comments about the package
+ *      - COMP header: general information about the compressed data, e.g. compression algorithm
+ *      - Compressed binary data: binary data used to update the software, compressed
+ *      - Padding data
  * - SIGN (Signature):
  *      - DWL comments: optional subsection containing comments about the package
  *      - Signature: package signature
  *
+ * @section lwm2mcoreDwlDecompression Compressed binary
+ *
+ * The compressed binary data of a COMP section are decompressed on the fly by the package
+ * downloader: each received chunk is decompressed with the porting layer decompression functions
+ * and the decompressed data are given to the storeRange callback. The package therefore never
+ * needs to be stored in its compressed form.
+ *
  * @section lwm2mcorePackageVerification Package verification
  *
  * The package CRC is retrieved in the first DWL prolog. A CRC is then computed with all binary data
  * from the package, starting from the first byte after the package CRC until the end of the BINA
- * section. The SIGN section is therefore ignored for the CRC computation.
+ * or COMP section. The SIGN section is therefore ignored for the CRC computation.
  *
  * The package signature is computed by hashing all the data from the beginning of the file until
- * the end of the BINA section, using the SHA1 algorithm. The SIGN section is therefore ignored for
- * the SHA1 digest computation.
+ * the end of the BINA or COMP section, using the SHA1 algorithm. The SIGN section is therefore
+ * ignored for the SHA1 digest computation. The porting layer can use another digest algorithm,
+ * e.g. SHA-256 for an ECDSA or Ed25519 public key: the package type, which gives the public key,
+ * is provided when the digest computation starts.
+ *
+ * The CRC and the SHA1 digest are both computed on the package as it is downloaded, i.e. on the
+ * compressed data for a COMP section, before decompression.
  *
  * <HR>
  *
@@ -86,6 +125,13 @@
 //--------------------------------------------------------------------------------------------------
 #define TMP_DATA_MAX_LEN    16384
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximal length of a decompressed data chunk given to the storeRange callback.
+ */
+//--------------------------------------------------------------------------------------------------
+#define DECOMP_DATA_MAX_LEN 16384
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Magic number identifying a DWL prolog
@@ -234,6 +280,11 @@ typedef struct
     size_t                      processedLen;        ///< Length of data processed by last parsing
     uint32_t                    downloadProgress;    ///< Overall download progress
     uint64_t                    updateGap;           ///< Gap between update and downloader offsets
+    uint64_t                    decompGap;           ///< Decompressed data already stored, to skip
+                                                     ///< when a compressed binary is resumed
+    bool                        isTransferPending;   ///< Asynchronous transfer ongoing
+    bool                        isStoreBusy;         ///< Storage busy, stop processing the
+                                                     ///< received data
 }
 PackageDownloaderObj_t;
 
@@ -256,6 +307,9 @@ typedef struct
     uint64_t remainingBinaryData;   ///< Remaining length of binary data to download
     uint64_t signatureSize;         ///< Signature size read in DWL prolog
     void*    sha1CtxPtr;            ///< SHA1 context pointer
+    uint32_t compressionType;       ///< Compression algorithm read in COMP header
+    void*    decompCtxPtr;          ///< Decompression context pointer
+    bool     isDecompEnd;           ///< End of the compressed stream is reached
 }
 DwlParserObj_t;
 
@@ -295,6 +349,52 @@ typedef union
 }
 UpckHeader_t;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * COMP header structure
+ */
+//--------------------------------------------------------------------------------------------------
+typedef union
+{
+    struct
+    {
+        uint32_t compressionType;                   ///< Compression algorithm, see
+                                                    ///< @ref lwm2mcore_CompressionType_t
+        uint32_t decompressedSize;                  ///< Size of the decompressed binary data
+    } structHeader;
+    uint8_t rawHeader[LWM2MCORE_COMP_HEADER_SIZE];  ///< Raw COMP header
+}
+CompHeader_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Downloaded data chunk buffered during a multi-range download, waiting for the preceding data
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct RangeChunk
+{
+    struct RangeChunk*  nextPtr;    ///< Next buffered chunk, with a higher offset
+    uint64_t            offset;     ///< Offset of the chunk in the package
+    size_t              len;        ///< Length of the chunk
+    uint8_t             data[];     ///< Chunk data
+}
+RangeChunk_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Multi-range download object structure
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint64_t        nextRangeOffset;    ///< Start offset of the next range to download
+    uint64_t        endOffset;          ///< End offset of the last range to download
+    uint64_t        receivedOffset;     ///< Offset of the next data to process, in package order
+    size_t          bufferedLen;        ///< Length of the buffered data
+    RangeChunk_t*   chunkListPtr;       ///< Buffered data chunks, sorted by offset
+}
+RangeDwlObj_t;
+
 //--------------------------------------------------------------------------------------------------
 // Static variables
 //--------------------------------------------------------------------------------------------------
@@ -320,6 +420,20 @@ static lwm2mcore_PackageDownloader_t* PkgDwlPtr = NULL;
 //--------------------------------------------------------------------------------------------------
 static DwlParserObj_t DwlParserObj;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Multi-range download object instance
+ */
+//--------------------------------------------------------------------------------------------------
+static RangeDwlObj_t RangeDwlObj;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Decompressed data chunk
+ */
+//--------------------------------------------------------------------------------------------------
+static uint8_t DecompData[DECOMP_DATA_MAX_LEN];
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Package downloader workspace
@@ -709,15 +823,12 @@ static void UpdateAndStorePkgDwlWorkspace
     PkgDwlWorkspace.remainingBinaryData = DwlParserObj.remainingBinaryData;
     PkgDwlWorkspace.signatureSize = DwlParserObj.signatureSize;
     PkgDwlWorkspace.computedCRC = DwlParserObj.computedCRC;
-    if (   (DwlParserObj.sha1CtxPtr)
-        && (strncmp((char*)PkgDwlWorkspace.sha1Ctx,
-                    DwlParserObj.sha1CtxPtr,
-                    SHA1_CTX_MAX_SIZE))
-       )
+    PkgDwlWorkspace.compressionType = DwlParserObj.compressionType;
+    if (DwlParserObj.sha1CtxPtr)
     {
         lwm2mcore_CopySha1(DwlParserObj.sha1CtxPtr,
-                           PkgDwlWorkspace.sha1Ctx,
-                           SHA1_CTX_MAX_SIZE);
+                           PkgDwlWorkspace.hashState,
+                           sizeof(PkgDwlWorkspace.hashState));
     }
 
     // Store the workspace
@@ -727,6 +838,66 @@ static void UpdateAndStorePkgDwlWorkspace
     }
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the decompression of the COMP section binary data
+ *
+ * @return
+ *  - DWL_OK      The function succeeded
+ *  - DWL_FAULT   The function failed
+ */
+//--------------------------------------------------------------------------------------------------
+static lwm2mcore_DwlResult_t StartDecompression
+(
+    void
+)
+{
+    lwm2mcore_Sid_t sid;
+
+    DwlParserObj.isDecompEnd = false;
+    sid = lwm2mcore_StartDecompression((lwm2mcore_CompressionType_t)DwlParserObj.compressionType,
+                                       &DwlParserObj.decompCtxPtr);
+    switch (sid)
+    {
+        case LWM2MCORE_ERR_COMPLETED_OK:
+            break;
+
+        case LWM2MCORE_ERR_OP_NOT_SUPPORTED:
+            LOG_ARG("Unsupported compression type %u", DwlParserObj.compressionType);
+            SetUpdateResult(PKG_DWL_ERROR_PKG_TYPE);
+            return DWL_FAULT;
+
+        default:
+            LOG_ARG("Unable to initialize the decompression, sid %d", sid);
+            SetUpdateResult(PKG_DWL_ERROR_OUT_OF_MEMORY);
+            return DWL_FAULT;
+    }
+
+    return DWL_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stop the decompression of the COMP section binary data, if any
+ */
+//--------------------------------------------------------------------------------------------------
+static void StopDecompression
+(
+    void
+)
+{
+    if (!DwlParserObj.decompCtxPtr)
+    {
+        return;
+    }
+
+    if (LWM2MCORE_ERR_COMPLETED_OK != lwm2mcore_EndDecompression(&DwlParserObj.decompCtxPtr))
+    {
+        LOG("Unable to release the decompression context");
+    }
+    DwlParserObj.decompCtxPtr = NULL;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Hash data if necessary, based on the current DWL section/subsection:
@@ -746,7 +917,8 @@ static lwm2mcore_DwlResult_t HashData
     // Initialize SHA1 context and CRC if not already done
     if (!DwlParserObj.sha1CtxPtr)
     {
-        if (LWM2MCORE_ERR_COMPLETED_OK != lwm2mcore_StartSha1(&DwlParserObj.sha1CtxPtr))
+        if (LWM2MCORE_ERR_COMPLETED_OK != lwm2mcore_StartSha1(PkgDwlObj.packageType,
+                                                              &DwlParserObj.sha1CtxPtr))
         {
             LOG("Unable to initialize SHA1 context");
             SetUpdateResult(PKG_DWL_ERROR_VERIFY);
@@ -792,8 +964,9 @@ static lwm2mcore_DwlResult_t HashData
             break;
 
         case DWL_TYPE_BINA:
+        case DWL_TYPE_COMP:
         {
-            // All BINA subsections are used for CRC computation
+            // All BINA and COMP subsections are used for CRC computation
             uint8_t* dataToHashPtr = DwlParserObj.dataToParsePtr;
             size_t   lenToHash = PkgDwlObj.processedLen;
 
@@ -817,7 +990,7 @@ static lwm2mcore_DwlResult_t HashData
                                                        dataToHashPtr,
                                                        lenToHash);
 
-            // SHA1 digest is updated with all BINA data
+            // SHA1 digest is updated with all BINA and COMP data
             if (LWM2MCORE_ERR_COMPLETED_OK!=lwm2mcore_ProcessSha1(DwlParserObj.sha1CtxPtr,
                                                                   dataToHashPtr,
                                                                   lenToHash))
@@ -967,6 +1140,22 @@ static lwm2mcore_DwlResult_t ParseDwlProlog
             DwlParserObj.lenToParse = DwlParserObj.commentSize;
             break;
 
+        case DWL_TYPE_COMP:
+            // Store prolog data
+            DwlParserObj.commentSize = (dwlPrologPtr->commentSize << 3);
+            DwlParserObj.binarySize = dwlPrologPtr->fileSize
+                                      - DwlParserObj.commentSize
+                                      - LWM2MCORE_COMP_HEADER_SIZE
+                                      - sizeof(DwlProlog_t);
+            DwlParserObj.paddingSize = ((dwlPrologPtr->fileSize + 7) & 0xFFFFFFF8)
+                                       - dwlPrologPtr->fileSize;
+
+            // Parse DWL comments
+            PkgDwlObj.state = PKG_DWL_PARSE;
+            DwlParserObj.subsection = DWL_SUB_COMMENTS;
+            DwlParserObj.lenToParse = DwlParserObj.commentSize;
+            break;
+
         case DWL_TYPE_SIGN:
             // Store prolog data
             DwlParserObj.commentSize = (dwlPrologPtr->commentSize << 3);
@@ -1042,6 +1231,13 @@ static lwm2mcore_DwlResult_t ParseDwlComments
             DwlParserObj.lenToParse = LWM2MCORE_BINA_HEADER_SIZE;
             break;
 
+        case DWL_TYPE_COMP:
+            // Parse COMP header
+            PkgDwlObj.state = PKG_DWL_PARSE;
+            DwlParserObj.subsection = DWL_SUB_HEADER;
+            DwlParserObj.lenToParse = LWM2MCORE_COMP_HEADER_SIZE;
+            break;
+
         case DWL_TYPE_SIGN:
             // Parse signature
             PkgDwlObj.state = PKG_DWL_PARSE;
@@ -1119,6 +1315,27 @@ static lwm2mcore_DwlResult_t ParseDwlHeader
             DwlParserObj.remainingBinaryData = DwlParserObj.binarySize;
             break;
 
+        case DWL_TYPE_COMP:
+        {
+            // Initialize the decompression with the algorithm given by the COMP header
+            CompHeader_t* compHeaderPtr = (CompHeader_t*)((void*)DwlParserObj.dataToParsePtr);
+            DwlParserObj.compressionType = compHeaderPtr->structHeader.compressionType;
+            LOG_ARG("Compressed binary: type %u, decompressed size %u",
+                    DwlParserObj.compressionType, compHeaderPtr->structHeader.decompressedSize);
+            if (DWL_OK != StartDecompression())
+            {
+                // updateResult is already set by StartDecompression
+                return DWL_FAULT;
+            }
+
+            // Parse DWL compressed binary data
+            PkgDwlObj.state = PKG_DWL_PARSE;
+            DwlParserObj.subsection = DWL_SUB_BINARY;
+            DwlParserObj.lenToParse = DwlParserObj.binarySize;
+            DwlParserObj.remainingBinaryData = DwlParserObj.binarySize;
+        }
+        break;
+
         default:
             LOG_ARG("Unexpected DWL header for section type 0x%08x", DwlParserObj.section);
             SetUpdateResult(PKG_DWL_ERROR_PKG_TYPE);
@@ -1146,7 +1363,7 @@ static lwm2mcore_DwlResult_t ParseDwlBinary
     lwm2mcore_DwlResult_t result;
 
     // Check if subsection is expected in current DWL section
-    if (DWL_TYPE_BINA != DwlParserObj.section)
+    if ((DWL_TYPE_BINA != DwlParserObj.section) && (DWL_TYPE_COMP != DwlParserObj.section))
     {
         LOG_ARG("Unexpected DWL binary data for section type 0x%08x", DwlParserObj.section);
         SetUpdateResult(PKG_DWL_ERROR_PKG_TYPE);
@@ -1190,7 +1407,7 @@ static lwm2mcore_DwlResult_t ParseDwlPadding
     LOG_ARG("Parse DWL padding, length %u", PkgDwlObj.processedLen);
 
     // Check if subsection is expected in current DWL section
-    if (DWL_TYPE_BINA != DwlParserObj.section)
+    if ((DWL_TYPE_BINA != DwlParserObj.section) && (DWL_TYPE_COMP != DwlParserObj.section))
     {
         LOG_ARG("Unexpected DWL padding data for section type 0x%08x", DwlParserObj.section);
         SetUpdateResult(PKG_DWL_ERROR_PKG_TYPE);
@@ -1331,6 +1548,9 @@ static lwm2mcore_DwlResult_t DwlParser
             LOG("Unable to reset SHA1 context");
         }
 
+        // Release the decompression context if necessary
+        StopDecompression();
+
         // Reset the DWL parser object for next use
         memset(&DwlParserObj, 0, sizeof(DwlParserObj_t));
         DwlParserObj.subsection = DWL_SUB_PROLOG;
@@ -1562,6 +1782,9 @@ static void PkgDwlGetInfo
     // Download the package
     PkgDwlObj.state = PKG_DWL_DOWNLOAD;
 
+    // Release the SHA1 context of a suspended download
+    lwm2mcore_CancelSha1(&DwlParserObj.sha1CtxPtr);
+
     // Require to parse at least the length of DWL prolog, enough to determine the file type
     memset(&DwlParserObj, 0, sizeof(DwlParserObj_t));
     DwlParserObj.subsection = DWL_SUB_PROLOG;
@@ -1589,19 +1812,38 @@ static lwm2mcore_DwlResult_t LoadResumeData
     LOG_ARG("Update offset = %llu", pkgDwlPtr->data.updateOffset);
     LOG_ARG("Stored offset = %llu", PkgDwlWorkspace.offset);
 
-    // The update process might be late comparing to the package downloader:
-    // check that this is really the case
-    if ( (PkgDwlWorkspace.remainingBinaryData + pkgDwlPtr->data.updateOffset)
-        > PkgDwlWorkspace.binarySize )
+    switch (PkgDwlWorkspace.section)
     {
-        LOG("Incoherence in stored data, unable to resume download");
-        return DWL_FAULT;
-    }
+        case DWL_TYPE_BINA:
+            // The update process might be late comparing to the package downloader:
+            // check that this is really the case
+            if ( (PkgDwlWorkspace.remainingBinaryData + pkgDwlPtr->data.updateOffset)
+                > PkgDwlWorkspace.binarySize )
+            {
+                LOG("Incoherence in stored data, unable to resume download");
+                return DWL_FAULT;
+            }
+
+            // Compute the update process gap to download again the unprocessed data
+            PkgDwlObj.updateGap = PkgDwlWorkspace.binarySize
+                                  - PkgDwlWorkspace.remainingBinaryData
+                                  - pkgDwlPtr->data.updateOffset;
+            break;
+
+        case DWL_TYPE_COMP:
+            // The decompression state can't be stored: the compressed data are downloaded again
+            // from the beginning of the binary subsection. The data already hashed are not hashed
+            // again and the decompressed data already stored, indicated by the update offset, are
+            // not stored again.
+            PkgDwlObj.updateGap = PkgDwlWorkspace.binarySize
+                                  - PkgDwlWorkspace.remainingBinaryData;
+            PkgDwlObj.decompGap = pkgDwlPtr->data.updateOffset;
+            break;
 
-    // Compute the update process gap to download again the unprocessed data
-    PkgDwlObj.updateGap = PkgDwlWorkspace.binarySize
-                          - PkgDwlWorkspace.remainingBinaryData
-                          - pkgDwlPtr->data.updateOffset;
+        default:
+            LOG_ARG("Unexpected DWL section 0x%08x in workspace", PkgDwlWorkspace.section);
+            return DWL_FAULT;
+    }
     LOG_ARG("Update gap = %llu", PkgDwlObj.updateGap);
 
     // Set start offset
@@ -1617,7 +1859,7 @@ static lwm2mcore_DwlResult_t LoadResumeData
     // Set DWL section
     // It has to be binary data if the update is resumed, as it is the only
     // section where the package downloader workspace is stored.
-    DwlParserObj.section = DWL_TYPE_BINA;
+    DwlParserObj.section = PkgDwlWorkspace.section;
     DwlParserObj.subsection = DWL_SUB_BINARY;
     DwlParserObj.packageCRC = PkgDwlWorkspace.packageCRC;
     DwlParserObj.computedCRC = PkgDwlWorkspace.computedCRC;
@@ -1626,9 +1868,20 @@ static lwm2mcore_DwlResult_t LoadResumeData
     DwlParserObj.paddingSize = PkgDwlWorkspace.paddingSize;
     DwlParserObj.remainingBinaryData = PkgDwlWorkspace.remainingBinaryData;
     DwlParserObj.signatureSize = PkgDwlWorkspace.signatureSize;
+    DwlParserObj.compressionType = PkgDwlWorkspace.compressionType;
+
+    // Restart the decompression of a compressed binary
+    if (   (DWL_TYPE_COMP == DwlParserObj.section)
+        && (DWL_OK != StartDecompression())
+       )
+    {
+        LOG("Unable to restart the decompression");
+        return DWL_FAULT;
+    }
 
-    if (LWM2MCORE_ERR_COMPLETED_OK != lwm2mcore_RestoreSha1(PkgDwlWorkspace.sha1Ctx,
-                                                            SHA1_CTX_MAX_SIZE,
+    if (LWM2MCORE_ERR_COMPLETED_OK != lwm2mcore_RestoreSha1(
+                                                            PkgDwlWorkspace.hashState,
+                                                            sizeof(PkgDwlWorkspace.hashState),
                                                             &DwlParserObj.sha1CtxPtr))
     {
         LOG("Unable to restore SHA1 context");
@@ -1640,61 +1893,181 @@ static lwm2mcore_DwlResult_t LoadResumeData
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Download the package
+ * Release all the data chunks buffered during a multi-range download
  */
 //--------------------------------------------------------------------------------------------------
-static void PkgDwlDownload
+static void ReleaseRangeChunks
 (
-    lwm2mcore_PackageDownloader_t* pkgDwlPtr    ///< Package downloader
+    void
 )
 {
-    // Notify the download beginning
-    // Set update state to 'Downloading'
-    switch (pkgDwlPtr->data.updateType)
+    while (RangeDwlObj.chunkListPtr)
     {
-        case LWM2MCORE_FW_UPDATE_TYPE:
-            PkgDwlObj.result =
-                    pkgDwlPtr->setFwUpdateState(LWM2MCORE_FW_UPDATE_STATE_DOWNLOADING);
-            break;
-        case LWM2MCORE_SW_UPDATE_TYPE:
-            PkgDwlObj.result =
-                    pkgDwlPtr->setSwUpdateState(LWM2MCORE_SW_UPDATE_STATE_DOWNLOAD_STARTED);
-            break;
-         default:
-           LOG("unknown download type");
-            PkgDwlObj.result = DWL_FAULT;
-            break;
+        RangeChunk_t* chunkPtr = RangeDwlObj.chunkListPtr;
+        RangeDwlObj.chunkListPtr = chunkPtr->nextPtr;
+        lwm2m_free(chunkPtr);
     }
-    if (DWL_OK != PkgDwlObj.result)
+    RangeDwlObj.bufferedLen = 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Buffer a data chunk received during a multi-range download, until the preceding data is received
+ *
+ * The data already processed or already buffered, e.g. in case of retransmission, is not buffered
+ * again: a buffered chunk included in the received data is replaced by it, and the received data is
+ * trimmed to the gap between the buffered chunks surrounding it. The buffered length only counts
+ * each byte of the package once.
+ *
+ * @return
+ *  - DWL_OK      The function succeeded
+ *  - DWL_FAULT   The function failed
+ */
+//--------------------------------------------------------------------------------------------------
+static lwm2mcore_DwlResult_t BufferRangeChunk
+(
+    uint64_t offset,    ///< Offset of the data in the package
+    uint8_t* bufPtr,    ///< Data to buffer
+    size_t   bufSize    ///< Size of data to buffer
+)
+{
+    RangeChunk_t* chunkPtr;
+    RangeChunk_t** prevPtrPtr = &RangeDwlObj.chunkListPtr;
+    uint64_t endOffset = offset + bufSize;
+
+    // Ignore the data already processed
+    if (endOffset <= RangeDwlObj.receivedOffset)
     {
-        LOG("Unable to set update state");
-        SetUpdateResult(PKG_DWL_ERROR_CONNECTION);
-        PkgDwlObj.state = PKG_DWL_ERROR;
-        return;
+        return DWL_OK;
+    }
+    if (offset < RangeDwlObj.receivedOffset)
+    {
+        bufPtr += RangeDwlObj.receivedOffset - offset;
+        offset = RangeDwlObj.receivedOffset;
     }
 
-    // Be ready to parse downloaded data
-    PkgDwlObj.state = PKG_DWL_PARSE;
+    // Find the insertion point in the list sorted by offset, and ignore the data already buffered
+    // by the preceding chunk
+    while ((*prevPtrPtr) && ((*prevPtrPtr)->offset <= offset))
+    {
+        uint64_t chunkEnd = (*prevPtrPtr)->offset + (*prevPtrPtr)->len;
 
-    // Check if the package downloader workspace should be used to compute the download offset.
-    // This is the case if it is a download resume and data was already stored.
-    if ((PkgDwlPtr->data.isResume) && (PkgDwlPtr->data.updateOffset))
+        if (chunkEnd >= endOffset)
+        {
+            return DWL_OK;
+        }
+        if (chunkEnd > offset)
+        {
+            bufPtr += chunkEnd - offset;
+            offset = chunkEnd;
+        }
+        prevPtrPtr = &(*prevPtrPtr)->nextPtr;
+    }
+
+    // Replace the following chunks included in the received data
+    while ((*prevPtrPtr) && (((*prevPtrPtr)->offset + (*prevPtrPtr)->len) <= endOffset))
     {
-        if (DWL_OK != LoadResumeData(pkgDwlPtr))
+        chunkPtr = *prevPtrPtr;
+        *prevPtrPtr = chunkPtr->nextPtr;
+        RangeDwlObj.bufferedLen -= chunkPtr->len;
+        lwm2m_free(chunkPtr);
+    }
+
+    // Ignore the data already buffered by the following chunk
+    if ((*prevPtrPtr) && ((*prevPtrPtr)->offset < endOffset))
+    {
+        endOffset = (*prevPtrPtr)->offset;
+    }
+    bufSize = (size_t)(endOffset - offset);
+
+    // The ranges are given in order to guarantee this limit, the data should not be buffered
+    // if it is exceeded
+    if ((RangeDwlObj.bufferedLen + bufSize) > PKG_DWL_REORDER_MAX_LEN)
+    {
+        LOG_ARG("Unable to buffer %zu bytes, already %zu bytes buffered",
+                bufSize, RangeDwlObj.bufferedLen);
+        return DWL_FAULT;
+    }
+
+    chunkPtr = (RangeChunk_t*)lwm2mcore_MallocTag(sizeof(RangeChunk_t) + bufSize,
+                                                  LWM2MCORE_HEAP_TAG_PACKAGE_DOWNLOADER);
+    if (!chunkPtr)
+    {
+        LOG("Unable to allocate a range chunk");
+        return DWL_FAULT;
+    }
+    chunkPtr->offset = offset;
+    chunkPtr->len = bufSize;
+    memcpy(chunkPtr->data, bufPtr, bufSize);
+
+    chunkPtr->nextPtr = *prevPtrPtr;
+    *prevPtrPtr = chunkPtr;
+    RangeDwlObj.bufferedLen += bufSize;
+
+    return DWL_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Process the data received in package order during a multi-range download, followed by the
+ * buffered data chunks which become contiguous with it.
+ *
+ * @return
+ *  - DWL_OK      The function succeeded
+ *  - DWL_FAULT   The function failed
+ */
+//--------------------------------------------------------------------------------------------------
+static lwm2mcore_DwlResult_t ProcessRangeData
+(
+    uint8_t* bufPtr,    ///< Data to process
+    size_t   bufSize    ///< Size of data to process
+)
+{
+    lwm2mcore_DwlResult_t result;
+
+    result = lwm2mcore_PackageDownloaderReceiveData(bufPtr, bufSize);
+    RangeDwlObj.receivedOffset += bufSize;
+
+    while ((DWL_OK == result)
+        && (RangeDwlObj.chunkListPtr)
+        && (RangeDwlObj.chunkListPtr->offset <= RangeDwlObj.receivedOffset))
+    {
+        RangeChunk_t* chunkPtr = RangeDwlObj.chunkListPtr;
+        uint64_t chunkEnd = chunkPtr->offset + chunkPtr->len;
+
+        // Skip the data of the chunk which was already received
+        if (chunkEnd > RangeDwlObj.receivedOffset)
         {
-            LOG("Unable to load resume data");
-            SetUpdateResult(PKG_DWL_ERROR_CONNECTION);
-            PkgDwlObj.state = PKG_DWL_ERROR;
-            return;
+            size_t skipLen = (size_t)(RangeDwlObj.receivedOffset - chunkPtr->offset);
+
+            result = lwm2mcore_PackageDownloaderReceiveData(chunkPtr->data + skipLen,
+                                                            chunkPtr->len - skipLen);
+            RangeDwlObj.receivedOffset = chunkEnd;
         }
+
+        RangeDwlObj.chunkListPtr = chunkPtr->nextPtr;
+        RangeDwlObj.bufferedLen -= chunkPtr->len;
+        lwm2m_free(chunkPtr);
     }
 
-    // Notify the application of the download start
-    PkgDwlEvent(PKG_DWL_EVENT_DL_START, pkgDwlPtr);
+    return result;
+}
 
-    // Start downloading
-    LOG_ARG("Download starting at offset %llu", PkgDwlObj.offset);
-    PkgDwlObj.result = pkgDwlPtr->download(PkgDwlObj.offset, pkgDwlPtr->ctxPtr);
+//--------------------------------------------------------------------------------------------------
+/**
+ * Process the result of the package transfer and determine next state
+ */
+//--------------------------------------------------------------------------------------------------
+static void ProcessTransferResult
+(
+    lwm2mcore_DwlResult_t transferResult    ///< Transfer result
+)
+{
+    // Data still buffered at this point can't be processed anymore: the download is either
+    // suspended, in which case it will be downloaded again, or stopped
+    ReleaseRangeChunks();
+
+    PkgDwlObj.result = transferResult;
     switch (PkgDwlObj.result)
     {
         case DWL_OK:
@@ -1724,15 +2097,101 @@ static void PkgDwlDownload
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Parse downloaded data and determine next state
+ * Download the package
  */
 //--------------------------------------------------------------------------------------------------
-static void PkgDwlParse
+static void PkgDwlDownload
 (
     lwm2mcore_PackageDownloader_t* pkgDwlPtr    ///< Package downloader
 )
 {
-    (void)pkgDwlPtr;
+    // Notify the download beginning
+    // Set update state to 'Downloading'
+    switch (pkgDwlPtr->data.updateType)
+    {
+        case LWM2MCORE_FW_UPDATE_TYPE:
+            PkgDwlObj.result =
+                    pkgDwlPtr->setFwUpdateState(LWM2MCORE_FW_UPDATE_STATE_DOWNLOADING);
+            break;
+        case LWM2MCORE_SW_UPDATE_TYPE:
+            PkgDwlObj.result =
+                    pkgDwlPtr->setSwUpdateState(LWM2MCORE_SW_UPDATE_STATE_DOWNLOAD_STARTED);
+            break;
+         default:
+           LOG("unknown download type");
+            PkgDwlObj.result = DWL_FAULT;
+            break;
+    }
+    if (DWL_OK != PkgDwlObj.result)
+    {
+        LOG("Unable to set update state");
+        SetUpdateResult(PKG_DWL_ERROR_CONNECTION);
+        PkgDwlObj.state = PKG_DWL_ERROR;
+        return;
+    }
+
+    // Be ready to parse downloaded data
+    PkgDwlObj.state = PKG_DWL_PARSE;
+
+    // Check if the package downloader workspace should be used to compute the download offset.
+    // This is the case if it is a download resume and data was already stored.
+    if ((PkgDwlPtr->data.isResume) && (PkgDwlPtr->data.updateOffset))
+    {
+        if (DWL_OK != LoadResumeData(pkgDwlPtr))
+        {
+            LOG("Unable to load resume data");
+            SetUpdateResult(PKG_DWL_ERROR_CONNECTION);
+            PkgDwlObj.state = PKG_DWL_ERROR;
+            return;
+        }
+    }
+
+    // Notify the application of the download start
+    PkgDwlEvent(PKG_DWL_EVENT_DL_START, pkgDwlPtr);
+
+    // Start downloading
+    if ((pkgDwlPtr->downloadRanges) && (pkgDwlPtr->data.packageSize > PkgDwlObj.offset))
+    {
+        // The package is downloaded by ranges, from the current offset to the end of the package
+        memset(&RangeDwlObj, 0, sizeof(RangeDwlObj_t));
+        RangeDwlObj.nextRangeOffset = PkgDwlObj.offset;
+        RangeDwlObj.receivedOffset = PkgDwlObj.offset;
+        RangeDwlObj.endOffset = pkgDwlPtr->data.packageSize;
+
+        LOG_ARG("Multi-range download starting at offset %llu", PkgDwlObj.offset);
+        PkgDwlObj.result = pkgDwlPtr->downloadRanges(pkgDwlPtr->ctxPtr);
+    }
+    else
+    {
+        LOG_ARG("Download starting at offset %llu", PkgDwlObj.offset);
+        PkgDwlObj.result = pkgDwlPtr->download(PkgDwlObj.offset, pkgDwlPtr->ctxPtr);
+    }
+
+    if (DWL_BUSY == PkgDwlObj.result)
+    {
+        // Asynchronous transfer: the received data are processed from the application event loop,
+        // until the transfer end is notified by lwm2mcore_PackageDownloaderEndTransfer
+        LOG("Asynchronous transfer started");
+        PkgDwlObj.result = DWL_OK;
+        PkgDwlObj.isTransferPending = true;
+        PkgDwlObj.endOfProcessing = true;
+        return;
+    }
+
+    ProcessTransferResult(PkgDwlObj.result);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parse downloaded data and determine next state
+ */
+//--------------------------------------------------------------------------------------------------
+static void PkgDwlParse
+(
+    lwm2mcore_PackageDownloader_t* pkgDwlPtr    ///< Package downloader
+)
+{
+    (void)pkgDwlPtr;
     // Parse downloaded data and determine next state
     PkgDwlObj.result = DwlParser();
     if (DWL_OK != PkgDwlObj.result)
@@ -1743,6 +2202,118 @@ static void PkgDwlParse
     }
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Decompress the downloaded compressed binary data and store the decompressed data.
+ *
+ * The decompressed data are given to the storeRange callback by chunks of at most
+ * DECOMP_DATA_MAX_LEN bytes.
+ *
+ * @return
+ *  - DWL_OK      The function succeeded
+ *  - DWL_FAULT   The function failed
+ */
+//--------------------------------------------------------------------------------------------------
+static lwm2mcore_DwlResult_t StoreDecompressedData
+(
+    lwm2mcore_PackageDownloader_t* pkgDwlPtr    ///< Package downloader
+)
+{
+    uint8_t* inBufPtr = DwlParserObj.dataToParsePtr;
+    size_t   inLen = PkgDwlObj.processedLen;
+    size_t   producedLen;
+
+    if (!DwlParserObj.decompCtxPtr)
+    {
+        LOG("No decompression context");
+        SetUpdateResult(PKG_DWL_ERROR_PKG_TYPE);
+        return DWL_FAULT;
+    }
+
+    do
+    {
+        uint8_t* outBufPtr = DecompData;
+        size_t   consumedLen = inLen;
+        size_t   outLen;
+
+        producedLen = DECOMP_DATA_MAX_LEN;
+        if (LWM2MCORE_ERR_COMPLETED_OK != lwm2mcore_ProcessDecompression(
+                                                                    DwlParserObj.decompCtxPtr,
+                                                                    inBufPtr,
+                                                                    &consumedLen,
+                                                                    DecompData,
+                                                                    &producedLen,
+                                                                    &DwlParserObj.isDecompEnd))
+        {
+            LOG("Error while decompressing binary data");
+            SetUpdateResult(PKG_DWL_ERROR_VERIFY);
+            return DWL_FAULT;
+        }
+        inBufPtr += consumedLen;
+        inLen -= consumedLen;
+
+        // Check that the decompression progresses
+        if ((inLen) && (!consumedLen) && (!producedLen))
+        {
+            LOG_ARG("Unexpected %zu bytes after the end of the compressed data", inLen);
+            SetUpdateResult(PKG_DWL_ERROR_VERIFY);
+            return DWL_FAULT;
+        }
+
+        // Do not store again the data already stored before the download resume
+        outLen = producedLen;
+        if (PkgDwlObj.decompGap)
+        {
+            size_t skippedLen = (outLen < PkgDwlObj.decompGap) ?
+                                outLen : (size_t)PkgDwlObj.decompGap;
+            outBufPtr += skippedLen;
+            outLen -= skippedLen;
+            PkgDwlObj.decompGap -= skippedLen;
+        }
+
+        if (outLen)
+        {
+            // A busy storage still accepts the data, the processing stops after this chunk
+            lwm2mcore_DwlResult_t result = pkgDwlPtr->storeRange(outBufPtr,
+                                                                 outLen,
+                                                                 pkgDwlPtr->ctxPtr);
+            if (DWL_BUSY == result)
+            {
+                PkgDwlObj.isStoreBusy = true;
+            }
+            else if (DWL_OK != result)
+            {
+                LOG("Error during decompressed data storage");
+                SetUpdateResult(PKG_DWL_ERROR_OUT_OF_MEMORY);
+                return DWL_FAULT;
+            }
+        }
+    }
+    while ((inLen) || (DECOMP_DATA_MAX_LEN == producedLen));
+
+    // Check if all compressed data is received
+    if (0 == DwlParserObj.remainingBinaryData)
+    {
+        if (!DwlParserObj.isDecompEnd)
+        {
+            LOG("Compressed binary data is truncated");
+            SetUpdateResult(PKG_DWL_ERROR_VERIFY);
+            return DWL_FAULT;
+        }
+
+        if (PkgDwlObj.decompGap)
+        {
+            LOG_ARG("Incoherent update offset, %llu bytes not found", PkgDwlObj.decompGap);
+            SetUpdateResult(PKG_DWL_ERROR_VERIFY);
+            return DWL_FAULT;
+        }
+
+        StopDecompression();
+    }
+
+    return DWL_OK;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Store downloaded data and determine next state
@@ -1753,10 +2324,32 @@ static void PkgDwlStore
     lwm2mcore_PackageDownloader_t* pkgDwlPtr    ///< Package downloader
 )
 {
+    // Compressed binary data are decompressed before being stored
+    if (DWL_TYPE_COMP == DwlParserObj.section)
+    {
+        PkgDwlObj.result = StoreDecompressedData(pkgDwlPtr);
+        if (DWL_OK != PkgDwlObj.result)
+        {
+            // updateResult is already set by StoreDecompressedData
+            PkgDwlObj.state = PKG_DWL_ERROR;
+            return;
+        }
+
+        // Parse next downloaded data
+        PkgDwlObj.state = PKG_DWL_PARSE;
+        return;
+    }
+
     // Store downloaded data
     PkgDwlObj.result = pkgDwlPtr->storeRange(DwlParserObj.dataToParsePtr,
                                              PkgDwlObj.processedLen,
                                              pkgDwlPtr->ctxPtr);
+    if (DWL_BUSY == PkgDwlObj.result)
+    {
+        // The data are stored, but the received data processing should stop after them
+        PkgDwlObj.isStoreBusy = true;
+        PkgDwlObj.result = DWL_OK;
+    }
     if (DWL_OK != PkgDwlObj.result)
     {
         LOG("Error during data storage");
@@ -1908,6 +2501,9 @@ static void PkgDwlEnd
         }
     }
 
+    // Release the decompression context if the download ended during a compressed binary
+    StopDecompression();
+
     // Notify the application of the download end
     PkgDwlEvent(PKG_DWL_EVENT_DL_END, pkgDwlPtr);
 
@@ -1937,6 +2533,10 @@ static void PkgDwlSuspend
 {
     LOG("Suspend package download");
 
+    // The decompression is restarted from the beginning of the compressed data when the download
+    // is resumed, release the decompression context
+    StopDecompression();
+
     // End of download
     PkgDwlObj.result = pkgDwlPtr->endDownload(pkgDwlPtr->ctxPtr);
     if (DWL_OK != PkgDwlObj.result)
@@ -1948,6 +2548,69 @@ static void PkgDwlSuspend
     PkgDwlObj.endOfProcessing = true;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Run the package downloader state machine until the end of processing: end of download, error,
+ * suspend or asynchronous transfer start
+ */
+//--------------------------------------------------------------------------------------------------
+static void RunStateMachine
+(
+    lwm2mcore_PackageDownloader_t* pkgDwlPtr    ///< Package downloader
+)
+{
+    // Run the package downloader until end of processing is reached (end of file, error...)
+    while (!PkgDwlObj.endOfProcessing)
+    {
+        // Run the package downloader action based on the current state
+        switch (PkgDwlObj.state)
+        {
+            case PKG_DWL_INIT:
+                PkgDwlInit(pkgDwlPtr);
+                break;
+
+            case PKG_DWL_INFO:
+                PkgDwlGetInfo(pkgDwlPtr);
+                break;
+
+            case PKG_DWL_DOWNLOAD:
+                PkgDwlDownload(pkgDwlPtr);
+                break;
+
+            case PKG_DWL_PARSE:
+            case PKG_DWL_STORE:
+                // The package downloading function PkgDwlDownload is blocking and the received
+                // data are processed by the lwm2mcore_PackageDownloaderReceiveData callback.
+                // After the download end, the state is set to END or ERROR, PkgDwlDownload returns
+                // and this loop is unblocked. For an asynchronous transfer, this loop is stopped
+                // until the transfer end.
+                // The state should therefore never be set to PARSE or STORE in this loop.
+                LOG_ARG("Unexpected package downloader state %d in Run", PkgDwlObj.state);
+                PkgDwlObj.result = DWL_FAULT;
+                PkgDwlObj.endOfProcessing = true;
+                break;
+
+            case PKG_DWL_ERROR:
+                PkgDwlError(pkgDwlPtr);
+                break;
+
+            case PKG_DWL_END:
+                PkgDwlEnd(pkgDwlPtr);
+                break;
+
+            case PKG_DWL_SUSPEND:
+                PkgDwlSuspend(pkgDwlPtr);
+                break;
+
+            default:
+                LOG_ARG("Unknown package downloader state %d in Run", PkgDwlObj.state);
+                PkgDwlObj.result = DWL_FAULT;
+                PkgDwlObj.endOfProcessing = true;
+                break;
+        }
+    }
+}
+
 //--------------------------------------------------------------------------------------------------
 // Public functions
 //--------------------------------------------------------------------------------------------------
@@ -1958,8 +2621,14 @@ static void PkgDwlSuspend
  *
  * This function is called to launch the package downloader.
  *
+ * If the download callback starts an asynchronous transfer, this function returns DWL_BUSY once
+ * the transfer is started: the package downloader is then driven by the application event loop
+ * with lwm2mcore_PackageDownloaderProcessData() and lwm2mcore_PackageDownloaderEndTransfer(),
+ * without blocking the calling thread.
+ *
  * @return
  *  - DWL_OK    The function succeeded
+ *  - DWL_BUSY  The asynchronous transfer is started
  *  - DWL_FAULT The function failed
  */
 //--------------------------------------------------------------------------------------------------
@@ -2038,54 +2707,13 @@ lwm2mcore_DwlResult_t lwm2mcore_PackageDownloaderRun
     PkgDwlObj.endOfProcessing = false;
     PkgDwlObj.packageType = LWM2MCORE_PKG_NONE;
 
-    // Run the package downloader until end of processing is reached (end of file, error...)
-    while (!PkgDwlObj.endOfProcessing)
-    {
-        // Run the package downloader action based on the current state
-        switch (PkgDwlObj.state)
-        {
-            case PKG_DWL_INIT:
-                PkgDwlInit(pkgDwlPtr);
-                break;
-
-            case PKG_DWL_INFO:
-                PkgDwlGetInfo(pkgDwlPtr);
-                break;
-
-            case PKG_DWL_DOWNLOAD:
-                PkgDwlDownload(pkgDwlPtr);
-                break;
-
-            case PKG_DWL_PARSE:
-            case PKG_DWL_STORE:
-                // The package downloading function PkgDwlDownload is blocking and the received
-                // data are processed by the lwm2mcore_PackageDownloaderReceiveData callback.
-                // After the download end, the state is set to END or ERROR, PkgDwlDownload returns
-                // and this loop is unblocked.
-                // The state should therefore never be set to PARSE or STORE in this loop.
-                LOG_ARG("Unexpected package downloader state %d in Run", PkgDwlObj.state);
-                PkgDwlObj.result = DWL_FAULT;
-                PkgDwlObj.endOfProcessing = true;
-                break;
-
-            case PKG_DWL_ERROR:
-                PkgDwlError(pkgDwlPtr);
-                break;
-
-            case PKG_DWL_END:
-                PkgDwlEnd(pkgDwlPtr);
-                break;
-
-            case PKG_DWL_SUSPEND:
-                PkgDwlSuspend(pkgDwlPtr);
-                break;
+    RunStateMachine(pkgDwlPtr);
 
-            default:
-                LOG_ARG("Unknown package downloader state %d in Run", PkgDwlObj.state);
-                PkgDwlObj.result = DWL_FAULT;
-                PkgDwlObj.endOfProcessing = true;
-                break;
-        }
+    // The package downloader is driven by the application event loop during an asynchronous
+    // transfer
+    if (PkgDwlObj.isTransferPending)
+    {
+        return DWL_BUSY;
     }
 
     return PkgDwlObj.result;
@@ -2097,6 +2725,9 @@ lwm2mcore_DwlResult_t lwm2mcore_PackageDownloaderRun
  *
  * Downloaded data should be sequentially transmitted to the package downloader with this function.
  *
+ * @note The data are entirely processed even if the storage is busy: flow control is only provided
+ * by lwm2mcore_PackageDownloaderProcessData().
+ *
  * @return
  *  - DWL_OK    The function succeeded
  *  - DWL_FAULT The function failed
@@ -2107,6 +2738,44 @@ lwm2mcore_DwlResult_t lwm2mcore_PackageDownloaderReceiveData
     uint8_t* bufPtr,    ///< Received data
     size_t   bufSize    ///< Size of received data
 )
+{
+    lwm2mcore_DwlResult_t result;
+
+    do
+    {
+        size_t processedLen = 0;
+
+        result = lwm2mcore_PackageDownloaderProcessData(bufPtr, bufSize, &processedLen);
+        bufPtr += processedLen;
+        bufSize -= processedLen;
+    }
+    while ((DWL_BUSY == result) && (bufSize));
+
+    return (DWL_BUSY == result) ? DWL_OK : result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Process the downloaded data, with flow control.
+ *
+ * Downloaded data should be sequentially transmitted to the package downloader with this function,
+ * typically from the application event loop for an asynchronous transfer. If the storage can't
+ * accept more data (storeRange callback returning DWL_BUSY), the processing stops and DWL_BUSY is
+ * returned: the remaining data, starting after the processed length, should be transmitted again
+ * once the storage completes some writes.
+ *
+ * @return
+ *  - DWL_OK    All the data are processed
+ *  - DWL_BUSY  Only the processed length of data is processed, the storage is busy
+ *  - DWL_FAULT The function failed
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_DwlResult_t lwm2mcore_PackageDownloaderProcessData
+(
+    uint8_t* bufPtr,            ///< [IN] Received data
+    size_t   bufSize,           ///< [IN] Size of received data
+    size_t*  processedLenPtr    ///< [OUT] Length of processed data
+)
 {
     // Check if the necessary callback is correctly set
     if ((!PkgDwlPtr) || (!PkgDwlPtr->storeRange))
@@ -2116,11 +2785,12 @@ lwm2mcore_DwlResult_t lwm2mcore_PackageDownloaderReceiveData
     }
 
     // Check downloaded buffer
-    if (!bufPtr)
+    if ((!bufPtr) || (!processedLenPtr))
     {
         LOG("Null data pointer");
         return DWL_FAULT;
     }
+    *processedLenPtr = 0;
     if (0 == bufSize)
     {
         LOG("No data to process");
@@ -2143,6 +2813,8 @@ lwm2mcore_DwlResult_t lwm2mcore_PackageDownloaderReceiveData
                 lwm2mcore_DwlResult_t result = BufferAndSetDataToParse(&parseData);
                 if ((DWL_OK != result) || (!parseData))
                 {
+                    // The remaining data are kept in the temporary buffer if not parsed
+                    *processedLenPtr = bufSize;
                     return result;
                 }
                 // Reset processed length
@@ -2214,11 +2886,180 @@ lwm2mcore_DwlResult_t lwm2mcore_PackageDownloaderReceiveData
                 PkgDwlObj.downloadedLen -= PkgDwlObj.processedLen;
             }
         }
+
+        // Stop processing the received data if the storage is busy
+        if ((PkgDwlObj.isStoreBusy) && (DWL_OK == PkgDwlObj.result))
+        {
+            PkgDwlObj.isStoreBusy = false;
+            *processedLenPtr = bufSize - PkgDwlObj.downloadedLen;
+            return DWL_BUSY;
+        }
     }
 
+    *processedLenPtr = bufSize - PkgDwlObj.downloadedLen;
     return PkgDwlObj.result;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Notify the end of an asynchronous transfer.
+ *
+ * This function is called when the transfer started by the download callback returning DWL_BUSY
+ * ends, with the result the download callback would have returned for a blocking download. The
+ * package downloader then ends or suspends the download, as lwm2mcore_PackageDownloaderRun()
+ * does after a blocking download.
+ *
+ * @return
+ *  - DWL_OK    The function succeeded
+ *  - DWL_FAULT The function failed or no asynchronous transfer is ongoing
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_DwlResult_t lwm2mcore_PackageDownloaderEndTransfer
+(
+    lwm2mcore_DwlResult_t transferResult    ///< [IN] Transfer result: DWL_OK, DWL_SUSPEND,
+                                            ///<      DWL_ABORTED or DWL_FAULT
+)
+{
+    if ((!PkgDwlPtr) || (!PkgDwlObj.isTransferPending))
+    {
+        LOG("No asynchronous transfer ongoing");
+        return DWL_FAULT;
+    }
+
+    LOG_ARG("Asynchronous transfer end, result %d", transferResult);
+    PkgDwlObj.isTransferPending = false;
+    PkgDwlObj.isStoreBusy = false;
+    PkgDwlObj.endOfProcessing = false;
+
+    // Continue the state machine as after a blocking download
+    ProcessTransferResult(transferResult);
+    RunStateMachine(PkgDwlPtr);
+
+    return PkgDwlObj.result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the next range of the package to download.
+ *
+ * This function is called by the multi-range download callback each time a new range can be
+ * downloaded. Ranges are given in the package order and are at most PKG_DWL_RANGE_LEN long.
+ *
+ * The package downloader only gives a range if its data can be buffered until the preceding data
+ * is received: if the next range is too far ahead of the data already processed, DWL_BUSY is
+ * returned and the function should be called again once more data is received.
+ *
+ * @return
+ *  - DWL_OK    The range is set, a null length indicating that the whole package was requested
+ *  - DWL_BUSY  No range can be downloaded for now
+ *  - DWL_FAULT The function failed
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_DwlResult_t lwm2mcore_PackageDownloaderGetNextRange
+(
+    lwm2mcore_PackageRange_t* rangePtr  ///< [OUT] Next range to download
+)
+{
+    uint64_t rangeLen;
+
+    if (!rangePtr)
+    {
+        LOG("Null range pointer");
+        return DWL_FAULT;
+    }
+
+    // No need to download more data if an error occurred
+    if ((!PkgDwlPtr) || (DWL_OK != PkgDwlObj.result))
+    {
+        LOG("No package download in progress");
+        return DWL_FAULT;
+    }
+
+    rangeLen = RangeDwlObj.endOffset - RangeDwlObj.nextRangeOffset;
+    if (rangeLen > PKG_DWL_RANGE_LEN)
+    {
+        rangeLen = PKG_DWL_RANGE_LEN;
+    }
+
+    // Check that the range data can be buffered if it is received before the preceding ranges
+    if ((RangeDwlObj.nextRangeOffset + rangeLen - RangeDwlObj.receivedOffset)
+        > PKG_DWL_REORDER_MAX_LEN)
+    {
+        return DWL_BUSY;
+    }
+
+    rangePtr->startOffset = RangeDwlObj.nextRangeOffset;
+    rangePtr->length = rangeLen;
+    RangeDwlObj.nextRangeOffset += rangeLen;
+
+    return DWL_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Process data downloaded from a package range.
+ *
+ * The data of the ranges given by lwm2mcore_PackageDownloaderGetNextRange() can be transmitted
+ * in any order with this function: the data are buffered until all the preceding data are
+ * received, in order to be parsed, hashed and stored sequentially.
+ *
+ * @warning This function is not reentrant: calls should be serialized by the caller.
+ *
+ * @return
+ *  - DWL_OK    The function succeeded
+ *  - DWL_FAULT The function failed
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_DwlResult_t lwm2mcore_PackageDownloaderReceiveRange
+(
+    uint64_t offset,    ///< Offset of the received data in the package
+    uint8_t* bufPtr,    ///< Received data
+    size_t   bufSize    ///< Size of received data
+)
+{
+    // Check downloaded buffer
+    if (!bufPtr)
+    {
+        LOG("Null data pointer");
+        return DWL_FAULT;
+    }
+    if (0 == bufSize)
+    {
+        LOG("No data to process");
+        return DWL_OK;
+    }
+
+    // Only data from the requested ranges is expected
+    if ((offset + bufSize) > RangeDwlObj.nextRangeOffset)
+    {
+        LOG_ARG("Unexpected data at offset %llu, length %zu", offset, bufSize);
+        return DWL_FAULT;
+    }
+
+    // Ignore the data already processed, e.g. in case of retransmission
+    if (offset < RangeDwlObj.receivedOffset)
+    {
+        size_t skipLen;
+
+        if ((offset + bufSize) <= RangeDwlObj.receivedOffset)
+        {
+            return DWL_OK;
+        }
+        skipLen = (size_t)(RangeDwlObj.receivedOffset - offset);
+        offset += skipLen;
+        bufPtr += skipLen;
+        bufSize -= skipLen;
+    }
+
+    // Data following the preceding data is directly processed, otherwise it is buffered
+    if (offset == RangeDwlObj.receivedOffset)
+    {
+        return ProcessRangeData(bufPtr, bufSize);
+    }
+
+    return BufferRangeChunk(offset, bufPtr, bufSize);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Initialize the package downloader.
@@ -19,6 +19,21 @@
 // Symbol and Enum definitions
 //--------------------------------------------------------------------------------------------------
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximal length of a range given for a multi-range download
+ */
+//--------------------------------------------------------------------------------------------------
+#define PKG_DWL_RANGE_LEN           65536
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximal length of the downloaded data buffered while waiting for the preceding data, during a
+ * multi-range download. This also limits the number of ranges downloaded at the same time.
+ */
+//--------------------------------------------------------------------------------------------------
+#define PKG_DWL_REORDER_MAX_LEN     262144
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Package downloader result codes
@@ -29,13 +44,17 @@ typedef enum
     DWL_OK      =  0,   ///< Successful
     DWL_FAULT   = -1,   ///< Internal error
     DWL_SUSPEND = -2,   ///< Download suspended
-    DWL_ABORTED = -3    ///< Download aborted
+    DWL_ABORTED = -3,   ///< Download aborted
+    DWL_BUSY    = -4    ///< Temporarily unable to process the request, retry later
 }
 lwm2mcore_DwlResult_t;
 
 //--------------------------------------------------------------------------------------------------
 /**
  * Package downloader data structure
+ *
+ * @note For a compressed binary (DWL COMP section), the update offset is the length of
+ * decompressed data already stored by the storeRange callback.
  */
 //--------------------------------------------------------------------------------------------------
 typedef struct
@@ -48,6 +67,18 @@ typedef struct
 }
 lwm2mcore_PackageDownloaderData_t;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Package range structure, used for a multi-range download
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint64_t startOffset;       ///< Offset of the first byte of the range in the package
+    uint64_t length;            ///< Length of the range
+}
+lwm2mcore_PackageRange_t;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Callback for package download initialization
@@ -168,9 +199,17 @@ typedef lwm2mcore_DwlResult_t (*lwm2mcore_SetSwUpdateResult_t)
  * Downloaded data should then be sequentially transmitted to the package downloader using
  * the lwm2mcore_PackageDownloaderReceiveData() function.
  *
+ * The callback can also only start an asynchronous transfer and return DWL_BUSY, in which case
+ * lwm2mcore_PackageDownloaderRun() returns immediately. The downloaded data should then be
+ * transmitted from the application event loop with lwm2mcore_PackageDownloaderProcessData(), and
+ * the transfer end should be notified with lwm2mcore_PackageDownloaderEndTransfer().
+ *
  * @return
- *  - DWL_OK    The function succeeded
- *  - DWL_FAULT The function failed
+ *  - DWL_OK      The function succeeded
+ *  - DWL_BUSY    The asynchronous transfer is started
+ *  - DWL_SUSPEND The download is suspended
+ *  - DWL_ABORTED The download is aborted
+ *  - DWL_FAULT   The function failed
  *
  * @warning This callback should be set to NULL if not implemented
  */
@@ -181,6 +220,33 @@ typedef lwm2mcore_DwlResult_t (*lwm2mcore_Download_t)
     void* ctxPtr                ///< Context pointer
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Callback to download a package using several byte ranges
+ *
+ * This callback should download the package by ranges, possibly using several concurrent
+ * connections to the server. Each range to download is retrieved with the
+ * lwm2mcore_PackageDownloaderGetNextRange() function, and the downloaded data of all ranges should
+ * then be transmitted to the package downloader with the lwm2mcore_PackageDownloaderReceiveRange()
+ * function, in any order. The callback should return once all the ranges are downloaded, or
+ * return DWL_BUSY after starting an asynchronous transfer, as the download callback.
+ *
+ * @return
+ *  - DWL_OK    The function succeeded
+ *  - DWL_BUSY  The asynchronous transfer is started
+ *  - DWL_FAULT The function failed
+ *
+ * @note This callback is optional and only used if the package size is known. The download
+ * callback is used otherwise.
+ *
+ * @warning This callback should be set to NULL if not implemented
+ */
+//--------------------------------------------------------------------------------------------------
+typedef lwm2mcore_DwlResult_t (*lwm2mcore_DownloadRanges_t)
+(
+    void* ctxPtr                ///< Context pointer
+);
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Callback to store a package range after treatment
@@ -188,8 +254,15 @@ typedef lwm2mcore_DwlResult_t (*lwm2mcore_Download_t)
  * This callback should store the data given in the buffer for a firmware update.
  * bufSize indicates the length of the buffer to store.
  *
+ * An asynchronous storage returns DWL_BUSY when the data are accepted but its write queue is
+ * full: lwm2mcore_PackageDownloaderProcessData() then stops processing the received data and
+ * returns DWL_BUSY, so that the application stops reading the transfer until the storage
+ * completes some writes. The data must be accepted anyway, as a compressed binary chunk may still
+ * produce a few more calls before the processing stops.
+ *
  * @return
  *  - DWL_OK    The function succeeded
+ *  - DWL_BUSY  The data are stored, the storage can't accept more data for now
  *  - DWL_FAULT The function failed
  *
  * @warning This callback should be set to NULL if not implemented
@@ -246,6 +319,7 @@ typedef struct
     lwm2mcore_StoreRange_t            storeRange;           ///< Storing callback
     lwm2mcore_EndDownload_t           endDownload;          ///< Ending callback
     void*                             ctxPtr;               ///< Context pointer
+    lwm2mcore_DownloadRanges_t        downloadRanges;       ///< Multi-range download callback
 }
 lwm2mcore_PackageDownloader_t;
 
@@ -259,8 +333,14 @@ lwm2mcore_PackageDownloader_t;
  *
  * This function is called to launch the package downloader.
  *
+ * If the download callback starts an asynchronous transfer, this function returns DWL_BUSY once
+ * the transfer is started: the package downloader is then driven by the application event loop
+ * with lwm2mcore_PackageDownloaderProcessData() and lwm2mcore_PackageDownloaderEndTransfer(),
+ * without blocking the calling thread.
+ *
  * @return
  *  - DWL_OK    The function succeeded
+ *  - DWL_BUSY  The asynchronous transfer is started
  *  - DWL_FAULT The function failed
  */
 //--------------------------------------------------------------------------------------------------
@@ -286,6 +366,93 @@ lwm2mcore_DwlResult_t lwm2mcore_PackageDownloaderReceiveData
     size_t   bufSize    ///< Size of received data
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Process the downloaded data, with flow control.
+ *
+ * Downloaded data should be sequentially transmitted to the package downloader with this function,
+ * typically from the application event loop for an asynchronous transfer. If the storage can't
+ * accept more data (storeRange callback returning DWL_BUSY), the processing stops and DWL_BUSY is
+ * returned: the remaining data, starting after the processed length, should be transmitted again
+ * once the storage completes some writes.
+ *
+ * @return
+ *  - DWL_OK    All the data are processed
+ *  - DWL_BUSY  Only the processed length of data is processed, the storage is busy
+ *  - DWL_FAULT The function failed
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_DwlResult_t lwm2mcore_PackageDownloaderProcessData
+(
+    uint8_t* bufPtr,            ///< [IN] Received data
+    size_t   bufSize,           ///< [IN] Size of received data
+    size_t*  processedLenPtr    ///< [OUT] Length of processed data
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Notify the end of an asynchronous transfer.
+ *
+ * This function is called when the transfer started by the download callback returning DWL_BUSY
+ * ends, with the result the download callback would have returned for a blocking download. The
+ * package downloader then ends or suspends the download, as lwm2mcore_PackageDownloaderRun()
+ * does after a blocking download.
+ *
+ * @return
+ *  - DWL_OK    The function succeeded
+ *  - DWL_FAULT The function failed or no asynchronous transfer is ongoing
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_DwlResult_t lwm2mcore_PackageDownloaderEndTransfer
+(
+    lwm2mcore_DwlResult_t transferResult    ///< [IN] Transfer result: DWL_OK, DWL_SUSPEND,
+                                            ///<      DWL_ABORTED or DWL_FAULT
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the next range of the package to download.
+ *
+ * This function is called by the multi-range download callback each time a new range can be
+ * downloaded. Ranges are given in the package order and are at most PKG_DWL_RANGE_LEN long.
+ *
+ * The package downloader only gives a range if its data can be buffered until the preceding data
+ * is received: if the next range is too far ahead of the data already processed, DWL_BUSY is
+ * returned and the function should be called again once more data is received.
+ *
+ * @return
+ *  - DWL_OK    The range is set, a null length indicating that the whole package was requested
+ *  - DWL_BUSY  No range can be downloaded for now
+ *  - DWL_FAULT The function failed
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_DwlResult_t lwm2mcore_PackageDownloaderGetNextRange
+(
+    lwm2mcore_PackageRange_t* rangePtr  ///< [OUT] Next range to download
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Process data downloaded from a package range.
+ *
+ * The data of the ranges given by lwm2mcore_PackageDownloaderGetNextRange() can be transmitted
+ * in any order with this function: the data are buffered until all the preceding data are
+ * received, in order to be parsed, hashed and stored sequentially.
+ *
+ * @warning This function is not reentrant: calls should be serialized by the caller.
+ *
+ * @return
+ *  - DWL_OK    The function succeeded
+ *  - DWL_FAULT The function failed
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_DwlResult_t lwm2mcore_PackageDownloaderReceiveRange
+(
+    uint64_t offset,    ///< Offset of the received data in the package
+    uint8_t* bufPtr,    ///< Received data
+    size_t   bufSize    ///< Size of received data
+);
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Initialize the package downloader.
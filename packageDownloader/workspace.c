@@ -14,6 +14,7 @@
 #include <internals.h>
 #include <lwm2mcore/lwm2mcore.h>
 #include <lwm2mcore/paramStorage.h>
+#include "paramCache.h"
 #include "workspace.h"
 
 //--------------------------------------------------------------------------------------------------
@@ -61,7 +62,7 @@ lwm2mcore_DwlResult_t ReadPkgDwlWorkspace
     }
 
     // Check if the package downloader workspace is stored
-    sid = lwm2mcore_GetParam(LWM2MCORE_DWL_WORKSPACE_PARAM, (uint8_t*)pkgDwlWorkspacePtr, &len);
+    sid = omanager_GetParam(LWM2MCORE_DWL_WORKSPACE_PARAM, (uint8_t*)pkgDwlWorkspacePtr, &len);
     LOG_ARG("Read download workspace: len=%zu, result=%d", len, sid);
 
     if (   (LWM2MCORE_ERR_COMPLETED_OK == sid)
@@ -84,7 +85,7 @@ lwm2mcore_DwlResult_t ReadPkgDwlWorkspace
     {
         // The workspace is present but the size is not correct, delete it
         LOG("Delete download workspace");
-        sid = lwm2mcore_DeleteParam(LWM2MCORE_DWL_WORKSPACE_PARAM);
+        sid = omanager_DeleteParam(LWM2MCORE_DWL_WORKSPACE_PARAM);
     }
 
     // Copy the default configuration
@@ -108,9 +109,11 @@ lwm2mcore_DwlResult_t WritePkgDwlWorkspace
 )
 {
     lwm2mcore_DwlResult_t result = DWL_FAULT;
-    lwm2mcore_Sid_t sid = lwm2mcore_SetParam(LWM2MCORE_DWL_WORKSPACE_PARAM,
-                                             (uint8_t*)pkgDwlWorkspacePtr,
-                                             sizeof(PackageDownloaderWorkspace_t));
+    // The workspace is the download checkpoint: it is written through the parameter cache
+    lwm2mcore_Sid_t sid = omanager_SetParam(LWM2MCORE_DWL_WORKSPACE_PARAM,
+                                            (uint8_t*)pkgDwlWorkspacePtr,
+                                            sizeof(PackageDownloaderWorkspace_t),
+                                            false);
     if (LWM2MCORE_ERR_COMPLETED_OK == sid)
     {
         result = DWL_OK;
@@ -138,7 +141,7 @@ lwm2mcore_DwlResult_t DeletePkgDwlWorkspace
 )
 {
     lwm2mcore_DwlResult_t result = DWL_FAULT;
-    lwm2mcore_Sid_t sid = lwm2mcore_DeleteParam(LWM2MCORE_DWL_WORKSPACE_PARAM);
+    lwm2mcore_Sid_t sid = omanager_DeleteParam(LWM2MCORE_DWL_WORKSPACE_PARAM);
     if (LWM2MCORE_ERR_COMPLETED_OK == sid)
     {
         result = DWL_OK;
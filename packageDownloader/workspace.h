@@ -12,6 +12,7 @@
 
 #include <lwm2mcore/lwm2mcore.h>
 #include <lwm2mcore/paramStorage.h>
+#include <lwm2mcore/security.h>
 #include "lwm2mcorePackageDownloader.h"
 
 //--------------------------------------------------------------------------------------------------
@@ -23,14 +24,7 @@
  * Supported version for package downloader workspace
  */
 //--------------------------------------------------------------------------------------------------
-#define PKGDWL_WORKSPACE_VERSION    1
-
-//--------------------------------------------------------------------------------------------------
-/**
- * Maximal size of the SHA-1 context
- */
-//--------------------------------------------------------------------------------------------------
-#define SHA1_CTX_MAX_SIZE   512
+#define PKGDWL_WORKSPACE_VERSION    3
 
 //--------------------------------------------------------------------------------------------------
 // Data structures
@@ -54,7 +48,8 @@ typedef struct
     uint64_t remainingBinaryData;           ///< Remaining length of binary data to download
     uint64_t signatureSize;                 ///< Signature size read in DWL prolog
     uint32_t computedCRC;                   ///< CRC computed with downloaded data
-    uint8_t  sha1Ctx[SHA1_CTX_MAX_SIZE];    ///< SHA-1 context
+    uint32_t compressionType;               ///< Compression algorithm read in COMP header
+    uint8_t  hashState[LWM2MCORE_HASH_STATE_MAX_LEN];   ///< Serialized digest state
 }
 PackageDownloaderWorkspace_t;
 
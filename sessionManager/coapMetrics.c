@@ -0,0 +1,623 @@
+/**
+ * @file coapMetrics.c
+ *
+ * CoAP transaction metrics of the servers, see coapMetrics.h
+ *
+ * Only the fixed CoAP header (RFC 7252 section 3) and the DTLS record headers (RFC 6347
+ * section 4.1) are parsed. A confirmable message is tracked by its message Id until it is
+ * acknowledged or reset, or until the MAX_TRANSMIT_WAIT time is elapsed. A confirmable message sent
+ * with the message Id of a tracked message is a retransmission.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <platform/types.h>
+#include <lwm2mcore/lwm2mcore.h>
+#include <lwm2mcore/statistics.h>
+#include <lwm2mcore/timer.h>
+#include "coapMetrics.h"
+#include "operationStats.h"
+#include "sessionManager.h"
+#include "internals.h"
+#include "liblwm2m.h"
+
+//--------------------------------------------------------------------------------------------------
+// Symbol and Enum definitions
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * CoAP fixed header length
+ */
+//--------------------------------------------------------------------------------------------------
+#define COAP_HEADER_LEN             4
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * CoAP message types
+ */
+//--------------------------------------------------------------------------------------------------
+#define COAP_TYPE_CON               0
+#define COAP_TYPE_NON               1
+#define COAP_TYPE_ACK               2
+#define COAP_TYPE_RST               3
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * DTLS record header length
+ */
+//--------------------------------------------------------------------------------------------------
+#define DTLS_RECORD_HEADER_LEN      13
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * CoAP MAX_TRANSMIT_WAIT in microseconds, with the default transmission parameters of RFC 7252
+ * used by Wakaama: ACK_TIMEOUT * (2 ^ (MAX_RETRANSMIT + 1) - 1) * ACK_RANDOM_FACTOR
+ */
+//--------------------------------------------------------------------------------------------------
+#define COAP_MAX_TRANSMIT_WAIT_US   (93 * 1000000ULL)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of confirmable messages tracked per server
+ */
+//--------------------------------------------------------------------------------------------------
+#define PENDING_EXCHANGE_MAX_NB     8
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of received message Ids kept per server to detect the duplicate requests
+ */
+//--------------------------------------------------------------------------------------------------
+#define RECEIVED_MID_NB             8
+
+//--------------------------------------------------------------------------------------------------
+// Data structures
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Confirmable message waiting for its acknowledgement
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    bool     isUsed;                ///< The entry tracks a message
+    bool     isRetransmitted;       ///< The message was retransmitted
+    uint16_t mid;                   ///< Message Id
+    uint64_t sendTimeUs;            ///< Time of the first transmission
+}
+PendingExchange_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Metrics and tracking data of a server
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    lwm2mcore_CoapMetrics_t metrics;                    ///< Metrics
+    PendingExchange_t pending[PENDING_EXCHANGE_MAX_NB]; ///< Confirmable messages sent
+    uint16_t receivedMid[RECEIVED_MID_NB];              ///< Last received message Ids
+    uint8_t  receivedMidNb;                             ///< Number of received message Ids
+    uint8_t  receivedMidIdx;                            ///< Next received message Id entry
+    uint64_t handshakeStartUs;                          ///< Start time of the on-going handshake,
+                                                        ///< 0 if no handshake
+}
+ServerMetrics_t;
+
+//--------------------------------------------------------------------------------------------------
+// Static variables
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Metrics of the servers, in the order of their first recorded exchange
+ */
+//--------------------------------------------------------------------------------------------------
+static ServerMetrics_t ServerMetrics[LWM2MCORE_COAP_METRICS_SERVER_MAX_NB];
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of servers with metrics
+ */
+//--------------------------------------------------------------------------------------------------
+static uint16_t ServerMetricsNb;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Period of the LWM2MCORE_EVENT_COAP_METRICS event in microseconds, 0 if disabled
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t EventPeriodUs;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Time of the last LWM2MCORE_EVENT_COAP_METRICS event
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t LastEventTimeUs;
+
+//--------------------------------------------------------------------------------------------------
+// Static functions
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the metrics of a server, added if the server has no metrics yet
+ *
+ * @return
+ *      - Metrics of the server
+ *      - NULL if the maximum number of servers is reached
+ */
+//--------------------------------------------------------------------------------------------------
+static ServerMetrics_t* GetServerMetrics
+(
+    uint16_t securityInstId         ///< [IN] Security object instance Id of the server
+)
+{
+    ServerMetrics_t* serverPtr;
+    uint16_t i;
+
+    for (i = 0; i < ServerMetricsNb; i++)
+    {
+        if (securityInstId == ServerMetrics[i].metrics.securityInstId)
+        {
+            return &ServerMetrics[i];
+        }
+    }
+
+    if (LWM2MCORE_COAP_METRICS_SERVER_MAX_NB <= ServerMetricsNb)
+    {
+        return NULL;
+    }
+
+    serverPtr = &ServerMetrics[ServerMetricsNb++];
+    memset(serverPtr, 0, sizeof(ServerMetrics_t));
+    serverPtr->metrics.securityInstId = securityInstId;
+    return serverPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Count as timeouts the confirmable messages not acknowledged within MAX_TRANSMIT_WAIT
+ */
+//--------------------------------------------------------------------------------------------------
+static void ExpirePendingExchanges
+(
+    ServerMetrics_t* serverPtr,     ///< [IN] Server metrics
+    uint64_t nowUs                  ///< [IN] Current time
+)
+{
+    uint32_t i;
+
+    for (i = 0; i < PENDING_EXCHANGE_MAX_NB; i++)
+    {
+        if ((serverPtr->pending[i].isUsed)
+         && (COAP_MAX_TRANSMIT_WAIT_US <= (nowUs - serverPtr->pending[i].sendTimeUs)))
+        {
+            serverPtr->pending[i].isUsed = false;
+            serverPtr->metrics.timeoutNb++;
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Update the smoothed round-trip time with a new sample (RFC 6298 section 2)
+ */
+//--------------------------------------------------------------------------------------------------
+static void UpdateRtt
+(
+    lwm2mcore_CoapMetrics_t* metricsPtr,    ///< [INOUT] Server metrics
+    uint64_t rttUs                          ///< [IN] Round-trip time
+)
+{
+    uint32_t rtt32Us = (UINT32_MAX < rttUs) ? UINT32_MAX : (uint32_t)rttUs;
+    uint32_t deltaUs;
+
+    omanager_AddHistogramSample(&metricsPtr->rtt, rttUs);
+
+    if (1 == metricsPtr->rtt.count)
+    {
+        metricsPtr->srttUs = rtt32Us;
+        metricsPtr->rttVarUs = rtt32Us / 2;
+        return;
+    }
+
+    deltaUs = (metricsPtr->srttUs > rtt32Us) ? (metricsPtr->srttUs - rtt32Us)
+                                             : (rtt32Us - metricsPtr->srttUs);
+    metricsPtr->rttVarUs = (uint32_t)(((uint64_t)metricsPtr->rttVarUs * 3 + deltaUs) / 4);
+    metricsPtr->srttUs = (uint32_t)(((uint64_t)metricsPtr->srttUs * 7 + rtt32Us) / 8);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Record a confirmable message sent to a server
+ */
+//--------------------------------------------------------------------------------------------------
+static void RecordConfirmableSent
+(
+    ServerMetrics_t* serverPtr,     ///< [IN] Server metrics
+    uint16_t mid                    ///< [IN] Message Id
+)
+{
+    PendingExchange_t* freePtr = NULL;
+    PendingExchange_t* oldestPtr = NULL;
+    uint64_t nowUs = lwm2mcore_GetTimeUs();
+    uint32_t i;
+
+    ExpirePendingExchanges(serverPtr, nowUs);
+
+    for (i = 0; i < PENDING_EXCHANGE_MAX_NB; i++)
+    {
+        PendingExchange_t* pendingPtr = &serverPtr->pending[i];
+
+        if (!pendingPtr->isUsed)
+        {
+            if (NULL == freePtr)
+            {
+                freePtr = pendingPtr;
+            }
+        }
+        else if (mid == pendingPtr->mid)
+        {
+            pendingPtr->isRetransmitted = true;
+            serverPtr->metrics.retransmissionNb++;
+            return;
+        }
+        else if ((NULL == oldestPtr) || (pendingPtr->sendTimeUs < oldestPtr->sendTimeUs))
+        {
+            oldestPtr = pendingPtr;
+        }
+    }
+
+    serverPtr->metrics.conSentNb++;
+
+    if (NULL == freePtr)
+    {
+        /* Too many on-going exchanges: stop tracking the oldest one */
+        freePtr = oldestPtr;
+    }
+    freePtr->isUsed = true;
+    freePtr->isRetransmitted = false;
+    freePtr->mid = mid;
+    freePtr->sendTimeUs = nowUs;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Record an acknowledgement or a reset received from a server
+ */
+//--------------------------------------------------------------------------------------------------
+static void RecordAcknowledgement
+(
+    ServerMetrics_t* serverPtr,     ///< [IN] Server metrics
+    uint16_t mid                    ///< [IN] Message Id
+)
+{
+    uint32_t i;
+
+    for (i = 0; i < PENDING_EXCHANGE_MAX_NB; i++)
+    {
+        PendingExchange_t* pendingPtr = &serverPtr->pending[i];
+
+        if ((pendingPtr->isUsed) && (mid == pendingPtr->mid))
+        {
+            pendingPtr->isUsed = false;
+
+            /* The round-trip time of a retransmitted message is ambiguous (Karn's algorithm) */
+            if (!pendingPtr->isRetransmitted)
+            {
+                uint64_t nowUs = lwm2mcore_GetTimeUs();
+                UpdateRtt(&serverPtr->metrics,
+                          (nowUs > pendingPtr->sendTimeUs) ? (nowUs - pendingPtr->sendTimeUs) : 0);
+            }
+            return;
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Record a request received from a server and check if it is a duplicate
+ */
+//--------------------------------------------------------------------------------------------------
+static void RecordRequest
+(
+    ServerMetrics_t* serverPtr,     ///< [IN] Server metrics
+    uint16_t mid                    ///< [IN] Message Id
+)
+{
+    uint8_t i;
+
+    for (i = 0; i < serverPtr->receivedMidNb; i++)
+    {
+        if (mid == serverPtr->receivedMid[i])
+        {
+            serverPtr->metrics.duplicateNb++;
+            return;
+        }
+    }
+
+    serverPtr->receivedMid[serverPtr->receivedMidIdx] = mid;
+    serverPtr->receivedMidIdx = (serverPtr->receivedMidIdx + 1) % RECEIVED_MID_NB;
+    if (RECEIVED_MID_NB > serverPtr->receivedMidNb)
+    {
+        serverPtr->receivedMidNb++;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+// Internal functions
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Record a UDP datagram sent to or received from a server
+ */
+//--------------------------------------------------------------------------------------------------
+void smanager_RecordDatagram
+(
+    uint16_t securityInstId,        ///< [IN] Security object instance Id of the server
+    const uint8_t* bufferPtr,       ///< [IN] Datagram
+    size_t length,                  ///< [IN] Datagram length
+    bool isDtls,                    ///< [IN] The datagram contains DTLS records
+    bool isSent                     ///< [IN] The datagram is sent to the server
+)
+{
+    ServerMetrics_t* serverPtr = GetServerMetrics(securityInstId);
+    uint32_t recordNb = 0;
+    size_t offset = 0;
+
+    if ((NULL == serverPtr) || (NULL == bufferPtr))
+    {
+        return;
+    }
+
+    if (isDtls)
+    {
+        /* A datagram may contain several records, the record length is in the last two bytes
+         * of the record header */
+        while ((offset + DTLS_RECORD_HEADER_LEN) <= length)
+        {
+            offset += DTLS_RECORD_HEADER_LEN
+                      + (((size_t)bufferPtr[offset + DTLS_RECORD_HEADER_LEN - 2] << 8)
+                         | bufferPtr[offset + DTLS_RECORD_HEADER_LEN - 1]);
+            recordNb++;
+        }
+    }
+
+    if (isSent)
+    {
+        serverPtr->metrics.bytesSent += length;
+        serverPtr->metrics.dtlsRecordSentNb += recordNb;
+    }
+    else
+    {
+        serverPtr->metrics.bytesReceived += length;
+        serverPtr->metrics.dtlsRecordReceivedNb += recordNb;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Record a CoAP message sent to or received from a server
+ */
+//--------------------------------------------------------------------------------------------------
+void smanager_RecordCoapMessage
+(
+    uint16_t securityInstId,        ///< [IN] Security object instance Id of the server
+    const uint8_t* bufferPtr,       ///< [IN] CoAP message
+    size_t length,                  ///< [IN] CoAP message length
+    bool isSent                     ///< [IN] The message is sent to the server
+)
+{
+    ServerMetrics_t* serverPtr;
+    uint8_t type;
+    uint16_t mid;
+
+    if ((NULL == bufferPtr) || (COAP_HEADER_LEN > length))
+    {
+        return;
+    }
+
+    serverPtr = GetServerMetrics(securityInstId);
+    if (NULL == serverPtr)
+    {
+        return;
+    }
+
+    type = (bufferPtr[0] >> 4) & 0x03;
+    mid = (uint16_t)((bufferPtr[2] << 8) | bufferPtr[3]);
+
+    if (isSent)
+    {
+        if (COAP_TYPE_CON == type)
+        {
+            RecordConfirmableSent(serverPtr, mid);
+        }
+    }
+    else if ((COAP_TYPE_ACK == type) || (COAP_TYPE_RST == type))
+    {
+        RecordAcknowledgement(serverPtr, mid);
+    }
+    else
+    {
+        RecordRequest(serverPtr, mid);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Record the start or the end of a DTLS handshake with a server
+ */
+//--------------------------------------------------------------------------------------------------
+void smanager_RecordHandshake
+(
+    uint16_t securityInstId,        ///< [IN] Security object instance Id of the server
+    bool isDone                     ///< [IN] The handshake succeeded
+)
+{
+    ServerMetrics_t* serverPtr = GetServerMetrics(securityInstId);
+    uint64_t nowUs = lwm2mcore_GetTimeUs();
+
+    if (NULL == serverPtr)
+    {
+        return;
+    }
+
+    if (!isDone)
+    {
+        serverPtr->handshakeStartUs = nowUs;
+        return;
+    }
+
+    if (serverPtr->handshakeStartUs)
+    {
+        omanager_AddHistogramSample(&serverPtr->metrics.handshake,
+                                    (nowUs > serverPtr->handshakeStartUs) ?
+                                    (nowUs - serverPtr->handshakeStartUs) : 0);
+        serverPtr->handshakeStartUs = 0;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stop the tracking of the on-going exchanges with a server when its connection is closed
+ */
+//--------------------------------------------------------------------------------------------------
+void smanager_CloseCoapMetrics
+(
+    uint16_t securityInstId         ///< [IN] Security object instance Id of the server
+)
+{
+    uint16_t i;
+
+    for (i = 0; i < ServerMetricsNb; i++)
+    {
+        if (securityInstId == ServerMetrics[i].metrics.securityInstId)
+        {
+            memset(ServerMetrics[i].pending, 0, sizeof(ServerMetrics[i].pending));
+            ServerMetrics[i].receivedMidNb = 0;
+            ServerMetrics[i].receivedMidIdx = 0;
+            ServerMetrics[i].handshakeStartUs = 0;
+            return;
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Count the timeouts of the confirmable messages and send the LWM2MCORE_EVENT_COAP_METRICS event
+ * if its period is elapsed. Called on each LwM2MCore step.
+ */
+//--------------------------------------------------------------------------------------------------
+void smanager_CheckCoapMetrics
+(
+    void
+)
+{
+    uint64_t nowUs = lwm2mcore_GetTimeUs();
+    uint16_t i;
+
+    for (i = 0; i < ServerMetricsNb; i++)
+    {
+        ExpirePendingExchanges(&ServerMetrics[i], nowUs);
+    }
+
+    if ((EventPeriodUs) && (EventPeriodUs <= (nowUs - LastEventTimeUs)))
+    {
+        lwm2mcore_Status_t status;
+
+        LastEventTimeUs = nowUs;
+
+        memset(&status, 0, sizeof(status));
+        status.event = LWM2MCORE_EVENT_COAP_METRICS;
+        status.u.coapMetrics.serverNb = ServerMetricsNb;
+        smanager_SendStatusEvent(status);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public functions
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function to retrieve the CoAP metrics of a server.
+ *
+ * This function has to be called from the LwM2MCore thread, for example on the
+ * LWM2MCORE_EVENT_COAP_METRICS event.
+ *
+ * @return
+ *      - LWM2MCORE_ERR_COMPLETED_OK if the metrics are retrieved
+ *      - LWM2MCORE_ERR_INCORRECT_RANGE if no server has this index: the index of the servers
+ *        with metrics goes from 0 to the number of servers minus 1
+ *      - LWM2MCORE_ERR_INVALID_ARG if a parameter is invalid
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_Sid_t lwm2mcore_GetCoapMetrics
+(
+    uint16_t index,                     ///< [IN] Index of the server
+    lwm2mcore_CoapMetrics_t* metricsPtr ///< [OUT] Server metrics
+)
+{
+    if (NULL == metricsPtr)
+    {
+        return LWM2MCORE_ERR_INVALID_ARG;
+    }
+
+    if (ServerMetricsNb <= index)
+    {
+        return LWM2MCORE_ERR_INCORRECT_RANGE;
+    }
+
+    memcpy(metricsPtr, &ServerMetrics[index].metrics, sizeof(lwm2mcore_CoapMetrics_t));
+    return LWM2MCORE_ERR_COMPLETED_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function to reset the CoAP metrics of all the servers.
+ *
+ * This function has to be called from the LwM2MCore thread.
+ */
+//--------------------------------------------------------------------------------------------------
+void lwm2mcore_ResetCoapMetrics
+(
+    void
+)
+{
+    uint16_t i;
+
+    for (i = 0; i < ServerMetricsNb; i++)
+    {
+        uint16_t securityInstId = ServerMetrics[i].metrics.securityInstId;
+
+        memset(&ServerMetrics[i].metrics, 0, sizeof(lwm2mcore_CoapMetrics_t));
+        ServerMetrics[i].metrics.securityInstId = securityInstId;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function to set the period of the LWM2MCORE_EVENT_COAP_METRICS event.
+ *
+ * The period is checked on each LwM2MCore step, which runs at least every 60 seconds during a
+ * session, or at each wake-up in queue mode: the event can therefore be delayed up to the next
+ * step.
+ */
+//--------------------------------------------------------------------------------------------------
+void lwm2mcore_SetCoapMetricsPeriod
+(
+    uint32_t periodSec                  ///< [IN] Event period in seconds, 0 to disable the event
+)
+{
+    EventPeriodUs = (uint64_t)periodSec * 1000000;
+    LastEventTimeUs = lwm2mcore_GetTimeUs();
+}
@@ -0,0 +1,88 @@
+/**
+ * @file coapMetrics.h
+ *
+ * CoAP transaction metrics of the servers
+ *
+ * The session manager records the UDP datagrams and the CoAP messages exchanged with each server,
+ * identified by its security object instance Id:
+ * - the datagrams are recorded as sent or received on the socket, DTLS records included,
+ * - the CoAP messages are recorded in plain text, before encryption or after decryption.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#ifndef __COAPMETRICS_H__
+#define __COAPMETRICS_H__
+
+#include <lwm2mcore/statistics.h>
+
+/**
+  * @addtogroup lwm2mcore_coapmetrics_int
+  * @{
+  */
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Record a UDP datagram sent to or received from a server
+ */
+//--------------------------------------------------------------------------------------------------
+void smanager_RecordDatagram
+(
+    uint16_t securityInstId,        ///< [IN] Security object instance Id of the server
+    const uint8_t* bufferPtr,       ///< [IN] Datagram
+    size_t length,                  ///< [IN] Datagram length
+    bool isDtls,                    ///< [IN] The datagram contains DTLS records
+    bool isSent                     ///< [IN] The datagram is sent to the server
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Record a CoAP message sent to or received from a server
+ */
+//--------------------------------------------------------------------------------------------------
+void smanager_RecordCoapMessage
+(
+    uint16_t securityInstId,        ///< [IN] Security object instance Id of the server
+    const uint8_t* bufferPtr,       ///< [IN] CoAP message
+    size_t length,                  ///< [IN] CoAP message length
+    bool isSent                     ///< [IN] The message is sent to the server
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Record the start or the end of a DTLS handshake with a server
+ */
+//--------------------------------------------------------------------------------------------------
+void smanager_RecordHandshake
+(
+    uint16_t securityInstId,        ///< [IN] Security object instance Id of the server
+    bool isDone                     ///< [IN] The handshake succeeded
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Stop the tracking of the on-going exchanges with a server when its connection is closed
+ */
+//--------------------------------------------------------------------------------------------------
+void smanager_CloseCoapMetrics
+(
+    uint16_t securityInstId         ///< [IN] Security object instance Id of the server
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Count the timeouts of the confirmable messages and send the
+ * LWM2MCORE_EVENT_COAP_METRICS event if its period is elapsed. Called on each LwM2MCore step.
+ */
+//--------------------------------------------------------------------------------------------------
+void smanager_CheckCoapMetrics
+(
+    void
+);
+
+/**
+  * @}
+  */
+
+#endif /* __COAPMETRICS_H__ */
@@ -26,6 +26,11 @@
 #include "objects.h"
 #include "dtlsConnection.h"
 #include "sessionManager.h"
+#include "coapMetrics.h"
+#include "queueMode.h"
+#include "traceBuffer.h"
+#include "sendBuffer.h"
+#include "coapRequests.h"
 #include "internals.h"
 #include "liblwm2m.h"
 
@@ -163,7 +168,7 @@ static char* SecurityGetPublicId
     {
         char* buffPtr;
 
-        buffPtr = (char*)lwm2m_malloc(dataPtr->value.asBuffer.length);
+        buffPtr = (char*)SMANAGER_DTLS_MALLOC(dataPtr->value.asBuffer.length);
         if (0 != buffPtr)
         {
             memcpy(buffPtr, dataPtr->value.asBuffer.buffer, dataPtr->value.asBuffer.length);
@@ -210,7 +215,7 @@ static char* SecurityGetSecretKey
     {
         char * buffPtr;
 
-        buffPtr = (char*)lwm2m_malloc(dataPtr->value.asBuffer.length);
+        buffPtr = (char*)SMANAGER_DTLS_MALLOC(dataPtr->value.asBuffer.length);
         if (0 != buffPtr)
         {
             memcpy(buffPtr, dataPtr->value.asBuffer.buffer, dataPtr->value.asBuffer.length);
@@ -245,34 +250,12 @@ static int SendData
 {
     int nbSent;
     size_t offset;
-    LOG("SendData");
 
-#ifdef WITH_LOGS
-    char s[INET6_ADDRSTRLEN];
-    in_port_t port = 0;
-
-    s[0] = 0;
-
-    if (AF_INET == connPtr->addr.sin6_family)
-    {
-        struct sockaddr_in *saddrPtr = (struct sockaddr_in *)&connPtr->addr;
-        inet_ntop(saddrPtr->sin_family, &saddrPtr->sin_addr, s, INET6_ADDRSTRLEN);
-        port = saddrPtr->sin_port;
-    }
-    else if (AF_INET6 == connPtr->addr.sin6_family)
-    {
-        struct sockaddr_in6 *saddrPtr = (struct sockaddr_in6 *)&connPtr->addr;
-        inet_ntop(saddrPtr->sin6_family, &saddrPtr->sin6_addr, s, INET6_ADDRSTRLEN);
-        port = saddrPtr->sin6_port;
-    }
-
-    LOG_ARG("Sending %d bytes to [%s]:%hu", length, s, ntohs(port));
-
-#endif
-    if (NULL == connPtr->dtlsSessionPtr)
-    {
-        lwm2mcore_DataDump("Sent bytes in no sec", bufferPtr, length);
-    }
+    smanager_TracePacket(LWM2MCORE_TRACE_DATAGRAM_SENT,
+                         (uint16_t)connPtr->securityInstId,
+                         bufferPtr,
+                         length,
+                         (NULL != connPtr->dtlsSessionPtr) ? LWM2MCORE_TRACE_FLAG_DTLS : 0);
 
     offset = 0;
     while (offset != length)
@@ -290,6 +273,11 @@ static int SendData
         }
         offset += nbSent;
     }
+    smanager_RecordDatagram((uint16_t)connPtr->securityInstId,
+                            bufferPtr,
+                            length,
+                            (NULL != connPtr->dtlsSessionPtr),
+                            true);
     connPtr->lastSend = lwm2m_gettime();
     return 0;
 }
@@ -427,6 +415,24 @@ static int SendToPeer
     return -1;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Give a received CoAP message to LwM2MCore, then to Wakaama if LwM2MCore does not handle it
+ */
+//--------------------------------------------------------------------------------------------------
+static void HandleCoapMessage
+(
+    dtls_Connection_t* connPtr,         ///< [IN] Connection
+    uint8_t* bufferPtr,                 ///< [IN] Received message
+    size_t length                       ///< [IN] Message length
+)
+{
+    if (!omanager_CoapHandleMessage(connPtr->lwm2mHPtr, (void*)connPtr, bufferPtr, length))
+    {
+        lwm2m_handle_packet(connPtr->lwm2mHPtr, bufferPtr, (int)length, (void*)connPtr);
+    }
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * TinyDTLS Callbacks
@@ -451,7 +457,13 @@ static int ReadFromPeer
                                                 sessionPtr->size);
     if (NULL != cnxPtr)
     {
-        lwm2m_handle_packet(cnxPtr->lwm2mHPtr, dataPtr, len, (void*)cnxPtr);
+        smanager_TracePacket(LWM2MCORE_TRACE_COAP_RECEIVED,
+                             (uint16_t)cnxPtr->securityInstId,
+                             dataPtr,
+                             len,
+                             LWM2MCORE_TRACE_FLAG_DTLS);
+        smanager_RecordCoapMessage((uint16_t)cnxPtr->securityInstId, dataPtr, len, false);
+        HandleCoapMessage(cnxPtr, dataPtr, len);
         return 0;
     }
     return -1;
@@ -476,15 +488,21 @@ static int dtlsEventCb
                                     ///< greater indicate internal DTLS session changes.
 )
 {
-    (void)level;
-    (void)sessionPtr;
-    (void)ctxPtr;
+    dtls_Connection_t* cnxPtr = dtls_FindConnection((dtls_Connection_t*) ctxPtr->app,
+                                                &(sessionPtr->addr.st),
+                                                sessionPtr->size);
+
+    smanager_Trace(LWM2MCORE_TRACE_DTLS_EVENT, code, level, 0, 0);
 
     switch (code)
     {
         case DTLS_EVENT_CONNECT:
         case DTLS_EVENT_RENEGOTIATE:
         {
+            if (NULL != cnxPtr)
+            {
+                smanager_RecordHandshake((uint16_t)cnxPtr->securityInstId, false);
+            }
             /* Notify that the device starts an authentication */
             smanager_SendSessionEvent(EVENT_TYPE_AUTHENTICATION, EVENT_STATUS_STARTED);
         }
@@ -492,6 +510,10 @@ static int dtlsEventCb
 
         case DTLS_EVENT_CONNECTED:
         {
+            if (NULL != cnxPtr)
+            {
+                smanager_RecordHandshake((uint16_t)cnxPtr->securityInstId, true);
+            }
             /* Notify that the device authentication succeeds */
             smanager_SendSessionEvent(EVENT_TYPE_AUTHENTICATION, EVENT_STATUS_DONE_SUCCESS);
         }
@@ -705,7 +727,7 @@ dtls_Connection_t* dtls_HandleNewIncoming
 {
     dtls_Connection_t* connPtr;
 
-    connPtr = (dtls_Connection_t*)lwm2m_malloc(sizeof(dtls_Connection_t));
+    connPtr = (dtls_Connection_t*)SMANAGER_DTLS_MALLOC(sizeof(dtls_Connection_t));
     if (NULL != connPtr)
     {
         connPtr->sock = sock;
@@ -713,7 +735,7 @@ dtls_Connection_t* dtls_HandleNewIncoming
         connPtr->addrLen = addrLen;
         connPtr->nextPtr = connListPtr;
 
-        connPtr->dtlsSessionPtr = (session_t*)lwm2m_malloc(sizeof(session_t));
+        connPtr->dtlsSessionPtr = (session_t*)SMANAGER_DTLS_MALLOC(sizeof(session_t));
         if (!(connPtr->dtlsSessionPtr))
         {
            LOG("connPtr->dtlsSessionPtr is NULL");
@@ -728,39 +750,29 @@ dtls_Connection_t* dtls_HandleNewIncoming
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Function to create a new connection to the server
+ * Function to split a server URI in the form "coaps://[host]:[port]" in host and port
+ *
+ * @note The URI buffer is modified: the host string is terminated
  *
  * @return
- *  - DTLS connection pointer (dtls_Connection_t)
- *  - NULL in case of failure
+ *  - true if the URI is valid
+ *  - false in case of failure
  */
 //--------------------------------------------------------------------------------------------------
-dtls_Connection_t* dtls_CreateConnection
+bool dtls_ParseUri
 (
-    dtls_Connection_t* connListPtr,     ///< [IN] DTLS connection structure
-    int sock,                           ///< [IN] Socket Id
-    lwm2m_object_t* securityObjPtr,     ///< [IN] Security object pointer
-    int instanceId,                     ///< [IN] Security object instance Id
-    lwm2m_context_t* lwm2mHPtr,         ///< [IN] Session handle
-    int addressFamily                   ///< [IN] Address familly
+    char* uriPtr,                       ///< [INOUT] Server URI
+    char** hostPtrPtr,                  ///< [OUT] Host
+    char** portPtrPtr                   ///< [OUT] Port
 )
 {
-    int s;
-    struct sockaddr saPtr;
-    socklen_t sl = 0;
-    dtls_Connection_t* connPtr = NULL;
-    char uriBuf[URI_LENGTH];
-    char* uriPtr;
     char* hostPtr;
     char* portPtr;
     const char* defaultPortPtr;
 
-    LOG("Entering");
-
-    uriPtr = SecurityGetUri(securityObjPtr, instanceId, uriBuf, URI_LENGTH);
-    if (NULL == uriPtr)
+    if ((NULL == uriPtr) || (NULL == hostPtrPtr) || (NULL == portPtrPtr))
     {
-        return NULL;
+        return false;
     }
 
     // parse uri in the form "coaps://[host]:[port]"
@@ -777,7 +789,7 @@ dtls_Connection_t* dtls_CreateConnection
     else
     {
         LOG("ERROR in uri");
-        return NULL;
+        return false;
     }
     portPtr = strrchr(hostPtr, ':');
     if (NULL == portPtr)
@@ -794,13 +806,59 @@ dtls_Connection_t* dtls_CreateConnection
             {
                 *(portPtr - 1) = 0;
             }
-            return NULL;
+            return false;
         }
         // split strings
         *portPtr = 0;
         portPtr++;
     }
 
+    *hostPtrPtr = hostPtr;
+    *portPtrPtr = portPtr;
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function to create a new connection to the server
+ *
+ * @return
+ *  - DTLS connection pointer (dtls_Connection_t)
+ *  - NULL in case of failure
+ */
+//--------------------------------------------------------------------------------------------------
+dtls_Connection_t* dtls_CreateConnection
+(
+    dtls_Connection_t* connListPtr,     ///< [IN] DTLS connection structure
+    int sock,                           ///< [IN] Socket Id
+    lwm2m_object_t* securityObjPtr,     ///< [IN] Security object pointer
+    int instanceId,                     ///< [IN] Security object instance Id
+    lwm2m_context_t* lwm2mHPtr,         ///< [IN] Session handle
+    int addressFamily                   ///< [IN] Address familly
+)
+{
+    int s;
+    struct sockaddr saPtr;
+    socklen_t sl = 0;
+    dtls_Connection_t* connPtr = NULL;
+    char uriBuf[URI_LENGTH];
+    char* uriPtr;
+    char* hostPtr;
+    char* portPtr;
+
+    LOG("Entering");
+
+    uriPtr = SecurityGetUri(securityObjPtr, instanceId, uriBuf, URI_LENGTH);
+    if (NULL == uriPtr)
+    {
+        return NULL;
+    }
+
+    if (false == dtls_ParseUri(uriPtr, &hostPtr, &portPtr))
+    {
+        return NULL;
+    }
+
     if (false == lwm2mcore_UdpConnect(uriPtr, hostPtr, portPtr, addressFamily, &saPtr, &sl, &s))
     {
         LOG("Connect failure");
@@ -857,6 +915,7 @@ void dtls_FreeConnection
     while (NULL != connListPtr)
     {
         dtls_Connection_t* nextPtr = connListPtr->nextPtr;
+        smanager_CloseCoapMetrics((uint16_t)connListPtr->securityInstId);
         if (connListPtr->dtlsSessionPtr)
         {
             lwm2m_free(connListPtr->dtlsSessionPtr);
@@ -883,9 +942,15 @@ static int ConnectionSend
     size_t length                       ///< [IN] Buffer length
 )
 {
+    smanager_TracePacket(LWM2MCORE_TRACE_COAP_SENT,
+                         (uint16_t)connPtr->securityInstId,
+                         bufferPtr,
+                         length,
+                         (NULL != connPtr->dtlsSessionPtr) ? LWM2MCORE_TRACE_FLAG_DTLS : 0);
+    smanager_RecordCoapMessage((uint16_t)connPtr->securityInstId, bufferPtr, length, true);
+
     if (NULL == connPtr->dtlsSessionPtr)
     {
-        LOG("ConnectionSend NO SEC");
         // no security
         if ( 0 != SendData(connPtr, bufferPtr, length))
         {
@@ -896,7 +961,6 @@ static int ConnectionSend
     else
     {
         time_t timeFromLastData = lwm2m_gettime() - connPtr->lastSend;
-        LOG_ARG("now - connP->lastSend %d", timeFromLastData);
         if ((0 < DTLS_NAT_TIMEOUT)
          && ((DTLS_NAT_TIMEOUT < timeFromLastData)
             // If difference is negative, a time update could have been made on platform side.
@@ -910,7 +974,6 @@ static int ConnectionSend
                 return -1;
             }
         }
-        LOG_ARG("ConnectionSend SEC length %d", length);
         if (-1 == dtls_write(connPtr->dtlsContextPtr,
                              connPtr->dtlsSessionPtr,
                              bufferPtr,
@@ -941,6 +1004,17 @@ int dtls_HandlePacket
     size_t numBytes                     ///< [IN] Buffer length
 )
 {
+    smanager_TracePacket(LWM2MCORE_TRACE_DATAGRAM_RECEIVED,
+                         (uint16_t)connPtr->securityInstId,
+                         bufferPtr,
+                         numBytes,
+                         (NULL != connPtr->dtlsSessionPtr) ? LWM2MCORE_TRACE_FLAG_DTLS : 0);
+    smanager_RecordDatagram((uint16_t)connPtr->securityInstId,
+                            bufferPtr,
+                            numBytes,
+                            (NULL != connPtr->dtlsSessionPtr),
+                            false);
+
     if (NULL != connPtr->dtlsSessionPtr)
     {
         // Let liblwm2m respond to the query depending on the context
@@ -956,9 +1030,14 @@ int dtls_HandlePacket
     }
     else
     {
-        // no security, just give the plaintext buffer to liblwm2m
-        lwm2mcore_DataDump("received bytes in no sec", bufferPtr, numBytes);
-        lwm2m_handle_packet(connPtr->lwm2mHPtr, bufferPtr, numBytes, (void*)connPtr);
+        // no security, just give the plaintext buffer to LwM2MCore and liblwm2m
+        smanager_TracePacket(LWM2MCORE_TRACE_COAP_RECEIVED,
+                             (uint16_t)connPtr->securityInstId,
+                             bufferPtr,
+                             numBytes,
+                             0);
+        smanager_RecordCoapMessage((uint16_t)connPtr->securityInstId, bufferPtr, numBytes, false);
+        HandleCoapMessage(connPtr, bufferPtr, numBytes);
         return 0;
     }
 }
@@ -1042,6 +1121,12 @@ uint8_t lwm2m_buffer_send
         return COAP_500_INTERNAL_SERVER_ERROR ;
     }
 
+    /* The radio is on: opportunity to send the buffered records */
+    omanager_SendSignalUplink();
+
+    /* Queue mode: the awake time restarts */
+    smanager_QueueSignalActivity();
+
     return COAP_NO_ERROR;
 }
 
@@ -31,6 +31,7 @@
 #include <stdint.h>
 #include <platform/types.h>
 #include <platform/inet.h>
+#include <lwm2mcore/heap.h>
 #include "tinydtls.h"
 #include "dtls.h"
 #include "liblwm2m.h"
@@ -47,6 +48,13 @@
 //--------------------------------------------------------------------------------------------------
 #define DTLS_NAT_TIMEOUT 40
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Allocate memory for the DTLS connections and sessions, to be released by lwm2m_free
+ */
+//--------------------------------------------------------------------------------------------------
+#define SMANAGER_DTLS_MALLOC(size) lwm2mcore_MallocTag((size), LWM2MCORE_HEAP_TAG_TINYDTLS)
+
 //--------------------------------------------------------------------------------------------------
 /**
  * @brief Structure for DTLS connection
@@ -99,6 +107,24 @@ dtls_Connection_t* dtls_HandleNewIncoming
     size_t addrLen                      ///< [IN] Socket address structure length
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Function to split a server URI in the form "coaps://[host]:[port]" in host and port
+ *
+ * @note The URI buffer is modified: the host string is terminated
+ *
+ * @return
+ *  - @c true if the URI is valid
+ *  - @c false in case of failure
+ */
+//--------------------------------------------------------------------------------------------------
+bool dtls_ParseUri
+(
+    char* uriPtr,                       ///< [INOUT] Server URI
+    char** hostPtrPtr,                  ///< [OUT] Host
+    char** portPtrPtr                   ///< [OUT] Port
+);
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Function to create a new connection to the server
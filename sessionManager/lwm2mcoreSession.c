@@ -13,6 +13,7 @@
 #include <lwm2mcore/lwm2mcore.h>
 #include <lwm2mcore/security.h>
 #include <lwm2mcore/coapHandlers.h>
+#include <lwm2mcore/send.h>
 #include <lwm2mcore/timer.h>
 #include <lwm2mcore/udp.h>
 #include <lwm2mcore/update.h>
@@ -22,6 +23,14 @@
 #include "dtlsConnection.h"
 #include "sessionManager.h"
 #include "handlers.h"
+#include "paramCache.h"
+#include "coapMetrics.h"
+#include "traceBuffer.h"
+#include "sendBuffer.h"
+#include "composite.h"
+#include "observe.h"
+#include "coapRequests.h"
+#include "queueMode.h"
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -67,12 +76,49 @@ static bool BootstrapSession = false;
 static lwm2m_client_state_t PreviousState;
 #endif
 
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Startup profile
+ */
+//--------------------------------------------------------------------------------------------------
+static lwm2mcore_StartupProfile_t StartupProfile;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Time of the lwm2mcore_Init call, in microseconds
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t StartupTimeUs;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Time of the next step, in seconds
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t StepTime;
+
 //--------------------------------------------------------------------------------------------------
 /**
  *                      PRIVATE FUNCTIONS
  */
 //--------------------------------------------------------------------------------------------------
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the current time in seconds
+ *
+ * @return
+ *  - Time in seconds
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t GetTime
+(
+    void
+)
+{
+    return (uint32_t)(lwm2mcore_GetTimeUs() / 1000000);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Initialize the LwM2M context object
@@ -86,7 +132,7 @@ static lwm2mcore_context_t* InitContext
     smanager_ClientData_t* dataPtr          ///< [IN] Context
 )
 {
-    dataPtr->lwm2mcoreCtxPtr = (lwm2mcore_context_t*)lwm2m_malloc(sizeof(lwm2mcore_context_t));
+    dataPtr->lwm2mcoreCtxPtr = (lwm2mcore_context_t*)SMANAGER_MALLOC(sizeof(lwm2mcore_context_t));
     LWM2MCORE_ASSERT(dataPtr->lwm2mcoreCtxPtr);
     memset(dataPtr->lwm2mcoreCtxPtr, 0, sizeof(lwm2mcore_context_t));
     return dataPtr->lwm2mcoreCtxPtr;
@@ -134,6 +180,7 @@ void* lwm2m_connect_server
             return NULL;
         }
         dataPtr->connListPtr = newConnPtr;
+        smanager_SetStartupPhase(LWM2MCORE_STARTUP_SERVER_CONNECTED);
     }
 
     return (void *)newConnPtr;
@@ -158,6 +205,8 @@ void lwm2m_close_connection
 
     if ((NULL != appDataPtr) && (NULL != targetPtr))
     {
+        smanager_CloseCoapMetrics((uint16_t)targetPtr->securityInstId);
+
         if (targetPtr == appDataPtr->connListPtr)
         {
             appDataPtr->connListPtr = targetPtr->nextPtr;
@@ -260,13 +309,42 @@ static void Lwm2mClientStepHandler
 )
 {
     int result = 0;
+    uint32_t sendDelay;
+    uint32_t observeDelay;
+    uint32_t wakeUpDelay;
 
     static struct timeval tv;
-    tv.tv_sec = 60;
+    tv.tv_sec = (time_t)smanager_QueueGetStepDelay(60);
     tv.tv_usec = 0;
 
     LOG("Entering");
 
+    /* Queue mode: no message is exchanged while the device sleeps */
+    if (smanager_QueueIsSleeping())
+    {
+        wakeUpDelay = smanager_QueueGetWakeUpDelay();
+        if (0 != wakeUpDelay)
+        {
+            if (false == lwm2mcore_TimerSet(LWM2MCORE_TIMER_STEP, wakeUpDelay,
+                                            Lwm2mClientStepHandler))
+            {
+                LOG("ERROR to launch the step timer");
+            }
+            StepTime = GetTime() + wakeUpDelay;
+            return;
+        }
+
+        /* Wake up: the Registration Update tells the server that the device is reachable, the
+         * held data are sent once it is acknowledged */
+        smanager_QueueWakeUp();
+        if (NULL != DataCtxPtr->lwm2mHPtr->serverList)
+        {
+            lwm2m_update_registration(DataCtxPtr->lwm2mHPtr,
+                                      DataCtxPtr->lwm2mHPtr->serverList->shortID,
+                                      false);
+        }
+    }
+
     /* This function does two things:
      * - first it does the work needed by liblwm2m (eg. (re)sending some packets).
      * - Secondly it adjusts the timeout value (default 60s) depending on the state of the
@@ -290,17 +368,85 @@ static void Lwm2mClientStepHandler
 #endif
     }
 
+    /* Notify the changed values of the composite observations and the resource observations at
+     * the end of their minimum or maximum period, unless they are held until the Registration
+     * Update of a wake-up is acknowledged */
+    if (!smanager_QueueIsHolding())
+    {
+        omanager_CompositeCheck((lwm2mcore_Ref_t)DataCtxPtr);
+
+        omanager_ObserveCheck((lwm2mcore_Ref_t)DataCtxPtr);
+        observeDelay = omanager_ObserveGetDelay();
+        if (observeDelay < (uint32_t)tv.tv_sec)
+        {
+            tv.tv_sec = (time_t)observeDelay;
+        }
+    }
+
+    /* Send the buffered records if a threshold is reached, and wake up for the age threshold or
+     * for the retransmission of the Send message in flight */
+    omanager_SendCheck((lwm2mcore_Ref_t)DataCtxPtr);
+    sendDelay = omanager_SendGetDelay();
+    if (sendDelay < (uint32_t)tv.tv_sec)
+    {
+        tv.tv_sec = (time_t)sendDelay;
+    }
+
+    /* Queue mode: step again at the end of the awake time, or sleep until the next deadline */
+    tv.tv_sec = (time_t)smanager_QueueGetDelay((uint32_t)tv.tv_sec,
+                                               (NULL == DataCtxPtr->lwm2mHPtr->transactionList)
+                                               && (!omanager_SendIsInFlight()));
+
     /* Launch timer step */
     if (false == lwm2mcore_TimerSet(LWM2MCORE_TIMER_STEP, tv.tv_sec, Lwm2mClientStepHandler))
     {
         LOG("ERROR to launch the step timer");
     }
+    StepTime = GetTime() + (uint32_t)tv.tv_sec;
 
     UpdateBootstrapInfo(&PreviousState, DataCtxPtr->lwm2mHPtr);
 
+    smanager_CheckCoapMetrics();
+
     LOG("LwM2M step completed.");
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Get the Device Management server the device is registered to
+ *
+ * @return
+ *      - Server
+ *      - NULL if the device is not registered, or after a disconnection
+ */
+//--------------------------------------------------------------------------------------------------
+static lwm2m_server_t* GetRegisteredServer
+(
+    lwm2mcore_Ref_t instanceRef             ///< [IN] instance reference
+)
+{
+    bool registered = false;
+    smanager_ClientData_t* dataPtr = (smanager_ClientData_t*) instanceRef;
+
+    /* No session after a disconnection */
+    if ((NULL == instanceRef) || (NULL == dataPtr->lwm2mHPtr))
+    {
+        return NULL;
+    }
+
+    /* Check that the device is registered to DM server */
+    if ((!lwm2mcore_ConnectionGetType(instanceRef, &registered)) || (!registered))
+    {
+        return NULL;
+    }
+
+    if (NULL == dataPtr->lwm2mHPtr->serverList)
+    {
+        LOG("serverList is NULL");
+    }
+    return dataPtr->lwm2mHPtr->serverList;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  *  Convert CoAP response code to LwM2M standard error codes
@@ -372,6 +518,84 @@ static uint32_t ConvertToCoapCode
     return coapCode;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function to record the time of a startup phase. Only the first occurrence of the phase since the
+ * lwm2mcore_Init call is recorded.
+ */
+//--------------------------------------------------------------------------------------------------
+void smanager_SetStartupPhase
+(
+    lwm2mcore_StartupPhase_t phase      ///< [IN] Startup phase
+)
+{
+    if ((LWM2MCORE_STARTUP_PHASE_MAX <= phase) || (StartupProfile.phaseMask & (1 << phase)))
+    {
+        return;
+    }
+
+    StartupProfile.elapsedUs[phase] = lwm2mcore_GetTimeUs() - StartupTimeUs;
+    StartupProfile.phaseMask |= (1 << phase);
+    LOG_ARG("Startup phase %d reached after %llu us",
+            phase, (unsigned long long)StartupProfile.elapsedUs[phase]);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function to prepare the connection to the server while the objects are registered: the
+ * credentials of the server to be contacted are loaded and the resolution of its address is
+ * started, so that lwm2mcore_UdpConnect and the DTLS handshake don't wait for them.
+ */
+//--------------------------------------------------------------------------------------------------
+void smanager_PrepareConnection
+(
+    void
+)
+{
+    char uri[LWM2MCORE_SERVERADDR_LEN + 1];
+    size_t uriLen = sizeof(uri) - 1;
+    lwm2mcore_Credentials_t credId;
+    char* hostPtr;
+    char* portPtr;
+
+    // The credentials status reads the address and PSK of the servers
+    switch (lwm2mcore_GetCredentialStatus())
+    {
+        case LWM2MCORE_DM_CREDENTIAL_PROVISIONED:
+            credId = LWM2MCORE_CREDENTIAL_DM_ADDRESS;
+            break;
+
+        case LWM2MCORE_BS_CREDENTIAL_PROVISIONED:
+            credId = LWM2MCORE_CREDENTIAL_BS_ADDRESS;
+            break;
+
+        default:
+            LOG("No credentials to prepare the connection");
+            return;
+    }
+
+    memset(uri, 0, sizeof(uri));
+    if (LWM2MCORE_ERR_COMPLETED_OK != lwm2mcore_GetCredential(credId,
+                                                              LWM2MCORE_BS_SERVER_ID,
+                                                              uri,
+                                                              &uriLen))
+    {
+        LOG("Unable to read the server address");
+        return;
+    }
+    uri[uriLen] = '\0';
+
+    if (!dtls_ParseUri(uri, &hostPtr, &portPtr))
+    {
+        return;
+    }
+
+    if (!lwm2mcore_UdpResolve(hostPtr, portPtr))
+    {
+        LOG("Server address resolution not started");
+    }
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Function to send status event to the application, using the callback stored in the LwM2MCore
@@ -383,6 +607,8 @@ void smanager_SendStatusEvent
     lwm2mcore_Status_t status
 )
 {
+    smanager_Trace(LWM2MCORE_TRACE_STATUS_EVENT, status.event, 0, 0, 0);
+
     // Check if a status callback is available
     if (!StatusCb)
     {
@@ -407,6 +633,8 @@ void smanager_SendSessionEvent
 {
     lwm2mcore_Status_t status;
 
+    smanager_Trace(LWM2MCORE_TRACE_SESSION_EVENT, eventId, eventstatus, 0, 0);
+
     switch (eventId)
     {
         case EVENT_TYPE_BOOTSTRAP:
@@ -455,6 +683,8 @@ void smanager_SendSessionEvent
                 case EVENT_STATUS_DONE_SUCCESS:
                 {
                     LOG("REGISTER DONE");
+                    smanager_SetStartupPhase(LWM2MCORE_STARTUP_REGISTERED);
+                    smanager_QueueSignalRegistration(omanager_IsQueueModeBinding());
 
                     status.event = LWM2MCORE_EVENT_SESSION_STARTED;
                     smanager_SendStatusEvent(status);
@@ -502,6 +732,7 @@ void smanager_SendSessionEvent
                 case EVENT_STATUS_DONE_SUCCESS:
                 {
                     LOG("REG UPDATE DONE");
+                    smanager_QueueSignalRegistration(omanager_IsQueueModeBinding());
                 }
                 break;
 
@@ -568,6 +799,7 @@ void smanager_SendSessionEvent
                 case EVENT_STATUS_DONE_SUCCESS:
                 {
                     LOG("AUTHENTICATION DONE");
+                    smanager_SetStartupPhase(LWM2MCORE_STARTUP_AUTHENTICATED);
 
                     if (BootstrapSession)
                     {
@@ -703,9 +935,28 @@ void lwm2mcore_UdpReceiveCb
         return;
     }
 
+    // Queue mode: the awake time restarts
+    smanager_QueueSignalActivity();
+
     // Let liblwm2m respond to the query depending on the context
     LOG("Handling packet");
     rc = dtls_HandlePacket(connPtr, bufferPtr, (size_t)len);
+
+    // End of the request: write the parameters updated by the server in platform memory
+    omanager_FlushParams();
+
+    // Queue mode: send in one burst the data held until the Registration Update of the wake-up
+    // is acknowledged
+    if (smanager_QueueTakeBurst())
+    {
+        omanager_CompositeCheck(config.instanceRef);
+        omanager_ObserveCheck(config.instanceRef);
+        lwm2mcore_SendFlush(config.instanceRef);
+    }
+
+    // Send the buffered records if a threshold is reached or if a Send message was acknowledged
+    omanager_SendCheck(config.instanceRef);
+
     if (rc)
     {
         LOG_ARG("Failed to handle DTLS packet %d.", rc);
@@ -756,6 +1007,9 @@ bool omanager_UpdateRequest
         LOG_ARG("lwm2m_update_registration return %d", iresult);
         if (!iresult)
         {
+            /* A sleeping device wakes up with this Registration Update */
+            smanager_QueueWakeUp();
+
             /* Stop the timer and launch it */
             if (false == lwm2mcore_TimerStop(LWM2MCORE_TIMER_STEP) )
             {
@@ -772,6 +1026,7 @@ bool omanager_UpdateRequest
             }
             else
             {
+                StepTime = GetTime() + 1;
                 result = true;
             }
         }
@@ -811,7 +1066,15 @@ lwm2mcore_Ref_t lwm2mcore_Init
     }
 
     StatusCb = eventCb;
-    dataPtr = (smanager_ClientData_t*)lwm2m_malloc(sizeof(smanager_ClientData_t));
+
+    memset(&StartupProfile, 0, sizeof(StartupProfile));
+    StartupTimeUs = lwm2mcore_GetTimeUs();
+    smanager_SetStartupPhase(LWM2MCORE_STARTUP_INIT);
+
+    /* The parameters may have been updated in platform memory since the last use */
+    omanager_ClearParamCache();
+
+    dataPtr = (smanager_ClientData_t*)SMANAGER_MALLOC(sizeof(smanager_ClientData_t));
     LWM2MCORE_ASSERT(dataPtr);
     memset(dataPtr, 0, sizeof(smanager_ClientData_t));
 
@@ -847,6 +1110,11 @@ void lwm2mcore_Free
         /* Free objects */
         omanager_ObjectsFree();
         omanager_FreeBootstrapInformation();
+        omanager_ClearParamCache();
+        omanager_SendFree();
+        omanager_CompositeReset();
+        omanager_ObserveReset();
+        smanager_QueueStop();
 
         if (NULL != dataPtr->lwm2mcoreCtxPtr)
         {
@@ -892,16 +1160,17 @@ bool lwm2mcore_Connect
 
     LOG_ARG("lwm2mcore_connect -> socket %d opened ", SocketConfig.sock);
 
+    smanager_SetStartupPhase(LWM2MCORE_STARTUP_SOCKET_OPENED);
+
     dataPtr = (smanager_ClientData_t*)instanceRef;
     dataPtr->sock = SocketConfig.sock;
     dataPtr->addressFamily = SocketConfig.af;
 
-    /* Initialize the lwm2m client step timer */
+    /* Run the 1st lwm2m client step now instead of waiting for the step timer: the step
+     * handler launches the step timer for the next one
+     */
     DataCtxPtr = dataPtr;
-    if (!lwm2mcore_TimerSet(LWM2MCORE_TIMER_STEP, 1, Lwm2mClientStepHandler))
-    {
-        LOG("Failed to launch the 1st step timer");
-    }
+    Lwm2mClientStepHandler();
 
     LOG("LWM2M Client started");
 
@@ -954,6 +1223,19 @@ bool lwm2mcore_Disconnect
     LOG("Suspend Download");
     lwm2mcore_SuspendPackageDownload();
 
+    /* Write the pending parameters in platform memory */
+    omanager_FlushParams();
+
+    /* The Send message in flight is lost with the session */
+    omanager_SendAbort();
+
+    /* The observations are lost with the session */
+    omanager_CompositeReset();
+    omanager_ObserveReset();
+
+    /* The queue mode starts again with the next registration */
+    smanager_QueueStop();
+
     /* Stop the current timers */
     if (!lwm2mcore_TimerStop(LWM2MCORE_TIMER_STEP))
     {
@@ -984,6 +1266,30 @@ bool lwm2mcore_Disconnect
     return true;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function to retrieve the startup profile, i.e. the time of the startup phases reached since the
+ * last lwm2mcore_Init call
+ *
+ * @return
+ *      - true if the profile is retrieved
+ *      - else false
+ */
+//--------------------------------------------------------------------------------------------------
+bool lwm2mcore_GetStartupProfile
+(
+    lwm2mcore_StartupProfile_t* profilePtr  ///< [OUT] Startup profile
+)
+{
+    if (!profilePtr)
+    {
+        return false;
+    }
+
+    memcpy(profilePtr, &StartupProfile, sizeof(lwm2mcore_StartupProfile_t));
+    return true;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Function to retrieve the status and the type of the current connection
@@ -1115,6 +1421,142 @@ lwm2mcore_PushResult_t lwm2mcore_Push
     return result;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function to send a notification of an observation to the Device Management server which
+ * registered it, see omanager_CoapNotify
+ *
+ * @return
+ *      - true if the notification is sent
+ *      - false otherwise
+ */
+//--------------------------------------------------------------------------------------------------
+bool smanager_Notify
+(
+    lwm2mcore_Ref_t instanceRef,            ///< [IN] instance reference
+    uint16_t shortServerId,                 ///< [IN] short server Id of the observing server
+    uint8_t* tokenPtr,                      ///< [IN] token of the observation
+    uint8_t tokenLength,                    ///< [IN] token length
+    uint16_t contentType,                   ///< [IN] content type
+    uint8_t* payloadPtr,                    ///< [IN] payload
+    size_t payloadLength                    ///< [IN] payload length
+)
+{
+    lwm2m_server_t* targetPtr = GetRegisteredServer(instanceRef);
+
+    while ((NULL != targetPtr) && (shortServerId != targetPtr->shortID))
+    {
+        targetPtr = targetPtr->next;
+    }
+
+    if (NULL == targetPtr)
+    {
+        LOG_ARG("No server with the short server Id %d", shortServerId);
+        return false;
+    }
+
+    /* The notification carries the token of the observation and the Observe option */
+    return omanager_CoapNotify(((smanager_ClientData_t*)instanceRef)->lwm2mHPtr,
+                               targetPtr->sessionH,
+                               tokenPtr,
+                               tokenLength,
+                               contentType,
+                               payloadPtr,
+                               payloadLength);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function to send a request of the LwM2M 1.1 Send operation to the Device Management server, see
+ * omanager_CoapSend
+ *
+ * @return
+ *      - true if the request is sent
+ *      - false otherwise
+ */
+//--------------------------------------------------------------------------------------------------
+bool smanager_Send
+(
+    lwm2mcore_Ref_t instanceRef,            ///< [IN] instance reference
+    uint16_t contentType,                   ///< [IN] content type
+    uint8_t* payloadPtr,                    ///< [IN] payload
+    size_t payloadLength,                   ///< [IN] payload length
+    uint16_t* midPtr                        ///< [OUT] message id
+)
+{
+    lwm2m_server_t* targetPtr = GetRegisteredServer(instanceRef);
+
+    if (NULL == targetPtr)
+    {
+        return false;
+    }
+
+    return omanager_CoapSend(((smanager_ClientData_t*)instanceRef)->lwm2mHPtr,
+                             targetPtr->sessionH,
+                             contentType,
+                             payloadPtr,
+                             payloadLength,
+                             midPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function to retransmit the request of the LwM2M 1.1 Send operation in flight, see
+ * omanager_CoapSendAgain
+ *
+ * @return
+ *      - true if the request is sent again
+ *      - false otherwise
+ */
+//--------------------------------------------------------------------------------------------------
+bool smanager_SendAgain
+(
+    lwm2mcore_Ref_t instanceRef             ///< [IN] instance reference
+)
+{
+    lwm2m_server_t* targetPtr = GetRegisteredServer(instanceRef);
+
+    if (NULL == targetPtr)
+    {
+        return false;
+    }
+
+    return omanager_CoapSendAgain(((smanager_ClientData_t*)instanceRef)->lwm2mHPtr,
+                                  targetPtr->sessionH);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function to run the LwM2M step earlier than scheduled, for a deadline set outside of the step.
+ * Nothing is done if the step is already scheduled before this delay.
+ */
+//--------------------------------------------------------------------------------------------------
+void smanager_ScheduleStep
+(
+    uint32_t delay                          ///< [IN] Delay of the step in seconds
+)
+{
+    uint32_t now = GetTime();
+
+    /* No session, or the step is already scheduled before */
+    if ((!lwm2mcore_TimerIsRunning(LWM2MCORE_TIMER_STEP)) || ((now + delay) >= StepTime))
+    {
+        return;
+    }
+
+    if (false == lwm2mcore_TimerStop(LWM2MCORE_TIMER_STEP))
+    {
+        LOG("Error to stop the step timer");
+    }
+
+    if (false == lwm2mcore_TimerSet(LWM2MCORE_TIMER_STEP, delay, Lwm2mClientStepHandler))
+    {
+        LOG("ERROR to launch the step timer");
+        return;
+    }
+    StepTime = now + delay;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Function to send an asynchronous response to server.
@@ -0,0 +1,500 @@
+/**
+ * @file queueMode.c
+ *
+ * Queue mode scheduler, see lwm2mcore/queueMode.h and queueMode.h
+ *
+ * The scheduler has three states: awake, waking up (a Registration Update is sent, the data are
+ * held until it is acknowledged) and sleeping. The times are monotonic times in seconds: the
+ * awake and sleep times are accumulated on each state change.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <lwm2mcore/lwm2mcore.h>
+#include <lwm2mcore/queueMode.h>
+#include <lwm2mcore/timer.h>
+#include "queueMode.h"
+#include "internals.h"
+#include "liblwm2m.h"
+
+//--------------------------------------------------------------------------------------------------
+// Symbol and Enum definitions
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Longest step delay in queue mode without maximum sleep time, in seconds: the LwM2M engine
+ * reduces it to its next deadline, at least the Registration Update
+ */
+//--------------------------------------------------------------------------------------------------
+#define QUEUE_STEP_MAX_DELAY        86400
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * States of the device in queue mode
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    QUEUE_STATE_AWAKE = 0,          ///< The data are sent
+    QUEUE_STATE_WAKING_UP,          ///< A Registration Update is sent, the data are held
+    QUEUE_STATE_SLEEPING            ///< The data are held until the wake-up time
+}QueueState_t;
+
+//--------------------------------------------------------------------------------------------------
+// Static variables
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Configuration, the queue mode is disabled if the awake time is 0
+ */
+//--------------------------------------------------------------------------------------------------
+static lwm2mcore_QueueModeConfig_t Config;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The queue mode is active: configured and accepted by the server binding
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsActive = false;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Current state
+ */
+//--------------------------------------------------------------------------------------------------
+static QueueState_t State = QUEUE_STATE_AWAKE;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Time of the last state change
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t StateTime = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Time of the last message exchanged with the server
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t ActivityTime = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Wake-up time of the sleeping device
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t WakeUpTime = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The held data have to be sent
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsBurstPending = false;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Statistics
+ */
+//--------------------------------------------------------------------------------------------------
+static lwm2mcore_QueueModeStats_t Stats;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *                      PRIVATE FUNCTIONS
+ */
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the monotonic time in seconds
+ *
+ * @return
+ *      - Monotonic time in seconds
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t GetTime
+(
+    void
+)
+{
+    return (uint32_t)(lwm2mcore_GetTimeUs() / 1000000);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Change the state and accumulate the time spent in the previous state
+ */
+//--------------------------------------------------------------------------------------------------
+static void SetState
+(
+    QueueState_t state,             ///< [IN] New state
+    uint32_t now                    ///< [IN] Current time
+)
+{
+    if (QUEUE_STATE_SLEEPING == State)
+    {
+        Stats.sleepTime += now - StateTime;
+    }
+    else
+    {
+        Stats.awakeTime += now - StateTime;
+    }
+
+    State = state;
+    StateTime = now;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *                      PUBLIC FUNCTIONS
+ */
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function to configure the queue mode.
+ *
+ * @return
+ *      - LWM2MCORE_ERR_COMPLETED_OK if the configuration is applied
+ *      - LWM2MCORE_ERR_INVALID_ARG if the configuration is invalid
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_Sid_t lwm2mcore_QueueModeConfigure
+(
+    const lwm2mcore_QueueModeConfig_t* configPtr    ///< [IN] Configuration, NULL to disable the
+                                                    ///<      queue mode
+)
+{
+    if ((NULL != configPtr) && (0 == configPtr->awakeTime))
+    {
+        return LWM2MCORE_ERR_INVALID_ARG;
+    }
+
+    if (NULL == configPtr)
+    {
+        smanager_QueueStop();
+        memset(&Config, 0, sizeof(Config));
+        return LWM2MCORE_ERR_COMPLETED_OK;
+    }
+
+    memcpy(&Config, configPtr, sizeof(Config));
+    return LWM2MCORE_ERR_COMPLETED_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function to retrieve the statistics of the queue mode
+ *
+ * @return
+ *      - LWM2MCORE_ERR_COMPLETED_OK if the statistics are retrieved
+ *      - LWM2MCORE_ERR_INVALID_ARG if a parameter is invalid
+ */
+//--------------------------------------------------------------------------------------------------
+lwm2mcore_Sid_t lwm2mcore_GetQueueModeStats
+(
+    lwm2mcore_QueueModeStats_t* statsPtr    ///< [OUT] Queue mode statistics
+)
+{
+    if (NULL == statsPtr)
+    {
+        return LWM2MCORE_ERR_INVALID_ARG;
+    }
+
+    /* Count the time spent in the current state */
+    if (IsActive)
+    {
+        SetState(State, GetTime());
+    }
+
+    memcpy(statsPtr, &Stats, sizeof(lwm2mcore_QueueModeStats_t));
+    statsPtr->isSleeping = smanager_QueueIsSleeping();
+
+    return LWM2MCORE_ERR_COMPLETED_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function to reset the statistics of the queue mode
+ */
+//--------------------------------------------------------------------------------------------------
+void lwm2mcore_ResetQueueModeStats
+(
+    void
+)
+{
+    memset(&Stats, 0, sizeof(Stats));
+    StateTime = GetTime();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Signal that the registration or a Registration Update is acknowledged by the server
+ */
+//--------------------------------------------------------------------------------------------------
+void smanager_QueueSignalRegistration
+(
+    bool isQueueBinding             ///< [IN] The server binding is UDP with queue mode
+)
+{
+    uint32_t now = GetTime();
+
+    if ((0 == Config.awakeTime) || (!isQueueBinding))
+    {
+        smanager_QueueStop();
+        return;
+    }
+
+    if (!IsActive)
+    {
+        LOG("Queue mode started");
+        IsActive = true;
+        State = QUEUE_STATE_AWAKE;
+        StateTime = now;
+    }
+    else if (QUEUE_STATE_WAKING_UP == State)
+    {
+        IsBurstPending = true;
+        Stats.burstNb++;
+    }
+
+    SetState(QUEUE_STATE_AWAKE, now);
+    ActivityTime = now;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stop the queue mode, when the session is closed
+ */
+//--------------------------------------------------------------------------------------------------
+void smanager_QueueStop
+(
+    void
+)
+{
+    if (IsActive)
+    {
+        SetState(QUEUE_STATE_AWAKE, GetTime());
+        LOG("Queue mode stopped");
+    }
+
+    IsActive = false;
+    IsBurstPending = false;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Signal that a message is sent to or received from the server
+ */
+//--------------------------------------------------------------------------------------------------
+void smanager_QueueSignalActivity
+(
+    void
+)
+{
+    ActivityTime = GetTime();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if the device is sleeping
+ *
+ * @return
+ *      - true if the device is sleeping
+ *      - false otherwise
+ */
+//--------------------------------------------------------------------------------------------------
+bool smanager_QueueIsSleeping
+(
+    void
+)
+{
+    return (IsActive && (QUEUE_STATE_SLEEPING == State));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if the data sent by LwM2MCore on its own initiative are held
+ *
+ * @return
+ *      - true if the data are held
+ *      - false otherwise
+ */
+//--------------------------------------------------------------------------------------------------
+bool smanager_QueueIsHolding
+(
+    void
+)
+{
+    return (IsActive && (QUEUE_STATE_AWAKE != State));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if a Send message is held, and count it in the statistics
+ *
+ * @return
+ *      - true if the message is held
+ *      - false otherwise
+ */
+//--------------------------------------------------------------------------------------------------
+bool smanager_QueueHoldSend
+(
+    void
+)
+{
+    if (!smanager_QueueIsHolding())
+    {
+        return false;
+    }
+
+    Stats.heldNb++;
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Signal that a Registration Update is sent
+ */
+//--------------------------------------------------------------------------------------------------
+void smanager_QueueWakeUp
+(
+    void
+)
+{
+    uint32_t now = GetTime();
+
+    if (!IsActive)
+    {
+        return;
+    }
+
+    if (QUEUE_STATE_SLEEPING == State)
+    {
+        LOG("Queue mode wake-up");
+        Stats.wakeUpNb++;
+    }
+
+    SetState(QUEUE_STATE_WAKING_UP, now);
+    ActivityTime = now;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if the held data have to be sent
+ *
+ * @return
+ *      - true if the held data have to be sent
+ *      - false otherwise
+ */
+//--------------------------------------------------------------------------------------------------
+bool smanager_QueueTakeBurst
+(
+    void
+)
+{
+    bool isBurstPending = IsBurstPending;
+
+    IsBurstPending = false;
+    return isBurstPending;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the longest delay of the next step
+ *
+ * @return
+ *      - Delay in seconds
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t smanager_QueueGetStepDelay
+(
+    uint32_t defaultDelay           ///< [IN] Default delay of the step in seconds
+)
+{
+    if (!IsActive)
+    {
+        return defaultDelay;
+    }
+
+    return (Config.maxSleepTime ? Config.maxSleepTime : QUEUE_STEP_MAX_DELAY);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the delay of the next step, at the end of a step
+ *
+ * @return
+ *      - Delay in seconds
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t smanager_QueueGetDelay
+(
+    uint32_t stepDelay,             ///< [IN] Delay until the next deadline of the step, in seconds
+    bool isIdle                     ///< [IN] No transaction is on-going
+)
+{
+    uint32_t now;
+    uint32_t awakeDelay;
+
+    if ((!IsActive) || (QUEUE_STATE_SLEEPING == State))
+    {
+        return stepDelay;
+    }
+
+    now = GetTime();
+    awakeDelay = now - ActivityTime;
+    if (awakeDelay < Config.awakeTime)
+    {
+        /* Step again at the end of the awake time to go to sleep */
+        awakeDelay = Config.awakeTime - awakeDelay;
+        return ((awakeDelay < stepDelay) ? awakeDelay : stepDelay);
+    }
+
+    if (!isIdle)
+    {
+        return stepDelay;
+    }
+
+    /* The data held by a failed wake-up are kept for the next one */
+    if ((0 != Config.maxSleepTime) && (Config.maxSleepTime < stepDelay))
+    {
+        stepDelay = Config.maxSleepTime;
+    }
+
+    LOG_ARG("Queue mode sleep for %u seconds", stepDelay);
+    SetState(QUEUE_STATE_SLEEPING, now);
+    WakeUpTime = now + stepDelay;
+    IsBurstPending = false;
+
+    return stepDelay;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the delay until the wake-up of a sleeping device
+ *
+ * @return
+ *      - Delay in seconds, 0 if the device has to wake up
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t smanager_QueueGetWakeUpDelay
+(
+    void
+)
+{
+    uint32_t now = GetTime();
+
+    if ((!smanager_QueueIsSleeping()) || ((int32_t)(WakeUpTime - now) <= 0))
+    {
+        return 0;
+    }
+
+    return WakeUpTime - now;
+}
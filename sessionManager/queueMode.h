@@ -0,0 +1,172 @@
+/**
+ * @file queueMode.h
+ *
+ * Queue mode scheduler, see lwm2mcore/queueMode.h
+ *
+ * The session manager drives the scheduler from the LwM2M step: the scheduler decides when the
+ * device goes to sleep and when it wakes up, and tells whether the data sent by LwM2MCore on its
+ * own initiative must be held.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#ifndef __QUEUEMODE_H__
+#define __QUEUEMODE_H__
+
+#include <lwm2mcore/queueMode.h>
+
+/**
+  * @addtogroup lwm2mcore_queuemode_int
+  * @{
+  */
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Signal that the registration or a Registration Update is acknowledged by the server: the
+ * queue mode is active if it is configured and if the server binding is UDP with queue mode. The
+ * data held during a wake-up are then sent in one burst (see smanager_QueueTakeBurst).
+ */
+//--------------------------------------------------------------------------------------------------
+void smanager_QueueSignalRegistration
+(
+    bool isQueueBinding             ///< [IN] The server binding is UDP with queue mode
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Stop the queue mode, when the session is closed
+ */
+//--------------------------------------------------------------------------------------------------
+void smanager_QueueStop
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Signal that a message is sent to or received from the server: the awake time restarts
+ */
+//--------------------------------------------------------------------------------------------------
+void smanager_QueueSignalActivity
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Check if the device is sleeping
+ *
+ * @return
+ *      - true if the device is sleeping
+ *      - false otherwise
+ */
+//--------------------------------------------------------------------------------------------------
+bool smanager_QueueIsSleeping
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Check if the data sent by LwM2MCore on its own initiative are held: the device is
+ * sleeping or waiting for the acknowledgement of the Registration Update of its wake-up
+ *
+ * @return
+ *      - true if the data are held
+ *      - false otherwise
+ */
+//--------------------------------------------------------------------------------------------------
+bool smanager_QueueIsHolding
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Check if a Send message is held, and count it in the statistics
+ *
+ * @return
+ *      - true if the message is held
+ *      - false otherwise
+ */
+//--------------------------------------------------------------------------------------------------
+bool smanager_QueueHoldSend
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Signal that a Registration Update is sent: a sleeping device wakes up and holds its data
+ * until the update is acknowledged
+ */
+//--------------------------------------------------------------------------------------------------
+void smanager_QueueWakeUp
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Check if the held data have to be sent, once the Registration Update of a wake-up is
+ * acknowledged. The burst is only reported once.
+ *
+ * @return
+ *      - true if the held data have to be sent
+ *      - false otherwise
+ */
+//--------------------------------------------------------------------------------------------------
+bool smanager_QueueTakeBurst
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Get the longest delay of the next step, before the LwM2M engine reduces it to its next
+ * deadline
+ *
+ * @return
+ *      - Delay in seconds: the default delay if the queue mode is not active
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t smanager_QueueGetStepDelay
+(
+    uint32_t defaultDelay           ///< [IN] Default delay of the step in seconds
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Get the delay of the next step, at the end of a step. The device goes to sleep if the
+ * awake time is elapsed since the last message exchanged with the server and if no transaction is
+ * on-going: it then wakes up after the step delay or the maximum sleep time.
+ *
+ * @return
+ *      - Delay in seconds
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t smanager_QueueGetDelay
+(
+    uint32_t stepDelay,             ///< [IN] Delay until the next deadline of the step, in seconds
+    bool isIdle                     ///< [IN] No transaction is on-going
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Get the delay until the wake-up of a sleeping device
+ *
+ * @return
+ *      - Delay in seconds, 0 if the device has to wake up
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t smanager_QueueGetWakeUpDelay
+(
+    void
+);
+
+/**
+  * @}
+  */
+
+#endif /* __QUEUEMODE_H__ */
@@ -13,6 +13,7 @@
 
 #include <lwm2mcore/lwm2mcore.h>
 #include <lwm2mcore/coapHandlers.h>
+#include <lwm2mcore/heap.h>
 #include "objects.h"
 #include "dtlsConnection.h"
 
@@ -21,6 +22,13 @@
   * @{
   */
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Allocate memory owned by the session manager, to be released by lwm2m_free
+ */
+//--------------------------------------------------------------------------------------------------
+#define SMANAGER_MALLOC(size) lwm2mcore_MallocTag((size), LWM2MCORE_HEAP_TAG_SESSION_MANAGER)
+
 //--------------------------------------------------------------------------------------------------
 /**
  * @brief Structure for LWM2M core context
@@ -100,6 +108,29 @@ void smanager_SendSessionEvent
     smanager_EventStatus_t status     ///< [IN] Event status
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Function to record the time of a startup phase. Only the first occurrence of the phase
+ * since the lwm2mcore_Init call is recorded.
+ */
+//--------------------------------------------------------------------------------------------------
+void smanager_SetStartupPhase
+(
+    lwm2mcore_StartupPhase_t phase      ///< [IN] Startup phase
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Function to prepare the connection to the server while the objects are registered: the
+ * credentials of the server to be contacted are loaded and the resolution of its address is
+ * started.
+ */
+//--------------------------------------------------------------------------------------------------
+void smanager_PrepareConnection
+(
+    void
+);
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Function to check if the client is connected to a bootstrap server
@@ -113,6 +144,73 @@ bool smanager_IsBootstrapConnection
 (
     void
 );
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Function to send a request of the LwM2M 1.1 Send operation to the Device Management
+ * server, see omanager_CoapSend
+ *
+ * @return
+ *      - true if the request is sent
+ *      - false otherwise
+ */
+//--------------------------------------------------------------------------------------------------
+bool smanager_Send
+(
+    lwm2mcore_Ref_t instanceRef,            ///< [IN] instance reference
+    uint16_t contentType,                   ///< [IN] content type
+    uint8_t* payloadPtr,                    ///< [IN] payload
+    size_t payloadLength,                   ///< [IN] payload length
+    uint16_t* midPtr                        ///< [OUT] message id
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Function to retransmit the request of the LwM2M 1.1 Send operation in flight, see
+ * omanager_CoapSendAgain
+ *
+ * @return
+ *      - true if the request is sent again
+ *      - false otherwise
+ */
+//--------------------------------------------------------------------------------------------------
+bool smanager_SendAgain
+(
+    lwm2mcore_Ref_t instanceRef             ///< [IN] instance reference
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Function to send a notification of an observation to the Device Management server which
+ * registered it, see omanager_CoapNotify
+ *
+ * @return
+ *      - true if the notification is sent
+ *      - false otherwise
+ */
+//--------------------------------------------------------------------------------------------------
+bool smanager_Notify
+(
+    lwm2mcore_Ref_t instanceRef,            ///< [IN] instance reference
+    uint16_t shortServerId,                 ///< [IN] short server Id of the observing server
+    uint8_t* tokenPtr,                      ///< [IN] token of the observation
+    uint8_t tokenLength,                    ///< [IN] token length
+    uint16_t contentType,                   ///< [IN] content type
+    uint8_t* payloadPtr,                    ///< [IN] payload
+    size_t payloadLength                    ///< [IN] payload length
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Function to run the LwM2M step earlier than scheduled, for a deadline set outside of the
+ * step. Nothing is done if the step is already scheduled before this delay.
+ */
+//--------------------------------------------------------------------------------------------------
+void smanager_ScheduleStep
+(
+    uint32_t delay                          ///< [IN] Delay of the step in seconds
+);
+
 /**
   * @}
   */
@@ -0,0 +1,402 @@
+/**
+ * @file traceBuffer.c
+ *
+ * Binary trace ring buffer of LwM2MCore, see traceBuffer.h
+ *
+ * The writers reserve consecutive sequence numbers with an atomic addition: the record of the
+ * sequence number n is stored in the slot n modulo the ring size. The sequence number of a slot is
+ * written with the BUSY_SEQ_FLAG toggled while the record is filled, then committed once the
+ * record is complete: as the ring size is lower than BUSY_SEQ_FLAG, a reader never expects a
+ * sequence number with this flag toggled. A reader copies a record and checks that the slot
+ * sequence number was not modified during the copy, so that a record overwritten by a writer is
+ * detected and skipped.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <platform/types.h>
+#include <lwm2mcore/lwm2mcore.h>
+#include <lwm2mcore/timer.h>
+#include <lwm2mcore/trace.h>
+#include "traceBuffer.h"
+#include "sessionManager.h"
+#include "internals.h"
+#include "liblwm2m.h"
+
+//--------------------------------------------------------------------------------------------------
+// Symbol and Enum definitions
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Flag toggled in the sequence number of a slot which is being written
+ */
+//--------------------------------------------------------------------------------------------------
+#define BUSY_SEQ_FLAG               0x80000000
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of payload bytes in a record
+ */
+//--------------------------------------------------------------------------------------------------
+#define PAYLOAD_RECORD_LEN          (LWM2MCORE_TRACE_ARG_NB * sizeof(uint32_t))
+
+//--------------------------------------------------------------------------------------------------
+// Static variables
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Ring buffer, NULL if the trace is disabled
+ */
+//--------------------------------------------------------------------------------------------------
+static lwm2mcore_TraceRecord_t* RingPtr;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of records of the ring buffer minus 1
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t RingMask;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Next sequence number to be reserved by a writer
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t WriteSeq;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of bytes captured per packet
+ */
+//--------------------------------------------------------------------------------------------------
+static uint16_t CaptureLen;
+
+//--------------------------------------------------------------------------------------------------
+// Static functions
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start the writing of the record of a sequence number
+ *
+ * @return
+ *      - Slot of the record
+ */
+//--------------------------------------------------------------------------------------------------
+static lwm2mcore_TraceRecord_t* StartRecord
+(
+    lwm2mcore_TraceRecord_t* ringPtr,   ///< [IN] Ring buffer
+    uint32_t seq,                       ///< [IN] Sequence number
+    uint16_t event,                     ///< [IN] Event Id
+    uint64_t timeUs                     ///< [IN] Time of the record
+)
+{
+    lwm2mcore_TraceRecord_t* recordPtr = &ringPtr[seq & RingMask];
+
+    __atomic_store_n(&recordPtr->seq, seq ^ BUSY_SEQ_FLAG, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    recordPtr->timeUs = timeUs;
+    recordPtr->event = event;
+    recordPtr->len = 0;
+    return recordPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Commit a record: it can be read once its sequence number is written
+ */
+//--------------------------------------------------------------------------------------------------
+static void CommitRecord
+(
+    lwm2mcore_TraceRecord_t* recordPtr, ///< [IN] Record
+    uint32_t seq                        ///< [IN] Sequence number
+)
+{
+    __atomic_store_n(&recordPtr->seq, seq, __ATOMIC_RELEASE);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Internal functions
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a trace record
+ */
+//--------------------------------------------------------------------------------------------------
+void smanager_Trace
+(
+    uint16_t event,                 ///< [IN] Event Id
+    uint32_t arg0,                  ///< [IN] First argument
+    uint32_t arg1,                  ///< [IN] Second argument
+    uint32_t arg2,                  ///< [IN] Third argument
+    uint32_t arg3                   ///< [IN] Fourth argument
+)
+{
+    lwm2mcore_TraceRecord_t* ringPtr = __atomic_load_n(&RingPtr, __ATOMIC_ACQUIRE);
+    lwm2mcore_TraceRecord_t* recordPtr;
+    uint32_t seq;
+
+    if (NULL == ringPtr)
+    {
+        return;
+    }
+
+    seq = __atomic_fetch_add(&WriteSeq, 1, __ATOMIC_RELAXED);
+    recordPtr = StartRecord(ringPtr, seq, event, lwm2mcore_GetTimeUs());
+    recordPtr->args[0] = arg0;
+    recordPtr->args[1] = arg1;
+    recordPtr->args[2] = arg2;
+    recordPtr->args[3] = arg3;
+    CommitRecord(recordPtr, seq);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add the trace records of a packet: the packet event, followed by the captured bytes
+ */
+//--------------------------------------------------------------------------------------------------
+void smanager_TracePacket
+(
+    lwm2mcore_TraceEvent_t event,   ///< [IN] Packet event Id
+    uint16_t securityInstId,        ///< [IN] Security object instance Id of the server
+    const uint8_t* bufferPtr,       ///< [IN] Packet
+    size_t length,                  ///< [IN] Packet length
+    uint32_t flags                  ///< [IN] Packet flags (LWM2MCORE_TRACE_FLAG_xxx)
+)
+{
+    lwm2mcore_TraceRecord_t* ringPtr = __atomic_load_n(&RingPtr, __ATOMIC_ACQUIRE);
+    lwm2mcore_TraceRecord_t* recordPtr;
+    uint64_t timeUs;
+    uint32_t captureLen;
+    uint32_t payloadRecordNb;
+    uint32_t seq;
+    uint32_t i;
+
+    if (NULL == ringPtr)
+    {
+        return;
+    }
+
+    captureLen = (NULL == bufferPtr) ? 0 : ((CaptureLen < length) ? CaptureLen : length);
+    payloadRecordNb = (captureLen + PAYLOAD_RECORD_LEN - 1) / PAYLOAD_RECORD_LEN;
+    timeUs = lwm2mcore_GetTimeUs();
+
+    /* The payload records follow the packet record */
+    seq = __atomic_fetch_add(&WriteSeq, 1 + payloadRecordNb, __ATOMIC_RELAXED);
+
+    recordPtr = StartRecord(ringPtr, seq, (uint16_t)event, timeUs);
+    recordPtr->args[0] = securityInstId;
+    recordPtr->args[1] = (uint32_t)length;
+    recordPtr->args[2] = flags;
+    recordPtr->args[3] = captureLen;
+    CommitRecord(recordPtr, seq);
+
+    for (i = 0; i < payloadRecordNb; i++)
+    {
+        uint32_t offset = i * PAYLOAD_RECORD_LEN;
+        uint32_t len = captureLen - offset;
+
+        if (PAYLOAD_RECORD_LEN < len)
+        {
+            len = PAYLOAD_RECORD_LEN;
+        }
+
+        recordPtr = StartRecord(ringPtr, seq + 1 + i, LWM2MCORE_TRACE_PAYLOAD, timeUs);
+        memset(recordPtr->args, 0, sizeof(recordPtr->args));
+        memcpy(recordPtr->args, bufferPtr + offset, len);
+        recordPtr->len = (uint16_t)len;
+        CommitRecord(recordPtr, seq + 1 + i);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public functions
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function to enable the trace.
+ *
+ * The trace records are stored in a ring buffer: when it is full, the oldest records are
+ * overwritten. The records can be added by any thread without lock.
+ *
+ * @return
+ *      - true if the trace is enabled
+ *      - false if the trace is already enabled, if the record number is not a power of two or in
+ *        case of allocation failure
+ */
+//--------------------------------------------------------------------------------------------------
+bool lwm2mcore_TraceEnable
+(
+    uint32_t recordNb,              ///< [IN] Number of records of the ring buffer (power of two)
+    uint16_t captureLen             ///< [IN] Maximum number of bytes captured per packet,
+                                    ///<      0 to trace the packet lengths only
+)
+{
+    lwm2mcore_TraceRecord_t* ringPtr;
+    uint32_t i;
+
+    if ((NULL != RingPtr)
+     || (0 == recordNb)
+     || (recordNb & (recordNb - 1))
+     || (BUSY_SEQ_FLAG <= recordNb))
+    {
+        return false;
+    }
+
+    ringPtr = (lwm2mcore_TraceRecord_t*)SMANAGER_MALLOC(recordNb * sizeof(lwm2mcore_TraceRecord_t));
+    if (NULL == ringPtr)
+    {
+        LOG("Unable to allocate the trace buffer");
+        return false;
+    }
+    memset(ringPtr, 0, recordNb * sizeof(lwm2mcore_TraceRecord_t));
+
+    /* No slot contains a committed record */
+    for (i = 0; i < recordNb; i++)
+    {
+        ringPtr[i].seq = i ^ BUSY_SEQ_FLAG;
+    }
+
+    RingMask = recordNb - 1;
+    CaptureLen = captureLen;
+    __atomic_store_n(&WriteSeq, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&RingPtr, ringPtr, __ATOMIC_RELEASE);
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function to disable the trace and release the ring buffer.
+ *
+ * This function has to be called when no other thread can add a record.
+ */
+//--------------------------------------------------------------------------------------------------
+void lwm2mcore_TraceDisable
+(
+    void
+)
+{
+    lwm2mcore_TraceRecord_t* ringPtr = __atomic_exchange_n(&RingPtr, NULL, __ATOMIC_ACQ_REL);
+
+    if (NULL != ringPtr)
+    {
+        lwm2m_free(ringPtr);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function to add a platform trace record
+ */
+//--------------------------------------------------------------------------------------------------
+void lwm2mcore_Trace
+(
+    uint16_t event,                 ///< [IN] Event Id, from LWM2MCORE_TRACE_PLATFORM_BASE
+    uint32_t arg0,                  ///< [IN] First argument
+    uint32_t arg1,                  ///< [IN] Second argument
+    uint32_t arg2,                  ///< [IN] Third argument
+    uint32_t arg3                   ///< [IN] Fourth argument
+)
+{
+    if (LWM2MCORE_TRACE_PLATFORM_BASE > event)
+    {
+        return;
+    }
+
+    smanager_Trace(event, arg0, arg1, arg2, arg3);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function to retrieve the trace records, in the order of their sequence numbers.
+ *
+ * The retrieval starts from the sequence number *seqPtr, or from the oldest record in the ring
+ * buffer if this record was overwritten. *seqPtr is updated with the sequence number following
+ * the last retrieved record, to be used for the next call. The records overwritten during the
+ * retrieval are skipped.
+ *
+ * @return
+ *      - Number of retrieved records
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t lwm2mcore_TraceGetRecords
+(
+    uint32_t* seqPtr,                   ///< [INOUT] Sequence number of the first record
+    lwm2mcore_TraceRecord_t* recordsPtr,///< [OUT] Records
+    uint32_t recordNb,                  ///< [IN] Maximum number of records
+    uint32_t* lostNbPtr                 ///< [OUT] Number of records lost since *seqPtr (optional)
+)
+{
+    lwm2mcore_TraceRecord_t* ringPtr = __atomic_load_n(&RingPtr, __ATOMIC_ACQUIRE);
+    uint32_t writeSeq;
+    uint32_t seq;
+    uint32_t lostNb = 0;
+    uint32_t count = 0;
+
+    if (lostNbPtr)
+    {
+        *lostNbPtr = 0;
+    }
+
+    if ((NULL == ringPtr) || (NULL == seqPtr) || (NULL == recordsPtr))
+    {
+        return 0;
+    }
+
+    writeSeq = __atomic_load_n(&WriteSeq, __ATOMIC_ACQUIRE);
+    seq = *seqPtr;
+
+    /* Records overwritten since the previous retrieval */
+    if ((writeSeq - seq) > (RingMask + 1))
+    {
+        lostNb = (writeSeq - (RingMask + 1)) - seq;
+        seq = writeSeq - (RingMask + 1);
+    }
+
+    while ((count < recordNb) && (seq != writeSeq))
+    {
+        lwm2mcore_TraceRecord_t* slotPtr = &ringPtr[seq & RingMask];
+        uint32_t slotSeq = __atomic_load_n(&slotPtr->seq, __ATOMIC_ACQUIRE);
+
+        if ((seq ^ BUSY_SEQ_FLAG) == slotSeq)
+        {
+            /* The record is being written, retrieve it on the next call */
+            break;
+        }
+
+        if (seq == slotSeq)
+        {
+            memcpy(&recordsPtr[count], slotPtr, sizeof(lwm2mcore_TraceRecord_t));
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            slotSeq = __atomic_load_n(&slotPtr->seq, __ATOMIC_RELAXED);
+        }
+
+        if (seq == slotSeq)
+        {
+            recordsPtr[count].seq = seq;
+            count++;
+        }
+        else
+        {
+            /* Overwritten by a newer record */
+            lostNb++;
+        }
+        seq++;
+    }
+
+    *seqPtr = seq;
+    if (lostNbPtr)
+    {
+        *lostNbPtr = lostNb;
+    }
+    return count;
+}
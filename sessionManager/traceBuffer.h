@@ -0,0 +1,56 @@
+/**
+ * @file traceBuffer.h
+ *
+ * Binary trace ring buffer of LwM2MCore
+ *
+ * The trace points of the hot paths (packets sent and received, resource operations) add
+ * fixed-size records to a ring buffer instead of formatting logs. When the trace is disabled, a
+ * trace point only costs a function call and a test.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#ifndef __TRACEBUFFER_H__
+#define __TRACEBUFFER_H__
+
+#include <lwm2mcore/trace.h>
+
+/**
+  * @addtogroup lwm2mcore_tracebuffer_int
+  * @{
+  */
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Add a trace record
+ */
+//--------------------------------------------------------------------------------------------------
+void smanager_Trace
+(
+    uint16_t event,                 ///< [IN] Event Id
+    uint32_t arg0,                  ///< [IN] First argument
+    uint32_t arg1,                  ///< [IN] Second argument
+    uint32_t arg2,                  ///< [IN] Third argument
+    uint32_t arg3                   ///< [IN] Fourth argument
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * @brief Add the trace records of a packet: the packet event, followed by the captured bytes
+ */
+//--------------------------------------------------------------------------------------------------
+void smanager_TracePacket
+(
+    lwm2mcore_TraceEvent_t event,   ///< [IN] Packet event Id
+    uint16_t securityInstId,        ///< [IN] Security object instance Id of the server
+    const uint8_t* bufferPtr,       ///< [IN] Packet
+    size_t length,                  ///< [IN] Packet length
+    uint32_t flags                  ///< [IN] Packet flags (LWM2MCORE_TRACE_FLAG_xxx)
+);
+
+/**
+  * @}
+  */
+
+#endif /* __TRACEBUFFER_H__ */
@@ -0,0 +1,577 @@
+/**
+ * @file dwlGenerator.c
+ *
+ * Generator of synthetic DWL packages, used to test and benchmark the package downloader.
+ *
+ * The generated package is made of the following sections:
+ * - UPCK: DWL prolog, optional comments, UPCK header (firmware update package)
+ * - BINA: DWL prolog, optional comments, BINA header, binary data, padding
+ *   or COMP: DWL prolog, optional comments, COMP header, zlib compressed binary data, padding
+ * - SIGN: DWL prolog, optional comments, signature (RSA-PSS/SHA1, ECDSA P-256/SHA-256 or
+ *   Ed25519/SHA-256 depending on the key type)
+ *
+ * @note The signature uses the OpenSSL library and the compression the zlib library.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zlib.h>
+#include <openssl/ec.h>
+#include <openssl/evp.h>
+#include <openssl/pem.h>
+#include <openssl/rsa.h>
+#include <openssl/sha.h>
+#include <openssl/x509.h>
+#include "dwlGenerator.h"
+
+//--------------------------------------------------------------------------------------------------
+// Symbol and Enum definitions
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * DWL prolog and header lengths
+ */
+//--------------------------------------------------------------------------------------------------
+#define DWL_PROLOG_LEN          32
+#define DWL_HEADER_LEN          128
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * DWL prolog magic number and section types
+ */
+//--------------------------------------------------------------------------------------------------
+#define DWL_MAGIC_NUMBER        0x464c5744  ///< DWLF
+#define DWL_TYPE_UPCK           0x4b435055  ///< UpdatePackage
+#define DWL_TYPE_SIGN           0x4e474953  ///< Signature
+#define DWL_TYPE_BINA           0x414e4942  ///< Binary
+#define DWL_TYPE_COMP           0x504d4f43  ///< CompBinary
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * UPCK type of a firmware update package
+ */
+//--------------------------------------------------------------------------------------------------
+#define UPCK_TYPE_FW            0x00000001
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * zlib compression type, see lwm2mcore_CompressionType_t
+ */
+//--------------------------------------------------------------------------------------------------
+#define COMP_TYPE_ZLIB          1
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Length of the generated RSA test key, in bits
+ */
+//--------------------------------------------------------------------------------------------------
+#define TEST_KEY_BITS           2048
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Length of a raw ECDSA P-256 signature (r and s)
+ */
+//--------------------------------------------------------------------------------------------------
+#define ECDSA_P256_RAW_SIGNATURE_LEN    64
+
+//--------------------------------------------------------------------------------------------------
+// Static functions
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Round a length up to a multiple of 8 bytes, DWL sections and comments being 8-byte aligned
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t Align8
+(
+    size_t len      ///< [IN] Length
+)
+{
+    return (len + 7) & ~(size_t)7;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a DWL prolog followed by the section comments, and return the length written
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t WritePrologAndComments
+(
+    uint8_t*    bufPtr,         ///< [OUT] Buffer
+    uint32_t    dataType,       ///< [IN] DWL section type
+    uint32_t    fileSize,       ///< [IN] DWL section size, without padding
+    size_t      commentLen      ///< [IN] Comments length, multiple of 8
+)
+{
+    uint32_t magicNumber = DWL_MAGIC_NUMBER;
+    uint32_t statusBitfield = 0xFFFFFFFF;
+    uint16_t commentSize = (uint16_t)(commentLen >> 3);
+    size_t i;
+
+    memset(bufPtr, 0, DWL_PROLOG_LEN);
+    memcpy(bufPtr, &magicNumber, sizeof(uint32_t));
+    memcpy(bufPtr + 4, &statusBitfield, sizeof(uint32_t));
+    memcpy(bufPtr + 12, &fileSize, sizeof(uint32_t));
+    memcpy(bufPtr + 24, &dataType, sizeof(uint32_t));
+    memcpy(bufPtr + 30, &commentSize, sizeof(uint16_t));
+
+    for (i = 0; i < commentLen; i++)
+    {
+        bufPtr[DWL_PROLOG_LEN + i] = (uint8_t)('a' + (i % 26));
+    }
+
+    return DWL_PROLOG_LEN + commentLen;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fill the binary data with pseudo-random data. Each byte only holds 4 random bits, so that the
+ * data is about 2:1 compressible.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FillBinaryData
+(
+    uint8_t* bufPtr,        ///< [OUT] Buffer
+    size_t   len,           ///< [IN] Buffer length
+    uint32_t seed           ///< [IN] Seed of the pseudo-random data
+)
+{
+    uint32_t state = seed ? seed : 1;
+    size_t i;
+
+    for (i = 0; i < len; i++)
+    {
+        // xorshift32
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        bufPtr[i] = (uint8_t)(0x40 | (state & 0x0F));
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Load the private key used to sign the package, or generate a test key
+ *
+ * @return
+ *  - Private key
+ *  - NULL on failure
+ */
+//--------------------------------------------------------------------------------------------------
+static EVP_PKEY* GetSigningKey
+(
+    const char*            keyFilePtr,      ///< [IN] PEM file of the private key, NULL to generate
+                                            ///< a test key
+    dwlgen_SignatureType_t signatureType    ///< [IN] Signature scheme of the test key
+)
+{
+    EVP_PKEY* keyPtr = NULL;
+    EVP_PKEY_CTX* keyCtxPtr;
+    bool isGenerated;
+
+    if (keyFilePtr)
+    {
+        FILE* filePtr = fopen(keyFilePtr, "r");
+        if (!filePtr)
+        {
+            printf("Unable to open key file %s\n", keyFilePtr);
+            return NULL;
+        }
+        keyPtr = PEM_read_PrivateKey(filePtr, NULL, NULL, NULL);
+        fclose(filePtr);
+        if (!keyPtr)
+        {
+            printf("Unable to read private key from %s\n", keyFilePtr);
+        }
+        return keyPtr;
+    }
+
+    switch (signatureType)
+    {
+        case DWLGEN_SIGN_ECDSA_P256_SHA256:
+            keyCtxPtr = EVP_PKEY_CTX_new_id(EVP_PKEY_EC, NULL);
+            isGenerated = (   (keyCtxPtr)
+                           && (1 == EVP_PKEY_keygen_init(keyCtxPtr))
+                           && (0 < EVP_PKEY_CTX_set_ec_paramgen_curve_nid(keyCtxPtr,
+                                                                     NID_X9_62_prime256v1))
+                           && (1 == EVP_PKEY_keygen(keyCtxPtr, &keyPtr))
+                          );
+            break;
+
+        case DWLGEN_SIGN_ED25519_SHA256:
+            keyCtxPtr = EVP_PKEY_CTX_new_id(EVP_PKEY_ED25519, NULL);
+            isGenerated = (   (keyCtxPtr)
+                           && (1 == EVP_PKEY_keygen_init(keyCtxPtr))
+                           && (1 == EVP_PKEY_keygen(keyCtxPtr, &keyPtr))
+                          );
+            break;
+
+        case DWLGEN_SIGN_RSA_PSS_SHA1:
+        default:
+            keyCtxPtr = EVP_PKEY_CTX_new_id(EVP_PKEY_RSA, NULL);
+            isGenerated = (   (keyCtxPtr)
+                           && (1 == EVP_PKEY_keygen_init(keyCtxPtr))
+                           && (0 < EVP_PKEY_CTX_set_rsa_keygen_bits(keyCtxPtr, TEST_KEY_BITS))
+                           && (1 == EVP_PKEY_keygen(keyCtxPtr, &keyPtr))
+                          );
+            break;
+    }
+
+    if (!isGenerated)
+    {
+        printf("Unable to generate test key\n");
+        EVP_PKEY_free(keyPtr);
+        keyPtr = NULL;
+    }
+    EVP_PKEY_CTX_free(keyCtxPtr);
+
+    return keyPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the length of the package signature for a private key. The length is fixed, as it is part
+ * of the signed data through the UPCK file size.
+ *
+ * @return
+ *  - Signature length
+ *  - 0 if the key type is not supported
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t GetSignatureLen
+(
+    EVP_PKEY* keyPtr        ///< [IN] Private key
+)
+{
+    switch (EVP_PKEY_base_id(keyPtr))
+    {
+        case EVP_PKEY_RSA:
+            return (size_t)EVP_PKEY_size(keyPtr);
+
+        case EVP_PKEY_EC:
+            return ECDSA_P256_RAW_SIGNATURE_LEN;
+
+        case EVP_PKEY_ED25519:
+            return (size_t)EVP_PKEY_size(keyPtr);
+
+        default:
+            return 0;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sign an ECDSA P-256 digest and convert the DER signature to the raw r|s format
+ *
+ * @return
+ *  - true  The signature is computed
+ *  - false The signature failed
+ */
+//--------------------------------------------------------------------------------------------------
+static bool SignEcdsaDigest
+(
+    EVP_PKEY_CTX*  keyCtxPtr,       ///< [IN] Signature context, initialized
+    const uint8_t* digestPtr,       ///< [IN] Digest
+    size_t         digestLen,       ///< [IN] Digest length
+    uint8_t*       signaturePtr     ///< [OUT] Raw signature
+)
+{
+    uint8_t derSignature[ECDSA_P256_RAW_SIGNATURE_LEN + 16];
+    size_t derSignatureLen = sizeof(derSignature);
+    const uint8_t* derPtr = derSignature;
+    ECDSA_SIG* sigPtr;
+    const BIGNUM* rPtr;
+    const BIGNUM* sPtr;
+    bool result;
+
+    if (1 != EVP_PKEY_sign(keyCtxPtr, derSignature, &derSignatureLen, digestPtr, digestLen))
+    {
+        return false;
+    }
+
+    sigPtr = d2i_ECDSA_SIG(NULL, &derPtr, (long)derSignatureLen);
+    if (!sigPtr)
+    {
+        return false;
+    }
+    ECDSA_SIG_get0(sigPtr, &rPtr, &sPtr);
+    result = (   (0 < BN_bn2binpad(rPtr, signaturePtr, ECDSA_P256_RAW_SIGNATURE_LEN / 2))
+              && (0 < BN_bn2binpad(sPtr,
+                                   signaturePtr + ECDSA_P256_RAW_SIGNATURE_LEN / 2,
+                                   ECDSA_P256_RAW_SIGNATURE_LEN / 2))
+             );
+    ECDSA_SIG_free(sigPtr);
+
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sign the package digest with the scheme given by the private key type:
+ * - RSA: RSA-PSS signature of the SHA1 digest
+ * - EC P-256: ECDSA signature of the SHA-256 digest, raw r|s
+ * - Ed25519: Ed25519 signature of the SHA-256 digest
+ *
+ * @return
+ *  - true  The signature is computed
+ *  - false The signature failed
+ */
+//--------------------------------------------------------------------------------------------------
+static bool SignDigest
+(
+    EVP_PKEY*      keyPtr,          ///< [IN] Private key
+    const uint8_t* digestPtr,       ///< [IN] Digest
+    size_t         digestLen,       ///< [IN] Digest length
+    uint8_t*       signaturePtr,    ///< [OUT] Signature
+    size_t         signatureLen     ///< [IN] Signature length, see GetSignatureLen()
+)
+{
+    bool result = false;
+
+    if (EVP_PKEY_ED25519 == EVP_PKEY_base_id(keyPtr))
+    {
+        EVP_MD_CTX* mdCtxPtr = EVP_MD_CTX_new();
+        size_t len = signatureLen;
+
+        result = (   (mdCtxPtr)
+                  && (1 == EVP_DigestSignInit(mdCtxPtr, NULL, NULL, NULL, keyPtr))
+                  && (1 == EVP_DigestSign(mdCtxPtr, signaturePtr, &len, digestPtr, digestLen))
+                  && (signatureLen == len)
+                 );
+        EVP_MD_CTX_free(mdCtxPtr);
+    }
+    else
+    {
+        EVP_PKEY_CTX* keyCtxPtr = EVP_PKEY_CTX_new(keyPtr, NULL);
+        size_t len = signatureLen;
+
+        if ((keyCtxPtr) && (1 == EVP_PKEY_sign_init(keyCtxPtr)))
+        {
+            if (EVP_PKEY_EC == EVP_PKEY_base_id(keyPtr))
+            {
+                result = (   (0 < EVP_PKEY_CTX_set_signature_md(keyCtxPtr, EVP_sha256()))
+                          && (SignEcdsaDigest(keyCtxPtr, digestPtr, digestLen, signaturePtr))
+                         );
+            }
+            else
+            {
+                result = (   (0 < EVP_PKEY_CTX_set_rsa_padding(keyCtxPtr, RSA_PKCS1_PSS_PADDING))
+                          && (0 < EVP_PKEY_CTX_set_signature_md(keyCtxPtr, EVP_sha1()))
+                          && (1 == EVP_PKEY_sign(keyCtxPtr,
+                                                 signaturePtr,
+                                                 &len,
+                                                 digestPtr,
+                                                 digestLen))
+                         );
+            }
+        }
+        EVP_PKEY_CTX_free(keyCtxPtr);
+    }
+
+    if (!result)
+    {
+        printf("Unable to sign the package\n");
+    }
+
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Public functions
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Generate a signed DWL package made of UPCK, BINA (or COMP) and SIGN sections.
+ *
+ * The package CRC and the signature cover the UPCK and BINA (or COMP) sections, as expected by
+ * the package downloader.
+ *
+ * @return
+ *  - true  The package is generated, it should be released with dwlgen_Free()
+ *  - false The generation failed
+ */
+//--------------------------------------------------------------------------------------------------
+bool dwlgen_Build
+(
+    const dwlgen_Config_t* configPtr,   ///< [IN] Generation parameters
+    dwlgen_Package_t*      packagePtr   ///< [OUT] Generated package
+)
+{
+    EVP_PKEY* keyPtr;
+    uint8_t* dataPtr;
+    uint8_t* binarySectionPtr;
+    uint8_t* publicKeyPtr;
+    size_t commentLen;
+    size_t dataLen;
+    size_t signedLen;
+    size_t signatureLen;
+    size_t maxPackageLen;
+    uint32_t dataType;
+    uint32_t upckType = UPCK_TYPE_FW;
+    uint32_t crc;
+    uint8_t digest[SHA256_DIGEST_LENGTH];
+    unsigned int digestLen;
+    int publicKeyLen;
+
+    if ((!configPtr) || (!packagePtr) || (!configPtr->binaryLen))
+    {
+        return false;
+    }
+
+    memset(packagePtr, 0, sizeof(dwlgen_Package_t));
+    commentLen = Align8(configPtr->commentLen);
+
+    keyPtr = GetSigningKey(configPtr->keyFilePtr, configPtr->signatureType);
+    if (!keyPtr)
+    {
+        return false;
+    }
+    signatureLen = GetSignatureLen(keyPtr);
+    if (!signatureLen)
+    {
+        printf("Unsupported private key type %d\n", EVP_PKEY_base_id(keyPtr));
+        EVP_PKEY_free(keyPtr);
+        return false;
+    }
+
+    // Binary data as it should be stored by the package downloader
+    packagePtr->binaryLen = configPtr->binaryLen;
+    packagePtr->binaryPtr = (uint8_t*)malloc(packagePtr->binaryLen);
+    if (!packagePtr->binaryPtr)
+    {
+        EVP_PKEY_free(keyPtr);
+        return false;
+    }
+    FillBinaryData(packagePtr->binaryPtr, packagePtr->binaryLen, configPtr->seed);
+
+    dataLen = configPtr->isCompressed ? (size_t)compressBound((uLong)packagePtr->binaryLen)
+                                      : packagePtr->binaryLen;
+    maxPackageLen = 3 * (DWL_PROLOG_LEN + commentLen)
+                    + 2 * DWL_HEADER_LEN
+                    + Align8(dataLen)
+                    + signatureLen;
+    packagePtr->packagePtr = (uint8_t*)malloc(maxPackageLen);
+    if (!packagePtr->packagePtr)
+    {
+        dwlgen_Free(packagePtr);
+        EVP_PKEY_free(keyPtr);
+        return false;
+    }
+    memset(packagePtr->packagePtr, 0, maxPackageLen);
+
+    // Binary data section: the data is first written to know the section size
+    binarySectionPtr = packagePtr->packagePtr + (DWL_PROLOG_LEN + commentLen + DWL_HEADER_LEN);
+    dataPtr = binarySectionPtr + DWL_PROLOG_LEN + commentLen;
+    if (configPtr->isCompressed)
+    {
+        uLongf compressedLen = (uLongf)dataLen;
+        uint32_t compressionType = COMP_TYPE_ZLIB;
+        uint32_t decompressedSize = (uint32_t)packagePtr->binaryLen;
+
+        if (Z_OK != compress2(dataPtr + DWL_HEADER_LEN,
+                              &compressedLen,
+                              packagePtr->binaryPtr,
+                              (uLong)packagePtr->binaryLen,
+                              Z_DEFAULT_COMPRESSION))
+        {
+            printf("Unable to compress the binary data\n");
+            dwlgen_Free(packagePtr);
+            EVP_PKEY_free(keyPtr);
+            return false;
+        }
+        dataLen = (size_t)compressedLen;
+        memcpy(dataPtr, &compressionType, sizeof(uint32_t));
+        memcpy(dataPtr + 4, &decompressedSize, sizeof(uint32_t));
+        dataType = DWL_TYPE_COMP;
+    }
+    else
+    {
+        memcpy(dataPtr + DWL_HEADER_LEN, packagePtr->binaryPtr, dataLen);
+        dataType = DWL_TYPE_BINA;
+    }
+    WritePrologAndComments(binarySectionPtr,
+                           dataType,
+                           (uint32_t)(DWL_PROLOG_LEN + commentLen + DWL_HEADER_LEN + dataLen),
+                           commentLen);
+    signedLen = (size_t)(binarySectionPtr - packagePtr->packagePtr)
+                + Align8(DWL_PROLOG_LEN + commentLen + DWL_HEADER_LEN + dataLen);
+    packagePtr->packageLen = signedLen + DWL_PROLOG_LEN + commentLen + signatureLen;
+    packagePtr->signatureLen = signatureLen;
+
+    // UPCK section
+    dataPtr = packagePtr->packagePtr;
+    dataPtr += WritePrologAndComments(dataPtr,
+                                      DWL_TYPE_UPCK,
+                                      (uint32_t)packagePtr->packageLen,
+                                      commentLen);
+    memcpy(dataPtr, &upckType, sizeof(uint32_t));
+
+    // The CRC covers the data from the UPCK file size to the end of the binary data section
+    crc = (uint32_t)crc32(0L, packagePtr->packagePtr + 12, (uInt)(signedLen - 12));
+    memcpy(packagePtr->packagePtr + 8, &crc, sizeof(uint32_t));
+
+    // The signature covers the data from the beginning to the end of the binary data section
+    dataPtr = packagePtr->packagePtr + signedLen;
+    dataPtr += WritePrologAndComments(dataPtr,
+                                      DWL_TYPE_SIGN,
+                                      (uint32_t)(DWL_PROLOG_LEN + commentLen + signatureLen),
+                                      commentLen);
+    if (   (1 != EVP_Digest(packagePtr->packagePtr,
+                            signedLen,
+                            digest,
+                            &digestLen,
+                            (EVP_PKEY_RSA == EVP_PKEY_base_id(keyPtr)) ? EVP_sha1() : EVP_sha256(),
+                            NULL))
+        || (!SignDigest(keyPtr, digest, digestLen, dataPtr, signatureLen))
+       )
+    {
+        dwlgen_Free(packagePtr);
+        EVP_PKEY_free(keyPtr);
+        return false;
+    }
+
+    // Public key verifying the signature
+    publicKeyLen = i2d_PUBKEY(keyPtr, NULL);
+    if ((publicKeyLen <= 0) || ((size_t)publicKeyLen > sizeof(packagePtr->publicKey)))
+    {
+        printf("Unable to export the public key\n");
+        dwlgen_Free(packagePtr);
+        EVP_PKEY_free(keyPtr);
+        return false;
+    }
+    publicKeyPtr = packagePtr->publicKey;
+    packagePtr->publicKeyLen = (size_t)i2d_PUBKEY(keyPtr, &publicKeyPtr);
+    EVP_PKEY_free(keyPtr);
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Release a package generated by dwlgen_Build()
+ */
+//--------------------------------------------------------------------------------------------------
+void dwlgen_Free
+(
+    dwlgen_Package_t* packagePtr        ///< [IN] Generated package
+)
+{
+    if (!packagePtr)
+    {
+        return;
+    }
+
+    free(packagePtr->packagePtr);
+    free(packagePtr->binaryPtr);
+    packagePtr->packagePtr = NULL;
+    packagePtr->binaryPtr = NULL;
+    packagePtr->packageLen = 0;
+    packagePtr->binaryLen = 0;
+}
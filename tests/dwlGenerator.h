@@ -0,0 +1,105 @@
+/**
+ * @file dwlGenerator.h
+ *
+ * Generator of synthetic DWL packages, used to test and benchmark the package downloader
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#ifndef DWL_GENERATOR_H
+#define DWL_GENERATOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <lwm2mcore/lwm2mcore.h>
+#include <lwm2mcore/security.h>
+
+//--------------------------------------------------------------------------------------------------
+// Data structures
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Package signature schemes, as verified by the package downloader for each public key type
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    DWLGEN_SIGN_RSA_PSS_SHA1,       ///< RSA-PSS signature of the SHA1 digest
+    DWLGEN_SIGN_ECDSA_P256_SHA256,  ///< ECDSA P-256 signature of the SHA-256 digest, raw r|s
+    DWLGEN_SIGN_ED25519_SHA256      ///< Ed25519 signature of the SHA-256 digest
+}
+dwlgen_SignatureType_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * DWL package generation parameters
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    size_t      binaryLen;      ///< Length of the binary data to update
+    size_t      commentLen;     ///< Length of the comments added to each DWL section, 0 if none
+    bool        isCompressed;   ///< Binary data compressed with zlib in a COMP section, instead
+                                ///< of a BINA section
+    uint32_t    seed;           ///< Seed of the pseudo-random binary data
+    const char* keyFilePtr;     ///< PEM file of the private key used to sign the package,
+                                ///< NULL to generate a test key
+    dwlgen_SignatureType_t signatureType;   ///< Signature scheme of the generated test key, the
+                                            ///< scheme of a key file being given by its key type
+}
+dwlgen_Config_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Generated DWL package
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint8_t* packagePtr;                        ///< DWL package
+    size_t   packageLen;                        ///< DWL package length
+    uint8_t* binaryPtr;                         ///< Binary data, as stored after the download
+    size_t   binaryLen;                         ///< Binary data length
+    uint8_t  publicKey[LWM2MCORE_PUBLICKEY_LEN];///< Public key verifying the package signature,
+                                                ///< X.509 SubjectPublicKeyInfo DER format
+    size_t   publicKeyLen;                      ///< Public key length
+    size_t   signatureLen;                      ///< Signature length, at the end of the package
+}
+dwlgen_Package_t;
+
+//--------------------------------------------------------------------------------------------------
+// Public functions
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Generate a signed DWL package made of UPCK, BINA (or COMP) and SIGN sections.
+ *
+ * The package CRC and the signature cover the UPCK and BINA (or COMP) sections, as expected by
+ * the package downloader.
+ *
+ * @return
+ *  - true  The package is generated, it should be released with dwlgen_Free()
+ *  - false The generation failed
+ */
+//--------------------------------------------------------------------------------------------------
+bool dwlgen_Build
+(
+    const dwlgen_Config_t* configPtr,   ///< [IN] Generation parameters
+    dwlgen_Package_t*      packagePtr   ///< [OUT] Generated package
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Release a package generated by dwlgen_Build()
+ */
+//--------------------------------------------------------------------------------------------------
+void dwlgen_Free
+(
+    dwlgen_Package_t* packagePtr        ///< [IN] Generated package
+);
+
+#endif /* DWL_GENERATOR_H */
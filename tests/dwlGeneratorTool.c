@@ -0,0 +1,259 @@
+/**
+ * @file dwlGeneratorTool.c
+ *
+ * Command line tool generating synthetic DWL packages, see dwlGenerator.h
+ *
+ * Usage: dwlgenerator -o <package file> -s <binary length> [options]
+ *  -o <file>   DWL package file to generate
+ *  -s <len>    Binary data length, with an optional K or M suffix
+ *  -c <len>    Comments length added to each DWL section (default: 0)
+ *  -z          Compress the binary data with zlib (COMP section instead of BINA)
+ *  -k <file>   PEM file of the private key signing the package (default: generated test key)
+ *  -a <scheme> Signature scheme of the generated test key: rsa (RSA-PSS/SHA1, default),
+ *              ecdsa (ECDSA P-256/SHA-256) or ed25519 (Ed25519/SHA-256)
+ *  -p <file>   File where the DER public key verifying the package is written
+ *  -b <file>   File where the binary data expected after the download is written
+ *  -r <seed>   Seed of the pseudo-random binary data (default: 1)
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "dwlGenerator.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parse a length with an optional K or M suffix
+ *
+ * @return
+ *  - Length
+ *  - 0 if the length is invalid
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t ParseLength
+(
+    const char* strPtr      ///< [IN] Length string
+)
+{
+    char* endPtr = NULL;
+    unsigned long long len = strtoull(strPtr, &endPtr, 0);
+
+    if ((!endPtr) || (endPtr == strPtr))
+    {
+        return 0;
+    }
+
+    switch (*endPtr)
+    {
+        case 'k':
+        case 'K':
+            len *= 1024;
+            break;
+
+        case 'm':
+        case 'M':
+            len *= 1024 * 1024;
+            break;
+
+        default:
+            break;
+    }
+
+    return (size_t)len;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parse a signature scheme name
+ *
+ * @return
+ *  - true  The scheme is valid
+ *  - false The scheme is unknown
+ */
+//--------------------------------------------------------------------------------------------------
+static bool ParseSignatureType
+(
+    const char*             strPtr,     ///< [IN] Scheme name
+    dwlgen_SignatureType_t* typePtr     ///< [OUT] Signature scheme
+)
+{
+    if (0 == strcmp(strPtr, "rsa"))
+    {
+        *typePtr = DWLGEN_SIGN_RSA_PSS_SHA1;
+    }
+    else if (0 == strcmp(strPtr, "ecdsa"))
+    {
+        *typePtr = DWLGEN_SIGN_ECDSA_P256_SHA256;
+    }
+    else if (0 == strcmp(strPtr, "ed25519"))
+    {
+        *typePtr = DWLGEN_SIGN_ED25519_SHA256;
+    }
+    else
+    {
+        return false;
+    }
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a buffer to a file
+ *
+ * @return
+ *  - true  The file is written
+ *  - false The file can't be written
+ */
+//--------------------------------------------------------------------------------------------------
+static bool WriteFile
+(
+    const char*    fileNamePtr,     ///< [IN] File name
+    const uint8_t* bufPtr,          ///< [IN] Buffer
+    size_t         len              ///< [IN] Buffer length
+)
+{
+    FILE* filePtr = fopen(fileNamePtr, "wb");
+    bool result;
+
+    if (!filePtr)
+    {
+        printf("Unable to open %s\n", fileNamePtr);
+        return false;
+    }
+
+    result = (len == fwrite(bufPtr, 1, len, filePtr));
+    if (!result)
+    {
+        printf("Unable to write %s\n", fileNamePtr);
+    }
+    fclose(filePtr);
+
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Print the tool usage
+ */
+//--------------------------------------------------------------------------------------------------
+static void PrintUsage
+(
+    const char* namePtr     ///< [IN] Program name
+)
+{
+    printf("Usage: %s -o <package file> -s <binary length> [-c <comments length>] [-z]\n"
+           "          [-k <private key PEM file>] [-a <rsa|ecdsa|ed25519>]\n"
+           "          [-p <public key DER file>] [-b <binary file>] [-r <seed>]\n",
+           namePtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * DWL package generator entry point
+ */
+//--------------------------------------------------------------------------------------------------
+int main
+(
+    int   argc,     ///< [IN] Number of arguments
+    char* argv[]    ///< [IN] Arguments
+)
+{
+    dwlgen_Config_t config;
+    dwlgen_Package_t package;
+    const char* packageFilePtr = NULL;
+    const char* publicKeyFilePtr = NULL;
+    const char* binaryFilePtr = NULL;
+    int opt;
+    int result = EXIT_SUCCESS;
+
+    memset(&config, 0, sizeof(config));
+    config.seed = 1;
+
+    while (-1 != (opt = getopt(argc, argv, "o:s:c:zk:a:p:b:r:")))
+    {
+        switch (opt)
+        {
+            case 'o':
+                packageFilePtr = optarg;
+                break;
+
+            case 's':
+                config.binaryLen = ParseLength(optarg);
+                break;
+
+            case 'c':
+                config.commentLen = ParseLength(optarg);
+                break;
+
+            case 'z':
+                config.isCompressed = true;
+                break;
+
+            case 'k':
+                config.keyFilePtr = optarg;
+                break;
+
+            case 'a':
+                if (!ParseSignatureType(optarg, &config.signatureType))
+                {
+                    PrintUsage(argv[0]);
+                    return EXIT_FAILURE;
+                }
+                break;
+
+            case 'p':
+                publicKeyFilePtr = optarg;
+                break;
+
+            case 'b':
+                binaryFilePtr = optarg;
+                break;
+
+            case 'r':
+                config.seed = (uint32_t)strtoul(optarg, NULL, 0);
+                break;
+
+            default:
+                PrintUsage(argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+
+    if ((!packageFilePtr) || (!config.binaryLen))
+    {
+        PrintUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (!dwlgen_Build(&config, &package))
+    {
+        printf("Unable to generate the DWL package\n");
+        return EXIT_FAILURE;
+    }
+
+    if (   (!WriteFile(packageFilePtr, package.packagePtr, package.packageLen))
+        || ((publicKeyFilePtr) && (!WriteFile(publicKeyFilePtr,
+                                              package.publicKey,
+                                              package.publicKeyLen)))
+        || ((binaryFilePtr) && (!WriteFile(binaryFilePtr, package.binaryPtr, package.binaryLen)))
+       )
+    {
+        result = EXIT_FAILURE;
+    }
+    else
+    {
+        printf("DWL package %s: %zu bytes, %s binary data of %zu bytes\n",
+               packageFilePtr,
+               package.packageLen,
+               config.isCompressed ? "compressed" : "raw",
+               package.binaryLen);
+    }
+
+    dwlgen_Free(&package);
+    return result;
+}
@@ -0,0 +1,360 @@
+/**
+ * @file heapBenchmark.c
+ *
+ * Benchmark of the heap accounting of the Linux platform (examples/linux/platform.c, built with
+ * LWM2MCORE_HEAP_ACCOUNTING).
+ *
+ * The cost of an allocation and release pair done with lwm2mcore_MallocTag and lwm2m_free is
+ * compared with the C library malloc and free, for several block sizes, with one thread and with
+ * several threads updating the statistics of the same subsystem. The heap statistics are checked
+ * at the end of each measurement.
+ *
+ * Usage: heapbenchmark [options]
+ *  -n <pairs>      Number of allocation and release pairs per measurement (default: 1000000)
+ *  -t <threads>    Number of threads of the concurrent measurement (default: 4)
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <lwm2mcore/lwm2mcore.h>
+#include <lwm2mcore/heap.h>
+#include "liblwm2m.h"
+
+//--------------------------------------------------------------------------------------------------
+// Symbol and Enum definitions
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of blocks allocated before being released, to avoid measuring the reuse of a single block
+ */
+//--------------------------------------------------------------------------------------------------
+#define BATCH_NB                64
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of threads
+ */
+//--------------------------------------------------------------------------------------------------
+#define THREAD_MAX_NB           64
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Subsystem of the measured allocations
+ */
+//--------------------------------------------------------------------------------------------------
+#define BENCH_TAG               LWM2MCORE_HEAP_TAG_PLATFORM
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parameters of a measurement thread
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    size_t      size;           ///< Block size
+    int         pairNb;         ///< Number of allocation and release pairs
+    bool        isAccounted;    ///< Use the accounting allocator
+    pthread_t   thread;         ///< Thread
+}
+BenchThread_t;
+
+//--------------------------------------------------------------------------------------------------
+// Static variables
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Block sizes
+ */
+//--------------------------------------------------------------------------------------------------
+static const size_t BlockSizes[] = {16, 64, 256, 1024, 4096};
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sink preventing the compiler from removing the allocations
+ */
+//--------------------------------------------------------------------------------------------------
+static volatile uintptr_t Sink;
+
+//--------------------------------------------------------------------------------------------------
+// Static functions
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the monotonic time, in nanoseconds
+ */
+//--------------------------------------------------------------------------------------------------
+static double GetTimeNs
+(
+    void
+)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((double)ts.tv_sec * 1e9) + (double)ts.tv_nsec;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Allocate and release blocks by batches
+ *
+ * @return
+ *  - false in case of allocation failure
+ */
+//--------------------------------------------------------------------------------------------------
+static bool RunPairs
+(
+    size_t size,            ///< [IN] Block size
+    int    pairNb,          ///< [IN] Number of allocation and release pairs
+    bool   isAccounted      ///< [IN] Use the accounting allocator
+)
+{
+    void* blocks[BATCH_NB];
+    uintptr_t sum = 0;
+    int done = 0;
+    int i;
+
+    while (done < pairNb)
+    {
+        int batchNb = ((pairNb - done) < BATCH_NB) ? (pairNb - done) : BATCH_NB;
+
+        for (i = 0; i < batchNb; i++)
+        {
+            blocks[i] = isAccounted ? lwm2mcore_MallocTag(size, BENCH_TAG) : malloc(size);
+            if (NULL == blocks[i])
+            {
+                return false;
+            }
+            *(volatile uint8_t*)blocks[i] = (uint8_t)i;
+            sum += (uintptr_t)blocks[i];
+        }
+
+        for (i = 0; i < batchNb; i++)
+        {
+            if (isAccounted)
+            {
+                lwm2m_free(blocks[i]);
+            }
+            else
+            {
+                free(blocks[i]);
+            }
+        }
+        done += batchNb;
+    }
+
+    Sink = sum;
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Measurement thread
+ */
+//--------------------------------------------------------------------------------------------------
+static void* BenchThread
+(
+    void* ctxPtr    ///< [IN] Thread parameters
+)
+{
+    BenchThread_t* benchPtr = (BenchThread_t*)ctxPtr;
+
+    if (!RunPairs(benchPtr->size, benchPtr->pairNb, benchPtr->isAccounted))
+    {
+        return ctxPtr;
+    }
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Measure the time of an allocation and release pair
+ *
+ * @return
+ *  - time in nanoseconds, negative in case of failure
+ */
+//--------------------------------------------------------------------------------------------------
+static double MeasurePair
+(
+    size_t size,            ///< [IN] Block size
+    int    pairNb,          ///< [IN] Number of allocation and release pairs per thread
+    int    threadNb,        ///< [IN] Number of threads
+    bool   isAccounted      ///< [IN] Use the accounting allocator
+)
+{
+    BenchThread_t threads[THREAD_MAX_NB];
+    bool result = true;
+    double startNs;
+    int i;
+
+    startNs = GetTimeNs();
+    for (i = 0; i < threadNb; i++)
+    {
+        threads[i].size = size;
+        threads[i].pairNb = pairNb;
+        threads[i].isAccounted = isAccounted;
+        if (0 != pthread_create(&threads[i].thread, NULL, BenchThread, &threads[i]))
+        {
+            threadNb = i;
+            result = false;
+            break;
+        }
+    }
+
+    for (i = 0; i < threadNb; i++)
+    {
+        void* retPtr = NULL;
+
+        pthread_join(threads[i].thread, &retPtr);
+        if (NULL != retPtr)
+        {
+            result = false;
+        }
+    }
+
+    if (!result)
+    {
+        return -1;
+    }
+
+    return (GetTimeNs() - startNs) / ((double)pairNb * threadNb);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Measure the overhead of the accounting allocator and check the statistics
+ *
+ * @return
+ *  - true on success
+ */
+//--------------------------------------------------------------------------------------------------
+static bool MeasureOverhead
+(
+    int pairNb,         ///< [IN] Number of allocation and release pairs per thread
+    int threadNb        ///< [IN] Number of threads
+)
+{
+    lwm2mcore_HeapStats_t before;
+    lwm2mcore_HeapStats_t after;
+    size_t i;
+
+    printf("\n%d thread(s), %d pairs per thread\n", threadNb, pairNb);
+    printf("%-10s %16s %16s %10s\n", "Size", "malloc (ns)", "accounted (ns)", "Overhead");
+
+    for (i = 0; i < (sizeof(BlockSizes) / sizeof(BlockSizes[0])); i++)
+    {
+        double mallocNs;
+        double accountedNs;
+
+        lwm2mcore_ResetHeapStats();
+        if (LWM2MCORE_ERR_COMPLETED_OK != lwm2mcore_GetHeapStats(BENCH_TAG, &before))
+        {
+            printf("The heap accounting is not enabled\n");
+            return false;
+        }
+
+        mallocNs = MeasurePair(BlockSizes[i], pairNb, threadNb, false);
+        accountedNs = MeasurePair(BlockSizes[i], pairNb, threadNb, true);
+        if ((0 > mallocNs) || (0 > accountedNs))
+        {
+            printf("Allocation failure\n");
+            return false;
+        }
+
+        lwm2mcore_GetHeapStats(BENCH_TAG, &after);
+        if (   (before.currentBytes != after.currentBytes)
+            || (before.currentNb != after.currentNb)
+            || ((uint32_t)(pairNb * threadNb) != after.allocNb)
+            || (after.allocNb != after.freeNb)
+            || ((before.currentBytes + (BlockSizes[i] * BATCH_NB)) > after.peakBytes))
+        {
+            printf("Inconsistent heap statistics: %llu bytes, %u blocks, %u allocations, "\
+                   "%u releases, peak %llu bytes\n",
+                   (unsigned long long)after.currentBytes, after.currentNb, after.allocNb,
+                   after.freeNb, (unsigned long long)after.peakBytes);
+            return false;
+        }
+
+        printf("%-10zu %16.1f %16.1f %9.1f%%\n",
+               BlockSizes[i], mallocNs, accountedNs, ((accountedNs - mallocNs) * 100) / mallocNs);
+    }
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Print the usage of the benchmark
+ */
+//--------------------------------------------------------------------------------------------------
+static void PrintUsage
+(
+    const char* namePtr     ///< [IN] Program name
+)
+{
+    printf("Usage: %s [-n <pairs>] [-t <threads>]\n", namePtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Heap accounting benchmark
+ *
+ * @return
+ *  - EXIT_SUCCESS on success
+ *  - EXIT_FAILURE on failure
+ */
+//--------------------------------------------------------------------------------------------------
+int main
+(
+    int   argc,     ///< [IN] Number of arguments
+    char* argv[]    ///< [IN] Arguments
+)
+{
+    int pairNb = 1000000;
+    int threadNb = 4;
+    int opt;
+
+    while (-1 != (opt = getopt(argc, argv, "n:t:")))
+    {
+        switch (opt)
+        {
+            case 'n':
+                pairNb = atoi(optarg);
+                break;
+
+            case 't':
+                threadNb = atoi(optarg);
+                break;
+
+            default:
+                PrintUsage(argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+
+    if ((0 >= pairNb) || (0 >= threadNb) || (THREAD_MAX_NB < threadNb))
+    {
+        PrintUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    printf("\n======== Heap accounting benchmark ========\n");
+
+    if ((!MeasureOverhead(pairNb, 1)) || ((1 < threadNb) && (!MeasureOverhead(pairNb, threadNb))))
+    {
+        printf("Heap accounting benchmark failed\n");
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
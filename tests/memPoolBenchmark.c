@@ -0,0 +1,585 @@
+/**
+ * @file memPoolBenchmark.c
+ *
+ * Benchmark of the size-class block pools of the Linux platform (examples/linux/memPool.c).
+ *
+ * The throughput measurement allocates and releases blocks of the hot allocation sizes of the
+ * core (registration and observation structures, CoAP options, URIs) in random order, with the C
+ * library and with the size classes falling back on the C library as lwm2m_malloc does, with one
+ * thread and with several threads.
+ *
+ * The fragmentation measurement simulates a long uptime: short-lived blocks of the hot sizes are
+ * interleaved with long-lived buffers of variable sizes, then the short-lived blocks are released
+ * and the heap state is reported. Each allocator runs in its own process to start from a clean
+ * heap.
+ *
+ * Usage: mempoolbenchmark [options]
+ *  -n <operations> Number of allocations or releases per thread (default: 2000000)
+ *  -t <threads>    Number of threads of the concurrent measurement (default: 4)
+ *  -c <cycles>     Number of cycles of the fragmentation measurement (default: 200000)
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#include <malloc.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "memPool.h"
+
+//--------------------------------------------------------------------------------------------------
+// Symbol and Enum definitions
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of blocks which can be allocated at the same time by a measurement thread
+ */
+//--------------------------------------------------------------------------------------------------
+#define LIVE_NB                 256
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of long-lived buffers of the fragmentation measurement
+ */
+//--------------------------------------------------------------------------------------------------
+#define LONG_LIVED_NB           64
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of threads
+ */
+//--------------------------------------------------------------------------------------------------
+#define THREAD_MAX_NB           64
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parameters of a measurement thread
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    int         opNb;           ///< Number of allocations or releases
+    bool        isPooled;       ///< Use the size classes
+    uint32_t    seed;           ///< Random generator seed
+    pthread_t   thread;         ///< Thread
+}
+BenchThread_t;
+
+//--------------------------------------------------------------------------------------------------
+// Static variables
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Hot allocation sizes of the core
+ */
+//--------------------------------------------------------------------------------------------------
+static const size_t HotSizes[] = {16, 24, 40, 48, 64, 96, 128, 200, 256};
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Block sizes of the size classes
+ */
+//--------------------------------------------------------------------------------------------------
+static const size_t ClassSizes[] = {32, 64, 128, 256};
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sink preventing the compiler from removing the allocations
+ */
+//--------------------------------------------------------------------------------------------------
+static volatile uintptr_t Sink;
+
+//--------------------------------------------------------------------------------------------------
+// Static functions
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the monotonic time, in nanoseconds
+ */
+//--------------------------------------------------------------------------------------------------
+static double GetTimeNs
+(
+    void
+)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((double)ts.tv_sec * 1e9) + (double)ts.tv_nsec;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Xorshift random generator
+ *
+ * @return
+ *  - Random value
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t Random
+(
+    uint32_t* seedPtr       ///< [INOUT] Generator state
+)
+{
+    uint32_t x = *seedPtr;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *seedPtr = x;
+    return x;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Allocate a block, from the size classes if requested, as lwm2m_malloc does
+ *
+ * @return
+ *  - Block address, NULL in case of allocation failure
+ */
+//--------------------------------------------------------------------------------------------------
+static void* Alloc
+(
+    size_t size,            ///< [IN] Block size
+    bool   isPooled         ///< [IN] Use the size classes
+)
+{
+    void* blockPtr = NULL;
+
+    if (isPooled)
+    {
+        blockPtr = MemPoolSizeClassAlloc(size);
+    }
+    if (!blockPtr)
+    {
+        blockPtr = malloc(size);
+    }
+    return blockPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Release a block, as lwm2m_free does
+ */
+//--------------------------------------------------------------------------------------------------
+static void Release
+(
+    void* blockPtr,         ///< [IN] Block address
+    bool  isPooled          ///< [IN] Use the size classes
+)
+{
+    if ((!isPooled) || (!MemPoolSizeClassRelease(blockPtr)))
+    {
+        free(blockPtr);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Measurement thread: allocate or release a random block of the live set
+ */
+//--------------------------------------------------------------------------------------------------
+static void* BenchThread
+(
+    void* ctxPtr    ///< [IN] Thread parameters
+)
+{
+    BenchThread_t* benchPtr = (BenchThread_t*)ctxPtr;
+    void* blocks[LIVE_NB];
+    uintptr_t sum = 0;
+    void* retPtr = NULL;
+    int i;
+
+    memset(blocks, 0, sizeof(blocks));
+
+    for (i = 0; i < benchPtr->opNb; i++)
+    {
+        uint32_t value = Random(&benchPtr->seed);
+        void** slotPtr = &blocks[value % LIVE_NB];
+
+        if (*slotPtr)
+        {
+            Release(*slotPtr, benchPtr->isPooled);
+            *slotPtr = NULL;
+        }
+        else
+        {
+            size_t size = HotSizes[(value >> 16) % (sizeof(HotSizes) / sizeof(HotSizes[0]))];
+
+            *slotPtr = Alloc(size, benchPtr->isPooled);
+            if (!*slotPtr)
+            {
+                retPtr = ctxPtr;
+                break;
+            }
+            *(volatile uint8_t*)*slotPtr = (uint8_t)i;
+            sum += (uintptr_t)*slotPtr;
+        }
+    }
+
+    for (i = 0; i < LIVE_NB; i++)
+    {
+        if (blocks[i])
+        {
+            Release(blocks[i], benchPtr->isPooled);
+        }
+    }
+
+    Sink = sum;
+    return retPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Measure the time of an allocation or a release
+ *
+ * @return
+ *  - time in nanoseconds, negative in case of failure
+ */
+//--------------------------------------------------------------------------------------------------
+static double MeasureOperation
+(
+    int  opNb,              ///< [IN] Number of operations per thread
+    int  threadNb,          ///< [IN] Number of threads
+    bool isPooled           ///< [IN] Use the size classes
+)
+{
+    BenchThread_t threads[THREAD_MAX_NB];
+    bool result = true;
+    double startNs;
+    int i;
+
+    startNs = GetTimeNs();
+    for (i = 0; i < threadNb; i++)
+    {
+        threads[i].opNb = opNb;
+        threads[i].isPooled = isPooled;
+        threads[i].seed = 0x9E3779B9u * (uint32_t)(i + 1);
+        if (0 != pthread_create(&threads[i].thread, NULL, BenchThread, &threads[i]))
+        {
+            threadNb = i;
+            result = false;
+            break;
+        }
+    }
+
+    for (i = 0; i < threadNb; i++)
+    {
+        void* retPtr = NULL;
+
+        pthread_join(threads[i].thread, &retPtr);
+        if (NULL != retPtr)
+        {
+            result = false;
+        }
+    }
+
+    if (!result)
+    {
+        return -1;
+    }
+
+    return (GetTimeNs() - startNs) / ((double)opNb * threadNb);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create the size classes, large enough for the live sets of all the threads
+ *
+ * @return
+ *  - true on success
+ */
+//--------------------------------------------------------------------------------------------------
+static bool CreateSizeClasses
+(
+    uint32_t blockNb        ///< [IN] Number of blocks per size class
+)
+{
+    MemPoolConfig_t configs[sizeof(ClassSizes) / sizeof(ClassSizes[0])];
+    size_t i;
+
+    for (i = 0; i < (sizeof(ClassSizes) / sizeof(ClassSizes[0])); i++)
+    {
+        configs[i].blockSize = ClassSizes[i];
+        configs[i].blockNb = blockNb;
+    }
+
+    return MemPoolSetSizeClasses(configs, sizeof(configs) / sizeof(configs[0]));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Measure the throughput of the size classes and check their statistics
+ *
+ * @return
+ *  - true on success
+ */
+//--------------------------------------------------------------------------------------------------
+static bool MeasureThroughput
+(
+    int opNb,           ///< [IN] Number of operations per thread
+    int threadNb        ///< [IN] Number of threads
+)
+{
+    MemPoolStats_t stats;
+    double mallocNs;
+    double pooledNs;
+    size_t i;
+
+    if (!CreateSizeClasses((uint32_t)(threadNb * LIVE_NB)))
+    {
+        printf("Failed to create the size classes\n");
+        return false;
+    }
+
+    mallocNs = MeasureOperation(opNb, threadNb, false);
+    pooledNs = MeasureOperation(opNb, threadNb, true);
+    if ((0 > mallocNs) || (0 > pooledNs))
+    {
+        printf("Allocation failure\n");
+        return false;
+    }
+
+    printf("\n%d thread(s), %d operations per thread\n", threadNb, opNb);
+    printf("%-16s %10.1f ns per operation\n", "malloc", mallocNs);
+    printf("%-16s %10.1f ns per operation (%+.1f%%)\n",
+           "size classes", pooledNs, ((pooledNs - mallocNs) * 100) / mallocNs);
+
+    for (i = 0; MemPoolGetSizeClassStats(i, &stats); i++)
+    {
+        if ((0 != stats.usedNb) || (0 != stats.exhaustedNb))
+        {
+            printf("Inconsistent statistics of the %zu bytes class: %u used, %u exhausted\n",
+                   stats.blockSize, stats.usedNb, stats.exhaustedNb);
+            return false;
+        }
+        printf("  class %4zu bytes: %10u allocations, peak %u/%u blocks\n",
+               stats.blockSize, stats.allocNb, stats.peakUsedNb, stats.blockNb);
+    }
+
+    return MemPoolSetSizeClasses(NULL, 0);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Simulate a long uptime and report the heap state. This function runs in a child process.
+ *
+ * @return
+ *  - true on success
+ */
+//--------------------------------------------------------------------------------------------------
+static bool RunUptime
+(
+    int  cycleNb,           ///< [IN] Number of cycles
+    bool isPooled           ///< [IN] Use the size classes
+)
+{
+    void* shortLived[LIVE_NB];
+    void* longLived[LONG_LIVED_NB];
+    uint32_t seed = 0x2545F491u;
+    size_t poolBytes = 0;
+    MemPoolStats_t stats;
+    int i;
+
+    memset(shortLived, 0, sizeof(shortLived));
+    memset(longLived, 0, sizeof(longLived));
+
+    if ((isPooled) && (!CreateSizeClasses(LIVE_NB)))
+    {
+        return false;
+    }
+
+    for (i = 0; i < cycleNb; i++)
+    {
+        uint32_t value = Random(&seed);
+        void** slotPtr = &shortLived[value % LIVE_NB];
+
+        if (*slotPtr)
+        {
+            Release(*slotPtr, isPooled);
+        }
+        *slotPtr = Alloc(HotSizes[(value >> 8) % (sizeof(HotSizes) / sizeof(HotSizes[0]))],
+                         isPooled);
+
+        // From time to time, a long-lived buffer (payload, package chunk, ...) is replaced
+        if (0 == ((value >> 16) % 16))
+        {
+            slotPtr = &longLived[(value >> 20) % LONG_LIVED_NB];
+            if (*slotPtr)
+            {
+                Release(*slotPtr, isPooled);
+            }
+            *slotPtr = Alloc(300 + (Random(&seed) % 3800), isPooled);
+        }
+    }
+
+    for (i = 0; i < LIVE_NB; i++)
+    {
+        if (shortLived[i])
+        {
+            Release(shortLived[i], isPooled);
+        }
+    }
+
+    for (i = 0; MemPoolGetSizeClassStats((size_t)i, &stats); i++)
+    {
+        poolBytes += stats.blockSize * stats.blockNb;
+    }
+
+#if defined(__GLIBC__) && ((__GLIBC__ > 2) || (__GLIBC_MINOR__ >= 33))
+    {
+        struct mallinfo2 info;
+
+        /* mallinfo2() returns a structure: the warning of the test build is disabled for it only */
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Waggregate-return"
+        info = mallinfo2();
+#pragma GCC diagnostic pop
+
+        printf("%-16s %12zu %12zu %12zu %12zu\n",
+               isPooled ? "size classes" : "malloc",
+               info.arena, info.uordblks - poolBytes, info.fordblks, poolBytes);
+    }
+#else
+    printf("%-16s heap statistics not available\n", isPooled ? "size classes" : "malloc");
+#endif
+
+    for (i = 0; i < LONG_LIVED_NB; i++)
+    {
+        if (longLived[i])
+        {
+            Release(longLived[i], isPooled);
+        }
+    }
+
+    return (!isPooled) || MemPoolSetSizeClasses(NULL, 0);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Measure the heap fragmentation after a long uptime, for each allocator
+ *
+ * @return
+ *  - true on success
+ */
+//--------------------------------------------------------------------------------------------------
+static bool MeasureFragmentation
+(
+    int cycleNb             ///< [IN] Number of cycles
+)
+{
+    int mode;
+
+    printf("\nUptime of %d cycles, %d long-lived buffers kept\n", cycleNb, LONG_LIVED_NB);
+    printf("%-16s %12s %12s %12s %12s\n", "Allocator", "Heap", "In use", "Free", "Pools");
+
+    for (mode = 0; mode < 2; mode++)
+    {
+        int status;
+        pid_t pid;
+
+        fflush(stdout);
+        pid = fork();
+        if (0 > pid)
+        {
+            return false;
+        }
+        if (0 == pid)
+        {
+            bool result = RunUptime(cycleNb, (1 == mode));
+
+            fflush(stdout);
+            _exit(result ? EXIT_SUCCESS : EXIT_FAILURE);
+        }
+
+        if ((pid != waitpid(pid, &status, 0)) || (!WIFEXITED(status))
+         || (EXIT_SUCCESS != WEXITSTATUS(status)))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Print the usage of the benchmark
+ */
+//--------------------------------------------------------------------------------------------------
+static void PrintUsage
+(
+    const char* namePtr     ///< [IN] Program name
+)
+{
+    printf("Usage: %s [-n <operations>] [-t <threads>] [-c <cycles>]\n", namePtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Block pool benchmark
+ *
+ * @return
+ *  - EXIT_SUCCESS on success
+ *  - EXIT_FAILURE on failure
+ */
+//--------------------------------------------------------------------------------------------------
+int main
+(
+    int   argc,     ///< [IN] Number of arguments
+    char* argv[]    ///< [IN] Arguments
+)
+{
+    int opNb = 2000000;
+    int threadNb = 4;
+    int cycleNb = 200000;
+    int opt;
+
+    while (-1 != (opt = getopt(argc, argv, "n:t:c:")))
+    {
+        switch (opt)
+        {
+            case 'n':
+                opNb = atoi(optarg);
+                break;
+
+            case 't':
+                threadNb = atoi(optarg);
+                break;
+
+            case 'c':
+                cycleNb = atoi(optarg);
+                break;
+
+            default:
+                PrintUsage(argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+
+    if ((0 >= opNb) || (0 >= threadNb) || (THREAD_MAX_NB < threadNb) || (0 >= cycleNb))
+    {
+        PrintUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    printf("\n======== Block pool benchmark ========\n");
+
+    if ((!MeasureThroughput(opNb, 1))
+     || ((1 < threadNb) && (!MeasureThroughput(opNb, threadNb)))
+     || (!MeasureFragmentation(cycleNb)))
+    {
+        printf("Block pool benchmark failed\n");
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,671 @@
+/**
+ * @file paramStorageBenchmark.c
+ *
+ * Benchmark of the Linux parameter store (examples/linux/paramStorage.c).
+ *
+ * Three measurements are done:
+ *  - write and read latency of a parameter, compared with the former storage of the parameters in
+ *    a configN.txt and configN.bak file pair per parameter,
+ *  - startup load time of the store, after a compaction and with the largest amount of obsolete
+ *    records the store can contain,
+ *  - crash consistency: a child process continuously updating a parameter is killed at a random
+ *    time, and the parameter read after the reload of the store should be the last value
+ *    acknowledged by the child or the value being written.
+ *
+ * Usage: paramstoragebenchmark [options]
+ *  -s <len>        Parameter value length, with an optional K suffix (default: 1K)
+ *  -n <writes>     Number of writes and reads for the latency measurement (default: 1000)
+ *  -k <crashes>    Number of crash iterations (default: 100, 0 to skip)
+ *  -f <file>       Store file (default: paramStoreBench.db, removed at the end)
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <lwm2mcore/lwm2mcore.h>
+#include <lwm2mcore/paramStorage.h>
+#include "paramStore.h"
+
+//--------------------------------------------------------------------------------------------------
+// Symbol and Enum definitions
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Legacy configuration filename prefix
+ */
+//--------------------------------------------------------------------------------------------------
+#define LEGACY_FILENAME         "paramStoreBench"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of runs of the startup load measurement, the best one is kept
+ */
+//--------------------------------------------------------------------------------------------------
+#define LOAD_RUNS               5
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Crash test parameter
+ */
+//--------------------------------------------------------------------------------------------------
+#define CRASH_PARAM             LWM2MCORE_DWL_WORKSPACE_PARAM
+
+//--------------------------------------------------------------------------------------------------
+// Static functions
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the monotonic time, in microseconds
+ */
+//--------------------------------------------------------------------------------------------------
+static double GetTimeUs
+(
+    void
+)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((double)ts.tv_sec * 1e6) + ((double)ts.tv_nsec / 1e3);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compare two latencies, for qsort
+ */
+//--------------------------------------------------------------------------------------------------
+static int CompareLatencies
+(
+    const void* aPtr,       ///< [IN] First latency
+    const void* bPtr        ///< [IN] Second latency
+)
+{
+    double a = *(const double*)aPtr;
+    double b = *(const double*)bPtr;
+
+    return (a > b) - (a < b);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Print the statistics of a latency series
+ */
+//--------------------------------------------------------------------------------------------------
+static void PrintLatencies
+(
+    const char* namePtr,        ///< [IN] Series name
+    double*     latenciesPtr,   ///< [IN] Latencies, in microseconds (sorted by the function)
+    int         nb              ///< [IN] Number of latencies
+)
+{
+    double sum = 0;
+    int i;
+
+    qsort(latenciesPtr, (size_t)nb, sizeof(double), CompareLatencies);
+    for (i = 0; i < nb; i++)
+    {
+        sum += latenciesPtr[i];
+    }
+
+    printf("%-24s %10.1f %10.1f %10.1f %10.1f\n",
+           namePtr,
+           sum / nb,
+           latenciesPtr[nb / 2],
+           latenciesPtr[(nb * 99) / 100],
+           latenciesPtr[nb - 1]);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fill a parameter value: the value starts with its sequence number
+ */
+//--------------------------------------------------------------------------------------------------
+static void FillValue
+(
+    uint8_t* bufPtr,    ///< [OUT] Value buffer
+    size_t   len,       ///< [IN] Value length (at least 4 bytes)
+    uint32_t seq        ///< [IN] Sequence number
+)
+{
+    size_t i;
+
+    memcpy(bufPtr, &seq, sizeof(seq));
+    for (i = sizeof(seq); i < len; i++)
+    {
+        bufPtr[i] = (uint8_t)(seq + i);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check a parameter value
+ *
+ * @return
+ *  - true  The value is consistent, its sequence number is returned
+ *  - false The value is corrupted
+ */
+//--------------------------------------------------------------------------------------------------
+static bool CheckValue
+(
+    const uint8_t* bufPtr,  ///< [IN] Value
+    size_t         len,     ///< [IN] Value length
+    uint32_t*      seqPtr   ///< [OUT] Sequence number
+)
+{
+    size_t i;
+
+    if (sizeof(*seqPtr) > len)
+    {
+        return false;
+    }
+    memcpy(seqPtr, bufPtr, sizeof(*seqPtr));
+    for (i = sizeof(*seqPtr); i < len; i++)
+    {
+        if ((uint8_t)(*seqPtr + i) != bufPtr[i])
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a parameter as the former implementation: the value is written in two files, without
+ * synchronization
+ *
+ * @return
+ *  - true  The parameter is written
+ *  - false The parameter can't be written
+ */
+//--------------------------------------------------------------------------------------------------
+static bool LegacySetParam
+(
+    lwm2mcore_Param_t paramId,      ///< [IN] Parameter Id
+    const uint8_t*    bufferPtr,    ///< [IN] Value
+    size_t            len           ///< [IN] Value length
+)
+{
+    const char* extensions[2] = { "txt", "bak" };
+    int i;
+
+    for (i = 0; i < 2; i++)
+    {
+        char fname[64];
+        FILE* fPtr;
+
+        snprintf(fname, sizeof(fname), "%s%d.%s", LEGACY_FILENAME, paramId, extensions[i]);
+        fPtr = fopen(fname, "w");
+        if (NULL == fPtr)
+        {
+            return false;
+        }
+        if (len != fwrite(bufferPtr, 1, len, fPtr))
+        {
+            fclose(fPtr);
+            return false;
+        }
+        fclose(fPtr);
+    }
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read a parameter as the former implementation
+ *
+ * @return
+ *  - true  The parameter is read
+ *  - false The parameter can't be read
+ */
+//--------------------------------------------------------------------------------------------------
+static bool LegacyGetParam
+(
+    lwm2mcore_Param_t paramId,      ///< [IN] Parameter Id
+    uint8_t*          bufferPtr,    ///< [OUT] Value
+    size_t*           lenPtr        ///< [INOUT] Value length
+)
+{
+    char fname[64];
+    FILE* fPtr;
+
+    snprintf(fname, sizeof(fname), "%s%d.txt", LEGACY_FILENAME, paramId);
+    fPtr = fopen(fname, "r");
+    if (NULL == fPtr)
+    {
+        return false;
+    }
+    *lenPtr = fread(bufferPtr, 1, *lenPtr, fPtr);
+    fclose(fPtr);
+
+    return (0 != *lenPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove the legacy files
+ */
+//--------------------------------------------------------------------------------------------------
+static void LegacyRemoveFiles
+(
+    void
+)
+{
+    char fname[64];
+
+    snprintf(fname, sizeof(fname), "%s%d.txt", LEGACY_FILENAME, CRASH_PARAM);
+    remove(fname);
+    snprintf(fname, sizeof(fname), "%s%d.bak", LEGACY_FILENAME, CRASH_PARAM);
+    remove(fname);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Measure the write and read latencies
+ *
+ * @return
+ *  - true  The measurement is done
+ *  - false A write or a read failed
+ */
+//--------------------------------------------------------------------------------------------------
+static bool MeasureLatencies
+(
+    const char* fileNamePtr,    ///< [IN] Store file
+    size_t      valueLen,       ///< [IN] Value length
+    int         writeNb         ///< [IN] Number of writes and reads
+)
+{
+    double* latenciesPtr = (double*)malloc(sizeof(double) * (size_t)writeNb);
+    uint8_t* valuePtr = (uint8_t*)malloc(valueLen);
+    bool result = true;
+    int method;
+
+    if ((!latenciesPtr) || (!valuePtr))
+    {
+        free(latenciesPtr);
+        free(valuePtr);
+        return false;
+    }
+
+    remove(fileNamePtr);
+    if (LWM2MCORE_ERR_COMPLETED_OK != ParamStoreOpen(fileNamePtr))
+    {
+        free(latenciesPtr);
+        free(valuePtr);
+        return false;
+    }
+
+    printf("\n%d writes and reads of a %zu-byte parameter (microseconds)\n", writeNb, valueLen);
+    printf("%-24s %10s %10s %10s %10s\n", "", "mean", "p50", "p99", "max");
+
+    for (method = 0; (result) && (method < 4); method++)
+    {
+        bool isLegacy = (0 == (method % 2));
+        bool isWrite = (2 > method);
+        int i;
+
+        for (i = 0; (result) && (i < writeNb); i++)
+        {
+            size_t len = valueLen;
+            double startTime;
+
+            if (isWrite)
+            {
+                FillValue(valuePtr, valueLen, (uint32_t)i);
+            }
+            startTime = GetTimeUs();
+            if (isWrite)
+            {
+                result = isLegacy ? LegacySetParam(CRASH_PARAM, valuePtr, valueLen) :
+                         (LWM2MCORE_ERR_COMPLETED_OK == lwm2mcore_SetParam(CRASH_PARAM,
+                                                                          valuePtr,
+                                                                          valueLen));
+            }
+            else
+            {
+                result = isLegacy ? LegacyGetParam(CRASH_PARAM, valuePtr, &len) :
+                         (LWM2MCORE_ERR_COMPLETED_OK == lwm2mcore_GetParam(CRASH_PARAM,
+                                                                          valuePtr,
+                                                                          &len));
+            }
+            latenciesPtr[i] = GetTimeUs() - startTime;
+        }
+
+        if (result)
+        {
+            PrintLatencies(isLegacy ? (isWrite ? "legacy write (no sync)" : "legacy read") :
+                                      (isWrite ? "store write (synced)" : "store read"),
+                           latenciesPtr,
+                           writeNb);
+        }
+    }
+
+    ParamStoreClose();
+    LegacyRemoveFiles();
+    free(latenciesPtr);
+    free(valuePtr);
+
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Measure the startup load time of the store, the best of LOAD_RUNS runs being kept
+ */
+//--------------------------------------------------------------------------------------------------
+static void MeasureLoad
+(
+    const char* fileNamePtr,    ///< [IN] Store file
+    const char* namePtr         ///< [IN] Measurement name
+)
+{
+    ParamStoreStats_t stats;
+    double bestTime = 0;
+    int run;
+
+    for (run = 0; run < LOAD_RUNS; run++)
+    {
+        double startTime;
+        double elapsedTime;
+
+        ParamStoreClose();
+        startTime = GetTimeUs();
+        ParamStoreOpen(fileNamePtr);
+        elapsedTime = GetTimeUs() - startTime;
+        if ((0 == run) || (elapsedTime < bestTime))
+        {
+            bestTime = elapsedTime;
+        }
+    }
+
+    ParamStoreGetStats(&stats);
+    printf("%-24s %10llu %10u %10.1f\n",
+           namePtr,
+           (unsigned long long)stats.fileLen,
+           stats.recordNb,
+           bestTime);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Measure the startup load time of a compacted store and of a store containing the largest
+ * amount of obsolete records
+ *
+ * @return
+ *  - true  The measurement is done
+ *  - false A write failed
+ */
+//--------------------------------------------------------------------------------------------------
+static bool MeasureLoadTimes
+(
+    const char* fileNamePtr,    ///< [IN] Store file
+    size_t      valueLen        ///< [IN] Value length
+)
+{
+    ParamStoreStats_t stats;
+    uint8_t* valuePtr = (uint8_t*)malloc(valueLen);
+    uint32_t seq = 0;
+
+    remove(fileNamePtr);
+    if ((!valuePtr) || (LWM2MCORE_ERR_COMPLETED_OK != ParamStoreOpen(fileNamePtr)))
+    {
+        free(valuePtr);
+        return false;
+    }
+
+    printf("\nStartup load time of the store\n");
+    printf("%-24s %10s %10s %10s\n", "", "bytes", "records", "us");
+
+    // Fill the store just below the compaction done on the write path
+    do
+    {
+        FillValue(valuePtr, valueLen, seq++);
+        if (LWM2MCORE_ERR_COMPLETED_OK != lwm2mcore_SetParam(CRASH_PARAM, valuePtr, valueLen))
+        {
+            free(valuePtr);
+            return false;
+        }
+        ParamStoreGetStats(&stats);
+    }
+    while ((stats.deadLen + (2 * valueLen)) < PARAM_STORE_COMPACT_MAX_DEAD_LEN);
+    free(valuePtr);
+
+    MeasureLoad(fileNamePtr, "largest store");
+    ParamStoreCompact();
+    MeasureLoad(fileNamePtr, "compacted store");
+    ParamStoreClose();
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Kill a process continuously updating a parameter, and check the parameter after the reload of
+ * the store
+ *
+ * @return
+ *  - true  All the crash iterations recovered a consistent parameter
+ *  - false A corrupted or lost parameter was read
+ */
+//--------------------------------------------------------------------------------------------------
+static bool TestCrashes
+(
+    const char* fileNamePtr,    ///< [IN] Store file
+    size_t      valueLen,       ///< [IN] Value length
+    int         crashNb         ///< [IN] Number of crash iterations
+)
+{
+    uint8_t* valuePtr = (uint8_t*)malloc(valueLen);
+    uint32_t ackNb = 0;
+    uint32_t inFlightNb = 0;
+    uint32_t discardedNb = 0;
+    uint32_t seq = 0;
+    int i;
+
+    remove(fileNamePtr);
+    if (   (!valuePtr)
+        || (LWM2MCORE_ERR_COMPLETED_OK != ParamStoreOpen(fileNamePtr))
+       )
+    {
+        free(valuePtr);
+        return false;
+    }
+    FillValue(valuePtr, valueLen, seq);
+    if (LWM2MCORE_ERR_COMPLETED_OK != lwm2mcore_SetParam(CRASH_PARAM, valuePtr, valueLen))
+    {
+        free(valuePtr);
+        return false;
+    }
+    ParamStoreClose();
+
+    srand((unsigned int)time(NULL));
+    for (i = 0; i < crashNb; i++)
+    {
+        ParamStoreStats_t stats;
+        uint32_t ackSeq = seq;
+        size_t len = valueLen;
+        int pipeFds[2];
+        pid_t pid;
+
+        if (0 != pipe(pipeFds))
+        {
+            free(valuePtr);
+            return false;
+        }
+
+        pid = fork();
+        if (0 == pid)
+        {
+            close(pipeFds[0]);
+            if (LWM2MCORE_ERR_COMPLETED_OK != ParamStoreOpen(fileNamePtr))
+            {
+                _exit(EXIT_FAILURE);
+            }
+            for (seq++; ; seq++)
+            {
+                FillValue(valuePtr, valueLen, seq);
+                if (   (LWM2MCORE_ERR_COMPLETED_OK != lwm2mcore_SetParam(CRASH_PARAM,
+                                                                          valuePtr,
+                                                                          valueLen))
+                    || (sizeof(seq) != write(pipeFds[1], &seq, sizeof(seq)))
+                   )
+                {
+                    _exit(EXIT_FAILURE);
+                }
+            }
+        }
+
+        close(pipeFds[1]);
+        if (0 > pid)
+        {
+            close(pipeFds[0]);
+            free(valuePtr);
+            return false;
+        }
+
+        usleep((useconds_t)(1000 + (rand() % 20000)));
+        kill(pid, SIGKILL);
+        waitpid(pid, NULL, 0);
+        while (sizeof(seq) == read(pipeFds[0], &seq, sizeof(seq)))
+        {
+            ackSeq = seq;
+        }
+        close(pipeFds[0]);
+
+        if (   (LWM2MCORE_ERR_COMPLETED_OK != ParamStoreOpen(fileNamePtr))
+            || (LWM2MCORE_ERR_COMPLETED_OK != lwm2mcore_GetParam(CRASH_PARAM, valuePtr, &len))
+            || (len != valueLen)
+            || (!CheckValue(valuePtr, len, &seq))
+            || ((seq != ackSeq) && (seq != (ackSeq + 1)))
+           )
+        {
+            printf("Crash %d: inconsistent parameter (last acknowledged value %u)\n", i, ackSeq);
+            ParamStoreClose();
+            free(valuePtr);
+            return false;
+        }
+
+        ParamStoreGetStats(&stats);
+        if (seq == ackSeq)
+        {
+            ackNb++;
+        }
+        else
+        {
+            inFlightNb++;
+        }
+        if (stats.discardedLen)
+        {
+            discardedNb++;
+        }
+        ParamStoreClose();
+    }
+    free(valuePtr);
+
+    printf("\n%d crashes: all consistent\n", crashNb);
+    printf("  last acknowledged value read:    %u\n", ackNb);
+    printf("  value being written read:        %u\n", inFlightNb);
+    printf("  interrupted record discarded:    %u\n", discardedNb);
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Print the benchmark usage
+ */
+//--------------------------------------------------------------------------------------------------
+static void PrintUsage
+(
+    const char* namePtr     ///< [IN] Program name
+)
+{
+    printf("Usage: %s [-s <value length>] [-n <writes>] [-k <crashes>] [-f <file>]\n", namePtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parameter store benchmark entry point
+ */
+//--------------------------------------------------------------------------------------------------
+int main
+(
+    int   argc,     ///< [IN] Number of arguments
+    char* argv[]    ///< [IN] Arguments
+)
+{
+    size_t valueLen = 1024;
+    int writeNb = 1000;
+    int crashNb = 100;
+    const char* fileNamePtr = "paramStoreBench.db";
+    bool result;
+    int opt;
+
+    while (-1 != (opt = getopt(argc, argv, "s:n:k:f:")))
+    {
+        char* endPtr = NULL;
+
+        switch (opt)
+        {
+            case 's':
+                valueLen = (size_t)strtoul(optarg, &endPtr, 0);
+                if (('k' == *endPtr) || ('K' == *endPtr))
+                {
+                    valueLen *= 1024;
+                }
+                break;
+
+            case 'n':
+                writeNb = atoi(optarg);
+                break;
+
+            case 'k':
+                crashNb = atoi(optarg);
+                break;
+
+            case 'f':
+                fileNamePtr = optarg;
+                break;
+
+            default:
+                PrintUsage(argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+
+    if (   (sizeof(uint32_t) > valueLen)
+        || (PARAM_STORE_VALUE_MAX_LEN < valueLen)
+        || (0 >= writeNb)
+        || (0 > crashNb)
+       )
+    {
+        PrintUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    printf("\n======== Parameter store benchmark ========\n");
+
+    result = MeasureLatencies(fileNamePtr, valueLen, writeNb)
+             && MeasureLoadTimes(fileNamePtr, valueLen)
+             && ((0 == crashNb) || TestCrashes(fileNamePtr, valueLen, crashNb));
+    remove(fileNamePtr);
+
+    if (!result)
+    {
+        printf("Parameter store benchmark failed\n");
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,600 @@
+/**
+ * @file pkgDwlBenchmark.c
+ *
+ * Package downloader benchmark.
+ *
+ * A synthetic DWL package is generated (see dwlGenerator.h) and fed to the package downloader
+ * through lwm2mcore_PackageDownloaderRun() and lwm2mcore_PackageDownloaderReceiveData(), with the
+ * Linux porting layer (CRC, SHA1, signature, decompression, workspace storage). The stored data
+ * is checked against the generated binary data.
+ *
+ * For each chunk size, the benchmark reports:
+ *  - the throughput in MB/s
+ *  - the CPU time used per MB of package
+ *  - the number of suspend/resume cycles
+ * The peak resident memory of the process is reported at the end.
+ *
+ * Usage: pkgdwlbenchmark [options]
+ *  -s <len>        Binary data length, with an optional K or M suffix (default: 16M)
+ *  -c <len,...>    Comma-separated list of chunk sizes (default: 1K,4K,16K,64K)
+ *  -z              Compress the binary data with zlib (COMP section instead of BINA)
+ *  -u <len>        Suspend and resume the download every <len> bytes (default: 0, no suspend)
+ *  -n <count>      Number of runs for each chunk size (default: 3)
+ *  -t <fw|sw>      Package type (default: fw)
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <lwm2mcore/lwm2mcore.h>
+#include <lwm2mcore/security.h>
+#include <packageDownloader/lwm2mcorePackageDownloader.h>
+#include "dwlGenerator.h"
+
+//--------------------------------------------------------------------------------------------------
+// Symbol and Enum definitions
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximal number of chunk sizes to benchmark
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_CHUNK_SIZES     16
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of bytes in a MB
+ */
+//--------------------------------------------------------------------------------------------------
+#define BYTES_PER_MB        (1024.0 * 1024.0)
+
+//--------------------------------------------------------------------------------------------------
+// Data structures
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Benchmark context
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    dwlgen_Package_t            package;            ///< Generated DWL package
+    size_t                      chunkLen;           ///< Length of the downloaded data chunks
+    size_t                      suspendLen;         ///< Package length between two suspends
+    size_t                      suspendOffset;      ///< Package offset of the next suspend
+    size_t                      storedLen;          ///< Length of the stored binary data
+    bool                        isSuspended;        ///< Last download was suspended
+    bool                        isStoreError;       ///< Stored data doesn't match the binary data
+    uint32_t                    suspendCount;       ///< Number of suspend/resume cycles
+    lwm2mcore_UpdateType_t      updateType;         ///< FW or SW update
+    int                         updateState;        ///< Last update state
+    int                         updateResult;       ///< Last update result
+}
+Benchmark_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Benchmark result for a chunk size
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    size_t      chunkLen;       ///< Length of the downloaded data chunks
+    double      wallTime;       ///< Best elapsed time of the runs, in seconds
+    double      cpuTime;        ///< CPU time of the best run, in seconds
+    uint32_t    suspendCount;   ///< Number of suspend/resume cycles of a run
+}
+BenchmarkResult_t;
+
+//--------------------------------------------------------------------------------------------------
+// Static variables
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Benchmark context instance
+ */
+//--------------------------------------------------------------------------------------------------
+static Benchmark_t Bench;
+
+//--------------------------------------------------------------------------------------------------
+// Static functions
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the time of the given clock, in seconds
+ */
+//--------------------------------------------------------------------------------------------------
+static double GetTime
+(
+    clockid_t clockId       ///< [IN] Clock
+)
+{
+    struct timespec ts;
+
+    clock_gettime(clockId, &ts);
+    return (double)ts.tv_sec + ((double)ts.tv_nsec / 1e9);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parse a length with an optional K or M suffix
+ *
+ * @return
+ *  - Length
+ *  - 0 if the length is invalid
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t ParseLength
+(
+    const char* strPtr,     ///< [IN] Length string
+    char**      endPtrPtr   ///< [OUT] End of the parsed length
+)
+{
+    unsigned long long len = strtoull(strPtr, endPtrPtr, 0);
+
+    switch (**endPtrPtr)
+    {
+        case 'k':
+        case 'K':
+            len *= 1024;
+            (*endPtrPtr)++;
+            break;
+
+        case 'm':
+        case 'M':
+            len *= 1024 * 1024;
+            (*endPtrPtr)++;
+            break;
+
+        default:
+            break;
+    }
+
+    return (size_t)len;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Package downloader callback: initialize the download
+ */
+//--------------------------------------------------------------------------------------------------
+static lwm2mcore_DwlResult_t InitDownload
+(
+    char* uriPtr,   ///< [IN] URI to use for the download
+    void* ctxPtr    ///< [IN] Context pointer
+)
+{
+    (void)uriPtr;
+    (void)ctxPtr;
+    return DWL_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Package downloader callback: get the package information
+ */
+//--------------------------------------------------------------------------------------------------
+static lwm2mcore_DwlResult_t GetPackageInfo
+(
+    lwm2mcore_PackageDownloaderData_t* dataPtr, ///< [INOUT] Information about the package
+    void* ctxPtr                                ///< [IN] Context pointer
+)
+{
+    (void)ctxPtr;
+    dataPtr->packageSize = Bench.package.packageLen;
+    return DWL_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Package downloader callback: set the firmware update state
+ */
+//--------------------------------------------------------------------------------------------------
+static lwm2mcore_DwlResult_t SetFwUpdateState
+(
+    lwm2mcore_FwUpdateState_t updateState       ///< [IN] New update state
+)
+{
+    Bench.updateState = (int)updateState;
+    return DWL_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Package downloader callback: set the firmware update result
+ */
+//--------------------------------------------------------------------------------------------------
+static lwm2mcore_DwlResult_t SetFwUpdateResult
+(
+    lwm2mcore_FwUpdateResult_t updateResult     ///< [IN] New update result
+)
+{
+    Bench.updateResult = (int)updateResult;
+    return DWL_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Package downloader callback: set the software update state
+ */
+//--------------------------------------------------------------------------------------------------
+static lwm2mcore_DwlResult_t SetSwUpdateState
+(
+    lwm2mcore_SwUpdateState_t updateState       ///< [IN] New update state
+)
+{
+    Bench.updateState = (int)updateState;
+    return DWL_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Package downloader callback: set the software update result
+ */
+//--------------------------------------------------------------------------------------------------
+static lwm2mcore_DwlResult_t SetSwUpdateResult
+(
+    lwm2mcore_SwUpdateResult_t updateResult     ///< [IN] New update result
+)
+{
+    Bench.updateResult = (int)updateResult;
+    return DWL_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Package downloader callback: download the package from the given offset, by chunks.
+ * The download is suspended every time the configured suspend length of the package is reached.
+ * As a resumed compressed binary is downloaded again from its beginning, the suspend offsets are
+ * absolute package offsets.
+ */
+//--------------------------------------------------------------------------------------------------
+static lwm2mcore_DwlResult_t Download
+(
+    uint64_t startOffset,   ///< [IN] Offset indicating where to start the download
+    void* ctxPtr            ///< [IN] Context pointer
+)
+{
+    size_t offset = (size_t)startOffset;
+
+    (void)ctxPtr;
+
+    while (offset < Bench.package.packageLen)
+    {
+        size_t len = Bench.package.packageLen - offset;
+        lwm2mcore_DwlResult_t result;
+
+        if ((Bench.suspendLen) && (offset >= Bench.suspendOffset))
+        {
+            Bench.suspendOffset = offset + Bench.suspendLen;
+            Bench.isSuspended = true;
+            return DWL_SUSPEND;
+        }
+
+        if (len > Bench.chunkLen)
+        {
+            len = Bench.chunkLen;
+        }
+
+        result = lwm2mcore_PackageDownloaderReceiveData(Bench.package.packagePtr + offset, len);
+        if (DWL_OK != result)
+        {
+            return result;
+        }
+        offset += len;
+    }
+
+    return DWL_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Package downloader callback: check the data to store against the generated binary data
+ */
+//--------------------------------------------------------------------------------------------------
+static lwm2mcore_DwlResult_t StoreRange
+(
+    uint8_t* bufPtr,        ///< [IN] Buffer of data to store
+    size_t bufSize,         ///< [IN] Size of buffer to store
+    void* ctxPtr            ///< [IN] Context pointer
+)
+{
+    (void)ctxPtr;
+
+    if (   ((Bench.storedLen + bufSize) > Bench.package.binaryLen)
+        || (0 != memcmp(Bench.package.binaryPtr + Bench.storedLen, bufPtr, bufSize))
+       )
+    {
+        Bench.isStoreError = true;
+        return DWL_FAULT;
+    }
+
+    Bench.storedLen += bufSize;
+    return DWL_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Package downloader callback: end the download
+ */
+//--------------------------------------------------------------------------------------------------
+static lwm2mcore_DwlResult_t EndDownload
+(
+    void* ctxPtr            ///< [IN] Context pointer
+)
+{
+    (void)ctxPtr;
+    return DWL_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Download the whole package once, resuming it after each suspend
+ *
+ * @return
+ *  - true  The package is downloaded, verified and correctly stored
+ *  - false The download failed
+ */
+//--------------------------------------------------------------------------------------------------
+static bool RunDownload
+(
+    void
+)
+{
+    lwm2mcore_PackageDownloader_t pkgDwl;
+    lwm2mcore_DwlResult_t result;
+    bool isDownloaded;
+
+    memset(&pkgDwl, 0, sizeof(pkgDwl));
+    pkgDwl.data.updateType = Bench.updateType;
+    pkgDwl.initDownload = InitDownload;
+    pkgDwl.getInfo = GetPackageInfo;
+    pkgDwl.setFwUpdateState = SetFwUpdateState;
+    pkgDwl.setFwUpdateResult = SetFwUpdateResult;
+    pkgDwl.setSwUpdateState = SetSwUpdateState;
+    pkgDwl.setSwUpdateResult = SetSwUpdateResult;
+    pkgDwl.download = Download;
+    pkgDwl.storeRange = StoreRange;
+    pkgDwl.endDownload = EndDownload;
+
+    Bench.storedLen = 0;
+    Bench.suspendOffset = Bench.suspendLen;
+    Bench.suspendCount = 0;
+    Bench.isStoreError = false;
+    lwm2mcore_PackageDownloaderInit();
+
+    do
+    {
+        size_t previousStoredLen = Bench.storedLen;
+
+        Bench.isSuspended = false;
+        result = lwm2mcore_PackageDownloaderRun(&pkgDwl);
+        if (Bench.isSuspended)
+        {
+            // The download is resumed from the stored data, which should progress between
+            // two suspends
+            if (Bench.storedLen == previousStoredLen)
+            {
+                printf("No data stored before suspend, the suspend length is too small\n");
+                return false;
+            }
+            Bench.suspendCount++;
+            pkgDwl.data.isResume = true;
+            pkgDwl.data.updateOffset = Bench.storedLen;
+        }
+    }
+    while ((DWL_OK == result) && (Bench.isSuspended));
+
+    if (LWM2MCORE_FW_UPDATE_TYPE == Bench.updateType)
+    {
+        isDownloaded = (LWM2MCORE_FW_UPDATE_STATE_DOWNLOADED == Bench.updateState)
+                    && (LWM2MCORE_FW_UPDATE_RESULT_DEFAULT_NORMAL == Bench.updateResult);
+    }
+    else
+    {
+        isDownloaded = (LWM2MCORE_SW_UPDATE_STATE_DOWNLOADED == Bench.updateState)
+                    && (LWM2MCORE_SW_UPDATE_RESULT_INITIAL == Bench.updateResult);
+    }
+
+    if (   (DWL_OK != result)
+        || (!isDownloaded)
+        || (Bench.isStoreError)
+        || (Bench.storedLen != Bench.package.binaryLen)
+       )
+    {
+        printf("Download failed: result %d, update state %d, update result %d, stored %zu/%zu\n",
+               result, Bench.updateState, Bench.updateResult,
+               Bench.storedLen, Bench.package.binaryLen);
+        return false;
+    }
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Print the tool usage
+ */
+//--------------------------------------------------------------------------------------------------
+static void PrintUsage
+(
+    const char* namePtr     ///< [IN] Program name
+)
+{
+    printf("Usage: %s [-s <binary length>] [-c <chunk size,...>] [-z] [-u <suspend length>]\n"
+           "          [-n <runs>] [-t <fw|sw>]\n",
+           namePtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Package downloader benchmark entry point
+ */
+//--------------------------------------------------------------------------------------------------
+int main
+(
+    int   argc,     ///< [IN] Number of arguments
+    char* argv[]    ///< [IN] Arguments
+)
+{
+    dwlgen_Config_t config;
+    BenchmarkResult_t results[MAX_CHUNK_SIZES];
+    size_t chunkLens[MAX_CHUNK_SIZES] = { 1024, 4096, 16384, 65536 };
+    uint32_t chunkCount = 4;
+    uint32_t runCount = 3;
+    struct rusage usage;
+    long initialMaxRss;
+    double packageMb;
+    uint32_t i;
+    uint32_t run;
+    int opt;
+
+    memset(&config, 0, sizeof(config));
+    memset(&Bench, 0, sizeof(Bench));
+    config.binaryLen = 16 * 1024 * 1024;
+    config.seed = 1;
+    Bench.updateType = LWM2MCORE_FW_UPDATE_TYPE;
+
+    while (-1 != (opt = getopt(argc, argv, "s:c:zu:n:t:")))
+    {
+        char* endPtr = optarg;
+
+        switch (opt)
+        {
+            case 's':
+                config.binaryLen = ParseLength(optarg, &endPtr);
+                break;
+
+            case 'c':
+                chunkCount = 0;
+                while ((*endPtr) && (chunkCount < MAX_CHUNK_SIZES))
+                {
+                    chunkLens[chunkCount] = ParseLength(endPtr, &endPtr);
+                    if (!chunkLens[chunkCount])
+                    {
+                        PrintUsage(argv[0]);
+                        return EXIT_FAILURE;
+                    }
+                    chunkCount++;
+                    if (',' == *endPtr)
+                    {
+                        endPtr++;
+                    }
+                }
+                break;
+
+            case 'z':
+                config.isCompressed = true;
+                break;
+
+            case 'u':
+                Bench.suspendLen = ParseLength(optarg, &endPtr);
+                break;
+
+            case 'n':
+                runCount = (uint32_t)strtoul(optarg, NULL, 0);
+                break;
+
+            case 't':
+                Bench.updateType = (0 == strcmp(optarg, "sw")) ? LWM2MCORE_SW_UPDATE_TYPE
+                                                               : LWM2MCORE_FW_UPDATE_TYPE;
+                break;
+
+            default:
+                PrintUsage(argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+
+    if ((!config.binaryLen) || (!chunkCount) || (!runCount))
+    {
+        PrintUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    // Generate the package and use its test key for the signature verification
+    if (!dwlgen_Build(&config, &Bench.package))
+    {
+        printf("Unable to generate the DWL package\n");
+        return EXIT_FAILURE;
+    }
+    if (LWM2MCORE_ERR_COMPLETED_OK != lwm2mcore_SetCredential(
+                                        (LWM2MCORE_FW_UPDATE_TYPE == Bench.updateType) ?
+                                        LWM2MCORE_CREDENTIAL_FW_KEY : LWM2MCORE_CREDENTIAL_SW_KEY,
+                                        LWM2MCORE_BS_SERVER_ID,
+                                        (char*)Bench.package.publicKey,
+                                        Bench.package.publicKeyLen))
+    {
+        printf("Unable to set the package public key\n");
+        dwlgen_Free(&Bench.package);
+        return EXIT_FAILURE;
+    }
+
+    getrusage(RUSAGE_SELF, &usage);
+    initialMaxRss = usage.ru_maxrss;
+    packageMb = (double)Bench.package.packageLen / BYTES_PER_MB;
+
+    for (i = 0; i < chunkCount; i++)
+    {
+        results[i].chunkLen = chunkLens[i];
+        results[i].wallTime = 0;
+        results[i].cpuTime = 0;
+        Bench.chunkLen = chunkLens[i];
+
+        for (run = 0; run < runCount; run++)
+        {
+            double wallStart = GetTime(CLOCK_MONOTONIC);
+            double cpuStart = GetTime(CLOCK_PROCESS_CPUTIME_ID);
+            double wallTime;
+
+            if (!RunDownload())
+            {
+                dwlgen_Free(&Bench.package);
+                return EXIT_FAILURE;
+            }
+
+            wallTime = GetTime(CLOCK_MONOTONIC) - wallStart;
+            if ((0 == run) || (wallTime < results[i].wallTime))
+            {
+                results[i].wallTime = wallTime;
+                results[i].cpuTime = GetTime(CLOCK_PROCESS_CPUTIME_ID) - cpuStart;
+                results[i].suspendCount = Bench.suspendCount;
+            }
+        }
+    }
+
+    getrusage(RUSAGE_SELF, &usage);
+
+    printf("\n======== Package downloader benchmark ========\n");
+    printf("Package: %zu bytes, %s binary data of %zu bytes, %s update, best of %u runs\n",
+           Bench.package.packageLen,
+           config.isCompressed ? "compressed" : "raw",
+           Bench.package.binaryLen,
+           (LWM2MCORE_FW_UPDATE_TYPE == Bench.updateType) ? "FW" : "SW",
+           runCount);
+    printf("%10s %10s %10s %12s %10s\n", "chunk", "time (s)", "MB/s", "CPU ms/MB", "suspends");
+    for (i = 0; i < chunkCount; i++)
+    {
+        printf("%10zu %10.3f %10.1f %12.2f %10u\n",
+               results[i].chunkLen,
+               results[i].wallTime,
+               packageMb / results[i].wallTime,
+               (results[i].cpuTime * 1000.0) / packageMb,
+               results[i].suspendCount);
+    }
+    printf("Peak RSS: %ld kB (%ld kB before the downloads, including the generated package)\n",
+           usage.ru_maxrss, initialMaxRss);
+
+    dwlgen_Free(&Bench.package);
+    return EXIT_SUCCESS;
+}
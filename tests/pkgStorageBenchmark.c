@@ -0,0 +1,403 @@
+/**
+ * @file pkgStorageBenchmark.c
+ *
+ * Benchmark of the Linux package storage backend (examples/linux/packageStorage.c).
+ *
+ * The same data are stored in a file by chunks of several sizes, as the package downloader would
+ * give them to the storeRange callback, with:
+ *  - naive fwrite calls, the file being synchronized at the same checkpoint interval,
+ *  - the package storage backend in buffered, direct and mmap modes.
+ * The throughput of each method includes the synchronization of all the data on the storage.
+ *
+ * Usage: pkgstoragebenchmark [options]
+ *  -s <len>        Stored data length, with an optional K or M suffix (default: 64M)
+ *  -c <len,...>    Comma-separated list of chunk sizes (default: 1K,4K,16K,64K)
+ *  -i <len>        Checkpoint interval (default: PKG_STORAGE_CHECKPOINT_LEN)
+ *  -f <file>       File to write (default: pkgStorageBench.bin, removed at the end)
+ *  -n <runs>       Number of runs per method and chunk size, the best one is kept (default: 3)
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "packageStorage.h"
+
+//--------------------------------------------------------------------------------------------------
+// Symbol and Enum definitions
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximal number of chunk sizes to benchmark
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_CHUNK_SIZES     16
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Storage methods
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    METHOD_FWRITE,          ///< Naive fwrite calls
+    METHOD_BUFFERED,        ///< Package storage, buffered mode
+    METHOD_DIRECT,          ///< Package storage, direct mode
+    METHOD_MMAP,            ///< Package storage, mmap mode
+    METHOD_MAX              ///< Number of methods
+}
+Method_t;
+
+//--------------------------------------------------------------------------------------------------
+// Static variables
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Method names
+ */
+//--------------------------------------------------------------------------------------------------
+static const char* MethodNames[METHOD_MAX] = { "fwrite", "buffered", "direct", "mmap" };
+
+//--------------------------------------------------------------------------------------------------
+// Static functions
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the monotonic time, in seconds
+ */
+//--------------------------------------------------------------------------------------------------
+static double GetTime
+(
+    void
+)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ((double)ts.tv_nsec / 1e9);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parse a length with an optional K or M suffix
+ *
+ * @return
+ *  - Length
+ *  - 0 if the length is invalid
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t ParseLength
+(
+    const char* strPtr,     ///< [IN] Length string
+    char**      endPtrPtr   ///< [OUT] End of the parsed length
+)
+{
+    unsigned long long len = strtoull(strPtr, endPtrPtr, 0);
+
+    switch (**endPtrPtr)
+    {
+        case 'k':
+        case 'K':
+            len *= 1024;
+            (*endPtrPtr)++;
+            break;
+
+        case 'm':
+        case 'M':
+            len *= 1024 * 1024;
+            (*endPtrPtr)++;
+            break;
+
+        default:
+            break;
+    }
+
+    return (size_t)len;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Store the data with naive fwrite calls, synchronizing the file at each checkpoint interval
+ *
+ * @return
+ *  - true  The data are stored
+ *  - false The data can't be stored
+ */
+//--------------------------------------------------------------------------------------------------
+static bool StoreWithFwrite
+(
+    const char*    fileNamePtr,         ///< [IN] File to write
+    const uint8_t* dataPtr,             ///< [IN] Data to store
+    size_t         dataLen,             ///< [IN] Data length
+    size_t         chunkLen,            ///< [IN] Chunk size
+    size_t         checkpointInterval   ///< [IN] Checkpoint interval
+)
+{
+    FILE* filePtr = fopen(fileNamePtr, "wb");
+    size_t offset = 0;
+    size_t syncOffset = 0;
+    bool result = true;
+
+    if (!filePtr)
+    {
+        return false;
+    }
+
+    while ((result) && (offset < dataLen))
+    {
+        size_t len = dataLen - offset;
+
+        if (len > chunkLen)
+        {
+            len = chunkLen;
+        }
+        result = (len == fwrite(dataPtr + offset, 1, len, filePtr));
+        offset += len;
+
+        if ((result) && ((offset - syncOffset) >= checkpointInterval))
+        {
+            result = (0 == fflush(filePtr)) && (0 == fdatasync(fileno(filePtr)));
+            syncOffset = offset;
+        }
+    }
+
+    result = result && (0 == fflush(filePtr)) && (0 == fsync(fileno(filePtr)));
+    fclose(filePtr);
+
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Store the data with the package storage backend
+ *
+ * @return
+ *  - true  The data are stored
+ *  - false The data can't be stored
+ */
+//--------------------------------------------------------------------------------------------------
+static bool StoreWithPackageStorage
+(
+    const char*          fileNamePtr,           ///< [IN] File to write
+    PackageStorageMode_t mode,                  ///< [IN] Write mode
+    const uint8_t*       dataPtr,               ///< [IN] Data to store
+    size_t               dataLen,               ///< [IN] Data length
+    size_t               chunkLen,              ///< [IN] Chunk size
+    size_t               checkpointInterval     ///< [IN] Checkpoint interval
+)
+{
+    PackageStorage_t storage;
+    size_t offset = 0;
+
+    if (DWL_OK != PackageStorageOpen(&storage, fileNamePtr, dataLen, mode, false))
+    {
+        return false;
+    }
+    storage.checkpointInterval = checkpointInterval;
+
+    while (offset < dataLen)
+    {
+        size_t len = dataLen - offset;
+
+        if (len > chunkLen)
+        {
+            len = chunkLen;
+        }
+        if (DWL_OK != PackageStorageWrite(&storage, dataPtr + offset, len))
+        {
+            PackageStorageClose(&storage, false);
+            return false;
+        }
+        offset += len;
+    }
+
+    return (DWL_OK == PackageStorageClose(&storage, true));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Print the benchmark usage
+ */
+//--------------------------------------------------------------------------------------------------
+static void PrintUsage
+(
+    const char* namePtr     ///< [IN] Program name
+)
+{
+    printf("Usage: %s [-s <data length>] [-c <chunk size,...>] [-i <checkpoint interval>]\n"
+           "          [-f <file>] [-n <runs>]\n",
+           namePtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Package storage benchmark entry point
+ */
+//--------------------------------------------------------------------------------------------------
+int main
+(
+    int   argc,     ///< [IN] Number of arguments
+    char* argv[]    ///< [IN] Arguments
+)
+{
+    size_t dataLen = 64 * 1024 * 1024;
+    size_t chunkLens[MAX_CHUNK_SIZES] = { 1024, 4096, 16384, 65536 };
+    size_t chunkNb = 4;
+    size_t checkpointInterval = PKG_STORAGE_CHECKPOINT_LEN;
+    const char* fileNamePtr = "pkgStorageBench.bin";
+    int runNb = 3;
+    uint8_t* dataPtr;
+    uint32_t state = 1;
+    size_t i;
+    int opt;
+
+    while (-1 != (opt = getopt(argc, argv, "s:c:i:f:n:")))
+    {
+        char* endPtr = NULL;
+
+        switch (opt)
+        {
+            case 's':
+                dataLen = ParseLength(optarg, &endPtr);
+                break;
+
+            case 'c':
+                chunkNb = 0;
+                endPtr = optarg;
+                do
+                {
+                    if (',' == *endPtr)
+                    {
+                        endPtr++;
+                    }
+                    if (MAX_CHUNK_SIZES > chunkNb)
+                    {
+                        chunkLens[chunkNb++] = ParseLength(endPtr, &endPtr);
+                    }
+                }
+                while (',' == *endPtr);
+                break;
+
+            case 'i':
+                checkpointInterval = ParseLength(optarg, &endPtr);
+                break;
+
+            case 'f':
+                fileNamePtr = optarg;
+                break;
+
+            case 'n':
+                runNb = atoi(optarg);
+                break;
+
+            default:
+                PrintUsage(argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+
+    if ((!dataLen) || (!checkpointInterval) || (0 >= runNb))
+    {
+        PrintUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    for (i = 0; i < chunkNb; i++)
+    {
+        if (!chunkLens[i])
+        {
+            PrintUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Pseudo-random data (xorshift32)
+    dataPtr = (uint8_t*)malloc(dataLen);
+    if (!dataPtr)
+    {
+        printf("Unable to allocate %zu bytes\n", dataLen);
+        return EXIT_FAILURE;
+    }
+    for (i = 0; i < dataLen; i++)
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        dataPtr[i] = (uint8_t)state;
+    }
+
+    printf("\n======== Package storage benchmark ========\n");
+    printf("%zu bytes stored in %s, checkpoint every %zu bytes, best of %d runs\n",
+           dataLen, fileNamePtr, checkpointInterval, runNb);
+    printf("%10s", "chunk");
+    for (i = 0; i < METHOD_MAX; i++)
+    {
+        printf(" %10s", MethodNames[i]);
+    }
+    printf("   (MB/s)\n");
+
+    for (i = 0; i < chunkNb; i++)
+    {
+        int method;
+
+        printf("%10zu", chunkLens[i]);
+        for (method = 0; method < METHOD_MAX; method++)
+        {
+            double bestTime = 0;
+            int run;
+
+            for (run = 0; run < runNb; run++)
+            {
+                double startTime = GetTime();
+                double elapsedTime;
+                bool isStored;
+
+                if (METHOD_FWRITE == method)
+                {
+                    isStored = StoreWithFwrite(fileNamePtr,
+                                               dataPtr,
+                                               dataLen,
+                                               chunkLens[i],
+                                               checkpointInterval);
+                }
+                else
+                {
+                    PackageStorageMode_t mode = (METHOD_BUFFERED == method) ?
+                                                PKG_STORAGE_MODE_BUFFERED :
+                                                ((METHOD_DIRECT == method) ?
+                                                 PKG_STORAGE_MODE_DIRECT : PKG_STORAGE_MODE_MMAP);
+                    isStored = StoreWithPackageStorage(fileNamePtr,
+                                                       mode,
+                                                       dataPtr,
+                                                       dataLen,
+                                                       chunkLens[i],
+                                                       checkpointInterval);
+                }
+                elapsedTime = GetTime() - startTime;
+                remove(fileNamePtr);
+
+                if (!isStored)
+                {
+                    printf("\n%s storage failed\n", MethodNames[method]);
+                    free(dataPtr);
+                    return EXIT_FAILURE;
+                }
+                if ((0 == run) || (elapsedTime < bestTime))
+                {
+                    bestTime = elapsedTime;
+                }
+            }
+            printf(" %10.1f", ((double)dataLen / (1024 * 1024)) / bestTime);
+        }
+        printf("\n");
+    }
+
+    free(dataPtr);
+    return EXIT_SUCCESS;
+}
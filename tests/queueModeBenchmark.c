@@ -0,0 +1,589 @@
+/**
+ * @file queueModeBenchmark.c
+ *
+ * Simulation benchmark of the queue mode scheduler (sessionManager/queueMode.c).
+ *
+ * A device records a sensor value periodically for the Send operation and an observed value
+ * changes at random times. The device is simulated second by second on a virtual clock, with the
+ * same event sequence:
+ * - without queue mode: each notification and each Send message is sent as soon as it is ready,
+ * - with queue mode: the session steps are driven by the queue mode scheduler, which holds the
+ *   notifications and the Send messages while the device sleeps and sends them in one burst after
+ *   the Registration Update of the wake-up.
+ *
+ * The radio stays on for the round trip time and the awake time after each message: the time is
+ * counted once when the radio on periods overlap. The benchmark reports, for several record and
+ * change periods, the number of messages, the radio on time in both modes and the radio on time
+ * saved by the queue mode.
+ *
+ * Usage: queuemodebenchmark [options]
+ *  -d <hours>      Simulated duration (default: 168)
+ *  -a <seconds>    Awake time (default: 93)
+ *  -s <seconds>    Maximum sleep time, 0 for no limit (default: 0)
+ *  -m <seconds>    Maximum age of a Send record (default: 3600)
+ *  -u <seconds>    Registration Update period (default: 43200)
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <lwm2mcore/lwm2mcore.h>
+#include <lwm2mcore/queueMode.h>
+#include <lwm2mcore/timer.h>
+#include <sessionManager/queueMode.h>
+
+//--------------------------------------------------------------------------------------------------
+// Symbol and Enum definitions
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Round trip time of a confirmable message, in seconds
+ */
+//--------------------------------------------------------------------------------------------------
+#define RTT                     1
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of records of a Send message
+ */
+//--------------------------------------------------------------------------------------------------
+#define SEND_RECORD_MAX_NB      32
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of buffered records
+ */
+//--------------------------------------------------------------------------------------------------
+#define RECORD_MAX_NB           1024
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Default step delay of the session, in seconds
+ */
+//--------------------------------------------------------------------------------------------------
+#define STEP_DELAY              60
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Simulated scenario
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    const char* namePtr;        ///< Scenario name
+    uint32_t    recordPeriod;   ///< Period of the Send records, in seconds
+    uint32_t    changePeriod;   ///< Mean period of the observed value changes, in seconds
+}
+Scenario_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Simulation parameters
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t    duration;       ///< Simulated duration, in seconds
+    uint32_t    awakeTime;      ///< Awake time, in seconds
+    uint32_t    maxSleepTime;   ///< Maximum sleep time, in seconds
+    uint32_t    maxAge;         ///< Maximum age of a Send record, in seconds
+    uint32_t    updatePeriod;   ///< Registration Update period, in seconds
+}
+SimConfig_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Simulated device
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    bool        isQueueMode;                ///< The session is driven by the queue mode scheduler
+    uint32_t    recordTimes[RECORD_MAX_NB]; ///< Ring of the times of the buffered records
+    uint32_t    firstRecord;                ///< Index of the oldest record of the ring
+    uint32_t    recordNb;                   ///< Number of buffered records
+    bool        isChanged;                  ///< The observed value changed since the last
+                                            ///< notification
+    uint32_t    ackTime;                    ///< Acknowledgement time of the transaction in
+                                            ///< progress, 0 if none
+    bool        isUpdate;                   ///< The transaction is a Registration Update
+    uint32_t    nextStepTime;               ///< Time of the next session step
+    uint32_t    nextUpdateTime;             ///< Time of the next Registration Update
+    uint32_t    radioEndTime;               ///< End of the current radio on period
+    uint32_t    radioOnTime;                ///< Radio on time
+    uint32_t    messageNb;                  ///< Number of messages sent
+}
+Device_t;
+
+//--------------------------------------------------------------------------------------------------
+// Static variables
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Scenarios
+ */
+//--------------------------------------------------------------------------------------------------
+static const Scenario_t Scenarios[] =
+{
+    { "records 1 h, changes 6 h",       3600,   21600 },
+    { "records 15 min, changes 1 h",    900,    3600 },
+    { "records 5 min, changes 15 min",  300,    900 },
+    { "records 1 min, changes 5 min",   60,     300 },
+};
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Virtual clock, in microseconds
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t SimTimeUs;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Simulation parameters
+ */
+//--------------------------------------------------------------------------------------------------
+static SimConfig_t SimConfig;
+
+//--------------------------------------------------------------------------------------------------
+// Platform functions of the scheduler
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the virtual monotonic time
+ *
+ * @return
+ *      - Virtual time in microseconds
+ */
+//--------------------------------------------------------------------------------------------------
+uint64_t lwm2mcore_GetTimeUs
+(
+    void
+)
+{
+    return SimTimeUs;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Discard the logs of the scheduler
+ */
+//--------------------------------------------------------------------------------------------------
+void lwm2m_printf
+(
+    const char* formatPtr,  ///< [IN] Format
+    ...
+)
+{
+    (void)formatPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Simulation
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send a message: the radio stays on for the round trip time and the awake time
+ */
+//--------------------------------------------------------------------------------------------------
+static void SendMessage
+(
+    Device_t* devPtr,           ///< [IN] Device
+    uint32_t now,               ///< [IN] Current time
+    bool isConfirmable          ///< [IN] The message is acknowledged after the round trip time
+)
+{
+    uint32_t endTime = now + RTT + SimConfig.awakeTime;
+
+    if (now >= devPtr->radioEndTime)
+    {
+        devPtr->radioOnTime += endTime - now;
+    }
+    else if (endTime > devPtr->radioEndTime)
+    {
+        devPtr->radioOnTime += endTime - devPtr->radioEndTime;
+    }
+    if (endTime > devPtr->radioEndTime)
+    {
+        devPtr->radioEndTime = endTime;
+    }
+
+    devPtr->messageNb++;
+    if (isConfirmable)
+    {
+        devPtr->ackTime = now + RTT;
+    }
+
+    if (devPtr->isQueueMode)
+    {
+        smanager_QueueSignalActivity();
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send a Registration Update
+ */
+//--------------------------------------------------------------------------------------------------
+static void SendUpdate
+(
+    Device_t* devPtr,           ///< [IN] Device
+    uint32_t now                ///< [IN] Current time
+)
+{
+    SendMessage(devPtr, now, true);
+    devPtr->isUpdate = true;
+    devPtr->nextUpdateTime = now + SimConfig.updatePeriod;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Notify the changed observed value, unless it is held
+ */
+//--------------------------------------------------------------------------------------------------
+static void Notify
+(
+    Device_t* devPtr,           ///< [IN] Device
+    uint32_t now                ///< [IN] Current time
+)
+{
+    if ((!devPtr->isChanged) || (devPtr->isQueueMode && smanager_QueueIsHolding()))
+    {
+        return;
+    }
+
+    SendMessage(devPtr, now, false);
+    devPtr->isChanged = false;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the time until the age threshold of the buffered records is reached
+ *
+ * @return
+ *      - Time in seconds, UINT32_MAX if no record is buffered
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t GetRecordDelay
+(
+    Device_t* devPtr,           ///< [IN] Device
+    uint32_t now                ///< [IN] Current time
+)
+{
+    uint32_t age;
+
+    if (0 == devPtr->recordNb)
+    {
+        return UINT32_MAX;
+    }
+
+    age = now - devPtr->recordTimes[devPtr->firstRecord];
+    return ((age >= SimConfig.maxAge) ? 0 : (SimConfig.maxAge - age));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send the buffered records if a threshold is reached or if forced, one Send message at a time
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckRecords
+(
+    Device_t* devPtr,           ///< [IN] Device
+    uint32_t now,               ///< [IN] Current time
+    bool isForced               ///< [IN] Send the records whatever the thresholds
+)
+{
+    uint32_t sentNb;
+
+    if ((0 == devPtr->recordNb) || (0 != devPtr->ackTime))
+    {
+        return;
+    }
+
+    if (   (!isForced)
+        && (SEND_RECORD_MAX_NB > devPtr->recordNb)
+        && (0 != GetRecordDelay(devPtr, now)))
+    {
+        return;
+    }
+
+    if (devPtr->isQueueMode && smanager_QueueHoldSend())
+    {
+        return;
+    }
+
+    sentNb = (SEND_RECORD_MAX_NB < devPtr->recordNb) ? SEND_RECORD_MAX_NB : devPtr->recordNb;
+    devPtr->firstRecord = (devPtr->firstRecord + sentNb) % RECORD_MAX_NB;
+    devPtr->recordNb -= sentNb;
+    SendMessage(devPtr, now, true);
+    devPtr->isUpdate = false;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Session step, as done by the step handler of the session manager
+ */
+//--------------------------------------------------------------------------------------------------
+static void Step
+(
+    Device_t* devPtr,           ///< [IN] Device
+    uint32_t now                ///< [IN] Current time
+)
+{
+    uint32_t delay;
+    uint32_t recordDelay;
+
+    delay = devPtr->isQueueMode ? smanager_QueueGetStepDelay(STEP_DELAY) : STEP_DELAY;
+
+    if (devPtr->isQueueMode && smanager_QueueIsSleeping())
+    {
+        uint32_t wakeUpDelay = smanager_QueueGetWakeUpDelay();
+
+        if (0 != wakeUpDelay)
+        {
+            devPtr->nextStepTime = now + wakeUpDelay;
+            return;
+        }
+
+        smanager_QueueWakeUp();
+        SendUpdate(devPtr, now);
+    }
+    else if ((now >= devPtr->nextUpdateTime) && (0 == devPtr->ackTime))
+    {
+        SendUpdate(devPtr, now);
+    }
+
+    Notify(devPtr, now);
+    CheckRecords(devPtr, now, false);
+
+    if ((devPtr->nextUpdateTime - now) < delay)
+    {
+        delay = devPtr->nextUpdateTime - now;
+    }
+    recordDelay = GetRecordDelay(devPtr, now);
+    if (recordDelay < delay)
+    {
+        delay = recordDelay;
+    }
+
+    if (devPtr->isQueueMode)
+    {
+        delay = smanager_QueueGetDelay(delay, (0 == devPtr->ackTime));
+    }
+
+    devPtr->nextStepTime = now + (delay ? delay : 1);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Simulate a device for a scenario
+ */
+//--------------------------------------------------------------------------------------------------
+static void Simulate
+(
+    const Scenario_t* scenarioPtr,  ///< [IN] Scenario
+    Device_t* devPtr,               ///< [OUT] Device
+    bool isQueueMode                ///< [IN] Drive the session with the queue mode scheduler
+)
+{
+    lwm2mcore_QueueModeConfig_t config;
+    uint32_t now;
+
+    memset(devPtr, 0, sizeof(Device_t));
+    devPtr->isQueueMode = isQueueMode;
+
+    /* Same event sequence in both modes */
+    srand(1);
+    SimTimeUs = 0;
+
+    memset(&config, 0, sizeof(config));
+    config.awakeTime = SimConfig.awakeTime;
+    config.maxSleepTime = SimConfig.maxSleepTime;
+    lwm2mcore_QueueModeConfigure(NULL);
+    if (isQueueMode)
+    {
+        lwm2mcore_QueueModeConfigure(&config);
+    }
+    lwm2mcore_ResetQueueModeStats();
+
+    /* Registration */
+    SendUpdate(devPtr, 0);
+
+    for (now = 0; now < SimConfig.duration; now++)
+    {
+        SimTimeUs = (uint64_t)now * 1000000;
+
+        /* Acknowledgement of the transaction in progress */
+        if ((0 != devPtr->ackTime) && (now >= devPtr->ackTime))
+        {
+            devPtr->ackTime = 0;
+            if (isQueueMode)
+            {
+                smanager_QueueSignalActivity();
+                if (devPtr->isUpdate)
+                {
+                    smanager_QueueSignalRegistration(true);
+                }
+            }
+
+            if (isQueueMode && smanager_QueueTakeBurst())
+            {
+                Notify(devPtr, now);
+                CheckRecords(devPtr, now, true);
+            }
+            else
+            {
+                CheckRecords(devPtr, now, false);
+            }
+        }
+
+        /* Sensor record, sent when the payload is full */
+        if ((0 != now) && (0 == (now % scenarioPtr->recordPeriod)))
+        {
+            if (RECORD_MAX_NB == devPtr->recordNb)
+            {
+                devPtr->firstRecord = (devPtr->firstRecord + 1) % RECORD_MAX_NB;
+                devPtr->recordNb--;
+            }
+            devPtr->recordTimes[(devPtr->firstRecord + devPtr->recordNb) % RECORD_MAX_NB] = now;
+            devPtr->recordNb++;
+            if (SEND_RECORD_MAX_NB <= devPtr->recordNb)
+            {
+                CheckRecords(devPtr, now, false);
+            }
+        }
+
+        /* Change of the observed value, notified by the next step */
+        if (0 == (rand() % scenarioPtr->changePeriod))
+        {
+            devPtr->isChanged = true;
+            if ((!isQueueMode) || (!smanager_QueueIsSleeping()))
+            {
+                devPtr->nextStepTime = now;
+            }
+        }
+
+        if (now >= devPtr->nextStepTime)
+        {
+            Step(devPtr, now);
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Print the usage
+ */
+//--------------------------------------------------------------------------------------------------
+static void PrintUsage
+(
+    const char* namePtr     ///< [IN] Program name
+)
+{
+    printf("Usage: %s [-d <hours>] [-a <awake time>] [-s <max sleep time>] [-m <max age>]"
+           " [-u <update period>]\n", namePtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Queue mode simulation benchmark
+ *
+ * @return
+ *  - EXIT_SUCCESS on success
+ *  - EXIT_FAILURE on failure
+ */
+//--------------------------------------------------------------------------------------------------
+int main
+(
+    int   argc,     ///< [IN] Number of arguments
+    char* argv[]    ///< [IN] Arguments
+)
+{
+    int hours = 168;
+    int opt;
+    size_t i;
+
+    SimConfig.awakeTime = LWM2MCORE_QUEUE_MODE_AWAKE_TIME;
+    SimConfig.maxSleepTime = 0;
+    SimConfig.maxAge = 3600;
+    SimConfig.updatePeriod = 43200;
+
+    while (-1 != (opt = getopt(argc, argv, "d:a:s:m:u:")))
+    {
+        switch (opt)
+        {
+            case 'd':
+                hours = atoi(optarg);
+                break;
+
+            case 'a':
+                SimConfig.awakeTime = (uint32_t)atoi(optarg);
+                break;
+
+            case 's':
+                SimConfig.maxSleepTime = (uint32_t)atoi(optarg);
+                break;
+
+            case 'm':
+                SimConfig.maxAge = (uint32_t)atoi(optarg);
+                break;
+
+            case 'u':
+                SimConfig.updatePeriod = (uint32_t)atoi(optarg);
+                break;
+
+            default:
+                PrintUsage(argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+
+    if ((0 >= hours) || (0 == SimConfig.awakeTime) || (0 == SimConfig.updatePeriod))
+    {
+        PrintUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    SimConfig.duration = (uint32_t)hours * 3600;
+
+    printf("\n======== Queue mode simulation ========\n");
+    printf("%d h, awake time %u s, max sleep time %u s, max record age %u s, "
+           "update period %u s\n\n",
+           hours, SimConfig.awakeTime, SimConfig.maxSleepTime, SimConfig.maxAge,
+           SimConfig.updatePeriod);
+    printf("%-32s %10s %10s %9s %12s %12s %7s\n",
+           "Scenario", "Msg", "Msg queue", "Wake-ups", "Radio on (s)", "Radio queue", "Saved");
+
+    for (i = 0; i < sizeof(Scenarios) / sizeof(Scenarios[0]); i++)
+    {
+        Device_t immediate;
+        Device_t queue;
+        lwm2mcore_QueueModeStats_t stats;
+
+        Simulate(&Scenarios[i], &immediate, false);
+        Simulate(&Scenarios[i], &queue, true);
+        if (LWM2MCORE_ERR_COMPLETED_OK != lwm2mcore_GetQueueModeStats(&stats))
+        {
+            printf("Queue mode statistics not available\n");
+            return EXIT_FAILURE;
+        }
+
+        printf("%-32s %10u %10u %9u %12u %12u %6.1f%%\n",
+               Scenarios[i].namePtr,
+               immediate.messageNb,
+               queue.messageNb,
+               stats.wakeUpNb,
+               immediate.radioOnTime,
+               queue.radioOnTime,
+               100.0 * (1.0 - ((double)queue.radioOnTime / (double)immediate.radioOnTime)));
+    }
+
+    return EXIT_SUCCESS;
+}
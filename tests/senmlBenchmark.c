@@ -0,0 +1,790 @@
+/**
+ * @file senmlBenchmark.c
+ *
+ * Benchmark of the SenML encoding of the object reads (objectManager/senml.c).
+ *
+ * Typical multi-resource read payloads (device object instance, connectivity monitoring object
+ * instance, all the instances of a temperature object) are serialized in LwM2M TLV, SenML-JSON and
+ * SenML-CBOR. The payload sizes and the serialization times are reported. The SenML-CBOR size
+ * without base name shows the gain of the base name compaction.
+ *
+ * The TLV encoder of this benchmark follows the Wakaama one: a first pass computes the payload
+ * length, a second pass writes it in an allocated buffer.
+ *
+ * Usage: senmlbenchmark [-n <iterations>]
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "liblwm2m.h"
+#include "senml.h"
+
+//--------------------------------------------------------------------------------------------------
+// Symbol and Enum definitions
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of data of a payload
+ */
+//--------------------------------------------------------------------------------------------------
+#define DATA_MAX_NB             32
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * TLV types
+ */
+//--------------------------------------------------------------------------------------------------
+#define TLV_OBJECT_INSTANCE     0x00
+#define TLV_RESOURCE_INSTANCE   0x40
+#define TLV_MULTIPLE_RESOURCE   0x80
+#define TLV_RESOURCE            0xC0
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Payload of the benchmark
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    const char*     namePtr;                    ///< Payload name
+    lwm2m_uri_t     uri;                        ///< Read URI
+    int             dataNb;                     ///< Number of data
+    lwm2m_data_t    data[DATA_MAX_NB];          ///< Data
+    lwm2m_data_t    children[DATA_MAX_NB];      ///< Resource instances and resources of the data
+    int             childNb;                    ///< Number of used children
+}
+Payload_t;
+
+//--------------------------------------------------------------------------------------------------
+// Static variables
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sink preventing the compiler from removing the serializations
+ */
+//--------------------------------------------------------------------------------------------------
+static volatile size_t Sink;
+
+//--------------------------------------------------------------------------------------------------
+// Static functions
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the monotonic time, in nanoseconds
+ */
+//--------------------------------------------------------------------------------------------------
+static double GetTimeNs
+(
+    void
+)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((double)ts.tv_sec * 1e9) + (double)ts.tv_nsec;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a data to a payload, or to the children of a multiple resource or object instance
+ *
+ * @return
+ *  - Added data
+ */
+//--------------------------------------------------------------------------------------------------
+static lwm2m_data_t* AddData
+(
+    Payload_t* payloadPtr,      ///< [INOUT] Payload
+    lwm2m_data_t* parentPtr,    ///< [INOUT] Parent data, NULL for the top level
+    uint16_t id,                ///< [IN] Data identifier
+    lwm2m_data_type_t type      ///< [IN] Data type
+)
+{
+    lwm2m_data_t* dataPtr;
+
+    if (parentPtr)
+    {
+        dataPtr = &payloadPtr->children[payloadPtr->childNb++];
+        if (0 == parentPtr->value.asChildren.count)
+        {
+            parentPtr->value.asChildren.array = dataPtr;
+        }
+        parentPtr->value.asChildren.count++;
+    }
+    else
+    {
+        dataPtr = &payloadPtr->data[payloadPtr->dataNb++];
+    }
+
+    memset(dataPtr, 0, sizeof(lwm2m_data_t));
+    dataPtr->id = id;
+    dataPtr->type = type;
+    return dataPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add an integer
+ */
+//--------------------------------------------------------------------------------------------------
+static void AddInt
+(
+    Payload_t* payloadPtr,      ///< [INOUT] Payload
+    lwm2m_data_t* parentPtr,    ///< [INOUT] Parent data, NULL for the top level
+    uint16_t id,                ///< [IN] Data identifier
+    int64_t value               ///< [IN] Value
+)
+{
+    AddData(payloadPtr, parentPtr, id, LWM2M_TYPE_INTEGER)->value.asInteger = value;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a float
+ */
+//--------------------------------------------------------------------------------------------------
+static void AddFloat
+(
+    Payload_t* payloadPtr,      ///< [INOUT] Payload
+    lwm2m_data_t* parentPtr,    ///< [INOUT] Parent data, NULL for the top level
+    uint16_t id,                ///< [IN] Data identifier
+    double value                ///< [IN] Value
+)
+{
+    AddData(payloadPtr, parentPtr, id, LWM2M_TYPE_FLOAT)->value.asFloat = value;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a string
+ */
+//--------------------------------------------------------------------------------------------------
+static void AddString
+(
+    Payload_t* payloadPtr,      ///< [INOUT] Payload
+    lwm2m_data_t* parentPtr,    ///< [INOUT] Parent data, NULL for the top level
+    uint16_t id,                ///< [IN] Data identifier
+    const char* strPtr          ///< [IN] Value
+)
+{
+    lwm2m_data_t* dataPtr = AddData(payloadPtr, parentPtr, id, LWM2M_TYPE_STRING);
+
+    dataPtr->value.asBuffer.buffer = (uint8_t*)strPtr;
+    dataPtr->value.asBuffer.length = strlen(strPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Build the device object instance payload: /3/0
+ */
+//--------------------------------------------------------------------------------------------------
+static void BuildDevice
+(
+    Payload_t* payloadPtr       ///< [OUT] Payload
+)
+{
+    lwm2m_data_t* multiPtr;
+
+    memset(payloadPtr, 0, sizeof(Payload_t));
+    payloadPtr->namePtr = "/3/0 device";
+    payloadPtr->uri.flag = LWM2M_URI_FLAG_OBJECT_ID | LWM2M_URI_FLAG_INSTANCE_ID;
+    payloadPtr->uri.objectId = 3;
+    payloadPtr->uri.instanceId = 0;
+
+    AddString(payloadPtr, NULL, 0, "Sierra Wireless");
+    AddString(payloadPtr, NULL, 1, "WP7702");
+    AddString(payloadPtr, NULL, 2, "4L932370010510");
+    AddString(payloadPtr, NULL, 3, "SWI9X07Y_02.28.03.05");
+    multiPtr = AddData(payloadPtr, NULL, 6, LWM2M_TYPE_MULTIPLE_RESOURCE);
+    AddInt(payloadPtr, multiPtr, 0, 1);
+    AddInt(payloadPtr, multiPtr, 1, 5);
+    multiPtr = AddData(payloadPtr, NULL, 7, LWM2M_TYPE_MULTIPLE_RESOURCE);
+    AddInt(payloadPtr, multiPtr, 0, 3800);
+    AddInt(payloadPtr, multiPtr, 1, 5000);
+    multiPtr = AddData(payloadPtr, NULL, 8, LWM2M_TYPE_MULTIPLE_RESOURCE);
+    AddInt(payloadPtr, multiPtr, 0, 125);
+    AddInt(payloadPtr, multiPtr, 1, 900);
+    AddInt(payloadPtr, NULL, 9, 80);
+    AddInt(payloadPtr, NULL, 10, 15000);
+    multiPtr = AddData(payloadPtr, NULL, 11, LWM2M_TYPE_MULTIPLE_RESOURCE);
+    AddInt(payloadPtr, multiPtr, 0, 0);
+    AddInt(payloadPtr, NULL, 13, 1700000000);
+    AddString(payloadPtr, NULL, 14, "+02:00");
+    AddString(payloadPtr, NULL, 15, "Europe/Paris");
+    AddString(payloadPtr, NULL, 16, "UQ");
+    AddString(payloadPtr, NULL, 17, "Module");
+    AddString(payloadPtr, NULL, 18, "1.0");
+    AddString(payloadPtr, NULL, 19, "R16.0.1");
+    AddInt(payloadPtr, NULL, 20, 1);
+    AddInt(payloadPtr, NULL, 21, 65536);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Build the connectivity monitoring object instance payload: /4/0
+ */
+//--------------------------------------------------------------------------------------------------
+static void BuildConnectivity
+(
+    Payload_t* payloadPtr       ///< [OUT] Payload
+)
+{
+    lwm2m_data_t* multiPtr;
+
+    memset(payloadPtr, 0, sizeof(Payload_t));
+    payloadPtr->namePtr = "/4/0 connectivity";
+    payloadPtr->uri.flag = LWM2M_URI_FLAG_OBJECT_ID | LWM2M_URI_FLAG_INSTANCE_ID;
+    payloadPtr->uri.objectId = 4;
+    payloadPtr->uri.instanceId = 0;
+
+    AddInt(payloadPtr, NULL, 0, 6);
+    multiPtr = AddData(payloadPtr, NULL, 1, LWM2M_TYPE_MULTIPLE_RESOURCE);
+    AddInt(payloadPtr, multiPtr, 0, 6);
+    AddInt(payloadPtr, multiPtr, 1, 7);
+    AddInt(payloadPtr, multiPtr, 2, 8);
+    AddInt(payloadPtr, NULL, 2, -85);
+    AddInt(payloadPtr, NULL, 3, 20);
+    multiPtr = AddData(payloadPtr, NULL, 4, LWM2M_TYPE_MULTIPLE_RESOURCE);
+    AddString(payloadPtr, multiPtr, 0, "10.117.42.12");
+    multiPtr = AddData(payloadPtr, NULL, 5, LWM2M_TYPE_MULTIPLE_RESOURCE);
+    AddString(payloadPtr, multiPtr, 0, "10.117.42.1");
+    AddInt(payloadPtr, NULL, 6, 12);
+    multiPtr = AddData(payloadPtr, NULL, 7, LWM2M_TYPE_MULTIPLE_RESOURCE);
+    AddString(payloadPtr, multiPtr, 0, "internet.m2m");
+    AddInt(payloadPtr, NULL, 8, 20816523);
+    AddInt(payloadPtr, NULL, 9, 1);
+    AddInt(payloadPtr, NULL, 10, 208);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Build the temperature object payload: /3303, four instances
+ */
+//--------------------------------------------------------------------------------------------------
+static void BuildTemperature
+(
+    Payload_t* payloadPtr       ///< [OUT] Payload
+)
+{
+    uint16_t i;
+
+    memset(payloadPtr, 0, sizeof(Payload_t));
+    payloadPtr->namePtr = "/3303 temperature";
+    payloadPtr->uri.flag = LWM2M_URI_FLAG_OBJECT_ID;
+    payloadPtr->uri.objectId = 3303;
+
+    for (i = 0; i < 4; i++)
+    {
+        lwm2m_data_t* instancePtr = AddData(payloadPtr, NULL, i, LWM2M_TYPE_OBJECT_INSTANCE);
+
+        AddFloat(payloadPtr, instancePtr, 5700, 21.5 + i);
+        AddFloat(payloadPtr, instancePtr, 5601, 18.25);
+        AddFloat(payloadPtr, instancePtr, 5602, 24.0 + (0.1 * i));
+        AddString(payloadPtr, instancePtr, 5701, "Cel");
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the length of a TLV integer value
+ *
+ * @return
+ *  - Length in bytes
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t GetTlvIntLength
+(
+    int64_t value               ///< [IN] Value
+)
+{
+    if ((INT8_MIN <= value) && (INT8_MAX >= value))
+    {
+        return 1;
+    }
+    if ((INT16_MIN <= value) && (INT16_MAX >= value))
+    {
+        return 2;
+    }
+    if ((INT32_MIN <= value) && (INT32_MAX >= value))
+    {
+        return 4;
+    }
+    return 8;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a TLV, or only compute its length if the buffer is NULL
+ *
+ * @return
+ *  - Length of the TLV
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t WriteTlv
+(
+    uint8_t* bufferPtr,         ///< [OUT] Buffer, NULL to compute the length only
+    uint8_t type,               ///< [IN] TLV type
+    uint16_t id,                ///< [IN] Identifier
+    const uint8_t* valuePtr,    ///< [IN] Value, NULL if written by the caller
+    size_t valueLen             ///< [IN] Value length
+)
+{
+    size_t headerLen = 1 + ((UINT8_MAX < id) ? 2 : 1);
+    uint8_t header[6];
+    size_t i;
+
+    header[0] = type;
+    if (UINT8_MAX < id)
+    {
+        header[0] |= 0x20;
+        header[1] = (uint8_t)(id >> 8);
+        header[2] = (uint8_t)id;
+    }
+    else
+    {
+        header[1] = (uint8_t)id;
+    }
+
+    if (8 > valueLen)
+    {
+        header[0] |= (uint8_t)valueLen;
+    }
+    else
+    {
+        size_t lenBytes = (UINT8_MAX >= valueLen) ? 1 : ((UINT16_MAX >= valueLen) ? 2 : 3);
+
+        header[0] |= (uint8_t)(lenBytes << 3);
+        for (i = 0; i < lenBytes; i++)
+        {
+            header[headerLen + i] = (uint8_t)(valueLen >> (8 * (lenBytes - 1 - i)));
+        }
+        headerLen += lenBytes;
+    }
+
+    if (bufferPtr)
+    {
+        memcpy(bufferPtr, header, headerLen);
+        if (valuePtr)
+        {
+            memcpy(bufferPtr + headerLen, valuePtr, valueLen);
+        }
+    }
+
+    return headerLen + valueLen;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Serialize data in TLV, or only compute the length if the buffer is NULL
+ *
+ * @return
+ *  - Length of the TLV payload
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t SerializeTlv
+(
+    uint8_t* bufferPtr,             ///< [OUT] Buffer, NULL to compute the length only
+    int dataNb,                     ///< [IN] Number of data
+    const lwm2m_data_t* dataPtr,    ///< [IN] Data
+    bool isResourceInstance         ///< [IN] The data are resource instances
+)
+{
+    size_t length = 0;
+    int i;
+
+    for (i = 0; i < dataNb; i++)
+    {
+        uint8_t type = isResourceInstance ? TLV_RESOURCE_INSTANCE : TLV_RESOURCE;
+        uint8_t value[8];
+        size_t valueLen = 0;
+        const uint8_t* valuePtr = value;
+        uint8_t* outPtr = bufferPtr ? (bufferPtr + length) : NULL;
+
+        switch (dataPtr[i].type)
+        {
+            case LWM2M_TYPE_OBJECT_INSTANCE:
+            case LWM2M_TYPE_MULTIPLE_RESOURCE:
+            {
+                bool isInstance = (LWM2M_TYPE_OBJECT_INSTANCE == dataPtr[i].type);
+                size_t childLen = SerializeTlv(NULL,
+                                               (int)dataPtr[i].value.asChildren.count,
+                                               dataPtr[i].value.asChildren.array,
+                                               !isInstance);
+                size_t headerLen = WriteTlv(outPtr,
+                                            isInstance ? TLV_OBJECT_INSTANCE
+                                                       : TLV_MULTIPLE_RESOURCE,
+                                            dataPtr[i].id,
+                                            NULL,
+                                            childLen) - childLen;
+
+                if (outPtr)
+                {
+                    SerializeTlv(outPtr + headerLen,
+                                 (int)dataPtr[i].value.asChildren.count,
+                                 dataPtr[i].value.asChildren.array,
+                                 !isInstance);
+                }
+                length += headerLen + childLen;
+            }
+            continue;
+
+            case LWM2M_TYPE_INTEGER:
+            {
+                int64_t intValue = dataPtr[i].value.asInteger;
+                size_t j;
+
+                valueLen = GetTlvIntLength(intValue);
+                for (j = 0; j < valueLen; j++)
+                {
+                    value[j] = (uint8_t)((uint64_t)intValue >> (8 * (valueLen - 1 - j)));
+                }
+            }
+            break;
+
+            case LWM2M_TYPE_FLOAT:
+            {
+                double floatValue = dataPtr[i].value.asFloat;
+                float single = (float)floatValue;
+                uint64_t bits;
+                size_t j;
+
+                if ((!((double)single < floatValue)) && (!((double)single > floatValue)))
+                {
+                    uint32_t singleBits;
+
+                    memcpy(&singleBits, &single, sizeof(singleBits));
+                    bits = singleBits;
+                    valueLen = 4;
+                }
+                else
+                {
+                    memcpy(&bits, &floatValue, sizeof(bits));
+                    valueLen = 8;
+                }
+                for (j = 0; j < valueLen; j++)
+                {
+                    value[j] = (uint8_t)(bits >> (8 * (valueLen - 1 - j)));
+                }
+            }
+            break;
+
+            case LWM2M_TYPE_BOOLEAN:
+                value[0] = dataPtr[i].value.asBoolean ? 1 : 0;
+                valueLen = 1;
+                break;
+
+            default:
+                valuePtr = dataPtr[i].value.asBuffer.buffer;
+                valueLen = dataPtr[i].value.asBuffer.length;
+                break;
+        }
+
+        length += WriteTlv(outPtr, type, dataPtr[i].id, valuePtr, valueLen);
+    }
+
+    return length;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Serialize a payload in TLV in an allocated buffer
+ *
+ * @return
+ *  - Length of the TLV payload
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t SerializeTlvPayload
+(
+    const Payload_t* payloadPtr,    ///< [IN] Payload
+    uint8_t** bufferPtr             ///< [OUT] Allocated buffer
+)
+{
+    size_t length = SerializeTlv(NULL, payloadPtr->dataNb, payloadPtr->data, false);
+
+    *bufferPtr = (uint8_t*)lwm2m_malloc(length);
+    if (!*bufferPtr)
+    {
+        return 0;
+    }
+    return SerializeTlv(*bufferPtr, payloadPtr->dataNb, payloadPtr->data, false);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add the records of data with their full path names, without base name
+ *
+ * @return
+ *  - false on failure
+ */
+//--------------------------------------------------------------------------------------------------
+static bool AddFullNameRecords
+(
+    omanager_SenmlWriter_t* writerPtr,  ///< [INOUT] Writer
+    const char* prefixPtr,              ///< [IN] Path prefix
+    int dataNb,                         ///< [IN] Number of data
+    const lwm2m_data_t* dataPtr         ///< [IN] Data
+)
+{
+    char name[SENML_NAME_MAX_LEN];
+    int i;
+
+    for (i = 0; i < dataNb; i++)
+    {
+        snprintf(name, sizeof(name), "%s%u", prefixPtr, dataPtr[i].id);
+        if ((LWM2M_TYPE_OBJECT_INSTANCE == dataPtr[i].type)
+         || (LWM2M_TYPE_MULTIPLE_RESOURCE == dataPtr[i].type))
+        {
+            strcat(name, "/");
+            if (!AddFullNameRecords(writerPtr, name, (int)dataPtr[i].value.asChildren.count,
+                                    dataPtr[i].value.asChildren.array))
+            {
+                return false;
+            }
+        }
+        else if (!omanager_SenmlAddRecord(writerPtr, name, 0, &dataPtr[i]))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Count the records of data
+ *
+ * @return
+ *  - Number of records
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t CountRecords
+(
+    int dataNb,                         ///< [IN] Number of data
+    const lwm2m_data_t* dataPtr         ///< [IN] Data
+)
+{
+    uint32_t recordNb = 0;
+    int i;
+
+    for (i = 0; i < dataNb; i++)
+    {
+        if ((LWM2M_TYPE_OBJECT_INSTANCE == dataPtr[i].type)
+         || (LWM2M_TYPE_MULTIPLE_RESOURCE == dataPtr[i].type))
+        {
+            recordNb += CountRecords((int)dataPtr[i].value.asChildren.count,
+                                     dataPtr[i].value.asChildren.array);
+        }
+        else
+        {
+            recordNb++;
+        }
+    }
+
+    return recordNb;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the SenML-CBOR length of a payload without base name
+ *
+ * @return
+ *  - Payload length, 0 on failure
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t GetFullNameCborLength
+(
+    const Payload_t* payloadPtr     ///< [IN] Payload
+)
+{
+    omanager_SenmlWriter_t writer;
+    char prefix[SENML_NAME_MAX_LEN];
+
+    if (payloadPtr->uri.flag & LWM2M_URI_FLAG_INSTANCE_ID)
+    {
+        snprintf(prefix, sizeof(prefix), "/%u/%u/",
+                 payloadPtr->uri.objectId, payloadPtr->uri.instanceId);
+    }
+    else
+    {
+        snprintf(prefix, sizeof(prefix), "/%u/", payloadPtr->uri.objectId);
+    }
+
+    if ((!omanager_SenmlBegin(&writer, LWM2MCORE_CONTENT_SENML_CBOR, NULL, 0,
+                              CountRecords(payloadPtr->dataNb, payloadPtr->data), NULL, 0))
+     || (!AddFullNameRecords(&writer, prefix, payloadPtr->dataNb, payloadPtr->data)))
+    {
+        return 0;
+    }
+    return omanager_SenmlEnd(&writer);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Measure the serialization time of a payload in a content format
+ *
+ * @return
+ *  - time in nanoseconds, negative in case of failure
+ */
+//--------------------------------------------------------------------------------------------------
+static double MeasureSerialization
+(
+    const Payload_t* payloadPtr,    ///< [IN] Payload
+    uint16_t format,                ///< [IN] Content format, LWM2M_CONTENT_TLV or SenML
+    int iterationNb,                ///< [IN] Number of serializations
+    size_t* lengthPtr               ///< [OUT] Payload length
+)
+{
+    double startNs = GetTimeNs();
+    size_t sum = 0;
+    int i;
+
+    for (i = 0; i < iterationNb; i++)
+    {
+        uint8_t* bufferPtr = NULL;
+        int len;
+
+        if (LWM2M_CONTENT_TLV == format)
+        {
+            len = (int)SerializeTlvPayload(payloadPtr, &bufferPtr);
+        }
+        else
+        {
+            len = lwm2mcore_SenmlSerialize(&payloadPtr->uri, payloadPtr->dataNb, payloadPtr->data,
+                                           format, &bufferPtr);
+        }
+
+        if (0 >= len)
+        {
+            return -1;
+        }
+        sum += bufferPtr[len - 1];
+        lwm2m_free(bufferPtr);
+        *lengthPtr = (size_t)len;
+    }
+
+    Sink = sum;
+    return (GetTimeNs() - startNs) / iterationNb;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Measure a payload in all the content formats
+ *
+ * @return
+ *  - true on success
+ */
+//--------------------------------------------------------------------------------------------------
+static bool MeasurePayload
+(
+    const Payload_t* payloadPtr,    ///< [IN] Payload
+    int iterationNb                 ///< [IN] Number of serializations
+)
+{
+    static const struct
+    {
+        const char* namePtr;
+        uint16_t format;
+    }
+    formats[] =
+    {
+        {"TLV", LWM2M_CONTENT_TLV},
+        {"SenML-JSON", LWM2MCORE_CONTENT_SENML_JSON},
+        {"SenML-CBOR", LWM2MCORE_CONTENT_SENML_CBOR}
+    };
+    size_t tlvLength = 0;
+    size_t i;
+
+    printf("\n%s, %u records\n", payloadPtr->namePtr,
+           CountRecords(payloadPtr->dataNb, payloadPtr->data));
+    printf("%-24s %10s %10s %12s\n", "Format", "Bytes", "vs TLV", "Encode (ns)");
+
+    for (i = 0; i < (sizeof(formats) / sizeof(formats[0])); i++)
+    {
+        size_t length = 0;
+        double timeNs = MeasureSerialization(payloadPtr, formats[i].format, iterationNb, &length);
+
+        if (0 > timeNs)
+        {
+            printf("%s serialization failed\n", formats[i].namePtr);
+            return false;
+        }
+        if (0 == i)
+        {
+            tlvLength = length;
+        }
+        printf("%-24s %10zu %9.0f%% %12.1f\n", formats[i].namePtr, length,
+               ((double)length * 100) / (double)tlvLength, timeNs);
+    }
+
+    printf("%-24s %10zu %9.0f%%\n", "SenML-CBOR, no base name", GetFullNameCborLength(payloadPtr),
+           ((double)GetFullNameCborLength(payloadPtr) * 100) / (double)tlvLength);
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * SenML encoding benchmark
+ *
+ * @return
+ *  - EXIT_SUCCESS on success
+ *  - EXIT_FAILURE on failure
+ */
+//--------------------------------------------------------------------------------------------------
+int main
+(
+    int   argc,     ///< [IN] Number of arguments
+    char* argv[]    ///< [IN] Arguments
+)
+{
+    static Payload_t payloads[3];
+    int iterationNb = 200000;
+    int opt;
+    size_t i;
+
+    while (-1 != (opt = getopt(argc, argv, "n:")))
+    {
+        switch (opt)
+        {
+            case 'n':
+                iterationNb = atoi(optarg);
+                break;
+
+            default:
+                printf("Usage: %s [-n <iterations>]\n", argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+
+    if (0 >= iterationNb)
+    {
+        printf("Usage: %s [-n <iterations>]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    BuildDevice(&payloads[0]);
+    BuildConnectivity(&payloads[1]);
+    BuildTemperature(&payloads[2]);
+
+    printf("\n======== SenML encoding benchmark ========\n");
+
+    for (i = 0; i < (sizeof(payloads) / sizeof(payloads[0])); i++)
+    {
+        if (!MeasurePayload(&payloads[i], iterationNb))
+        {
+            printf("SenML encoding benchmark failed\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,470 @@
+/**
+ * @file signatureBenchmark.c
+ *
+ * Package signature verification benchmark.
+ *
+ * For each signature scheme supported by the Linux porting layer (RSA-PSS/SHA1,
+ * ECDSA P-256/SHA-256 and Ed25519/SHA-256), a synthetic DWL package is generated (see
+ * dwlGenerator.h) and its signature is verified through lwm2mcore_StartSha1(),
+ * lwm2mcore_ProcessSha1() and lwm2mcore_EndSha1().
+ *
+ * For each scheme, the benchmark reports:
+ *  - the digest throughput in MB/s
+ *  - the latency of lwm2mcore_EndSha1() when the public key is parsed, i.e. for the first
+ *    verification after the key is set
+ *  - the latency of lwm2mcore_EndSha1() with the cached public key
+ * The latencies are given in microseconds (mean, median, 99th percentile, maximum).
+ *
+ * Usage: signaturebenchmark [options]
+ *  -s <len>    Binary data length, with an optional K or M suffix (default: 4M)
+ *  -n <count>  Number of verifications for each latency (default: 200)
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <lwm2mcore/lwm2mcore.h>
+#include <lwm2mcore/security.h>
+#include "dwlGenerator.h"
+
+//--------------------------------------------------------------------------------------------------
+// Symbol and Enum definitions
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * DWL prolog length
+ */
+//--------------------------------------------------------------------------------------------------
+#define DWL_PROLOG_LEN      32
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Length of the data chunks given to lwm2mcore_ProcessSha1()
+ */
+//--------------------------------------------------------------------------------------------------
+#define DIGEST_CHUNK_LEN    (64 * 1024)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the saved digest context
+ */
+//--------------------------------------------------------------------------------------------------
+#define DIGEST_CTX_LEN      LWM2MCORE_HASH_STATE_MAX_LEN
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of bytes in a MB
+ */
+//--------------------------------------------------------------------------------------------------
+#define BYTES_PER_MB        (1024.0 * 1024.0)
+
+//--------------------------------------------------------------------------------------------------
+// Data structures
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Benchmarked signature scheme
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    dwlgen_SignatureType_t  signatureType;  ///< Signature scheme
+    const char*             namePtr;        ///< Scheme name
+}
+Scheme_t;
+
+//--------------------------------------------------------------------------------------------------
+// Static variables
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Benchmarked signature schemes
+ */
+//--------------------------------------------------------------------------------------------------
+static const Scheme_t Schemes[] =
+{
+    { DWLGEN_SIGN_RSA_PSS_SHA1,      "RSA-2048 PSS/SHA1"  },
+    { DWLGEN_SIGN_ECDSA_P256_SHA256, "ECDSA P-256/SHA256" },
+    { DWLGEN_SIGN_ED25519_SHA256,    "Ed25519/SHA256"     },
+};
+
+//--------------------------------------------------------------------------------------------------
+// Static functions
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the monotonic time, in microseconds
+ */
+//--------------------------------------------------------------------------------------------------
+static double GetTimeUs
+(
+    void
+)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((double)ts.tv_sec * 1e6) + ((double)ts.tv_nsec / 1e3);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compare two latencies, for qsort
+ */
+//--------------------------------------------------------------------------------------------------
+static int CompareLatencies
+(
+    const void* aPtr,       ///< [IN] First latency
+    const void* bPtr        ///< [IN] Second latency
+)
+{
+    double a = *(const double*)aPtr;
+    double b = *(const double*)bPtr;
+
+    return (a > b) - (a < b);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Print the statistics of a latency series
+ */
+//--------------------------------------------------------------------------------------------------
+static void PrintLatencies
+(
+    const char* namePtr,        ///< [IN] Series name
+    double*     latenciesPtr,   ///< [IN] Latencies, in microseconds (sorted by the function)
+    int         nb              ///< [IN] Number of latencies
+)
+{
+    double sum = 0;
+    int i;
+
+    qsort(latenciesPtr, (size_t)nb, sizeof(double), CompareLatencies);
+    for (i = 0; i < nb; i++)
+    {
+        sum += latenciesPtr[i];
+    }
+
+    printf("  %-22s %10.1f %10.1f %10.1f %10.1f\n",
+           namePtr,
+           sum / nb,
+           latenciesPtr[nb / 2],
+           latenciesPtr[(nb * 99) / 100],
+           latenciesPtr[nb - 1]);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parse a length with an optional K or M suffix
+ *
+ * @return
+ *  - Length
+ *  - 0 if the length is invalid
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t ParseLength
+(
+    const char* strPtr      ///< [IN] Length string
+)
+{
+    char* endPtr = NULL;
+    unsigned long long len = strtoull(strPtr, &endPtr, 0);
+
+    if ((!endPtr) || (endPtr == strPtr))
+    {
+        return 0;
+    }
+
+    switch (*endPtr)
+    {
+        case 'k':
+        case 'K':
+            len *= 1024;
+            break;
+
+        case 'm':
+        case 'M':
+            len *= 1024 * 1024;
+            break;
+
+        default:
+            break;
+    }
+
+    return (size_t)len;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the public key verifying the firmware packages. The parsed key cached by the porting layer
+ * is released.
+ *
+ * @return
+ *  - true  The key is set
+ *  - false The key can't be set
+ */
+//--------------------------------------------------------------------------------------------------
+static bool SetPackageKey
+(
+    dwlgen_Package_t* packagePtr    ///< [IN] Generated package
+)
+{
+    return (LWM2MCORE_ERR_COMPLETED_OK == lwm2mcore_SetCredential(LWM2MCORE_CREDENTIAL_FW_KEY,
+                                                                  LWM2MCORE_BS_SERVER_ID,
+                                                                  (char*)packagePtr->publicKey,
+                                                                  packagePtr->publicKeyLen));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compute the digest of the signed package data and save the digest context
+ *
+ * @return
+ *  - true  The digest context is saved
+ *  - false The digest computation failed
+ */
+//--------------------------------------------------------------------------------------------------
+static bool ComputeDigest
+(
+    dwlgen_Package_t* packagePtr,   ///< [IN] Generated package
+    uint8_t*          ctxBufPtr,    ///< [OUT] Saved digest context
+    double*           durationPtr   ///< [OUT] Digest computation duration, in microseconds
+)
+{
+    size_t signedLen = packagePtr->packageLen - DWL_PROLOG_LEN - packagePtr->signatureLen;
+    size_t offset;
+    void* ctxPtr = NULL;
+    double startTime = GetTimeUs();
+    bool result;
+
+    if (LWM2MCORE_ERR_COMPLETED_OK != lwm2mcore_StartSha1(LWM2MCORE_PKG_FW, &ctxPtr))
+    {
+        return false;
+    }
+
+    for (offset = 0; offset < signedLen; offset += DIGEST_CHUNK_LEN)
+    {
+        size_t len = signedLen - offset;
+
+        if (len > DIGEST_CHUNK_LEN)
+        {
+            len = DIGEST_CHUNK_LEN;
+        }
+        if (LWM2MCORE_ERR_COMPLETED_OK != lwm2mcore_ProcessSha1(ctxPtr,
+                                                                packagePtr->packagePtr + offset,
+                                                                len))
+        {
+            lwm2mcore_CancelSha1(&ctxPtr);
+            return false;
+        }
+    }
+    *durationPtr = GetTimeUs() - startTime;
+
+    result = (LWM2MCORE_ERR_COMPLETED_OK == lwm2mcore_CopySha1(ctxPtr, ctxBufPtr, DIGEST_CTX_LEN));
+    lwm2mcore_CancelSha1(&ctxPtr);
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Restore the saved digest context and verify the package signature
+ *
+ * @return
+ *  - true  The signature is valid
+ *  - false The signature is not valid or can't be verified
+ */
+//--------------------------------------------------------------------------------------------------
+static bool VerifySignature
+(
+    dwlgen_Package_t* packagePtr,   ///< [IN] Generated package
+    uint8_t*          ctxBufPtr,    ///< [IN] Saved digest context
+    double*           latencyPtr    ///< [OUT] lwm2mcore_EndSha1() latency, in microseconds
+)
+{
+    void* ctxPtr = NULL;
+    double startTime;
+    lwm2mcore_Sid_t sid;
+
+    if (LWM2MCORE_ERR_COMPLETED_OK != lwm2mcore_RestoreSha1(ctxBufPtr, DIGEST_CTX_LEN, &ctxPtr))
+    {
+        return false;
+    }
+
+    startTime = GetTimeUs();
+    sid = lwm2mcore_EndSha1(ctxPtr,
+                            LWM2MCORE_PKG_FW,
+                            packagePtr->packagePtr + packagePtr->packageLen
+                            - packagePtr->signatureLen,
+                            packagePtr->signatureLen);
+    *latencyPtr = GetTimeUs() - startTime;
+    lwm2mcore_CancelSha1(&ctxPtr);
+
+    return (LWM2MCORE_ERR_COMPLETED_OK == sid);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Benchmark a signature scheme
+ *
+ * @return
+ *  - true  The benchmark succeeded
+ *  - false A verification failed
+ */
+//--------------------------------------------------------------------------------------------------
+static bool RunScheme
+(
+    const Scheme_t* schemePtr,      ///< [IN] Signature scheme
+    size_t          binaryLen,      ///< [IN] Binary data length
+    int             verifyNb        ///< [IN] Number of verifications for each latency
+)
+{
+    dwlgen_Config_t config;
+    dwlgen_Package_t package;
+    uint8_t ctxBuf[DIGEST_CTX_LEN];
+    double* latenciesPtr;
+    double digestDuration;
+    bool result = true;
+    int i;
+
+    memset(&config, 0, sizeof(config));
+    config.binaryLen = binaryLen;
+    config.seed = 1;
+    config.signatureType = schemePtr->signatureType;
+
+    latenciesPtr = (double*)malloc((size_t)verifyNb * sizeof(double));
+    if (!latenciesPtr)
+    {
+        return false;
+    }
+
+    if (!dwlgen_Build(&config, &package))
+    {
+        printf("Unable to generate the DWL package\n");
+        free(latenciesPtr);
+        return false;
+    }
+
+    if ((!SetPackageKey(&package)) || (!ComputeDigest(&package, ctxBuf, &digestDuration)))
+    {
+        printf("Unable to compute the package digest\n");
+        result = false;
+    }
+
+    if (result)
+    {
+        printf("%s: %zu-byte signature, digest %.1f MB/s\n",
+               schemePtr->namePtr,
+               package.signatureLen,
+               ((double)package.packageLen / BYTES_PER_MB) / (digestDuration / 1e6));
+
+        // The key is set again before each verification: it is parsed by lwm2mcore_EndSha1()
+        for (i = 0; (i < verifyNb) && (result); i++)
+        {
+            result = (SetPackageKey(&package)) && (VerifySignature(&package,
+                                                                   ctxBuf,
+                                                                   &latenciesPtr[i]));
+        }
+        if (result)
+        {
+            PrintLatencies("key parsing", latenciesPtr, verifyNb);
+        }
+    }
+
+    if (result)
+    {
+        for (i = 0; (i < verifyNb) && (result); i++)
+        {
+            result = VerifySignature(&package, ctxBuf, &latenciesPtr[i]);
+        }
+        if (result)
+        {
+            PrintLatencies("cached key", latenciesPtr, verifyNb);
+        }
+    }
+
+    if (!result)
+    {
+        printf("%s: signature verification failed\n", schemePtr->namePtr);
+    }
+
+    dwlgen_Free(&package);
+    free(latenciesPtr);
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Print the tool usage
+ */
+//--------------------------------------------------------------------------------------------------
+static void PrintUsage
+(
+    const char* namePtr     ///< [IN] Program name
+)
+{
+    printf("Usage: %s [-s <binary length>] [-n <verifications>]\n", namePtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Signature verification benchmark entry point
+ */
+//--------------------------------------------------------------------------------------------------
+int main
+(
+    int   argc,     ///< [IN] Number of arguments
+    char* argv[]    ///< [IN] Arguments
+)
+{
+    size_t binaryLen = 4 * 1024 * 1024;
+    int verifyNb = 200;
+    size_t i;
+    int opt;
+
+    while (-1 != (opt = getopt(argc, argv, "s:n:")))
+    {
+        switch (opt)
+        {
+            case 's':
+                binaryLen = ParseLength(optarg);
+                break;
+
+            case 'n':
+                verifyNb = atoi(optarg);
+                break;
+
+            default:
+                PrintUsage(argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+
+    if ((!binaryLen) || (verifyNb <= 0))
+    {
+        PrintUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    printf("\n======== Package signature verification benchmark ========\n");
+    printf("Binary data of %zu bytes, %d verifications, latencies in us\n", binaryLen, verifyNb);
+    printf("  %-22s %10s %10s %10s %10s\n", "lwm2mcore_EndSha1", "mean", "p50", "p99", "max");
+
+    for (i = 0; i < sizeof(Schemes) / sizeof(Schemes[0]); i++)
+    {
+        if (!RunScheme(&Schemes[i], binaryLen, verifyNb))
+        {
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,612 @@
+/**
+ * @file startupBenchmark.c
+ *
+ * Startup time benchmark: time from lwm2mcore_Init to the registration to a server.
+ *
+ * A local server stand-in answers to the registration requests on the loopback interface, and
+ * the client is cold started several times: lwm2mcore_Init, lwm2mcore_ObjectRegister,
+ * lwm2mcore_Connect, connection to the server and registration. As the LwM2M engine is stubbed
+ * in the test build, the benchmark does what the engine does once the client is connected: it
+ * connects to the server through lwm2m_connect_server(), sends a registration request to the
+ * stand-in and notifies the registration when the stand-in answers.
+ *
+ * The benchmark reports, for each startup phase given by lwm2mcore_GetStartupProfile(), the time
+ * since lwm2mcore_Init (mean, median, maximum), and the time of the server address resolution
+ * alone: as the server address is resolved while the objects are registered, the time between the
+ * socket opening and the server connection can be shorter than this resolution time.
+ *
+ * Usage: startupbenchmark [options]
+ *  -n <count>  Number of cold starts (default: 20)
+ *  -r <ms>     Response delay of the server stand-in, in milliseconds (default: 0)
+ *  -h <host>   Host name of the server stand-in, resolved to a local address (default: localhost)
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <poll.h>
+#include <pthread.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include "liblwm2m.h"
+#include <lwm2mcore/lwm2mcore.h>
+#include <lwm2mcore/timer.h>
+#include <lwm2mcore/udp.h>
+#include <sessionManager/sessionManager.h>
+#include "clientConfig.h"
+
+//--------------------------------------------------------------------------------------------------
+// Symbol and Enum definitions
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Client configuration file, in the benchmark working directory
+ */
+//--------------------------------------------------------------------------------------------------
+#define CONFIG_FILE             "clientConfig.txt"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Client endpoint
+ */
+//--------------------------------------------------------------------------------------------------
+#define ENDPOINT                "startup"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum CoAP message length exchanged with the server stand-in
+ */
+//--------------------------------------------------------------------------------------------------
+#define COAP_MSG_MAX_LEN        64
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Time to wait for the registration response, in milliseconds
+ */
+//--------------------------------------------------------------------------------------------------
+#define REGISTER_TIMEOUT_MS     5000
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Polling period of the server stand-in, to check the end of the benchmark, in milliseconds
+ */
+//--------------------------------------------------------------------------------------------------
+#define SERVER_POLL_MS          100
+
+//--------------------------------------------------------------------------------------------------
+// Data structures
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Local server stand-in
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    int             sock;           ///< Server socket
+    uint16_t        port;           ///< Server port
+    int             delayMs;        ///< Response delay, in milliseconds
+    volatile bool   isStopped;      ///< The server must stop
+    pthread_t       thread;         ///< Server thread
+}
+Server_t;
+
+//--------------------------------------------------------------------------------------------------
+// Static variables
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Startup phase names
+ */
+//--------------------------------------------------------------------------------------------------
+static const char* PhaseNames[LWM2MCORE_STARTUP_PHASE_MAX] =
+{
+    "init",
+    "objects registered",
+    "socket opened",
+    "server connected",
+    "authenticated",
+    "registered",
+};
+
+//--------------------------------------------------------------------------------------------------
+// Static functions
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Status event callback
+ *
+ * @return
+ *  - 0
+ */
+//--------------------------------------------------------------------------------------------------
+static int EventHandler
+(
+    lwm2mcore_Status_t status       ///< [IN] Status event
+)
+{
+    (void)status;
+    return 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compare two latencies, for qsort
+ */
+//--------------------------------------------------------------------------------------------------
+static int CompareLatencies
+(
+    const void* aPtr,       ///< [IN] First latency
+    const void* bPtr        ///< [IN] Second latency
+)
+{
+    double a = *(const double*)aPtr;
+    double b = *(const double*)bPtr;
+
+    return (a > b) - (a < b);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Print the statistics of a latency series
+ */
+//--------------------------------------------------------------------------------------------------
+static void PrintLatencies
+(
+    const char* namePtr,        ///< [IN] Series name
+    double*     latenciesPtr,   ///< [IN] Latencies, in microseconds (sorted by the function)
+    int         nb              ///< [IN] Number of latencies
+)
+{
+    double sum = 0;
+    int i;
+
+    if (!nb)
+    {
+        printf("  %-22s %10s %10s %10s\n", namePtr, "-", "-", "-");
+        return;
+    }
+
+    qsort(latenciesPtr, (size_t)nb, sizeof(double), CompareLatencies);
+    for (i = 0; i < nb; i++)
+    {
+        sum += latenciesPtr[i];
+    }
+
+    printf("  %-22s %10.1f %10.1f %10.1f\n",
+           namePtr,
+           sum / nb,
+           latenciesPtr[nb / 2],
+           latenciesPtr[nb - 1]);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Server stand-in thread: acknowledge each request with a 2.01 Created response
+ */
+//--------------------------------------------------------------------------------------------------
+static void* ServerThread
+(
+    void* contextPtr        ///< [IN] Server stand-in
+)
+{
+    Server_t* serverPtr = (Server_t*)contextPtr;
+    uint8_t msg[COAP_MSG_MAX_LEN];
+    struct sockaddr_storage addr;
+    socklen_t addrLen;
+    struct pollfd fds;
+    ssize_t len;
+
+    fds.fd = serverPtr->sock;
+    fds.events = POLLIN;
+
+    while (!serverPtr->isStopped)
+    {
+        if (0 >= poll(&fds, 1, SERVER_POLL_MS))
+        {
+            continue;
+        }
+
+        addrLen = sizeof(addr);
+        len = recvfrom(serverPtr->sock, msg, sizeof(msg), 0, (struct sockaddr*)&addr, &addrLen);
+        if (4 > len)
+        {
+            continue;
+        }
+
+        if (serverPtr->delayMs)
+        {
+            usleep((useconds_t)serverPtr->delayMs * 1000);
+        }
+
+        // Piggybacked ACK with the message id of the request, no token
+        msg[0] = 0x60;
+        msg[1] = 0x41;
+        sendto(serverPtr->sock, msg, 4, 0, (struct sockaddr*)&addr, addrLen);
+    }
+
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start the server stand-in on an ephemeral port
+ *
+ * @return
+ *  - true on success
+ *  - false on failure
+ */
+//--------------------------------------------------------------------------------------------------
+static bool StartServer
+(
+    Server_t* serverPtr     ///< [INOUT] Server stand-in
+)
+{
+    struct sockaddr_in addr;
+    socklen_t addrLen = sizeof(addr);
+
+    serverPtr->sock = socket(AF_INET, SOCK_DGRAM, 0);
+    if (0 > serverPtr->sock)
+    {
+        return false;
+    }
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = 0;
+    if (   (0 != bind(serverPtr->sock, (struct sockaddr*)&addr, sizeof(addr)))
+        || (0 != getsockname(serverPtr->sock, (struct sockaddr*)&addr, &addrLen))
+       )
+    {
+        close(serverPtr->sock);
+        return false;
+    }
+    serverPtr->port = ntohs(addr.sin_port);
+    serverPtr->isStopped = false;
+
+    if (0 != pthread_create(&serverPtr->thread, NULL, ServerThread, serverPtr))
+    {
+        close(serverPtr->sock);
+        return false;
+    }
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stop the server stand-in
+ */
+//--------------------------------------------------------------------------------------------------
+static void StopServer
+(
+    Server_t* serverPtr     ///< [INOUT] Server stand-in
+)
+{
+    serverPtr->isStopped = true;
+    pthread_join(serverPtr->thread, NULL);
+    close(serverPtr->sock);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write the client configuration, with the server stand-in as bootstrap server, and load it
+ *
+ * @return
+ *  - true on success
+ *  - false on failure
+ */
+//--------------------------------------------------------------------------------------------------
+static bool SetClientConfig
+(
+    const char* hostPtr,    ///< [IN] Server host name
+    uint16_t    port        ///< [IN] Server port
+)
+{
+    clientConfig_t* configPtr = NULL;
+    FILE* filePtr;
+
+    filePtr = fopen(CONFIG_FILE, "w");
+    if (!filePtr)
+    {
+        return false;
+    }
+
+    fprintf(filePtr, "[GENERAL]\n");
+    fprintf(filePtr, "ENDPOINT = %s\n", ENDPOINT);
+    fprintf(filePtr, "SN = LWM2MCORE12345\n\n");
+    fprintf(filePtr, "[BOOTSTRAP SECURITY]\n");
+    fprintf(filePtr, "SERVER URI = coap://%s:%u\n", hostPtr, port);
+    fprintf(filePtr, "DEVICE PKID = 11111\n");
+    fprintf(filePtr, "SECRET KEY = 3232323232\n\n");
+    fprintf(filePtr, "[LWM2M SECURITY]\n");
+    fclose(filePtr);
+
+    return (0 == clientConfigRead(&configPtr)) && (NULL != configPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Register to the server stand-in as the LwM2M engine does, and notify the registration
+ *
+ * @return
+ *  - true on success
+ *  - false on failure
+ */
+//--------------------------------------------------------------------------------------------------
+static bool Register
+(
+    smanager_ClientData_t* dataPtr,     ///< [IN] Client context
+    dtls_Connection_t*     connPtr      ///< [IN] Connection to the server
+)
+{
+    static uint16_t mid = 0;
+    uint8_t msg[COAP_MSG_MAX_LEN];
+    size_t len = 0;
+    struct pollfd fds;
+
+    // CON POST /rd?ep=<endpoint>
+    mid++;
+    msg[len++] = 0x40;
+    msg[len++] = 0x02;
+    msg[len++] = (uint8_t)(mid >> 8);
+    msg[len++] = (uint8_t)mid;
+    msg[len++] = 0xB2;
+    msg[len++] = 'r';
+    msg[len++] = 'd';
+    msg[len++] = 0x40 | (uint8_t)(strlen("ep=" ENDPOINT));
+    memcpy(msg + len, "ep=" ENDPOINT, strlen("ep=" ENDPOINT));
+    len += strlen("ep=" ENDPOINT);
+
+    if (0 > lwm2mcore_UdpSend(dataPtr->sock,
+                              msg,
+                              len,
+                              0,
+                              (struct sockaddr*)&connPtr->addr,
+                              (socklen_t)connPtr->addrLen))
+    {
+        return false;
+    }
+
+    fds.fd = dataPtr->sock;
+    fds.events = POLLIN;
+    if (   (0 >= poll(&fds, 1, REGISTER_TIMEOUT_MS))
+        || (4 > recv(dataPtr->sock, msg, sizeof(msg), 0))
+        || (0x41 != msg[1])
+       )
+    {
+        return false;
+    }
+
+    smanager_SendSessionEvent(EVENT_TYPE_REGISTRATION, EVENT_STATUS_DONE_SUCCESS);
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Cold start the client and register to the server stand-in
+ *
+ * @return
+ *  - true on success
+ *  - false on failure
+ */
+//--------------------------------------------------------------------------------------------------
+static bool ColdStart
+(
+    lwm2mcore_StartupProfile_t* profilePtr  ///< [OUT] Startup profile
+)
+{
+    char endpoint[] = ENDPOINT;
+    smanager_ClientData_t* dataPtr;
+    dtls_Connection_t* connPtr;
+    lwm2mcore_Ref_t ref;
+    bool result = false;
+
+    ref = lwm2mcore_Init(EventHandler);
+    if (!ref)
+    {
+        return false;
+    }
+    dataPtr = (smanager_ClientData_t*)ref;
+
+    if (   (lwm2mcore_ObjectRegister(ref, endpoint, NULL, NULL))
+        && (NULL != dataPtr->securityObjPtr->instanceList)
+        && (lwm2mcore_Connect(ref))
+       )
+    {
+        connPtr = (dtls_Connection_t*)lwm2m_connect_server(
+                                                    dataPtr->securityObjPtr->instanceList->id,
+                                                    dataPtr);
+        result = (NULL != connPtr)
+                 && Register(dataPtr, connPtr)
+                 && lwm2mcore_GetStartupProfile(profilePtr);
+        lwm2mcore_Disconnect(ref);
+    }
+
+    lwm2mcore_Free(ref);
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Measure the time of the server address resolution alone, in microseconds
+ *
+ * @return
+ *  - Resolution time
+ *  - negative value on failure
+ */
+//--------------------------------------------------------------------------------------------------
+static double ResolveAddress
+(
+    const char* hostPtr     ///< [IN] Server host name
+)
+{
+    struct addrinfo hints;
+    struct addrinfo* addrListPtr = NULL;
+    uint64_t startTime;
+    uint64_t endTime;
+
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+
+    startTime = lwm2mcore_GetTimeUs();
+    if (0 != getaddrinfo(hostPtr, "5683", &hints, &addrListPtr))
+    {
+        return -1;
+    }
+    endTime = lwm2mcore_GetTimeUs();
+    freeaddrinfo(addrListPtr);
+
+    return (double)(endTime - startTime);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Print the tool usage
+ */
+//--------------------------------------------------------------------------------------------------
+static void PrintUsage
+(
+    const char* namePtr     ///< [IN] Program name
+)
+{
+    printf("Usage: %s [-n <cold starts>] [-r <response delay ms>] [-h <host>]\n", namePtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Startup time benchmark entry point
+ */
+//--------------------------------------------------------------------------------------------------
+int main
+(
+    int   argc,     ///< [IN] Number of arguments
+    char* argv[]    ///< [IN] Arguments
+)
+{
+    char workDir[] = "/tmp/startupbenchXXXXXX";
+    const char* hostPtr = "localhost";
+    lwm2mcore_StartupProfile_t profile;
+    double* timesPtr[LWM2MCORE_STARTUP_PHASE_MAX];
+    double* resolutionTimesPtr;
+    int phaseNb[LWM2MCORE_STARTUP_PHASE_MAX];
+    Server_t server;
+    int startNb = 20;
+    int result = EXIT_SUCCESS;
+    int phase;
+    int opt;
+    int i;
+
+    memset(&server, 0, sizeof(server));
+
+    while (-1 != (opt = getopt(argc, argv, "n:r:h:")))
+    {
+        switch (opt)
+        {
+            case 'n':
+                startNb = atoi(optarg);
+                break;
+
+            case 'r':
+                server.delayMs = atoi(optarg);
+                break;
+
+            case 'h':
+                hostPtr = optarg;
+                break;
+
+            default:
+                PrintUsage(argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+
+    if ((startNb <= 0) || (server.delayMs < 0))
+    {
+        PrintUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    // The client configuration and parameters are written in a dedicated directory
+    if ((!mkdtemp(workDir)) || (0 != chdir(workDir)))
+    {
+        printf("Failed to create the working directory\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!StartServer(&server))
+    {
+        printf("Failed to start the server stand-in\n");
+        return EXIT_FAILURE;
+    }
+
+    if (!SetClientConfig(hostPtr, server.port))
+    {
+        printf("Failed to set the client configuration\n");
+        StopServer(&server);
+        return EXIT_FAILURE;
+    }
+
+    for (phase = 0; phase < LWM2MCORE_STARTUP_PHASE_MAX; phase++)
+    {
+        timesPtr[phase] = (double*)malloc((size_t)startNb * sizeof(double));
+        phaseNb[phase] = 0;
+    }
+    resolutionTimesPtr = (double*)malloc((size_t)startNb * sizeof(double));
+
+    for (i = 0; (i < startNb) && (EXIT_SUCCESS == result); i++)
+    {
+        resolutionTimesPtr[i] = ResolveAddress(hostPtr);
+        if ((0 > resolutionTimesPtr[i]) || (!ColdStart(&profile)))
+        {
+            printf("Cold start %d failed\n", i);
+            result = EXIT_FAILURE;
+            break;
+        }
+
+        for (phase = 0; phase < LWM2MCORE_STARTUP_PHASE_MAX; phase++)
+        {
+            if (profile.phaseMask & (1 << phase))
+            {
+                timesPtr[phase][phaseNb[phase]++] = (double)profile.elapsedUs[phase];
+            }
+        }
+    }
+
+    if (EXIT_SUCCESS == result)
+    {
+        printf("\n======== Startup time benchmark ========\n");
+        printf("%d cold starts, server stand-in %s:%u with a response delay of %d ms\n",
+               startNb, hostPtr, server.port, server.delayMs);
+        printf("Time since lwm2mcore_Init, in us\n");
+        printf("  %-22s %10s %10s %10s\n", "phase", "mean", "p50", "max");
+        for (phase = 0; phase < LWM2MCORE_STARTUP_PHASE_MAX; phase++)
+        {
+            PrintLatencies(PhaseNames[phase], timesPtr[phase], phaseNb[phase]);
+        }
+        printf("Server address resolution alone, in us\n");
+        PrintLatencies("resolution", resolutionTimesPtr, startNb);
+    }
+
+    for (phase = 0; phase < LWM2MCORE_STARTUP_PHASE_MAX; phase++)
+    {
+        free(timesPtr[phase]);
+    }
+    free(resolutionTimesPtr);
+    StopServer(&server);
+    printf("Client files kept in %s\n", workDir);
+
+    return result;
+}
@@ -11,12 +11,50 @@
 
 #include <stdio.h>
 #include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
 #include "internals.h"
 #include "liblwm2m.h"
 #include <lwm2mcore/lwm2mcore.h>
+#include <lwm2mcore/security.h>
+#include <lwm2mcore/udp.h>
+#include <lwm2mcore/statistics.h>
+#include <lwm2mcore/heap.h>
+#include <lwm2mcore/trace.h>
+#include <lwm2mcore/timer.h>
+#include <lwm2mcore/send.h>
+#include <lwm2mcore/queueMode.h>
+#include <lwm2mcore/observe.h>
+#include <lwm2mcore/connStats.h>
 #include <objectManager/objects.h>
+#include <objectManager/handlers.h>
+#include <objectManager/utils.h>
+#include <objectManager/paramCache.h>
+#include <objectManager/senml.h>
+#include <objectManager/sendBuffer.h>
+#include <objectManager/composite.h>
+#include <objectManager/connStats.h>
+#include <objectManager/observe.h>
+#include <objectManager/coapRequests.h>
+#include <objectManager/operationStats.h>
 #include <sessionManager/sessionManager.h>
+#include <sessionManager/coapMetrics.h>
+#include <sessionManager/queueMode.h>
+#include <sessionManager/traceBuffer.h>
+#include <packageDownloader/lwm2mcorePackageDownloader.h>
 #include <lwm2mcore/coapHandlers.h>
+#include "dwlGenerator.h"
+#include "clientConfig.h"
+#include "memPool.h"
+#include "packageStorage.h"
+#include "paramStore.h"
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -36,6 +74,110 @@
 //--------------------------------------------------------------------------------------------------
 #define MAX_LEN_PAYLOAD  100
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Length of the binary data of the test DWL packages
+ */
+//--------------------------------------------------------------------------------------------------
+#define TEST_DWL_BINARY_LEN     (1024 * 1024 + 13)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Length of the comments of each section of the test DWL packages
+ */
+//--------------------------------------------------------------------------------------------------
+#define TEST_DWL_COMMENT_LEN    64
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Length of the data downloaded before each suspend, for the download resume test
+ */
+//--------------------------------------------------------------------------------------------------
+#define TEST_DWL_SUSPEND_LEN    100000
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of concurrent connections to the HTTP server stand-in
+ */
+//--------------------------------------------------------------------------------------------------
+#define TEST_DWL_CONNECTIONS    4
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Length of the data chunks sent by the HTTP server stand-in
+ */
+//--------------------------------------------------------------------------------------------------
+#define TEST_DWL_CHUNK_LEN      1400
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximal latency injected by the HTTP server stand-in before sending a chunk, in ticks
+ */
+//--------------------------------------------------------------------------------------------------
+#define TEST_DWL_MAX_LATENCY    40
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * DWL prolog length, and length of the binary data of the signature verification test packages
+ */
+//--------------------------------------------------------------------------------------------------
+#define TEST_DWL_PROLOG_LEN         32
+#define TEST_DWL_SIGN_BINARY_LEN    (64 * 1024 + 5)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * File storing the test package binary data, and checkpoint interval of the package storage
+ */
+//--------------------------------------------------------------------------------------------------
+#define TEST_PKG_STORAGE_FILE       "pkgStorageTest.bin"
+#define TEST_PKG_STORAGE_CHECKPOINT (64 * 1024)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * File storing a package pushed by the server, on the Linux platform
+ */
+//--------------------------------------------------------------------------------------------------
+#define TEST_PUSH_PACKAGE_FILE      "package_push"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Length of the write queue of the asynchronous storage stand-in
+ */
+//--------------------------------------------------------------------------------------------------
+#define TEST_ASYNC_QUEUE_LEN        (16 * 1024)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parameter store file of the parameter store test, and number of crash iterations
+ */
+//--------------------------------------------------------------------------------------------------
+#define TEST_PARAM_STORE_FILE       "paramStoreTest.db"
+#define TEST_PARAM_STORE_CRASHES    10
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Client configuration file used by the credential tests, saved during the tests
+ */
+//--------------------------------------------------------------------------------------------------
+#define TEST_CLIENT_CONFIG_FILE     "clientConfig.txt"
+#define TEST_CLIENT_CONFIG_BACKUP   "clientConfig.txt.bak"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of security object instances of the bootstrap configuration test: the last ones have
+ * non-contiguous instance Ids, higher than LWM2MCORE_BS_INSTANCE_MAX_NB
+ */
+//--------------------------------------------------------------------------------------------------
+#define TEST_BS_SECURITY_NB         (LWM2MCORE_BS_INSTANCE_MAX_NB + 2)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Instance Ids of the bootstrap configuration test, higher than LWM2MCORE_BS_INSTANCE_MAX_NB
+ */
+//--------------------------------------------------------------------------------------------------
+#define TEST_BS_SECURITY_HIGH_ID    40000
+#define TEST_BS_SERVER_HIGH_ID      300
+
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -65,6 +207,107 @@ static lwm2mcore_CoapResponse_t Lwm2mServerResponse;
 //--------------------------------------------------------------------------------------------------
 static lwm2mcore_CoapRequest_t* RequestPtr;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum length of a CoAP message exchanged with the LwM2M server stand-in
+ */
+//--------------------------------------------------------------------------------------------------
+#define TEST_COAP_MESSAGE_MAX_LEN   1152
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Short server Id of the LwM2M server stand-in
+ */
+//--------------------------------------------------------------------------------------------------
+#define TEST_SHORT_SERVER_ID        1
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * LwM2M server stand-in: socket receiving the messages of the client, and its address which is the
+ * source of the requests given to the client
+ */
+//--------------------------------------------------------------------------------------------------
+static int TestServerSock = -1;
+static struct sockaddr_in TestServerAddr;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Socket of the client connection to the LwM2M server stand-in
+ */
+//--------------------------------------------------------------------------------------------------
+static int TestClientSock = -1;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Connection to the HTTP server stand-in
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    lwm2mcore_PackageRange_t range;     ///< Remaining data of the requested range
+    uint32_t                 readyTick; ///< Tick at which the next chunk is received
+}
+TestConnection_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test DWL package served by the HTTP server stand-in
+ */
+//--------------------------------------------------------------------------------------------------
+static dwlgen_Package_t TestPackage;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Package length between two download suspends (0 if no suspend), package offset of the next
+ * suspend, and suspend indication
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t TestSuspendLen;
+static size_t TestSuspendOffset;
+static bool TestIsSuspended;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Binary data stored by the package downloader
+ */
+//--------------------------------------------------------------------------------------------------
+static uint8_t* TestStoredPtr;
+static size_t TestStoredLen;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Last firmware update state and result set by the package downloader
+ */
+//--------------------------------------------------------------------------------------------------
+static lwm2mcore_FwUpdateState_t TestFwUpdateState;
+static lwm2mcore_FwUpdateResult_t TestFwUpdateResult;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of chunks received before the preceding data, and maximal length of requested data
+ * ahead of the first missing byte
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t TestOutOfOrderCount;
+static uint64_t TestMaxAheadLen;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Retransmission of the chunks received before the preceding data by the HTTP server stand-in
+ */
+//--------------------------------------------------------------------------------------------------
+static bool TestResendChunks;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Asynchronous download: transfer start offset, length of data in the storage write queue and
+ * number of times the storage was busy
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t TestTransferOffset;
+static size_t TestStoreQueueLen;
+static uint32_t TestStoreBusyCount;
+
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -140,6 +383,272 @@ static int EventHandler
     return result;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Open the LwM2M server stand-in: a UDP socket on the loopback interface, and a plain-text client
+ * connection to this socket used as the session of the registered server
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestServerOpen
+(
+    lwm2m_server_t* serverPtr           ///< [IN] Registered server
+)
+{
+    smanager_ClientData_t* dataPtr = (smanager_ClientData_t*)Lwm2mcoreRef;
+    dtls_Connection_t* connPtr;
+    socklen_t addrLen = sizeof(TestServerAddr);
+
+    TestServerSock = socket(AF_INET, SOCK_DGRAM, 0);
+    TestClientSock = socket(AF_INET, SOCK_DGRAM, 0);
+    TEST_ASSERT((0 <= TestServerSock) && (0 <= TestClientSock));
+
+    memset(&TestServerAddr, 0, sizeof(TestServerAddr));
+    TestServerAddr.sin_family = AF_INET;
+    TestServerAddr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    TEST_ASSERT(bind(TestServerSock, (struct sockaddr*)&TestServerAddr, addrLen) == 0);
+    TEST_ASSERT(getsockname(TestServerSock, (struct sockaddr*)&TestServerAddr, &addrLen) == 0);
+
+    connPtr = dtls_HandleNewIncoming(dataPtr->connListPtr, TestClientSock,
+                                     (struct sockaddr*)&TestServerAddr, addrLen);
+    TEST_ASSERT(connPtr != NULL);
+    lwm2m_free(connPtr->dtlsSessionPtr);
+    connPtr->dtlsSessionPtr = NULL;
+    connPtr->securityObjPtr = dataPtr->securityObjPtr;
+    connPtr->securityInstId = serverPtr->secObjInstID;
+    connPtr->lwm2mHPtr = dataPtr->lwm2mHPtr;
+    dataPtr->connListPtr = connPtr;
+    serverPtr->sessionH = connPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Close the LwM2M server stand-in
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestServerClose
+(
+    void
+)
+{
+    close(TestServerSock);
+    close(TestClientSock);
+    TestServerSock = -1;
+    TestClientSock = -1;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Receive a message of the client on the LwM2M server stand-in
+ *
+ * @return
+ *      - Message length
+ *      - 0 if no message is received within 100 ms
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t TestServerReceive
+(
+    uint8_t* bufferPtr,                 ///< [OUT] Message
+    size_t size                         ///< [IN] Buffer size
+)
+{
+    struct pollfd pfd;
+    ssize_t len;
+
+    pfd.fd = TestServerSock;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    if (0 >= poll(&pfd, 1, 100))
+    {
+        return 0;
+    }
+
+    len = recv(TestServerSock, bufferPtr, size, 0);
+    TEST_ASSERT(len > 0);
+    return (size_t)len;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Receive the pending messages of the client on the LwM2M server stand-in
+ *
+ * @return
+ *      - Number of messages
+ */
+//--------------------------------------------------------------------------------------------------
+static int TestServerCount
+(
+    void
+)
+{
+    uint8_t buffer[TEST_COAP_MESSAGE_MAX_LEN];
+    int count = 0;
+
+    while (TestServerReceive(buffer, sizeof(buffer)))
+    {
+        count++;
+    }
+
+    return count;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send a request of the LwM2M server stand-in to the client, through the UDP receive callback
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestServerRequest
+(
+    const uint8_t* requestPtr,          ///< [IN] CoAP message
+    size_t len                          ///< [IN] Message length
+)
+{
+    uint8_t buffer[TEST_COAP_MESSAGE_MAX_LEN];
+    struct sockaddr_storage addr;
+    lwm2mcore_SocketConfig_t config;
+
+    TEST_ASSERT(len <= sizeof(buffer));
+    memcpy(buffer, requestPtr, len);
+    memset(&addr, 0, sizeof(addr));
+    memcpy(&addr, &TestServerAddr, sizeof(TestServerAddr));
+    memset(&config, 0, sizeof(config));
+    config.instanceRef = Lwm2mcoreRef;
+
+    lwm2mcore_UdpReceiveCb(buffer, (uint32_t)len, &addr, sizeof(TestServerAddr), config);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get an unsigned integer option of a CoAP message received by the LwM2M server stand-in
+ *
+ * @return
+ *      - true if the option is present
+ *      - false otherwise
+ */
+//--------------------------------------------------------------------------------------------------
+static bool TestCoapGetOption
+(
+    const uint8_t* messagePtr,          ///< [IN] CoAP message
+    size_t len,                         ///< [IN] Message length
+    uint16_t number,                    ///< [IN] Option number
+    uint32_t* valuePtr                  ///< [OUT] Option value
+)
+{
+    size_t pos = 4 + (messagePtr[0] & 0x0F);
+    uint16_t current = 0;
+
+    while ((pos < len) && (0xFF != messagePtr[pos]))
+    {
+        uint16_t delta = messagePtr[pos] >> 4;
+        size_t optionLen = messagePtr[pos] & 0x0F;
+        size_t i;
+
+        pos++;
+        if (13 == delta)
+        {
+            delta = (uint16_t)(13 + messagePtr[pos++]);
+        }
+        current = (uint16_t)(current + delta);
+
+        if (current == number)
+        {
+            *valuePtr = 0;
+            for (i = 0; i < optionLen; i++)
+            {
+                *valuePtr = (*valuePtr << 8) | messagePtr[pos + i];
+            }
+            return true;
+        }
+        pos += optionLen;
+    }
+
+    return false;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the payload of a CoAP message received by the LwM2M server stand-in
+ *
+ * @return
+ *      - Payload length, 0 if the message has no payload
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t TestCoapGetPayload
+(
+    const uint8_t* messagePtr,          ///< [IN] CoAP message
+    size_t len,                         ///< [IN] Message length
+    const uint8_t** payloadPtr          ///< [OUT] Payload
+)
+{
+    size_t pos = 4 + (messagePtr[0] & 0x0F);
+
+    while ((pos < len) && (0xFF != messagePtr[pos]))
+    {
+        size_t optionLen = messagePtr[pos] & 0x0F;
+
+        pos += (13 == (messagePtr[pos] >> 4)) ? 2 : 1;
+        pos += optionLen;
+    }
+
+    *payloadPtr = messagePtr + pos + 1;
+    return (pos < len) ? (len - pos - 1) : 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Receive a Send request of the client on the LwM2M server stand-in: a confirmable POST on /dp
+ * with a token and a SenML-CBOR payload
+ *
+ * @return
+ *      - Request length
+ *      - 0 if no message is received within 100 ms
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t TestSendReceive
+(
+    uint8_t* requestPtr,                ///< [OUT] Request
+    size_t size                         ///< [IN] Request buffer size
+)
+{
+    size_t len = TestServerReceive(requestPtr, size);
+    size_t pos = 4 + (requestPtr[0] & 0x0F);
+    uint32_t value;
+
+    if (0 == len)
+    {
+        return 0;
+    }
+
+    TEST_ASSERT(((requestPtr[0] & 0xF0) == 0x40) && (requestPtr[1] == 0x02));
+    TEST_ASSERT(((requestPtr[0] & 0x0F) != 0) && (len > (pos + 3)));
+    TEST_ASSERT((requestPtr[pos] == 0xB2) && (memcmp(requestPtr + pos + 1, "dp", 2) == 0));
+    TEST_ASSERT(TestCoapGetOption(requestPtr, len, 12, &value)
+                && (value == LWM2MCORE_CONTENT_SENML_CBOR));
+    return len;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Answer a Send request by the LwM2M server stand-in: acknowledgement with a response code and the
+ * token of the request, or reset
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestSendAck
+(
+    const uint8_t* requestPtr,          ///< [IN] Send request
+    uint8_t code                        ///< [IN] Response code, 0 for a reset
+)
+{
+    uint8_t message[4 + 8];
+    size_t tokenLen = (0 == code) ? 0 : (requestPtr[0] & 0x0F);
+
+    message[0] = (uint8_t)(((0 == code) ? 0x70 : 0x60) | tokenLen);
+    message[1] = code;
+    message[2] = requestPtr[2];
+    message[3] = requestPtr[3];
+    memcpy(message + 4, requestPtr + 4, tokenLen);
+    TestServerRequest(message, 4 + tokenLen);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Test function for lwm2mcore_Init API
@@ -187,6 +696,7 @@ static void test_lwm2mcore_Disconnect
     TEST_ASSERT(lwm2mcore_Disconnect(NULL) == false);
     printf("Lwm2mcoreRef is %p\n", Lwm2mcoreRef);
     TEST_ASSERT(lwm2mcore_Disconnect(Lwm2mcoreRef) == true);
+    TestServerClose();
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -227,10 +737,14 @@ static void test_lwm2mcore_Update
 
     memset(targetP, 0, sizeof(lwm2m_server_t));
     targetP->secObjInstID = 123;
-    targetP->shortID = 1;
+    targetP->shortID = TEST_SHORT_SERVER_ID;
+    targetP->status = STATE_REGISTERED;
     dataPtr->lwm2mHPtr->serverList = (lwm2m_server_t*)LWM2M_LIST_ADD(dataPtr->lwm2mHPtr->serverList,
                                                                      targetP);
 
+    /* The messages of the client to this server are received by the server stand-in */
+    TestServerOpen(targetP);
+
     TEST_ASSERT(lwm2mcore_Update(Lwm2mcoreRef) == true);
 }
 
@@ -252,15 +766,595 @@ static void test_lwm2mcore_Push
 
 //-------------------------------------------------------------------------------------------------
 /**
- * Test function for lwm2m_connect_server API
+ * Test function for the LwM2M Send operation
  */
 //--------------------------------------------------------------------------------------------------
-void test_lwm2m_connect_server
+static void test_lwm2mcore_Send
 (
     void
 )
 {
-    smanager_ClientData_t* dataPtr = (smanager_ClientData_t*)Lwm2mcoreRef;
+    /* Manufacturer and battery level of the device object, recorded 10 seconds apart */
+    const uint8_t expected[] =
+    {
+        0x82,
+        0xA4, 0x21, 0x65, '/', '3', '/', '0', '/', 0x22, 0x1A, 0x65, 0x53, 0xF1, 0x00,
+        0x00, 0x61, '0', 0x03, 0x6F, 'S', 'i', 'e', 'r', 'r', 'a', ' ',
+        'W', 'i', 'r', 'e', 'l', 'e', 's', 's',
+        0xA3, 0x00, 0x61, '9', 0x06, 0x0A, 0x02, 0x18, 0x39
+    };
+    const int64_t time = 1700000000;
+    uint8_t request[TEST_COAP_MESSAGE_MAX_LEN];
+    uint8_t retransmission[TEST_COAP_MESSAGE_MAX_LEN];
+    uint8_t token[8];
+    const uint8_t* payloadPtr;
+    lwm2mcore_SendConfig_t config;
+    lwm2mcore_SendStats_t stats;
+    size_t len;
+    int i;
+
+    memset(&config, 0, sizeof(config));
+    config.recordMaxNb = 4;
+    config.payloadMaxLen = 256;
+    config.flushOnUplink = true;
+
+    TEST_ASSERT(lwm2mcore_SendRecord(Lwm2mcoreRef, LWM2MCORE_DEVICE_OID, 0,
+                                     LWM2MCORE_DEVICE_BATTERY_LEVEL_RID, time)
+                == LWM2MCORE_ERR_INVALID_STATE);
+    config.payloadMaxLen = LWM2MCORE_SEND_PAYLOAD_MIN_LEN - 1;
+    TEST_ASSERT(lwm2mcore_SendConfigure(&config) == LWM2MCORE_ERR_INVALID_ARG);
+    config.payloadMaxLen = LWM2MCORE_SEND_PAYLOAD_MAX_LEN + 1;
+    TEST_ASSERT(lwm2mcore_SendConfigure(&config) == LWM2MCORE_ERR_INVALID_ARG);
+    config.payloadMaxLen = 256;
+    TEST_ASSERT(lwm2mcore_SendConfigure(&config) == LWM2MCORE_ERR_COMPLETED_OK);
+    TEST_ASSERT(omanager_SendGetDelay() == UINT32_MAX);
+
+    /* The records are buffered until a threshold is reached */
+    TestServerCount();
+    TEST_ASSERT(lwm2mcore_SendRecord(Lwm2mcoreRef, LWM2MCORE_DEVICE_OID, 0,
+                                     LWM2MCORE_DEVICE_MANUFACTURER_RID, time)
+                == LWM2MCORE_ERR_COMPLETED_OK);
+    TEST_ASSERT(lwm2mcore_SendRecord(Lwm2mcoreRef, LWM2MCORE_DEVICE_OID, 0,
+                                     LWM2MCORE_DEVICE_BATTERY_LEVEL_RID, time + 10)
+                == LWM2MCORE_ERR_COMPLETED_OK);
+    TEST_ASSERT(lwm2mcore_SendRecord(Lwm2mcoreRef, LWM2MCORE_DEVICE_OID, 0, 999, time)
+                == LWM2MCORE_ERR_INVALID_ARG);
+    omanager_SendCheck(Lwm2mcoreRef);
+    TEST_ASSERT(TestServerCount() == 0);
+
+    /* Another message is sent: the records are sent in a single SenML-CBOR pack, in a confirmable
+     * POST request on /dp
+     */
+    omanager_SendSignalUplink();
+    omanager_SendCheck(Lwm2mcoreRef);
+    len = TestSendReceive(request, sizeof(request));
+    TEST_ASSERT(len > 0);
+    TEST_ASSERT(TestCoapGetPayload(request, len, &payloadPtr) == sizeof(expected));
+    TEST_ASSERT(memcmp(payloadPtr, expected, sizeof(expected)) == 0);
+    TEST_ASSERT(omanager_SendIsInFlight());
+
+    /* Only one Send message is in flight: the new records wait for its acknowledgement */
+    TEST_ASSERT(lwm2mcore_SendRecord(Lwm2mcoreRef, LWM2MCORE_DEVICE_OID, 0,
+                                     LWM2MCORE_DEVICE_BATTERY_LEVEL_RID, time + 20)
+                == LWM2MCORE_ERR_COMPLETED_OK);
+    TEST_ASSERT(lwm2mcore_SendFlush(Lwm2mcoreRef) == LWM2MCORE_ERR_INVALID_STATE);
+
+    /* Retransmission at the end of the timeout: same message Id and token */
+    TEST_ASSERT((0 < omanager_SendGetDelay()) && (3 >= omanager_SendGetDelay()));
+    usleep(3100000);
+    omanager_SendCheck(Lwm2mcoreRef);
+    TEST_ASSERT(TestSendReceive(retransmission, sizeof(retransmission)) == len);
+    TEST_ASSERT(memcmp(retransmission, request, len) == 0);
+    TEST_ASSERT((2 < omanager_SendGetDelay()) && (6 >= omanager_SendGetDelay()));
+
+    /* Reset by the server: the records are sent again with the new one */
+    TestSendAck(request, 0);
+    TEST_ASSERT(!omanager_SendIsInFlight());
+    TEST_ASSERT(lwm2mcore_GetSendStats(&stats) == LWM2MCORE_ERR_COMPLETED_OK);
+    TEST_ASSERT((stats.sendNb == 1) && (stats.failedNb == 1) && (stats.bufferedNb == 3));
+    TEST_ASSERT(lwm2mcore_SendFlush(Lwm2mcoreRef) == LWM2MCORE_ERR_COMPLETED_OK);
+    len = TestSendReceive(request, sizeof(request));
+    TEST_ASSERT(TestCoapGetPayload(request, len, &payloadPtr) == sizeof(expected) + 9);
+
+    /* An acknowledgement with another token is not the acknowledgement of the Send message */
+    memcpy(token, request + 4, request[0] & 0x0F);
+    request[4] ^= 0xFF;
+    TestSendAck(request, COAP_204_CHANGED);
+    TEST_ASSERT(omanager_SendIsInFlight());
+    memcpy(request + 4, token, request[0] & 0x0F);
+    TestSendAck(request, COAP_204_CHANGED);
+    TEST_ASSERT(!omanager_SendIsInFlight());
+    TEST_ASSERT(lwm2mcore_GetSendStats(&stats) == LWM2MCORE_ERR_COMPLETED_OK);
+    TEST_ASSERT((stats.ackNb == 1) && (stats.sentRecordNb == 3) && (stats.bufferedNb == 0));
+
+    /* The full buffer drops the oldest records */
+    for (i = 0; i < 6; i++)
+    {
+        TEST_ASSERT(lwm2mcore_SendRecord(Lwm2mcoreRef, LWM2MCORE_DEVICE_OID, 0,
+                                         LWM2MCORE_DEVICE_BATTERY_LEVEL_RID, time + i)
+                    == LWM2MCORE_ERR_COMPLETED_OK);
+    }
+    TEST_ASSERT(lwm2mcore_GetSendStats(&stats) == LWM2MCORE_ERR_COMPLETED_OK);
+    TEST_ASSERT((stats.droppedNb == 2) && (stats.bufferedNb == 4));
+
+    /* Age threshold */
+    config.maxAge = 30;
+    TEST_ASSERT(lwm2mcore_SendConfigure(&config) == LWM2MCORE_ERR_COMPLETED_OK);
+    TEST_ASSERT(omanager_SendGetDelay() == UINT32_MAX);
+    TEST_ASSERT(lwm2mcore_SendRecord(Lwm2mcoreRef, LWM2MCORE_DEVICE_OID, 0,
+                                     LWM2MCORE_DEVICE_BATTERY_LEVEL_RID, time)
+                == LWM2MCORE_ERR_COMPLETED_OK);
+    TEST_ASSERT(omanager_SendGetDelay() <= 30);
+    TEST_ASSERT(omanager_SendGetDelay() >= 29);
+
+    /* Size threshold: the records are sent as soon as the payload reaches the maximum length */
+    config.recordMaxNb = 16;
+    config.maxAge = 0;
+    config.payloadMaxLen = LWM2MCORE_SEND_PAYLOAD_MIN_LEN;
+    TEST_ASSERT(lwm2mcore_SendConfigure(&config) == LWM2MCORE_ERR_COMPLETED_OK);
+    TEST_ASSERT(lwm2mcore_SendRecord(Lwm2mcoreRef, LWM2MCORE_DEVICE_OID, 0,
+                                     LWM2MCORE_DEVICE_MANUFACTURER_RID, time)
+                == LWM2MCORE_ERR_OVERFLOW);
+    len = 0;
+    for (i = 0; (i < 8) && (0 == len); i++)
+    {
+        TEST_ASSERT(lwm2mcore_SendRecord(Lwm2mcoreRef, LWM2MCORE_DEVICE_OID, 0,
+                                         LWM2MCORE_DEVICE_BATTERY_LEVEL_RID, time + i)
+                    == LWM2MCORE_ERR_COMPLETED_OK);
+        len = TestSendReceive(request, sizeof(request));
+    }
+    TEST_ASSERT(len > 0);
+    TEST_ASSERT(TestCoapGetPayload(request, len, &payloadPtr) <= LWM2MCORE_SEND_PAYLOAD_MIN_LEN);
+    TEST_ASSERT(payloadPtr[0] == 0x85);
+    TEST_ASSERT(lwm2mcore_GetSendStats(&stats) == LWM2MCORE_ERR_COMPLETED_OK);
+    TEST_ASSERT(stats.bufferedNb == 6);
+
+    /* Configuration refused while a message is in flight, then disabled */
+    TEST_ASSERT(lwm2mcore_SendConfigure(NULL) == LWM2MCORE_ERR_INVALID_STATE);
+    TestSendAck(request, COAP_204_CHANGED);
+    TEST_ASSERT(lwm2mcore_SendConfigure(NULL) == LWM2MCORE_ERR_COMPLETED_OK);
+    TEST_ASSERT(lwm2mcore_SendFlush(Lwm2mcoreRef) == LWM2MCORE_ERR_INVALID_STATE);
+}
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * Test function for the Read-Composite and Observe-Composite operations
+ */
+//--------------------------------------------------------------------------------------------------
+static void test_lwm2mcore_Composite
+(
+    void
+)
+{
+    /* Manufacturer and battery level of the device object, and an unknown object */
+    static const uint8_t request[] =
+    {
+        0x83,
+        0xA1, 0x00, 0x66, '/', '3', '/', '0', '/', '0',
+        0xA1, 0x00, 0x68, '/', '6', '5', '0', '0', '0', '/', '0',
+        0xA2, 0x21, 0x65, '/', '3', '/', '0', '/', 0x00, 0x61, '9'
+    };
+    static const char jsonRequest[] = "[{\"bn\":\"/3/0/\",\"n\":\"0\"}, {\"n\":\"9\"}]";
+    static const char badPathRequest[] = "[{\"n\":\"/3/0/0/1\"}]";
+    static const char rootRequest[] = "[{\"n\":\"/\"}]";
+    static const char notFoundRequest[] = "[{\"n\":\"/65000\"}]";
+    static const char* expectedNames[] = {"/3/0/0", "/3/0/9"};
+    /* FETCH request on the root path with the Observe option, in SenML-JSON */
+    static const uint8_t fetchHeader[] =
+    {
+        0x42, 0x05, 0x20, 0x01, 'C', 'O',
+        0x60, 0x61, LWM2MCORE_CONTENT_SENML_JSON, 0x51, LWM2MCORE_CONTENT_SENML_JSON, 0xFF
+    };
+    static const uint8_t fetchCancelHeader[] =
+    {
+        0x42, 0x05, 0x20, 0x02, 'C', 'O',
+        0x61, 0x01, 0x61, LWM2MCORE_CONTENT_SENML_JSON, 0x51, LWM2MCORE_CONTENT_SENML_JSON, 0xFF
+    };
+    static const char timeRequest[] = "[{\"n\":\"/3/0/13\"}]";
+    uint8_t message[TEST_COAP_MESSAGE_MAX_LEN];
+    uint8_t response[TEST_COAP_MESSAGE_MAX_LEN];
+    uint8_t reset[4];
+    uint32_t observeSeq;
+    uint32_t value;
+    char names[4][SENML_NAME_MAX_LEN];
+    uint8_t token[COMPOSITE_TOKEN_MAX_LEN] = {0x4F, 0x42};
+    lwm2m_data_t* dataPtr;
+    lwm2m_uri_t uri;
+    uint8_t* bufferPtr;
+    uint8_t* payloadPtr;
+    size_t length;
+    size_t separateLen = 0;
+    int dataNb;
+    int len;
+    int i;
+
+    /* One response for the paths of several requests: the records carry their absolute path */
+    TEST_ASSERT(lwm2mcore_CompositeRead(LWM2MCORE_CONTENT_SENML_CBOR, request, sizeof(request),
+                                        LWM2MCORE_CONTENT_SENML_CBOR, &bufferPtr, &length)
+                == COAP_205_CONTENT);
+    TEST_ASSERT(omanager_SenmlDecodeNames(LWM2MCORE_CONTENT_SENML_CBOR, bufferPtr, length,
+                                          names, 4) == 2);
+    TEST_ASSERT(strcmp(names[0], expectedNames[0]) == 0);
+    TEST_ASSERT(strcmp(names[1], expectedNames[1]) == 0);
+
+    /* The response is shorter than the responses of the separate Read requests */
+    memset(&uri, 0, sizeof(uri));
+    uri.flag = LWM2M_URI_FLAG_OBJECT_ID | LWM2M_URI_FLAG_INSTANCE_ID | LWM2M_URI_FLAG_RESOURCE_ID;
+    uri.objectId = LWM2MCORE_DEVICE_OID;
+    for (i = 0; i < 2; i++)
+    {
+        uri.resourceId = (i == 0) ? LWM2MCORE_DEVICE_MANUFACTURER_RID
+                                  : LWM2MCORE_DEVICE_BATTERY_LEVEL_RID;
+        TEST_ASSERT(omanager_ReadUri(&uri, &dataNb, &dataPtr) == COAP_205_CONTENT);
+        TEST_ASSERT(dataNb == 1);
+        len = lwm2mcore_SenmlSerialize(&uri, (int)dataPtr->value.asChildren.count,
+                                       dataPtr->value.asChildren.array,
+                                       LWM2MCORE_CONTENT_SENML_CBOR, &payloadPtr);
+        TEST_ASSERT(len > 0);
+        separateLen += (size_t)len;
+        lwm2m_free(payloadPtr);
+        lwm2m_data_free(dataNb, dataPtr);
+    }
+    printf("Read-Composite: %zu bytes, separate Read: %zu bytes\n", length, separateLen);
+    TEST_ASSERT(length < separateLen);
+    lwm2m_free(bufferPtr);
+
+    /* SenML-JSON request with a base name, SenML-JSON response */
+    TEST_ASSERT(lwm2mcore_CompositeRead(LWM2MCORE_CONTENT_SENML_JSON,
+                                        (const uint8_t*)jsonRequest, strlen(jsonRequest),
+                                        LWM2MCORE_CONTENT_SENML_JSON, &bufferPtr, &length)
+                == COAP_205_CONTENT);
+    TEST_ASSERT(omanager_SenmlDecodeNames(LWM2MCORE_CONTENT_SENML_JSON, bufferPtr, length,
+                                          names, 4) == 2);
+    TEST_ASSERT(strcmp(names[0], expectedNames[0]) == 0);
+    TEST_ASSERT(strcmp(names[1], expectedNames[1]) == 0);
+    lwm2m_free(bufferPtr);
+
+    /* Invalid requests */
+    TEST_ASSERT(lwm2mcore_CompositeRead(LWM2M_CONTENT_TLV, request, sizeof(request),
+                                        LWM2MCORE_CONTENT_SENML_CBOR, &bufferPtr, &length)
+                == COAP_415_UNSUPPORTED_CONTENT_FORMAT);
+    TEST_ASSERT(lwm2mcore_CompositeRead(LWM2MCORE_CONTENT_SENML_CBOR, request, sizeof(request),
+                                        LWM2M_CONTENT_TLV, &bufferPtr, &length)
+                == COAP_415_UNSUPPORTED_CONTENT_FORMAT);
+    TEST_ASSERT(lwm2mcore_CompositeRead(LWM2MCORE_CONTENT_SENML_CBOR, request, sizeof(request) - 1,
+                                        LWM2MCORE_CONTENT_SENML_CBOR, &bufferPtr, &length)
+                == COAP_400_BAD_REQUEST);
+    TEST_ASSERT(lwm2mcore_CompositeRead(LWM2MCORE_CONTENT_SENML_JSON,
+                                        (const uint8_t*)badPathRequest, strlen(badPathRequest),
+                                        LWM2MCORE_CONTENT_SENML_CBOR, &bufferPtr, &length)
+                == COAP_400_BAD_REQUEST);
+    TEST_ASSERT(lwm2mcore_CompositeRead(LWM2MCORE_CONTENT_SENML_JSON,
+                                        (const uint8_t*)rootRequest, strlen(rootRequest),
+                                        LWM2MCORE_CONTENT_SENML_CBOR, &bufferPtr, &length)
+                == COAP_400_BAD_REQUEST);
+    TEST_ASSERT(lwm2mcore_CompositeRead(LWM2MCORE_CONTENT_SENML_JSON,
+                                        (const uint8_t*)notFoundRequest, strlen(notFoundRequest),
+                                        LWM2MCORE_CONTENT_SENML_CBOR, &bufferPtr, &length)
+                == COAP_404_NOT_FOUND);
+    TEST_ASSERT(bufferPtr == NULL);
+
+    /* Observation: no notification while the values don't change */
+    TEST_ASSERT(lwm2mcore_CompositeObserve(TEST_SHORT_SERVER_ID, token, 2,
+                                           LWM2MCORE_CONTENT_SENML_CBOR,
+                                           request, sizeof(request),
+                                           LWM2MCORE_CONTENT_SENML_CBOR, &bufferPtr, &length)
+                == COAP_205_CONTENT);
+    lwm2m_free(bufferPtr);
+    TestServerCount();
+    omanager_CompositeCheck(Lwm2mcoreRef);
+    TEST_ASSERT(TestServerCount() == 0);
+
+    /* Limited number of observations */
+    for (i = 1; i < COMPOSITE_OBSERVE_MAX_NB; i++)
+    {
+        token[2] = (uint8_t)i;
+        TEST_ASSERT(lwm2mcore_CompositeObserve(TEST_SHORT_SERVER_ID, token, 3,
+                                               LWM2MCORE_CONTENT_SENML_CBOR,
+                                               request, sizeof(request),
+                                               LWM2MCORE_CONTENT_SENML_CBOR, &bufferPtr, &length)
+                    == COAP_205_CONTENT);
+        lwm2m_free(bufferPtr);
+    }
+    token[2] = (uint8_t)i;
+    TEST_ASSERT(lwm2mcore_CompositeObserve(TEST_SHORT_SERVER_ID, token, 3,
+                                           LWM2MCORE_CONTENT_SENML_CBOR,
+                                           request, sizeof(request),
+                                           LWM2MCORE_CONTENT_SENML_CBOR, &bufferPtr, &length)
+                == COAP_503_SERVICE_UNAVAILABLE);
+
+    /* Cancellation, only by the server of the observation */
+    TEST_ASSERT(!lwm2mcore_CompositeCancel(TEST_SHORT_SERVER_ID + 1, token, 2));
+    TEST_ASSERT(lwm2mcore_CompositeCancel(TEST_SHORT_SERVER_ID, token, 2));
+    TEST_ASSERT(!lwm2mcore_CompositeCancel(TEST_SHORT_SERVER_ID, token, 2));
+    omanager_CompositeReset();
+    token[2] = 1;
+    TEST_ASSERT(!lwm2mcore_CompositeCancel(TEST_SHORT_SERVER_ID, token, 3));
+
+    /* Observe-Composite request of the current time, in SenML-JSON */
+    memcpy(message, fetchHeader, sizeof(fetchHeader));
+    memcpy(message + sizeof(fetchHeader), timeRequest, strlen(timeRequest));
+    length = sizeof(fetchHeader) + strlen(timeRequest);
+    TestServerRequest(message, length);
+    len = (int)TestServerReceive(response, sizeof(response));
+    TEST_ASSERT((len > 6) && (response[0] == 0x62) && (response[1] == COAP_205_CONTENT));
+    TEST_ASSERT((response[2] == 0x20) && (response[3] == 0x01));
+    TEST_ASSERT(memcmp(response + 4, "CO", 2) == 0);
+    TEST_ASSERT(TestCoapGetOption(response, (size_t)len, 6, &observeSeq));
+    TEST_ASSERT(TestCoapGetOption(response, (size_t)len, 12, &value)
+                && (value == LWM2MCORE_CONTENT_SENML_JSON));
+
+    /* Notification: new message with the token and a greater Observe option */
+    usleep(1100000);
+    omanager_CompositeCheck(Lwm2mcoreRef);
+    len = (int)TestServerReceive(response, sizeof(response));
+    TEST_ASSERT((len > 6) && (response[0] == 0x52) && (response[1] == COAP_205_CONTENT));
+    TEST_ASSERT(memcmp(response + 4, "CO", 2) == 0);
+    TEST_ASSERT(TestCoapGetOption(response, (size_t)len, 6, &value) && (value > observeSeq));
+
+    /* Reset of the notification: the observation is cancelled */
+    reset[0] = 0x70;
+    reset[1] = 0;
+    reset[2] = response[2];
+    reset[3] = response[3];
+    TestServerRequest(reset, sizeof(reset));
+    TEST_ASSERT(TestServerCount() == 0);
+    TEST_ASSERT(!lwm2mcore_CompositeCancel(TEST_SHORT_SERVER_ID, (const uint8_t*)"CO", 2));
+
+    /* Deregistration: answered as a Read-Composite, without the Observe option */
+    message[3] = 0x04;
+    TestServerRequest(message, length);
+    TEST_ASSERT(TestServerReceive(response, sizeof(response)) > 6);
+    memcpy(message, fetchCancelHeader, sizeof(fetchCancelHeader));
+    memcpy(message + sizeof(fetchCancelHeader), timeRequest, strlen(timeRequest));
+    TestServerRequest(message, sizeof(fetchCancelHeader) + strlen(timeRequest));
+    len = (int)TestServerReceive(response, sizeof(response));
+    TEST_ASSERT((len > 6) && (response[1] == COAP_205_CONTENT) && (response[3] == 0x02));
+    TEST_ASSERT(!TestCoapGetOption(response, (size_t)len, 6, &value));
+    TEST_ASSERT(!lwm2mcore_CompositeCancel(TEST_SHORT_SERVER_ID, (const uint8_t*)"CO", 2));
+
+    /* Request payload in an unsupported format */
+    memcpy(message, fetchHeader, sizeof(fetchHeader));
+    memcpy(message + sizeof(fetchHeader), timeRequest, strlen(timeRequest));
+    message[3] = 0x03;
+    message[8] = LWM2M_CONTENT_TEXT;
+    TestServerRequest(message, length);
+    len = (int)TestServerReceive(response, sizeof(response));
+    TEST_ASSERT((len == 6) && (response[1] == COAP_415_UNSUPPORTED_CONTENT_FORMAT));
+}
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * Byte of the large value read in blocks
+ */
+//--------------------------------------------------------------------------------------------------
+static uint8_t TestStreamByte
+(
+    size_t offset
+)
+{
+    return (uint8_t)((offset * 31) + (offset >> 12));
+}
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * Request a block of the SSL certificate by a Block2 GET request of the LwM2M server stand-in
+ *
+ * @return
+ *      - Response length
+ *      - 0 if no response is received
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t TestStreamGetBlock
+(
+    uint32_t blockNum,                  ///< [IN] Block number, of 1024 bytes
+    uint8_t* responsePtr,               ///< [OUT] Response
+    size_t size                         ///< [IN] Response buffer size
+)
+{
+    /* GET /10243/0/0, the Block2 option is appended */
+    const uint8_t header[] = { 0x42, 0x01, 0x00, 0x00, 'S', 'R',
+                               0xB5, '1', '0', '2', '4', '3', 0x01, '0', 0x01, '0' };
+    uint8_t request[sizeof(header) + 4];
+    uint32_t value = (blockNum << 4) | 6;
+    size_t optionLen = (value > 0xFFFF) ? 3 : ((value > 0xFF) ? 2 : 1);
+    size_t len = sizeof(header);
+
+    memcpy(request, header, sizeof(header));
+    request[2] = (uint8_t)(blockNum >> 8);
+    request[3] = (uint8_t)blockNum;
+    request[len++] = (uint8_t)(0xC0 | optionLen);
+    while (optionLen > 0)
+    {
+        optionLen--;
+        request[len++] = (uint8_t)(value >> (8 * optionLen));
+    }
+
+    TestServerRequest(request, len);
+    return TestServerReceive(responsePtr, size);
+}
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * Write a block of the SSL certificate by a Block1 PUT request of the LwM2M server stand-in
+ *
+ * @return
+ *      - Response length
+ *      - 0 if no response is received
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t TestStreamPutBlock
+(
+    uint16_t mid,                       ///< [IN] Message ID
+    uint32_t blockNum,                  ///< [IN] Block number, of 1024 bytes
+    bool isMore,                        ///< [IN] More flag of the Block1 option
+    const uint8_t* blockPtr,            ///< [IN] Block
+    size_t blockLen,                    ///< [IN] Block length
+    uint8_t* responsePtr,               ///< [OUT] Response
+    size_t size                         ///< [IN] Response buffer size
+)
+{
+    /* PUT /10243/0/0 of opaque data, the Block1 option and the payload are appended */
+    const uint8_t header[] = { 0x42, 0x03, 0x00, 0x00, 'S', 'W',
+                               0xB5, '1', '0', '2', '4', '3', 0x01, '0', 0x01, '0',
+                               0x11, LWM2M_CONTENT_OPAQUE };
+    uint8_t request[TEST_COAP_MESSAGE_MAX_LEN];
+    uint32_t value = (blockNum << 4) | (isMore ? 0x08 : 0) | 6;
+    size_t optionLen = (value > 0xFFFF) ? 3 : ((value > 0xFF) ? 2 : 1);
+    size_t len = sizeof(header);
+
+    memcpy(request, header, sizeof(header));
+    request[2] = (uint8_t)(mid >> 8);
+    request[3] = (uint8_t)mid;
+    /* Block1 option after the Content-Format option: extended delta */
+    request[len++] = (uint8_t)(0xD0 | optionLen);
+    request[len++] = 27 - 12 - 13;
+    while (optionLen > 0)
+    {
+        optionLen--;
+        request[len++] = (uint8_t)(value >> (8 * optionLen));
+    }
+    request[len++] = 0xFF;
+    memcpy(request + len, blockPtr, blockLen);
+    len += blockLen;
+
+    TestServerRequest(request, len);
+    return TestServerReceive(responsePtr, size);
+}
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * Test function for the Block2 streamed read of a large resource
+ */
+//--------------------------------------------------------------------------------------------------
+static void test_lwm2mcore_StreamRead
+(
+    void
+)
+{
+    const size_t certLen = (4 * 1024 * 1024) + 100;
+    uint8_t response[TEST_COAP_MESSAGE_MAX_LEN];
+    const uint8_t* payloadPtr;
+    lwm2mcore_HeapStats_t stats;
+    uint8_t block[1024];
+    lwm2m_uri_t uri;
+    char* certPtr;
+    size_t offset = 0;
+    size_t len;
+    uint32_t blockNum;
+    uint32_t value;
+    bool isLast = false;
+    bool isValid = true;
+    size_t i;
+
+    /* Multi-megabyte certificate saved by the platform */
+    certPtr = (char*)malloc(certLen);
+    TEST_ASSERT(certPtr != NULL);
+    for (i = 0; i < certLen; i++)
+    {
+        certPtr[i] = (char)TestStreamByte(i);
+    }
+    TEST_ASSERT(lwm2mcore_UpdateSslCertificate(certPtr, (int)certLen)
+                == LWM2MCORE_ERR_COMPLETED_OK);
+    free(certPtr);
+
+    memset(&uri, 0, sizeof(uri));
+    uri.flag = LWM2M_URI_FLAG_OBJECT_ID | LWM2M_URI_FLAG_INSTANCE_ID | LWM2M_URI_FLAG_RESOURCE_ID;
+    uri.objectId = LWM2MCORE_SSL_CERTIFS_OID;
+    uri.resourceId = LWM2MCORE_SSL_CERTIFICATE_CERTIF;
+
+    /* The server stand-in requests the blocks until the last one: no allocation in the core */
+    lwm2mcore_ResetHeapStats();
+    for (blockNum = 0; !isLast; blockNum++)
+    {
+        TEST_ASSERT(lwm2mcore_StreamRead(&uri, blockNum, sizeof(block), block, &len, &isLast)
+                    == COAP_205_CONTENT);
+        TEST_ASSERT(len == (isLast ? (certLen - offset) : sizeof(block)));
+        for (i = 0; i < len; i++)
+        {
+            isValid = isValid && (block[i] == TestStreamByte(offset + i));
+        }
+        offset += len;
+    }
+    TEST_ASSERT(isValid);
+    TEST_ASSERT(offset == certLen);
+    TEST_ASSERT(blockNum == ((certLen + sizeof(block) - 1) / sizeof(block)));
+    TEST_ASSERT(lwm2mcore_GetHeapStats(LWM2MCORE_HEAP_TAG_OBJECT_MANAGER, &stats)
+                == LWM2MCORE_ERR_COMPLETED_OK);
+    TEST_ASSERT(stats.allocNb == 0);
+
+    /* Same transfer requested by the server stand-in: Block2 GET requests of the UDP receive path,
+     * answered before Wakaama with opaque blocks
+     */
+    TestServerCount();
+    offset = 0;
+    isLast = false;
+    for (blockNum = 0; !isLast; blockNum++)
+    {
+        len = TestStreamGetBlock(blockNum, response, sizeof(response));
+        TEST_ASSERT((len > 6) && (response[0] == 0x62) && (response[1] == COAP_205_CONTENT));
+        TEST_ASSERT((response[2] == (uint8_t)(blockNum >> 8))
+                    && (response[3] == (uint8_t)blockNum));
+        TEST_ASSERT(TestCoapGetOption(response, len, 12, &value)
+                    && (value == LWM2M_CONTENT_OPAQUE));
+        TEST_ASSERT(TestCoapGetOption(response, len, 23, &value)
+                    && ((value >> 4) == blockNum) && ((value & 0x07) == 6));
+        isLast = (0 == (value & 0x08));
+        len = TestCoapGetPayload(response, len, &payloadPtr);
+        TEST_ASSERT(len == (isLast ? (certLen - offset) : sizeof(block)));
+        for (i = 0; i < len; i++)
+        {
+            isValid = isValid && (payloadPtr[i] == TestStreamByte(offset + i));
+        }
+        offset += len;
+    }
+    TEST_ASSERT(isValid);
+    TEST_ASSERT(offset == certLen);
+
+    /* Block beyond the end of the value */
+    len = TestStreamGetBlock(blockNum, response, sizeof(response));
+    TEST_ASSERT((len == 6) && (response[1] == COAP_402_BAD_OPTION));
+
+    /* Smaller blocks */
+    TEST_ASSERT(lwm2mcore_StreamRead(&uri, 3, 16, block, &len, &isLast) == COAP_205_CONTENT);
+    TEST_ASSERT((len == 16) && (!isLast) && (block[0] == TestStreamByte(48)));
+
+    /* Invalid blocks */
+    TEST_ASSERT(lwm2mcore_StreamRead(&uri, blockNum, sizeof(block), block, &len, &isLast)
+                == COAP_402_BAD_OPTION);
+    TEST_ASSERT(lwm2mcore_StreamRead(&uri, 0, 1000, block, &len, &isLast)
+                == COAP_400_BAD_REQUEST);
+
+    /* Resources without streamed read handler, unknown object instance */
+    uri.objectId = LWM2MCORE_DEVICE_OID;
+    uri.resourceId = LWM2MCORE_DEVICE_MANUFACTURER_RID;
+    TEST_ASSERT(lwm2mcore_StreamRead(&uri, 0, sizeof(block), block, &len, &isLast)
+                == COAP_501_NOT_IMPLEMENTED);
+    uri.objectId = LWM2MCORE_SSL_CERTIFS_OID;
+    uri.instanceId = 1;
+    uri.resourceId = LWM2MCORE_SSL_CERTIFICATE_CERTIF;
+    TEST_ASSERT(lwm2mcore_StreamRead(&uri, 0, sizeof(block), block, &len, &isLast)
+                == COAP_404_NOT_FOUND);
+
+    /* Deleted certificate: a single empty block */
+    uri.instanceId = 0;
+    TEST_ASSERT(lwm2mcore_UpdateSslCertificate((char*)block, 0) == LWM2MCORE_ERR_COMPLETED_OK);
+    TEST_ASSERT(lwm2mcore_StreamRead(&uri, 0, sizeof(block), block, &len, &isLast)
+                == COAP_205_CONTENT);
+    TEST_ASSERT((len == 0) && isLast);
+}
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * Test function for lwm2m_connect_server API
+ */
+//--------------------------------------------------------------------------------------------------
+void test_lwm2m_connect_server
+(
+    void
+)
+{
+    smanager_ClientData_t* dataPtr = (smanager_ClientData_t*)Lwm2mcoreRef;
     lwm2m_list_t* instancePtr;
     instancePtr = (lwm2m_list_t *)lwm2m_malloc(sizeof(lwm2m_list_t));
     if (NULL == instancePtr)
@@ -308,81 +1402,3065 @@ void test_smanager_SendSessionEvent
 
 //-------------------------------------------------------------------------------------------------
 /**
- * Test function for lwm2mcore_SendAsyncResponse API
+ * Test function for lwm2mcore_GetStartupProfile API
  */
 //--------------------------------------------------------------------------------------------------
-void test_lwm2mcore_SendAsyncResponse
+static void test_lwm2mcore_GetStartupProfile
 (
     void
 )
 {
-    RequestPtr = (lwm2mcore_CoapRequest_t*)lwm2m_malloc(sizeof(lwm2mcore_CoapRequest_t));
-    if (NULL == RequestPtr)
+    lwm2mcore_StartupProfile_t profile;
+    lwm2mcore_StartupProfile_t newProfile;
+    struct sockaddr_storage addr;
+    socklen_t addrLen = 0;
+    char host[] = "localhost";
+    char port[] = "5683";
+    int sock = -1;
+    int phase;
+
+    TEST_ASSERT(false == lwm2mcore_GetStartupProfile(NULL));
+    TEST_ASSERT(lwm2mcore_GetStartupProfile(&profile));
+
+    // All the phases are reached by the previous tests
+    for (phase = LWM2MCORE_STARTUP_INIT; phase < LWM2MCORE_STARTUP_PHASE_MAX; phase++)
     {
-        printf("RequestPtr is NULL!\n");
-        TEST_ASSERT(false);
+        TEST_ASSERT(profile.phaseMask & (1 << phase));
     }
+    TEST_ASSERT(profile.elapsedUs[LWM2MCORE_STARTUP_INIT]
+                <= profile.elapsedUs[LWM2MCORE_STARTUP_OBJECTS_REGISTERED]);
+    TEST_ASSERT(profile.elapsedUs[LWM2MCORE_STARTUP_OBJECTS_REGISTERED]
+                <= profile.elapsedUs[LWM2MCORE_STARTUP_SOCKET_OPENED]);
+    TEST_ASSERT(profile.elapsedUs[LWM2MCORE_STARTUP_SOCKET_OPENED]
+                <= profile.elapsedUs[LWM2MCORE_STARTUP_SERVER_CONNECTED]);
 
-    RequestPtr->uriLength = strlen("www.sierrawireless.com");
-    RequestPtr->uri = (char*)lwm2m_malloc(RequestPtr->uriLength + 1);
-    strncpy(RequestPtr->uri, "www.sierrawireless.com", RequestPtr->uriLength + 1);
+    // Only the first occurrence of a phase is recorded
+    smanager_SetStartupPhase(LWM2MCORE_STARTUP_REGISTERED);
+    smanager_SetStartupPhase(LWM2MCORE_STARTUP_PHASE_MAX);
+    TEST_ASSERT(lwm2mcore_GetStartupProfile(&newProfile));
+    TEST_ASSERT(0 == memcmp(&profile, &newProfile, sizeof(profile)));
 
-    RequestPtr->method = 1;
+    // Connection with a server address resolved in advance
+    TEST_ASSERT(false == lwm2mcore_UdpResolve(NULL, port));
+    TEST_ASSERT(lwm2mcore_UdpResolve(host, port));
+    TEST_ASSERT(lwm2mcore_UdpConnect(host, host, port, AF_INET,
+                                     (struct sockaddr*)&addr, &addrLen, &sock));
+    TEST_ASSERT(0 <= sock);
+    TEST_ASSERT(AF_INET == addr.ss_family);
+    close(sock);
+}
 
-    RequestPtr->bufferLength = strlen("123456789");
-    RequestPtr->buffer = (uint8_t*)lwm2m_malloc(RequestPtr->bufferLength + 1);
-    strncpy((char*)RequestPtr->buffer, "123456789", RequestPtr->bufferLength + 1);
+//-------------------------------------------------------------------------------------------------
+/**
+ * Test function for lwm2mcore_GetStatistics API
+ */
+//--------------------------------------------------------------------------------------------------
+static void test_lwm2mcore_GetStatistics
+(
+    void
+)
+{
+    lwm2mcore_Histogram_t histogram;
+    lwm2mcore_ObjectStats_t stats;
+    lwm2mcore_Sid_t sid;
+    uint16_t index = 0;
+    uint16_t oid = 0xFFF0;
+    int op;
 
-    RequestPtr->messageId = 100;
-    RequestPtr->tokenLength = 3;
-    memcpy(RequestPtr->token, "hi", 3);
-    RequestPtr->contentType = 1;
+    TEST_ASSERT(LWM2MCORE_ERR_INVALID_ARG == lwm2mcore_GetStatistics(0, NULL));
 
-    Lwm2mServerResponse.code = COAP_RESOURCE_CHANGED;
+    // Histogram buckets
+    memset(&histogram, 0, sizeof(histogram));
+    omanager_AddHistogramSample(&histogram, 0);
+    omanager_AddHistogramSample(&histogram, 1);
+    omanager_AddHistogramSample(&histogram, 2);
+    omanager_AddHistogramSample(&histogram, 3);
+    omanager_AddHistogramSample(&histogram, 1000);
+    omanager_AddHistogramSample(&histogram, 1ULL << 40);
+    TEST_ASSERT(6 == histogram.count);
+    TEST_ASSERT(UINT32_MAX == histogram.maxUs);
+    TEST_ASSERT((1006 + (1ULL << 40)) == histogram.totalUs);
+    TEST_ASSERT(2 == histogram.buckets[0]);
+    TEST_ASSERT(2 == histogram.buckets[1]);
+    TEST_ASSERT(1 == histogram.buckets[9]);
+    TEST_ASSERT(1 == histogram.buckets[LWM2MCORE_STATS_BUCKET_NB - 1]);
+    omanager_ResetHistogram(&histogram);
+    TEST_ASSERT(0 == histogram.count);
+    TEST_ASSERT(0 == histogram.maxUs);
+    TEST_ASSERT(0 == histogram.buckets[0]);
 
-    Lwm2mServerResponse.payloadLength = strlen("123456789");
-    Lwm2mServerResponse.payload = (uint8_t*)lwm2m_malloc(Lwm2mServerResponse.payloadLength + 1);
-    strncpy((char*)Lwm2mServerResponse.payload, "123456789", Lwm2mServerResponse.payloadLength + 1);
+    // Operations on an object
+    omanager_RecordLatency(oid, LWM2MCORE_STATS_OP_READ, false, lwm2mcore_GetTimeUs());
+    omanager_RecordLatency(oid, LWM2MCORE_STATS_OP_READ, true, lwm2mcore_GetTimeUs());
+    omanager_RecordLatency(oid, LWM2MCORE_STATS_OP_EXECUTE, false, lwm2mcore_GetTimeUs());
+    omanager_RecordLatency(oid, LWM2MCORE_STATS_OP_MAX, false, lwm2mcore_GetTimeUs());
 
-    TEST_ASSERT(lwm2mcore_SendAsyncResponse(Lwm2mcoreRef, RequestPtr, &Lwm2mServerResponse)
-                != false);
+    do
+    {
+        sid = lwm2mcore_GetStatistics(index++, &stats);
+        TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == sid);
+    }
+    while (oid != stats.oid);
+
+    for (op = 0; op < LWM2MCORE_STATS_OP_MAX; op++)
+    {
+        TEST_ASSERT(((LWM2MCORE_STATS_OP_READ == op) || (LWM2MCORE_STATS_OP_EXECUTE == op))
+                    == stats.request[op].count);
+        TEST_ASSERT((LWM2MCORE_STATS_OP_READ == op) == stats.callback[op].count);
+    }
+
+    while (LWM2MCORE_ERR_COMPLETED_OK == sid)
+    {
+        sid = lwm2mcore_GetStatistics(index++, &stats);
+    }
+    TEST_ASSERT(LWM2MCORE_ERR_INCORRECT_RANGE == sid);
+
+    // The statistics are reset but the object is kept
+    lwm2mcore_ResetStatistics();
+    TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == lwm2mcore_GetStatistics(0, &stats));
+    for (op = 0; op < LWM2MCORE_STATS_OP_MAX; op++)
+    {
+        TEST_ASSERT(0 == stats.request[op].count);
+        TEST_ASSERT(0 == stats.callback[op].count);
+    }
 }
 
+//-------------------------------------------------------------------------------------------------
+/**
+ * Test function for lwm2mcore_GetCoapMetrics API
+ */
 //--------------------------------------------------------------------------------------------------
+static void test_lwm2mcore_GetCoapMetrics
+(
+    void
+)
+{
+    lwm2mcore_CoapMetrics_t metrics;
+    uint16_t securityInstId = 0xFFF0;
+    uint16_t index = 0;
+    // CoAP CON, ACK and NON messages with their message Id
+    uint8_t con1[] = {0x40, 0x02, 0x12, 0x34};
+    uint8_t ack1[] = {0x60, 0x44, 0x12, 0x34};
+    uint8_t con2[] = {0x40, 0x02, 0x12, 0x35};
+    uint8_t ack2[] = {0x60, 0x44, 0x12, 0x35};
+    uint8_t request[] = {0x50, 0x01, 0x00, 0x01};
+    // Two DTLS records in a datagram
+    uint8_t records[] = {0x16, 0xFE, 0xFD, 0, 0, 0, 0, 0, 0, 0, 0, 0x00, 0x02, 0xAA, 0xBB,
+                         0x17, 0xFE, 0xFD, 0, 1, 0, 0, 0, 0, 0, 0, 0x00, 0x00};
+
+    TEST_ASSERT(LWM2MCORE_ERR_INVALID_ARG == lwm2mcore_GetCoapMetrics(0, NULL));
+
+    // Retransmitted message: no round-trip time sample
+    smanager_RecordCoapMessage(securityInstId, con1, sizeof(con1), true);
+    smanager_RecordCoapMessage(securityInstId, con1, sizeof(con1), true);
+    smanager_RecordCoapMessage(securityInstId, ack1, sizeof(ack1), false);
+    // Round-trip time sample
+    smanager_RecordCoapMessage(securityInstId, con2, sizeof(con2), true);
+    smanager_RecordCoapMessage(securityInstId, ack2, sizeof(ack2), false);
+    // Duplicate request
+    smanager_RecordCoapMessage(securityInstId, request, sizeof(request), false);
+    smanager_RecordCoapMessage(securityInstId, request, sizeof(request), false);
+    // Datagrams
+    smanager_RecordDatagram(securityInstId, records, sizeof(records), true, true);
+    smanager_RecordDatagram(securityInstId, records, sizeof(records), true, false);
+    smanager_RecordDatagram(securityInstId, con1, sizeof(con1), false, true);
+    // Handshake
+    smanager_RecordHandshake(securityInstId, true);
+    smanager_RecordHandshake(securityInstId, false);
+    smanager_RecordHandshake(securityInstId, true);
+
+    do
+    {
+        TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == lwm2mcore_GetCoapMetrics(index++, &metrics));
+    }
+    while (securityInstId != metrics.securityInstId);
+
+    TEST_ASSERT(2 == metrics.conSentNb);
+    TEST_ASSERT(1 == metrics.retransmissionNb);
+    TEST_ASSERT(0 == metrics.timeoutNb);
+    TEST_ASSERT(1 == metrics.duplicateNb);
+    TEST_ASSERT(1 == metrics.rtt.count);
+    TEST_ASSERT(metrics.rtt.maxUs == metrics.srttUs);
+    TEST_ASSERT(metrics.srttUs / 2 == metrics.rttVarUs);
+    TEST_ASSERT(2 == metrics.dtlsRecordSentNb);
+    TEST_ASSERT(2 == metrics.dtlsRecordReceivedNb);
+    TEST_ASSERT((sizeof(records) + sizeof(con1)) == metrics.bytesSent);
+    TEST_ASSERT(sizeof(records) == metrics.bytesReceived);
+    TEST_ASSERT(1 == metrics.handshake.count);
+
+    // The exchanges are not tracked after the connection is closed
+    smanager_RecordCoapMessage(securityInstId, con1, sizeof(con1), true);
+    smanager_CloseCoapMetrics(securityInstId);
+    smanager_RecordCoapMessage(securityInstId, ack1, sizeof(ack1), false);
+    TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == lwm2mcore_GetCoapMetrics(index - 1, &metrics));
+    TEST_ASSERT(3 == metrics.conSentNb);
+    TEST_ASSERT(1 == metrics.rtt.count);
+
+    lwm2mcore_ResetCoapMetrics();
+    TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == lwm2mcore_GetCoapMetrics(index - 1, &metrics));
+    TEST_ASSERT(securityInstId == metrics.securityInstId);
+    TEST_ASSERT(0 == metrics.conSentNb);
+    TEST_ASSERT(0 == metrics.bytesSent);
+    TEST_ASSERT(0 == metrics.rtt.count);
+
+    TEST_ASSERT(LWM2MCORE_ERR_INCORRECT_RANGE
+                == lwm2mcore_GetCoapMetrics(LWM2MCORE_COAP_METRICS_SERVER_MAX_NB, &metrics));
+}
+
+//-------------------------------------------------------------------------------------------------
 /**
- *  Unitary test entry point.
+ * Test function for lwm2mcore_TraceGetRecords API
  */
 //--------------------------------------------------------------------------------------------------
-int main
+static void test_lwm2mcore_TraceGetRecords
 (
     void
 )
 {
-    printf("======== Start UnitTest of lwm2mcore ========\n");
+    lwm2mcore_TraceRecord_t records[8];
+    uint8_t packet[40];
+    uint32_t seq = 0;
+    uint32_t lostNb;
+    uint32_t i;
 
-    printf("======== test of lwm2mcore_Init() ========\n");
-    test_lwm2mcore_Init();
+    for (i = 0; i < sizeof(packet); i++)
+    {
+        packet[i] = (uint8_t)i;
+    }
 
-    printf("======== test of lwm2mcore_Connect() ========\n");
-    test_lwm2mcore_Connect();
+    // Trace disabled
+    smanager_Trace(LWM2MCORE_TRACE_READ, 3, 0, 1, 0);
+    TEST_ASSERT(0 == lwm2mcore_TraceGetRecords(&seq, records, 8, &lostNb));
 
-    printf("======== test of lwm2mcore_Update() ========\n");
-    test_lwm2mcore_Update();
+    // The record number has to be a power of two
+    TEST_ASSERT(false == lwm2mcore_TraceEnable(6, 20));
+    TEST_ASSERT(true == lwm2mcore_TraceEnable(8, 20));
+    TEST_ASSERT(false == lwm2mcore_TraceEnable(8, 20));
 
-    printf("======== test of lwm2mcore_Push() ========\n");
-    test_lwm2mcore_Push();
+    smanager_Trace(LWM2MCORE_TRACE_READ, 3, 0, 1, 0);
+    // Platform traces can not use the LwM2MCore event Ids
+    lwm2mcore_Trace(LWM2MCORE_TRACE_WRITE, 1, 2, 3, 4);
+    lwm2mcore_Trace(LWM2MCORE_TRACE_PLATFORM_BASE + 1, 1, 2, 3, 4);
+    // 20 bytes captured in two payload records
+    smanager_TracePacket(LWM2MCORE_TRACE_COAP_SENT, 1, packet, sizeof(packet), 0);
 
-    printf("======== test of lwm2m_connect_server() ========\n");
-    test_lwm2m_connect_server();
+    TEST_ASSERT(5 == lwm2mcore_TraceGetRecords(&seq, records, 8, &lostNb));
+    TEST_ASSERT(5 == seq);
+    TEST_ASSERT(0 == lostNb);
+    TEST_ASSERT(LWM2MCORE_TRACE_READ == records[0].event);
+    TEST_ASSERT(3 == records[0].args[0]);
+    TEST_ASSERT(1 == records[0].args[2]);
+    TEST_ASSERT(LWM2MCORE_TRACE_PLATFORM_BASE + 1 == records[1].event);
+    TEST_ASSERT(4 == records[1].args[3]);
+    TEST_ASSERT(LWM2MCORE_TRACE_COAP_SENT == records[2].event);
+    TEST_ASSERT(sizeof(packet) == records[2].args[1]);
+    TEST_ASSERT(20 == records[2].args[3]);
+    TEST_ASSERT(LWM2MCORE_TRACE_PAYLOAD == records[3].event);
+    TEST_ASSERT(16 == records[3].len);
+    TEST_ASSERT(0 == memcmp(records[3].args, packet, 16));
+    TEST_ASSERT(4 == records[4].len);
+    TEST_ASSERT(0 == memcmp(records[4].args, packet + 16, 4));
+    for (i = 1; i < 5; i++)
+    {
+        TEST_ASSERT(records[i - 1].seq + 1 == records[i].seq);
+        TEST_ASSERT(records[i - 1].timeUs <= records[i].timeUs);
+    }
 
-    printf("======== test of lwm2mcore_SendAsyncResponse() ========\n");
-    test_lwm2mcore_SendAsyncResponse();
+    // The oldest records are overwritten when the ring buffer is full
+    for (i = 0; i < 10; i++)
+    {
+        smanager_Trace(LWM2MCORE_TRACE_SESSION_EVENT, i, 0, 0, 0);
+    }
+    TEST_ASSERT(8 == lwm2mcore_TraceGetRecords(&seq, records, 8, &lostNb));
+    TEST_ASSERT(2 == lostNb);
+    TEST_ASSERT(15 == seq);
+    TEST_ASSERT(2 == records[0].args[0]);
+    TEST_ASSERT(9 == records[7].args[0]);
+    TEST_ASSERT(0 == lwm2mcore_TraceGetRecords(&seq, records, 8, &lostNb));
 
-    printf("======== test of lwm2mcore_Disconnect() ========\n");
-    test_lwm2mcore_Disconnect();
+    lwm2mcore_TraceDisable();
+    seq = 0;
+    TEST_ASSERT(0 == lwm2mcore_TraceGetRecords(&seq, records, 8, NULL));
+}
 
-    printf("======== test of smanager_SendSessionEvent() ========\n");
-    test_smanager_SendSessionEvent();
+//-------------------------------------------------------------------------------------------------
+/**
+ * Test function for lwm2mcore_GetHeapStats API
+ */
+//--------------------------------------------------------------------------------------------------
+static void test_lwm2mcore_GetHeapStats
+(
+    void
+)
+{
+    lwm2mcore_HeapStats_t before;
+    lwm2mcore_HeapStats_t stats;
+    uint8_t* dataPtr;
+    char* strPtr;
+
+    TEST_ASSERT(LWM2MCORE_ERR_INVALID_ARG
+                == lwm2mcore_GetHeapStats(LWM2MCORE_HEAP_TAG_MAX, &stats));
+    TEST_ASSERT(LWM2MCORE_ERR_INVALID_ARG
+                == lwm2mcore_GetHeapStats(LWM2MCORE_HEAP_TAG_WAKAAMA, NULL));
+
+    // Allocation owned by the object manager
+    TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK
+                == lwm2mcore_GetHeapStats(LWM2MCORE_HEAP_TAG_OBJECT_MANAGER, &before));
+    dataPtr = (uint8_t*)OMANAGER_MALLOC(100);
+    TEST_ASSERT(NULL != dataPtr);
+    memset(dataPtr, 0, 100);
+    lwm2mcore_GetHeapStats(LWM2MCORE_HEAP_TAG_OBJECT_MANAGER, &stats);
+    TEST_ASSERT((before.currentBytes + 100) == stats.currentBytes);
+    TEST_ASSERT((before.currentNb + 1) == stats.currentNb);
+    TEST_ASSERT((before.allocNb + 1) == stats.allocNb);
+    TEST_ASSERT(stats.currentBytes <= stats.peakBytes);
+    lwm2m_free(dataPtr);
+    lwm2mcore_GetHeapStats(LWM2MCORE_HEAP_TAG_OBJECT_MANAGER, &stats);
+    TEST_ASSERT(before.currentBytes == stats.currentBytes);
+    TEST_ASSERT(before.currentNb == stats.currentNb);
+    TEST_ASSERT((before.freeNb + 1) == stats.freeNb);
+
+    // Allocations without tag and with an invalid tag are owned by Wakaama
+    lwm2mcore_GetHeapStats(LWM2MCORE_HEAP_TAG_WAKAAMA, &before);
+    strPtr = lwm2m_strdup("heap");
+    dataPtr = (uint8_t*)lwm2mcore_MallocTag(10, LWM2MCORE_HEAP_TAG_MAX);
+    TEST_ASSERT((NULL != strPtr) && (NULL != dataPtr));
+    TEST_ASSERT(0 == strcmp(strPtr, "heap"));
+    lwm2mcore_GetHeapStats(LWM2MCORE_HEAP_TAG_WAKAAMA, &stats);
+    TEST_ASSERT((before.currentBytes + 15) == stats.currentBytes);
+    TEST_ASSERT((before.currentNb + 2) == stats.currentNb);
+
+    // The reset keeps the current allocations
+    lwm2mcore_ResetHeapStats();
+    lwm2mcore_GetHeapStats(LWM2MCORE_HEAP_TAG_WAKAAMA, &stats);
+    TEST_ASSERT((before.currentBytes + 15) == stats.currentBytes);
+    TEST_ASSERT(stats.currentBytes == stats.peakBytes);
+    TEST_ASSERT((before.currentNb + 2) == stats.currentNb);
+    TEST_ASSERT(0 == stats.allocNb);
+    TEST_ASSERT(0 == stats.freeNb);
+    lwm2m_free(strPtr);
+    lwm2m_free(dataPtr);
+    lwm2mcore_GetHeapStats(LWM2MCORE_HEAP_TAG_WAKAAMA, &stats);
+    TEST_ASSERT(before.currentBytes == stats.currentBytes);
+    TEST_ASSERT(2 == stats.freeNb);
+}
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * Test function for the block pools and the size classes of lwm2m_malloc
+ */
+//--------------------------------------------------------------------------------------------------
+static void test_MemPool
+(
+    void
+)
+{
+    MemPoolConfig_t configs[] = {{64, 2}, {20, 2}};
+    MemPoolStats_t stats;
+    MemPoolRef_t poolRef;
+    void* blocks[3];
+    void* heapPtr;
+    int i;
+
+    // Pool instance
+    TEST_ASSERT(NULL == MemPoolCreate(0, 4));
+    TEST_ASSERT(NULL == MemPoolCreate(16, 0));
+    poolRef = MemPoolCreate(24, 2);
+    TEST_ASSERT(NULL != poolRef);
+    blocks[0] = MemPoolAlloc(poolRef);
+    blocks[1] = MemPoolAlloc(poolRef);
+    TEST_ASSERT((NULL != blocks[0]) && (NULL != blocks[1]) && (blocks[0] != blocks[1]));
+    TEST_ASSERT(0 == ((uintptr_t)blocks[0] % MEM_POOL_ALIGNMENT));
+    TEST_ASSERT(0 == ((uintptr_t)blocks[1] % MEM_POOL_ALIGNMENT));
+    memset(blocks[0], 0xA5, 32);
+    memset(blocks[1], 0x5A, 32);
+    TEST_ASSERT(NULL == MemPoolAlloc(poolRef));
+    TEST_ASSERT(MemPoolContains(poolRef, blocks[0]));
+    TEST_ASSERT(MemPoolContains(poolRef, blocks[1]));
+    TEST_ASSERT(!MemPoolContains(poolRef, &stats));
+
+    MemPoolGetStats(poolRef, &stats);
+    TEST_ASSERT(32 == stats.blockSize);
+    TEST_ASSERT(2 == stats.blockNb);
+    TEST_ASSERT(2 == stats.usedNb);
+    TEST_ASSERT(2 == stats.peakUsedNb);
+    TEST_ASSERT(2 == stats.allocNb);
+    TEST_ASSERT(1 == stats.exhaustedNb);
+    TEST_ASSERT(!MemPoolDelete(poolRef));
+
+    // The last released block is allocated first
+    MemPoolRelease(poolRef, blocks[1]);
+    TEST_ASSERT(blocks[1] == MemPoolAlloc(poolRef));
+    MemPoolRelease(poolRef, blocks[0]);
+    MemPoolRelease(poolRef, blocks[1]);
+    MemPoolGetStats(poolRef, &stats);
+    TEST_ASSERT(0 == stats.usedNb);
+    TEST_ASSERT(2 == stats.peakUsedNb);
+    TEST_ASSERT(3 == stats.allocNb);
+    TEST_ASSERT(MemPoolDelete(poolRef));
+
+    // Size classes, sorted by block size
+    TEST_ASSERT(!MemPoolSetSizeClasses(NULL, 1));
+    TEST_ASSERT(MemPoolSetSizeClasses(configs, sizeof(configs) / sizeof(configs[0])));
+    TEST_ASSERT(MemPoolGetSizeClassStats(0, &stats));
+    TEST_ASSERT(32 == stats.blockSize);
+    TEST_ASSERT(MemPoolGetSizeClassStats(1, &stats));
+    TEST_ASSERT(64 == stats.blockSize);
+    TEST_ASSERT(!MemPoolGetSizeClassStats(2, &stats));
+
+    // Small allocations are served by the smallest class with a free block
+    for (i = 0; i < 3; i++)
+    {
+        blocks[i] = lwm2m_malloc(8);
+        TEST_ASSERT(NULL != blocks[i]);
+        memset(blocks[i], i, 8);
+    }
+    MemPoolGetSizeClassStats(0, &stats);
+    TEST_ASSERT(2 == stats.usedNb);
+    TEST_ASSERT(1 == stats.exhaustedNb);
+    MemPoolGetSizeClassStats(1, &stats);
+    TEST_ASSERT(1 == stats.usedNb);
+
+    // Large allocations are served by the heap
+    heapPtr = lwm2m_malloc(1000);
+    TEST_ASSERT(NULL != heapPtr);
+    memset(heapPtr, 0, 1000);
+    MemPoolGetSizeClassStats(1, &stats);
+    TEST_ASSERT(1 == stats.usedNb);
+    TEST_ASSERT(1 == stats.allocNb);
+
+    // The size classes can't be changed while they are in use
+    TEST_ASSERT(!MemPoolSetSizeClasses(NULL, 0));
+    lwm2m_free(heapPtr);
+    for (i = 0; i < 3; i++)
+    {
+        lwm2m_free(blocks[i]);
+    }
+    MemPoolGetSizeClassStats(0, &stats);
+    TEST_ASSERT(0 == stats.usedNb);
+    MemPoolGetSizeClassStats(1, &stats);
+    TEST_ASSERT(0 == stats.usedNb);
+    TEST_ASSERT(MemPoolSetSizeClasses(NULL, 0));
+    TEST_ASSERT(!MemPoolGetSizeClassStats(0, &stats));
+}
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * Test function for lwm2mcore_SenmlSerialize API
+ */
+//--------------------------------------------------------------------------------------------------
+static void test_lwm2mcore_SenmlSerialize
+(
+    void
+)
+{
+    static const char expectedJson[] =
+        "[{\"bn\":\"/3/0/\",\"n\":\"0\",\"vs\":\"Sierra \\\"W\\\"\"},{\"n\":\"9\",\"v\":80},"
+        "{\"n\":\"11/0\",\"v\":0},{\"n\":\"11/1\",\"v\":-2},{\"n\":\"2\",\"vd\":\"AQL_\"},"
+        "{\"n\":\"5\",\"vb\":true},{\"n\":\"7\",\"v\":1.5},{\"n\":\"10\",\"vlo\":\"3:1\"}]";
+    static const uint8_t expectedCbor[] =
+    {
+        0x82,
+        0xA3, 0x21, 0x65, '/', '3', '/', '0', '/', 0x00, 0x61, '9', 0x02, 0x18, 0x50,
+        0xA2, 0x00, 0x61, '7', 0x02, 0xFA, 0x3F, 0xC0, 0x00, 0x00
+    };
+    static const char expectedSeries[] =
+        "[{\"bn\":\"/3303/0/\",\"bt\":1700000000,\"n\":\"5700\",\"v\":21.5},"
+        "{\"n\":\"5700\",\"t\":60,\"v\":0.1}]";
+    uint8_t opaque[] = {0x01, 0x02, 0xFF};
+    char string[] = "Sierra \"W\"";
+    lwm2m_uri_t uri;
+    lwm2m_data_t instances[2];
+    lwm2m_data_t data[7];
+    lwm2m_data_t sample;
+    omanager_SenmlWriter_t writer;
+    uint8_t buffer[128];
+    uint8_t* payloadPtr;
+    size_t length;
+    int len;
+
+    memset(&uri, 0, sizeof(uri));
+    uri.flag = LWM2M_URI_FLAG_OBJECT_ID | LWM2M_URI_FLAG_INSTANCE_ID;
+    uri.objectId = 3;
+    uri.instanceId = 0;
+
+    memset(data, 0, sizeof(data));
+    memset(instances, 0, sizeof(instances));
+    data[0].id = 0;
+    data[0].type = LWM2M_TYPE_STRING;
+    data[0].value.asBuffer.buffer = (uint8_t*)string;
+    data[0].value.asBuffer.length = strlen(string);
+    data[1].id = 9;
+    data[1].type = LWM2M_TYPE_INTEGER;
+    data[1].value.asInteger = 80;
+    data[2].id = 11;
+    data[2].type = LWM2M_TYPE_MULTIPLE_RESOURCE;
+    data[2].value.asChildren.count = 2;
+    data[2].value.asChildren.array = instances;
+    instances[0].id = 0;
+    instances[0].type = LWM2M_TYPE_INTEGER;
+    instances[0].value.asInteger = 0;
+    instances[1].id = 1;
+    instances[1].type = LWM2M_TYPE_INTEGER;
+    instances[1].value.asInteger = -2;
+    data[3].id = 2;
+    data[3].type = LWM2M_TYPE_OPAQUE;
+    data[3].value.asBuffer.buffer = opaque;
+    data[3].value.asBuffer.length = sizeof(opaque);
+    data[4].id = 5;
+    data[4].type = LWM2M_TYPE_BOOLEAN;
+    data[4].value.asBoolean = true;
+    data[5].id = 7;
+    data[5].type = LWM2M_TYPE_FLOAT;
+    data[5].value.asFloat = 1.5;
+    data[6].id = 10;
+    data[6].type = LWM2M_TYPE_OBJECT_LINK;
+    data[6].value.asObjLink.objectId = 3;
+    data[6].value.asObjLink.objectInstanceId = 1;
+
+    // Not a SenML content format
+    TEST_ASSERT(-1 == lwm2mcore_SenmlSerialize(&uri, 7, data, LWM2M_CONTENT_TLV, &payloadPtr));
+    TEST_ASSERT(NULL == payloadPtr);
+
+    // SenML-JSON with base name
+    len = lwm2mcore_SenmlSerialize(&uri, 7, data, LWM2MCORE_CONTENT_SENML_JSON, &payloadPtr);
+    TEST_ASSERT((int)strlen(expectedJson) == len);
+    TEST_ASSERT(0 == memcmp(expectedJson, payloadPtr, (size_t)len));
+    lwm2m_free(payloadPtr);
+
+    // SenML-CBOR, the float is encoded in single precision
+    data[0] = data[1];
+    data[1] = data[5];
+    len = lwm2mcore_SenmlSerialize(&uri, 2, data, LWM2MCORE_CONTENT_SENML_CBOR, &payloadPtr);
+    TEST_ASSERT(sizeof(expectedCbor) == (size_t)len);
+    TEST_ASSERT(0 == memcmp(expectedCbor, payloadPtr, (size_t)len));
+    lwm2m_free(payloadPtr);
+
+    // A float which is not finite can't be encoded in SenML-JSON
+    data[1].value.asFloat = strtod("inf", NULL);
+    TEST_ASSERT(-1 == lwm2mcore_SenmlSerialize(&uri, 2, data, LWM2MCORE_CONTENT_SENML_JSON,
+                                               &payloadPtr));
+    TEST_ASSERT(NULL == payloadPtr);
+
+    // Timestamped records with base time, in a caller buffer
+    memset(&sample, 0, sizeof(sample));
+    sample.type = LWM2M_TYPE_FLOAT;
+    TEST_ASSERT(omanager_SenmlBegin(&writer, LWM2MCORE_CONTENT_SENML_JSON, buffer, sizeof(buffer),
+                                    2, "/3303/0/", 1700000000));
+    sample.value.asFloat = 21.5;
+    TEST_ASSERT(omanager_SenmlAddRecord(&writer, "5700", 1700000000, &sample));
+    sample.value.asFloat = 0.1;
+    TEST_ASSERT(omanager_SenmlAddRecord(&writer, "5700", 1700000060, &sample));
+    TEST_ASSERT(!omanager_SenmlAddRecord(&writer, "5700", 1700000120, &sample));
+    length = omanager_SenmlEnd(&writer);
+    TEST_ASSERT(strlen(expectedSeries) == length);
+    TEST_ASSERT(0 == memcmp(expectedSeries, buffer, length));
+
+    // Buffer too small
+    TEST_ASSERT(omanager_SenmlBegin(&writer, LWM2MCORE_CONTENT_SENML_CBOR, buffer, 8, 1,
+                                    "/3303/0/", 0));
+    TEST_ASSERT(!omanager_SenmlAddRecord(&writer, "5700", 0, &sample));
+    TEST_ASSERT(0 == omanager_SenmlEnd(&writer));
+}
+
+//-------------------------------------------------------------------------------------------------
+/**
+ * Test function for lwm2mcore_SendAsyncResponse API
+ */
+//--------------------------------------------------------------------------------------------------
+void test_lwm2mcore_SendAsyncResponse
+(
+    void
+)
+{
+    RequestPtr = (lwm2mcore_CoapRequest_t*)lwm2m_malloc(sizeof(lwm2mcore_CoapRequest_t));
+    if (NULL == RequestPtr)
+    {
+        printf("RequestPtr is NULL!\n");
+        TEST_ASSERT(false);
+    }
+
+    RequestPtr->uriLength = strlen("www.sierrawireless.com");
+    RequestPtr->uri = (char*)lwm2m_malloc(RequestPtr->uriLength + 1);
+    strncpy(RequestPtr->uri, "www.sierrawireless.com", RequestPtr->uriLength + 1);
+
+    RequestPtr->method = 1;
+
+    RequestPtr->bufferLength = strlen("123456789");
+    RequestPtr->buffer = (uint8_t*)lwm2m_malloc(RequestPtr->bufferLength + 1);
+    strncpy((char*)RequestPtr->buffer, "123456789", RequestPtr->bufferLength + 1);
+
+    RequestPtr->messageId = 100;
+    RequestPtr->tokenLength = 3;
+    memcpy(RequestPtr->token, "hi", 3);
+    RequestPtr->contentType = 1;
+
+    Lwm2mServerResponse.code = COAP_RESOURCE_CHANGED;
+
+    Lwm2mServerResponse.payloadLength = strlen("123456789");
+    Lwm2mServerResponse.payload = (uint8_t*)lwm2m_malloc(Lwm2mServerResponse.payloadLength + 1);
+    strncpy((char*)Lwm2mServerResponse.payload, "123456789", Lwm2mServerResponse.payloadLength + 1);
+
+    TEST_ASSERT(lwm2mcore_SendAsyncResponse(Lwm2mcoreRef, RequestPtr, &Lwm2mServerResponse)
+                != false);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Package downloader callback: initialize the download
+ */
+//--------------------------------------------------------------------------------------------------
+static lwm2mcore_DwlResult_t TestInitDownload
+(
+    char* uriPtr,   ///< [IN] URI to use for the download
+    void* ctxPtr    ///< [IN] Context pointer
+)
+{
+    (void)uriPtr;
+    (void)ctxPtr;
+    return DWL_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Package downloader callback: get the package information
+ */
+//--------------------------------------------------------------------------------------------------
+static lwm2mcore_DwlResult_t TestGetPackageInfo
+(
+    lwm2mcore_PackageDownloaderData_t* dataPtr, ///< [INOUT] Information about the package
+    void* ctxPtr                                ///< [IN] Context pointer
+)
+{
+    (void)ctxPtr;
+    dataPtr->packageSize = TestPackage.packageLen;
+    return DWL_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Package downloader callback: set the firmware update state
+ */
+//--------------------------------------------------------------------------------------------------
+static lwm2mcore_DwlResult_t TestSetFwUpdateState
+(
+    lwm2mcore_FwUpdateState_t updateState       ///< [IN] New update state
+)
+{
+    TestFwUpdateState = updateState;
+    return DWL_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Package downloader callback: set the firmware update result
+ */
+//--------------------------------------------------------------------------------------------------
+static lwm2mcore_DwlResult_t TestSetFwUpdateResult
+(
+    lwm2mcore_FwUpdateResult_t updateResult     ///< [IN] New update result
+)
+{
+    TestFwUpdateResult = updateResult;
+    return DWL_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Package downloader callback: set the software update state
+ */
+//--------------------------------------------------------------------------------------------------
+static lwm2mcore_DwlResult_t TestSetSwUpdateState
+(
+    lwm2mcore_SwUpdateState_t updateState       ///< [IN] New update state
+)
+{
+    (void)updateState;
+    return DWL_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Package downloader callback: set the software update result
+ */
+//--------------------------------------------------------------------------------------------------
+static lwm2mcore_DwlResult_t TestSetSwUpdateResult
+(
+    lwm2mcore_SwUpdateResult_t updateResult     ///< [IN] New update result
+)
+{
+    (void)updateResult;
+    return DWL_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Package downloader callback: download the package sequentially from the given offset, by
+ * chunks. The download is suspended every TestSuspendLen bytes of the package.
+ */
+//--------------------------------------------------------------------------------------------------
+static lwm2mcore_DwlResult_t TestDownload
+(
+    uint64_t startOffset,   ///< [IN] Offset indicating where to start the download
+    void* ctxPtr            ///< [IN] Context pointer
+)
+{
+    size_t offset = (size_t)startOffset;
+
+    (void)ctxPtr;
+
+    while (offset < TestPackage.packageLen)
+    {
+        size_t len = TestPackage.packageLen - offset;
+        lwm2mcore_DwlResult_t result;
+
+        if ((TestSuspendLen) && (offset >= TestSuspendOffset))
+        {
+            TestSuspendOffset = offset + TestSuspendLen;
+            TestIsSuspended = true;
+            return DWL_SUSPEND;
+        }
+
+        if (len > TEST_DWL_CHUNK_LEN)
+        {
+            len = TEST_DWL_CHUNK_LEN;
+        }
+
+        result = lwm2mcore_PackageDownloaderReceiveData(TestPackage.packagePtr + offset, len);
+        if (DWL_OK != result)
+        {
+            return result;
+        }
+        offset += len;
+    }
+
+    return DWL_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Package downloader callback: download the package by ranges from the HTTP server stand-in.
+ *
+ * Each connection waits for a random latency before receiving each chunk of its range, so that
+ * the chunks of the different ranges are received out of order.
+ */
+//--------------------------------------------------------------------------------------------------
+static lwm2mcore_DwlResult_t TestDownloadRanges
+(
+    void* ctxPtr            ///< [IN] Context pointer
+)
+{
+    TestConnection_t connections[TEST_DWL_CONNECTIONS];
+    uint8_t* receivedPtr;
+    uint64_t firstMissingOffset = 0;
+    uint64_t requestedOffset = 0;
+    uint32_t tick = 0;
+    bool allRequested = false;
+    bool activeConnection = true;
+    int i;
+
+    (void)ctxPtr;
+    memset(connections, 0, sizeof(connections));
+
+    // Received bytes of the package
+    receivedPtr = (uint8_t*)malloc(TestPackage.packageLen);
+    TEST_ASSERT(NULL != receivedPtr);
+    memset(receivedPtr, 0, TestPackage.packageLen);
+
+    while ((!allRequested) || (activeConnection))
+    {
+        activeConnection = false;
+
+        for (i = 0; i < TEST_DWL_CONNECTIONS; i++)
+        {
+            TestConnection_t* connPtr = &connections[i];
+
+            // Request a new range on an idle connection
+            if ((0 == connPtr->range.length) && (!allRequested))
+            {
+                lwm2mcore_DwlResult_t result;
+
+                result = lwm2mcore_PackageDownloaderGetNextRange(&connPtr->range);
+                TEST_ASSERT((DWL_OK == result) || (DWL_BUSY == result));
+                if (DWL_OK == result)
+                {
+                    if (0 == connPtr->range.length)
+                    {
+                        allRequested = true;
+                    }
+                    else
+                    {
+                        TEST_ASSERT(requestedOffset == connPtr->range.startOffset);
+                        requestedOffset += connPtr->range.length;
+                        connPtr->readyTick = tick + (uint32_t)(rand() % TEST_DWL_MAX_LATENCY);
+                    }
+                }
+            }
+
+            if (0 == connPtr->range.length)
+            {
+                continue;
+            }
+            activeConnection = true;
+
+            // Receive the next chunk of the range once the latency elapsed
+            if (connPtr->readyTick <= tick)
+            {
+                size_t len = TEST_DWL_CHUNK_LEN;
+                uint64_t offset = connPtr->range.startOffset;
+
+                if (connPtr->range.length < len)
+                {
+                    len = (size_t)connPtr->range.length;
+                }
+
+                bool isOutOfOrder = (offset != firstMissingOffset);
+
+                if (isOutOfOrder)
+                {
+                    TestOutOfOrderCount++;
+                }
+                memset(receivedPtr + offset, 1, len);
+                while ((firstMissingOffset < TestPackage.packageLen) && (receivedPtr[firstMissingOffset]))
+                {
+                    firstMissingOffset++;
+                }
+
+                TEST_ASSERT(DWL_OK == lwm2mcore_PackageDownloaderReceiveRange(offset,
+                                                                            TestPackage.packagePtr + offset,
+                                                                            len));
+                if ((TestResendChunks) && (isOutOfOrder))
+                {
+                    TEST_ASSERT(DWL_OK == lwm2mcore_PackageDownloaderReceiveRange(offset,
+                                                                            TestPackage.packagePtr + offset,
+                                                                            len));
+                }
+                connPtr->range.startOffset += len;
+                connPtr->range.length -= len;
+                connPtr->readyTick = tick + (uint32_t)(rand() % TEST_DWL_MAX_LATENCY);
+            }
+        }
+
+        // Track the data requested ahead of the first missing byte
+        if ((requestedOffset - firstMissingOffset) > TestMaxAheadLen)
+        {
+            TestMaxAheadLen = requestedOffset - firstMissingOffset;
+        }
+
+        tick++;
+    }
+
+    TEST_ASSERT(TestPackage.packageLen == firstMissingOffset);
+    free(receivedPtr);
+    return DWL_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Package downloader callback: store the binary data
+ */
+//--------------------------------------------------------------------------------------------------
+static lwm2mcore_DwlResult_t TestStoreRange
+(
+    uint8_t* bufPtr,        ///< [IN] Buffer of data to store
+    size_t bufSize,         ///< [IN] Size of buffer to store
+    void* ctxPtr            ///< [IN] Context pointer
+)
+{
+    (void)ctxPtr;
+
+    TEST_ASSERT((TestStoredLen + bufSize) <= TEST_DWL_BINARY_LEN);
+    memcpy(TestStoredPtr + TestStoredLen, bufPtr, bufSize);
+    TestStoredLen += bufSize;
+    return DWL_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Package downloader callback: start an asynchronous transfer from the given offset
+ */
+//--------------------------------------------------------------------------------------------------
+static lwm2mcore_DwlResult_t TestStartTransfer
+(
+    uint64_t startOffset,   ///< [IN] Offset indicating where to start the download
+    void* ctxPtr            ///< [IN] Context pointer
+)
+{
+    (void)ctxPtr;
+
+    TestTransferOffset = startOffset;
+    return DWL_BUSY;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Package downloader callback: queue the data in the asynchronous storage stand-in, which is busy
+ * once its write queue is full
+ */
+//--------------------------------------------------------------------------------------------------
+static lwm2mcore_DwlResult_t TestQueueRange
+(
+    uint8_t* bufPtr,        ///< [IN] Buffer of data to store
+    size_t bufSize,         ///< [IN] Size of buffer to store
+    void* ctxPtr            ///< [IN] Context pointer
+)
+{
+    TEST_ASSERT(DWL_OK == TestStoreRange(bufPtr, bufSize, ctxPtr));
+
+    TestStoreQueueLen += bufSize;
+    if (TEST_ASYNC_QUEUE_LEN <= TestStoreQueueLen)
+    {
+        TestStoreBusyCount++;
+        return DWL_BUSY;
+    }
+    return DWL_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Package downloader callback: end the download
+ */
+//--------------------------------------------------------------------------------------------------
+static lwm2mcore_DwlResult_t TestEndDownload
+(
+    void* ctxPtr            ///< [IN] Context pointer
+)
+{
+    (void)ctxPtr;
+    return DWL_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Generate a test DWL package and set its public key for the signature verification
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestGeneratePackage
+(
+    bool isCompressed       ///< [IN] Generate a COMP section instead of a BINA section
+)
+{
+    dwlgen_Config_t config;
+
+    memset(&config, 0, sizeof(config));
+    config.binaryLen = TEST_DWL_BINARY_LEN;
+    config.commentLen = TEST_DWL_COMMENT_LEN;
+    config.isCompressed = isCompressed;
+    config.seed = 1;
+
+    TEST_ASSERT(dwlgen_Build(&config, &TestPackage));
+    TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == lwm2mcore_SetCredential(LWM2MCORE_CREDENTIAL_FW_KEY,
+                                                                      LWM2MCORE_BS_SERVER_ID,
+                                                                      (char*)TestPackage.publicKey,
+                                                                      TestPackage.publicKeyLen));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Run the package downloader with the test package, resuming the download after each suspend
+ *
+ * @return
+ *  - Package downloader result
+ */
+//--------------------------------------------------------------------------------------------------
+static lwm2mcore_DwlResult_t TestRunPackageDownloader
+(
+    bool useRanges          ///< [IN] Download the package by ranges
+)
+{
+    lwm2mcore_PackageDownloader_t pkgDwl;
+    lwm2mcore_DwlResult_t result;
+
+    memset(&pkgDwl, 0, sizeof(pkgDwl));
+    pkgDwl.data.updateType = LWM2MCORE_FW_UPDATE_TYPE;
+    pkgDwl.initDownload = TestInitDownload;
+    pkgDwl.getInfo = TestGetPackageInfo;
+    pkgDwl.setFwUpdateState = TestSetFwUpdateState;
+    pkgDwl.setFwUpdateResult = TestSetFwUpdateResult;
+    pkgDwl.setSwUpdateState = TestSetSwUpdateState;
+    pkgDwl.setSwUpdateResult = TestSetSwUpdateResult;
+    pkgDwl.download = TestDownload;
+    pkgDwl.downloadRanges = useRanges ? TestDownloadRanges : NULL;
+    pkgDwl.storeRange = TestStoreRange;
+    pkgDwl.endDownload = TestEndDownload;
+
+    TestStoredLen = 0;
+    TestSuspendOffset = TestSuspendLen;
+    TestFwUpdateState = LWM2MCORE_FW_UPDATE_STATE_IDLE;
+    TestFwUpdateResult = LWM2MCORE_FW_UPDATE_RESULT_DEFAULT_NORMAL;
+    lwm2mcore_PackageDownloaderInit();
+
+    do
+    {
+        TestIsSuspended = false;
+        result = lwm2mcore_PackageDownloaderRun(&pkgDwl);
+        if (TestIsSuspended)
+        {
+            // Resume the download from the stored data
+            pkgDwl.data.isResume = true;
+            pkgDwl.data.updateOffset = TestStoredLen;
+        }
+    }
+    while ((DWL_OK == result) && (TestIsSuspended));
+
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test function for sequential package download: lwm2mcore_PackageDownloaderRun and
+ * lwm2mcore_PackageDownloaderReceiveData APIs, with raw and compressed binary data, download
+ * suspend and resume, and corrupted package
+ */
+//--------------------------------------------------------------------------------------------------
+static void test_lwm2mcore_PackageDownloaderReceiveData
+(
+    void
+)
+{
+    int i;
+
+    TestStoredPtr = (uint8_t*)malloc(TEST_DWL_BINARY_LEN);
+    TEST_ASSERT(NULL != TestStoredPtr);
+
+    for (i = 0; i < 2; i++)
+    {
+        bool isCompressed = (1 == i);
+
+        TestGeneratePackage(isCompressed);
+
+        // Download without suspend
+        TestSuspendLen = 0;
+        TEST_ASSERT(DWL_OK == TestRunPackageDownloader(false));
+        TEST_ASSERT(LWM2MCORE_FW_UPDATE_STATE_DOWNLOADED == TestFwUpdateState);
+        TEST_ASSERT(LWM2MCORE_FW_UPDATE_RESULT_DEFAULT_NORMAL == TestFwUpdateResult);
+        TEST_ASSERT(TEST_DWL_BINARY_LEN == TestStoredLen);
+        TEST_ASSERT(0 == memcmp(TestPackage.binaryPtr, TestStoredPtr, TEST_DWL_BINARY_LEN));
+
+        // Download with several suspend and resume cycles
+        TestSuspendLen = TEST_DWL_SUSPEND_LEN;
+        TEST_ASSERT(DWL_OK == TestRunPackageDownloader(false));
+        TEST_ASSERT(LWM2MCORE_FW_UPDATE_STATE_DOWNLOADED == TestFwUpdateState);
+        TEST_ASSERT(LWM2MCORE_FW_UPDATE_RESULT_DEFAULT_NORMAL == TestFwUpdateResult);
+        TEST_ASSERT(TEST_DWL_BINARY_LEN == TestStoredLen);
+        TEST_ASSERT(0 == memcmp(TestPackage.binaryPtr, TestStoredPtr, TEST_DWL_BINARY_LEN));
+
+        // Corrupted binary data is detected
+        TestSuspendLen = 0;
+        TestPackage.packagePtr[TestPackage.packageLen / 2] ^= 0x01;
+        TestRunPackageDownloader(false);
+        TEST_ASSERT(LWM2MCORE_FW_UPDATE_STATE_IDLE == TestFwUpdateState);
+        TEST_ASSERT(LWM2MCORE_FW_UPDATE_RESULT_VERIFY_ERROR == TestFwUpdateResult);
+
+        dwlgen_Free(&TestPackage);
+    }
+
+    free(TestStoredPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test function for asynchronous package download: lwm2mcore_PackageDownloaderProcessData and
+ * lwm2mcore_PackageDownloaderEndTransfer APIs.
+ *
+ * A single-threaded event loop delivers the downloaded data chunks, completes the writes of the
+ * asynchronous storage and suspends the download once, while the downloader never blocks.
+ */
+//--------------------------------------------------------------------------------------------------
+static void test_lwm2mcore_PackageDownloaderAsync
+(
+    void
+)
+{
+    int i;
+
+    TestStoredPtr = (uint8_t*)malloc(TEST_DWL_BINARY_LEN);
+    TEST_ASSERT(NULL != TestStoredPtr);
+
+    for (i = 0; i < 2; i++)
+    {
+        lwm2mcore_PackageDownloader_t pkgDwl;
+        bool isSuspendDone = false;
+        bool isStorageBusy = false;
+        size_t offset;
+        size_t pendingLen = 0;
+
+        TestGeneratePackage(1 == i);
+
+        memset(&pkgDwl, 0, sizeof(pkgDwl));
+        pkgDwl.data.updateType = LWM2MCORE_FW_UPDATE_TYPE;
+        pkgDwl.initDownload = TestInitDownload;
+        pkgDwl.getInfo = TestGetPackageInfo;
+        pkgDwl.setFwUpdateState = TestSetFwUpdateState;
+        pkgDwl.setFwUpdateResult = TestSetFwUpdateResult;
+        pkgDwl.setSwUpdateState = TestSetSwUpdateState;
+        pkgDwl.setSwUpdateResult = TestSetSwUpdateResult;
+        pkgDwl.download = TestStartTransfer;
+        pkgDwl.storeRange = TestQueueRange;
+        pkgDwl.endDownload = TestEndDownload;
+
+        TestStoredLen = 0;
+        TestStoreQueueLen = 0;
+        TestStoreBusyCount = 0;
+        TestFwUpdateState = LWM2MCORE_FW_UPDATE_STATE_IDLE;
+        TestFwUpdateResult = LWM2MCORE_FW_UPDATE_RESULT_DEFAULT_NORMAL;
+        lwm2mcore_PackageDownloaderInit();
+
+        // The download is started without blocking
+        TEST_ASSERT(DWL_BUSY == lwm2mcore_PackageDownloaderRun(&pkgDwl));
+        TEST_ASSERT(LWM2MCORE_FW_UPDATE_STATE_DOWNLOADING == TestFwUpdateState);
+        offset = (size_t)TestTransferOffset;
+
+        // Event loop
+        while (offset < TestPackage.packageLen)
+        {
+            if (isStorageBusy)
+            {
+                // Storage completion event
+                TestStoreQueueLen = 0;
+                isStorageBusy = false;
+            }
+            else if ((!isSuspendDone) && (offset >= TEST_DWL_SUSPEND_LEN))
+            {
+                // The transfer is interrupted: suspend and resume the download
+                isSuspendDone = true;
+                TEST_ASSERT(DWL_OK == lwm2mcore_PackageDownloaderEndTransfer(DWL_SUSPEND));
+                pkgDwl.data.isResume = true;
+                pkgDwl.data.updateOffset = TestStoredLen;
+                TestStoreQueueLen = 0;
+                TEST_ASSERT(DWL_BUSY == lwm2mcore_PackageDownloaderRun(&pkgDwl));
+                offset = (size_t)TestTransferOffset;
+                pendingLen = 0;
+            }
+            else
+            {
+                // Data arrival event, the data not processed are given again after the storage
+                // completion
+                size_t processedLen = 0;
+                lwm2mcore_DwlResult_t result;
+
+                if (!pendingLen)
+                {
+                    pendingLen = TestPackage.packageLen - offset;
+                    if (pendingLen > TEST_DWL_CHUNK_LEN)
+                    {
+                        pendingLen = TEST_DWL_CHUNK_LEN;
+                    }
+                }
+
+                result = lwm2mcore_PackageDownloaderProcessData(TestPackage.packagePtr + offset,
+                                                                pendingLen,
+                                                                &processedLen);
+                TEST_ASSERT((DWL_OK == result) || (DWL_BUSY == result));
+                TEST_ASSERT(processedLen <= pendingLen);
+                isStorageBusy = (DWL_BUSY == result);
+                offset += processedLen;
+                pendingLen -= processedLen;
+            }
+        }
+
+        TEST_ASSERT(isSuspendDone);
+        TEST_ASSERT(0 < TestStoreBusyCount);
+        TEST_ASSERT(DWL_OK == lwm2mcore_PackageDownloaderEndTransfer(DWL_OK));
+        TEST_ASSERT(LWM2MCORE_FW_UPDATE_STATE_DOWNLOADED == TestFwUpdateState);
+        TEST_ASSERT(LWM2MCORE_FW_UPDATE_RESULT_DEFAULT_NORMAL == TestFwUpdateResult);
+        TEST_ASSERT(TEST_DWL_BINARY_LEN == TestStoredLen);
+        TEST_ASSERT(0 == memcmp(TestPackage.binaryPtr, TestStoredPtr, TEST_DWL_BINARY_LEN));
+
+        // No transfer is ongoing anymore
+        TEST_ASSERT(DWL_FAULT == lwm2mcore_PackageDownloaderEndTransfer(DWL_OK));
+
+        dwlgen_Free(&TestPackage);
+    }
+
+    free(TestStoredPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test function for multi-range package download: lwm2mcore_PackageDownloaderGetNextRange and
+ * lwm2mcore_PackageDownloaderReceiveRange APIs
+ */
+//--------------------------------------------------------------------------------------------------
+static void test_lwm2mcore_PackageDownloaderRanges
+(
+    void
+)
+{
+    TestStoredPtr = (uint8_t*)malloc(TEST_DWL_BINARY_LEN);
+    TEST_ASSERT(NULL != TestStoredPtr);
+    TestGeneratePackage(false);
+    srand(1);
+
+    TestSuspendLen = 0;
+    TEST_ASSERT(DWL_OK == TestRunPackageDownloader(true));
+
+    // The package is verified and the binary data is stored in order
+    TEST_ASSERT(LWM2MCORE_FW_UPDATE_STATE_DOWNLOADED == TestFwUpdateState);
+    TEST_ASSERT(LWM2MCORE_FW_UPDATE_RESULT_DEFAULT_NORMAL == TestFwUpdateResult);
+    TEST_ASSERT(TEST_DWL_BINARY_LEN == TestStoredLen);
+    TEST_ASSERT(0 == memcmp(TestPackage.binaryPtr, TestStoredPtr, TEST_DWL_BINARY_LEN));
+
+    // The ranges were received out of order, within the reordering limit
+    TEST_ASSERT(0 < TestOutOfOrderCount);
+    TEST_ASSERT(PKG_DWL_REORDER_MAX_LEN >= TestMaxAheadLen);
+
+    // The out-of-order chunks received twice are buffered once, within the reordering limit
+    TestResendChunks = true;
+    TestOutOfOrderCount = 0;
+    memset(TestStoredPtr, 0, TEST_DWL_BINARY_LEN);
+    TEST_ASSERT(DWL_OK == TestRunPackageDownloader(true));
+    TestResendChunks = false;
+
+    TEST_ASSERT(LWM2MCORE_FW_UPDATE_STATE_DOWNLOADED == TestFwUpdateState);
+    TEST_ASSERT(LWM2MCORE_FW_UPDATE_RESULT_DEFAULT_NORMAL == TestFwUpdateResult);
+    TEST_ASSERT(TEST_DWL_BINARY_LEN == TestStoredLen);
+    TEST_ASSERT(0 == memcmp(TestPackage.binaryPtr, TestStoredPtr, TEST_DWL_BINARY_LEN));
+    TEST_ASSERT(0 < TestOutOfOrderCount);
+
+    dwlgen_Free(&TestPackage);
+    free(TestStoredPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test function for the Linux package storage backend: the package downloader stores the binary
+ * data with PackageStorageStoreRange, the storage being closed and reopened at each download
+ * suspend, for each write mode
+ */
+//--------------------------------------------------------------------------------------------------
+static void test_PackageStorage
+(
+    void
+)
+{
+    PackageStorageMode_t modes[] = { PKG_STORAGE_MODE_BUFFERED,
+                                     PKG_STORAGE_MODE_DIRECT,
+                                     PKG_STORAGE_MODE_MMAP };
+    size_t i;
+
+    TestGeneratePackage(true);
+
+    for (i = 0; i < (sizeof(modes) / sizeof(modes[0])); i++)
+    {
+        lwm2mcore_PackageDownloader_t pkgDwl;
+        PackageStorage_t storage;
+        lwm2mcore_DwlResult_t result;
+        FILE* filePtr;
+        uint8_t* readPtr;
+
+        memset(&pkgDwl, 0, sizeof(pkgDwl));
+        pkgDwl.data.updateType = LWM2MCORE_FW_UPDATE_TYPE;
+        pkgDwl.initDownload = TestInitDownload;
+        pkgDwl.getInfo = TestGetPackageInfo;
+        pkgDwl.setFwUpdateState = TestSetFwUpdateState;
+        pkgDwl.setFwUpdateResult = TestSetFwUpdateResult;
+        pkgDwl.setSwUpdateState = TestSetSwUpdateState;
+        pkgDwl.setSwUpdateResult = TestSetSwUpdateResult;
+        pkgDwl.download = TestDownload;
+        pkgDwl.storeRange = PackageStorageStoreRange;
+        pkgDwl.endDownload = TestEndDownload;
+        pkgDwl.ctxPtr = &storage;
+
+        TestSuspendLen = TEST_DWL_SUSPEND_LEN;
+        TestSuspendOffset = TestSuspendLen;
+        TestFwUpdateState = LWM2MCORE_FW_UPDATE_STATE_IDLE;
+        TestFwUpdateResult = LWM2MCORE_FW_UPDATE_RESULT_DEFAULT_NORMAL;
+        lwm2mcore_PackageDownloaderInit();
+
+        TEST_ASSERT(DWL_OK == PackageStorageOpen(&storage,
+                                                 TEST_PKG_STORAGE_FILE,
+                                                 TestPackage.packageLen,
+                                                 modes[i],
+                                                 false));
+        storage.checkpointInterval = TEST_PKG_STORAGE_CHECKPOINT;
+
+        do
+        {
+            TestIsSuspended = false;
+            result = lwm2mcore_PackageDownloaderRun(&pkgDwl);
+            if (TestIsSuspended)
+            {
+                // Resume the download from the data committed to the package file
+                TEST_ASSERT(DWL_OK == PackageStorageClose(&storage, false));
+                TEST_ASSERT(DWL_OK == PackageStorageOpen(&storage,
+                                                         TEST_PKG_STORAGE_FILE,
+                                                         TestPackage.packageLen,
+                                                         modes[i],
+                                                         true));
+                storage.checkpointInterval = TEST_PKG_STORAGE_CHECKPOINT;
+                TEST_ASSERT(PackageStorageGetCommittedLen(&storage) <= TEST_DWL_BINARY_LEN);
+                pkgDwl.data.isResume = true;
+                pkgDwl.data.updateOffset = PackageStorageGetCommittedLen(&storage);
+            }
+        }
+        while ((DWL_OK == result) && (TestIsSuspended));
+
+        TEST_ASSERT(DWL_OK == result);
+        TEST_ASSERT(LWM2MCORE_FW_UPDATE_STATE_DOWNLOADED == TestFwUpdateState);
+        TEST_ASSERT(LWM2MCORE_FW_UPDATE_RESULT_DEFAULT_NORMAL == TestFwUpdateResult);
+        TEST_ASSERT(DWL_OK == PackageStorageClose(&storage, true));
+        TEST_ASSERT(TEST_DWL_BINARY_LEN == PackageStorageGetCommittedLen(&storage));
+
+        // The package file contains exactly the binary data
+        readPtr = (uint8_t*)malloc(TEST_DWL_BINARY_LEN + 1);
+        TEST_ASSERT(NULL != readPtr);
+        filePtr = fopen(TEST_PKG_STORAGE_FILE, "rb");
+        TEST_ASSERT(NULL != filePtr);
+        TEST_ASSERT(TEST_DWL_BINARY_LEN == fread(readPtr, 1, TEST_DWL_BINARY_LEN + 1, filePtr));
+        fclose(filePtr);
+        TEST_ASSERT(0 == memcmp(TestPackage.binaryPtr, readPtr, TEST_DWL_BINARY_LEN));
+        free(readPtr);
+        remove(TEST_PKG_STORAGE_FILE);
+    }
+
+    dwlgen_Free(&TestPackage);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test function for the Block1 streamed write of large resources: the SSL certificate and a
+ * firmware package pushed by the server
+ */
+//--------------------------------------------------------------------------------------------------
+static void test_lwm2mcore_StreamWrite
+(
+    void
+)
+{
+    const size_t certLen = (64 * 1024) + 100;
+    const size_t blockLen = 1024;
+    uint8_t response[TEST_COAP_MESSAGE_MAX_LEN];
+    lwm2mcore_HeapStats_t stats;
+    uint8_t block[1024];
+    lwm2m_uri_t uri;
+    uint8_t* certPtr;
+    uint8_t* readPtr;
+    FILE* filePtr;
+    size_t offset;
+    size_t len;
+    size_t totalLen;
+    uint32_t blockNum;
+    uint32_t value;
+    size_t i;
+
+    certPtr = (uint8_t*)malloc(certLen);
+    TEST_ASSERT(certPtr != NULL);
+    for (i = 0; i < certLen; i++)
+    {
+        certPtr[i] = TestStreamByte(i);
+    }
+
+    memset(&uri, 0, sizeof(uri));
+    uri.flag = LWM2M_URI_FLAG_OBJECT_ID | LWM2M_URI_FLAG_INSTANCE_ID | LWM2M_URI_FLAG_RESOURCE_ID;
+    uri.objectId = LWM2MCORE_SSL_CERTIFS_OID;
+    uri.resourceId = LWM2MCORE_SSL_CERTIFICATE_CERTIF;
+
+    /* The server stand-in writes the blocks, with a retransmission and an unexpected block: no
+     * allocation in the core */
+    lwm2mcore_ResetHeapStats();
+    for (blockNum = 0, offset = 0; offset < certLen; blockNum++, offset += len)
+    {
+        bool isLast;
+
+        len = ((certLen - offset) > blockLen) ? blockLen : (certLen - offset);
+        isLast = ((offset + len) == certLen);
+        TEST_ASSERT(lwm2mcore_StreamWrite(&uri, blockNum, blockLen, isLast, certPtr + offset, len)
+                    == (isLast ? COAP_204_CHANGED : COAP_231_CONTINUE));
+
+        if (5 == blockNum)
+        {
+            TEST_ASSERT(lwm2mcore_StreamWrite(&uri,
+                                              blockNum,
+                                              blockLen,
+                                              false,
+                                              certPtr + offset,
+                                              len)
+                        == COAP_231_CONTINUE);
+            TEST_ASSERT(lwm2mcore_StreamWrite(&uri, blockNum + 2, blockLen, false, block, len)
+                        == COAP_408_REQ_ENTITY_INCOMPLETE);
+        }
+    }
+    TEST_ASSERT(lwm2mcore_GetHeapStats(LWM2MCORE_HEAP_TAG_OBJECT_MANAGER, &stats)
+                == LWM2MCORE_ERR_COMPLETED_OK);
+    TEST_ASSERT(stats.allocNb == 0);
+
+    /* The whole certificate is saved */
+    readPtr = (uint8_t*)malloc(certLen);
+    TEST_ASSERT(readPtr != NULL);
+    len = certLen;
+    TEST_ASSERT(lwm2mcore_GetSslCertificate(0, (char*)readPtr, &len, &totalLen)
+                == LWM2MCORE_ERR_COMPLETED_OK);
+    TEST_ASSERT((len == certLen) && (totalLen == certLen));
+    TEST_ASSERT(0 == memcmp(certPtr, readPtr, certLen));
+
+    /* Same transfer of a shorter certificate by Block1 PUT requests of the UDP receive path,
+     * acknowledged before Wakaama with the Block1 option of each request
+     */
+    TestServerCount();
+    for (blockNum = 0, offset = 0; offset < (certLen - 1); blockNum++, offset += len)
+    {
+        size_t responseLen;
+        bool isMore;
+
+        len = ((certLen - 1 - offset) > blockLen) ? blockLen : (certLen - 1 - offset);
+        isMore = ((offset + len) < (certLen - 1));
+        responseLen = TestStreamPutBlock((uint16_t)(0x8000 | blockNum), blockNum, isMore,
+                                         certPtr + offset, len, response, sizeof(response));
+        TEST_ASSERT((responseLen > 6) && (response[0] == 0x62)
+                    && (response[1] == (isMore ? COAP_231_CONTINUE : COAP_204_CHANGED)));
+        TEST_ASSERT((response[2] == (uint8_t)(0x80 | (blockNum >> 8)))
+                    && (response[3] == (uint8_t)blockNum));
+        TEST_ASSERT(TestCoapGetOption(response, responseLen, 27, &value)
+                    && (value == ((blockNum << 4) | (isMore ? 0x08 : 0) | 6)));
+    }
+    len = certLen;
+    TEST_ASSERT(lwm2mcore_GetSslCertificate(0, (char*)readPtr, &len, &totalLen)
+                == LWM2MCORE_ERR_COMPLETED_OK);
+    TEST_ASSERT((len == (certLen - 1)) && (totalLen == (certLen - 1)));
+    TEST_ASSERT(0 == memcmp(certPtr, readPtr, certLen - 1));
+
+    /* Retransmission of the last request: same acknowledgement, the block is not written again */
+    blockNum--;
+    offset -= len;
+    TEST_ASSERT(TestStreamPutBlock((uint16_t)(0x8000 | blockNum), blockNum, false,
+                                   certPtr + offset, len, response, sizeof(response)) > 6);
+    TEST_ASSERT((response[1] == COAP_204_CHANGED) && (response[3] == (uint8_t)blockNum));
+    TEST_ASSERT(TestServerCount() == 0);
+
+    /* Last block sent again in a new request: acknowledged again, not written again */
+    TEST_ASSERT(TestStreamPutBlock(0x80FF, blockNum, false, certPtr + offset, len,
+                                   response, sizeof(response)) > 6);
+    TEST_ASSERT((response[1] == COAP_204_CHANGED) && (response[3] == 0xFF));
+
+    /* Unexpected block of a new transfer */
+    TEST_ASSERT(TestStreamPutBlock(0x8100, 0, true, certPtr, blockLen,
+                                   response, sizeof(response)) > 6);
+    TEST_ASSERT(response[1] == COAP_231_CONTINUE);
+    TEST_ASSERT(TestStreamPutBlock(0x8101, 2, true, certPtr, blockLen,
+                                   response, sizeof(response)) == 6);
+    TEST_ASSERT(response[1] == COAP_408_REQ_ENTITY_INCOMPLETE);
+
+    /* The whole certificate is saved again */
+    for (blockNum = 0, offset = 0; offset < certLen; blockNum++, offset += len)
+    {
+        bool isLast;
+
+        len = ((certLen - offset) > blockLen) ? blockLen : (certLen - offset);
+        isLast = ((offset + len) == certLen);
+        TEST_ASSERT(lwm2mcore_StreamWrite(&uri, blockNum, blockLen, isLast, certPtr + offset, len)
+                    == (isLast ? COAP_204_CHANGED : COAP_231_CONTINUE));
+    }
+
+    /* An interrupted transfer keeps the saved certificate */
+    memset(block, 0, sizeof(block));
+    TEST_ASSERT(lwm2mcore_StreamWrite(&uri, 0, blockLen, false, block, blockLen)
+                == COAP_231_CONTINUE);
+    TEST_ASSERT(lwm2mcore_StreamWrite(&uri, 2, blockLen, false, block, blockLen)
+                == COAP_408_REQ_ENTITY_INCOMPLETE);
+    len = certLen;
+    TEST_ASSERT(lwm2mcore_GetSslCertificate(0, (char*)readPtr, &len, &totalLen)
+                == LWM2MCORE_ERR_COMPLETED_OK);
+    TEST_ASSERT((len == certLen) && (0 == memcmp(certPtr, readPtr, certLen)));
+    free(readPtr);
+    free(certPtr);
+
+    /* Invalid blocks */
+    TEST_ASSERT(lwm2mcore_StreamWrite(&uri, 0, 1000, true, block, 10) == COAP_400_BAD_REQUEST);
+    TEST_ASSERT(lwm2mcore_StreamWrite(&uri, 0, blockLen, false, block, 10)
+                == COAP_400_BAD_REQUEST);
+
+    /* Resources without streamed write handler, unknown object instance */
+    uri.objectId = LWM2MCORE_DEVICE_OID;
+    uri.resourceId = LWM2MCORE_DEVICE_MANUFACTURER_RID;
+    TEST_ASSERT(lwm2mcore_StreamWrite(&uri, 0, blockLen, true, block, 10)
+                == COAP_501_NOT_IMPLEMENTED);
+    uri.objectId = LWM2MCORE_SSL_CERTIFS_OID;
+    uri.instanceId = 1;
+    uri.resourceId = LWM2MCORE_SSL_CERTIFICATE_CERTIF;
+    TEST_ASSERT(lwm2mcore_StreamWrite(&uri, 0, blockLen, true, block, 10) == COAP_404_NOT_FOUND);
+
+    /* Empty certificate: the saved certificate is deleted */
+    uri.instanceId = 0;
+    TEST_ASSERT(lwm2mcore_StreamWrite(&uri, 0, blockLen, true, NULL, 0) == COAP_204_CHANGED);
+    len = sizeof(block);
+    TEST_ASSERT(lwm2mcore_GetSslCertificate(0, (char*)block, &len, &totalLen)
+                == LWM2MCORE_ERR_COMPLETED_OK);
+    TEST_ASSERT((len == 0) && (totalLen == 0));
+
+    /* Firmware package pushed by the server: parsed and stored as the blocks are received */
+    TestGeneratePackage(false);
+    uri.objectId = LWM2MCORE_FIRMWARE_UPDATE_OID;
+    uri.resourceId = LWM2MCORE_FW_UPDATE_PACKAGE_RID;
+    for (blockNum = 0, offset = 0; offset < TestPackage.packageLen; blockNum++, offset += len)
+    {
+        bool isLast;
+
+        len = ((TestPackage.packageLen - offset) > blockLen) ? blockLen
+                                                             : (TestPackage.packageLen - offset);
+        isLast = ((offset + len) == TestPackage.packageLen);
+        TEST_ASSERT(lwm2mcore_StreamWrite(&uri,
+                                          blockNum,
+                                          blockLen,
+                                          isLast,
+                                          TestPackage.packagePtr + offset,
+                                          len)
+                    == (isLast ? COAP_204_CHANGED : COAP_231_CONTINUE));
+    }
+
+    /* The package file contains exactly the binary data */
+    readPtr = (uint8_t*)malloc(TEST_DWL_BINARY_LEN + 1);
+    TEST_ASSERT(NULL != readPtr);
+    filePtr = fopen(TEST_PUSH_PACKAGE_FILE, "rb");
+    TEST_ASSERT(NULL != filePtr);
+    TEST_ASSERT(TEST_DWL_BINARY_LEN == fread(readPtr, 1, TEST_DWL_BINARY_LEN + 1, filePtr));
+    fclose(filePtr);
+    TEST_ASSERT(0 == memcmp(TestPackage.binaryPtr, readPtr, TEST_DWL_BINARY_LEN));
+    free(readPtr);
+    remove(TEST_PUSH_PACKAGE_FILE);
+
+    /* A corrupted package is rejected */
+    memcpy(block, TestPackage.packagePtr, blockLen);
+    block[0] ^= 0xFF;
+    TEST_ASSERT(lwm2mcore_StreamWrite(&uri, 0, blockLen, false, block, blockLen)
+                == COAP_500_INTERNAL_SERVER_ERROR);
+    TEST_ASSERT(NULL == fopen(TEST_PUSH_PACKAGE_FILE, "rb"));
+
+    dwlgen_Free(&TestPackage);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test function for the queue mode scheduler
+ */
+//--------------------------------------------------------------------------------------------------
+static void test_lwm2mcore_QueueMode
+(
+    void
+)
+{
+    lwm2mcore_QueueModeConfig_t config;
+    lwm2mcore_QueueModeStats_t stats;
+    lwm2mcore_SendConfig_t sendConfig;
+    uint8_t request[TEST_COAP_MESSAGE_MAX_LEN];
+
+    memset(&config, 0, sizeof(config));
+    TEST_ASSERT(lwm2mcore_QueueModeConfigure(&config) == LWM2MCORE_ERR_INVALID_ARG);
+    TEST_ASSERT(lwm2mcore_GetQueueModeStats(NULL) == LWM2MCORE_ERR_INVALID_ARG);
+    config.awakeTime = 1;
+    config.maxSleepTime = 1;
+    TEST_ASSERT(lwm2mcore_QueueModeConfigure(&config) == LWM2MCORE_ERR_COMPLETED_OK);
+    lwm2mcore_ResetQueueModeStats();
+
+    /* Not active without the queue mode binding */
+    smanager_QueueSignalRegistration(false);
+    TEST_ASSERT(smanager_QueueGetStepDelay(60) == 60);
+    TEST_ASSERT(smanager_QueueGetDelay(60, true) == 60);
+    TEST_ASSERT(!smanager_QueueIsHolding());
+
+    /* Awake after the registration, until the awake time is elapsed */
+    smanager_QueueSignalRegistration(true);
+    TEST_ASSERT(smanager_QueueGetStepDelay(60) == 1);
+    TEST_ASSERT(smanager_QueueGetDelay(60, true) <= 1);
+    TEST_ASSERT(!smanager_QueueIsSleeping());
+    usleep(1100000);
+
+    /* A transaction is on-going: the device stays awake */
+    TEST_ASSERT(smanager_QueueGetDelay(60, false) == 60);
+    TEST_ASSERT(!smanager_QueueIsSleeping());
+
+    /* Sleep for the maximum sleep time: the Send records are held */
+    TEST_ASSERT(smanager_QueueGetDelay(60, true) == 1);
+    TEST_ASSERT(smanager_QueueIsSleeping());
+    TEST_ASSERT(smanager_QueueIsHolding());
+    TEST_ASSERT(smanager_QueueGetWakeUpDelay() <= 1);
+
+    memset(&sendConfig, 0, sizeof(sendConfig));
+    sendConfig.recordMaxNb = 4;
+    sendConfig.payloadMaxLen = 256;
+    TEST_ASSERT(lwm2mcore_SendConfigure(&sendConfig) == LWM2MCORE_ERR_COMPLETED_OK);
+    TestServerCount();
+    TEST_ASSERT(lwm2mcore_SendRecord(Lwm2mcoreRef, LWM2MCORE_DEVICE_OID, 0,
+                                     LWM2MCORE_DEVICE_BATTERY_LEVEL_RID, 1700000000)
+                == LWM2MCORE_ERR_COMPLETED_OK);
+    TEST_ASSERT(lwm2mcore_SendFlush(Lwm2mcoreRef) == LWM2MCORE_ERR_INVALID_STATE);
+    TEST_ASSERT(TestServerCount() == 0);
+
+    /* Wake-up: the data are held until the Registration Update is acknowledged */
+    usleep(1100000);
+    TEST_ASSERT(smanager_QueueGetWakeUpDelay() == 0);
+    smanager_QueueWakeUp();
+    TEST_ASSERT(!smanager_QueueIsSleeping());
+    TEST_ASSERT(smanager_QueueIsHolding());
+    TEST_ASSERT(!smanager_QueueTakeBurst());
+    TEST_ASSERT(lwm2mcore_SendFlush(Lwm2mcoreRef) == LWM2MCORE_ERR_INVALID_STATE);
+
+    /* The held data are sent in one burst */
+    smanager_QueueSignalRegistration(true);
+    TEST_ASSERT(!smanager_QueueIsHolding());
+    TEST_ASSERT(smanager_QueueTakeBurst());
+    TEST_ASSERT(!smanager_QueueTakeBurst());
+    TEST_ASSERT(lwm2mcore_SendFlush(Lwm2mcoreRef) == LWM2MCORE_ERR_COMPLETED_OK);
+    TEST_ASSERT(TestSendReceive(request, sizeof(request)) > 0);
+    TestSendAck(request, COAP_204_CHANGED);
+    TEST_ASSERT(lwm2mcore_SendConfigure(NULL) == LWM2MCORE_ERR_COMPLETED_OK);
+
+    TEST_ASSERT(lwm2mcore_GetQueueModeStats(&stats) == LWM2MCORE_ERR_COMPLETED_OK);
+    TEST_ASSERT((stats.wakeUpNb == 1) && (stats.burstNb == 1) && (stats.heldNb == 2));
+    TEST_ASSERT((stats.sleepTime >= 1) && (stats.awakeTime >= 1) && (!stats.isSleeping));
+
+    /* Disabled: the data are no more held */
+    TEST_ASSERT(smanager_QueueGetDelay(60, true) == 1);
+    TEST_ASSERT(lwm2mcore_QueueModeConfigure(NULL) == LWM2MCORE_ERR_COMPLETED_OK);
+    TEST_ASSERT(!smanager_QueueIsSleeping());
+    TEST_ASSERT(!smanager_QueueIsHolding());
+    TEST_ASSERT(smanager_QueueGetStepDelay(60) == 60);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test function for the observation of single-instance resources: notification attributes,
+ * minimum and maximum periods
+ */
+//--------------------------------------------------------------------------------------------------
+static void test_lwm2mcore_Observe
+(
+    void
+)
+{
+    uint8_t token[OBSERVE_TOKEN_MAX_LEN] = {0x4F, 0x42, 0};
+    lwm2mcore_ObserveStats_t stats;
+    lwm2m_attributes_t attr;
+    lwm2m_uri_t uri;
+    int i;
+
+    /* The deadlines are checked by the test, not by the session step */
+    lwm2mcore_TimerStop(LWM2MCORE_TIMER_STEP);
+    omanager_ObserveReset();
+    TEST_ASSERT(lwm2mcore_ResourceChanged(NULL, LWM2MCORE_DEVICE_OID, 0,
+                                          LWM2MCORE_DEVICE_CURRENT_TIME_RID)
+                == LWM2MCORE_ERR_INVALID_ARG);
+    TEST_ASSERT(lwm2mcore_GetObserveStats(NULL) == LWM2MCORE_ERR_INVALID_ARG);
+
+    /* No period by default on the Device object */
+    memset(&uri, 0, sizeof(uri));
+    memset(&attr, 0, sizeof(attr));
+    uri.flag = LWM2M_URI_FLAG_OBJECT_ID;
+    uri.objectId = LWM2MCORE_DEVICE_OID;
+    attr.toSet = LWM2M_ATTR_FLAG_MIN_PERIOD | LWM2M_ATTR_FLAG_MAX_PERIOD;
+    TEST_ASSERT(lwm2mcore_WriteAttributes(TEST_SHORT_SERVER_ID, &uri, &attr) == COAP_204_CHANGED);
+
+    /* Invalid attributes */
+    uri.flag |= LWM2M_URI_FLAG_INSTANCE_ID;
+    attr.toSet = LWM2M_ATTR_FLAG_STEP;
+    attr.step = 2;
+    TEST_ASSERT(lwm2mcore_WriteAttributes(TEST_SHORT_SERVER_ID, &uri, &attr)
+                == COAP_400_BAD_REQUEST);
+    uri.flag |= LWM2M_URI_FLAG_RESOURCE_ID;
+    uri.resourceId = LWM2MCORE_DEVICE_CURRENT_TIME_RID;
+    attr.toSet = LWM2M_ATTR_FLAG_MIN_PERIOD | LWM2M_ATTR_FLAG_MAX_PERIOD;
+    attr.minPeriod = 10;
+    attr.maxPeriod = 5;
+    TEST_ASSERT(lwm2mcore_WriteAttributes(TEST_SHORT_SERVER_ID, &uri, &attr)
+                == COAP_400_BAD_REQUEST);
+    attr.toSet = LWM2M_ATTR_FLAG_GREATER_THAN | LWM2M_ATTR_FLAG_LESS_THAN;
+    attr.greaterThan = 10;
+    attr.lessThan = 20;
+    TEST_ASSERT(lwm2mcore_WriteAttributes(TEST_SHORT_SERVER_ID, &uri, &attr)
+                == COAP_400_BAD_REQUEST);
+    attr.toSet = LWM2M_ATTR_FLAG_STEP;
+    attr.toClear = LWM2M_ATTR_FLAG_STEP;
+    TEST_ASSERT(lwm2mcore_WriteAttributes(TEST_SHORT_SERVER_ID, &uri, &attr)
+                == COAP_400_BAD_REQUEST);
+
+    /* Step of 2 seconds on the current time */
+    attr.toClear = 0;
+    TEST_ASSERT(lwm2mcore_WriteAttributes(TEST_SHORT_SERVER_ID, &uri, &attr) == COAP_204_CHANGED);
+
+    /* Only the resources are observed by LwM2MCore */
+    uri.flag = LWM2M_URI_FLAG_OBJECT_ID | LWM2M_URI_FLAG_INSTANCE_ID;
+    TEST_ASSERT(!lwm2mcore_ObserveResource(TEST_SHORT_SERVER_ID, token, 2, &uri,
+                                           LWM2M_CONTENT_TEXT));
+    uri.flag |= LWM2M_URI_FLAG_RESOURCE_ID;
+    TEST_ASSERT(!lwm2mcore_ObserveResource(TEST_SHORT_SERVER_ID, token, 0, &uri,
+                                           LWM2M_CONTENT_TEXT));
+    TEST_ASSERT(lwm2mcore_ObserveResource(TEST_SHORT_SERVER_ID, token, 2, &uri,
+                                          LWM2M_CONTENT_TEXT));
+
+    /* No change and no period: nothing to check */
+    TEST_ASSERT(omanager_ObserveGetDelay() == UINT32_MAX);
+    TestServerCount();
+    omanager_ObserveCheck(Lwm2mcoreRef);
+    TEST_ASSERT(TestServerCount() == 0);
+
+    /* A change lower than the step is filtered */
+    TEST_ASSERT(lwm2mcore_ResourceChanged(Lwm2mcoreRef, LWM2MCORE_DEVICE_OID, 0,
+                                          LWM2MCORE_DEVICE_CURRENT_TIME_RID)
+                == LWM2MCORE_ERR_COMPLETED_OK);
+    TEST_ASSERT(TestServerCount() == 0);
+    usleep(2100000);
+    TEST_ASSERT(lwm2mcore_ResourceChanged(Lwm2mcoreRef, LWM2MCORE_DEVICE_OID, 0,
+                                          LWM2MCORE_DEVICE_CURRENT_TIME_RID)
+                == LWM2MCORE_ERR_COMPLETED_OK);
+    TEST_ASSERT(TestServerCount() == 1);
+
+    /* Minimum period on the object instance: the next change is delayed */
+    uri.flag = LWM2M_URI_FLAG_OBJECT_ID | LWM2M_URI_FLAG_INSTANCE_ID;
+    attr.toSet = LWM2M_ATTR_FLAG_MIN_PERIOD;
+    attr.minPeriod = 60;
+    TEST_ASSERT(lwm2mcore_WriteAttributes(TEST_SHORT_SERVER_ID, &uri, &attr) == COAP_204_CHANGED);
+    uri.flag |= LWM2M_URI_FLAG_RESOURCE_ID;
+    attr.toSet = 0;
+    attr.toClear = LWM2M_ATTR_FLAG_STEP;
+    TEST_ASSERT(lwm2mcore_WriteAttributes(TEST_SHORT_SERVER_ID, &uri, &attr) == COAP_204_CHANGED);
+    usleep(1100000);
+    TEST_ASSERT(lwm2mcore_ResourceChanged(Lwm2mcoreRef, LWM2MCORE_DEVICE_OID, 0,
+                                          LWM2MCORE_DEVICE_CURRENT_TIME_RID)
+                == LWM2MCORE_ERR_COMPLETED_OK);
+    TEST_ASSERT(lwm2mcore_ResourceChanged(Lwm2mcoreRef, LWM2MCORE_DEVICE_OID, 0,
+                                          LWM2MCORE_DEVICE_CURRENT_TIME_RID)
+                == LWM2MCORE_ERR_COMPLETED_OK);
+    TEST_ASSERT(TestServerCount() == 0);
+    TEST_ASSERT((0 < omanager_ObserveGetDelay()) && (60 >= omanager_ObserveGetDelay()));
+    omanager_ObserveCheck(Lwm2mcoreRef);
+    TEST_ASSERT(TestServerCount() == 0);
+
+    /* Minimum period reduced: the delayed notification is sent */
+    uri.flag = LWM2M_URI_FLAG_OBJECT_ID | LWM2M_URI_FLAG_INSTANCE_ID;
+    attr.toSet = LWM2M_ATTR_FLAG_MIN_PERIOD | LWM2M_ATTR_FLAG_MAX_PERIOD;
+    attr.toClear = 0;
+    attr.minPeriod = 1;
+    attr.maxPeriod = 1;
+    TEST_ASSERT(lwm2mcore_WriteAttributes(TEST_SHORT_SERVER_ID, &uri, &attr) == COAP_204_CHANGED);
+    TEST_ASSERT(omanager_ObserveGetDelay() == 0);
+    omanager_ObserveCheck(Lwm2mcoreRef);
+    TEST_ASSERT(TestServerCount() == 1);
+
+    /* Maximum period: notified without change */
+    TEST_ASSERT(1 >= omanager_ObserveGetDelay());
+    usleep(1100000);
+    omanager_ObserveCheck(Lwm2mcoreRef);
+    TEST_ASSERT(TestServerCount() == 1);
+
+    /* The first deadline is checked first */
+    uri.flag |= LWM2M_URI_FLAG_RESOURCE_ID;
+    uri.resourceId = LWM2MCORE_DEVICE_BATTERY_LEVEL_RID;
+    attr.toSet = LWM2M_ATTR_FLAG_MAX_PERIOD;
+    attr.maxPeriod = 30;
+    TEST_ASSERT(lwm2mcore_WriteAttributes(TEST_SHORT_SERVER_ID, &uri, &attr) == COAP_204_CHANGED);
+    token[2] = 1;
+    TEST_ASSERT(lwm2mcore_ObserveResource(TEST_SHORT_SERVER_ID, token, 3, &uri,
+                                          LWM2M_CONTENT_TEXT));
+    TEST_ASSERT(1 >= omanager_ObserveGetDelay());
+    TEST_ASSERT(lwm2mcore_ObserveCancel(TEST_SHORT_SERVER_ID, token, 2));
+    TEST_ASSERT(!lwm2mcore_ObserveCancel(TEST_SHORT_SERVER_ID, token, 2));
+    TEST_ASSERT((1 < omanager_ObserveGetDelay()) && (30 >= omanager_ObserveGetDelay()));
+
+    /* The largest maximum period does not wrap around the deadline */
+    attr.maxPeriod = UINT32_MAX;
+    TEST_ASSERT(lwm2mcore_WriteAttributes(TEST_SHORT_SERVER_ID, &uri, &attr) == COAP_204_CHANGED);
+    TEST_ASSERT(omanager_ObserveGetDelay() > (UINT32_MAX / 2));
+    omanager_ObserveCheck(Lwm2mcoreRef);
+    TEST_ASSERT(TestServerCount() == 0);
+    attr.maxPeriod = 30;
+    TEST_ASSERT(lwm2mcore_WriteAttributes(TEST_SHORT_SERVER_ID, &uri, &attr) == COAP_204_CHANGED);
+
+    /* The observations and the attributes of another server are kept apart */
+    TEST_ASSERT(lwm2mcore_ObserveResource(TEST_SHORT_SERVER_ID + 1, token, 3, &uri,
+                                          LWM2M_CONTENT_TEXT));
+    attr.toSet = LWM2M_ATTR_FLAG_MIN_PERIOD | LWM2M_ATTR_FLAG_MAX_PERIOD;
+    attr.minPeriod = 1;
+    attr.maxPeriod = 1;
+    TEST_ASSERT(lwm2mcore_WriteAttributes(TEST_SHORT_SERVER_ID + 1, &uri, &attr)
+                == COAP_204_CHANGED);
+    TEST_ASSERT(1 >= omanager_ObserveGetDelay());
+    TEST_ASSERT(lwm2mcore_ObserveCancel(TEST_SHORT_SERVER_ID + 1, token, 3));
+    TEST_ASSERT(!lwm2mcore_ObserveCancel(TEST_SHORT_SERVER_ID + 1, token, 3));
+    TEST_ASSERT((1 < omanager_ObserveGetDelay()) && (30 >= omanager_ObserveGetDelay()));
+    attr.toSet = 0;
+    attr.toClear = LWM2M_ATTR_FLAG_MIN_PERIOD | LWM2M_ATTR_FLAG_MAX_PERIOD;
+    TEST_ASSERT(lwm2mcore_WriteAttributes(TEST_SHORT_SERVER_ID + 1, &uri, &attr)
+                == COAP_204_CHANGED);
+
+    /* Maximum number of observations */
+    for (i = 1; i < OBSERVE_MAX_NB; i++)
+    {
+        token[2] = (uint8_t)(i + 1);
+        TEST_ASSERT(lwm2mcore_ObserveResource(TEST_SHORT_SERVER_ID, token, 3, &uri,
+                                              LWM2M_CONTENT_TEXT));
+    }
+    token[2] = (uint8_t)(OBSERVE_MAX_NB + 1);
+    TEST_ASSERT(!lwm2mcore_ObserveResource(TEST_SHORT_SERVER_ID, token, 3, &uri,
+                                           LWM2M_CONTENT_TEXT));
+
+    TEST_ASSERT(lwm2mcore_GetObserveStats(&stats) == LWM2MCORE_ERR_COMPLETED_OK);
+    TEST_ASSERT(stats.observationNb == OBSERVE_MAX_NB);
+    TEST_ASSERT((stats.notifiedNb == 3) && (stats.deferredNb == 1) && (stats.maxPeriodNb == 1));
+    TEST_ASSERT((stats.changedNb == 4) && (1 <= stats.filteredNb));
+
+    omanager_ObserveReset();
+    TEST_ASSERT(omanager_ObserveGetDelay() == UINT32_MAX);
+    TEST_ASSERT(lwm2mcore_GetObserveStats(&stats) == LWM2MCORE_ERR_COMPLETED_OK);
+    TEST_ASSERT(0 == stats.observationNb);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test function for the Observe and Write-Attributes requests received from the LwM2M server
+ * stand-in, and for the notifications sent to it
+ */
+//--------------------------------------------------------------------------------------------------
+static void test_lwm2mcore_ObserveRequests
+(
+    void
+)
+{
+    /* Write-Attributes on /3/0/13: valid, pmax lower than pmin, and unknown attribute */
+    static const uint8_t writeAttributes[] =
+    {
+        0x42, 0x03, 0x10, 0x01, 'W', 'A',
+        0xB1, '3', 0x01, '0', 0x02, '1', '3',
+        0x46, 'p', 'm', 'i', 'n', '=', '1', 0x07, 'p', 'm', 'a', 'x', '=', '6', '0'
+    };
+    static const uint8_t badPeriods[] =
+    {
+        0x42, 0x03, 0x10, 0x02, 'W', 'A',
+        0xB1, '3', 0x01, '0', 0x02, '1', '3',
+        0x47, 'p', 'm', 'i', 'n', '=', '1', '0', 0x06, 'p', 'm', 'a', 'x', '=', '5'
+    };
+    static const uint8_t badAttribute[] =
+    {
+        0x42, 0x03, 0x10, 0x03, 'W', 'A',
+        0xB1, '3', 0x01, '0', 0x02, '1', '3', 0x45, 'f', 'o', 'o', '=', '1'
+    };
+    /* Confirmable Observe request on /3/0/13 */
+    static const uint8_t observe[] =
+    {
+        0x42, 0x01, 0x10, 0x04, 'W', 'A',
+        0x60, 0x51, '3', 0x01, '0', 0x02, '1', '3'
+    };
+    /* Non-confirmable Observe request on /3/0/13, then its deregistration */
+    static const uint8_t observeNon[] =
+    {
+        0x52, 0x01, 0x10, 0x05, 'W', 'B',
+        0x60, 0x51, '3', 0x01, '0', 0x02, '1', '3'
+    };
+    static const uint8_t observeCancel[] =
+    {
+        0x42, 0x01, 0x10, 0x06, 'W', 'B',
+        0x61, 0x01, 0x51, '3', 0x01, '0', 0x02, '1', '3'
+    };
+    /* Observe request on the object instance /3/0, left to Wakaama */
+    static const uint8_t observeInstance[] =
+    {
+        0x42, 0x01, 0x10, 0x07, 'W', 'C',
+        0x60, 0x51, '3', 0x01, '0'
+    };
+    uint8_t response[TEST_COAP_MESSAGE_MAX_LEN];
+    uint8_t reset[4];
+    lwm2mcore_ObserveStats_t stats;
+    uint32_t observeSeq;
+    uint32_t value;
+    size_t len;
+
+    /* The deadlines are checked by the test, not by the session step */
+    lwm2mcore_TimerStop(LWM2MCORE_TIMER_STEP);
+    omanager_ObserveReset();
+    TestServerCount();
+
+    /* Valid attributes: also given to Wakaama, which responds */
+    TestServerRequest(writeAttributes, sizeof(writeAttributes));
+    TEST_ASSERT(TestServerCount() == 0);
+
+    /* Invalid attributes: rejected by LwM2MCore */
+    TestServerRequest(badPeriods, sizeof(badPeriods));
+    len = TestServerReceive(response, sizeof(response));
+    TEST_ASSERT((len == 6) && (response[0] == 0x62) && (response[1] == COAP_400_BAD_REQUEST));
+    TEST_ASSERT((response[2] == 0x10) && (response[3] == 0x02));
+    TestServerRequest(badAttribute, sizeof(badAttribute));
+    len = TestServerReceive(response, sizeof(response));
+    TEST_ASSERT((len == 6) && (response[1] == COAP_400_BAD_REQUEST) && (response[3] == 0x03));
+
+    /* Observation: piggybacked 2.05 response with the Observe option and the token */
+    TestServerRequest(observe, sizeof(observe));
+    len = TestServerReceive(response, sizeof(response));
+    TEST_ASSERT((len > 6) && (response[0] == 0x62) && (response[1] == COAP_205_CONTENT));
+    TEST_ASSERT((response[2] == 0x10) && (response[3] == 0x04));
+    TEST_ASSERT(memcmp(response + 4, "WA", 2) == 0);
+    TEST_ASSERT(TestCoapGetOption(response, len, 6, &observeSeq));
+    TEST_ASSERT(lwm2mcore_GetObserveStats(&stats) == LWM2MCORE_ERR_COMPLETED_OK);
+    TEST_ASSERT(stats.observationNb == 1);
+    TEST_ASSERT((0 < omanager_ObserveGetDelay()) && (60 >= omanager_ObserveGetDelay()));
+
+    /* Notification: new message with the token and a greater Observe option */
+    usleep(1100000);
+    TEST_ASSERT(lwm2mcore_ResourceChanged(Lwm2mcoreRef, LWM2MCORE_DEVICE_OID, 0,
+                                          LWM2MCORE_DEVICE_CURRENT_TIME_RID)
+                == LWM2MCORE_ERR_COMPLETED_OK);
+    len = TestServerReceive(response, sizeof(response));
+    TEST_ASSERT((len > 6) && (response[0] == 0x52) && (response[1] == COAP_205_CONTENT));
+    TEST_ASSERT(memcmp(response + 4, "WA", 2) == 0);
+    TEST_ASSERT(TestCoapGetOption(response, len, 6, &value) && (value > observeSeq));
+
+    /* Reset of the notification: the observation is cancelled */
+    reset[0] = 0x70;
+    reset[1] = 0;
+    reset[2] = response[2];
+    reset[3] = response[3];
+    TestServerRequest(reset, sizeof(reset));
+    TEST_ASSERT(TestServerCount() == 0);
+    TEST_ASSERT(lwm2mcore_GetObserveStats(&stats) == LWM2MCORE_ERR_COMPLETED_OK);
+    TEST_ASSERT(stats.observationNb == 0);
+
+    /* Non-confirmable request: non-confirmable response */
+    TestServerRequest(observeNon, sizeof(observeNon));
+    len = TestServerReceive(response, sizeof(response));
+    TEST_ASSERT((len > 6) && (response[0] == 0x52) && (response[1] == COAP_205_CONTENT));
+    TEST_ASSERT(memcmp(response + 4, "WB", 2) == 0);
+    TEST_ASSERT(TestCoapGetOption(response, len, 6, &value));
+    TEST_ASSERT(lwm2mcore_GetObserveStats(&stats) == LWM2MCORE_ERR_COMPLETED_OK);
+    TEST_ASSERT(stats.observationNb == 1);
+
+    /* Deregistration: answered as a read, without the Observe option */
+    TestServerRequest(observeCancel, sizeof(observeCancel));
+    len = TestServerReceive(response, sizeof(response));
+    TEST_ASSERT((len > 6) && (response[0] == 0x62) && (response[1] == COAP_205_CONTENT));
+    TEST_ASSERT(!TestCoapGetOption(response, len, 6, &value));
+    TEST_ASSERT(lwm2mcore_GetObserveStats(&stats) == LWM2MCORE_ERR_COMPLETED_OK);
+    TEST_ASSERT(stats.observationNb == 0);
+
+    /* Only the resources are observed by LwM2MCore */
+    TestServerRequest(observeInstance, sizeof(observeInstance));
+    TEST_ASSERT(TestServerCount() == 0);
+    TEST_ASSERT(lwm2mcore_GetObserveStats(&stats) == LWM2MCORE_ERR_COMPLETED_OK);
+    TEST_ASSERT(stats.observationNb == 0);
+
+    omanager_ObserveReset();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test function for the Read and Observe requests accepting a SenML content format, received from
+ * the LwM2M server stand-in
+ */
+//--------------------------------------------------------------------------------------------------
+static void test_lwm2mcore_SenmlRequests
+(
+    void
+)
+{
+    /* Read of /3/0/0 accepting SenML-JSON, then without Accept option */
+    static const uint8_t readJson[] =
+    {
+        0x42, 0x01, 0x30, 0x01, 'S', 'J',
+        0xB1, '3', 0x01, '0', 0x01, '0', 0x61, LWM2MCORE_CONTENT_SENML_JSON
+    };
+    static const uint8_t readDefault[] =
+    {
+        0x42, 0x01, 0x30, 0x02, 'S', 'D',
+        0xB1, '3', 0x01, '0', 0x01, '0'
+    };
+    /* Read of the object /3 accepting SenML-CBOR, and of an unknown object */
+    static const uint8_t readCbor[] =
+    {
+        0x42, 0x01, 0x30, 0x03, 'S', 'C',
+        0xB1, '3', 0x61, LWM2MCORE_CONTENT_SENML_CBOR
+    };
+    static const uint8_t readNotFound[] =
+    {
+        0x42, 0x01, 0x30, 0x04, 'S', 'N',
+        0xB5, '6', '5', '0', '0', '0', 0x01, '0', 0x61, LWM2MCORE_CONTENT_SENML_JSON
+    };
+    /* Observation of /3/0/13 accepting SenML-JSON */
+    static const uint8_t observeJson[] =
+    {
+        0x42, 0x01, 0x30, 0x05, 'S', 'O',
+        0x60, 0x51, '3', 0x01, '0', 0x02, '1', '3', 0x61, LWM2MCORE_CONTENT_SENML_JSON
+    };
+    uint8_t response[TEST_COAP_MESSAGE_MAX_LEN];
+    char names[2][SENML_NAME_MAX_LEN];
+    const uint8_t* payloadPtr;
+    lwm2m_data_t* dataPtr;
+    lwm2m_uri_t uri;
+    uint8_t* expectedPtr;
+    uint32_t value;
+    size_t payloadLen;
+    size_t len;
+    int dataNb;
+    int expectedLen;
+
+    lwm2mcore_TimerStop(LWM2MCORE_TIMER_STEP);
+    omanager_ObserveReset();
+    TestServerCount();
+
+    /* The response is the SenML pack of the resource */
+    memset(&uri, 0, sizeof(uri));
+    uri.flag = LWM2M_URI_FLAG_OBJECT_ID | LWM2M_URI_FLAG_INSTANCE_ID | LWM2M_URI_FLAG_RESOURCE_ID;
+    uri.objectId = LWM2MCORE_DEVICE_OID;
+    uri.resourceId = LWM2MCORE_DEVICE_MANUFACTURER_RID;
+    TEST_ASSERT(omanager_ReadUri(&uri, &dataNb, &dataPtr) == COAP_205_CONTENT);
+    expectedLen = lwm2mcore_SenmlSerialize(&uri, (int)dataPtr->value.asChildren.count,
+                                           dataPtr->value.asChildren.array,
+                                           LWM2MCORE_CONTENT_SENML_JSON, &expectedPtr);
+    lwm2m_data_free(dataNb, dataPtr);
+    TEST_ASSERT(expectedLen > 0);
+
+    TestServerRequest(readJson, sizeof(readJson));
+    len = TestServerReceive(response, sizeof(response));
+    TEST_ASSERT((len > 6) && (response[0] == 0x62) && (response[1] == COAP_205_CONTENT));
+    TEST_ASSERT((response[3] == 0x01) && (memcmp(response + 4, "SJ", 2) == 0));
+    TEST_ASSERT(TestCoapGetOption(response, len, 12, &value)
+                && (value == LWM2MCORE_CONTENT_SENML_JSON));
+    payloadLen = TestCoapGetPayload(response, len, &payloadPtr);
+    TEST_ASSERT((payloadLen == (size_t)expectedLen)
+                && (memcmp(payloadPtr, expectedPtr, payloadLen) == 0));
+    lwm2m_free(expectedPtr);
+
+    /* The other content formats are encoded by Wakaama */
+    TestServerRequest(readDefault, sizeof(readDefault));
+    TEST_ASSERT(TestServerCount() == 0);
+
+    /* Object read in SenML-CBOR: one record per resource, in blocks if needed */
+    TestServerRequest(readCbor, sizeof(readCbor));
+    len = TestServerReceive(response, sizeof(response));
+    TEST_ASSERT((len > 6) && (response[1] == COAP_205_CONTENT));
+    TEST_ASSERT(TestCoapGetOption(response, len, 12, &value)
+                && (value == LWM2MCORE_CONTENT_SENML_CBOR));
+    payloadLen = TestCoapGetPayload(response, len, &payloadPtr);
+    TEST_ASSERT(payloadLen > 0);
+    if (!TestCoapGetOption(response, len, 23, &value))
+    {
+        TEST_ASSERT(omanager_SenmlDecodeNames(LWM2MCORE_CONTENT_SENML_CBOR, payloadPtr, payloadLen,
+                                              names, 2) == 2);
+        TEST_ASSERT(strncmp(names[0], "/3/0/", 5) == 0);
+    }
+    else
+    {
+        TEST_ASSERT((value == 0x0E) && (payloadLen == COAP_REQUEST_BLOCK_MAX_LEN));
+    }
+
+    TestServerRequest(readNotFound, sizeof(readNotFound));
+    len = TestServerReceive(response, sizeof(response));
+    TEST_ASSERT((len == 6) && (response[1] == COAP_404_NOT_FOUND));
+
+    /* Observation: the response and the notifications are SenML packs */
+    TestServerRequest(observeJson, sizeof(observeJson));
+    len = TestServerReceive(response, sizeof(response));
+    TEST_ASSERT((len > 6) && (response[1] == COAP_205_CONTENT));
+    TEST_ASSERT(TestCoapGetOption(response, len, 12, &value)
+                && (value == LWM2MCORE_CONTENT_SENML_JSON));
+    usleep(1100000);
+    TEST_ASSERT(lwm2mcore_ResourceChanged(Lwm2mcoreRef, LWM2MCORE_DEVICE_OID, 0,
+                                          LWM2MCORE_DEVICE_CURRENT_TIME_RID)
+                == LWM2MCORE_ERR_COMPLETED_OK);
+    len = TestServerReceive(response, sizeof(response));
+    TEST_ASSERT((len > 6) && (response[0] == 0x52) && (memcmp(response + 4, "SO", 2) == 0));
+    TEST_ASSERT(TestCoapGetOption(response, len, 12, &value)
+                && (value == LWM2MCORE_CONTENT_SENML_JSON));
+    payloadLen = TestCoapGetPayload(response, len, &payloadPtr);
+    TEST_ASSERT(omanager_SenmlDecodeNames(LWM2MCORE_CONTENT_SENML_JSON, payloadPtr, payloadLen,
+                                          names, 2) == 1);
+    TEST_ASSERT(strcmp(names[0], "/3/0/13") == 0);
+
+    omanager_ObserveReset();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test function for the connectivity statistics sampling: ring of samples, aggregation and reads
+ * served from the last sample
+ */
+//--------------------------------------------------------------------------------------------------
+static void test_lwm2mcore_ConnStats
+(
+    void
+)
+{
+    lwm2mcore_ConnStatsConfig_t config;
+    lwm2mcore_ConnStatsAggregate_t aggregate;
+    lwm2mcore_ResourceType_t type;
+    lwm2mcore_Uri_t uri;
+    char buffer[LWM2MCORE_BUFFER_MAX_LEN];
+    size_t len;
+    int i;
+
+    memset(&config, 0, sizeof(config));
+    TEST_ASSERT(lwm2mcore_ConnStatsConfigure(&config) == LWM2MCORE_ERR_INVALID_ARG);
+    TEST_ASSERT(lwm2mcore_GetConnStatsAggregate(LWM2MCORE_CONN_STATS_OID,
+                                                LWM2MCORE_CONN_STATS_TX_DATA_COUNT_RID, NULL)
+                == LWM2MCORE_ERR_INVALID_ARG);
+    TEST_ASSERT(lwm2mcore_GetConnStatsAggregate(LWM2MCORE_CONN_STATS_OID,
+                                                LWM2MCORE_CONN_STATS_START_RID, &aggregate)
+                == LWM2MCORE_ERR_INVALID_ARG);
+    TEST_ASSERT(lwm2mcore_GetConnStatsAggregate(LWM2MCORE_CONN_STATS_OID,
+                                                LWM2MCORE_CONN_STATS_TX_DATA_COUNT_RID, &aggregate)
+                == LWM2MCORE_ERR_INVALID_STATE);
+
+    /* The samples are taken by the test, not by the sampling timer */
+    config.interval = 3600;
+    TEST_ASSERT(lwm2mcore_ConnStatsConfigure(&config) == LWM2MCORE_ERR_COMPLETED_OK);
+    lwm2mcore_TimerStop(LWM2MCORE_TIMER_CONN_STATS);
+    TEST_ASSERT(lwm2mcore_GetConnStatsAggregate(LWM2MCORE_CONN_STATS_OID,
+                                                LWM2MCORE_CONN_STATS_TX_DATA_COUNT_RID, &aggregate)
+                == LWM2MCORE_ERR_INVALID_STATE);
+
+    /* No sample yet: read from the platform */
+    len = sizeof(buffer);
+    TEST_ASSERT(omanager_ReadResource(LWM2MCORE_CONN_STATS_OID, 0,
+                                      LWM2MCORE_CONN_STATS_TX_DATA_COUNT_RID,
+                                      &type, buffer, &len) == COAP_205_CONTENT);
+    TEST_ASSERT(357 == omanager_BytesToInt(buffer, len));
+
+    for (i = 0; i < 3; i++)
+    {
+        omanager_ConnStatsSample();
+    }
+    TEST_ASSERT(lwm2mcore_GetConnStatsAggregate(LWM2MCORE_CONN_STATS_OID,
+                                                LWM2MCORE_CONN_STATS_TX_DATA_COUNT_RID, &aggregate)
+                == LWM2MCORE_ERR_COMPLETED_OK);
+    TEST_ASSERT((aggregate.sampleNb == 3) && (aggregate.min == 357) && (aggregate.max == 357));
+    TEST_ASSERT((aggregate.avg == 357) && (aggregate.last == 357));
+    TEST_ASSERT(lwm2mcore_GetConnStatsAggregate(LWM2MCORE_EXT_CONN_STATS_OID,
+                                                LWM2MCORE_EXT_CONN_STATS_RSRP_RID, &aggregate)
+                == LWM2MCORE_ERR_COMPLETED_OK);
+    TEST_ASSERT((aggregate.min == -116) && (aggregate.max == -116) && (aggregate.avg == -116));
+
+    /* Read from the last sample */
+    len = sizeof(buffer);
+    TEST_ASSERT(omanager_ReadResource(LWM2MCORE_CONN_STATS_OID, 0,
+                                      LWM2MCORE_CONN_STATS_TX_DATA_COUNT_RID,
+                                      &type, buffer, &len) == COAP_205_CONTENT);
+    TEST_ASSERT(357 == omanager_BytesToInt(buffer, len));
+    len = sizeof(buffer);
+    TEST_ASSERT(omanager_ReadResource(LWM2MCORE_EXT_CONN_STATS_OID, 0,
+                                      LWM2MCORE_EXT_CONN_STATS_TAC_RID,
+                                      &type, buffer, &len) == COAP_205_CONTENT);
+    TEST_ASSERT(58506 == omanager_BytesToInt(buffer, len));
+
+    /* The oldest samples are replaced */
+    for (i = 0; i < LWM2MCORE_CONN_STATS_SAMPLE_MAX_NB; i++)
+    {
+        omanager_ConnStatsSample();
+    }
+    TEST_ASSERT(lwm2mcore_GetConnStatsAggregate(LWM2MCORE_CONN_STATS_OID,
+                                                LWM2MCORE_CONN_STATS_RX_SMS_COUNT_RID, &aggregate)
+                == LWM2MCORE_ERR_COMPLETED_OK);
+    TEST_ASSERT(aggregate.sampleNb == LWM2MCORE_CONN_STATS_SAMPLE_MAX_NB);
+    TEST_ASSERT(aggregate.avg == 12);
+
+    /* The samples are discarded when the counters are reset */
+    memset(&uri, 0, sizeof(uri));
+    uri.op = LWM2MCORE_OP_EXECUTE;
+    uri.oid = LWM2MCORE_CONN_STATS_OID;
+    uri.rid = LWM2MCORE_CONN_STATS_START_RID;
+    TEST_ASSERT(omanager_ExecConnectivityStatistics(&uri, NULL, 0) == LWM2MCORE_ERR_COMPLETED_OK);
+    TEST_ASSERT(lwm2mcore_GetConnStatsAggregate(LWM2MCORE_CONN_STATS_OID,
+                                                LWM2MCORE_CONN_STATS_RX_SMS_COUNT_RID, &aggregate)
+                == LWM2MCORE_ERR_INVALID_STATE);
+
+    /* Disabled: no more sample */
+    TEST_ASSERT(lwm2mcore_ConnStatsConfigure(NULL) == LWM2MCORE_ERR_COMPLETED_OK);
+    omanager_ConnStatsSample();
+    TEST_ASSERT(lwm2mcore_GetConnStatsAggregate(LWM2MCORE_CONN_STATS_OID,
+                                                LWM2MCORE_CONN_STATS_RX_SMS_COUNT_RID, &aggregate)
+                == LWM2MCORE_ERR_INVALID_STATE);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fill a parameter value of the parameter store test: the value starts with its sequence number
+ * and its length depends on it
+ *
+ * @return
+ *  - Value length
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t TestFillParamValue
+(
+    uint8_t* bufPtr,    ///< [OUT] Value buffer (at least 4096 bytes)
+    uint32_t seq        ///< [IN] Sequence number
+)
+{
+    size_t len = 16 + ((seq * 37) % 4000);
+    size_t i;
+
+    memcpy(bufPtr, &seq, sizeof(seq));
+    for (i = sizeof(seq); i < len; i++)
+    {
+        bufPtr[i] = (uint8_t)(seq + i);
+    }
+
+    return len;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check a parameter value of the parameter store test
+ *
+ * @return
+ *  - Sequence number of the value
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t TestCheckParamValue
+(
+    lwm2mcore_Param_t paramId   ///< [IN] Parameter Id
+)
+{
+    uint8_t value[4096];
+    uint8_t expected[4096];
+    size_t len = sizeof(value);
+    uint32_t seq;
+
+    TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == lwm2mcore_GetParam(paramId, value, &len));
+    TEST_ASSERT(sizeof(seq) <= len);
+    memcpy(&seq, value, sizeof(seq));
+    TEST_ASSERT(len == TestFillParamValue(expected, seq));
+    TEST_ASSERT(0 == memcmp(value, expected, len));
+
+    return seq;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test function for the Linux parameter store: parameter updates and deletions, reload of the
+ * store, interrupted records, compaction, and consistency after a process killed while writing
+ */
+//--------------------------------------------------------------------------------------------------
+static void test_ParamStore
+(
+    void
+)
+{
+    uint8_t value[4096];
+    size_t len;
+    ParamStoreStats_t stats;
+    FILE* filePtr;
+    uint32_t seq;
+    int i;
+
+    remove(TEST_PARAM_STORE_FILE);
+    TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == ParamStoreOpen(TEST_PARAM_STORE_FILE));
+
+    // Invalid arguments
+    len = sizeof(value);
+    TEST_ASSERT(LWM2MCORE_ERR_INVALID_ARG == lwm2mcore_SetParam(LWM2MCORE_MAX_PARAM, value, 1));
+    TEST_ASSERT(LWM2MCORE_ERR_INVALID_ARG == lwm2mcore_SetParam(LWM2MCORE_BOOTSTRAP_PARAM,
+                                                                NULL,
+                                                                1));
+    TEST_ASSERT(LWM2MCORE_ERR_INVALID_ARG == lwm2mcore_GetParam(LWM2MCORE_MAX_PARAM, value, &len));
+    TEST_ASSERT(LWM2MCORE_ERR_INVALID_ARG == lwm2mcore_DeleteParam(LWM2MCORE_MAX_PARAM));
+
+    // Update, read and delete
+    TEST_ASSERT(LWM2MCORE_ERR_GENERAL_ERROR == lwm2mcore_GetParam(LWM2MCORE_BOOTSTRAP_PARAM,
+                                                                  value,
+                                                                  &len));
+    TEST_ASSERT(0 == len);
+    len = TestFillParamValue(value, 1);
+    TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == lwm2mcore_SetParam(LWM2MCORE_BOOTSTRAP_PARAM,
+                                                                 value,
+                                                                 len));
+    len = TestFillParamValue(value, 2);
+    TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == lwm2mcore_SetParam(LWM2MCORE_DWL_WORKSPACE_PARAM,
+                                                                 value,
+                                                                 len));
+    TEST_ASSERT(1 == TestCheckParamValue(LWM2MCORE_BOOTSTRAP_PARAM));
+    TEST_ASSERT(2 == TestCheckParamValue(LWM2MCORE_DWL_WORKSPACE_PARAM));
+    len = 8;
+    TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == lwm2mcore_GetParam(LWM2MCORE_BOOTSTRAP_PARAM,
+                                                                 value,
+                                                                 &len));
+    TEST_ASSERT(8 == len);
+    TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == lwm2mcore_DeleteParam(LWM2MCORE_DWL_WORKSPACE_PARAM));
+    TEST_ASSERT(LWM2MCORE_ERR_GENERAL_ERROR == lwm2mcore_DeleteParam(LWM2MCORE_DWL_WORKSPACE_PARAM));
+    len = sizeof(value);
+    TEST_ASSERT(LWM2MCORE_ERR_GENERAL_ERROR == lwm2mcore_GetParam(LWM2MCORE_DWL_WORKSPACE_PARAM,
+                                                                  value,
+                                                                  &len));
+
+    // Reload
+    TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == ParamStoreOpen(TEST_PARAM_STORE_FILE));
+    TEST_ASSERT(1 == TestCheckParamValue(LWM2MCORE_BOOTSTRAP_PARAM));
+    len = sizeof(value);
+    TEST_ASSERT(LWM2MCORE_ERR_GENERAL_ERROR == lwm2mcore_GetParam(LWM2MCORE_DWL_WORKSPACE_PARAM,
+                                                                  value,
+                                                                  &len));
+
+    // Interrupted record: the previous value is kept
+    len = TestFillParamValue(value, 3);
+    TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == lwm2mcore_SetParam(LWM2MCORE_BOOTSTRAP_PARAM,
+                                                                 value,
+                                                                 len));
+    ParamStoreGetStats(&stats);
+    ParamStoreClose();
+    TEST_ASSERT(0 == truncate(TEST_PARAM_STORE_FILE, (off_t)(stats.fileLen - 1)));
+    TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == ParamStoreOpen(TEST_PARAM_STORE_FILE));
+    TEST_ASSERT(1 == TestCheckParamValue(LWM2MCORE_BOOTSTRAP_PARAM));
+    ParamStoreGetStats(&stats);
+    TEST_ASSERT(0 != stats.discardedLen);
+
+    // Garbage at the end of the file
+    ParamStoreClose();
+    filePtr = fopen(TEST_PARAM_STORE_FILE, "ab");
+    TEST_ASSERT(NULL != filePtr);
+    TEST_ASSERT(sizeof(value) == fwrite(value, 1, sizeof(value), filePtr));
+    fclose(filePtr);
+    TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == ParamStoreOpen(TEST_PARAM_STORE_FILE));
+    TEST_ASSERT(1 == TestCheckParamValue(LWM2MCORE_BOOTSTRAP_PARAM));
+    ParamStoreGetStats(&stats);
+    TEST_ASSERT(sizeof(value) == stats.discardedLen);
+
+    // Compaction
+    seq = 10;
+    while (!ParamStoreIsCompactionNeeded())
+    {
+        len = TestFillParamValue(value, seq++);
+        TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == lwm2mcore_SetParam(LWM2MCORE_DWL_WORKSPACE_PARAM,
+                                                                     value,
+                                                                     len));
+    }
+    TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == ParamStoreCompact());
+    ParamStoreGetStats(&stats);
+    TEST_ASSERT(0 == stats.deadLen);
+    TEST_ASSERT(1 == stats.compactionNb);
+    TEST_ASSERT(1 == TestCheckParamValue(LWM2MCORE_BOOTSTRAP_PARAM));
+    TEST_ASSERT((seq - 1) == TestCheckParamValue(LWM2MCORE_DWL_WORKSPACE_PARAM));
+    TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == ParamStoreOpen(TEST_PARAM_STORE_FILE));
+    TEST_ASSERT(1 == TestCheckParamValue(LWM2MCORE_BOOTSTRAP_PARAM));
+    TEST_ASSERT((seq - 1) == TestCheckParamValue(LWM2MCORE_DWL_WORKSPACE_PARAM));
+    ParamStoreClose();
+
+    // Process killed while updating a parameter: the last committed value or the one being
+    // written is read after the reload
+    srand(1);
+    for (i = 0; i < TEST_PARAM_STORE_CRASHES; i++)
+    {
+        uint32_t ackSeq = 0;
+        uint32_t killSeq = 50 + (uint32_t)(rand() % 400);
+        int pipeFds[2];
+        pid_t pid;
+
+        TEST_ASSERT(0 == pipe(pipeFds));
+        pid = fork();
+        TEST_ASSERT(0 <= pid);
+        if (0 == pid)
+        {
+            close(pipeFds[0]);
+            if (LWM2MCORE_ERR_COMPLETED_OK != ParamStoreOpen(TEST_PARAM_STORE_FILE))
+            {
+                _exit(EXIT_FAILURE);
+            }
+            for (seq = TestCheckParamValue(LWM2MCORE_DWL_WORKSPACE_PARAM) + 1; ; seq++)
+            {
+                len = TestFillParamValue(value, seq);
+                if (   (LWM2MCORE_ERR_COMPLETED_OK != lwm2mcore_SetParam(
+                                                                LWM2MCORE_DWL_WORKSPACE_PARAM,
+                                                                value,
+                                                                len))
+                    || (sizeof(seq) != write(pipeFds[1], &seq, sizeof(seq)))
+                   )
+                {
+                    _exit(EXIT_FAILURE);
+                }
+            }
+        }
+
+        close(pipeFds[1]);
+        while ((ackSeq < killSeq) && (sizeof(seq) == read(pipeFds[0], &seq, sizeof(seq))))
+        {
+            ackSeq = seq;
+        }
+        usleep((useconds_t)(rand() % 500));
+        kill(pid, SIGKILL);
+        waitpid(pid, NULL, 0);
+        while (sizeof(seq) == read(pipeFds[0], &seq, sizeof(seq)))
+        {
+            ackSeq = seq;
+        }
+        close(pipeFds[0]);
+
+        TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == ParamStoreOpen(TEST_PARAM_STORE_FILE));
+        seq = TestCheckParamValue(LWM2MCORE_DWL_WORKSPACE_PARAM);
+        TEST_ASSERT((seq == ackSeq) || (seq == (ackSeq + 1)));
+        TEST_ASSERT(1 == TestCheckParamValue(LWM2MCORE_BOOTSTRAP_PARAM));
+        ParamStoreClose();
+    }
+
+    remove(TEST_PARAM_STORE_FILE);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test function for the parameter cache: cached reads, skipped unchanged writes, deferred writes
+ * and flush, partial reads
+ */
+//--------------------------------------------------------------------------------------------------
+static void test_omanager_ParamCache
+(
+    void
+)
+{
+    omanager_ParamCacheStats_t cacheStats;
+    ParamStoreStats_t storeStats;
+    uint8_t value[4096];
+    uint8_t expected[4096];
+    uint32_t recordNb;
+    uint32_t hitNb;
+    uint32_t bsInfoSize;
+    size_t len;
+
+    omanager_ClearParamCache();
+    remove(TEST_PARAM_STORE_FILE);
+    TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == ParamStoreOpen(TEST_PARAM_STORE_FILE));
+    ParamStoreGetStats(&storeStats);
+    recordNb = storeStats.recordNb;
+
+    // Write-through and unchanged writes
+    len = TestFillParamValue(expected, 1);
+    TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == omanager_SetParam(LWM2MCORE_BOOTSTRAP_PARAM,
+                                                                expected,
+                                                                len,
+                                                                false));
+    TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == omanager_SetParam(LWM2MCORE_BOOTSTRAP_PARAM,
+                                                                expected,
+                                                                len,
+                                                                false));
+    TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == omanager_SetParam(LWM2MCORE_BOOTSTRAP_PARAM,
+                                                                expected,
+                                                                len,
+                                                                true));
+    ParamStoreGetStats(&storeStats);
+    TEST_ASSERT((recordNb + 1) == storeStats.recordNb);
+    TEST_ASSERT(1 == TestCheckParamValue(LWM2MCORE_BOOTSTRAP_PARAM));
+
+    // Cached reads
+    omanager_GetParamCacheStats(&cacheStats);
+    hitNb = cacheStats.readHitNb;
+    len = sizeof(value);
+    TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == omanager_GetParam(LWM2MCORE_BOOTSTRAP_PARAM,
+                                                                value,
+                                                                &len));
+    TEST_ASSERT(len == TestFillParamValue(expected, 1));
+    TEST_ASSERT(0 == memcmp(value, expected, len));
+    omanager_GetParamCacheStats(&cacheStats);
+    TEST_ASSERT((hitNb + 1) == cacheStats.readHitNb);
+
+    // Deferred writes: only done by the flush
+    len = TestFillParamValue(expected, 2);
+    TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == omanager_SetParam(LWM2MCORE_BOOTSTRAP_PARAM,
+                                                                expected,
+                                                                len,
+                                                                true));
+    bsInfoSize = (uint32_t)len;
+    TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == omanager_SetParam(
+                                                            LWM2MCORE_BOOTSTRAP_INFO_SIZE_PARAM,
+                                                            (uint8_t*)&bsInfoSize,
+                                                            sizeof(bsInfoSize),
+                                                            true));
+    ParamStoreGetStats(&storeStats);
+    TEST_ASSERT((recordNb + 1) == storeStats.recordNb);
+    TEST_ASSERT(1 == TestCheckParamValue(LWM2MCORE_BOOTSTRAP_PARAM));
+    len = sizeof(value);
+    TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == omanager_GetParam(LWM2MCORE_BOOTSTRAP_PARAM,
+                                                                value,
+                                                                &len));
+    TEST_ASSERT(0 == memcmp(value, expected, len));
+
+    TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == omanager_FlushParams());
+    ParamStoreGetStats(&storeStats);
+    TEST_ASSERT((recordNb + 3) == storeStats.recordNb);
+    TEST_ASSERT(2 == TestCheckParamValue(LWM2MCORE_BOOTSTRAP_PARAM));
+    TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == omanager_FlushParams());
+    ParamStoreGetStats(&storeStats);
+    TEST_ASSERT((recordNb + 3) == storeStats.recordNb);
+
+    // Partial reads: a longer read is done in platform memory
+    omanager_ClearParamCache();
+    omanager_GetParamCacheStats(&cacheStats);
+    hitNb = cacheStats.readHitNb;
+    len = 8;
+    TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == omanager_GetParam(LWM2MCORE_BOOTSTRAP_PARAM,
+                                                                value,
+                                                                &len));
+    TEST_ASSERT(8 == len);
+    len = 8;
+    TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == omanager_GetParam(LWM2MCORE_BOOTSTRAP_PARAM,
+                                                                value,
+                                                                &len));
+    omanager_GetParamCacheStats(&cacheStats);
+    TEST_ASSERT((hitNb + 1) == cacheStats.readHitNb);
+    len = sizeof(value);
+    TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == omanager_GetParam(LWM2MCORE_BOOTSTRAP_PARAM,
+                                                                value,
+                                                                &len));
+    TEST_ASSERT(len == bsInfoSize);
+    TEST_ASSERT(0 == memcmp(value, expected, len));
+    omanager_GetParamCacheStats(&cacheStats);
+    TEST_ASSERT((hitNb + 1) == cacheStats.readHitNb);
+
+    // Deletion
+    TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == omanager_DeleteParam(LWM2MCORE_BOOTSTRAP_PARAM));
+    len = sizeof(value);
+    TEST_ASSERT(LWM2MCORE_ERR_GENERAL_ERROR == omanager_GetParam(LWM2MCORE_BOOTSTRAP_PARAM,
+                                                                 value,
+                                                                 &len));
+    TEST_ASSERT(0 == len);
+
+    omanager_ClearParamCache();
+    ParamStoreClose();
+    remove(TEST_PARAM_STORE_FILE);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Verify the signature of the test package with the SHA1 APIs, the digest being computed on the
+ * signed data in several chunks
+ *
+ * @return
+ *  - lwm2mcore_EndSha1 result
+ */
+//--------------------------------------------------------------------------------------------------
+static lwm2mcore_Sid_t TestVerifyPackage
+(
+    void
+)
+{
+    size_t signedLen = TestPackage.packageLen - TEST_DWL_PROLOG_LEN - TestPackage.signatureLen;
+    size_t offset;
+    void* sha1CtxPtr = NULL;
+    lwm2mcore_Sid_t sid;
+
+    TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == lwm2mcore_StartSha1(LWM2MCORE_PKG_FW, &sha1CtxPtr));
+    for (offset = 0; offset < signedLen; offset += TEST_DWL_CHUNK_LEN)
+    {
+        size_t len = signedLen - offset;
+
+        if (len > TEST_DWL_CHUNK_LEN)
+        {
+            len = TEST_DWL_CHUNK_LEN;
+        }
+        TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == lwm2mcore_ProcessSha1(sha1CtxPtr,
+                                                            TestPackage.packagePtr + offset,
+                                                            len));
+    }
+
+    sid = lwm2mcore_EndSha1(sha1CtxPtr,
+                            LWM2MCORE_PKG_FW,
+                            TestPackage.packagePtr + TestPackage.packageLen
+                            - TestPackage.signatureLen,
+                            TestPackage.signatureLen);
+    TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == lwm2mcore_CancelSha1(&sha1CtxPtr));
+
+    return sid;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test function for the package signature verification: RSA-PSS, ECDSA P-256 and Ed25519
+ * signatures, tampered signature, cached public key replaced by lwm2mcore_SetCredential
+ */
+//--------------------------------------------------------------------------------------------------
+static void test_lwm2mcore_EndSha1
+(
+    void
+)
+{
+    dwlgen_SignatureType_t signatureTypes[] = {DWLGEN_SIGN_RSA_PSS_SHA1,
+                                               DWLGEN_SIGN_ECDSA_P256_SHA256,
+                                               DWLGEN_SIGN_ED25519_SHA256};
+    dwlgen_Package_t otherPackage;
+    dwlgen_Config_t config;
+    size_t i;
+
+    memset(&config, 0, sizeof(config));
+    config.binaryLen = TEST_DWL_SIGN_BINARY_LEN;
+    config.seed = 1;
+
+    for (i = 0; i < sizeof(signatureTypes) / sizeof(signatureTypes[0]); i++)
+    {
+        config.signatureType = signatureTypes[i];
+        TEST_ASSERT(dwlgen_Build(&config, &otherPackage));
+        TEST_ASSERT(dwlgen_Build(&config, &TestPackage));
+        TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == lwm2mcore_SetCredential(
+                                                                LWM2MCORE_CREDENTIAL_FW_KEY,
+                                                                LWM2MCORE_BS_SERVER_ID,
+                                                                (char*)TestPackage.publicKey,
+                                                                TestPackage.publicKeyLen));
+
+        // The second verification uses the cached public key
+        TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == TestVerifyPackage());
+        TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == TestVerifyPackage());
+
+        // Tampered signature
+        TestPackage.packagePtr[TestPackage.packageLen - 1] ^= 0x01;
+        TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK != TestVerifyPackage());
+        TestPackage.packagePtr[TestPackage.packageLen - 1] ^= 0x01;
+
+        // Public key of another package: the cached key is replaced
+        TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == lwm2mcore_SetCredential(
+                                                                LWM2MCORE_CREDENTIAL_FW_KEY,
+                                                                LWM2MCORE_BS_SERVER_ID,
+                                                                (char*)otherPackage.publicKey,
+                                                                otherPackage.publicKeyLen));
+        TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK != TestVerifyPackage());
+
+        dwlgen_Free(&otherPackage);
+        dwlgen_Free(&TestPackage);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test function for the digest state serialization: digest restored from its serialized state,
+ * concurrent digest contexts, invalid serialized state
+ */
+//--------------------------------------------------------------------------------------------------
+static void test_lwm2mcore_CopySha1
+(
+    void
+)
+{
+    dwlgen_SignatureType_t signatureTypes[] = {DWLGEN_SIGN_RSA_PSS_SHA1,
+                                               DWLGEN_SIGN_ED25519_SHA256};
+    uint8_t hashState[LWM2MCORE_HASH_STATE_MAX_LEN];
+    dwlgen_Config_t config;
+    uint8_t* signaturePtr;
+    size_t signedLen;
+    size_t splitLen;
+    size_t i;
+
+    memset(&config, 0, sizeof(config));
+    config.binaryLen = TEST_DWL_SIGN_BINARY_LEN;
+    config.seed = 1;
+
+    for (i = 0; i < sizeof(signatureTypes) / sizeof(signatureTypes[0]); i++)
+    {
+        void* savedCtxPtr = NULL;
+        void* fullCtxPtr = NULL;
+        void* restoredCtxPtr = NULL;
+
+        config.signatureType = signatureTypes[i];
+        TEST_ASSERT(dwlgen_Build(&config, &TestPackage));
+        TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == lwm2mcore_SetCredential(
+                                                                LWM2MCORE_CREDENTIAL_FW_KEY,
+                                                                LWM2MCORE_BS_SERVER_ID,
+                                                                (char*)TestPackage.publicKey,
+                                                                TestPackage.publicKeyLen));
+        signedLen = TestPackage.packageLen - TEST_DWL_PROLOG_LEN - TestPackage.signatureLen;
+        signaturePtr = TestPackage.packagePtr + signedLen + TEST_DWL_PROLOG_LEN;
+
+        // Split point not aligned on the digest block length
+        splitLen = signedLen / 2 + 17;
+
+        // Two digests computed at the same time, one of them is saved after the split point
+        TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == lwm2mcore_StartSha1(LWM2MCORE_PKG_FW,
+                                                                      &savedCtxPtr));
+        TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == lwm2mcore_StartSha1(LWM2MCORE_PKG_FW,
+                                                                      &fullCtxPtr));
+        TEST_ASSERT(savedCtxPtr != fullCtxPtr);
+        TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == lwm2mcore_ProcessSha1(savedCtxPtr,
+                                                                        TestPackage.packagePtr,
+                                                                        splitLen));
+        TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == lwm2mcore_ProcessSha1(fullCtxPtr,
+                                                                        TestPackage.packagePtr,
+                                                                        signedLen));
+        TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == lwm2mcore_CopySha1(savedCtxPtr,
+                                                                     hashState,
+                                                                     sizeof(hashState)));
+        TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == lwm2mcore_CancelSha1(&savedCtxPtr));
+        TEST_ASSERT(NULL == savedCtxPtr);
+
+        // Digest resumed from the serialized state
+        TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == lwm2mcore_RestoreSha1(hashState,
+                                                                        sizeof(hashState),
+                                                                        &restoredCtxPtr));
+        TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == lwm2mcore_ProcessSha1(
+                                                                restoredCtxPtr,
+                                                                TestPackage.packagePtr + splitLen,
+                                                                signedLen - splitLen));
+        TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == lwm2mcore_EndSha1(restoredCtxPtr,
+                                                                    LWM2MCORE_PKG_FW,
+                                                                    signaturePtr,
+                                                                    TestPackage.signatureLen));
+        TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == lwm2mcore_EndSha1(fullCtxPtr,
+                                                                    LWM2MCORE_PKG_FW,
+                                                                    signaturePtr,
+                                                                    TestPackage.signatureLen));
+
+        // Invalid serialized states
+        TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK != lwm2mcore_RestoreSha1(hashState,
+                                                                        8,
+                                                                        &restoredCtxPtr));
+        hashState[0] = 0xFF;
+        TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK != lwm2mcore_RestoreSha1(hashState,
+                                                                        sizeof(hashState),
+                                                                        &restoredCtxPtr));
+
+        TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == lwm2mcore_CancelSha1(&restoredCtxPtr));
+        TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == lwm2mcore_CancelSha1(&fullCtxPtr));
+        dwlgen_Free(&TestPackage);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test function for the credential cache: decoded PSK, invalidation by lwm2mcore_SetCredential and
+ * lwm2mcore_DeleteCredential, servers sharing a cache slot
+ */
+//--------------------------------------------------------------------------------------------------
+static void test_lwm2mcore_GetCredential
+(
+    void
+)
+{
+    const char address[] = "coaps://test.server:5684";
+    uint8_t psk1[] = {0x01, 0xAB, 0x5C, 0xFF};
+    uint8_t psk2[] = {0x10, 0x20, 0x30, 0x40, 0x50, 0x60, 0x70, 0x80};
+    char buffer[LWM2MCORE_SERVERADDR_LEN];
+    size_t len;
+    int i;
+
+    rename(TEST_CLIENT_CONFIG_FILE, TEST_CLIENT_CONFIG_BACKUP);
+
+    TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == lwm2mcore_SetCredential(
+                                                                LWM2MCORE_CREDENTIAL_DM_ADDRESS,
+                                                                1,
+                                                                (char*)address,
+                                                                strlen(address)));
+    TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == lwm2mcore_SetCredential(
+                                                                LWM2MCORE_CREDENTIAL_DM_SECRET_KEY,
+                                                                1,
+                                                                (char*)psk1,
+                                                                sizeof(psk1)));
+
+    // Decoded once, then read from the cache
+    for (i = 0; i < 2; i++)
+    {
+        len = sizeof(buffer);
+        TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == lwm2mcore_GetCredential(
+                                                                LWM2MCORE_CREDENTIAL_DM_SECRET_KEY,
+                                                                1,
+                                                                buffer,
+                                                                &len));
+        TEST_ASSERT(sizeof(psk1) == len);
+        TEST_ASSERT(0 == memcmp(buffer, psk1, len));
+
+        len = sizeof(buffer);
+        TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == lwm2mcore_GetCredential(
+                                                                LWM2MCORE_CREDENTIAL_DM_ADDRESS,
+                                                                1,
+                                                                buffer,
+                                                                &len));
+        TEST_ASSERT(strlen(address) == len);
+        TEST_ASSERT(0 == strcmp(buffer, address));
+    }
+
+    len = sizeof(psk1) - 1;
+    TEST_ASSERT(LWM2MCORE_ERR_OVERFLOW == lwm2mcore_GetCredential(
+                                                                LWM2MCORE_CREDENTIAL_DM_SECRET_KEY,
+                                                                1,
+                                                                buffer,
+                                                                &len));
+
+    // Unknown server sharing the cache slot of the configured one
+    len = sizeof(buffer);
+    TEST_ASSERT(LWM2MCORE_ERR_GENERAL_ERROR == lwm2mcore_GetCredential(
+                                                                LWM2MCORE_CREDENTIAL_DM_SECRET_KEY,
+                                                                5,
+                                                                buffer,
+                                                                &len));
+    len = sizeof(buffer);
+    TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == lwm2mcore_GetCredential(
+                                                                LWM2MCORE_CREDENTIAL_DM_SECRET_KEY,
+                                                                1,
+                                                                buffer,
+                                                                &len));
+    TEST_ASSERT(0 == memcmp(buffer, psk1, len));
+
+    // Updated credential
+    TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == lwm2mcore_SetCredential(
+                                                                LWM2MCORE_CREDENTIAL_DM_SECRET_KEY,
+                                                                1,
+                                                                (char*)psk2,
+                                                                sizeof(psk2)));
+    len = sizeof(buffer);
+    TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == lwm2mcore_GetCredential(
+                                                                LWM2MCORE_CREDENTIAL_DM_SECRET_KEY,
+                                                                1,
+                                                                buffer,
+                                                                &len));
+    TEST_ASSERT(sizeof(psk2) == len);
+    TEST_ASSERT(0 == memcmp(buffer, psk2, len));
+
+    // Deleted credential
+    TEST_ASSERT(lwm2mcore_DeleteCredential(LWM2MCORE_CREDENTIAL_DM_ADDRESS, 1));
+    len = sizeof(buffer);
+    TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == lwm2mcore_GetCredential(
+                                                                LWM2MCORE_CREDENTIAL_DM_ADDRESS,
+                                                                1,
+                                                                buffer,
+                                                                &len));
+    TEST_ASSERT(0 == len);
+
+    ClientConfigFree();
+    remove(TEST_CLIENT_CONFIG_FILE);
+    rename(TEST_CLIENT_CONFIG_BACKUP, TEST_CLIENT_CONFIG_FILE);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test function for the bootstrap configuration: conversion of a version 2 configuration, reload
+ * of the converted configuration, high instance Ids, corrupted configuration
+ */
+//--------------------------------------------------------------------------------------------------
+static void test_omanager_GetBootstrapConfiguration
+(
+    void
+)
+{
+    ConfigSecurityToStore_t security;
+    ConfigServerToStore_t server;
+    lwm2mcore_Uri_t uri;
+    uint8_t rawData[4096];
+    char buffer[8];
+    size_t len = 0;
+    uint32_t value;
+    uint16_t securityObjectNumber = TEST_BS_SECURITY_NB + 1;
+    uint16_t serverObjectNumber = 2;
+    uint16_t i;
+
+    omanager_ClearParamCache();
+    remove(TEST_PARAM_STORE_FILE);
+    TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == ParamStoreOpen(TEST_PARAM_STORE_FILE));
+
+    // Version 2 configuration: raw structures, the last security instance being a duplicate
+    value = 2;
+    memcpy(rawData + len, &value, sizeof(value));
+    len += sizeof(value);
+    memcpy(rawData + len, &securityObjectNumber, sizeof(securityObjectNumber));
+    len += sizeof(securityObjectNumber);
+    memcpy(rawData + len, &serverObjectNumber, sizeof(serverObjectNumber));
+    len += sizeof(serverObjectNumber);
+    for (i = 0; i < securityObjectNumber; i++)
+    {
+        memset(&security, 0, sizeof(security));
+        security.securityObjectInstanceId = i;
+        if ((TEST_BS_SECURITY_NB - 2) == i)
+        {
+            security.securityObjectInstanceId = 100;
+        }
+        else if ((TEST_BS_SECURITY_NB - 1) == i)
+        {
+            security.securityObjectInstanceId = TEST_BS_SECURITY_HIGH_ID;
+        }
+        else if (TEST_BS_SECURITY_NB == i)
+        {
+            security.securityObjectInstanceId = 0;
+        }
+        security.isBootstrapServer = (0 == i);
+        security.securityMode = SEC_PSK;
+        security.serverId = i;
+        security.clientHoldOffTime = 5;
+        memcpy(rawData + len, &security, sizeof(security));
+        len += sizeof(security);
+    }
+    for (i = 0; i < serverObjectNumber; i++)
+    {
+        memset(&server, 0, sizeof(server));
+        server.serverObjectInstanceId = i ? TEST_BS_SERVER_HIGH_ID : 0;
+        server.serverId = i + 1;
+        server.lifetime = 3600 * (i + 1);
+        server.defaultPmin = 30;
+        server.defaultPmax = 60;
+        server.bindingMode[0] = 'U';
+        memcpy(rawData + len, &server, sizeof(server));
+        len += sizeof(server);
+    }
+    TEST_ASSERT(sizeof(rawData) >= len);
+    value = (uint32_t)len;
+    TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == lwm2mcore_SetParam(LWM2MCORE_BOOTSTRAP_PARAM,
+                                                                 rawData,
+                                                                 len));
+    TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == lwm2mcore_SetParam(
+                                                            LWM2MCORE_BOOTSTRAP_INFO_SIZE_PARAM,
+                                                            (uint8_t*)&value,
+                                                            sizeof(value)));
+
+    // Converted and reloaded configurations
+    for (i = 0; i < 2; i++)
+    {
+        TEST_ASSERT(true == omanager_GetBootstrapConfiguration());
+        TEST_ASSERT(true == ConfigGetObjectsNumber(&securityObjectNumber, &serverObjectNumber));
+        TEST_ASSERT(TEST_BS_SECURITY_NB == securityObjectNumber);
+        TEST_ASSERT(2 == serverObjectNumber);
+        TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == omanager_GetLifetime(&value));
+        TEST_ASSERT(3600 == value);
+
+        // The instances with high Ids are kept
+        memset(&uri, 0, sizeof(uri));
+        uri.op = LWM2MCORE_OP_READ;
+        uri.oid = LWM2MCORE_SECURITY_OID;
+        uri.oiid = TEST_BS_SECURITY_HIGH_ID;
+        uri.rid = LWM2MCORE_SECURITY_SERVER_ID_RID;
+        len = sizeof(buffer);
+        TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == omanager_ReadSecurityObj(&uri, buffer, &len,
+                                                                           NULL));
+        TEST_ASSERT((TEST_BS_SECURITY_NB - 1) == omanager_BytesToInt(buffer, len));
+        uri.oid = LWM2MCORE_SERVER_OID;
+        uri.oiid = TEST_BS_SERVER_HIGH_ID;
+        uri.rid = LWM2MCORE_SERVER_SHORT_ID_RID;
+        len = sizeof(buffer);
+        TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == omanager_ReadServerObj(&uri, buffer, &len,
+                                                                         NULL));
+        TEST_ASSERT(2 == omanager_BytesToInt(buffer, len));
+        TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == omanager_FlushParams());
+        omanager_ClearParamCache();
+
+        len = sizeof(rawData);
+        TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == lwm2mcore_GetParam(LWM2MCORE_BOOTSTRAP_PARAM,
+                                                                     rawData,
+                                                                     &len));
+        TEST_ASSERT((0 == rawData[0]) && (0 == rawData[1]) && (0 == rawData[2]));
+        TEST_ASSERT(3 == rawData[3]);
+        len = sizeof(value);
+        TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK != lwm2mcore_GetParam(
+                                                            LWM2MCORE_BOOTSTRAP_INFO_SIZE_PARAM,
+                                                            (uint8_t*)&value,
+                                                            &len));
+    }
+
+    // Corrupted configuration: default configuration
+    len = sizeof(rawData);
+    TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == lwm2mcore_GetParam(LWM2MCORE_BOOTSTRAP_PARAM,
+                                                                 rawData,
+                                                                 &len));
+    rawData[len / 2] ^= 0xFF;
+    TEST_ASSERT(LWM2MCORE_ERR_COMPLETED_OK == lwm2mcore_SetParam(LWM2MCORE_BOOTSTRAP_PARAM,
+                                                                 rawData,
+                                                                 len));
+    TEST_ASSERT(false == omanager_GetBootstrapConfiguration());
+    TEST_ASSERT(true == ConfigGetObjectsNumber(&securityObjectNumber, &serverObjectNumber));
+    TEST_ASSERT(1 == securityObjectNumber);
+    TEST_ASSERT(0 == serverObjectNumber);
+
+    omanager_FreeBootstrapInformation();
+    omanager_ClearParamCache();
+    ParamStoreClose();
+    remove(TEST_PARAM_STORE_FILE);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Unitary test entry point.
+ */
+//--------------------------------------------------------------------------------------------------
+int main
+(
+    void
+)
+{
+    printf("======== Start UnitTest of lwm2mcore ========\n");
+
+    printf("======== test of lwm2mcore_Init() ========\n");
+    test_lwm2mcore_Init();
+
+    printf("======== test of lwm2mcore_Connect() ========\n");
+    test_lwm2mcore_Connect();
+
+    printf("======== test of lwm2mcore_Update() ========\n");
+    test_lwm2mcore_Update();
+
+    printf("======== test of lwm2mcore_Push() ========\n");
+    test_lwm2mcore_Push();
+
+    printf("======== test of lwm2mcore_SendRecord() ========\n");
+    test_lwm2mcore_Send();
+
+    printf("======== test of lwm2mcore_CompositeRead() ========\n");
+    test_lwm2mcore_Composite();
+
+    printf("======== test of lwm2mcore_StreamRead() ========\n");
+    test_lwm2mcore_StreamRead();
+
+    printf("======== test of lwm2mcore_StreamWrite() ========\n");
+    test_lwm2mcore_StreamWrite();
+
+    printf("======== test of lwm2mcore_QueueModeConfigure() ========\n");
+    test_lwm2mcore_QueueMode();
+
+    printf("======== test of lwm2mcore_ResourceChanged() ========\n");
+    test_lwm2mcore_Observe();
+
+    printf("======== test of the Observe and Write-Attributes requests ========\n");
+    test_lwm2mcore_ObserveRequests();
+
+    printf("======== test of the SenML Read and Observe requests ========\n");
+    test_lwm2mcore_SenmlRequests();
+
+    printf("======== test of lwm2mcore_ConnStatsConfigure() ========\n");
+    test_lwm2mcore_ConnStats();
+
+    printf("======== test of lwm2m_connect_server() ========\n");
+    test_lwm2m_connect_server();
+
+    printf("======== test of lwm2mcore_SendAsyncResponse() ========\n");
+    test_lwm2mcore_SendAsyncResponse();
+
+    printf("======== test of lwm2mcore_Disconnect() ========\n");
+    test_lwm2mcore_Disconnect();
+
+    printf("======== test of smanager_SendSessionEvent() ========\n");
+    test_smanager_SendSessionEvent();
+
+    printf("======== test of lwm2mcore_GetStartupProfile() ========\n");
+    test_lwm2mcore_GetStartupProfile();
+
+    printf("======== test of lwm2mcore_GetStatistics() ========\n");
+    test_lwm2mcore_GetStatistics();
+
+    printf("======== test of lwm2mcore_GetCoapMetrics() ========\n");
+    test_lwm2mcore_GetCoapMetrics();
+
+    printf("======== test of lwm2mcore_TraceGetRecords() ========\n");
+    test_lwm2mcore_TraceGetRecords();
+
+    printf("======== test of lwm2mcore_GetHeapStats() ========\n");
+    test_lwm2mcore_GetHeapStats();
+
+    printf("======== test of the block pools ========\n");
+    test_MemPool();
+
+    printf("======== test of lwm2mcore_SenmlSerialize() ========\n");
+    test_lwm2mcore_SenmlSerialize();
+
+    printf("======== test of lwm2mcore_PackageDownloaderReceiveData() ========\n");
+    test_lwm2mcore_PackageDownloaderReceiveData();
+
+    printf("======== test of lwm2mcore_PackageDownloaderProcessData() ========\n");
+    test_lwm2mcore_PackageDownloaderAsync();
+
+    printf("======== test of lwm2mcore_PackageDownloaderReceiveRange() ========\n");
+    test_lwm2mcore_PackageDownloaderRanges();
+
+    printf("======== test of PackageStorageStoreRange() ========\n");
+    test_PackageStorage();
+
+    printf("======== test of lwm2mcore_SetParam() ========\n");
+    test_ParamStore();
+
+    printf("======== test of omanager_SetParam() ========\n");
+    test_omanager_ParamCache();
+
+    printf("======== test of lwm2mcore_EndSha1() ========\n");
+    test_lwm2mcore_EndSha1();
+
+    printf("======== test of lwm2mcore_CopySha1() ========\n");
+    test_lwm2mcore_CopySha1();
+
+    printf("======== test of lwm2mcore_GetCredential() ========\n");
+    test_lwm2mcore_GetCredential();
+
+    printf("======== test of omanager_GetBootstrapConfiguration() ========\n");
+    test_omanager_GetBootstrapConfiguration();
 
     printf("======== test of lwm2mcore_Free() ========\n");
     test_lwm2mcore_Free();
@@ -0,0 +1,501 @@
+/**
+ * @file traceTool.c
+ *
+ * Command line tool decoding a LwM2MCore binary trace file, see lwm2mcore/trace.h
+ *
+ * Usage: lwm2mtrace -i <trace file> [options]
+ *  -i <file>   Trace file written by the client
+ *  -p <file>   Export the captured packets in a pcap file (raw IPv4 link type)
+ *  -d          Export the UDP datagrams instead of the plain text CoAP messages
+ *  -q          Do not print the decoded records
+ *
+ * In the pcap file, the client address is 10.0.0.1 and the address of a server is 10.0.1.x, x
+ * being its security object instance Id. The CoAP messages are exported on the port 5683, and the
+ * datagrams on the port 5684 if they contain DTLS records.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <lwm2mcore/trace.h>
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum length of an exported packet
+ */
+//--------------------------------------------------------------------------------------------------
+#define PACKET_MAX_LEN          65535
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Length of the IPv4 and UDP headers of an exported packet
+ */
+//--------------------------------------------------------------------------------------------------
+#define IP_UDP_HEADER_LEN       28
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * pcap link type of the raw IP packets
+ */
+//--------------------------------------------------------------------------------------------------
+#define PCAP_LINKTYPE_RAW       101
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * UDP ports of the exported packets
+ */
+//--------------------------------------------------------------------------------------------------
+#define CLIENT_PORT             56830
+#define COAP_PORT               5683
+#define COAPS_PORT              5684
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Names of the LwM2MCore trace events
+ */
+//--------------------------------------------------------------------------------------------------
+static const char* EventNames[LWM2MCORE_TRACE_EVENT_MAX] =
+{
+    "PAYLOAD",
+    "DATAGRAM_SENT",
+    "DATAGRAM_RECEIVED",
+    "COAP_SENT",
+    "COAP_RECEIVED",
+    "READ",
+    "WRITE",
+    "EXECUTE",
+    "SESSION_EVENT",
+    "DTLS_EVENT",
+    "STATUS_EVENT"
+};
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if an event is a packet event
+ *
+ * @return
+ *  - true  The event is followed by the captured bytes of a packet
+ *  - false else
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsPacketEvent
+(
+    uint16_t event          ///< [IN] Event Id
+)
+{
+    return (   (LWM2MCORE_TRACE_DATAGRAM_SENT == event)
+            || (LWM2MCORE_TRACE_DATAGRAM_RECEIVED == event)
+            || (LWM2MCORE_TRACE_COAP_SENT == event)
+            || (LWM2MCORE_TRACE_COAP_RECEIVED == event));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Print a decoded record
+ */
+//--------------------------------------------------------------------------------------------------
+static void PrintRecord
+(
+    const lwm2mcore_TraceRecord_t* recordPtr,   ///< [IN] Record
+    uint64_t firstTimeUs                        ///< [IN] Time of the first record
+)
+{
+    const uint32_t* argsPtr = recordPtr->args;
+    uint64_t timeUs = recordPtr->timeUs - firstTimeUs;
+
+    printf("%10u %8llu.%06llu ",
+           recordPtr->seq,
+           (unsigned long long)(timeUs / 1000000),
+           (unsigned long long)(timeUs % 1000000));
+
+    if (LWM2MCORE_TRACE_PLATFORM_BASE <= recordPtr->event)
+    {
+        printf("PLATFORM_%u 0x%x 0x%x 0x%x 0x%x\n",
+               recordPtr->event - LWM2MCORE_TRACE_PLATFORM_BASE,
+               argsPtr[0], argsPtr[1], argsPtr[2], argsPtr[3]);
+        return;
+    }
+
+    switch (recordPtr->event)
+    {
+        case LWM2MCORE_TRACE_PAYLOAD:
+        {
+            const uint8_t* bytesPtr = (const uint8_t*)argsPtr;
+            uint16_t i;
+
+            printf("  ");
+            for (i = 0; (i < recordPtr->len) && (i < sizeof(recordPtr->args)); i++)
+            {
+                printf(" %02x", bytesPtr[i]);
+            }
+            printf("\n");
+        }
+        break;
+
+        case LWM2MCORE_TRACE_DATAGRAM_SENT:
+        case LWM2MCORE_TRACE_DATAGRAM_RECEIVED:
+        case LWM2MCORE_TRACE_COAP_SENT:
+        case LWM2MCORE_TRACE_COAP_RECEIVED:
+            printf("%s server %u, %u bytes%s, %u captured\n",
+                   EventNames[recordPtr->event], argsPtr[0], argsPtr[1],
+                   (argsPtr[2] & LWM2MCORE_TRACE_FLAG_DTLS) ? " (DTLS)" : "", argsPtr[3]);
+            break;
+
+        case LWM2MCORE_TRACE_READ:
+        case LWM2MCORE_TRACE_WRITE:
+        case LWM2MCORE_TRACE_EXECUTE:
+            printf("%s /%u/%u/%u", EventNames[recordPtr->event],
+                   argsPtr[0], argsPtr[1], argsPtr[2] & 0xFFFF);
+            if (argsPtr[2] >> 16)
+            {
+                printf("/%u", argsPtr[2] >> 16);
+            }
+            printf(" result %d\n", (int32_t)argsPtr[3]);
+            break;
+
+        case LWM2MCORE_TRACE_SESSION_EVENT:
+            printf("%s type %u status %u\n", EventNames[recordPtr->event], argsPtr[0], argsPtr[1]);
+            break;
+
+        case LWM2MCORE_TRACE_DTLS_EVENT:
+            printf("%s code %u level %u\n", EventNames[recordPtr->event], argsPtr[0], argsPtr[1]);
+            break;
+
+        case LWM2MCORE_TRACE_STATUS_EVENT:
+            printf("%s %u\n", EventNames[recordPtr->event], argsPtr[0]);
+            break;
+
+        default:
+            printf("UNKNOWN_%u 0x%x 0x%x 0x%x 0x%x\n",
+                   recordPtr->event, argsPtr[0], argsPtr[1], argsPtr[2], argsPtr[3]);
+            break;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a 16-bit value in network byte order
+ */
+//--------------------------------------------------------------------------------------------------
+static void SetUint16
+(
+    uint8_t* bufferPtr,     ///< [OUT] Buffer
+    uint32_t value          ///< [IN] Value
+)
+{
+    bufferPtr[0] = (uint8_t)(value >> 8);
+    bufferPtr[1] = (uint8_t)value;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a packet in the pcap file, with IPv4 and UDP headers
+ *
+ * @return
+ *  - true  The packet is written
+ *  - false Write failure
+ */
+//--------------------------------------------------------------------------------------------------
+static bool WritePcapPacket
+(
+    FILE* filePtr,                          ///< [IN] pcap file
+    const lwm2mcore_TraceRecord_t* recordPtr,///< [IN] Packet record
+    uint8_t* packetPtr,                     ///< [INOUT] Packet, with the captured bytes from
+                                            ///<         IP_UDP_HEADER_LEN
+    uint32_t captureLen                     ///< [IN] Number of captured bytes
+)
+{
+    uint32_t length = recordPtr->args[1];
+    bool isSent = (   (LWM2MCORE_TRACE_DATAGRAM_SENT == recordPtr->event)
+                   || (LWM2MCORE_TRACE_COAP_SENT == recordPtr->event));
+    bool isCoap = (   (LWM2MCORE_TRACE_COAP_SENT == recordPtr->event)
+                   || (LWM2MCORE_TRACE_COAP_RECEIVED == recordPtr->event));
+    uint32_t serverPort = ((!isCoap) && (recordPtr->args[2] & LWM2MCORE_TRACE_FLAG_DTLS)) ?
+                          COAPS_PORT : COAP_PORT;
+    uint8_t client[4] = {10, 0, 0, 1};
+    uint8_t server[4] = {10, 0, 1, (uint8_t)recordPtr->args[0]};
+    uint32_t header[4];
+    uint32_t checksum = 0;
+    uint32_t i;
+
+    if ((PACKET_MAX_LEN - IP_UDP_HEADER_LEN) < length)
+    {
+        length = PACKET_MAX_LEN - IP_UDP_HEADER_LEN;
+    }
+
+    /* IPv4 header */
+    memset(packetPtr, 0, IP_UDP_HEADER_LEN);
+    packetPtr[0] = 0x45;
+    SetUint16(packetPtr + 2, IP_UDP_HEADER_LEN + length);
+    packetPtr[8] = 64;
+    packetPtr[9] = 17;
+    memcpy(packetPtr + 12, isSent ? client : server, 4);
+    memcpy(packetPtr + 16, isSent ? server : client, 4);
+    for (i = 0; i < 20; i += 2)
+    {
+        checksum += ((uint32_t)packetPtr[i] << 8) | packetPtr[i + 1];
+    }
+    checksum = (checksum & 0xFFFF) + (checksum >> 16);
+    checksum = (checksum & 0xFFFF) + (checksum >> 16);
+    SetUint16(packetPtr + 10, ~checksum & 0xFFFF);
+
+    /* UDP header, without checksum */
+    SetUint16(packetPtr + 20, isSent ? CLIENT_PORT : serverPort);
+    SetUint16(packetPtr + 22, isSent ? serverPort : CLIENT_PORT);
+    SetUint16(packetPtr + 24, 8 + length);
+
+    header[0] = (uint32_t)(recordPtr->timeUs / 1000000);
+    header[1] = (uint32_t)(recordPtr->timeUs % 1000000);
+    header[2] = IP_UDP_HEADER_LEN + captureLen;
+    header[3] = IP_UDP_HEADER_LEN + length;
+
+    return (   (1 == fwrite(header, sizeof(header), 1, filePtr))
+            && (1 == fwrite(packetPtr, IP_UDP_HEADER_LEN + captureLen, 1, filePtr)));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Export the captured packets in a pcap file
+ *
+ * @return
+ *  - Number of exported packets
+ *  - -1 in case of failure
+ */
+//--------------------------------------------------------------------------------------------------
+static int ExportPcap
+(
+    const char* fileNamePtr,                    ///< [IN] pcap file
+    const lwm2mcore_TraceRecord_t* recordsPtr,  ///< [IN] Records
+    uint32_t recordNb,                          ///< [IN] Number of records
+    bool isDatagram                             ///< [IN] Export the datagrams
+)
+{
+    uint32_t pcapHeader[6] = {0xA1B2C3D4, 0x00040002, 0, 0, PACKET_MAX_LEN, PCAP_LINKTYPE_RAW};
+    uint8_t* packetPtr;
+    FILE* filePtr;
+    uint32_t i;
+    int packetNb = 0;
+
+    filePtr = fopen(fileNamePtr, "wb");
+    if (!filePtr)
+    {
+        printf("Unable to create %s\n", fileNamePtr);
+        return -1;
+    }
+
+    packetPtr = (uint8_t*)malloc(PACKET_MAX_LEN);
+    if ((!packetPtr) || (1 != fwrite(pcapHeader, sizeof(pcapHeader), 1, filePtr)))
+    {
+        free(packetPtr);
+        fclose(filePtr);
+        return -1;
+    }
+
+    for (i = 0; i < recordNb; i++)
+    {
+        const lwm2mcore_TraceRecord_t* recordPtr = &recordsPtr[i];
+        bool isDatagramEvent = (   (LWM2MCORE_TRACE_DATAGRAM_SENT == recordPtr->event)
+                                || (LWM2MCORE_TRACE_DATAGRAM_RECEIVED == recordPtr->event));
+        uint32_t captureLen = 0;
+        uint32_t j;
+
+        if ((!IsPacketEvent(recordPtr->event)) || (isDatagram != isDatagramEvent))
+        {
+            continue;
+        }
+
+        /* Gather the captured bytes from the following records */
+        for (j = i + 1;
+             (j < recordNb)
+             && (LWM2MCORE_TRACE_PAYLOAD == recordsPtr[j].event)
+             && ((recordPtr->seq + (j - i)) == recordsPtr[j].seq)
+             && (captureLen < recordPtr->args[3]);
+             j++)
+        {
+            uint32_t len = recordsPtr[j].len;
+
+            if ((PACKET_MAX_LEN - IP_UDP_HEADER_LEN - captureLen) < len)
+            {
+                break;
+            }
+            memcpy(packetPtr + IP_UDP_HEADER_LEN + captureLen, recordsPtr[j].args, len);
+            captureLen += len;
+        }
+
+        if (captureLen != recordPtr->args[3])
+        {
+            /* Some captured bytes were lost */
+            continue;
+        }
+
+        if (!WritePcapPacket(filePtr, recordPtr, packetPtr, captureLen))
+        {
+            packetNb = -1;
+            break;
+        }
+        packetNb++;
+    }
+
+    free(packetPtr);
+    fclose(filePtr);
+    return packetNb;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read a trace file
+ *
+ * @return
+ *  - Records, to be released by the caller
+ *  - NULL in case of failure
+ */
+//--------------------------------------------------------------------------------------------------
+static lwm2mcore_TraceRecord_t* ReadTraceFile
+(
+    const char* fileNamePtr,                ///< [IN] Trace file
+    lwm2mcore_TraceFileHeader_t* headerPtr  ///< [OUT] File header
+)
+{
+    lwm2mcore_TraceRecord_t* recordsPtr = NULL;
+    FILE* filePtr = fopen(fileNamePtr, "rb");
+
+    if (!filePtr)
+    {
+        printf("Unable to open %s\n", fileNamePtr);
+        return NULL;
+    }
+
+    if (   (1 != fread(headerPtr, sizeof(lwm2mcore_TraceFileHeader_t), 1, filePtr))
+        || (LWM2MCORE_TRACE_FILE_MAGIC != headerPtr->magic)
+        || (LWM2MCORE_TRACE_FILE_VERSION != headerPtr->version)
+        || (sizeof(lwm2mcore_TraceRecord_t) != headerPtr->recordSize))
+    {
+        printf("%s is not a trace file of this version\n", fileNamePtr);
+        fclose(filePtr);
+        return NULL;
+    }
+
+    recordsPtr = (lwm2mcore_TraceRecord_t*)malloc((headerPtr->recordNb + 1)
+                                                  * sizeof(lwm2mcore_TraceRecord_t));
+    if (   (recordsPtr)
+        && (headerPtr->recordNb != fread(recordsPtr,
+                                         sizeof(lwm2mcore_TraceRecord_t),
+                                         headerPtr->recordNb,
+                                         filePtr)))
+    {
+        printf("%s is truncated\n", fileNamePtr);
+        free(recordsPtr);
+        recordsPtr = NULL;
+    }
+
+    fclose(filePtr);
+    return recordsPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Print the tool usage
+ */
+//--------------------------------------------------------------------------------------------------
+static void PrintUsage
+(
+    const char* namePtr     ///< [IN] Program name
+)
+{
+    printf("Usage: %s -i <trace file> [-p <pcap file>] [-d] [-q]\n", namePtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Trace decoder entry point
+ */
+//--------------------------------------------------------------------------------------------------
+int main
+(
+    int   argc,     ///< [IN] Number of arguments
+    char* argv[]    ///< [IN] Arguments
+)
+{
+    lwm2mcore_TraceFileHeader_t header;
+    lwm2mcore_TraceRecord_t* recordsPtr;
+    const char* traceFilePtr = NULL;
+    const char* pcapFilePtr = NULL;
+    bool isDatagram = false;
+    bool isQuiet = false;
+    int result = EXIT_SUCCESS;
+    int opt;
+    uint32_t i;
+
+    while (-1 != (opt = getopt(argc, argv, "i:p:dq")))
+    {
+        switch (opt)
+        {
+            case 'i':
+                traceFilePtr = optarg;
+                break;
+
+            case 'p':
+                pcapFilePtr = optarg;
+                break;
+
+            case 'd':
+                isDatagram = true;
+                break;
+
+            case 'q':
+                isQuiet = true;
+                break;
+
+            default:
+                PrintUsage(argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+
+    if (!traceFilePtr)
+    {
+        PrintUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    recordsPtr = ReadTraceFile(traceFilePtr, &header);
+    if (!recordsPtr)
+    {
+        return EXIT_FAILURE;
+    }
+
+    printf("%u records, %u lost\n", header.recordNb, header.lostNb);
+
+    for (i = 0; (!isQuiet) && (i < header.recordNb); i++)
+    {
+        if ((i) && ((recordsPtr[i - 1].seq + 1) != recordsPtr[i].seq))
+        {
+            printf("---------- %u records lost\n", recordsPtr[i].seq - recordsPtr[i - 1].seq - 1);
+        }
+        PrintRecord(&recordsPtr[i], recordsPtr[0].timeUs);
+    }
+
+    if (pcapFilePtr)
+    {
+        int packetNb = ExportPcap(pcapFilePtr, recordsPtr, header.recordNb, isDatagram);
+
+        if (0 > packetNb)
+        {
+            printf("Unable to export the packets in %s\n", pcapFilePtr);
+            result = EXIT_FAILURE;
+        }
+        else
+        {
+            printf("%d packets exported in %s\n", packetNb, pcapFilePtr);
+        }
+    }
+
+    free(recordsPtr);
+    return result;
+}
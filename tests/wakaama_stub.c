@@ -9,6 +9,7 @@
 //-------------------------------------------------------------------------------------------------
 
 
+#include <stdio.h>
 #include <string.h>
 #include <stdint.h>
 #include <stddef.h>
@@ -25,6 +26,16 @@
 //-------------------------------------------------------------------------------------------------
 #define MAX_BUFFER_LEN 100
 
+//-------------------------------------------------------------------------------------------------
+/**
+ * Number of asynchronous responses and notifications, and last one, used by the tests
+ */
+//-------------------------------------------------------------------------------------------------
+int StubAsyncResponseNb = 0;
+uint8_t StubAsyncToken[8];
+uint8_t StubAsyncTokenLen = 0;
+size_t StubAsyncPayloadLen = 0;
+
 
 char* coap_get_multi_option_as_string
 (
@@ -342,14 +353,51 @@ bool lwm2m_async_response
     (void)shortServerId;
     (void)mid;
     (void)code;
-    (void)token;
-    (void)token_len;
     (void)content_type;
     (void)payload;
-    (void)payload_len;
+
+    StubAsyncResponseNb++;
+    StubAsyncTokenLen = (token_len < sizeof(StubAsyncToken)) ? token_len : sizeof(StubAsyncToken);
+    memcpy(StubAsyncToken, token, StubAsyncTokenLen);
+    StubAsyncPayloadLen = payload_len;
     return true;
 }
 
+int lwm2m_data_serialize
+(
+    lwm2m_uri_t* uriP,
+    int size,
+    lwm2m_data_t* dataP,
+    lwm2m_media_type_t* formatP,
+    uint8_t** bufferP
+)
+{
+    char buffer[MAX_BUFFER_LEN];
+    int length;
+
+    (void)uriP;
+    (void)formatP;
+
+    /* Plain text of an integer value, one byte for the other values */
+    if ((1 == size) && (LWM2M_TYPE_INTEGER == dataP->type))
+    {
+        length = snprintf(buffer, sizeof(buffer), "%lld", (long long)dataP->value.asInteger);
+    }
+    else
+    {
+        buffer[0] = '0';
+        length = 1;
+    }
+
+    *bufferP = (uint8_t*)lwm2m_malloc((size_t)length);
+    if (NULL == *bufferP)
+    {
+        return -1;
+    }
+    memcpy(*bufferP, buffer, (size_t)length);
+    return length;
+}
+
 void lwm2m_data_free
 (
     int size,